@@ -0,0 +1,196 @@
+/*
+
+	bench_array - ax_array sorting, searches and parallel algorithms
+
+	c++ -O2 -I include bench/bench_array.cpp -o bench_array -lpthread
+
+	Sorts random data with ax::sort (radix sort for arithmetic types), with
+	ax::sort and a comparator (introsort), and with std::sort. Scans a large
+	array with TArr::find(), count() and findMin() next to std::find(),
+	std::count() and std::min_element(). Finally sorts with parallelSort() on
+	a job system with --threads workers. Results are per element. See
+	ax_bench.h for the options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXMM_IMPLEMENTATION
+#define AXFIBER_IMPLEMENTATION
+#define AXJOB_IMPLEMENTATION
+#define AXSTR_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_memory.h"
+#include "ax_fiber.h"
+#include "ax_job.h"
+#include "ax_array.hpp"
+#include "ax_bench.h"
+
+/* elements in the large sort and scan inputs */
+#define LARGE_COUNT ( 1024*1024 )
+/* elements in the small sort input */
+#define SMALL_COUNT 1000
+
+static axbench_u64_t                g_uRandom = 88172645463325252ULL;
+
+static axbench_u64_t nextRandom()
+{
+	g_uRandom ^= g_uRandom << 13;
+	g_uRandom ^= g_uRandom >> 7;
+	g_uRandom ^= g_uRandom << 17;
+	return g_uRandom;
+}
+
+/* each iteration restores the unsorted input (outside the timing) and sorts it */
+template< typename T, typename TSort >
+static void runSortCase( axbench_t &bench, const char *pszName, const std::vector< T > &src, std::vector< T > &dst, TSort sortFn )
+{
+	ax::runBenchmark( bench, pszName, src.size(), "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			axbench_pause( &bench );
+			dst = src;
+			axbench_resume( &bench );
+
+			sortFn( dst.data(), dst.data() + dst.size() );
+			AXBENCH_KEEP( dst.data() );
+		}
+	} );
+}
+
+template< typename T >
+static void runSort( axbench_t &bench, const char *pszType, size_t cElements )
+{
+	char szName[ AXBENCH_MAX_NAME ];
+	std::vector< T > src( cElements ), dst;
+
+	for( T &x : src ) {
+		x = T( nextRandom() );
+	}
+
+	snprintf( szName, sizeof( szName ), "array/sort/%s/%u", pszType, unsigned( cElements ) );
+	runSortCase( bench, szName, src, dst, []( T *s, T *e ) { ax::sort( s, e ); } );
+
+	snprintf( szName, sizeof( szName ), "array/sort/%s/%u/comparator", pszType, unsigned( cElements ) );
+	runSortCase( bench, szName, src, dst, []( T *s, T *e ) { ax::sort( s, e, []( const T &a, const T &b ) { return a < b; } ); } );
+
+	snprintf( szName, sizeof( szName ), "array/sort/%s/%u/std", pszType, unsigned( cElements ) );
+	runSortCase( bench, szName, src, dst, []( T *s, T *e ) { std::sort( s, e ); } );
+}
+
+/* the value searched for is never present, so every scan covers the whole array */
+template< typename T >
+static void runScan( axbench_t &bench, const char *pszType )
+{
+	char szName[ AXBENCH_MAX_NAME ];
+	std::vector< T > v( LARGE_COUNT );
+
+	for( size_t i = 0; i < v.size(); ++i ) {
+		v[ i ] = T( i%100 );
+	}
+
+	const ax::TArr< T > arr( v.data(), v.size() );
+	const T missing = T( 101 );
+
+	snprintf( szName, sizeof( szName ), "array/find/%s", pszType );
+	ax::runBenchmark( bench, szName, LARGE_COUNT, "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			const T *p = arr.find( missing );
+			AXBENCH_KEEP( &p );
+		}
+	} );
+	snprintf( szName, sizeof( szName ), "array/find/%s/std", pszType );
+	ax::runBenchmark( bench, szName, LARGE_COUNT, "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			auto p = std::find( v.begin(), v.end(), missing );
+			AXBENCH_KEEP( &p );
+		}
+	} );
+
+	snprintf( szName, sizeof( szName ), "array/count/%s", pszType );
+	ax::runBenchmark( bench, szName, LARGE_COUNT, "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			auto n = arr.count( T( 7 ) );
+			AXBENCH_KEEP( &n );
+		}
+	} );
+	snprintf( szName, sizeof( szName ), "array/count/%s/std", pszType );
+	ax::runBenchmark( bench, szName, LARGE_COUNT, "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			auto n = std::count( v.begin(), v.end(), T( 7 ) );
+			AXBENCH_KEEP( &n );
+		}
+	} );
+
+	snprintf( szName, sizeof( szName ), "array/find_min/%s", pszType );
+	ax::runBenchmark( bench, szName, LARGE_COUNT, "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			const T *p = arr.findMin();
+			AXBENCH_KEEP( &p );
+		}
+	} );
+	snprintf( szName, sizeof( szName ), "array/find_min/%s/std", pszType );
+	ax::runBenchmark( bench, szName, LARGE_COUNT, "elem", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			auto p = std::min_element( v.begin(), v.end() );
+			AXBENCH_KEEP( &p );
+		}
+	} );
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+	char szName[ AXBENCH_MAX_NAME ];
+
+	if( !axbench_init( &bench, "array", argc, argv ) ) {
+		return 2;
+	}
+
+	runSort< int >( bench, "int", SMALL_COUNT );
+	runSort< int >( bench, "int", LARGE_COUNT );
+	runSort< float >( bench, "float", LARGE_COUNT );
+	runSort< axbench_u64_t >( bench, "u64", LARGE_COUNT );
+
+	runScan< int >( bench, "int" );
+	runScan< unsigned char >( bench, "u8" );
+	runScan< float >( bench, "float" );
+	runScan< double >( bench, "double" );
+
+	/* the job system's workers include this thread */
+	axjob_system_t jobs;
+	axjob_config_t cfg;
+
+	memset( ( void * )&cfg, 0, sizeof( cfg ) );
+	cfg.cWorkers = axbench_max_threads( &bench );
+	if( !axjob_init( &jobs, &cfg ) ) {
+		fprintf( stderr, "bench_array: axjob_init failed\n" );
+		axbench_fini( &bench );
+		return 2;
+	}
+
+	{
+		std::vector< int > src( LARGE_COUNT ), dst;
+
+		for( int &x : src ) {
+			x = int( nextRandom() );
+		}
+
+		snprintf( szName, sizeof( szName ), "array/parallel_sort/int/%u/t%u", unsigned( LARGE_COUNT ), unsigned( cfg.cWorkers ) );
+		runSortCase( bench, szName, src, dst, [&]( int *s, int *e ) { ax::parallelSort( &jobs, s, e ); } );
+
+		snprintf( szName, sizeof( szName ), "array/parallel_sort/int/%u/t%u/comparator", unsigned( LARGE_COUNT ), unsigned( cfg.cWorkers ) );
+		runSortCase( bench, szName, src, dst, [&]( int *s, int *e ) { ax::parallelSort( &jobs, s, e, []( int a, int b ) { return a < b; } ); } );
+	}
+
+	axjob_fini( &jobs );
+	return axbench_fini( &bench );
+}
@@ -0,0 +1,92 @@
+/*
+
+	bench_config - ax_config lexing throughput
+
+	c++ -O2 -I include bench/bench_config.cpp -o bench_config -lpthread
+
+	Lexes a generated configuration of about 1MB (sections, string, number and
+	list assignments, comments) from start to end-of-file with axconf_lex.
+	Each iteration lexes the whole buffer once into a fresh axconf_t, so the
+	cost of allocating and releasing the tokens is included, as it would be
+	when loading a file. Results are in bytes, so the rate reads as MB/s. See
+	ax_bench.h for the options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXSTR_IMPLEMENTATION
+#define AXCONF_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_string.h"
+#include "ax_config.h"
+#include "ax_bench.h"
+
+/* approximate size of the generated configuration */
+#define CONFIG_BYTES ( 1024*1024 )
+
+/* append one section's worth of text; returns the number of bytes written */
+static size_t writeSection( char *pDst, size_t cDstBytes, unsigned i )
+{
+	const int n = snprintf( pDst, cDstBytes,
+		"// section %u\n"
+		"[section_%u]\n"
+		"name_%u = \"value number %u\"\n"
+		"count_%u := %u\n"
+		"ratio_%u := %u.%03u\n"
+		"flags_%u += [ alpha, beta_%u, gamma ]\n"
+		"\n",
+		i, i, i, i, i, i*7 + 1, i, i%100, i%1000, i, i%16 );
+
+	return n > 0 && size_t( n ) < cDstBytes ? size_t( n ) : 0;
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+
+	if( !axbench_init( &bench, "config", argc, argv ) ) {
+		return 2;
+	}
+
+	char *const pText = ( char * )malloc( CONFIG_BYTES + 512 );
+	if( !pText ) {
+		fprintf( stderr, "bench_config: out of memory\n" );
+		axbench_fini( &bench );
+		return 2;
+	}
+
+	size_t cText = 0;
+	for( unsigned i = 0; cText < CONFIG_BYTES; ++i ) {
+		const size_t n = writeSection( &pText[ cText ], CONFIG_BYTES + 512 - cText, i );
+		if( !n ) {
+			break;
+		}
+		cText += n;
+	}
+
+	ax::runBenchmark( bench, "config/lex", cText, "B", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			axconf_t cfg;
+			axconf_token_t *t;
+
+			axconf_init( &cfg );
+			axconf_set_buffer_ref( &cfg, pText, cText );
+			do {
+				t = axconf_lex( &cfg );
+			} while( t != ( axconf_token_t * )0 && t->type != kAxconfTok_EOF );
+			AXBENCH_KEEP( t );
+			axconf_fini( &cfg );
+		}
+	} );
+
+	free( ( void * )pText );
+	return axbench_fini( &bench );
+}
@@ -0,0 +1,168 @@
+/*
+
+	bench_dictionary - TDictionary and TCompactDictionary lookups
+
+	c++ -O2 -I include bench/bench_dictionary.cpp -o bench_dictionary -lpthread
+
+	Fills each dictionary with a fixed set of identifier keys, then measures
+	find() of keys that are present (hit) and of keys that aren't (miss), and
+	lookup() into an empty dictionary (insert). std::unordered_map with the
+	same keys is measured alongside for reference. See ax_bench.h for the
+	options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXSTR_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_string.h"
+#include "ax_dictionary.hpp"
+#include "ax_bench.h"
+
+/* number of keys in each dictionary */
+#define KEY_COUNT 10000
+
+static std::vector< std::string >   g_Keys;
+static std::vector< std::string >   g_Misses;
+
+/* identifiers of varying length with shared prefixes, as in a symbol table */
+static void initKeys()
+{
+	static const char *const pszPrefixes[] = { "get_", "set_", "m_", "g_", "kValue", "on", "is_", "" };
+	static const char szChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_";
+	axbench_u32_t x = 0x2545F491;
+
+	for( unsigned i = 0; i < KEY_COUNT*2; ++i ) {
+		std::string key = pszPrefixes[ i%( sizeof( pszPrefixes )/sizeof( pszPrefixes[ 0 ] ) ) ];
+
+		x = x*1664525 + 1013904223;
+		const unsigned cChars = 3 + ( x >> 24 )%14;
+		for( unsigned j = 0; j < cChars; ++j ) {
+			x = x*1664525 + 1013904223;
+			key += szChars[ ( x >> 16 )%( sizeof( szChars ) - 1 ) ];
+		}
+
+		/* the second half never goes in, but keeps the same shape */
+		( i < KEY_COUNT ? g_Keys : g_Misses ).push_back( key );
+	}
+}
+
+template< typename TDict >
+static void runDictionary( axbench_t &bench, const char *pszName )
+{
+	static int                      iValue;
+	char szName[ AXBENCH_MAX_NAME ];
+	TDict dict;
+
+	if( !dict.init( AX_DICT_IDENT ) ) {
+		return;
+	}
+	for( const std::string &key : g_Keys ) {
+		typename TDict::SEntry *const pEntry = dict.lookup( ax::Str( key.c_str(), key.size() ) );
+		if( pEntry != nullptr ) {
+			pEntry->pData = &iValue;
+		}
+	}
+
+	snprintf( szName, sizeof( szName ), "dictionary/%s/find_hit", pszName );
+	ax::runBenchmark( bench, szName, 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			const std::string &key = g_Keys[ i%KEY_COUNT ];
+			typename TDict::SEntry *const pEntry = dict.find( ax::Str( key.c_str(), key.size() ) );
+			AXBENCH_KEEP( pEntry );
+		}
+	} );
+
+	snprintf( szName, sizeof( szName ), "dictionary/%s/find_miss", pszName );
+	ax::runBenchmark( bench, szName, 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			const std::string &key = g_Misses[ i%KEY_COUNT ];
+			typename TDict::SEntry *const pEntry = dict.find( ax::Str( key.c_str(), key.size() ) );
+			AXBENCH_KEEP( pEntry );
+		}
+	} );
+
+	dict.fini();
+
+	/* build the whole set each iteration; fini() is left out of the timing */
+	snprintf( szName, sizeof( szName ), "dictionary/%s/insert", pszName );
+	ax::runBenchmark( bench, szName, KEY_COUNT, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			TDict fresh;
+
+			if( !fresh.init( AX_DICT_IDENT ) ) {
+				return;
+			}
+			for( const std::string &key : g_Keys ) {
+				typename TDict::SEntry *const pEntry = fresh.lookup( ax::Str( key.c_str(), key.size() ) );
+				AXBENCH_KEEP( pEntry );
+			}
+
+			axbench_pause( &bench );
+			fresh.fini();
+			axbench_resume( &bench );
+		}
+	} );
+}
+
+static void runUnorderedMap( axbench_t &bench )
+{
+	static int                      iValue;
+	std::unordered_map< std::string, int * > map;
+
+	for( const std::string &key : g_Keys ) {
+		map[ key ] = &iValue;
+	}
+
+	ax::runBenchmark( bench, "dictionary/unordered_map/find_hit", 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			auto iter = map.find( g_Keys[ i%KEY_COUNT ] );
+			AXBENCH_KEEP( &iter );
+		}
+	} );
+	ax::runBenchmark( bench, "dictionary/unordered_map/find_miss", 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			auto iter = map.find( g_Misses[ i%KEY_COUNT ] );
+			AXBENCH_KEEP( &iter );
+		}
+	} );
+	ax::runBenchmark( bench, "dictionary/unordered_map/insert", KEY_COUNT, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			std::unordered_map< std::string, int * > fresh;
+
+			for( const std::string &key : g_Keys ) {
+				fresh[ key ] = &iValue;
+			}
+
+			axbench_pause( &bench );
+			fresh.clear();
+			axbench_resume( &bench );
+		}
+	} );
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+
+	if( !axbench_init( &bench, "dictionary", argc, argv ) ) {
+		return 2;
+	}
+
+	initKeys();
+
+	runDictionary< ax::TDictionary< int > >( bench, "trie" );
+	runDictionary< ax::TCompactDictionary< int > >( bench, "compact" );
+	runUnorderedMap( bench );
+
+	return axbench_fini( &bench );
+}
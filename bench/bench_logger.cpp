@@ -0,0 +1,160 @@
+/*
+
+	bench_logger - ax_logger report submission latency
+
+	c++ -O2 -I include bench/bench_logger.cpp -o bench_logger -lpthread
+
+	Measures axlog_submit_report() of an already formatted report, delivered to
+	an endpoint filter that does nothing, so what is timed is the logger's own
+	overhead: synchronously on 1, 2, 4, ... threads (up to --threads), and
+	through the asynchronous backend. Formatting is measured separately with
+	axlog_init_report(). axlog_deferf() and axlog_defercf() are timed from the
+	caller's side, with the backend flushed between batches outside the timing.
+	See ax_bench.h for the options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXSTR_IMPLEMENTATION
+#define AXPRINTF_IMPLEMENTATION
+#define AXLOG_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_string.h"
+#include "ax_printf.h"
+#include "ax_logger.h"
+#include "ax_bench.h"
+
+#define REPORT_FLAGS ( axlogp_info | AXLOG_DEFAULT_FACILITY )
+
+static axbench_u64_t                g_cReceived;
+
+static axlog_send_t AXLOG_CALL nullEndpoint_f( void *pUserParm, axlog_report_t *pReport, const axlog_sysinfo_t *pSysinfo )
+{
+	( void )pUserParm;
+	( void )pReport;
+	( void )pSysinfo;
+
+	/* racy with several threads; only there so the call isn't empty */
+	g_cReceived = g_cReceived + 1;
+	return axlog_forward;
+}
+
+static void initReport( char *pszBuf, axlog_uptr_t cBuf, axlog_report_t *pReport, axbench_u32_t uThread )
+{
+	( void )axlog_init_report( pszBuf, cBuf, pReport, REPORT_FLAGS, __FILE__, __LINE__, "initReport", ( const char * )0,
+		"thread %u: loaded %d items in %.2f ms", unsigned( uThread ), 1234, 5.67 );
+}
+
+static void runSubmit( axbench_t &bench, const char *pszName, axbench_u32_t cThreads )
+{
+	ax::runBenchmarkMT( bench, pszName, cThreads, 1, "op", [&]( axbench_u32_t uThread, axbench_u64_t cIters ) {
+		char szBuf[ 128 ];
+		axlog_report_t rep;
+
+		initReport( szBuf, sizeof( szBuf ), &rep, uThread );
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			axlog_submit_report_result_t r = axlog_submit_report( &rep );
+			AXBENCH_KEEP( &r );
+		}
+	} );
+}
+
+#if AXLOG_DEFERRED_ENABLED
+/* flushed every so often, untimed, so the ring never fills and what's timed is the caller's side */
+# define DEFER_BATCH 256
+
+static void runDefer( axbench_t &bench, const char *pszName, const axpf_format_t *pFmt )
+{
+	( void )pFmt;
+
+	ax::runBenchmark( bench, pszName, 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			if( i % DEFER_BATCH == 0 ) {
+				axbench_pause( &bench );
+				( void )axlog_async_flush( ~0U );
+				axbench_resume( &bench );
+			}
+
+			axlog_submit_report_result_t r;
+# if AXLOG_COMPILED_ENABLED
+			if( pFmt != ( const axpf_format_t * )0 ) {
+				r = axlog_defercf( REPORT_FLAGS, __FILE__, __LINE__, "runDefer", pFmt, unsigned( i ), 1234, 5.67 );
+			} else
+# endif
+			{
+				r = axlog_deferf( REPORT_FLAGS, __FILE__, __LINE__, "runDefer",
+					"thread %u: loaded %d items in %.2f ms", unsigned( i ), 1234, 5.67 );
+			}
+			AXBENCH_KEEP( &r );
+		}
+	} );
+}
+#endif
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+	char szName[ AXBENCH_MAX_NAME ];
+
+	if( !axbench_init( &bench, "logger", argc, argv ) ) {
+		return 2;
+	}
+
+	if( axlog_add_filter( axlog_filter_endpoint, &nullEndpoint_f, ( void * )0 ) != axlog_add_filter_result_ok ) {
+		fprintf( stderr, "bench_logger: couldn't add the endpoint\n" );
+		axbench_fini( &bench );
+		return 2;
+	}
+
+	{
+		char szBuf[ 128 ];
+		axlog_report_t rep;
+
+		ax::runBenchmark( bench, "logger/init_report", 1, "op", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				initReport( szBuf, sizeof( szBuf ), &rep, axbench_u32_t( i ) );
+				AXBENCH_KEEP( szBuf );
+			}
+		} );
+	}
+
+	const axbench_u32_t cMaxThreads = axbench_max_threads( &bench );
+	for( axbench_u32_t cThreads = 1; cThreads <= cMaxThreads; cThreads *= 2 ) {
+		snprintf( szName, sizeof( szName ), "logger/submit/sync/t%u", unsigned( cThreads ) );
+		runSubmit( bench, szName, cThreads );
+	}
+
+#if AXLOG_ASYNC_ENABLED
+	/* blocking on overflow, so a full ring costs what it would in practice rather than being dropped */
+	if( axlog_async_start( axlog_overflow_block ) == axlog_async_start_result_ok ) {
+		for( axbench_u32_t cThreads = 1; cThreads <= cMaxThreads; cThreads *= 2 ) {
+			snprintf( szName, sizeof( szName ), "logger/submit/async/t%u", unsigned( cThreads ) );
+			runSubmit( bench, szName, cThreads );
+		}
+
+# if AXLOG_DEFERRED_ENABLED
+		runDefer( bench, "logger/deferf/async", ( const axpf_format_t * )0 );
+#  if AXLOG_COMPILED_ENABLED
+		axpf_format_t *pFmt = axpf_compile( "thread %u: loaded %d items in %.2f ms", ( const char * )0 );
+		if( pFmt != ( axpf_format_t * )0 ) {
+			runDefer( bench, "logger/defercf/async", pFmt );
+			axpf_free_format( pFmt );
+		}
+#  endif
+# endif
+
+		axlog_async_stop();
+	} else {
+		fprintf( stderr, "bench_logger: couldn't start the asynchronous backend\n" );
+	}
+#endif
+
+	( void )axlog_remove_filter( axlog_filter_endpoint, &nullEndpoint_f, ( void * )0 );
+	return axbench_fini( &bench );
+}
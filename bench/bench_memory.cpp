@@ -0,0 +1,157 @@
+/*
+
+	bench_memory - ax_memory phased heaps and hierarchical allocations
+
+	c++ -O2 -I include bench/bench_memory.cpp -o bench_memory -lpthread
+
+	Phased allocation is measured on 1, 2, 4, ... threads (up to --threads),
+	next to malloc/free used the same way: each thread allocates a phase's
+	worth of objects, then releases the whole phase. Hierarchical allocation
+	is measured by building a tree of objects and tearing it down with a
+	single axmm_h_free() of the root. See ax_bench.h for the options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXMM_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_memory.h"
+#include "ax_bench.h"
+
+/* allocations per phase, per thread */
+#define PHASE_ALLOCS 4096
+/* objects in each hierarchical tree */
+#define TREE_NODES 1024
+
+static axmm_phased_heap_t           g_Heap;
+
+static void runPhased( axbench_t &bench, axbench_u32_t cThreads, axmm_size_t cBytes )
+{
+	char szName[ AXBENCH_MAX_NAME ];
+
+	/* each thread has its own tag (phase), so freeing one doesn't race the others */
+	snprintf( szName, sizeof( szName ), "memory/phased_alloc/%uB/t%u", unsigned( cBytes ), unsigned( cThreads ) );
+	ax::runBenchmarkMT( bench, szName, cThreads, 1, "op", [&]( axbench_u32_t uThread, axbench_u64_t cIters ) {
+		const unsigned uTag = 1 + uThread;
+
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			void *p = axmm_phased_alloc( &g_Heap, uTag, cBytes );
+			AXBENCH_KEEP( p );
+
+			if( ( i + 1 )%PHASE_ALLOCS == 0 ) {
+				axmm_phased_free( &g_Heap, uTag );
+			}
+		}
+		axmm_phased_free( &g_Heap, uTag );
+		axmm_phased_unregister_thread( &g_Heap );
+	} );
+
+	snprintf( szName, sizeof( szName ), "memory/phased_alloc/%uB/t%u/malloc", unsigned( cBytes ), unsigned( cThreads ) );
+	ax::runBenchmarkMT( bench, szName, cThreads, 1, "op", [&]( axbench_u32_t, axbench_u64_t cIters ) {
+		void **const pPhase = ( void ** )malloc( sizeof( void * )*PHASE_ALLOCS );
+		axbench_u64_t n = 0;
+
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			pPhase[ n ] = malloc( cBytes );
+			AXBENCH_KEEP( pPhase[ n ] );
+
+			if( ++n == PHASE_ALLOCS ) {
+				while( n > 0 ) {
+					free( pPhase[ --n ] );
+				}
+			}
+		}
+		while( n > 0 ) {
+			free( pPhase[ --n ] );
+		}
+
+		free( ( void * )pPhase );
+	} );
+}
+
+/* each node's parent is an earlier node picked by a fixed pseudo-random sequence */
+static void *buildTree( void **pNodes, axmm_size_t cBytes )
+{
+	axbench_u32_t x = 12345;
+
+	pNodes[ 0 ] = axmm_h_alloc( cBytes );
+	for( unsigned i = 1; i < TREE_NODES; ++i ) {
+		x = x*1664525 + 1013904223;
+		pNodes[ i ] = axmm_h_suballoc( pNodes[ ( x >> 8 )%i ], cBytes );
+	}
+
+	return pNodes[ 0 ];
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+	char szName[ AXBENCH_MAX_NAME ];
+
+	if( !axbench_init( &bench, "memory", argc, argv ) ) {
+		return 2;
+	}
+
+	if( !axmm_phased_init( &g_Heap, ( void * )0, 0 ) ) {
+		fprintf( stderr, "bench_memory: axmm_phased_init failed\n" );
+		axbench_fini( &bench );
+		return 2;
+	}
+
+	/* tag 0 is left alone, so threads get tags 1 and up */
+	axbench_u32_t cMaxThreads = axbench_max_threads( &bench );
+	if( cMaxThreads > AXMM_MAX_TAGS - 1 ) {
+		cMaxThreads = AXMM_MAX_TAGS - 1;
+	}
+
+	static const axmm_size_t cSizes[] = { 16, 64, 512 };
+	for( const axmm_size_t cBytes : cSizes ) {
+		for( axbench_u32_t cThreads = 1; cThreads <= cMaxThreads; cThreads *= 2 ) {
+			runPhased( bench, cThreads, cBytes );
+		}
+	}
+
+	axmm_phased_fini( &g_Heap );
+
+	void *pNodes[ TREE_NODES ];
+	static const axmm_size_t cNodeSizes[] = { 32, 256 };
+	for( const axmm_size_t cBytes : cNodeSizes ) {
+		snprintf( szName, sizeof( szName ), "memory/h_tree/build_teardown/%uB", unsigned( cBytes ) );
+		ax::runBenchmark( bench, szName, TREE_NODES, "node", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				axmm_h_free( buildTree( pNodes, cBytes ) );
+			}
+		} );
+
+		snprintf( szName, sizeof( szName ), "memory/h_tree/build/%uB", unsigned( cBytes ) );
+		ax::runBenchmark( bench, szName, TREE_NODES, "node", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				void *const pRoot = buildTree( pNodes, cBytes );
+
+				axbench_pause( &bench );
+				axmm_h_free( pRoot );
+				axbench_resume( &bench );
+			}
+		} );
+
+		snprintf( szName, sizeof( szName ), "memory/h_tree/teardown/%uB", unsigned( cBytes ) );
+		ax::runBenchmark( bench, szName, TREE_NODES, "node", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				axbench_pause( &bench );
+				void *const pRoot = buildTree( pNodes, cBytes );
+				axbench_resume( &bench );
+
+				axmm_h_free( pRoot );
+			}
+		} );
+	}
+
+	return axbench_fini( &bench );
+}
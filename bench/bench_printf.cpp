@@ -0,0 +1,112 @@
+/*
+
+	bench_printf - ax_printf formatting throughput
+
+	c++ -O2 -I include bench/bench_printf.cpp -o bench_printf -lpthread
+
+	Formats integers and floating-point values into a buffer with axspf, next
+	to snprintf with the same format. Each iteration formats one value; the
+	values cycle through a table so no single one dominates. See ax_bench.h
+	for the options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <string.h>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXPRINTF_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_printf.h"
+#include "ax_bench.h"
+
+#define VALUE_COUNT 256
+
+static int                          g_Ints[ VALUE_COUNT ];
+static double                       g_Doubles[ VALUE_COUNT ];
+
+static void initValues()
+{
+	axbench_u32_t x = 0x9E3779B9;
+
+	for( unsigned i = 0; i < VALUE_COUNT; ++i ) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+
+		/* a spread of magnitudes, with both signs */
+		g_Ints[ i ] = int( x >> ( i%31 ) )*( i%2 ? -1 : 1 );
+		g_Doubles[ i ] = double( int( x ) )/double( 1u << ( i%24 ) );
+	}
+}
+
+template< typename TValue >
+static void runFormat( axbench_t &bench, const char *pszName, const char *pszFormat, const TValue *pValues )
+{
+	char szName[ AXBENCH_MAX_NAME ];
+	char szBuf[ 128 ];
+
+	snprintf( szName, sizeof( szName ), "printf/%s", pszName );
+	ax::runBenchmark( bench, szName, 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			axpf_ptrdiff_t r = axspf( szBuf, sizeof( szBuf ), pszFormat, pValues[ i%VALUE_COUNT ] );
+			AXBENCH_KEEP( &r );
+			AXBENCH_KEEP( szBuf );
+		}
+	} );
+
+	snprintf( szName, sizeof( szName ), "printf/%s/snprintf", pszName );
+	ax::runBenchmark( bench, szName, 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			int r = snprintf( szBuf, sizeof( szBuf ), pszFormat, pValues[ i%VALUE_COUNT ] );
+			AXBENCH_KEEP( &r );
+			AXBENCH_KEEP( szBuf );
+		}
+	} );
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+
+	if( !axbench_init( &bench, "printf", argc, argv ) ) {
+		return 2;
+	}
+
+	initValues();
+
+	runFormat( bench, "int/d", "%d", g_Ints );
+	runFormat( bench, "int/x", "%08x", g_Ints );
+	runFormat( bench, "int/padded", "[%-12d]", g_Ints );
+
+	runFormat( bench, "float/f", "%f", g_Doubles );
+	runFormat( bench, "float/.3f", "%.3f", g_Doubles );
+	runFormat( bench, "float/e", "%e", g_Doubles );
+	runFormat( bench, "float/g", "%g", g_Doubles );
+	runFormat( bench, "float/.17g", "%.17g", g_Doubles );
+
+	/* several conversions in one call */
+	char szBuf[ 256 ];
+	ax::runBenchmark( bench, "printf/mixed", 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			const unsigned j = unsigned( i%VALUE_COUNT );
+			axpf_ptrdiff_t r = axspf( szBuf, sizeof( szBuf ), "%s:%d: %s (%.2f ms, %u items)", "source.cpp", g_Ints[ j ], "something happened", g_Doubles[ j ], unsigned( j ) );
+			AXBENCH_KEEP( &r );
+			AXBENCH_KEEP( szBuf );
+		}
+	} );
+	ax::runBenchmark( bench, "printf/mixed/snprintf", 1, "op", [&]( axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			const unsigned j = unsigned( i%VALUE_COUNT );
+			int r = snprintf( szBuf, sizeof( szBuf ), "%s:%d: %s (%.2f ms, %u items)", "source.cpp", g_Ints[ j ], "something happened", g_Doubles[ j ], unsigned( j ) );
+			AXBENCH_KEEP( &r );
+			AXBENCH_KEEP( szBuf );
+		}
+	} );
+
+	return axbench_fini( &bench );
+}
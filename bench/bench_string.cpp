@@ -0,0 +1,171 @@
+/*
+
+	bench_string - ax_string scanning and UTF-8/UTF-16 transcoding
+
+	c++ -O2 -I include bench/bench_string.cpp -o bench_string -lpthread
+
+	Each routine runs over inputs of several sizes, next to the C library's
+	equivalent where there is one. See ax_bench.h for the options.
+
+*/
+
+#include <wchar.h>
+#include <string.h>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXSTR_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_string.h"
+#include "ax_bench.h"
+
+static const axstr_size_t           g_Sizes[] = { 16, 256, 4096, 65536 };
+
+static const char *sizeName( axstr_size_t n )
+{
+	switch( n ) {
+	case 16:    return "16";
+	case 256:   return "256";
+	case 4096:  return "4k";
+	case 65536: return "64k";
+	}
+	return "?";
+}
+
+/* ASCII text with no NUL or needle before the end */
+static void fillText( char *pszDst, axstr_size_t n )
+{
+	static const char szWords[] = "the quick brown fox jumps over the lazy dog ";
+	axstr_size_t i;
+
+	for( i = 0; i < n; ++i ) {
+		pszDst[ i ] = szWords[ i%( sizeof( szWords ) - 1 ) ];
+	}
+	pszDst[ n ] = '\0';
+}
+
+/* UTF-8 text that's about half two- and three-byte sequences */
+static axstr_size_t fillMixedUTF8( axstr_utf8_t *pDst, axstr_size_t n )
+{
+	static const char *const pszPieces[] = { "abc ", "\xC3\xA9t\xC3\xA9 ", "\xE6\x97\xA5\xE6\x9C\xAC ", "x" };
+	axstr_size_t i, j;
+	const char *s;
+
+	i = 0;
+	for( j = 0; ; ++j ) {
+		s = pszPieces[ j%4 ];
+		if( i + strlen( s ) > n ) {
+			break;
+		}
+		while( *s != '\0' ) {
+			pDst[ i++ ] = ( axstr_utf8_t )*s++;
+		}
+	}
+	while( i < n ) {
+		pDst[ i++ ] = ( axstr_utf8_t )' ';
+	}
+	pDst[ n ] = 0;
+
+	return n;
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+	char szName[ AXBENCH_MAX_NAME ];
+
+	if( !axbench_init( &bench, "string", argc, argv ) ) {
+		return 2;
+	}
+
+	const axstr_size_t cMaxBytes = g_Sizes[ sizeof( g_Sizes )/sizeof( g_Sizes[0] ) - 1 ];
+	char *const pszText = new char[ cMaxBytes + 1 ];
+	axstr_utf8_t *const pUTF8 = new axstr_utf8_t[ cMaxBytes + 1 ];
+	axstr_utf16_t *const pUTF16 = new axstr_utf16_t[ cMaxBytes + 1 ];
+	axstr_utf8_t *const pUTF8Out = new axstr_utf8_t[ cMaxBytes*3 + 1 ];
+
+	for( const axstr_size_t n : g_Sizes ) {
+		const double fBytes = double( n );
+
+		fillText( pszText, n );
+
+		snprintf( szName, sizeof( szName ), "string/len/%s", sizeName( n ) );
+		ax::runBenchmark( bench, szName, fBytes, "B", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				AXBENCH_KEEP( pszText );
+				axstr_size_t r = axstr_len( pszText );
+				AXBENCH_KEEP( &r );
+			}
+		} );
+		snprintf( szName, sizeof( szName ), "string/len/%s/strlen", sizeName( n ) );
+		ax::runBenchmark( bench, szName, fBytes, "B", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				AXBENCH_KEEP( pszText );
+				axstr_size_t r = strlen( pszText );
+				AXBENCH_KEEP( &r );
+			}
+		} );
+
+		/* the needle only matches at the very end, after many partial matches */
+		static const char szNeedle[] = "the lazy cat";
+		memcpy( &pszText[ n - ( sizeof( szNeedle ) - 1 ) ], szNeedle, sizeof( szNeedle ) - 1 );
+
+		snprintf( szName, sizeof( szName ), "string/findstrn/%s", sizeName( n ) );
+		ax::runBenchmark( bench, szName, fBytes, "B", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				AXBENCH_KEEP( pszText );
+				char *r = axstr_findstrn( pszText, szNeedle, sizeof( szNeedle ) - 1 );
+				AXBENCH_KEEP( r );
+			}
+		} );
+		snprintf( szName, sizeof( szName ), "string/findstrn/%s/strstr", sizeName( n ) );
+		ax::runBenchmark( bench, szName, fBytes, "B", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				AXBENCH_KEEP( pszText );
+				const char *r = strstr( pszText, szNeedle );
+				AXBENCH_KEEP( r );
+			}
+		} );
+
+		/* transcoding, for ASCII and for mixed input */
+		for( int bMixed = 0; bMixed < 2; ++bMixed ) {
+			const char *const pszKind = bMixed ? "mixed" : "ascii";
+
+			if( bMixed ) {
+				fillMixedUTF8( pUTF8, n );
+			} else {
+				fillText( ( char * )pUTF8, n );
+			}
+
+			snprintf( szName, sizeof( szName ), "string/utf8_to_utf16/%s/%s", pszKind, sizeName( n ) );
+			ax::runBenchmark( bench, szName, fBytes, "B", [&]( axbench_u64_t cIters ) {
+				for( axbench_u64_t i = 0; i < cIters; ++i ) {
+					axstr_bool_t r = axstr_utf8_to_utf16_n( pUTF16, cMaxBytes + 1, pUTF8, pUTF8 + n );
+					AXBENCH_KEEP( &r );
+					AXBENCH_KEEP( pUTF16 );
+				}
+			} );
+
+			axstr_utf8_to_utf16_n( pUTF16, cMaxBytes + 1, pUTF8, pUTF8 + n );
+			const axstr_size_t cUnits = axstr_utf8_to_utf16_len_n( pUTF8, pUTF8 + n );
+
+			snprintf( szName, sizeof( szName ), "string/utf16_to_utf8/%s/%s", pszKind, sizeName( n ) );
+			ax::runBenchmark( bench, szName, fBytes, "B", [&]( axbench_u64_t cIters ) {
+				for( axbench_u64_t i = 0; i < cIters; ++i ) {
+					axstr_bool_t r = axstr_utf16_to_utf8_n( pUTF8Out, cMaxBytes*3 + 1, pUTF16, pUTF16 + cUnits );
+					AXBENCH_KEEP( &r );
+					AXBENCH_KEEP( pUTF8Out );
+				}
+			} );
+		}
+	}
+
+	delete [] pUTF8Out;
+	delete [] pUTF16;
+	delete [] pUTF8;
+	delete [] pszText;
+
+	return axbench_fini( &bench );
+}
@@ -0,0 +1,188 @@
+/*
+
+	bench_thread - ax_thread synchronization and ax_fiber switching
+
+	c++ -O2 -I include bench/bench_thread.cpp -o bench_thread -lpthread
+
+	To measure ax_fiber's ucontext backend instead of the assembly one (on
+	x86-64 and AArch64, where the assembly backend is the default), build a
+	second copy with it turned off:
+
+	c++ -O2 -DAXFIBER_CONTEXT_ASM=0 -I include bench/bench_thread.cpp -o bench_thread_ucontext -lpthread
+
+	Locks are measured on 1, 2, 4, ... threads (up to --threads), each thread
+	taking the lock around a tiny critical section in a loop, so anything above
+	one thread is as contended as it gets. Read/write lock threads set their
+	worker ID to their thread index, as the job system's workers would, so
+	CScalableRWLock's readers each count in their own slot. Semaphores are measured handing a
+	token back and forth between two threads. Fiber switching is measured as a
+	round trip to another fiber and back, under a name that says which backend
+	was compiled in ("asm", "ucontext" or "windows"), so one build's result
+	is never compared against the other's baseline. See ax_bench.h for the
+	options.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXTIME_IMPLEMENTATION
+#define AXMM_IMPLEMENTATION
+#define AXFIBER_IMPLEMENTATION
+#define AXBENCH_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_time.h"
+#include "ax_memory.h"
+#include "ax_fiber.h"
+#include "ax_bench.h"
+
+/* the ax_fiber backend this was built with */
+#if AXFIBER_IMPL_WINDOWS
+# define FIBER_BACKEND "windows"
+#elif AXFIBER_CONTEXT_ASM
+# define FIBER_BACKEND "asm"
+#else
+# define FIBER_BACKEND "ucontext"
+#endif
+
+/* every lock benchmark guards this */
+static volatile axbench_u64_t       g_uCounter;
+
+template< typename TMutex >
+static void runMutex( axbench_t &bench, const char *pszName, axbench_u32_t cThreads )
+{
+	char szName[ AXBENCH_MAX_NAME ];
+	TMutex mutex;
+
+	snprintf( szName, sizeof( szName ), "thread/%s/t%u", pszName, unsigned( cThreads ) );
+	ax::runBenchmarkMT( bench, szName, cThreads, 1, "op", [&]( axbench_u32_t, axbench_u64_t cIters ) {
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			mutex.lock();
+			g_uCounter = g_uCounter + 1;
+			mutex.unlock();
+		}
+	} );
+}
+
+/* one write for every `cReadsPerWrite` reads; each thread gets its own worker ID, so CScalableRWLock readers use separate slots */
+template< typename TRWLock >
+static void runRWLock( axbench_t &bench, const char *pszName, axbench_u32_t cThreads, axbench_u32_t cReadsPerWrite )
+{
+	char szName[ AXBENCH_MAX_NAME ];
+	TRWLock rwlock;
+
+	if( cReadsPerWrite > 0 ) {
+		snprintf( szName, sizeof( szName ), "thread/%s/%ur1w/t%u", pszName, unsigned( cReadsPerWrite ), unsigned( cThreads ) );
+	} else {
+		snprintf( szName, sizeof( szName ), "thread/%s/read/t%u", pszName, unsigned( cThreads ) );
+	}
+	ax::runBenchmarkMT( bench, szName, cThreads, 1, "op", [&]( axbench_u32_t uThread, axbench_u64_t cIters ) {
+		const axth_u32_t uOldWorkerId = axth_get_worker_id();
+
+		axth_set_worker_id( uThread );
+		for( axbench_u64_t i = 0; i < cIters; ++i ) {
+			if( cReadsPerWrite > 0 && i%( cReadsPerWrite + 1 ) == cReadsPerWrite ) {
+				rwlock.writeLock();
+				g_uCounter = g_uCounter + 1;
+				rwlock.writeUnlock();
+			} else {
+				rwlock.readLock();
+				axbench_u64_t x = g_uCounter;
+				AXBENCH_KEEP( &x );
+				rwlock.readUnlock();
+			}
+		}
+		axth_set_worker_id( uOldWorkerId );
+	} );
+}
+
+/* implementation: the fiber on the other end of the round trip */
+struct SFiberPair
+{
+	axfiber_t                       Main;
+	axfiber_t                       Other;
+};
+static void AXFIBER_OS_CALL switchBack_f( void *pData )
+{
+	SFiberPair *const p = ( SFiberPair * )pData;
+
+	for(;;) {
+		axfi_switch( &p->Main );
+	}
+}
+
+int main( int argc, char **argv )
+{
+	axbench_t bench;
+	char szName[ AXBENCH_MAX_NAME ];
+
+	if( !axbench_init( &bench, "thread", argc, argv ) ) {
+		return 2;
+	}
+
+	const axbench_u32_t cMaxThreads = axbench_max_threads( &bench );
+
+	for( axbench_u32_t cThreads = 1; cThreads <= cMaxThreads; cThreads *= 2 ) {
+		runMutex< ax::CQuickMutex >( bench, "qmutex", cThreads );
+		runMutex< ax::CTicketMutex >( bench, "ticket_mutex", cThreads );
+		runMutex< ax::CAdaptiveMutex >( bench, "adaptive_mutex", cThreads );
+	}
+	for( axbench_u32_t cThreads = 1; cThreads <= cMaxThreads; cThreads *= 2 ) {
+		runRWLock< ax::CRWLock >( bench, "rwlock", cThreads, 0 );
+		runRWLock< ax::CRWLock >( bench, "rwlock", cThreads, 15 );
+		runRWLock< ax::CScalableRWLock >( bench, "scalable_rwlock", cThreads, 0 );
+		runRWLock< ax::CScalableRWLock >( bench, "scalable_rwlock", cThreads, 15 );
+	}
+
+	/* thread 0 signals A and waits on B; thread 1 does the reverse (each iteration is one handoff) */
+	{
+		ax::CSemaphore sems[ 2 ];
+
+		ax::runBenchmarkMT( bench, "thread/semaphore/ping_pong", 2, 1, "handoff", [&]( axbench_u32_t uThread, axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				if( uThread == 0 ) {
+					sems[ 0 ].signal();
+					sems[ 1 ].wait();
+				} else {
+					sems[ 0 ].wait();
+					sems[ 1 ].signal();
+				}
+			}
+		} );
+	}
+
+	/* uncontended: every signal is matched by a wait on the same thread */
+	for( axbench_u32_t cThreads = 1; cThreads <= cMaxThreads; cThreads *= 2 ) {
+		ax::CSemaphore sem;
+
+		snprintf( szName, sizeof( szName ), "thread/semaphore/signal_wait/t%u", unsigned( cThreads ) );
+		ax::runBenchmarkMT( bench, szName, cThreads, 1, "op", [&]( axbench_u32_t, axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				sem.signal();
+				sem.wait();
+			}
+		} );
+	}
+
+	{
+		SFiberPair pair;
+
+		if( !axfi_thread_to_fiber( &pair.Main, ( void * )0 ) || !axfi_init( &pair.Other, 64*1024, &switchBack_f, ( void * )&pair ) ) {
+			fprintf( stderr, "bench_thread: couldn't set up fibers\n" );
+			axbench_fini( &bench );
+			return 2;
+		}
+
+		ax::runBenchmark( bench, "thread/fiber/" FIBER_BACKEND "/switch_round_trip", 2, "switch", [&]( axbench_u64_t cIters ) {
+			for( axbench_u64_t i = 0; i < cIters; ++i ) {
+				axfi_switch( &pair.Other );
+			}
+		} );
+
+		axfi_fini( &pair.Other );
+		axfi_fiber_to_thread();
+	}
+
+	return axbench_fini( &bench );
+}
@@ -15,6 +15,11 @@
 
 	This library will use ax_types if it has been included prior to this header.
 
+	The parallel algorithms (parallelSort(), parallelForEach() and
+	parallelReduce()) split their work into jobs on an ax_job system. They live
+	in ax_array_parallel.hpp, which is included automatically once both this
+	header and ax_job.h have been, in either order; see AXARR_PARALLEL_ENABLED.
+
 
 	LICENSE
 	=======
@@ -217,6 +222,67 @@ inline void operator delete( void *, void *, ax::detail::SPlcmntNw )
 # error AXARR_MEMCPY needs to be defined if AXARR_MEMSET is also defined
 #endif
 
+/*! \def     AXARR_SIMD_ENABLED
+ *  \brief   Optional user-supplied macro controlling whether `TArr::find()`,
+ *           `TArr::count()`, `TArr::findMin()` and `TArr::findMax()` use
+ *           vector instructions for arithmetic element types.
+ *  \details SSE2 is used on x86/x64 and NEON on AArch64. Defaults to
+ *           `AX_INTRINSICS_ENABLED` if that is defined, or `1` otherwise.
+ */
+#ifndef AXARR_SIMD_ENABLED
+# ifdef AX_INTRINSICS_ENABLED
+#  define AXARR_SIMD_ENABLED        AX_INTRINSICS_ENABLED
+# else
+#  define AXARR_SIMD_ENABLED        1
+# endif
+#endif
+
+#define AXARR__SIMD_SSE2            0
+#define AXARR__SIMD_NEON            0
+#if AXARR_SIMD_ENABLED
+# if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#  undef  AXARR__SIMD_SSE2
+#  define AXARR__SIMD_SSE2          1
+#  include <emmintrin.h>
+# elif ( defined( __ARM_NEON ) && defined( __aarch64__ ) ) || defined( _M_ARM64 )
+#  undef  AXARR__SIMD_NEON
+#  define AXARR__SIMD_NEON          1
+#  include <arm_neon.h>
+# endif
+# if defined( _MSC_VER )
+#  include <intrin.h>
+# endif
+#endif
+#define AXARR__SIMD                 ( AXARR__SIMD_SSE2 | AXARR__SIMD_NEON )
+
+/*! \def     AXARR_PARALLEL_ENABLED
+ *  \brief   Optional user-supplied macro controlling whether the parallel
+ *           algorithms (`parallelSort()`, `parallelForEach()` and
+ *           `parallelReduce()`) are available.
+ *  \details These run on an ax_job system, and are defined in
+ *           ax_array_parallel.hpp once ax_job.h has been included (before or
+ *           after this header; this header doesn't include it, as ax_job.h
+ *           indirectly includes this). Defaults to `1`.
+ */
+#ifndef AXARR_PARALLEL_ENABLED
+# define AXARR_PARALLEL_ENABLED     1
+#endif
+
+/*! \def     AXARR_RADIX_SORT_MIN
+ *  \brief   Fewest elements for which `sort()` picks radix sort (for element
+ *           types with a `TRadixKey`) over introsort.
+ */
+#ifndef AXARR_RADIX_SORT_MIN
+# define AXARR_RADIX_SORT_MIN       256
+#endif
+
+/*! \def     AXARR_PARALLEL_MIN_CHUNK
+ *  \brief   Fewest elements the parallel algorithms hand to a single job.
+ */
+#ifndef AXARR_PARALLEL_MIN_CHUNK
+# define AXARR_PARALLEL_MIN_CHUNK   16384
+#endif
+
 namespace ax
 {
 
@@ -413,6 +479,364 @@ namespace ax
 		};
 
 	}
+
+	namespace detail
+	{
+
+		// How the vectorized searches treat an element type's bits
+		enum EArrSimdKind
+		{
+			kArrSimdNone,
+			kArrSimdSInt,
+			kArrSimdUInt,
+			kArrSimdFloat
+		};
+
+		template< typename T > struct TArrSimdKind { static const EArrSimdKind value = kArrSimdNone; };
+		template<> struct TArrSimdKind< char > { static const EArrSimdKind value = char( -1 ) < char( 0 ) ? kArrSimdSInt : kArrSimdUInt; };
+		template<> struct TArrSimdKind< signed char > { static const EArrSimdKind value = kArrSimdSInt; };
+		template<> struct TArrSimdKind< unsigned char > { static const EArrSimdKind value = kArrSimdUInt; };
+		template<> struct TArrSimdKind< signed short > { static const EArrSimdKind value = kArrSimdSInt; };
+		template<> struct TArrSimdKind< unsigned short > { static const EArrSimdKind value = kArrSimdUInt; };
+		template<> struct TArrSimdKind< signed int > { static const EArrSimdKind value = kArrSimdSInt; };
+		template<> struct TArrSimdKind< unsigned int > { static const EArrSimdKind value = kArrSimdUInt; };
+		template<> struct TArrSimdKind< signed long > { static const EArrSimdKind value = kArrSimdSInt; };
+		template<> struct TArrSimdKind< unsigned long > { static const EArrSimdKind value = kArrSimdUInt; };
+		template<> struct TArrSimdKind< signed long long > { static const EArrSimdKind value = kArrSimdSInt; };
+		template<> struct TArrSimdKind< unsigned long long > { static const EArrSimdKind value = kArrSimdUInt; };
+		template<> struct TArrSimdKind< float > { static const EArrSimdKind value = kArrSimdFloat; };
+		template<> struct TArrSimdKind< double > { static const EArrSimdKind value = kArrSimdFloat; };
+
+		inline unsigned arrCtz64( unsigned long long m )
+		{
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_ARM64 ) )
+			unsigned long i;
+			_BitScanForward64( &i, m );
+			return unsigned( i );
+#elif defined( _MSC_VER )
+			unsigned long i;
+			if( _BitScanForward( &i, ( unsigned long )m ) ) {
+				return unsigned( i );
+			}
+			_BitScanForward( &i, ( unsigned long )( m >> 32 ) );
+			return unsigned( i ) + 32;
+#else
+			return unsigned( __builtin_ctzll( m ) );
+#endif
+		}
+		inline unsigned arrPopcount64( unsigned long long m )
+		{
+			unsigned n = 0;
+			while( m ) {
+				m &= m - 1;
+				++n;
+			}
+			return n;
+		}
+
+		// Vector operations on one 16-byte register of `T`
+		//
+		// Comparisons produce all-ones lanes, which mask() packs into
+		// kMaskBits bits per byte of the register (so each element owns
+		// kMaskBits*sizeof(T) consecutive bits).
+		template< typename T, EArrSimdKind tKind = TArrSimdKind< T >::value, axarr_size_t tSize = sizeof( T ) >
+		struct TArrLane
+		{
+			static const bool kEqual = false;
+			static const bool kOrder = false;
+		};
+
+#if AXARR__SIMD_SSE2
+		struct SArrLaneBase
+		{
+			typedef __m128i Vec;
+
+			static const unsigned kMaskBits = 1;
+
+			static inline Vec load( const void *p ) { return _mm_loadu_si128( ( const __m128i * )p ); }
+			static inline unsigned long long mask( Vec m ) { return ( unsigned long long )( unsigned )_mm_movemask_epi8( m ); }
+			static inline Vec select( Vec m, Vec a, Vec b ) { return _mm_or_si128( _mm_and_si128( m, a ), _mm_andnot_si128( m, b ) ); }
+		};
+
+		template< typename T > struct TArrLane< T, kArrSimdSInt, 1 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_cmpeq_epi8( a, b ); }
+			static inline Vec less( Vec a, Vec b ) { return _mm_cmplt_epi8( a, b ); }
+		};
+		template< typename T > struct TArrLane< T, kArrSimdSInt, 2 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_cmpeq_epi16( a, b ); }
+			static inline Vec less( Vec a, Vec b ) { return _mm_cmplt_epi16( a, b ); }
+		};
+		template< typename T > struct TArrLane< T, kArrSimdSInt, 4 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_cmpeq_epi32( a, b ); }
+			static inline Vec less( Vec a, Vec b ) { return _mm_cmplt_epi32( a, b ); }
+		};
+		// SSE2 has no unsigned compares; flipping the sign bit maps them onto signed ones
+		template< typename T > struct TArrLane< T, kArrSimdUInt, 1 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_cmpeq_epi8( a, b ); }
+			static inline Vec less( Vec a, Vec b ) { const Vec k = _mm_set1_epi8( char( 0x80 ) ); return _mm_cmplt_epi8( _mm_xor_si128( a, k ), _mm_xor_si128( b, k ) ); }
+		};
+		template< typename T > struct TArrLane< T, kArrSimdUInt, 2 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_cmpeq_epi16( a, b ); }
+			static inline Vec less( Vec a, Vec b ) { const Vec k = _mm_set1_epi16( short( 0x8000 ) ); return _mm_cmplt_epi16( _mm_xor_si128( a, k ), _mm_xor_si128( b, k ) ); }
+		};
+		template< typename T > struct TArrLane< T, kArrSimdUInt, 4 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_cmpeq_epi32( a, b ); }
+			static inline Vec less( Vec a, Vec b ) { const Vec k = _mm_set1_epi32( int( 0x80000000 ) ); return _mm_cmplt_epi32( _mm_xor_si128( a, k ), _mm_xor_si128( b, k ) ); }
+		};
+		// 64-bit lanes are equal when both of their 32-bit halves are; there's no 64-bit ordering in SSE2
+		template< typename T, EArrSimdKind tKind > struct TArrLane< T, tKind, 8 >: SArrLaneBase
+		{
+			static const bool kEqual = tKind == kArrSimdSInt || tKind == kArrSimdUInt;
+			static const bool kOrder = false;
+
+			static inline Vec equal( Vec a, Vec b ) { const Vec m = _mm_cmpeq_epi32( a, b ); return _mm_and_si128( m, _mm_shuffle_epi32( m, _MM_SHUFFLE( 2, 3, 0, 1 ) ) ); }
+		};
+		template< typename T > struct TArrLane< T, kArrSimdFloat, 4 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_castps_si128( _mm_cmpeq_ps( _mm_castsi128_ps( a ), _mm_castsi128_ps( b ) ) ); }
+			static inline Vec less( Vec a, Vec b ) { return _mm_castps_si128( _mm_cmplt_ps( _mm_castsi128_ps( a ), _mm_castsi128_ps( b ) ) ); }
+		};
+		template< typename T > struct TArrLane< T, kArrSimdFloat, 8 >: SArrLaneBase
+		{
+			static const bool kEqual = true;
+			static const bool kOrder = true;
+
+			static inline Vec equal( Vec a, Vec b ) { return _mm_castpd_si128( _mm_cmpeq_pd( _mm_castsi128_pd( a ), _mm_castsi128_pd( b ) ) ); }
+			static inline Vec less( Vec a, Vec b ) { return _mm_castpd_si128( _mm_cmplt_pd( _mm_castsi128_pd( a ), _mm_castsi128_pd( b ) ) ); }
+		};
+#elif AXARR__SIMD_NEON
+		struct SArrLaneBase
+		{
+			typedef uint8x16_t Vec;
+
+			static const unsigned kMaskBits = 4;
+
+			static inline Vec load( const void *p ) { return vld1q_u8( ( const uint8_t * )p ); }
+			// narrow each 0x00/0xFF byte to a nibble so the mask fits in 64 bits
+			static inline unsigned long long mask( Vec m ) { return vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( m ), 4 ) ), 0 ); }
+			static inline Vec select( Vec m, Vec a, Vec b ) { return vbslq_u8( m, a, b ); }
+		};
+
+# define AXARR__NEON_LANE(Kind_,Size_,Suffix_)\
+		template< typename T > struct TArrLane< T, Kind_, Size_ >: SArrLaneBase\
+		{\
+			static const bool kEqual = true;\
+			static const bool kOrder = true;\
+			\
+			static inline Vec equal( Vec a, Vec b ) { return vreinterpretq_u8_##Suffix_( vceqq_##Suffix_( vreinterpretq_##Suffix_##_u8( a ), vreinterpretq_##Suffix_##_u8( b ) ) ); }\
+			static inline Vec less( Vec a, Vec b ) { return vreinterpretq_u8_##Suffix_( vcltq_##Suffix_( vreinterpretq_##Suffix_##_u8( a ), vreinterpretq_##Suffix_##_u8( b ) ) ); }\
+		}
+		AXARR__NEON_LANE( kArrSimdSInt, 1, s8 );
+		AXARR__NEON_LANE( kArrSimdSInt, 2, s16 );
+		AXARR__NEON_LANE( kArrSimdSInt, 4, s32 );
+		AXARR__NEON_LANE( kArrSimdSInt, 8, s64 );
+		AXARR__NEON_LANE( kArrSimdUInt, 1, u8 );
+		AXARR__NEON_LANE( kArrSimdUInt, 2, u16 );
+		AXARR__NEON_LANE( kArrSimdUInt, 4, u32 );
+		AXARR__NEON_LANE( kArrSimdUInt, 8, u64 );
+		AXARR__NEON_LANE( kArrSimdFloat, 4, f32 );
+		AXARR__NEON_LANE( kArrSimdFloat, 8, f64 );
+# undef AXARR__NEON_LANE
+#endif
+
+		// Element-wise searches backing `TArr::find()` and friends
+		//
+		// The scalar versions only need `operator==` (find, count) or
+		// `operator<` (findMin, findMax), so they work for any type.
+		template< typename T, bool tVector = TArrLane< T >::kEqual >
+		struct TArrSearch
+		{
+			static inline const T *find( const T *s, const T *e, const T &x )
+			{
+				for( const T *p = s; p != e; ++p ) {
+					if( *p == x ) {
+						return p;
+					}
+				}
+
+				return ( const T * )0;
+			}
+			static inline axarr_size_t count( const T *s, const T *e, const T &x )
+			{
+				axarr_size_t n = 0;
+				for( const T *p = s; p != e; ++p ) {
+					n += *p == x ? 1 : 0;
+				}
+
+				return n;
+			}
+			static inline const T *findMin( const T *s, const T *e )
+			{
+				const T *r = s != e ? s : ( const T * )0;
+				for( const T *p = s; p != e; ++p ) {
+					if( *p < *r ) {
+						r = p;
+					}
+				}
+
+				return r;
+			}
+			static inline const T *findMax( const T *s, const T *e )
+			{
+				const T *r = s != e ? s : ( const T * )0;
+				for( const T *p = s; p != e; ++p ) {
+					if( *r < *p ) {
+						r = p;
+					}
+				}
+
+				return r;
+			}
+		};
+
+#if AXARR__SIMD
+		template< typename T >
+		struct TArrSearch< T, true >
+		{
+			typedef TArrLane< T >     Lane;
+			typedef typename Lane::Vec Vec;
+
+			static const axarr_size_t kLanes    = 16/sizeof( T );
+			static const unsigned     kElemBits = Lane::kMaskBits*unsigned( sizeof( T ) );
+
+			static inline Vec splat( const T &x )
+			{
+				T buf[ kLanes ];
+				for( axarr_size_t i = 0; i < kLanes; ++i ) {
+					buf[ i ] = x;
+				}
+
+				return Lane::load( &buf[0] );
+			}
+
+			static inline const T *find( const T *s, const T *e, const T &x )
+			{
+				const Vec v = splat( x );
+
+				const T *p = s;
+				for( ; axarr_size_t( e - p ) >= kLanes; p += kLanes ) {
+					const unsigned long long m = Lane::mask( Lane::equal( Lane::load( p ), v ) );
+					if( m != 0 ) {
+						return p + arrCtz64( m )/kElemBits;
+					}
+				}
+
+				return TArrSearch< T, false >::find( p, e, x );
+			}
+			static inline axarr_size_t count( const T *s, const T *e, const T &x )
+			{
+				const Vec v = splat( x );
+
+				axarr_size_t n = 0;
+				const T *p = s;
+				for( ; axarr_size_t( e - p ) >= kLanes; p += kLanes ) {
+					n += arrPopcount64( Lane::mask( Lane::equal( Lane::load( p ), v ) ) )/kElemBits;
+				}
+
+				return n + TArrSearch< T, false >::count( p, e, x );
+			}
+
+			static inline const T *findMin( const T *s, const T *e );
+			static inline const T *findMax( const T *s, const T *e );
+		};
+
+		// Vectorized min/max, for lanes that can be ordered
+		//
+		// Every lane starts from the first element so that a leading NaN
+		// sticks, exactly as it does in the scalar loop.
+		template< typename T, bool tOrder = TArrLane< T >::kOrder >
+		struct TArrExtreme
+		{
+			template< bool tMax >
+			static inline const T *find( const T *s, const T *e )
+			{
+				return tMax ? TArrSearch< T, false >::findMax( s, e ) : TArrSearch< T, false >::findMin( s, e );
+			}
+		};
+		template< typename T >
+		struct TArrExtreme< T, true >
+		{
+			typedef TArrLane< T >      Lane;
+			typedef typename Lane::Vec Vec;
+
+			static const axarr_size_t kLanes = TArrSearch< T, true >::kLanes;
+
+			template< bool tMax >
+			static inline const T *find( const T *s, const T *e )
+			{
+				if( axarr_size_t( e - s ) < kLanes*2 ) {
+					return TArrExtreme< T, false >::template find< tMax >( s, e );
+				}
+
+				Vec acc = TArrSearch< T, true >::splat( *s );
+				const T *p = s;
+				for( ; axarr_size_t( e - p ) >= kLanes; p += kLanes ) {
+					const Vec v = Lane::load( p );
+					acc = Lane::select( tMax ? Lane::less( acc, v ) : Lane::less( v, acc ), v, acc );
+				}
+
+				T lanes[ kLanes ];
+				AXARR_MEMCPY( ( void * )&lanes[0], ( const void * )&acc, sizeof( lanes ) );
+
+				T best = *TArrExtreme< T, false >::template find< tMax >( &lanes[0], &lanes[ kLanes ] );
+				const T *r = ( const T * )0;
+				for( const T *q = p; q != e; ++q ) {
+					if( tMax ? best < *q : *q < best ) {
+						best = *q;
+						r = q;
+					}
+				}
+				if( r != ( const T * )0 ) {
+					return r;
+				}
+
+				// the first element equal to the extreme; only missing when the extreme is a NaN, which must be `*s`
+				r = TArrSearch< T, true >::find( s, p, best );
+				return r != ( const T * )0 ? r : s;
+			}
+		};
+
+		template< typename T >
+		inline const T *TArrSearch< T, true >::findMin( const T *s, const T *e )
+		{
+			return TArrExtreme< T >::template find< false >( s, e );
+		}
+		template< typename T >
+		inline const T *TArrSearch< T, true >::findMax( const T *s, const T *e )
+		{
+			return TArrExtreme< T >::template find< true >( s, e );
+		}
+#endif
+
+	}
+
 	template< typename TElement >
 	struct ArrayPolicies
 	{
@@ -679,14 +1103,7 @@ namespace ax
 			AXARR_ASSERT( ( !pFrom || pFrom >= m_pArr && pFrom <= m_pArr + m_cArr ) &&
 				"`pFrom` points outside of this array" );
 
-			const Type *const e = m_pArr + m_cArr;
-			for( const Type *p = !pFrom ? m_pArr : pFrom; p != e; ++p ) {
-				if( *p == x ) {
-					return p;
-				}
-			}
-
-			return ( const Type * )0;
+			return detail::TArrSearch<Type>::find( !pFrom ? m_pArr : pFrom, m_pArr + m_cArr, x );
 		}
 		//! \brief  Determine whether a given element exists within the array.
 		//! \param  x Element to compare against. If any element in the array
@@ -697,6 +1114,35 @@ namespace ax
 		{
 			return find( x ) != ( const Type * )0;
 		}
+		//! \brief  Count the elements that compare equal to the given element.
+		//! \param  x Element to compare against.
+		//! \return Number of elements `e` for which `e == x`.
+		inline SizeType count( const Type &x ) const
+		{
+			return ( SizeType )detail::TArrSearch<Type>::count( m_pArr, m_pArr + m_cArr, x );
+		}
+		//! \brief  Find the smallest element, as ordered by `operator<`.
+		//! \return Pointer to the first of the smallest elements, or `nullptr`
+		//!         if the array is empty.
+		//!
+		//! \note   Searches over arithmetic types are vectorized where
+		//!         `AXARR_SIMD_ENABLED` allows. For floating-point arrays a
+		//!         NaN in the first element is returned as the result, while
+		//!         NaNs anywhere else are skipped, as a plain `operator<` loop
+		//!         would do.
+		inline const Type *findMin() const
+		{
+			return detail::TArrSearch<Type>::findMin( m_pArr, m_pArr + m_cArr );
+		}
+		//! \brief  Find the largest element, as ordered by `operator<`.
+		//! \return Pointer to the first of the largest elements, or `nullptr`
+		//!         if the array is empty.
+		//!
+		//! \note   See `findMin()` regarding NaNs.
+		inline const Type *findMax() const
+		{
+			return detail::TArrSearch<Type>::findMax( m_pArr, m_pArr + m_cArr );
+		}
 
 	private:
 		const Type *            m_pArr;
@@ -1514,6 +1960,27 @@ namespace ax
 		{
 			return view().contains( x );
 		}
+		//! \brief  Count the elements that compare equal to the given element.
+		//! \param  x Element to compare against.
+		//! \return Number of elements `e` for which `e == x`.
+		inline SizeType count( const Type &x ) const
+		{
+			return view().count( x );
+		}
+		//! \brief  Find the smallest element. See `TArr::findMin()`.
+		//! \return Pointer to the first of the smallest elements, or `nullptr`
+		//!         if the array is empty.
+		inline const Type *findMin() const
+		{
+			return view().findMin();
+		}
+		//! \brief  Find the largest element. See `TArr::findMax()`.
+		//! \return Pointer to the first of the largest elements, or `nullptr`
+		//!         if the array is empty.
+		inline const Type *findMax() const
+		{
+			return view().findMax();
+		}
 		//! \brief If it exists, `delete` the last member of the array and
 		//!        remove it.
 		inline void deleteLast() {
@@ -2061,6 +2528,483 @@ namespace ax
 	template< typename T, axarr_size_t tBufSize, typename OverflowAllocator = policy::ArrayAllocator<T> >
 	using TSmallArr = TMutArr< T, policy::SmallArrayAllocator< T, tBufSize, OverflowAllocator > >;
 
+	/* ---------------------------------------------------------------------- */
+
+	/*! \brief Maps an element to an unsigned integer that orders it, enabling
+	 *         radix sort.
+	 *
+	 *  `sort()` uses radix sort for element types whose specialization sets
+	 *  `kEnabled`. Such types must be trivially copyable and `key( a ) <
+	 *  key( b )` must hold exactly when `a` should sort before `b`; elements
+	 *  with equal keys keep their relative order. Integers sort by value, as
+	 *  do `float` and `double` (with `-0.0` before `0.0`, and NaNs at either
+	 *  end depending on their sign bit).
+	 *
+	 *  Specialize this to opt other types in, e.g.:
+	 *
+	 *      template<> struct ax::TRadixKey< SDrawCall > {
+	 *          static const bool kEnabled = true;
+	 *          typedef unsigned long long KeyType;
+	 *          static inline KeyType key( const SDrawCall &x ) { return x.uSortKey; }
+	 *      };
+	 */
+	template< typename T >
+	struct TRadixKey
+	{
+		static const bool kEnabled = false;
+	};
+
+#define AXARR__RADIX_KEY(T_,Key_,Expr_)\
+	template<> struct TRadixKey< T_ >\
+	{\
+		static const bool kEnabled = true;\
+		typedef Key_ KeyType;\
+		static inline KeyType key( const T_ &x ) { return Expr_; }\
+	}
+#define AXARR__RADIX_SIGNED_KEY(T_,Key_)\
+	AXARR__RADIX_KEY( T_, Key_, KeyType( KeyType( x ) ^ ( KeyType( 1 ) << ( sizeof( KeyType )*8 - 1 ) ) ) )
+
+	AXARR__RADIX_KEY( unsigned char, unsigned char, x );
+	AXARR__RADIX_KEY( unsigned short, unsigned short, x );
+	AXARR__RADIX_KEY( unsigned int, unsigned int, x );
+	AXARR__RADIX_KEY( unsigned long, unsigned long, x );
+	AXARR__RADIX_KEY( unsigned long long, unsigned long long, x );
+	AXARR__RADIX_SIGNED_KEY( signed char, unsigned char );
+	AXARR__RADIX_SIGNED_KEY( signed short, unsigned short );
+	AXARR__RADIX_SIGNED_KEY( signed int, unsigned int );
+	AXARR__RADIX_SIGNED_KEY( signed long, unsigned long );
+	AXARR__RADIX_SIGNED_KEY( signed long long, unsigned long long );
+
+#undef AXARR__RADIX_SIGNED_KEY
+#undef AXARR__RADIX_KEY
+
+	template<>
+	struct TRadixKey< char >
+	{
+		static const bool kEnabled = true;
+		typedef unsigned char KeyType;
+		static inline KeyType key( const char &x ) { return KeyType( char( -1 ) < char( 0 ) ? KeyType( x ) ^ 0x80 : KeyType( x ) ); }
+	};
+	// Negative values have every bit flipped (reversing their order), positive values just the sign
+	template<>
+	struct TRadixKey< float >
+	{
+		static const bool kEnabled = true;
+		typedef unsigned int KeyType;
+		static inline KeyType key( const float &x )
+		{
+			KeyType u;
+			AXARR_MEMCPY( ( void * )&u, ( const void * )&x, sizeof( u ) );
+			return u ^ ( KeyType( 0 - ( u >> 31 ) ) | 0x80000000U );
+		}
+	};
+	template<>
+	struct TRadixKey< double >
+	{
+		static const bool kEnabled = true;
+		typedef unsigned long long KeyType;
+		static inline KeyType key( const double &x )
+		{
+			KeyType u;
+			AXARR_MEMCPY( ( void * )&u, ( const void * )&x, sizeof( u ) );
+			return u ^ ( KeyType( 0 - ( u >> 63 ) ) | 0x8000000000000000ULL );
+		}
+	};
+
+	namespace detail
+	{
+
+		template< typename T >
+		inline T &&arrMove( T &x )
+		{
+			return static_cast< T && >( x );
+		}
+		template< typename T >
+		inline void arrSwap( T &a, T &b )
+		{
+			T t( arrMove( a ) );
+			a = arrMove( b );
+			b = arrMove( t );
+		}
+
+		// Default ordering of `sort()`; agrees with radix sort for types it applies to
+		template< typename T, bool tRadix = TRadixKey< T >::kEnabled >
+		struct TArrLess
+		{
+			inline bool operator()( const T &a, const T &b ) const { return a < b; }
+		};
+		template< typename T >
+		struct TArrLess< T, true >
+		{
+			inline bool operator()( const T &a, const T &b ) const { return TRadixKey< T >::key( a ) < TRadixKey< T >::key( b ); }
+		};
+
+		template< typename T, typename TLess >
+		inline void arrInsertionSort( T *s, T *e, TLess &less )
+		{
+			if( s == e ) {
+				return;
+			}
+
+			for( T *p = s + 1; p != e; ++p ) {
+				T x( arrMove( *p ) );
+				T *q = p;
+				for( ; q != s && less( x, *( q - 1 ) ); --q ) {
+					*q = arrMove( *( q - 1 ) );
+				}
+				*q = arrMove( x );
+			}
+		}
+
+		template< typename T, typename TLess >
+		inline void arrSiftDown( T *p, axarr_size_t i, axarr_size_t n, TLess &less )
+		{
+			T x( arrMove( p[ i ] ) );
+			for(;;) {
+				axarr_size_t c = i*2 + 1;
+				if( c >= n ) {
+					break;
+				}
+				if( c + 1 < n && less( p[ c ], p[ c + 1 ] ) ) {
+					++c;
+				}
+				if( !less( x, p[ c ] ) ) {
+					break;
+				}
+				p[ i ] = arrMove( p[ c ] );
+				i = c;
+			}
+			p[ i ] = arrMove( x );
+		}
+		template< typename T, typename TLess >
+		inline void arrHeapSort( T *s, T *e, TLess &less )
+		{
+			const axarr_size_t n = axarr_size_t( e - s );
+			for( axarr_size_t i = n/2; i-- > 0; ) {
+				arrSiftDown( s, i, n, less );
+			}
+			for( axarr_size_t i = n; i-- > 1; ) {
+				arrSwap( s[ 0 ], s[ i ] );
+				arrSiftDown( s, 0, i, less );
+			}
+		}
+
+		// Introsort: median-of-three quicksort that falls back to heap sort
+		// past `depth` levels and finishes small ranges with insertion sort
+		template< typename T, typename TLess >
+		inline void arrIntroSort( T *s, T *e, unsigned depth, TLess &less )
+		{
+			while( e - s > 16 ) {
+				if( !depth ) {
+					arrHeapSort( s, e, less );
+					return;
+				}
+				--depth;
+
+				// move the median of three to `*s`, leaving sentinels on either side for the unguarded scans
+				T *const a = s + 1;
+				T *const b = s + ( e - s )/2;
+				T *const c = e - 1;
+				if( less( *a, *b ) ) {
+					arrSwap( *s, less( *b, *c ) ? *b : ( less( *a, *c ) ? *c : *a ) );
+				} else {
+					arrSwap( *s, less( *a, *c ) ? *a : ( less( *b, *c ) ? *c : *b ) );
+				}
+
+				T *lo = s + 1;
+				T *hi = e;
+				for(;;) {
+					while( less( *lo, *s ) ) {
+						++lo;
+					}
+					--hi;
+					while( less( *s, *hi ) ) {
+						--hi;
+					}
+					if( !( lo < hi ) ) {
+						break;
+					}
+					arrSwap( *lo, *hi );
+					++lo;
+				}
+
+				arrIntroSort( lo, e, depth, less );
+				e = lo;
+			}
+
+			arrInsertionSort( s, e, less );
+		}
+
+		// Stable LSD radix sort on 8-bit digits of `TRadixKey<T>::key()`
+		//
+		// Returns `false` without touching the array if the scratch buffer
+		// couldn't be allocated.
+		template< typename T >
+		inline bool arrRadixSort( T *s, T *e )
+		{
+			typedef TRadixKey< T >           Radix;
+			typedef typename Radix::KeyType  Key;
+
+			const axarr_size_t n = axarr_size_t( e - s );
+			if( n < 2 ) {
+				return true;
+			}
+
+			T *const pScratch = ( T * )axarr_alloc( sizeof( T )*n );
+			if( !pScratch ) {
+				return false;
+			}
+
+			// histograms for every digit in one pass
+			axarr_size_t counts[ sizeof( Key ) ][ 256 ];
+			AXARR_MEMSET( ( void * )&counts[0][0], 0, sizeof( counts ) );
+			for( const T *p = s; p != e; ++p ) {
+				const Key k = Radix::key( *p );
+				for( axarr_size_t d = 0; d < sizeof( Key ); ++d ) {
+					++counts[ d ][ ( k >> ( d*8 ) ) & 0xFF ];
+				}
+			}
+
+			T *src = s;
+			T *dst = pScratch;
+			for( axarr_size_t d = 0; d < sizeof( Key ); ++d ) {
+				axarr_size_t *const c = &counts[ d ][ 0 ];
+
+				// a digit every element shares doesn't reorder anything
+				if( c[ ( Radix::key( *src ) >> ( d*8 ) ) & 0xFF ] == n ) {
+					continue;
+				}
+
+				axarr_size_t uSum = 0;
+				for( unsigned i = 0; i < 256; ++i ) {
+					const axarr_size_t t = c[ i ];
+					c[ i ] = uSum;
+					uSum += t;
+				}
+
+				for( const T *p = src; p != src + n; ++p ) {
+					const axarr_size_t i = c[ ( Radix::key( *p ) >> ( d*8 ) ) & 0xFF ]++;
+					AXARR_MEMCPY( ( void * )&dst[ i ], ( const void * )p, sizeof( T ) );
+				}
+
+				T *const t = src;
+				src = dst;
+				dst = t;
+			}
+
+			if( src != s ) {
+				AXARR_MEMCPY( ( void * )s, ( const void * )src, sizeof( T )*n );
+			}
+
+			axarr_free( ( void * )pScratch );
+			return true;
+		}
+
+		inline unsigned arrSortDepth( axarr_size_t n )
+		{
+			unsigned depth = 0;
+			while( n > 1 ) {
+				n >>= 1;
+				depth += 2;
+			}
+
+			return depth;
+		}
+
+		template< typename T, bool tRadix = TRadixKey< T >::kEnabled >
+		struct TArrSort
+		{
+			static inline void sort( T *s, T *e )
+			{
+				TArrLess< T > less;
+				arrIntroSort( s, e, arrSortDepth( axarr_size_t( e - s ) ), less );
+			}
+		};
+		template< typename T >
+		struct TArrSort< T, true >
+		{
+			static inline void sort( T *s, T *e )
+			{
+				if( axarr_size_t( e - s ) >= AXARR_RADIX_SORT_MIN && arrRadixSort( s, e ) ) {
+					return;
+				}
+
+				TArrSort< T, false >::sort( s, e );
+			}
+		};
+
+	}
+
+	/*! \brief Sort the elements between `s` and `e` (exclusive) in ascending
+	 *         order.
+	 *
+	 *  Types with a `TRadixKey` specialization are radix sorted once there are
+	 *  at least `AXARR_RADIX_SORT_MIN` of them (falling back to introsort if
+	 *  the scratch buffer can't be allocated); everything else is introsorted
+	 *  using `operator<`. Introsort is not stable.
+	 */
+	template< typename T >
+	inline void sort( T *s, T *e )
+	{
+		detail::TArrSort< T >::sort( s, e );
+	}
+	//! \brief Sort the elements between `s` and `e` (exclusive) with introsort,
+	//!        ordered by `less( a, b )`.
+	template< typename T, typename TLess >
+	inline void sort( T *s, T *e, TLess less )
+	{
+		detail::arrIntroSort( s, e, detail::arrSortDepth( axarr_size_t( e - s ) ), less );
+	}
+	//! \brief Sort all of the elements of an array. See `sort( T *, T * )`.
+	template< typename T, typename TAllocator >
+	inline void sort( TMutArr< T, TAllocator > &arr )
+	{
+		sort( arr.begin(), arr.end() );
+	}
+	//! \brief Sort all of the elements of an array, ordered by `less( a, b )`.
+	template< typename T, typename TAllocator, typename TLess >
+	inline void sort( TMutArr< T, TAllocator > &arr, TLess less )
+	{
+		sort( arr.begin(), arr.end(), less );
+	}
+
+	/*! \brief Stable radix sort of the elements between `s` and `e`
+	 *         (exclusive), for types with a `TRadixKey` specialization.
+	 *
+	 *  \return `true` if sorted; `false` if the scratch buffer (as big as the
+	 *          range) couldn't be allocated, in which case the range is left
+	 *          untouched.
+	 */
+	template< typename T >
+	inline bool radixSort( T *s, T *e )
+	{
+		static_assert( TRadixKey< T >::kEnabled, "radixSort() needs a TRadixKey specialization for the element type" );
+		return detail::arrRadixSort( s, e );
+	}
+
+	//! \brief Call `fn( x )` on each element `x` between `s` and `e`
+	//!        (exclusive), in order.
+	template< typename T, typename TFn >
+	inline void forEach( T *s, T *e, TFn fn )
+	{
+		for( T *p = s; p != e; ++p ) {
+			fn( *p );
+		}
+	}
+	//! \brief Call `fn( x )` on each element `x` of an array, in order.
+	template< typename T, typename TAllocator, typename TFn >
+	inline void forEach( TMutArr< T, TAllocator > &arr, TFn fn )
+	{
+		forEach( arr.begin(), arr.end(), fn );
+	}
+
+	//! \brief  Fold the elements of an array into an accumulator, in order.
+	//! \return `op( ... op( op( init, arr[0] ), arr[1] ) ..., arr[n-1] )`, or
+	//!         `init` for an empty array.
+	template< typename T, typename TAcc, typename TOp >
+	inline TAcc reduce( TArr< T > arr, TAcc init, TOp op )
+	{
+		for( const T *p = arr.begin(); p != arr.end(); ++p ) {
+			init = op( init, *p );
+		}
+
+		return init;
+	}
+	//! \brief Fold the elements of an array into an accumulator, in order.
+	//!        See `reduce( TArr, TAcc, TOp )`.
+	template< typename T, typename TAllocator, typename TAcc, typename TOp >
+	inline TAcc reduce( const TMutArr< T, TAllocator > &arr, TAcc init, TOp op )
+	{
+		return reduce( arr.view(), init, op );
+	}
+
+
+#ifdef INCGUARD_AX_PRINTF_H_
+	/* ---------------------------------------------------------------------- */
+
+	namespace detail
+	{
+		template< typename TAllocator >
+		struct TArrPrintf
+		{
+			typedef TMutArr< char, TAllocator > ArrayType;
+			typedef typename ArrayType::SizeType SizeType;
+
+			static int AXPF_CALL grow_f( axpf_buffer_t *pBuf, axpf_size_t cMin )
+			{
+				ArrayType &arr = *reinterpret_cast< ArrayType * >( pBuf->pUser );
+
+				const SizeType cUsed = SizeType( pBuf->i );
+				const SizeType cWant = cUsed + SizeType( cMin ) + 1;
+				if( cWant <= cUsed ) {
+					return 0;
+				}
+
+				const SizeType cDouble = arr.max()*2;
+				if( !arr.resize( cUsed, ( const char * )0 ) || !arr.reserve( cWant > cDouble ? cWant : cDouble ) ) {
+					return 0;
+				}
+
+				pBuf->p = arr.begin();
+				pBuf->n = axpf_size_t( arr.max() );
+				return 1;
+			}
+		};
+	}
+
+	//! rief  Format onto the end of a `char` array.
+	//!
+	//! Output is written directly into the array's storage, which grows as
+	//! needed (respecting "no grow"; see `TMutArr::setNoGrow()`). A `NUL` is
+	//! kept just past the last element but is not counted by `len()`.
+	//!
+	//! \return `true` on success; `false` otherwise, in which case the array
+	//!         has its original length.
+	template< typename TAllocator >
+	inline bool appendfv( TMutArr< char, TAllocator > &arr, AXPF_PARM_ANNO const char *fmt, const char *fmte, va_list args ) AXPF_FUNC_ANNO(2,4)
+	{
+		typedef typename TMutArr< char, TAllocator >::SizeType SizeType;
+
+		const SizeType cLen = arr.len();
+		if( !arr.reserve( cLen + 1 ) ) {
+			return false;
+		}
+
+		axpf_buffer_t b;
+
+		b.p       = arr.begin();
+		b.i       = axpf_size_t( cLen );
+		b.n       = axpf_size_t( arr.max() );
+		b.pfnGrow = &detail::TArrPrintf< TAllocator >::grow_f;
+		b.pUser   = reinterpret_cast< void * >( &arr );
+
+		if( axbpfev( &b, fmt, fmte, args ) < 0 ) {
+			arr.resize( cLen, ( const char * )0 );
+			return false;
+		}
+
+		return arr.resize( SizeType( b.i ), ( const char * )0 );
+	}
+	//! \copydoc appendfv()
+	template< typename TAllocator >
+	inline bool appendf( TMutArr< char, TAllocator > &arr, AXPF_PARM_ANNO const char *fmt, ... ) AXPF_FUNC_ANNO(2,3)
+	{
+		va_list args;
+
+		va_start( args, fmt );
+		const bool r = appendfv( arr, fmt, ( const char * )0, args );
+		va_end( args );
+
+		return r;
+	}
+#endif
+
 }
 
+/* if ax_job.h is still being processed (it can include this through
+   ax_string.h), it includes the parallel algorithms itself once it's done */
+#if defined( AXJOB__DECLARED )
+# include "ax_array_parallel.hpp"
+#endif
+
 #endif
@@ -0,0 +1,424 @@
+/*
+
+	ax_array_parallel - public domain
+	Last update: 2026-10-15
+
+
+	Parallel algorithms for ax_array: parallelSort(), parallelForEach() and
+	parallelReduce(). They split their work into jobs on an ax_job system.
+
+
+	INTERACTIONS
+	============
+
+	There is normally no need to include this header directly. ax_job.h
+	includes it when ax_array.hpp has been included, and ax_array.hpp includes
+	it when ax_job.h has been, so the algorithms are available in either
+	include order. Including it directly pulls in both.
+
+	See AXARR_PARALLEL_ENABLED and AXARR_PARALLEL_MIN_CHUNK in ax_array.hpp.
+
+
+	LICENSE
+	=======
+
+	This software is in the public domain. Where that dedication is not
+	recognized, you are granted a perpetual, irrevocable license to copy
+	and modify this file as you see fit. There are no warranties of any
+	kind.
+
+*/
+
+/*! \file  ax_array_parallel.hpp
+ *  \brief Parallel sort, for-each and reduce over ax_array ranges.
+ */
+
+#ifndef INCGUARD_AX_ARRAY_PARALLEL_HPP_
+#define INCGUARD_AX_ARRAY_PARALLEL_HPP_
+
+#ifndef AX_NO_PRAGMA_ONCE
+# pragma once
+#endif
+
+#include "ax_array.hpp"
+#include "ax_job.h"
+
+#if AXARR_PARALLEL_ENABLED
+
+namespace ax
+{
+
+	namespace detail
+	{
+
+		// Number of jobs to split `n` elements into
+		inline axarr_size_t arrCountChunks( const axjob_system_t *pJobs, axarr_size_t n )
+		{
+			const axarr_size_t cMax = axarr_size_t( axjob_count_workers( pJobs ) )*4;
+			const axarr_size_t c = n/AXARR_PARALLEL_MIN_CHUNK;
+
+			return c < cMax ? ( c > 1 ? c : 1 ) : ( cMax > 1 ? cMax : 1 );
+		}
+
+		// Run every task on the job system and wait for them; if there's no
+		// memory for the job descriptions they run on this thread instead
+		template< typename TTask >
+		inline void arrRunTasks( axjob_system_t *pJobs, TTask *pTasks, axarr_size_t cTasks )
+		{
+			axjob_desc_t *const pDescs = ( axjob_desc_t * )axarr_alloc( sizeof( axjob_desc_t )*cTasks );
+			if( !pDescs ) {
+				for( axarr_size_t i = 0; i < cTasks; ++i ) {
+					TTask::run_f( ( void * )&pTasks[ i ] );
+				}
+				return;
+			}
+
+			for( axarr_size_t i = 0; i < cTasks; ++i ) {
+				pDescs[ i ].pfnJob = &TTask::run_f;
+				pDescs[ i ].pData = ( void * )&pTasks[ i ];
+			}
+
+			axjob_counter_t counter;
+			axjob_counter_init( &counter, 0 );
+			axjob_run( pJobs, pDescs, axth_u32_t( cTasks ), &counter );
+			axjob_wait( pJobs, &counter, 0 );
+
+			axarr_free( ( void * )pDescs );
+		}
+
+		template< typename T, typename TFn >
+		struct TArrForEachTask
+		{
+			T *         s;
+			T *         e;
+			TFn *       pFn;
+
+			static void AXJOB_CALL run_f( void *pData )
+			{
+				const TArrForEachTask &task = *( const TArrForEachTask * )pData;
+				for( T *p = task.s; p != task.e; ++p ) {
+					( *task.pFn )( *p );
+				}
+			}
+		};
+
+		template< typename T, typename TAcc, typename TOp >
+		struct TArrReduceTask
+		{
+			const T *   s;
+			const T *   e;
+			TAcc *      pAcc;
+			TOp *       pOp;
+
+			static void AXJOB_CALL run_f( void *pData )
+			{
+				const TArrReduceTask &task = *( const TArrReduceTask * )pData;
+				for( const T *p = task.s; p != task.e; ++p ) {
+					*task.pAcc = ( *task.pOp )( *task.pAcc, *p );
+				}
+			}
+		};
+
+		// Sorts one chunk with `*pLess`; `tDefault` uses `sort( T *, T * )` (and so radix sort) instead
+		//
+		// This is a template parameter rather than a flag so a comparator never instantiates the
+		// default ordering, which needs `operator<`.
+		template< typename T, typename TLess, bool tDefault >
+		struct TArrSortTask
+		{
+			T *         s;
+			T *         e;
+			TLess *     pLess;
+
+			static void AXJOB_CALL run_f( void *pData )
+			{
+				const TArrSortTask &task = *( const TArrSortTask * )pData;
+				sort( task.s, task.e, *task.pLess );
+			}
+		};
+		template< typename T, typename TLess >
+		struct TArrSortTask< T, TLess, true >
+		{
+			T *         s;
+			T *         e;
+			TLess *     pLess;
+
+			static void AXJOB_CALL run_f( void *pData )
+			{
+				const TArrSortTask &task = *( const TArrSortTask * )pData;
+				sort( task.s, task.e );
+			}
+		};
+
+		// Number of elements of `a` among the first `k` outputs of a stable merge of `a` and `b`
+		template< typename T, typename TLess >
+		inline axarr_size_t arrCoRank( axarr_size_t k, const T *a, axarr_size_t na, const T *b, axarr_size_t nb, TLess &less )
+		{
+			axarr_size_t lo = k > nb ? k - nb : 0;
+			axarr_size_t hi = k < na ? k : na;
+			while( lo < hi ) {
+				const axarr_size_t i = lo + ( hi - lo )/2;
+				if( !less( b[ k - i - 1 ], a[ i ] ) ) {
+					lo = i + 1;
+				} else {
+					hi = i;
+				}
+			}
+
+			return lo;
+		}
+
+		// Writes outputs [k0,k1) of the stable merge of `a` and `b` to `d`
+		template< typename T, typename TLess >
+		struct TArrMergeTask
+		{
+			T *         a;
+			axarr_size_t na;
+			T *         b;
+			axarr_size_t nb;
+			T *         d;
+			axarr_size_t k0;
+			axarr_size_t k1;
+			TLess *     pLess;
+
+			static void AXJOB_CALL run_f( void *pData )
+			{
+				const TArrMergeTask &task = *( const TArrMergeTask * )pData;
+				TLess &less = *task.pLess;
+
+				const axarr_size_t i0 = arrCoRank( task.k0, task.a, task.na, task.b, task.nb, less );
+				const axarr_size_t i1 = arrCoRank( task.k1, task.a, task.na, task.b, task.nb, less );
+
+				T *pa = task.a + i0;
+				T *const ea = task.a + i1;
+				T *pb = task.b + ( task.k0 - i0 );
+				T *const eb = task.b + ( task.k1 - i1 );
+				T *pd = task.d + task.k0;
+
+				while( pa != ea && pb != eb ) {
+					*pd++ = less( *pb, *pa ) ? arrMove( *pb++ ) : arrMove( *pa++ );
+				}
+				while( pa != ea ) {
+					*pd++ = arrMove( *pa++ );
+				}
+				while( pb != eb ) {
+					*pd++ = arrMove( *pb++ );
+				}
+			}
+		};
+
+		// Sorts chunks in parallel, then merges pairs of runs level by level,
+		// splitting each merge across jobs along its merge path
+		template< bool tDefault, typename T, typename TLess >
+		inline void arrParallelSort( axjob_system_t *pJobs, T *s, T *e, TLess &less )
+		{
+			typedef TArrSortTask< T, TLess, tDefault > SortTask;
+			typedef TArrMergeTask< T, TLess >          MergeTask;
+
+			const axarr_size_t n = axarr_size_t( e - s );
+			const axarr_size_t cChunks = arrCountChunks( pJobs, n );
+			if( cChunks < 2 ) {
+				SortTask task = { s, e, &less };
+				SortTask::run_f( ( void * )&task );
+				return;
+			}
+
+			TMutArr< axarr_size_t > runs;
+			TMutArr< SortTask >     sortTasks;
+			TMutArr< MergeTask >    mergeTasks;
+			TMutArr< T >            scratch;
+			if( !runs.reserve( cChunks + 1 ) || !sortTasks.reserve( cChunks ) || !mergeTasks.reserve( cChunks*2 ) || !scratch.resize( n, *s ) ) {
+				SortTask task = { s, e, &less };
+				SortTask::run_f( ( void * )&task );
+				return;
+			}
+
+			for( axarr_size_t i = 0; i <= cChunks; ++i ) {
+				runs.append( n*i/cChunks );
+			}
+			for( axarr_size_t i = 0; i < cChunks; ++i ) {
+				const SortTask task = { s + runs[ i ], s + runs[ i + 1 ], &less };
+				sortTasks.append( task );
+			}
+			arrRunTasks( pJobs, sortTasks.begin(), sortTasks.len() );
+
+			T *src = s;
+			T *dst = scratch.begin();
+			while( runs.len() > 2 ) {
+				mergeTasks.clear();
+
+				// each pair of runs (or a lone last run) gets jobs in proportion to its length
+				axarr_size_t cRuns = 0;
+				for( axarr_size_t i = 0; i + 1 < runs.len(); i += 2 ) {
+					const axarr_size_t uBase = runs[ i ];
+					const axarr_size_t uMid = runs[ i + 1 ];
+					const axarr_size_t uEnd = i + 2 < runs.len() ? runs[ i + 2 ] : uMid;
+					const axarr_size_t cParts = ( uEnd - uBase )*cChunks/n + 1;
+
+					for( axarr_size_t j = 0; j < cParts; ++j ) {
+						const MergeTask task = {
+							src + uBase, uMid - uBase, src + uMid, uEnd - uMid, dst + uBase,
+							( uEnd - uBase )*j/cParts, ( uEnd - uBase )*( j + 1 )/cParts, &less
+						};
+						mergeTasks.append( task );
+					}
+
+					runs[ cRuns++ ] = uBase;
+				}
+				runs[ cRuns++ ] = n;
+				runs.resize( cRuns );
+
+				arrRunTasks( pJobs, mergeTasks.begin(), mergeTasks.len() );
+
+				T *const t = src;
+				src = dst;
+				dst = t;
+			}
+
+			if( src != s ) {
+				for( axarr_size_t i = 0; i < n; ++i ) {
+					s[ i ] = arrMove( src[ i ] );
+				}
+			}
+		}
+
+	}
+
+	/*! \brief Sort the elements between `s` and `e` (exclusive) over a job
+	 *         system.
+	 *
+	 *  The range is split into up to four chunks per worker (each at least
+	 *  `AXARR_PARALLEL_MIN_CHUNK` elements), which are sorted in jobs with
+	 *  `sort( T *, T * )` and then merged in parallel. The merges need a
+	 *  scratch array as large as the range; if that can't be allocated the
+	 *  whole range is sorted on this thread instead.
+	 *
+	 *  Elements must be copy constructible (to size the scratch array) and
+	 *  assignable.
+	 */
+	template< typename T >
+	inline void parallelSort( axjob_system_t *pJobs, T *s, T *e )
+	{
+		detail::TArrLess< T > less;
+		detail::arrParallelSort< true >( pJobs, s, e, less );
+	}
+	//! \brief Sort the elements between `s` and `e` (exclusive) over a job
+	//!        system, ordered by `less( a, b )`.
+	//!
+	//! `less` is called from several threads at once. See
+	//! `parallelSort( axjob_system_t *, T *, T * )`.
+	template< typename T, typename TLess >
+	inline void parallelSort( axjob_system_t *pJobs, T *s, T *e, TLess less )
+	{
+		detail::arrParallelSort< false >( pJobs, s, e, less );
+	}
+	//! \brief Sort all of the elements of an array over a job system.
+	template< typename T, typename TAllocator >
+	inline void parallelSort( axjob_system_t *pJobs, TMutArr< T, TAllocator > &arr )
+	{
+		parallelSort( pJobs, arr.begin(), arr.end() );
+	}
+	//! \brief Sort all of the elements of an array over a job system, ordered
+	//!        by `less( a, b )`.
+	template< typename T, typename TAllocator, typename TLess >
+	inline void parallelSort( axjob_system_t *pJobs, TMutArr< T, TAllocator > &arr, TLess less )
+	{
+		parallelSort( pJobs, arr.begin(), arr.end(), less );
+	}
+
+	//! \brief Call `fn( x )` on each element `x` between `s` and `e`
+	//!        (exclusive), split into jobs.
+	//!
+	//! `fn` is shared by every job, so calls to it happen concurrently and in
+	//! no particular order.
+	template< typename T, typename TFn >
+	inline void parallelForEach( axjob_system_t *pJobs, T *s, T *e, TFn fn )
+	{
+		typedef detail::TArrForEachTask< T, TFn > Task;
+
+		const axarr_size_t n = axarr_size_t( e - s );
+		const axarr_size_t cChunks = detail::arrCountChunks( pJobs, n );
+
+		TMutArr< Task > tasks;
+		if( cChunks < 2 || !tasks.reserve( cChunks ) ) {
+			forEach( s, e, fn );
+			return;
+		}
+
+		for( axarr_size_t i = 0; i < cChunks; ++i ) {
+			const Task task = { s + n*i/cChunks, s + n*( i + 1 )/cChunks, &fn };
+			tasks.append( task );
+		}
+		detail::arrRunTasks( pJobs, tasks.begin(), tasks.len() );
+	}
+	//! \brief Call `fn( x )` on each element `x` of an array, split into jobs.
+	template< typename T, typename TAllocator, typename TFn >
+	inline void parallelForEach( axjob_system_t *pJobs, TMutArr< T, TAllocator > &arr, TFn fn )
+	{
+		parallelForEach( pJobs, arr.begin(), arr.end(), fn );
+	}
+
+	/*! \brief Fold the elements of an array into an accumulator, split into
+	 *         jobs.
+	 *
+	 *  Each chunk is folded with `op( acc, x )` starting from its own copy of
+	 *  `identity`, and the chunks' results are then folded together in order
+	 *  with `combine( acc, chunkAcc )`. So `identity` must leave values
+	 *  unchanged (e.g. `0` for sums) and the operations must be associative.
+	 *  `op` is called from several threads at once.
+	 *
+	 *  \return The combined result, or `identity` for an empty array.
+	 */
+	template< typename T, typename TAcc, typename TOp, typename TCombine >
+	inline TAcc parallelReduce( axjob_system_t *pJobs, TArr< T > arr, TAcc identity, TOp op, TCombine combine )
+	{
+		typedef detail::TArrReduceTask< T, TAcc, TOp > Task;
+
+		const axarr_size_t n = arr.len();
+		const axarr_size_t cChunks = detail::arrCountChunks( pJobs, n );
+
+		TMutArr< Task > tasks;
+		TMutArr< TAcc > results;
+		if( cChunks < 2 || !tasks.reserve( cChunks ) || !results.resize( cChunks, identity ) ) {
+			return reduce( arr, identity, op );
+		}
+
+		for( axarr_size_t i = 0; i < cChunks; ++i ) {
+			const Task task = { arr.begin() + n*i/cChunks, arr.begin() + n*( i + 1 )/cChunks, &results[ i ], &op };
+			tasks.append( task );
+		}
+		detail::arrRunTasks( pJobs, tasks.begin(), tasks.len() );
+
+		TAcc acc = results[ 0 ];
+		for( axarr_size_t i = 1; i < cChunks; ++i ) {
+			acc = combine( acc, results[ i ] );
+		}
+
+		return acc;
+	}
+	//! \brief Fold the elements of an array into an accumulator, split into
+	//!        jobs, using `op` to combine the chunks' results too.
+	template< typename T, typename TAcc, typename TOp >
+	inline TAcc parallelReduce( axjob_system_t *pJobs, TArr< T > arr, TAcc identity, TOp op )
+	{
+		return parallelReduce( pJobs, arr, identity, op, op );
+	}
+	//! \brief Fold the elements of an array into an accumulator, split into
+	//!        jobs. See `parallelReduce( axjob_system_t *, TArr, TAcc, TOp, TCombine )`.
+	template< typename T, typename TAllocator, typename TAcc, typename TOp, typename TCombine >
+	inline TAcc parallelReduce( axjob_system_t *pJobs, const TMutArr< T, TAllocator > &arr, TAcc identity, TOp op, TCombine combine )
+	{
+		return parallelReduce( pJobs, arr.view(), identity, op, combine );
+	}
+	//! \brief Fold the elements of an array into an accumulator, split into
+	//!        jobs, using `op` to combine the chunks' results too.
+	template< typename T, typename TAllocator, typename TAcc, typename TOp >
+	inline TAcc parallelReduce( axjob_system_t *pJobs, const TMutArr< T, TAllocator > &arr, TAcc identity, TOp op )
+	{
+		return parallelReduce( pJobs, arr.view(), identity, op, op );
+	}
+}
+
+#endif
+
+#endif
@@ -0,0 +1,989 @@
+/*
+
+	ax_bench - public domain
+	Last update: 2026-10-15
+
+
+	This library is a small benchmark harness: it sizes and repeats timed runs,
+	prints a table, writes the results as JSON, and compares them against a
+	baseline written by an earlier run to catch regressions.
+
+
+	USAGE
+	=====
+
+	Define AXBENCH_IMPLEMENTATION in exactly one source file that includes this
+	header, before including it.
+
+	The following don't need to be defined, as default definitions will be
+	provided, but can be defined if you want to alter default functionality
+	without modifying this file.
+
+	AXBENCH_FUNC and AXBENCH_CALL control the function declaration and calling
+	conventions. Ensure that all source files including this use the same
+	definitions for these. (That can be done in your Makefile or project
+	settings.)
+
+
+	OVERVIEW
+	========
+
+	A driver is a program that passes its command line to `axbench_init()`,
+	runs any number of benchmarks, and returns whatever `axbench_fini()`
+	returns:
+
+		static void AXBENCH_CALL bench_strlen( axbench_t *pBench, void *pUser, axbench_u64_t cIters )
+		{
+			const char *const s = ( const char * )pUser;
+			axbench_u64_t i;
+
+			for( i = 0; i < cIters; ++i ) {
+				axbench_size_t n = strlen( s );
+				AXBENCH_KEEP( &n );
+			}
+		}
+
+		int main( int argc, char **argv )
+		{
+			axbench_t bench;
+
+			if( !axbench_init( &bench, "string", argc, argv ) ) {
+				return 2;
+			}
+
+			axbench_run( &bench, "string/strlen/4k", &bench_strlen, ( void * )szText, 4096, "B" );
+
+			return axbench_fini( &bench );
+		}
+
+	In C++, `ax::runBenchmark()` takes a lambda (or any functor) instead.
+
+	A benchmark function runs `cIters` iterations of whatever is being
+	measured. The harness first calls it with growing counts until one call
+	takes long enough to time reliably, then takes several samples at that
+	count. It reports the median time per iteration, the fastest sample, and
+	a rate: the given units per iteration (bytes for "B", reported as B/s,
+	or any other unit, such as "op") per second.
+
+	Wrap setup that shouldn't be timed in `axbench_pause()` and
+	`axbench_resume()`. Each pair costs two clock reads, so use them around
+	work that takes much longer than that.
+
+	`axbench_run_mt()` runs a benchmark on several threads at once. Each
+	thread runs `cIters` iterations; the time is measured from when all of
+	them are released together until the last one finishes. The reported time
+	per iteration is the wall time divided by the iterations of all threads
+	(that is, the inverse of the combined throughput).
+
+	Benchmark names are paths, such as "string/len/4k". Keep them stable:
+	they're how results are matched against a baseline.
+
+
+	COMMAND LINE
+	============
+
+	`axbench_init()` understands the following options, and returns zero on
+	anything else (after printing the list).
+
+		--filter=TEXT       Only run benchmarks whose names contain TEXT
+		--list              Print the names of the benchmarks instead of
+		`                   running them
+		--json=FILE         Write the results to FILE
+		--baseline=FILE     Compare against the results in FILE (as written by
+		`                   --json)
+		--threshold=PCT     Slowdown, in percent, counted as a regression
+		`                   (default: 10)
+		--time=MS           Time spent sampling each benchmark (default: 500)
+		--samples=N         Number of samples per benchmark (default: 5)
+		--threads=N         Highest thread count for drivers to use (default:
+		`                   the number of hardware threads)
+
+	`axbench_fini()` returns 0 if everything ran without regressing, 1 if any
+	benchmark regressed against the baseline, or 2 if an error occurred (such
+	as being unable to write the results). Use that as the exit code to gate
+	a build on it.
+
+	A typical workflow is to record a baseline on a quiet machine, then
+	compare against it after each change:
+
+		./bench_string --json=string.base.json
+		./bench_string --baseline=string.base.json --json=string.json
+
+	Baselines only mean something on the machine (and build settings) that
+	recorded them.
+
+
+	CONFIGURATION MACROS
+	====================
+
+	Define any of these prior to including this header, if you want to alter
+	the default functionality.
+
+		AXBENCH_MAX_RESULTS
+		-------------------
+		Highest number of results one run (or baseline) holds. (Default is
+		1024.)
+
+		AXBENCH_MAX_NAME
+		----------------
+		Size of the buffer holding each benchmark's name, including the
+		terminating NUL. (Default is 96.)
+
+		AXBENCH_MAX_THREADS
+		-------------------
+		Highest number of threads `axbench_run_mt()` will start. (Default is
+		256.)
+
+
+	REPLACE BENCHMARK ALLOCATORS
+	============================
+
+	You can specify your own allocator to use with this library by defining the
+	axbench_alloc and axbench_free macros. By default they are defined to the
+	standard C library's malloc() and free(). Results and baselines are
+	allocated by `axbench_init()` and freed by `axbench_fini()`.
+
+
+	INTERACTIONS
+	============
+
+	This library requires ax_thread (threads, atomics and the hardware thread
+	count) and ax_time (the clock). They will be included automatically on
+	compilers with `__has_include`; otherwise include them before this
+	header.
+
+	The drivers in the repository's bench/ directory use this to cover the
+	other libraries. Each is one source file, built on its own; for example:
+
+		c++ -O2 -I include bench/bench_string.cpp -o bench_string -lpthread
+
+
+	LICENSE
+	=======
+
+	This software is in the public domain. Where that dedication is not
+	recognized, you are granted a perpetual, irrevocable license to copy
+	and modify this file as you see fit. There are no warranties of any
+	kind.
+
+*/
+
+#ifndef INCGUARD_AX_BENCH_H_
+#define INCGUARD_AX_BENCH_H_
+
+#ifndef AX_NO_PRAGMA_ONCE
+# pragma once
+#endif
+
+#if !defined( AX_NO_INCLUDES ) && defined( __has_include )
+# if __has_include( "ax_platform.h" )
+#  include "ax_platform.h"
+# endif
+# if __has_include( "ax_types.h" )
+#  include "ax_types.h"
+# endif
+# if __has_include( "ax_thread.h" )
+#  include "ax_thread.h"
+# endif
+# if __has_include( "ax_time.h" )
+#  include "ax_time.h"
+# endif
+#endif
+
+#ifndef INCGUARD_AX_THREAD_H_
+# error ax_bench requires ax_thread.h
+#endif
+#ifndef INCGUARD_AX_TIME_H_
+# error ax_bench requires ax_time.h
+#endif
+
+#ifdef AXBENCH_IMPLEMENTATION
+# define AXBENCH_IMPLEMENT          1
+#else
+# define AXBENCH_IMPLEMENT          0
+#endif
+
+#ifndef AXBENCH_FUNC
+# ifdef AX_FUNC
+#  define AXBENCH_FUNC              AX_FUNC
+# else
+#  define AXBENCH_FUNC              extern
+# endif
+#endif
+#ifndef AXBENCH_CALL
+# ifdef AX_CALL
+#  define AXBENCH_CALL              AX_CALL
+# else
+#  define AXBENCH_CALL
+# endif
+#endif
+
+#ifndef AXBENCH_MAX_RESULTS
+# define AXBENCH_MAX_RESULTS        1024
+#endif
+#ifndef AXBENCH_MAX_NAME
+# define AXBENCH_MAX_NAME           96
+#endif
+#ifndef AXBENCH_MAX_THREADS
+# define AXBENCH_MAX_THREADS        256
+#endif
+
+#ifndef axbench_alloc
+# include <stdlib.h>
+# define axbench_alloc(N_)          (malloc((N_)))
+# define axbench_free(P_)           (free((P_)))
+#endif
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef axth_u32_t                  axbench_u32_t;
+typedef axth_u64_t                  axbench_u64_t;
+typedef size_t                      axbench_size_t;
+
+/* Keep the compiler from optimizing away whatever `Ptr_` points to */
+#if defined( __GNUC__ ) || defined( __clang__ )
+# define AXBENCH_KEEP(Ptr_)\
+	__asm__ __volatile__( "" : : "r"( ( const void * )( Ptr_ ) ) : "memory" )
+#else
+# define AXBENCH_KEEP(Ptr_)\
+	axbench__keep( ( const void * )( Ptr_ ) )
+#endif
+
+/* Results of one benchmark */
+typedef struct axbench_result_s
+{
+	char                            szName[ AXBENCH_MAX_NAME ];
+	/* Median nanoseconds per iteration */
+	double                          fNanos;
+	/* Fastest sample's nanoseconds per iteration */
+	double                          fMinNanos;
+	/* Units per second, at the median */
+	double                          fRate;
+	/* Iterations per sample */
+	axbench_u64_t                   cIters;
+	/* Unit of `fRate`, per second */
+	char                            szUnit[ 16 ];
+} axbench_result_t;
+
+/* Harness state */
+typedef struct axbench_s
+{
+	const char *                    pszSuite;
+
+	/* options */
+	const char *                    pszFilter;
+	const char *                    pszJsonFile;
+	double                          fThreshold;
+	axbench_u64_t                   uSampleNanos;
+	axbench_u32_t                   cSamples;
+	axbench_u32_t                   cMaxThreads;
+	int                             bList;
+
+	axbench_result_t *              pResults;
+	axbench_u32_t                   cResults;
+	axbench_result_t *              pBaseline;
+	axbench_u32_t                   cBaseline;
+	axbench_u32_t                   cRegressions;
+	int                             bFailed;
+
+	/* time excluded from the current sample by `axbench_pause()` */
+	axbench_u64_t                   uPausedAt;
+	axbench_u64_t                   uExcluded;
+} axbench_t;
+
+/* Runs `cIters` iterations of a benchmark */
+typedef void( AXBENCH_CALL *axbench_fn_t )( axbench_t *pBench, void *pUser, axbench_u64_t cIters );
+/* Runs `cIters` iterations of a benchmark on thread `uThread` (from 0) */
+typedef void( AXBENCH_CALL *axbench_fn_mt_t )( void *pUser, axbench_u32_t uThread, axbench_u64_t cIters );
+
+/* Read the clock, in nanoseconds */
+AXBENCH_FUNC axbench_u64_t AXBENCH_CALL axbench_nanoseconds( void );
+
+/*
+ * Parse the command line and load the baseline, if any.
+ *
+ * `pszSuite` names the driver in its output. Returns nonzero on success.
+ */
+AXBENCH_FUNC int AXBENCH_CALL axbench_init( axbench_t *p, const char *pszSuite, int argc, char **argv );
+/* Print the summary, write the results, and return the exit code */
+AXBENCH_FUNC int AXBENCH_CALL axbench_fini( axbench_t *p );
+
+/* Whether a benchmark by this name should run (after --filter and --list) */
+AXBENCH_FUNC int AXBENCH_CALL axbench_enabled( axbench_t *p, const char *pszName );
+/* Highest number of threads to use (--threads) */
+AXBENCH_FUNC axbench_u32_t AXBENCH_CALL axbench_max_threads( const axbench_t *p );
+
+/* Run a benchmark, if enabled; `fUnitsPerIter` units of `pszUnit` are processed each iteration */
+AXBENCH_FUNC void AXBENCH_CALL axbench_run( axbench_t *p, const char *pszName, axbench_fn_t pfnBench, void *pUser, double fUnitsPerIter, const char *pszUnit );
+/* Run a benchmark on `cThreads` threads at once, if enabled */
+AXBENCH_FUNC void AXBENCH_CALL axbench_run_mt( axbench_t *p, const char *pszName, axbench_u32_t cThreads, axbench_fn_mt_t pfnBench, void *pUser, double fUnitsPerIter, const char *pszUnit );
+
+/* Stop timing the current sample (from within an `axbench_run()` benchmark) */
+AXBENCH_FUNC void AXBENCH_CALL axbench_pause( axbench_t *p );
+/* Resume timing the current sample */
+AXBENCH_FUNC void AXBENCH_CALL axbench_resume( axbench_t *p );
+
+/* implementation: AXBENCH_KEEP() for compilers without inline assembly */
+AXBENCH_FUNC void AXBENCH_CALL axbench__keep( const void *p );
+
+#if AXBENCH_IMPLEMENT
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+static const void *volatile         axbench__g_pKeep    = ( const void * )0;
+
+static void axbench__copy( char *pszDst, axbench_size_t cDst, const char *pszSrc )
+{
+	axbench_size_t i;
+
+	for( i = 0; pszSrc[ i ] != '\0' && i + 1 < cDst; ++i ) {
+		pszDst[ i ] = pszSrc[ i ];
+	}
+	pszDst[ i ] = '\0';
+}
+
+/* implementation: value of `--name=value` if `pszArg` is that option, else null */
+static const char *axbench__option( const char *pszArg, const char *pszName )
+{
+	axbench_size_t n;
+
+	n = strlen( pszName );
+	if( strncmp( pszArg, pszName, n ) != 0 || pszArg[ n ] != '=' ) {
+		return ( const char * )0;
+	}
+
+	return &pszArg[ n + 1 ];
+}
+
+static void axbench__usage( const char *pszProgram )
+{
+	fprintf( stderr,
+		"usage: %s [options]\n"
+		"  --filter=TEXT       only run benchmarks whose names contain TEXT\n"
+		"  --list              list the benchmarks instead of running them\n"
+		"  --json=FILE         write the results to FILE\n"
+		"  --baseline=FILE     compare against results written by --json\n"
+		"  --threshold=PCT     slowdown counted as a regression (default: 10)\n"
+		"  --time=MS           time spent sampling each benchmark (default: 500)\n"
+		"  --samples=N         samples per benchmark (default: 5)\n"
+		"  --threads=N         highest thread count to use\n",
+		pszProgram );
+}
+
+/* implementation: read results back from a file written by `axbench__write_json()` */
+static int axbench__load_baseline( axbench_t *p, const char *pszFilename )
+{
+	FILE *fp;
+	char szLine[ 1024 ];
+	axbench_result_t *r;
+	const char *s;
+	axbench_size_t i;
+
+# if defined( _MSC_VER ) && defined( __STDC_WANT_SECURE_LIB__ )
+	if( fopen_s( &fp, pszFilename, "rb" ) != 0 ) {
+		fp = ( FILE * )0;
+	}
+# else
+	fp = fopen( pszFilename, "rb" );
+# endif
+	if( !fp ) {
+		fprintf( stderr, "ax_bench: couldn't open baseline \"%s\"\n", pszFilename );
+		return 0;
+	}
+
+	/* one result per line, each with its name first */
+	while( fgets( szLine, ( int )sizeof( szLine ), fp ) != ( char * )0 && p->cBaseline < AXBENCH_MAX_RESULTS ) {
+		s = strstr( szLine, "{\"name\":\"" );
+		if( !s ) {
+			continue;
+		}
+
+		r = &p->pBaseline[ p->cBaseline ];
+		memset( ( void * )r, 0, sizeof( *r ) );
+
+		s += 9;
+		for( i = 0; *s != '\0' && *s != '\"' && i + 1 < sizeof( r->szName ); ++s ) {
+			if( *s == '\\' && s[1] != '\0' ) {
+				++s;
+			}
+			r->szName[ i++ ] = *s;
+		}
+		r->szName[ i ] = '\0';
+
+		s = strstr( s, "\"ns\":" );
+		if( !s ) {
+			continue;
+		}
+		r->fNanos = strtod( s + 5, ( char ** )0 );
+		if( r->fNanos > 0.0 ) {
+			++p->cBaseline;
+		}
+	}
+
+	fclose( fp );
+	return 1;
+}
+
+static const axbench_result_t *axbench__find_baseline( const axbench_t *p, const char *pszName )
+{
+	axbench_u32_t i;
+
+	for( i = 0; i < p->cBaseline; ++i ) {
+		if( strcmp( p->pBaseline[ i ].szName, pszName ) == 0 ) {
+			return &p->pBaseline[ i ];
+		}
+	}
+
+	return ( const axbench_result_t * )0;
+}
+
+static void axbench__put_json_str( FILE *fp, const char *s )
+{
+	fputc( '\"', fp );
+	for( ; *s != '\0'; ++s ) {
+		if( *s == '\"' || *s == '\\' ) {
+			fputc( '\\', fp );
+		}
+		if( ( unsigned char )*s >= 0x20 ) {
+			fputc( *s, fp );
+		}
+	}
+	fputc( '\"', fp );
+}
+
+static int axbench__write_json( const axbench_t *p, const char *pszFilename )
+{
+	const axbench_result_t *r;
+	FILE *fp;
+	axbench_u32_t i;
+	int bOk;
+
+# if defined( _MSC_VER ) && defined( __STDC_WANT_SECURE_LIB__ )
+	if( fopen_s( &fp, pszFilename, "wb" ) != 0 ) {
+		fp = ( FILE * )0;
+	}
+# else
+	fp = fopen( pszFilename, "wb" );
+# endif
+	if( !fp ) {
+		fprintf( stderr, "ax_bench: couldn't write \"%s\"\n", pszFilename );
+		return 0;
+	}
+
+	fputs( "{\"suite\":", fp );
+	axbench__put_json_str( fp, p->pszSuite );
+	fprintf( fp, ",\"hardware_threads\":%u,\"results\":[\n", ( unsigned )axth_count_cpu_threads() );
+	for( i = 0; i < p->cResults; ++i ) {
+		r = &p->pResults[ i ];
+
+		fputs( "{\"name\":", fp );
+		axbench__put_json_str( fp, r->szName );
+		fprintf( fp, ",\"ns\":%.4f,\"min_ns\":%.4f,\"iters\":%llu,\"rate\":%.6g,\"unit\":",
+			r->fNanos, r->fMinNanos, ( unsigned long long )r->cIters, r->fRate );
+		axbench__put_json_str( fp, r->szUnit );
+		fputs( i + 1 < p->cResults ? "},\n" : "}\n", fp );
+	}
+	fputs( "]}\n", fp );
+
+	bOk = !ferror( fp );
+	if( fclose( fp ) != 0 ) {
+		bOk = 0;
+	}
+
+	return bOk;
+}
+
+static void axbench__print_rate( char *pszDst, axbench_size_t cDst, double fRate, const char *pszUnit )
+{
+	static const char *const pszPrefixes[] = { "", "k", "M", "G", "T" };
+	axbench_u32_t i;
+
+	for( i = 0; fRate >= 1000.0 && i + 1 < sizeof( pszPrefixes )/sizeof( pszPrefixes[0] ); ++i ) {
+		fRate /= 1000.0;
+	}
+
+# if defined( _MSC_VER ) && defined( __STDC_WANT_SECURE_LIB__ )
+	sprintf_s( pszDst, cDst, "%.2f %s%s/s", fRate, pszPrefixes[ i ], pszUnit );
+# else
+	snprintf( pszDst, cDst, "%.2f %s%s/s", fRate, pszPrefixes[ i ], pszUnit );
+# endif
+}
+
+/* implementation: sort the samples, store the result, and print it */
+static void axbench__report( axbench_t *p, const char *pszName, double *pSamples, axbench_u64_t cIters, double fUnitsPerIter, const char *pszUnit )
+{
+	const axbench_result_t *b;
+	axbench_result_t *r;
+	axbench_u32_t i, j;
+	char szRate[ 48 ];
+	double f;
+
+	for( i = 1; i < p->cSamples; ++i ) {
+		f = pSamples[ i ];
+		for( j = i; j > 0 && pSamples[ j - 1 ] > f; --j ) {
+			pSamples[ j ] = pSamples[ j - 1 ];
+		}
+		pSamples[ j ] = f;
+	}
+
+	if( p->cResults == AXBENCH_MAX_RESULTS ) {
+		fprintf( stderr, "ax_bench: too many results; \"%s\" was not kept\n", pszName );
+		p->bFailed = 1;
+		return;
+	}
+
+	r = &p->pResults[ p->cResults++ ];
+	axbench__copy( r->szName, sizeof( r->szName ), pszName );
+	axbench__copy( r->szUnit, sizeof( r->szUnit ), pszUnit );
+	r->fNanos = pSamples[ p->cSamples/2 ];
+	r->fMinNanos = pSamples[ 0 ];
+	r->fRate = r->fNanos > 0.0 ? fUnitsPerIter*1e9/r->fNanos : 0.0;
+	r->cIters = cIters;
+
+	axbench__print_rate( szRate, sizeof( szRate ), r->fRate, pszUnit );
+	printf( "%-52s %12.2f %12.2f %18s", r->szName, r->fNanos, r->fMinNanos, szRate );
+
+	b = axbench__find_baseline( p, r->szName );
+	if( b != ( const axbench_result_t * )0 ) {
+		f = ( r->fNanos/b->fNanos - 1.0 )*100.0;
+		printf( " %+8.1f%%", f );
+		if( f > p->fThreshold ) {
+			printf( "  REGRESSION" );
+			++p->cRegressions;
+		} else if( f < -p->fThreshold ) {
+			printf( "  improved" );
+		}
+	}
+	printf( "\n" );
+	fflush( stdout );
+}
+#endif
+
+AXBENCH_FUNC void AXBENCH_CALL axbench__keep( const void *p )
+#if AXBENCH_IMPLEMENT
+{
+	axbench__g_pKeep = p;
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC axbench_u64_t AXBENCH_CALL axbench_nanoseconds( void )
+#if AXBENCH_IMPLEMENT
+{
+	int s, ns;
+
+	if( !axtm_nanoseconds( &s, &ns ) ) {
+		return 0;
+	}
+
+	return ( axbench_u64_t )( unsigned )s*1000000000ULL + ( axbench_u64_t )( unsigned )ns;
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC int AXBENCH_CALL axbench_init( axbench_t *p, const char *pszSuite, int argc, char **argv )
+#if AXBENCH_IMPLEMENT
+{
+	const char *pszBaseline, *s;
+	int i;
+
+	memset( ( void * )p, 0, sizeof( *p ) );
+
+	p->pszSuite = pszSuite;
+	p->fThreshold = 10.0;
+	p->uSampleNanos = 500000000ULL;
+	p->cSamples = 5;
+	p->cMaxThreads = axth_count_cpu_threads();
+
+	pszBaseline = ( const char * )0;
+	for( i = 1; i < argc; ++i ) {
+		if( ( s = axbench__option( argv[ i ], "--filter" ) ) != ( const char * )0 ) {
+			p->pszFilter = s;
+		} else if( ( s = axbench__option( argv[ i ], "--json" ) ) != ( const char * )0 ) {
+			p->pszJsonFile = s;
+		} else if( ( s = axbench__option( argv[ i ], "--baseline" ) ) != ( const char * )0 ) {
+			pszBaseline = s;
+		} else if( ( s = axbench__option( argv[ i ], "--threshold" ) ) != ( const char * )0 ) {
+			p->fThreshold = strtod( s, ( char ** )0 );
+		} else if( ( s = axbench__option( argv[ i ], "--time" ) ) != ( const char * )0 ) {
+			p->uSampleNanos = ( axbench_u64_t )strtoul( s, ( char ** )0, 10 )*1000000ULL;
+		} else if( ( s = axbench__option( argv[ i ], "--samples" ) ) != ( const char * )0 ) {
+			p->cSamples = ( axbench_u32_t )strtoul( s, ( char ** )0, 10 );
+		} else if( ( s = axbench__option( argv[ i ], "--threads" ) ) != ( const char * )0 ) {
+			p->cMaxThreads = ( axbench_u32_t )strtoul( s, ( char ** )0, 10 );
+		} else if( strcmp( argv[ i ], "--list" ) == 0 ) {
+			p->bList = 1;
+		} else {
+			axbench__usage( argv[0] );
+			return 0;
+		}
+	}
+
+	/* --time is for the whole benchmark; each sample gets an even share of it */
+	if( p->cSamples < 1 ) {
+		p->cSamples = 1;
+	}
+	if( p->cSamples > 99 ) {
+		p->cSamples = 99;
+	}
+	p->uSampleNanos /= p->cSamples;
+	if( p->uSampleNanos < 1000000 ) {
+		p->uSampleNanos = 1000000;
+	}
+	if( p->cMaxThreads < 1 ) {
+		p->cMaxThreads = 1;
+	}
+	if( p->cMaxThreads > AXBENCH_MAX_THREADS ) {
+		p->cMaxThreads = AXBENCH_MAX_THREADS;
+	}
+
+	p->pResults = ( axbench_result_t * )axbench_alloc( sizeof( axbench_result_t )*AXBENCH_MAX_RESULTS*2 );
+	if( !p->pResults ) {
+		fprintf( stderr, "ax_bench: out of memory\n" );
+		return 0;
+	}
+	p->pBaseline = &p->pResults[ AXBENCH_MAX_RESULTS ];
+
+	if( pszBaseline != ( const char * )0 && !axbench__load_baseline( p, pszBaseline ) ) {
+		axbench_free( ( void * )p->pResults );
+		p->pResults = ( axbench_result_t * )0;
+		return 0;
+	}
+
+	if( !p->bList ) {
+		printf( "%-52s %12s %12s %18s%s\n", p->pszSuite, "ns/iter", "min ns/iter", "rate", p->cBaseline > 0 ? "  vs. baseline" : "" );
+		fflush( stdout );
+	}
+
+	return 1;
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC int AXBENCH_CALL axbench_fini( axbench_t *p )
+#if AXBENCH_IMPLEMENT
+{
+	int r;
+
+	if( !p->bList && p->pszJsonFile != ( const char * )0 && !axbench__write_json( p, p->pszJsonFile ) ) {
+		p->bFailed = 1;
+	}
+
+	if( p->cRegressions > 0 ) {
+		printf( "%u regression%s beyond %.1f%%\n", ( unsigned )p->cRegressions, p->cRegressions == 1 ? "" : "s", p->fThreshold );
+	}
+
+	r = p->bFailed ? 2 : p->cRegressions > 0 ? 1 : 0;
+
+	axbench_free( ( void * )p->pResults );
+	p->pResults = ( axbench_result_t * )0;
+	p->pBaseline = ( axbench_result_t * )0;
+
+	return r;
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC int AXBENCH_CALL axbench_enabled( axbench_t *p, const char *pszName )
+#if AXBENCH_IMPLEMENT
+{
+	if( p->pszFilter != ( const char * )0 && !strstr( pszName, p->pszFilter ) ) {
+		return 0;
+	}
+
+	if( p->bList ) {
+		printf( "%s\n", pszName );
+		return 0;
+	}
+
+	return 1;
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC axbench_u32_t AXBENCH_CALL axbench_max_threads( const axbench_t *p )
+#if AXBENCH_IMPLEMENT
+{
+	return p->cMaxThreads;
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC void AXBENCH_CALL axbench_pause( axbench_t *p )
+#if AXBENCH_IMPLEMENT
+{
+	p->uPausedAt = axbench_nanoseconds();
+}
+#else
+;
+#endif
+AXBENCH_FUNC void AXBENCH_CALL axbench_resume( axbench_t *p )
+#if AXBENCH_IMPLEMENT
+{
+	p->uExcluded += axbench_nanoseconds() - p->uPausedAt;
+}
+#else
+;
+#endif
+
+#if AXBENCH_IMPLEMENT
+/* implementation: one timed call of a single-threaded benchmark */
+static axbench_u64_t axbench__sample( axbench_t *p, axbench_fn_t pfnBench, void *pUser, axbench_u64_t cIters )
+{
+	axbench_u64_t t0, t1;
+
+	p->uExcluded = 0;
+
+	t0 = axbench_nanoseconds();
+	pfnBench( p, pUser, cIters );
+	t1 = axbench_nanoseconds();
+
+	return t1 - t0 > p->uExcluded ? t1 - t0 - p->uExcluded : 1;
+}
+
+/* implementation: iterations to run for a sample to take about `uSampleNanos`, given a trial run */
+static axbench_u64_t axbench__scale( const axbench_t *p, axbench_u64_t cIters, axbench_u64_t uNanos )
+{
+	double f;
+
+	f = ( double )p->uSampleNanos/( double )( uNanos > 0 ? uNanos : 1 );
+	if( f > 100.0 ) {
+		f = 100.0;
+	}
+
+	return ( axbench_u64_t )( ( double )cIters*f ) + 1;
+}
+
+/* implementation: shared by the threads of one `axbench_run_mt()` sample */
+typedef struct axbench__mt_s
+{
+	axbench_fn_mt_t                 pfnBench;
+	void *                          pUser;
+	axbench_u64_t                   cIters;
+	volatile axbench_u32_t          cReady;
+	volatile axbench_u32_t          bGo;
+	volatile axbench_u32_t          cDone;
+} axbench__mt_t;
+
+typedef struct axbench__mt_thread_s
+{
+	axthread_t                      Thread;
+	axbench__mt_t *                 pShared;
+	axbench_u32_t                   uIndex;
+	volatile axbench_u32_t          bExited;
+} axbench__mt_thread_t;
+
+static int AXTHREAD_CALL axbench__mt_thread_f( axthread_t *pThread, void *pData )
+{
+	axbench__mt_thread_t *const t = ( axbench__mt_thread_t * )pData;
+	axbench__mt_t *const s = t->pShared;
+
+	( void )pThread;
+
+	( void )AX_ATOMIC_FETCH_ADD_FULL32( &s->cReady, 1 );
+	while( !s->bGo ) {
+		AX_CPU_PAUSE();
+	}
+
+	s->pfnBench( s->pUser, t->uIndex, s->cIters );
+
+	( void )AX_ATOMIC_FETCH_ADD_FULL32( &s->cDone, 1 );
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &t->bExited, 1 );
+	return 0;
+}
+
+/* implementation: one timed run on `cThreads` threads; returns 0 if the threads couldn't be started */
+static axbench_u64_t axbench__sample_mt( axbench__mt_thread_t *pThreads, axbench_u32_t cThreads, axbench_fn_mt_t pfnBench, void *pUser, axbench_u64_t cIters )
+{
+	axbench__mt_t s;
+	axbench_u64_t t0, t1;
+	axbench_u32_t i, cStarted;
+
+	s.pfnBench = pfnBench;
+	s.pUser = pUser;
+	s.cIters = cIters;
+	s.cReady = 0;
+	s.bGo = 0;
+	s.cDone = 0;
+
+	for( cStarted = 0; cStarted < cThreads; ++cStarted ) {
+		pThreads[ cStarted ].pShared = &s;
+		pThreads[ cStarted ].uIndex = cStarted;
+		pThreads[ cStarted ].bExited = 0;
+		if( !axthread_init( &pThreads[ cStarted ].Thread, &axbench__mt_thread_f, ( void * )&pThreads[ cStarted ] ) ) {
+			break;
+		}
+	}
+
+	/* release everyone together once they're all waiting */
+	while( s.cReady != cStarted ) {
+		axth_yield();
+	}
+	t0 = axbench_nanoseconds();
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &s.bGo, 1 );
+
+	while( s.cDone != cStarted ) {
+		axth_yield();
+	}
+	t1 = axbench_nanoseconds();
+
+	for( i = 0; i < cStarted; ++i ) {
+		while( !pThreads[ i ].bExited ) {
+			axth_yield();
+		}
+		axthread_fini( &pThreads[ i ].Thread );
+	}
+
+	if( cStarted != cThreads ) {
+		return 0;
+	}
+
+	return t1 > t0 ? t1 - t0 : 1;
+}
+#endif
+
+AXBENCH_FUNC void AXBENCH_CALL axbench_run( axbench_t *p, const char *pszName, axbench_fn_t pfnBench, void *pUser, double fUnitsPerIter, const char *pszUnit )
+#if AXBENCH_IMPLEMENT
+{
+	double Samples[ 100 ];
+	axbench_u64_t cIters, uNanos;
+	axbench_u32_t i;
+
+	if( !axbench_enabled( p, pszName ) ) {
+		return;
+	}
+
+	/* grow the iteration count until a call is long enough to time (this also warms up) */
+	cIters = 1;
+	for(;;) {
+		uNanos = axbench__sample( p, pfnBench, pUser, cIters );
+		if( uNanos >= p->uSampleNanos/2 ) {
+			break;
+		}
+		cIters = axbench__scale( p, cIters, uNanos );
+	}
+	cIters = axbench__scale( p, cIters, uNanos );
+
+	for( i = 0; i < p->cSamples; ++i ) {
+		Samples[ i ] = ( double )axbench__sample( p, pfnBench, pUser, cIters )/( double )cIters;
+	}
+
+	axbench__report( p, pszName, Samples, cIters, fUnitsPerIter, pszUnit );
+}
+#else
+;
+#endif
+
+AXBENCH_FUNC void AXBENCH_CALL axbench_run_mt( axbench_t *p, const char *pszName, axbench_u32_t cThreads, axbench_fn_mt_t pfnBench, void *pUser, double fUnitsPerIter, const char *pszUnit )
+#if AXBENCH_IMPLEMENT
+{
+	double Samples[ 100 ];
+	axbench__mt_thread_t *pThreads;
+	axbench_u64_t cIters, uNanos;
+	axbench_u32_t i;
+
+	if( !axbench_enabled( p, pszName ) ) {
+		return;
+	}
+
+	if( cThreads < 1 || cThreads > AXBENCH_MAX_THREADS ) {
+		fprintf( stderr, "ax_bench: \"%s\" asked for %u threads\n", pszName, ( unsigned )cThreads );
+		p->bFailed = 1;
+		return;
+	}
+
+	pThreads = ( axbench__mt_thread_t * )axbench_alloc( sizeof( *pThreads )*cThreads );
+	if( !pThreads ) {
+		fprintf( stderr, "ax_bench: out of memory\n" );
+		p->bFailed = 1;
+		return;
+	}
+
+	cIters = 1;
+	for(;;) {
+		uNanos = axbench__sample_mt( pThreads, cThreads, pfnBench, pUser, cIters );
+		if( !uNanos || uNanos >= p->uSampleNanos/2 ) {
+			break;
+		}
+		cIters = axbench__scale( p, cIters, uNanos );
+	}
+	cIters = axbench__scale( p, cIters, uNanos );
+
+	for( i = 0; i < p->cSamples && uNanos != 0; ++i ) {
+		uNanos = axbench__sample_mt( pThreads, cThreads, pfnBench, pUser, cIters );
+		Samples[ i ] = ( double )uNanos/( ( double )cIters*( double )cThreads );
+	}
+
+	axbench_free( ( void * )pThreads );
+
+	if( !uNanos ) {
+		fprintf( stderr, "ax_bench: couldn't start %u threads for \"%s\"\n", ( unsigned )cThreads, pszName );
+		p->bFailed = 1;
+		return;
+	}
+
+	axbench__report( p, pszName, Samples, cIters*cThreads, fUnitsPerIter, pszUnit );
+}
+#else
+;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+namespace ax
+{
+
+	namespace detail
+	{
+
+		template< typename TFunc >
+		void AXBENCH_CALL benchmarkTrampoline( axbench_t *, void *pUser, axbench_u64_t cIters )
+		{
+			( *reinterpret_cast< TFunc * >( pUser ) )( cIters );
+		}
+		template< typename TFunc >
+		void AXBENCH_CALL benchmarkTrampolineMT( void *pUser, axbench_u32_t uThread, axbench_u64_t cIters )
+		{
+			( *reinterpret_cast< TFunc * >( pUser ) )( uThread, cIters );
+		}
+
+	}
+
+	/*! \brief Run a benchmark given as a functor taking the iteration count.
+	 *
+	 *  Capture the `axbench_t` to call `axbench_pause()`/`axbench_resume()`.
+	 */
+	template< typename TFunc >
+	inline void runBenchmark( axbench_t &bench, const char *pszName, double fUnitsPerIter, const char *pszUnit, TFunc func )
+	{
+		axbench_run( &bench, pszName, &detail::benchmarkTrampoline< TFunc >, reinterpret_cast< void * >( &func ), fUnitsPerIter, pszUnit );
+	}
+	/*! \brief Run a benchmark on `cThreads` threads, given as a functor taking
+	 *         the thread index and the iteration count.
+	 *
+	 *  The functor is shared by all of the threads.
+	 */
+	template< typename TFunc >
+	inline void runBenchmarkMT( axbench_t &bench, const char *pszName, axbench_u32_t cThreads, double fUnitsPerIter, const char *pszUnit, TFunc func )
+	{
+		axbench_run_mt( &bench, pszName, cThreads, &detail::benchmarkTrampolineMT< TFunc >, reinterpret_cast< void * >( &func ), fUnitsPerIter, pszUnit );
+	}
+
+}
+#endif
+
+#endif
@@ -246,6 +246,84 @@
 		[]
 
 
+	ZERO-COPY LOADING
+	=================
+
+	By default the source text is copied into a buffer owned by the axconf_t
+	(axconf_set_buffer) and every section and variable name is duplicated onto
+	the heap. For very large configurations this can be avoided entirely:
+
+		axconf_set_buffer_ref( &cfg, pText, cTextBytes );
+		// -or- axconf_map_file( &cfg, "big.cfg" );
+
+		axconf_ctx_init( &ctx, &cfg );
+		axconf_ctx_set_flags( &ctx, kAxconfCtxF_ZeroCopy );
+
+	axconf_set_buffer_ref lexes straight from caller-owned memory, which must
+	remain valid (and unchanged) until the configuration is finished with it.
+	axconf_map_file memory-maps the file read-only; the mapping is released by
+	axconf_fini. (Define AXCONF_MMAP_ENABLED to 0 to exclude it.)
+
+	kAxconfCtxF_Arena allocates every section, variable, and value added to the
+	context from a single arena owned by the context, which is released as a
+	whole by axconf_ctx_fini. kAxconfCtxF_Borrow stores names and string values
+	created from tokens as spans into the source buffer. Only strings that
+	contained escape sequences are copied. kAxconfCtxF_ZeroCopy is both.
+
+	When borrowing, the configuration's buffer must outlive the context. Use
+	axconf_var_get_name_ref / axconf_sect_get_name_ref / axconf_val_get_string
+	to read names and strings without forcing a NUL-terminated copy.
+
+
+	LOOKUP BY NAME
+	==============
+
+	Sections and variables can be found by name with axconf_ctx_find_section,
+	axconf_sect_find_var, and axconf_ctx_find (which takes "section.var"). On
+	their own these search linearly. Call axconf_ctx_build_index once loading is
+	done to make them constant time. The index hashes with ax_string's murmur3
+	if available (override with axconf_hash) and is discarded automatically when
+	the context's sections or variables change.
+
+
+	RELOADING
+	=========
+
+	To pick up edits to a configuration, load the new version into a separate
+	context and merge it into the one in use:
+
+		axconf_ctx_sync( &ctx, &newCtx, 0, OnChange, pUserData );
+
+	Only the variables that were added, modified, or removed are touched, and
+	OnChange is called for each. Sections whose content hash is unchanged are
+	skipped, so a small edit to a large file costs little beyond loading it.
+
+	If other threads read the configuration while it is being reloaded, publish
+	whole contexts instead (requires ax_thread; see AXCONF_LIVE_ENABLED):
+
+		const axconf_context_t *p = axconf_live_acquire( &live, &uToken );
+		// ... read from p ...
+		axconf_live_release( &live, uToken );
+
+	The writer calls axconf_ctx_sync with kAxconfSyncF_ReportOnly to learn what
+	changed, then axconf_live_publish, which returns the old context once no
+	reader is using it.
+
+
+	PARALLEL LEXING
+	===============
+
+	Very large configurations can be lexed on several threads at once with
+	ax_job (include ax_job.h before this header):
+
+		axconf_lex_parallel( &cfg, &jobs, 0 );
+
+	The buffer is split at lines beginning with '[' and the pieces are lexed
+	as separate jobs, then joined. The tokens, their line numbers, and the
+	reports come out exactly as they would from lexing sequentially, and the
+	tokens are then read with axconf_lex as usual.
+
+
 	INTERACTIONS
 	============
 
@@ -258,6 +336,9 @@
 	header. If ax_string is not used then configurations must be UTF-8 encoded.
 	Otherwise they can also be encoded with UTF-16 LE/BE or UTF-32 LE/BE.
 
+	This library will use ax_job if it has been included prior to this header,
+	enabling axconf_lex_parallel. (See AXCONF_PARALLEL_ENABLED.)
+
 
 	LICENSE
 	=======
@@ -292,6 +373,9 @@
 # if __has_include( "ax_logger.h" )
 #  include "ax_logger.h"
 # endif
+# if ( !defined( AXCONF_LIVE_ENABLED ) || AXCONF_LIVE_ENABLED ) && __has_include( "ax_thread.h" )
+#  include "ax_thread.h"
+# endif
 #endif
 
 #ifdef AXCONF_IMPLEMENTATION
@@ -360,6 +444,10 @@ typedef double                      axconf_real_t;
 # include <string.h>
 # define axconf_memchr              memchr
 #endif
+#ifndef axconf_memcmp
+# include <string.h>
+# define axconf_memcmp              memcmp
+#endif
 #ifndef axconf_strlen
 # ifdef INCGUARD_AX_STRING_H_
 #  define axconf_strlen             axstr_len
@@ -369,6 +457,69 @@ typedef double                      axconf_real_t;
 # endif
 #endif
 
+#ifndef axconf_hash
+# ifdef INCGUARD_AX_STRING_H_
+#  define axconf_hash(S_,E_,Seed_)  axstr_murmur3_ranged_seeded((S_),(E_),(Seed_))
+# else
+#  define axconf_hash(S_,E_,Seed_)  axconf__fnv1a((S_),(E_),(Seed_))
+# endif
+#endif
+
+#ifndef AXCONF_LIVE_ENABLED
+# ifdef INCGUARD_AX_THREAD_H_
+#  define AXCONF_LIVE_ENABLED       1
+# else
+#  define AXCONF_LIVE_ENABLED       0
+# endif
+#endif
+#if AXCONF_LIVE_ENABLED && !defined( INCGUARD_AX_THREAD_H_ )
+# error ax_config: AXCONF_LIVE_ENABLED requires ax_thread.h
+#endif
+#ifndef AXCONF_LIVE_STRIPES
+# define AXCONF_LIVE_STRIPES        8
+#endif
+#ifndef AXCONF_PARALLEL_ENABLED
+# ifdef INCGUARD_AX_JOB_H_
+#  define AXCONF_PARALLEL_ENABLED   1
+# else
+#  define AXCONF_PARALLEL_ENABLED   0
+# endif
+#endif
+#if AXCONF_PARALLEL_ENABLED && !defined( INCGUARD_AX_JOB_H_ )
+# error ax_config: AXCONF_PARALLEL_ENABLED requires ax_job.h
+#endif
+#ifndef AXCONF_PARALLEL_MIN_CHUNK
+# define AXCONF_PARALLEL_MIN_CHUNK  262144
+#endif
+
+#ifndef AXCONF_ARENA_BLOCK_SIZE
+# define AXCONF_ARENA_BLOCK_SIZE    65536
+#endif
+
+#ifndef AXCONF_MMAP_ENABLED
+# if defined( _WIN32 ) || defined( __unix__ ) || defined( __APPLE__ )
+#  define AXCONF_MMAP_ENABLED       1
+# else
+#  define AXCONF_MMAP_ENABLED       0
+# endif
+#endif
+
+#if AXCONF_IMPLEMENT && AXCONF_MMAP_ENABLED
+# ifdef _WIN32
+#  undef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN       1
+#  include <Windows.h>
+#  undef min
+#  undef max
+# else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+# endif
+#endif
+
 #ifndef AXCONF_ASSERT
 # ifdef AX_ASSERT
 #  define AXCONF_ASSERT             AX_ASSERT
@@ -465,6 +616,51 @@ typedef enum axconf_value_type_e
 	kAxconfValTy_Blob
 } axconf_value_type_t;
 
+typedef enum axconf_node_flag_e
+{
+	/* The node's memory came from its context's arena (don't free it) */
+	kAxconfNodeF_Arena              = 1<<0,
+	/* The value's data is not owned by the value (don't free it) */
+	kAxconfNodeF_BorrowedData       = 1<<1,
+	/* The section's uContentHash matches its variables */
+	kAxconfNodeF_HashValid          = 1<<2
+} axconf_node_flag_t;
+
+typedef enum axconf_context_flag_e
+{
+	/* Allocate sections, variables, and values from the context's arena */
+	kAxconfCtxF_Arena               = 1<<0,
+	/* Names and strings made from tokens refer into the source buffer */
+	kAxconfCtxF_Borrow              = 1<<1,
+
+	/* Both of the above */
+	kAxconfCtxF_ZeroCopy            = kAxconfCtxF_Arena | kAxconfCtxF_Borrow
+} axconf_context_flag_t;
+
+typedef enum axconf_change_e
+{
+	/* The variable only exists in the new tree */
+	kAxconfChange_Added,
+	/* The variable's type or values differ */
+	kAxconfChange_Modified,
+	/* The variable only exists in the old tree (still valid during the call) */
+	kAxconfChange_Removed
+} axconf_change_t;
+
+typedef enum axconf_sync_flag_e
+{
+	/* Only report the differences; leave the destination untouched */
+	kAxconfSyncF_ReportOnly         = 1<<0
+} axconf_sync_flag_t;
+
+typedef enum axconf_buffer_flag_e
+{
+	/* The buffer belongs to the caller and must not be written to or freed */
+	kAxconfBufF_Borrowed            = 1<<0,
+	/* The buffer is a read-only file mapping made by axconf_map_file */
+	kAxconfBufF_Mapped              = 1<<1
+} axconf_buffer_flag_t;
+
 typedef enum axconf_severity_e
 {
 	/* Fatal error that cannot be recovered from (such as "out of memory") */
@@ -582,12 +778,31 @@ typedef struct axconf_blob_value_s
 	unsigned char *                 pBytes;
 } axconf_blob_value_t;
 
+typedef struct axconf_arena_block_s
+{
+	/* Next (older) block in the arena */
+	struct axconf_arena_block_s *   pNext;
+} axconf_arena_block_t;
+
+/* Linear allocator that nodes of a context can be carved from */
+typedef struct axconf_arena_s
+{
+	/* Most recently allocated block */
+	axconf_arena_block_t *          pHead;
+	/* Current allocation position within pHead */
+	char *                          pCurr;
+	/* End of pHead's memory */
+	char *                          pEnd;
+} axconf_arena_t;
+
 struct axconf_var_s;
 struct axconf_value_link_s;
 typedef struct axconf_value_link_s
 {
 	/* Variable owning this value */
 	struct axconf_var_s *           pVar;
+	/* Flags (see axconf_node_flag_t) */
+	unsigned                        uFlags;
 
 	/* Previous link in the variable's list */
 	struct axconf_value_link_s *    l_prev;
@@ -604,19 +819,25 @@ typedef struct axconf_value_link_s
 		axconf_u64_t                u;
 		/* Floating-point value */
 		axconf_float_value_t        f;
-		/* NUL-terminated string value */
+		/* String value -- not NUL-terminated if kAxconfNodeF_BorrowedData */
 		char *                      psz;
 		/* Binary blob value */
 		axconf_blob_value_t         bin;
 	}                               Data;
+	/* Length of the string value in bytes */
+	axconf_size_t                   cStrBytes;
 } axconf_value_link_t;
 
 struct axconf_section_s;
 struct axconf_var_s;
 typedef struct axconf_var_s
 {
-	/* Name of this variable */
+	/* Name of this variable (NULL if only borrowed and not yet requested) */
 	char *                          pszName;
+	/* Name of this variable as a span (may point into the source buffer) */
+	axconf_stringref_t              Name;
+	/* Flags (see axconf_node_flag_t) */
+	unsigned                        uFlags;
 
 	/* Type for the value */
 	axconf_value_type_t             ValueTy;
@@ -641,8 +862,12 @@ struct axconf_context_s;
 struct axconf_section_s;
 typedef struct axconf_section_s
 {
-	/* Name of this section */
+	/* Name of this section (NULL if only borrowed and not yet requested) */
 	char *                          pszName;
+	/* Name of this section as a span (may point into the source buffer) */
+	axconf_stringref_t              Name;
+	/* Flags (see axconf_node_flag_t) */
+	unsigned                        uFlags;
 
 	/* Context we belong to */
 	struct axconf_context_s *       pContext;
@@ -655,8 +880,30 @@ typedef struct axconf_section_s
 	axconf_var_t *                  v_head;
 	/* Last variable */
 	axconf_var_t *                  v_tail;
+
+	/* Hash of the variables and values (if kAxconfNodeF_HashValid) */
+	axconf_u64_t                    uContentHash;
 } axconf_section_t;
 
+typedef struct axconf_index_slot_s
+{
+	/* Hash of the key (for variables this is seeded by the section) */
+	unsigned                        uHash;
+	/* Section or variable this slot refers to, or NULL if unused */
+	void *                          pNode;
+} axconf_index_slot_t;
+
+/* Open-addressed hash tables for finding sections and variables by name */
+typedef struct axconf_index_s
+{
+	/* Section slots (power of two; zero if no index is built) */
+	axconf_index_slot_t *           pSects;
+	axconf_size_t                   cSectSlots;
+	/* Variable slots (power of two) */
+	axconf_index_slot_t *           pVars;
+	axconf_size_t                   cVarSlots;
+} axconf_index_t;
+
 struct axconf_s;
 struct axconf_context_s;
 typedef struct axconf_context_s
@@ -681,17 +928,52 @@ typedef struct axconf_context_s
 	axconf_size_t                   cConfigs;
 	/* Configurations that have affected this context */
 	struct axconf_s **              ppConfigs;
+
+	/* Flags (see axconf_context_flag_t) */
+	unsigned                        uFlags;
+	/* Arena nodes are allocated from when kAxconfCtxF_Arena is set */
+	axconf_arena_t                  Arena;
+	/* Name lookup index (see axconf_ctx_build_index) */
+	axconf_index_t                  Index;
 } axconf_context_t;
 
+/* Called by axconf_ctx_sync for each variable that differs */
+typedef void( AXCONF_CALL *axconf_fn_change_t )( void *pUserData, axconf_change_t Change, const axconf_var_t *pVar );
+
+#if AXCONF_LIVE_ENABLED
+/* Count of readers for each grace period parity, one cache line per stripe */
+typedef struct axconf_live_stripe_s
+{
+	volatile axth_u32_t             cReaders[ 2 ];
+	unsigned char                   Pad[ 64 - 8 ];
+} axconf_live_stripe_t;
+
+/* Context published to concurrent readers (see axconf_live_publish) */
+typedef struct axconf_live_s
+{
+	/* The currently published context */
+	axconf_context_t *volatile      pCurrent;
+	/* Grace period counter -- the low bit selects the readers' parity */
+	volatile axth_u32_t             uEpoch;
+	/* Readers currently holding a context */
+	axconf_live_stripe_t            Stripes[ AXCONF_LIVE_STRIPES ];
+} axconf_live_t;
+#endif
+
 /* Primary configuration structure -- Most operations occur on this */
 typedef struct axconf_s
 {
 	/* Name of the file loaded */
 	char *                          pszFilename;
-	/* Pointer to the start of the buffer (this can be free()'d) */
+	/* Pointer to the start of the buffer (free()'d unless uBufFlags says not) */
 	char *                          buf_s;
 	/* Pointer to the end of the buffer (the NUL terminator) */
 	const char *                    buf_e;
+	/* Ownership of the buffer (see axconf_buffer_flag_t) */
+	unsigned                        uBufFlags;
+	/* Where lexing stops if not `buf_e` (the chunks of axconf_lex_parallel
+	`  look ahead past their end, as lexing the whole buffer would) */
+	const char *                    lex_e;
 	/* First token in the list */
 	axconf_token_link_t *           l_head;
 	/* Last token in the list */
@@ -1103,6 +1385,170 @@ static int axconf__strappendch( char **p, char c )
 {
 	return axconf__strappend( p, &c, ( &c ) + 1 );
 }
+
+/*! \internal \brief Allocate cBytes from the arena, adding a block if needed */
+static void *axconf__arena_alloc( axconf_arena_t *pArena, axconf_size_t cBytes )
+{
+	static const axconf_size_t align = sizeof( void * )*2;
+	axconf_arena_block_t *pBlock;
+	axconf_size_t cHeader;
+	axconf_size_t cBlock;
+	char *q;
+
+	cBytes += ( align - cBytes%align )%align;
+	if( cBytes <= ( axconf_size_t )( pArena->pEnd - pArena->pCurr ) ) {
+		q = pArena->pCurr;
+		pArena->pCurr += cBytes;
+		return ( void * )q;
+	}
+
+	cHeader = sizeof( axconf_arena_block_t ) + ( align - sizeof( axconf_arena_block_t )%align )%align;
+
+	/* oversized requests get a block of their own behind the current one so
+	`  the remainder of the current block isn't wasted */
+	if( cBytes > AXCONF_ARENA_BLOCK_SIZE/4 ) {
+		pBlock = ( axconf_arena_block_t * )axconf_alloc( cHeader + cBytes );
+		if( !pBlock ) {
+			return ( void * )0;
+		}
+
+		if( pArena->pHead != ( axconf_arena_block_t * )0 ) {
+			pBlock->pNext = pArena->pHead->pNext;
+			pArena->pHead->pNext = pBlock;
+		} else {
+			pBlock->pNext = ( axconf_arena_block_t * )0;
+			pArena->pHead = pBlock;
+			pArena->pCurr = ( char * )pBlock + cHeader + cBytes;
+			pArena->pEnd = pArena->pCurr;
+		}
+
+		return ( void * )( ( char * )pBlock + cHeader );
+	}
+
+	cBlock = AXCONF_ARENA_BLOCK_SIZE;
+	pBlock = ( axconf_arena_block_t * )axconf_alloc( cBlock );
+	if( !pBlock ) {
+		return ( void * )0;
+	}
+
+	pBlock->pNext = pArena->pHead;
+	pArena->pHead = pBlock;
+
+	q = ( char * )pBlock + cHeader;
+	pArena->pCurr = q + cBytes;
+	pArena->pEnd = ( char * )pBlock + cBlock;
+
+	return ( void * )q;
+}
+/*! \internal \brief Release every block of the arena */
+static void axconf__arena_fini( axconf_arena_t *pArena )
+{
+	axconf_arena_block_t *pBlock, *pNext;
+
+	for( pBlock = pArena->pHead; pBlock != ( axconf_arena_block_t * )0; pBlock = pNext ) {
+		pNext = pBlock->pNext;
+		axconf_free( ( void * )pBlock );
+	}
+
+	pArena->pHead = ( axconf_arena_block_t * )0;
+	pArena->pCurr = ( char * )0;
+	pArena->pEnd = ( char * )0;
+}
+
+/*! \internal \brief Allocate a node for the context, from its arena if enabled
+
+	`*pOutFlags` receives kAxconfNodeF_Arena if the arena was used.
+*/
+static void *axconf__ctx_alloc( axconf_context_t *pCtx, axconf_size_t cBytes, unsigned *pOutFlags )
+{
+	if( pCtx != ( axconf_context_t * )0 && ( pCtx->uFlags & kAxconfCtxF_Arena ) ) {
+		*pOutFlags = kAxconfNodeF_Arena;
+		return axconf__arena_alloc( &pCtx->Arena, cBytes );
+	}
+
+	*pOutFlags = 0;
+	return axconf_alloc( cBytes );
+}
+
+#ifndef INCGUARD_AX_STRING_H_
+/*! \internal \brief FNV-1a hash of a span, used when ax_string isn't available */
+static unsigned axconf__fnv1a( const char *s, const char *e, unsigned seed )
+{
+	unsigned h;
+
+	h = 2166136261U ^ seed;
+	while( s < e ) {
+		h ^= ( unsigned char )*s++;
+		h *= 16777619U;
+	}
+
+	return h;
+}
+#endif
+
+/*! \internal \brief Note that a section's variables or values have changed */
+static void axconf__sect_touch( axconf_section_t *pSect )
+{
+	if( pSect != ( axconf_section_t * )0 ) {
+		pSect->uFlags &= ~kAxconfNodeF_HashValid;
+	}
+}
+
+/*! \internal \brief Copy bytes for a value of the context (NUL-terminated)
+
+	From the arena if the context has one, in which case kAxconfNodeF_BorrowedData
+	is added to `*puValFlags` as the value won't own the memory.
+*/
+static char *axconf__ctx_copy_bytes( axconf_context_t *pCtx, const void *pSrc, axconf_size_t cBytes, unsigned *puValFlags )
+{
+	char *p;
+
+	if( pCtx != ( axconf_context_t * )0 && ( pCtx->uFlags & kAxconfCtxF_Arena ) ) {
+		p = ( char * )axconf__arena_alloc( &pCtx->Arena, cBytes + 1 );
+		if( p != ( char * )0 ) {
+			*puValFlags |= kAxconfNodeF_BorrowedData;
+		}
+	} else {
+		p = ( char * )axconf_prc_alloc( cBytes + 1 );
+	}
+
+	if( !p ) {
+		return ( char * )0;
+	}
+
+	if( cBytes > 0 ) {
+		axconf_memcpy( ( void * )p, pSrc, cBytes );
+	}
+	p[ cBytes ] = '\0';
+
+	return p;
+}
+
+/*! \internal \brief Forget the context's lookup index (it no longer matches the tree) */
+static void axconf__ctx_drop_index( axconf_context_t *pCtx )
+{
+	if( !pCtx || !pCtx->Index.pSects ) {
+		return;
+	}
+
+	axconf_free( ( void * )pCtx->Index.pSects );
+	axconf_free( ( void * )pCtx->Index.pVars );
+
+	pCtx->Index.pSects = ( axconf_index_slot_t * )0;
+	pCtx->Index.cSectSlots = 0;
+	pCtx->Index.pVars = ( axconf_index_slot_t * )0;
+	pCtx->Index.cVarSlots = 0;
+}
+
+/*! \internal \brief Produce a NUL-terminated name, copying a borrowed span if needed */
+static const char *axconf__name_cstr( char **ppszName, const axconf_stringref_t *pName )
+{
+	if( !*ppszName && pName->n > 0 ) {
+		*ppszName = axconf__strndup( pName->s, ( axconf_size_t )pName->n );
+	}
+
+	return *ppszName;
+}
 #endif
 
 
@@ -1118,6 +1564,28 @@ static int axconf__strappendch( char **p, char c )
 ===============================================================================
 */
 
+#if AXCONF_IMPLEMENT
+/*! \internal \brief Free, unmap, or forget the buffer depending on who owns it */
+static void axconf__release_buffer( axconf_t *p )
+{
+	if( p->uBufFlags & kAxconfBufF_Mapped ) {
+#if AXCONF_MMAP_ENABLED
+# ifdef _WIN32
+		UnmapViewOfFile( ( LPCVOID )p->buf_s );
+# else
+		munmap( ( void * )p->buf_s, ( size_t )( p->buf_e - p->buf_s ) );
+# endif
+#endif
+	} else if( ~p->uBufFlags & kAxconfBufF_Borrowed ) {
+		axconf_buf_free( ( void * )p->buf_s );
+	}
+
+	p->buf_s = ( char * )0;
+	p->buf_e = ( const char * )0;
+	p->uBufFlags = 0;
+}
+#endif
+
 AXCONF_FUNC axconf_t *AXCONF_CALL axconf_init( axconf_t *p )
 #if AXCONF_IMPLEMENT
 {
@@ -1125,6 +1593,8 @@ AXCONF_FUNC axconf_t *AXCONF_CALL axconf_init( axconf_t *p )
 
 	p->buf_s = ( char * )0;
 	p->buf_e = ( const char * )0;
+	p->uBufFlags = 0;
+	p->lex_e = ( const char * )0;
 
 	p->l_head = ( axconf_token_link_t * )0;
 	p->l_tail = ( axconf_token_link_t * )0;
@@ -1133,6 +1603,7 @@ AXCONF_FUNC axconf_t *AXCONF_CALL axconf_init( axconf_t *p )
 	p->r_head = ( axconf_report_t * )0;
 	p->r_tail = ( axconf_report_t * )0;
 
+	p->r_outOfMemory.Severity = kAxconfSev_Silent;
 	p->r_temp_i = 0;
 
 	p->cMaxErrors = ~0U;
@@ -1148,25 +1619,26 @@ AXCONF_FUNC axconf_t *AXCONF_CALL axconf_init( axconf_t *p )
 #else
 ;
 #endif
-AXCONF_FUNC axconf_t *AXCONF_CALL axconf_fini( axconf_t *p )
 #if AXCONF_IMPLEMENT
+/*! \internal \brief Free a list of tokens, starting at `t` */
+static void axconf__free_tokens( axconf_token_link_t *t )
 {
-	axconf_token_link_t *t, *tn;
-	axconf_report_t *r, *rn;
-	axconf_free( ( void * )p->pszFilename );
-	axconf_free( ( void * )p->buf_s );
+	axconf_token_link_t *tn;
 
-	p->pszFilename = ( char * )0;
-	p->buf_s = ( char * )0;
-	p->buf_e = ( const char * )0;
-
-	/* Free each token */
-	for( t = p->l_head; t != ( axconf_token_link_t * )0; t = tn ) {
+	for( ; t != ( axconf_token_link_t * )0; t = tn ) {
 		tn = t->l_next;
 
 		axconf_prc_free( ( void * )t->tok.pOwnedMem );
 		axconf_tok_free( ( void * )t );
 	}
+}
+/*! \internal \brief Free all tokens and reports of the configuration */
+static void axconf__free_lexed( axconf_t *p )
+{
+	axconf_report_t *r, *rn;
+
+	/* Free each token */
+	axconf__free_tokens( p->l_head );
 
 	p->l_head = ( axconf_token_link_t * )0;
 	p->l_tail = ( axconf_token_link_t * )0;
@@ -1185,6 +1657,18 @@ AXCONF_FUNC axconf_t *AXCONF_CALL axconf_fini( axconf_t *p )
 
 	p->r_head = ( axconf_report_t * )0;
 	p->r_tail = ( axconf_report_t * )0;
+}
+#endif
+
+AXCONF_FUNC axconf_t *AXCONF_CALL axconf_fini( axconf_t *p )
+#if AXCONF_IMPLEMENT
+{
+	axconf_free( ( void * )p->pszFilename );
+	axconf__release_buffer( p );
+
+	p->pszFilename = ( char * )0;
+
+	axconf__free_lexed( p );
 
 	/* Remove references of this config from the context */
 	if( p->pContext != ( axconf_context_t * )0 ) {
@@ -1257,7 +1741,7 @@ AXCONF_FUNC int AXCONF_CALL axconf_set_buffer_size( axconf_t *p, axconf_size_t n
 		pBuffer = ( char * )0;
 	}
 
-	axconf_buf_free( ( void * )p->buf_s );
+	axconf__release_buffer( p );
 	p->buf_s = pBuffer;
 	p->buf_e = pBuffer + n;
 
@@ -1290,6 +1774,7 @@ AXCONF_FUNC void AXCONF_CALL axconf_write( axconf_t *p, const char *pszSrcBuffer
 #if AXCONF_IMPLEMENT
 {
 	AXCONF_ASSERT( p->buf_s != ( char * )0 && "Destination buffer not set" );
+	AXCONF_ASSERT( !p->uBufFlags && "Destination buffer is read-only" );
 	AXCONF_ASSERT( cSrcBytes == ( axconf_size_t )( p->buf_e - p->buf_s )
 		&& "Source buffer size does not match destination buffer size" );
 
@@ -1301,6 +1786,134 @@ AXCONF_FUNC void AXCONF_CALL axconf_write( axconf_t *p, const char *pszSrcBuffer
 ;
 #endif
 
+/*! Lex directly from the caller's memory rather than copying it
+
+	The `cSrcBytes` bytes at `pSrcBuffer` are used in place. They must remain
+	valid and unchanged until the buffer is replaced or axconf_fini is called,
+	and for as long as any context borrowing from it (kAxconfCtxF_Borrow) is
+	alive. No NUL terminator is required.
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_set_buffer_ref( axconf_t *p, const char *pSrcBuffer, axconf_size_t cSrcBytes )
+#if AXCONF_IMPLEMENT
+{
+	AXCONF_ASSERT( ( pSrcBuffer != ( const char * )0 || !cSrcBytes ) && "Invalid buffer" );
+
+	axconf__release_buffer( p );
+
+	/* the lexer requires a non-NULL buffer, even if empty */
+	p->buf_s = ( char * )( pSrcBuffer != ( const char * )0 ? pSrcBuffer : "" );
+	p->buf_e = p->buf_s + cSrcBytes;
+	p->uBufFlags = kAxconfBufF_Borrowed;
+
+	return 1;
+}
+#else
+;
+#endif
+#if AXCONF_MMAP_ENABLED
+/*! Memory-map a file read-only and use it as the buffer
+
+	This also sets the configuration's file name. The mapping is released when
+	the buffer is replaced or axconf_fini is called. Returns 0 if the file could
+	not be opened or mapped; the configuration is left unchanged in that case.
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_map_file( axconf_t *p, const char *pszFilename )
+# if AXCONF_IMPLEMENT
+{
+	const char *pMap;
+	axconf_size_t cBytes;
+
+	AXCONF_ASSERT( pszFilename != ( const char * )0 && "Filename must be set" );
+
+#  ifdef _WIN32
+	{
+		HANDLE hFile, hMapping;
+		LARGE_INTEGER Size;
+
+		hFile = CreateFileA( pszFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+		if( hFile == INVALID_HANDLE_VALUE ) {
+			return 0;
+		}
+
+		if( !GetFileSizeEx( hFile, &Size ) || ( axconf_u64_t )Size.QuadPart > ( axconf_u64_t )( ( axconf_size_t )-1 ) ) {
+			CloseHandle( hFile );
+			return 0;
+		}
+
+		cBytes = ( axconf_size_t )Size.QuadPart;
+		pMap = ( const char * )0;
+		if( cBytes > 0 ) {
+			hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+			if( hMapping != NULL ) {
+				pMap = ( const char * )MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+				CloseHandle( hMapping );
+			}
+		}
+
+		CloseHandle( hFile );
+		if( cBytes > 0 && !pMap ) {
+			return 0;
+		}
+	}
+#  else
+	{
+		struct stat st;
+		void *pView;
+		int fd;
+
+		fd = open( pszFilename, O_RDONLY );
+		if( fd == -1 ) {
+			return 0;
+		}
+
+		if( fstat( fd, &st ) != 0 || st.st_size < 0 || ( axconf_u64_t )st.st_size > ( axconf_u64_t )( ( axconf_size_t )-1 ) ) {
+			close( fd );
+			return 0;
+		}
+
+		cBytes = ( axconf_size_t )st.st_size;
+		pMap = ( const char * )0;
+		if( cBytes > 0 ) {
+			pView = mmap( ( void * )0, ( size_t )cBytes, PROT_READ, MAP_PRIVATE, fd, 0 );
+			if( pView != MAP_FAILED ) {
+				pMap = ( const char * )pView;
+#   ifdef MADV_SEQUENTIAL
+				madvise( pView, ( size_t )cBytes, MADV_SEQUENTIAL );
+#   endif
+			}
+		}
+
+		close( fd );
+		if( cBytes > 0 && !pMap ) {
+			return 0;
+		}
+	}
+#  endif
+
+	if( !axconf_set_filename( p, pszFilename ) ) {
+		if( pMap != ( const char * )0 ) {
+#  ifdef _WIN32
+			UnmapViewOfFile( ( LPCVOID )pMap );
+#  else
+			munmap( ( void * )pMap, ( size_t )cBytes );
+#  endif
+		}
+		return 0;
+	}
+
+	/* empty files can't be mapped, so just borrow an empty buffer */
+	axconf_set_buffer_ref( p, pMap, cBytes );
+	if( pMap != ( const char * )0 ) {
+		p->uBufFlags = kAxconfBufF_Mapped;
+	}
+
+	return 1;
+}
+# else
+;
+# endif
+#endif
+
 AXCONF_FUNC const char *AXCONF_CALL axconf_get_buffer( const axconf_t *p )
 #if AXCONF_IMPLEMENT
 {
@@ -1783,6 +2396,10 @@ AXCONF_FUNC void AXCONF_CALL axconf_print_reports( const axconf_t *p )
 #if AXCONF_IMPLEMENT
 static void AXCONF_CALL axconf__val_unlink( axconf_value_link_t *pVal )
 {
+	if( pVal->pVar != ( axconf_var_t * )0 ) {
+		--pVal->pVar->cValues;
+	}
+
 	if( pVal->l_prev != ( axconf_value_link_t * )0 ) {
 		pVal->l_prev->l_next = pVal->l_next;
 	} else if( pVal->pVar != ( axconf_var_t * )0 ) {
@@ -1805,6 +2422,7 @@ AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_val_init( axconf_value_link_
 #if AXCONF_IMPLEMENT
 {
 	pVal->pVar = ( axconf_var_t * )0;
+	pVal->uFlags = 0;
 
 	pVal->l_prev = ( axconf_value_link_t * )0;
 	pVal->l_next = ( axconf_value_link_t * )0;
@@ -1818,6 +2436,7 @@ AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_val_init( axconf_value_link_
 	pVal->Data.psz = ( char * )0;
 	pVal->Data.bin.cBytes = 0;
 	pVal->Data.bin.pBytes = ( unsigned char * )0;
+	pVal->cStrBytes = 0;
 
 	return pVal;
 }
@@ -1832,6 +2451,10 @@ AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_val_fini( axconf_value_link_
 	}
 
 	if( pVal->pVar != ( axconf_var_t * )0 ) {
+		axconf__sect_touch( pVal->pVar->pSection );
+	}
+
+	if( pVal->pVar != ( axconf_var_t * )0 && ( ~pVal->uFlags & kAxconfNodeF_BorrowedData ) ) {
 		if( pVal->pVar->ValueTy == kAxconfValTy_Blob ) {
 			axconf_prc_free( ( void * )pVal->Data.bin.pBytes );
 		} else if( pVal->pVar->ValueTy == kAxconfValTy_String ) {
@@ -1839,6 +2462,8 @@ AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_val_fini( axconf_value_link_
 		}
 	}
 
+	pVal->uFlags &= ~kAxconfNodeF_BorrowedData;
+
 	axconf__val_unlink( pVal );
 	return ( axconf_value_link_t * )0;
 }
@@ -1848,15 +2473,56 @@ AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_val_fini( axconf_value_link_
 AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_val_free( axconf_value_link_t *pVal )
 #if AXCONF_IMPLEMENT
 {
-	axconf_val_fini( pVal );
-	axconf_free( ( void * )pVal );
-
+	if( !pVal ) {
+		return ( axconf_value_link_t * )0;
+	}
+
+	axconf_val_fini( pVal );
+	if( ~pVal->uFlags & kAxconfNodeF_Arena ) {
+		axconf_free( ( void * )pVal );
+	}
+
 	return ( axconf_value_link_t * )0;
 }
 #else
 ;
 #endif
 
+#if AXCONF_IMPLEMENT
+/*! \internal \brief Length of a string value, including ones set without a length */
+static axconf_size_t axconf__val_strlen( const axconf_value_link_t *pVal )
+{
+	if( !pVal->Data.psz ) {
+		return 0;
+	}
+
+	if( pVal->cStrBytes > 0 || ( pVal->uFlags & kAxconfNodeF_BorrowedData ) ) {
+		return pVal->cStrBytes;
+	}
+
+	return axconf_strlen( pVal->Data.psz );
+}
+#endif
+
+/*! Retrieve the text of a string value
+
+	The returned text is only guaranteed to be NUL-terminated if the value does
+	not borrow its data (see kAxconfCtxF_Borrow). `pcBytes` is optional and
+	receives the length of the text.
+*/
+AXCONF_FUNC const char *AXCONF_CALL axconf_val_get_string( const axconf_value_link_t *pVal, axconf_size_t *pcBytes )
+#if AXCONF_IMPLEMENT
+{
+	if( pcBytes != ( axconf_size_t * )0 ) {
+		*pcBytes = axconf__val_strlen( pVal );
+	}
+
+	return pVal->Data.psz != ( char * )0 ? pVal->Data.psz : "";
+}
+#else
+;
+#endif
+
 
 /*
 ===============================================================================
@@ -1874,6 +2540,9 @@ AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_var_init( axconf_var_t *pVar, axcon
 #if AXCONF_IMPLEMENT
 {
 	pVar->pszName = ( char * )0;
+	pVar->Name.n = 0;
+	pVar->Name.s = ( const char * )0;
+	pVar->uFlags = 0;
 
 	pVar->ValueTy = kAxconfValTy_Invalid;
 
@@ -1881,6 +2550,9 @@ AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_var_init( axconf_var_t *pVar, axcon
 	pVar->l_head = ( axconf_value_link_t * )0;
 	pVar->l_tail = ( axconf_value_link_t * )0;
 
+	axconf__ctx_drop_index( pSect->pContext );
+	axconf__sect_touch( pSect );
+
 	pVar->pSection = pSect;
 	pVar->v_prev = pSect->v_tail;
 	pVar->v_next = ( axconf_var_t * )0;
@@ -1903,8 +2575,15 @@ AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_var_fini( axconf_var_t *pVar )
 		return ( axconf_var_t * )0;
 	}
 
+	if( pVar->pSection != ( axconf_section_t * )0 ) {
+		axconf__ctx_drop_index( pVar->pSection->pContext );
+	}
+	axconf__sect_touch( pVar->pSection );
+
 	axconf_free( ( void * )pVar->pszName );
 	pVar->pszName = ( char * )0;
+	pVar->Name.n = 0;
+	pVar->Name.s = ( const char * )0;
 
 	while( pVar->l_head != ( axconf_value_link_t * )0 ) {
 		axconf_val_free( pVar->l_head );
@@ -1934,8 +2613,14 @@ AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_var_fini( axconf_var_t *pVar )
 AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_var_free( axconf_var_t *pVar )
 #if AXCONF_IMPLEMENT
 {
+	if( !pVar ) {
+		return ( axconf_var_t * )0;
+	}
+
 	axconf_var_fini( pVar );
-	axconf_free( ( void * )pVar );
+	if( ~pVar->uFlags & kAxconfNodeF_Arena ) {
+		axconf_free( ( void * )pVar );
+	}
 
 	return ( axconf_var_t * )0;
 }
@@ -1953,8 +2638,13 @@ AXCONF_FUNC int AXCONF_CALL axconf_var_set_name_n( axconf_var_t *pVar, const cha
 		return 0;
 	}
 
+	axconf__ctx_drop_index( pVar->pSection != ( axconf_section_t * )0 ? pVar->pSection->pContext : ( axconf_context_t * )0 );
+	axconf__sect_touch( pVar->pSection );
+
 	axconf_free( ( void * )pVar->pszName );
 	pVar->pszName = p;
+	pVar->Name.n = ( int )cNameBytes;
+	pVar->Name.s = p;
 
 	return 1;
 }
@@ -1971,8 +2661,33 @@ AXCONF_FUNC int AXCONF_CALL axconf_var_set_name( axconf_var_t *pVar, const char
 		return 0;
 	}
 
+	axconf__ctx_drop_index( pVar->pSection != ( axconf_section_t * )0 ? pVar->pSection->pContext : ( axconf_context_t * )0 );
+	axconf__sect_touch( pVar->pSection );
+
 	axconf_free( ( void * )pVar->pszName );
 	pVar->pszName = p;
+	pVar->Name.n = ( int )axconf_strlen( p );
+	pVar->Name.s = p;
+
+	return 1;
+}
+#else
+;
+#endif
+/*! Set the name of the variable to a span without copying it
+
+	The memory must outlive the variable (or its next rename).
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_var_set_name_ref( axconf_var_t *pVar, const char *pNameBase, axconf_size_t cNameBytes )
+#if AXCONF_IMPLEMENT
+{
+	axconf__ctx_drop_index( pVar->pSection != ( axconf_section_t * )0 ? pVar->pSection->pContext : ( axconf_context_t * )0 );
+	axconf__sect_touch( pVar->pSection );
+
+	axconf_free( ( void * )pVar->pszName );
+	pVar->pszName = ( char * )0;
+	pVar->Name.n = ( int )cNameBytes;
+	pVar->Name.s = pNameBase;
 
 	return 1;
 }
@@ -1982,7 +2697,20 @@ AXCONF_FUNC int AXCONF_CALL axconf_var_set_name( axconf_var_t *pVar, const char
 AXCONF_FUNC const char *AXCONF_CALL axconf_var_get_name( const axconf_var_t *pVar )
 #if AXCONF_IMPLEMENT
 {
-	return !pVar->pszName ? "" : pVar->pszName;
+	const char *pszName;
+
+	/* borrowed names are only copied out the first time they're asked for */
+	pszName = axconf__name_cstr( ( char ** )&pVar->pszName, &pVar->Name );
+	return !pszName ? "" : pszName;
+}
+#else
+;
+#endif
+/*! Retrieve the name of the variable without requiring a NUL terminator */
+AXCONF_FUNC const axconf_stringref_t *AXCONF_CALL axconf_var_get_name_ref( const axconf_var_t *pVar )
+#if AXCONF_IMPLEMENT
+{
+	return &pVar->Name;
 }
 #else
 ;
@@ -2014,6 +2742,99 @@ AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_var_last_value( const axconf
 ;
 #endif
 
+AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_var_add_value( axconf_var_t *pVar )
+#if AXCONF_IMPLEMENT
+{
+	axconf_value_link_t *pVal;
+	unsigned uFlags;
+
+	pVal = ( axconf_value_link_t * )axconf__ctx_alloc( pVar->pSection->pContext, sizeof( *pVal ), &uFlags );
+	if( !pVal ) {
+		return ( axconf_value_link_t * )0;
+	}
+
+	axconf_val_init( pVal );
+	pVal->uFlags = uFlags;
+
+	pVal->pVar = pVar;
+	pVal->l_prev = pVar->l_tail;
+	if( pVar->l_tail != ( axconf_value_link_t * )0 ) {
+		pVar->l_tail->l_next = pVal;
+	} else {
+		pVar->l_head = pVal;
+	}
+	pVar->l_tail = pVal;
+	++pVar->cValues;
+
+	axconf__sect_touch( pVar->pSection );
+
+	return pVal;
+}
+#else
+;
+#endif
+/*! Append the text of a string token as a value of the variable
+
+	If the context borrows (kAxconfCtxF_Borrow) and the string had no escape
+	sequences then the value refers directly into the source buffer. Otherwise
+	the text is copied. The variable must be untyped or a string variable.
+*/
+AXCONF_FUNC axconf_value_link_t *AXCONF_CALL axconf_var_add_string_by_token( axconf_var_t *pVar, const axconf_token_t *pTok )
+#if AXCONF_IMPLEMENT
+{
+	axconf_value_link_t *pVal;
+	axconf_context_t *pCtx;
+	axconf_size_t cBytes;
+	const char *pText;
+	char *pCopy;
+
+	AXCONF_ASSERT( pTok->type == kAxconfTok_String && "String token expected" );
+
+	if( pVar->ValueTy != kAxconfValTy_Invalid && pVar->ValueTy != kAxconfValTy_String ) {
+		return ( axconf_value_link_t * )0;
+	}
+
+	if( pTok->uFlags & kAxconfTokF_Processed ) {
+		pText = pTok->processed.pszEscaped;
+		cBytes = *axconf__strlenptr( pText );
+	} else {
+		/* strip the quotes (the closing one is missing if unterminated) */
+		pText = pTok->pLexanS + 1;
+		cBytes = ( axconf_size_t )( pTok->pLexanE - pText );
+		if( cBytes > 0 && pText[ cBytes - 1 ] == '\"' ) {
+			--cBytes;
+		}
+	}
+
+	pVal = axconf_var_add_value( pVar );
+	if( !pVal ) {
+		return ( axconf_value_link_t * )0;
+	}
+
+	pVar->ValueTy = kAxconfValTy_String;
+	pCtx = pVar->pSection->pContext;
+
+	if( ( pCtx->uFlags & kAxconfCtxF_Borrow ) && ( ~pTok->uFlags & kAxconfTokF_Processed ) ) {
+		pVal->Data.psz = ( char * )pText;
+		pVal->cStrBytes = cBytes;
+		pVal->uFlags |= kAxconfNodeF_BorrowedData;
+		return pVal;
+	}
+
+	pCopy = axconf__ctx_copy_bytes( pCtx, ( const void * )pText, cBytes, &pVal->uFlags );
+	if( !pCopy ) {
+		return axconf_val_free( pVal );
+	}
+
+	pVal->Data.psz = pCopy;
+	pVal->cStrBytes = cBytes;
+
+	return pVal;
+}
+#else
+;
+#endif
+
 AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_var_get_section( const axconf_var_t *pVar )
 #if AXCONF_IMPLEMENT
 {
@@ -2057,7 +2878,11 @@ AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_sect_init( axconf_section_t *pS
 #if AXCONF_IMPLEMENT
 {
 	pSect->pszName = ( char * )0;
+	pSect->Name.n = 0;
+	pSect->Name.s = ( const char * )0;
+	pSect->uFlags = 0;
 	pSect->pContext = pCtx;
+	axconf__ctx_drop_index( pCtx );
 	pSect->s_prev = pCtx->s_tail;
 	pSect->s_next = ( axconf_section_t * )0;
 	if( pCtx->s_tail != ( axconf_section_t * )0 ) {
@@ -2087,6 +2912,28 @@ AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_sect_fini( axconf_section_t *pS
 
 	axconf_free( ( void * )pSect->pszName );
 	pSect->pszName = ( char * )0;
+	pSect->Name.n = 0;
+	pSect->Name.s = ( const char * )0;
+
+	if( pSect->pContext != ( axconf_context_t * )0 ) {
+		axconf__ctx_drop_index( pSect->pContext );
+
+		if( pSect->s_prev != ( axconf_section_t * )0 ) {
+			pSect->s_prev->s_next = pSect->s_next;
+		} else {
+			pSect->pContext->s_head = pSect->s_next;
+		}
+
+		if( pSect->s_next != ( axconf_section_t * )0 ) {
+			pSect->s_next->s_prev = pSect->s_prev;
+		} else {
+			pSect->pContext->s_tail = pSect->s_prev;
+		}
+	}
+
+	pSect->s_prev = ( axconf_section_t * )0;
+	pSect->s_next = ( axconf_section_t * )0;
+	pSect->pContext = ( axconf_context_t * )0;
 
 	return ( axconf_section_t * )0;
 }
@@ -2096,8 +2943,14 @@ AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_sect_fini( axconf_section_t *pS
 AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_sect_free( axconf_section_t *pSect )
 #if AXCONF_IMPLEMENT
 {
+	if( !pSect ) {
+		return ( axconf_section_t * )0;
+	}
+
 	axconf_sect_fini( pSect );
-	axconf_free( ( void * )pSect );
+	if( ~pSect->uFlags & kAxconfNodeF_Arena ) {
+		axconf_free( ( void * )pSect );
+	}
 
 	return ( axconf_section_t * )0;
 }
@@ -2115,8 +2968,12 @@ AXCONF_FUNC int AXCONF_CALL axconf_sect_set_name_n( axconf_section_t *pSect, con
 		return 0;
 	}
 
+	axconf__ctx_drop_index( pSect->pContext );
+
 	axconf_free( ( void * )pSect->pszName );
 	pSect->pszName = p;
+	pSect->Name.n = ( int )cNameBytes;
+	pSect->Name.s = p;
 
 	return 1;
 }
@@ -2133,8 +2990,31 @@ AXCONF_FUNC int AXCONF_CALL axconf_sect_set_name( axconf_section_t *pSect, const
 		return 0;
 	}
 
+	axconf__ctx_drop_index( pSect->pContext );
+
 	axconf_free( ( void * )pSect->pszName );
 	pSect->pszName = p;
+	pSect->Name.n = ( int )axconf_strlen( p );
+	pSect->Name.s = p;
+
+	return 1;
+}
+#else
+;
+#endif
+/*! Set the name of the section to a span without copying it
+
+	The memory must outlive the section (or its next rename).
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_sect_set_name_ref( axconf_section_t *pSect, const char *pNameBase, axconf_size_t cNameBytes )
+#if AXCONF_IMPLEMENT
+{
+	axconf__ctx_drop_index( pSect->pContext );
+
+	axconf_free( ( void * )pSect->pszName );
+	pSect->pszName = ( char * )0;
+	pSect->Name.n = ( int )cNameBytes;
+	pSect->Name.s = pNameBase;
 
 	return 1;
 }
@@ -2144,7 +3024,17 @@ AXCONF_FUNC int AXCONF_CALL axconf_sect_set_name( axconf_section_t *pSect, const
 AXCONF_FUNC const char *AXCONF_CALL axconf_sect_get_name( const axconf_section_t *pSect )
 #if AXCONF_IMPLEMENT
 {
-	return pSect->pszName;
+	/* borrowed names are only copied out the first time they're asked for */
+	return axconf__name_cstr( ( char ** )&pSect->pszName, &pSect->Name );
+}
+#else
+;
+#endif
+/*! Retrieve the name of the section without requiring a NUL terminator */
+AXCONF_FUNC const axconf_stringref_t *AXCONF_CALL axconf_sect_get_name_ref( const axconf_section_t *pSect )
+#if AXCONF_IMPLEMENT
+{
+	return &pSect->Name;
 }
 #else
 ;
@@ -2167,6 +3057,49 @@ AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_sect_next( const axconf_section
 ;
 #endif
 
+AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_sect_add_var( axconf_section_t *pSect )
+#if AXCONF_IMPLEMENT
+{
+	axconf_var_t *pVar;
+	unsigned uFlags;
+
+	pVar = ( axconf_var_t * )axconf__ctx_alloc( pSect->pContext, sizeof( *pVar ), &uFlags );
+	if( !pVar ) {
+		return ( axconf_var_t * )0;
+	}
+
+	axconf_var_init( pVar, pSect );
+	pVar->uFlags = uFlags;
+
+	return pVar;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_sect_add_var_by_token( axconf_section_t *pSect, const axconf_token_t *pTok )
+#if AXCONF_IMPLEMENT
+{
+	axconf_var_t *pVar;
+	axconf_size_t cBytes;
+
+	pVar = axconf_sect_add_var( pSect );
+	if( !pVar ) {
+		return ( axconf_var_t * )0;
+	}
+
+	cBytes = ( axconf_size_t )( pTok->pLexanE - pTok->pLexanS );
+	if( pSect->pContext->uFlags & kAxconfCtxF_Borrow ) {
+		axconf_var_set_name_ref( pVar, pTok->pLexanS, cBytes );
+	} else if( !axconf_var_set_name_n( pVar, pTok->pLexanS, cBytes ) ) {
+		return axconf_var_free( pVar );
+	}
+
+	return pVar;
+}
+#else
+;
+#endif
+
 AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_sect_first_var( const axconf_section_t *pSect )
 #if AXCONF_IMPLEMENT
 {
@@ -2278,108 +3211,1094 @@ AXCONF_FUNC axconf_context_t *AXCONF_CALL axconf_ctx_init( axconf_context_t *pCt
 	pCtx->s_head = ( axconf_section_t * )0;
 	pCtx->s_tail = ( axconf_section_t * )0;
 
-	pCtx->cConfigs = 0;
-	pCtx->ppConfigs = ( axconf_t ** )0;
+	pCtx->cConfigs = 0;
+	pCtx->ppConfigs = ( axconf_t ** )0;
+
+	pCtx->uFlags = 0;
+	pCtx->Arena.pHead = ( axconf_arena_block_t * )0;
+	pCtx->Arena.pCurr = ( char * )0;
+	pCtx->Arena.pEnd = ( char * )0;
+
+	pCtx->Index.pSects = ( axconf_index_slot_t * )0;
+	pCtx->Index.cSectSlots = 0;
+	pCtx->Index.pVars = ( axconf_index_slot_t * )0;
+	pCtx->Index.cVarSlots = 0;
+
+	if( !axconf__ctx_addcfg( pCtx, pCfg ) ) {
+		return ( axconf_context_t * )0;
+	}
+
+	return pCtx;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_context_t *AXCONF_CALL axconf_ctx_fini( axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	axconf_size_t i;
+
+	/* Remove self from parent */
+	if( pCtx->ctx_prnt != ( axconf_context_t * )0 ) {
+		axconf__ctx_unlink( pCtx );
+	}
+
+	/* Remove all sub-contexts */
+	while( pCtx->ctx_head != ( axconf_context_t * )0 ) {
+		axconf_ctx_fini( pCtx->ctx_head );
+	}
+
+	/* Remove self from all configurations still pointing to this */
+	for( i = 0; i < pCtx->cConfigs; ++i ) {
+		if( pCtx->ppConfigs[ i ]->pContext != pCtx ) {
+			continue;
+		}
+
+		pCtx->ppConfigs[ i ]->pContext = ( axconf_context_t * )0;
+	}
+
+	/* Remove all sections */
+	while( pCtx->s_head != ( axconf_section_t * )0 ) {
+		axconf_sect_free( pCtx->s_head );
+	}
+
+	/* Release the nodes that were allocated in bulk */
+	axconf__arena_fini( &pCtx->Arena );
+	axconf__ctx_drop_index( pCtx );
+
+	axconf_free( ( void * )pCtx->ppConfigs );
+	pCtx->ppConfigs = ( axconf_t ** )0;
+	pCtx->cConfigs = 0;
+
+	return ( axconf_context_t * )0;
+}
+#else
+;
+#endif
+
+/*! Set how the context allocates and names its nodes (axconf_context_flag_t)
+
+	This should be done before anything is added to the context. Borrowing
+	requires the source buffers of the context's configurations to outlive it.
+*/
+AXCONF_FUNC void AXCONF_CALL axconf_ctx_set_flags( axconf_context_t *pCtx, unsigned uFlags )
+#if AXCONF_IMPLEMENT
+{
+	pCtx->uFlags = uFlags;
+}
+#else
+;
+#endif
+AXCONF_FUNC unsigned AXCONF_CALL axconf_ctx_get_flags( const axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	return pCtx->uFlags;
+}
+#else
+;
+#endif
+
+AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_add_section( axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	axconf_section_t *pSect;
+	unsigned uFlags;
+
+	pSect = ( axconf_section_t * )axconf__ctx_alloc( pCtx, sizeof( *pSect ), &uFlags );
+	if( !pSect ) {
+		return ( axconf_section_t * )0;
+	}
+
+	axconf_sect_init( pSect, pCtx );
+	pSect->uFlags = uFlags;
+
+	return pSect;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_add_section_by_token( axconf_context_t *pCtx, const axconf_token_t *pTok )
+#if AXCONF_IMPLEMENT
+{
+	axconf_section_t *pSect;
+
+	pSect = axconf_ctx_add_section( pCtx );
+	if( !pSect ) {
+		return ( axconf_section_t * )0;
+	}
+
+	if( pCtx->uFlags & kAxconfCtxF_Borrow ) {
+		axconf_sect_set_name_ref( pSect, pTok->pLexanS, ( axconf_size_t )( pTok->pLexanE - pTok->pLexanS ) );
+	} else if( !axconf_sect_set_name_n( pSect, pTok->pLexanS, ( axconf_size_t )( pTok->pLexanE - pTok->pLexanS ) ) ) {
+		return axconf_sect_free( pSect );
+	}
+
+	return pSect;
+}
+#else
+;
+#endif
+
+AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_first_section( const axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	return ( axconf_section_t * )pCtx->s_head;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_last_section( const axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	return ( axconf_section_t * )pCtx->s_tail;
+}
+#else
+;
+#endif
+
+
+/*
+===============================================================================
+###############################################################################
+===============================================================================
+
+	LOOKUP BY NAME
+
+===============================================================================
+###############################################################################
+===============================================================================
+*/
+
+#if AXCONF_IMPLEMENT
+static unsigned axconf__hash_span( const char *s, axconf_size_t n, unsigned seed )
+{
+	if( !s ) {
+		s = "";
+	}
+
+	return axconf_hash( s, s + n, seed );
+}
+/*! \internal \brief Seed for hashing the variables of a given section */
+static unsigned axconf__sect_seed( const axconf_section_t *pSect )
+{
+	axconf_size_t x;
+
+	x = ( axconf_size_t )pSect;
+	return ( unsigned )( ( x >> 4 ) ^ ( x >> 20 ) )*0x9E3779B1U;
+}
+static int axconf__name_eq( const axconf_stringref_t *pName, const char *s, axconf_size_t n )
+{
+	if( ( axconf_size_t )pName->n != n ) {
+		return 0;
+	}
+
+	return n == 0 || axconf_memcmp( ( const void * )pName->s, ( const void * )s, n ) == 0;
+}
+static axconf_size_t axconf__index_slots( axconf_size_t cItems )
+{
+	axconf_size_t n;
+
+	/* keep the load factor at or below one half */
+	n = 8;
+	while( n < cItems*2 ) {
+		n *= 2;
+	}
+
+	return n;
+}
+static void axconf__index_insert( axconf_index_slot_t *pSlots, axconf_size_t cSlots, unsigned uHash, void *pNode )
+{
+	axconf_size_t i;
+
+	for( i = uHash & ( cSlots - 1 ); pSlots[ i ].pNode != ( void * )0; i = ( i + 1 ) & ( cSlots - 1 ) ) {
+	}
+
+	pSlots[ i ].uHash = uHash;
+	pSlots[ i ].pNode = pNode;
+}
+#endif
+
+/*! Build (or rebuild) the index used by the find functions
+
+	This should be called once the context has been fully loaded. Adding,
+	removing, or renaming any section or variable of the context discards the
+	index, after which the find functions fall back to a linear search until it
+	is built again. Returns 0 if memory could not be allocated.
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_ctx_build_index( axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	axconf_index_slot_t *pSects, *pVars;
+	axconf_size_t cSects, cVars;
+	axconf_size_t cSectSlots, cVarSlots;
+	axconf_section_t *pSect;
+	axconf_var_t *pVar;
+	axconf_size_t i;
+	unsigned uSeed;
+
+	axconf__ctx_drop_index( pCtx );
+
+	cSects = 0;
+	cVars = 0;
+	for( pSect = pCtx->s_head; pSect != ( axconf_section_t * )0; pSect = pSect->s_next ) {
+		++cSects;
+		for( pVar = pSect->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+			++cVars;
+		}
+	}
+
+	cSectSlots = axconf__index_slots( cSects );
+	cVarSlots = axconf__index_slots( cVars );
+
+	pSects = ( axconf_index_slot_t * )axconf_alloc( sizeof( *pSects )*cSectSlots );
+	pVars = ( axconf_index_slot_t * )axconf_alloc( sizeof( *pVars )*cVarSlots );
+	if( !pSects || !pVars ) {
+		axconf_free( ( void * )pSects );
+		axconf_free( ( void * )pVars );
+		return 0;
+	}
+
+	for( i = 0; i < cSectSlots; ++i ) {
+		pSects[ i ].pNode = ( void * )0;
+	}
+	for( i = 0; i < cVarSlots; ++i ) {
+		pVars[ i ].pNode = ( void * )0;
+	}
+
+	/* with linear probing an earlier duplicate is always found first, so the
+	`  first section or variable of a given name wins */
+	for( pSect = pCtx->s_head; pSect != ( axconf_section_t * )0; pSect = pSect->s_next ) {
+		axconf__index_insert( pSects, cSectSlots, axconf__hash_span( pSect->Name.s, ( axconf_size_t )pSect->Name.n, 0 ), ( void * )pSect );
+
+		uSeed = axconf__sect_seed( pSect );
+		for( pVar = pSect->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+			axconf__index_insert( pVars, cVarSlots, axconf__hash_span( pVar->Name.s, ( axconf_size_t )pVar->Name.n, uSeed ), ( void * )pVar );
+		}
+	}
+
+	pCtx->Index.pSects = pSects;
+	pCtx->Index.cSectSlots = cSectSlots;
+	pCtx->Index.pVars = pVars;
+	pCtx->Index.cVarSlots = cVarSlots;
+
+	return 1;
+}
+#else
+;
+#endif
+/*! Determine whether the context's lookup index is current */
+AXCONF_FUNC int AXCONF_CALL axconf_ctx_has_index( const axconf_context_t *pCtx )
+#if AXCONF_IMPLEMENT
+{
+	return pCtx->Index.pSects != ( axconf_index_slot_t * )0;
+}
+#else
+;
+#endif
+
+/*! Find the first section with the given name (empty for the global section) */
+AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_find_section_n( const axconf_context_t *pCtx, const char *pName, axconf_size_t cNameBytes )
+#if AXCONF_IMPLEMENT
+{
+	const axconf_index_slot_t *pSlot;
+	axconf_section_t *pSect;
+	axconf_size_t uMask;
+	axconf_size_t i;
+	unsigned uHash;
+
+	if( !pCtx->Index.pSects ) {
+		for( pSect = pCtx->s_head; pSect != ( axconf_section_t * )0; pSect = pSect->s_next ) {
+			if( axconf__name_eq( &pSect->Name, pName, cNameBytes ) ) {
+				return pSect;
+			}
+		}
+
+		return ( axconf_section_t * )0;
+	}
+
+	uHash = axconf__hash_span( pName, cNameBytes, 0 );
+	uMask = pCtx->Index.cSectSlots - 1;
+	for( i = uHash & uMask; ( pSlot = &pCtx->Index.pSects[ i ] )->pNode != ( void * )0; i = ( i + 1 ) & uMask ) {
+		pSect = ( axconf_section_t * )pSlot->pNode;
+		if( pSlot->uHash == uHash && axconf__name_eq( &pSect->Name, pName, cNameBytes ) ) {
+			return pSect;
+		}
+	}
+
+	return ( axconf_section_t * )0;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_find_section( const axconf_context_t *pCtx, const char *pszName )
+#if AXCONF_IMPLEMENT
+{
+	return axconf_ctx_find_section_n( pCtx, pszName, pszName != ( const char * )0 ? axconf_strlen( pszName ) : 0 );
+}
+#else
+;
+#endif
+
+/*! Find the first variable with the given name in the section */
+AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_sect_find_var_n( const axconf_section_t *pSect, const char *pName, axconf_size_t cNameBytes )
+#if AXCONF_IMPLEMENT
+{
+	const axconf_index_slot_t *pSlot;
+	const axconf_context_t *pCtx;
+	axconf_var_t *pVar;
+	axconf_size_t uMask;
+	axconf_size_t i;
+	unsigned uHash;
+
+	pCtx = pSect->pContext;
+	if( !pCtx || !pCtx->Index.pVars ) {
+		for( pVar = pSect->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+			if( axconf__name_eq( &pVar->Name, pName, cNameBytes ) ) {
+				return pVar;
+			}
+		}
+
+		return ( axconf_var_t * )0;
+	}
+
+	uHash = axconf__hash_span( pName, cNameBytes, axconf__sect_seed( pSect ) );
+	uMask = pCtx->Index.cVarSlots - 1;
+	for( i = uHash & uMask; ( pSlot = &pCtx->Index.pVars[ i ] )->pNode != ( void * )0; i = ( i + 1 ) & uMask ) {
+		pVar = ( axconf_var_t * )pSlot->pNode;
+		if( pSlot->uHash == uHash && pVar->pSection == pSect && axconf__name_eq( &pVar->Name, pName, cNameBytes ) ) {
+			return pVar;
+		}
+	}
+
+	return ( axconf_var_t * )0;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_sect_find_var( const axconf_section_t *pSect, const char *pszName )
+#if AXCONF_IMPLEMENT
+{
+	return axconf_sect_find_var_n( pSect, pszName, pszName != ( const char * )0 ? axconf_strlen( pszName ) : 0 );
+}
+#else
+;
+#endif
+
+/*! Find a variable by a "section.var" path
+
+	Each '.' in the path is tried in turn as the split between the section name
+	and the variable name, so section names may themselves contain dots. A path
+	without a '.' names a variable of the global (unnamed) section.
+*/
+AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_ctx_find_n( const axconf_context_t *pCtx, const char *pPath, axconf_size_t cPathBytes )
+#if AXCONF_IMPLEMENT
+{
+	axconf_section_t *pSect;
+	axconf_var_t *pVar;
+	const char *pDot;
+	const char *e;
+
+	if( !pPath ) {
+		pPath = "";
+	}
+
+	e = pPath + cPathBytes;
+	pDot = ( const char * )axconf_memchr( ( const void * )pPath, '.', cPathBytes );
+	if( !pDot ) {
+		pSect = axconf_ctx_find_section_n( pCtx, "", 0 );
+		return !pSect ? ( axconf_var_t * )0 : axconf_sect_find_var_n( pSect, pPath, cPathBytes );
+	}
+
+	do {
+		pSect = axconf_ctx_find_section_n( pCtx, pPath, ( axconf_size_t )( pDot - pPath ) );
+		if( pSect != ( axconf_section_t * )0 ) {
+			pVar = axconf_sect_find_var_n( pSect, pDot + 1, ( axconf_size_t )( e - ( pDot + 1 ) ) );
+			if( pVar != ( axconf_var_t * )0 ) {
+				return pVar;
+			}
+		}
+
+		pDot = ( const char * )axconf_memchr( ( const void * )( pDot + 1 ), '.', ( axconf_size_t )( e - ( pDot + 1 ) ) );
+	} while( pDot != ( const char * )0 );
+
+	return ( axconf_var_t * )0;
+}
+#else
+;
+#endif
+AXCONF_FUNC axconf_var_t *AXCONF_CALL axconf_ctx_find( const axconf_context_t *pCtx, const char *pszPath )
+#if AXCONF_IMPLEMENT
+{
+	return axconf_ctx_find_n( pCtx, pszPath, pszPath != ( const char * )0 ? axconf_strlen( pszPath ) : 0 );
+}
+#else
+;
+#endif
+
+
+/*
+===============================================================================
+###############################################################################
+===============================================================================
+
+	INCREMENTAL RELOAD
+
+===============================================================================
+###############################################################################
+===============================================================================
+*/
+
+#if AXCONF_IMPLEMENT
+static axconf_u64_t axconf__fnv64( axconf_u64_t h, const void *p, axconf_size_t n )
+{
+	const unsigned char *s;
+
+	for( s = ( const unsigned char * )p; n > 0; --n ) {
+		h ^= *s++;
+		h *= ( ( axconf_u64_t )0x100 << 32 ) | 0x1B3;
+	}
+
+	return h;
+}
+static axconf_u64_t axconf__fnv64_size( axconf_u64_t h, axconf_size_t n )
+{
+	axconf_u64_t x;
+
+	x = ( axconf_u64_t )n;
+	return axconf__fnv64( h, ( const void * )&x, sizeof( x ) );
+}
+
+/*! \internal \brief Hash the names, types, and values of a section's variables */
+static axconf_u64_t axconf__sect_content_hash( const axconf_section_t *pSect )
+{
+	const axconf_value_link_t *pVal;
+	const axconf_var_t *pVar;
+	axconf_u64_t h;
+	axconf_size_t n;
+
+	h = ( ( axconf_u64_t )0xCBF29CE4U << 32 ) | 0x84222325U;
+	for( pVar = pSect->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+		h = axconf__fnv64_size( h, ( axconf_size_t )pVar->Name.n );
+		h = axconf__fnv64( h, ( const void * )pVar->Name.s, ( axconf_size_t )pVar->Name.n );
+		h = axconf__fnv64_size( h, ( axconf_size_t )pVar->ValueTy );
+		h = axconf__fnv64_size( h, pVar->cValues );
+
+		for( pVal = pVar->l_head; pVal != ( axconf_value_link_t * )0; pVal = pVal->l_next ) {
+			switch( pVar->ValueTy ) {
+			case kAxconfValTy_Invalid:
+				break;
+			case kAxconfValTy_Boolean:
+				h = axconf__fnv64_size( h, pVal->Data.b );
+				break;
+			case kAxconfValTy_SignedInteger:
+			case kAxconfValTy_UnsignedInteger:
+				h = axconf__fnv64( h, ( const void * )&pVal->Data.u, sizeof( pVal->Data.u ) );
+				break;
+			case kAxconfValTy_Float:
+				h = axconf__fnv64( h, ( const void * )&pVal->Data.f.iWhole, sizeof( pVal->Data.f.iWhole ) );
+				h = axconf__fnv64_size( h, pVal->Data.f.uFract );
+				h = axconf__fnv64_size( h, ( axconf_size_t )( unsigned )pVal->Data.f.iExp );
+				break;
+			case kAxconfValTy_String:
+				n = axconf__val_strlen( pVal );
+				h = axconf__fnv64_size( h, n );
+				h = axconf__fnv64( h, ( const void * )pVal->Data.psz, n );
+				break;
+			case kAxconfValTy_Blob:
+				h = axconf__fnv64_size( h, pVal->Data.bin.cBytes );
+				h = axconf__fnv64( h, ( const void * )pVal->Data.bin.pBytes, pVal->Data.bin.cBytes );
+				break;
+			}
+		}
+	}
+
+	return h;
+}
+static axconf_u64_t axconf__sect_cached_hash( axconf_section_t *pSect )
+{
+	if( ~pSect->uFlags & kAxconfNodeF_HashValid ) {
+		pSect->uContentHash = axconf__sect_content_hash( pSect );
+		pSect->uFlags |= kAxconfNodeF_HashValid;
+	}
+
+	return pSect->uContentHash;
+}
+
+static int axconf__val_eq( axconf_value_type_t Ty, const axconf_value_link_t *a, const axconf_value_link_t *b )
+{
+	axconf_size_t n;
+
+	switch( Ty ) {
+	case kAxconfValTy_Invalid:
+		return 1;
+	case kAxconfValTy_Boolean:
+		return a->Data.b == b->Data.b;
+	case kAxconfValTy_SignedInteger:
+	case kAxconfValTy_UnsignedInteger:
+		return a->Data.u == b->Data.u;
+	case kAxconfValTy_Float:
+		return a->Data.f.iWhole == b->Data.f.iWhole && a->Data.f.uFract == b->Data.f.uFract && a->Data.f.iExp == b->Data.f.iExp;
+	case kAxconfValTy_String:
+		n = axconf__val_strlen( a );
+		return n == axconf__val_strlen( b ) && ( !n || axconf_memcmp( ( const void * )a->Data.psz, ( const void * )b->Data.psz, n ) == 0 );
+	case kAxconfValTy_Blob:
+		n = a->Data.bin.cBytes;
+		return n == b->Data.bin.cBytes && ( !n || axconf_memcmp( ( const void * )a->Data.bin.pBytes, ( const void * )b->Data.bin.pBytes, n ) == 0 );
+	}
+
+	return 0;
+}
+static int axconf__var_eq( const axconf_var_t *a, const axconf_var_t *b )
+{
+	const axconf_value_link_t *x, *y;
+
+	if( a->ValueTy != b->ValueTy || a->cValues != b->cValues ) {
+		return 0;
+	}
+
+	for( x = a->l_head, y = b->l_head; x != ( axconf_value_link_t * )0 && y != ( axconf_value_link_t * )0; x = x->l_next, y = y->l_next ) {
+		if( !axconf__val_eq( a->ValueTy, x, y ) ) {
+			return 0;
+		}
+	}
+
+	return x == y;
+}
+
+/*! \internal \brief Replace the values of pDst with copies of those of pSrc */
+static int axconf__var_assign( axconf_var_t *pDst, const axconf_var_t *pSrc )
+{
+	const axconf_value_link_t *pSrcVal;
+	axconf_value_link_t *pVal;
+	axconf_context_t *pCtx;
+
+	while( pDst->l_head != ( axconf_value_link_t * )0 ) {
+		axconf_val_free( pDst->l_head );
+	}
+
+	pDst->ValueTy = pSrc->ValueTy;
+	pCtx = pDst->pSection->pContext;
+
+	for( pSrcVal = pSrc->l_head; pSrcVal != ( axconf_value_link_t * )0; pSrcVal = pSrcVal->l_next ) {
+		pVal = axconf_var_add_value( pDst );
+		if( !pVal ) {
+			return 0;
+		}
+
+		if( pSrc->ValueTy == kAxconfValTy_String ) {
+			pVal->cStrBytes = axconf__val_strlen( pSrcVal );
+			pVal->Data.psz = axconf__ctx_copy_bytes( pCtx, ( const void * )pSrcVal->Data.psz, pVal->cStrBytes, &pVal->uFlags );
+			if( !pVal->Data.psz ) {
+				return 0;
+			}
+		} else if( pSrc->ValueTy == kAxconfValTy_Blob ) {
+			pVal->Data.bin.pBytes = ( unsigned char * )axconf__ctx_copy_bytes( pCtx, ( const void * )pSrcVal->Data.bin.pBytes, pSrcVal->Data.bin.cBytes, &pVal->uFlags );
+			if( !pVal->Data.bin.pBytes ) {
+				return 0;
+			}
+			pVal->Data.bin.cBytes = pSrcVal->Data.bin.cBytes;
+		} else {
+			pVal->Data = pSrcVal->Data;
+		}
+	}
+
+	return 1;
+}
+
+/*
+	Matches nodes of the old tree to nodes of the new tree by name
+
+	Each name maps to a chain of the old nodes with that name, in order. Taking
+	a name yields the first node of its chain not yet taken, so the n-th section
+	or variable of a given name in the new tree pairs with the n-th of the old.
+*/
+typedef struct axconf__match_s
+{
+	/* Old nodes and their names, in list order */
+	void **                         ppNodes;
+	const axconf_stringref_t **     ppNames;
+	/* Whether each old node has been taken */
+	unsigned char *                 pTaken;
+	/* Next node with the same name, or ~0 */
+	axconf_size_t *                 pNext;
+	/* Per slot: a node with the name (~0 if the slot is empty), the next node
+	`  of the name to be taken (~0 if exhausted), and the name's hash */
+	axconf_size_t *                 pSlotKey;
+	axconf_size_t *                 pSlotHead;
+	unsigned *                      pSlotHash;
+	axconf_size_t                   cSlots;
+	axconf_size_t                   cNodes;
+} axconf__match_t;
+
+static int axconf__match_init( axconf__match_t *m, axconf_size_t cNodes )
+{
+	axconf_size_t cSlots;
+	axconf_size_t cBytes;
+	char *p;
+
+	cSlots = axconf__index_slots( cNodes );
+	cBytes =
+		cNodes*( sizeof( void * ) + sizeof( axconf_stringref_t * ) + sizeof( axconf_size_t ) ) +
+		cSlots*( sizeof( axconf_size_t )*2 + sizeof( unsigned ) ) +
+		cNodes;
+
+	p = ( char * )axconf_alloc( cBytes );
+	if( !p ) {
+		return 0;
+	}
+
+	/* carve the arrays from largest alignment to smallest */
+	m->ppNodes = ( void ** )p;                      p += cNodes*sizeof( void * );
+	m->ppNames = ( const axconf_stringref_t ** )p;  p += cNodes*sizeof( axconf_stringref_t * );
+	m->pNext = ( axconf_size_t * )p;                p += cNodes*sizeof( axconf_size_t );
+	m->pSlotKey = ( axconf_size_t * )p;             p += cSlots*sizeof( axconf_size_t );
+	m->pSlotHead = ( axconf_size_t * )p;            p += cSlots*sizeof( axconf_size_t );
+	m->pSlotHash = ( unsigned * )p;                 p += cSlots*sizeof( unsigned );
+	m->pTaken = ( unsigned char * )p;
+
+	m->cSlots = cSlots;
+	m->cNodes = cNodes;
+
+	return 1;
+}
+static void axconf__match_fini( axconf__match_t *m )
+{
+	axconf_free( ( void * )m->ppNodes );
+	m->ppNodes = ( void ** )0;
+}
+/*! \internal \brief Find the slot for a name (either its slot or an empty one) */
+static axconf_size_t axconf__match_slot( const axconf__match_t *m, const axconf_stringref_t *pName, unsigned uHash )
+{
+	const axconf_stringref_t *pKeyName;
+	axconf_size_t i;
+
+	for( i = uHash & ( m->cSlots - 1 ); m->pSlotKey[ i ] != ~( axconf_size_t )0; i = ( i + 1 ) & ( m->cSlots - 1 ) ) {
+		pKeyName = m->ppNames[ m->pSlotKey[ i ] ];
+		if( m->pSlotHash[ i ] == uHash && axconf__name_eq( pKeyName, pName->s, ( axconf_size_t )pName->n ) ) {
+			break;
+		}
+	}
+
+	return i;
+}
+/*! \internal \brief Index ppNodes/ppNames once they have been filled in */
+static void axconf__match_build( axconf__match_t *m )
+{
+	axconf_size_t i, j;
+	unsigned uHash;
+
+	for( i = 0; i < m->cSlots; ++i ) {
+		m->pSlotKey[ i ] = ~( axconf_size_t )0;
+	}
+
+	/* walk backward, prepending, so each chain ends up in list order */
+	for( i = m->cNodes; i-- > 0; ) {
+		m->pTaken[ i ] = 0;
+
+		uHash = axconf__hash_span( m->ppNames[ i ]->s, ( axconf_size_t )m->ppNames[ i ]->n, 0 );
+		j = axconf__match_slot( m, m->ppNames[ i ], uHash );
+		if( m->pSlotKey[ j ] == ~( axconf_size_t )0 ) {
+			m->pSlotHash[ j ] = uHash;
+			m->pNext[ i ] = ~( axconf_size_t )0;
+		} else {
+			m->pNext[ i ] = m->pSlotHead[ j ];
+		}
+
+		m->pSlotKey[ j ] = i;
+		m->pSlotHead[ j ] = i;
+	}
+}
+/*! \internal \brief Take the next unmatched old node with the name, or ~0 */
+static axconf_size_t axconf__match_take( axconf__match_t *m, const axconf_stringref_t *pName )
+{
+	axconf_size_t i, j;
+
+	j = axconf__match_slot( m, pName, axconf__hash_span( pName->s, ( axconf_size_t )pName->n, 0 ) );
+	i = m->pSlotKey[ j ] != ~( axconf_size_t )0 ? m->pSlotHead[ j ] : ~( axconf_size_t )0;
+	if( i != ~( axconf_size_t )0 ) {
+		m->pSlotHead[ j ] = m->pNext[ i ];
+		m->pTaken[ i ] = 1;
+	}
+
+	return i;
+}
+
+/*! \internal \brief Add a copy of pSrcVar (name and values) to pSect */
+static axconf_var_t *axconf__sect_copy_var( axconf_section_t *pSect, const axconf_var_t *pSrcVar )
+{
+	axconf_var_t *pVar;
+
+	pVar = axconf_sect_add_var( pSect );
+	if( !pVar ) {
+		return ( axconf_var_t * )0;
+	}
+
+	if( !axconf_var_set_name_n( pVar, pSrcVar->Name.s, ( axconf_size_t )pSrcVar->Name.n ) || !axconf__var_assign( pVar, pSrcVar ) ) {
+		return axconf_var_free( pVar );
+	}
+
+	return pVar;
+}
+
+/*! \internal \brief Bring the variables of pDst in line with those of pSrc */
+static int axconf__sect_sync( axconf_section_t *pDst, const axconf_section_t *pSrc, unsigned uFlags, axconf_fn_change_t pfnChange, void *pUserData )
+{
+	const axconf_var_t *pSrcVar;
+	axconf_var_t *pVar;
+	axconf__match_t m;
+	axconf_size_t cDstVars;
+	axconf_size_t i;
+	int bReport;
+	int r;
+
+	bReport = ( int )( uFlags & kAxconfSyncF_ReportOnly );
+
+	/* usually the variables are the same names in the same order */
+	for( pVar = pDst->v_head, pSrcVar = pSrc->v_head; pVar != ( axconf_var_t * )0 && pSrcVar != ( axconf_var_t * )0; pVar = pVar->v_next, pSrcVar = pSrcVar->v_next ) {
+		if( !axconf__name_eq( &pVar->Name, pSrcVar->Name.s, ( axconf_size_t )pSrcVar->Name.n ) ) {
+			break;
+		}
+	}
+	if( !pVar && !pSrcVar ) {
+		for( pVar = pDst->v_head, pSrcVar = pSrc->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next, pSrcVar = pSrcVar->v_next ) {
+			if( axconf__var_eq( pVar, pSrcVar ) ) {
+				continue;
+			}
+
+			if( !bReport && !axconf__var_assign( pVar, pSrcVar ) ) {
+				return 0;
+			}
+			if( pfnChange != ( axconf_fn_change_t )0 ) {
+				pfnChange( pUserData, kAxconfChange_Modified, pVar );
+			}
+		}
+
+		return 1;
+	}
+
+	cDstVars = 0;
+	for( pVar = pDst->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+		++cDstVars;
+	}
+
+	if( !axconf__match_init( &m, cDstVars ) ) {
+		return 0;
+	}
+
+	i = 0;
+	for( pVar = pDst->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+		m.ppNodes[ i ] = ( void * )pVar;
+		m.ppNames[ i ] = &pVar->Name;
+		++i;
+	}
+	axconf__match_build( &m );
+
+	r = 1;
+	for( pSrcVar = pSrc->v_head; pSrcVar != ( axconf_var_t * )0; pSrcVar = pSrcVar->v_next ) {
+		i = axconf__match_take( &m, &pSrcVar->Name );
+		if( i == ~( axconf_size_t )0 ) {
+			if( bReport ) {
+				pVar = ( axconf_var_t * )pSrcVar;
+			} else if( !( pVar = axconf__sect_copy_var( pDst, pSrcVar ) ) ) {
+				r = 0;
+				break;
+			}
+
+			if( pfnChange != ( axconf_fn_change_t )0 ) {
+				pfnChange( pUserData, kAxconfChange_Added, pVar );
+			}
+			continue;
+		}
+
+		pVar = ( axconf_var_t * )m.ppNodes[ i ];
+		if( !bReport ) {
+			/* move to the end so the variables end up in the new order */
+			if( pVar != pDst->v_tail ) {
+				if( pVar->v_prev != ( axconf_var_t * )0 ) {
+					pVar->v_prev->v_next = pVar->v_next;
+				} else {
+					pDst->v_head = pVar->v_next;
+				}
+				pVar->v_next->v_prev = pVar->v_prev;
+
+				pVar->v_prev = pDst->v_tail;
+				pVar->v_next = ( axconf_var_t * )0;
+				pDst->v_tail->v_next = pVar;
+				pDst->v_tail = pVar;
+			}
+		}
+
+		if( axconf__var_eq( pVar, pSrcVar ) ) {
+			continue;
+		}
+
+		if( !bReport && !axconf__var_assign( pVar, pSrcVar ) ) {
+			r = 0;
+			break;
+		}
+		if( pfnChange != ( axconf_fn_change_t )0 ) {
+			pfnChange( pUserData, kAxconfChange_Modified, pVar );
+		}
+	}
+
+	/* anything not taken is gone from the new tree */
+	for( i = 0; r && i < m.cNodes; ++i ) {
+		if( m.pTaken[ i ] ) {
+			continue;
+		}
 
-	if( !axconf__ctx_addcfg( pCtx, pCfg ) ) {
-		return ( axconf_context_t * )0;
+		pVar = ( axconf_var_t * )m.ppNodes[ i ];
+		if( pfnChange != ( axconf_fn_change_t )0 ) {
+			pfnChange( pUserData, kAxconfChange_Removed, pVar );
+		}
+		if( !bReport ) {
+			axconf_var_free( pVar );
+		}
 	}
 
-	return pCtx;
+	axconf__match_fini( &m );
+	return r;
 }
-#else
-;
 #endif
-AXCONF_FUNC axconf_context_t *AXCONF_CALL axconf_ctx_fini( axconf_context_t *pCtx )
+
+/*! Update one tree to match another, reporting each variable that differs
+
+	`pDst` is typically the tree currently in use and `pSrc` one freshly loaded
+	from the new version of the configuration. Sections are paired by name (the
+	n-th section of a name with the n-th of the same name) and a section whose
+	content hash is unchanged is skipped without looking at its variables. The
+	hashes of `pDst` are cached between calls. Only the sections, variables,
+	and values that differ are changed; everything else (including pointers
+	held to unchanged variables) stays as it was. Afterward the sections and
+	variables of `pDst` are in the same order as those of `pSrc`.
+
+	`pfnChange` (optional) is called after a variable is added or modified and
+	before a variable is removed. With kAxconfSyncF_ReportOnly, `pDst` is left
+	as it is and the callback receives the variable from whichever tree has it
+	(the new one for added variables).
+
+	Copied names and values are owned by `pDst`, so `pSrc` and its buffer can be
+	discarded afterward. Returns 0 if memory ran out part way through, leaving
+	`pDst` valid but only partially updated.
+
+	This is *NOT* safe while other threads read `pDst`. To reload under
+	concurrent readers, load the new tree separately and hand it out with
+	axconf_live_publish instead, using kAxconfSyncF_ReportOnly to notify.
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_ctx_sync( axconf_context_t *pDst, const axconf_context_t *pSrc, unsigned uFlags, axconf_fn_change_t pfnChange, void *pUserData )
 #if AXCONF_IMPLEMENT
 {
+	const axconf_section_t *pSrcSect;
+	axconf_section_t *pSect;
+	axconf_var_t *pVar;
+	const axconf_var_t *pSrcVar;
+	axconf__match_t m;
+	axconf_size_t cDstSects;
 	axconf_size_t i;
+	axconf_u64_t uHash;
+	int bReport;
+	int r;
 
-	/* Remove self from parent */
-	if( pCtx->ctx_prnt != ( axconf_context_t * )0 ) {
-		axconf__ctx_unlink( pCtx );
+	bReport = ( int )( uFlags & kAxconfSyncF_ReportOnly );
+
+	cDstSects = 0;
+	for( pSect = pDst->s_head; pSect != ( axconf_section_t * )0; pSect = pSect->s_next ) {
+		++cDstSects;
 	}
 
-	/* Remove all sub-contexts */
-	while( pCtx->ctx_head != ( axconf_context_t * )0 ) {
-		axconf_ctx_fini( pCtx->ctx_head );
+	if( !axconf__match_init( &m, cDstSects ) ) {
+		return 0;
 	}
 
-	/* Remove self from all configurations still pointing to this */
-	for( i = 0; i < pCtx->cConfigs; ++i ) {
-		if( pCtx->ppConfigs[ i ]->pContext != pCtx ) {
+	i = 0;
+	for( pSect = pDst->s_head; pSect != ( axconf_section_t * )0; pSect = pSect->s_next ) {
+		m.ppNodes[ i ] = ( void * )pSect;
+		m.ppNames[ i ] = &pSect->Name;
+		++i;
+	}
+	axconf__match_build( &m );
+
+	r = 1;
+	for( pSrcSect = pSrc->s_head; pSrcSect != ( axconf_section_t * )0; pSrcSect = pSrcSect->s_next ) {
+		i = axconf__match_take( &m, &pSrcSect->Name );
+
+		if( i == ~( axconf_size_t )0 ) {
+			pSect = ( axconf_section_t * )0;
+			if( !bReport ) {
+				pSect = axconf_ctx_add_section( pDst );
+				if( !pSect || !axconf_sect_set_name_n( pSect, pSrcSect->Name.s, ( axconf_size_t )pSrcSect->Name.n ) ) {
+					axconf_sect_free( pSect );
+					r = 0;
+					break;
+				}
+			}
+
+			for( pSrcVar = pSrcSect->v_head; pSrcVar != ( axconf_var_t * )0; pSrcVar = pSrcVar->v_next ) {
+				if( bReport ) {
+					pVar = ( axconf_var_t * )pSrcVar;
+				} else if( !( pVar = axconf__sect_copy_var( pSect, pSrcVar ) ) ) {
+					r = 0;
+					break;
+				}
+
+				if( pfnChange != ( axconf_fn_change_t )0 ) {
+					pfnChange( pUserData, kAxconfChange_Added, pVar );
+				}
+			}
+			if( !r ) {
+				break;
+			}
+
 			continue;
 		}
 
-		pCtx->ppConfigs[ i ]->pContext = ( axconf_context_t * )0;
+		pSect = ( axconf_section_t * )m.ppNodes[ i ];
+		if( !bReport && pSect != pDst->s_tail ) {
+			/* move to the end so the sections end up in the new order */
+			if( pSect->s_prev != ( axconf_section_t * )0 ) {
+				pSect->s_prev->s_next = pSect->s_next;
+			} else {
+				pDst->s_head = pSect->s_next;
+			}
+			pSect->s_next->s_prev = pSect->s_prev;
+
+			pSect->s_prev = pDst->s_tail;
+			pSect->s_next = ( axconf_section_t * )0;
+			pDst->s_tail->s_next = pSect;
+			pDst->s_tail = pSect;
+		}
+
+		uHash = axconf__sect_content_hash( pSrcSect );
+		if( axconf__sect_cached_hash( pSect ) == uHash ) {
+			continue;
+		}
+
+		if( !axconf__sect_sync( pSect, pSrcSect, uFlags, pfnChange, pUserData ) ) {
+			r = 0;
+			break;
+		}
+
+		if( !bReport ) {
+			pSect->uContentHash = uHash;
+			pSect->uFlags |= kAxconfNodeF_HashValid;
+		}
 	}
 
-	/* Remove all sections */
-	while( pCtx->s_head != ( axconf_section_t * )0 ) {
-		axconf_sect_free( pCtx->s_head );
+	/* sections that weren't taken are gone from the new tree */
+	for( i = 0; r && i < m.cNodes; ++i ) {
+		if( m.pTaken[ i ] ) {
+			continue;
+		}
+
+		pSect = ( axconf_section_t * )m.ppNodes[ i ];
+		if( pfnChange != ( axconf_fn_change_t )0 ) {
+			for( pVar = pSect->v_head; pVar != ( axconf_var_t * )0; pVar = pVar->v_next ) {
+				pfnChange( pUserData, kAxconfChange_Removed, pVar );
+			}
+		}
+		if( !bReport ) {
+			axconf_sect_free( pSect );
+		}
 	}
 
-	return ( axconf_context_t * )0;
+	axconf__match_fini( &m );
+	return r;
 }
 #else
 ;
 #endif
 
-AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_add_section( axconf_context_t *pCtx )
-#if AXCONF_IMPLEMENT
+#if AXCONF_LIVE_ENABLED
+/*! Start publishing a context to concurrent readers */
+AXCONF_FUNC void AXCONF_CALL axconf_live_init( axconf_live_t *pLive, axconf_context_t *pCtx )
+# if AXCONF_IMPLEMENT
 {
-	axconf_section_t *pSect;
-
-	pSect = ( axconf_section_t * )axconf_alloc( sizeof( *pSect ) );
-	if( !pSect ) {
-		return ( axconf_section_t * )0;
-	}
+	unsigned i;
 
-	if( !axconf_sect_init( pSect, pCtx ) ) {
-		axconf_free( ( void * )pSect );
-		return ( axconf_section_t * )0;
+	pLive->pCurrent = pCtx;
+	pLive->uEpoch = 0;
+	for( i = 0; i < AXCONF_LIVE_STRIPES; ++i ) {
+		pLive->Stripes[ i ].cReaders[ 0 ] = 0;
+		pLive->Stripes[ i ].cReaders[ 1 ] = 0;
 	}
-
-	return pSect;
 }
-#else
+# else
 ;
-#endif
-AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_add_section_by_token( axconf_context_t *pCtx, const axconf_token_t *pTok )
-#if AXCONF_IMPLEMENT
+# endif
+
+/*! Begin reading the published context
+
+	The context stays valid (and unchanged) until axconf_live_release is called
+	with the token written to `*puToken`. Hold it only briefly: a publisher
+	waits for every reader of the previous context before returning. Readers
+	must not modify the context. (Use axconf_var_get_name_ref rather than
+	axconf_var_get_name if names are borrowed, as the latter may copy.)
+*/
+AXCONF_FUNC const axconf_context_t *AXCONF_CALL axconf_live_acquire( axconf_live_t *pLive, unsigned *puToken )
+# if AXCONF_IMPLEMENT
 {
-	axconf_section_t *pSect;
+	axth_u32_t uStripe, uEpoch;
 
-	pSect = axconf_ctx_add_section( pCtx );
-	if( !pSect ) {
-		return ( axconf_section_t * )0;
-	}
+	/* threads have distinct stacks, so this spreads them over the stripes */
+	uStripe = ( ( axth_u32_t )( ( axconf_size_t )&uEpoch >> 12 )*0x9E3779B9U ) >> 29;
+	uStripe &= AXCONF_LIVE_STRIPES - 1;
 
-	if( !axconf_sect_set_name_n( pSect, pTok->pLexanS, ( axconf_size_t )( pTok->pLexanE - pTok->pLexanS ) ) ) {
-		return axconf_sect_free( pSect );
+	for(;;) {
+		uEpoch = pLive->uEpoch & 1;
+		( void )AX_ATOMIC_FETCH_ADD_FULL32( &pLive->Stripes[ uStripe ].cReaders[ uEpoch ], 1 );
+		if( ( pLive->uEpoch & 1 ) == uEpoch ) {
+			break;
+		}
+
+		( void )AX_ATOMIC_FETCH_SUB_FULL32( &pLive->Stripes[ uStripe ].cReaders[ uEpoch ], 1 );
 	}
 
-	return pSect;
+	*puToken = ( unsigned )( uStripe*2 + uEpoch );
+	return pLive->pCurrent;
 }
-#else
+# else
 ;
-#endif
-
-AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_first_section( const axconf_context_t *pCtx )
-#if AXCONF_IMPLEMENT
+# endif
+/*! Finish reading the context returned by axconf_live_acquire */
+AXCONF_FUNC void AXCONF_CALL axconf_live_release( axconf_live_t *pLive, unsigned uToken )
+# if AXCONF_IMPLEMENT
 {
-	return ( axconf_section_t * )pCtx->s_head;
+	( void )AX_ATOMIC_FETCH_SUB_FULL32( &pLive->Stripes[ uToken/2 ].cReaders[ uToken%2 ], 1 );
 }
-#else
+# else
 ;
-#endif
-AXCONF_FUNC axconf_section_t *AXCONF_CALL axconf_ctx_last_section( const axconf_context_t *pCtx )
-#if AXCONF_IMPLEMENT
+# endif
+
+/*! Atomically replace the published context
+
+	Readers that acquire after this begins see `pNewCtx`. Once every reader of
+	the previous context has released it, the previous context is returned and
+	belongs to the caller again (to finish, or to sync and publish later).
+	Publishers must be serialized by the caller.
+*/
+AXCONF_FUNC axconf_context_t *AXCONF_CALL axconf_live_publish( axconf_live_t *pLive, axconf_context_t *pNewCtx )
+# if AXCONF_IMPLEMENT
 {
-	return ( axconf_section_t * )pCtx->s_tail;
+	axconf_context_t *pOldCtx;
+	axth_u32_t uEpoch;
+	unsigned i;
+
+	pOldCtx = ( axconf_context_t * )AX_ATOMIC_EXCHANGE_FULLPTR( &pLive->pCurrent, pNewCtx );
+
+	uEpoch = AX_ATOMIC_FETCH_ADD_FULL32( &pLive->uEpoch, 1 ) & 1;
+	/* spin on the atomic macros rather than axth_backoff so that ax_config
+	`  doesn't need ax_thread's implementation at link time */
+	for( i = 0; i < AXCONF_LIVE_STRIPES; ++i ) {
+		while( pLive->Stripes[ i ].cReaders[ uEpoch ] != 0 ) {
+			AX_CPU_PAUSE();
+		}
+	}
+
+	return pOldCtx;
 }
-#else
+# else
 ;
+# endif
 #endif
 
 
@@ -2511,7 +4430,9 @@ static const char *axconf__skip_quoted( const char *s, const char *e, axconf_tok
 				state = 3;
 			}
 
-			if( state != 1 ) {
+			/* the text is only copied once an escape is seen; otherwise the
+			`  token's span is the string */
+			if( state == 2 || ( state == 3 && pmem != ( char * )0 ) ) {
 				if( !axconf__strappend( &pmem, b, s ) ) {
 					/* Out of memory */
 					*bytes_out = ( axconf_size_t )( s - b );
@@ -2555,11 +4476,15 @@ static const char *axconf__skip_quoted( const char *s, const char *e, axconf_tok
 		}
 	}
 
-	if( pmem != ( char * )0 && state == 3 ) {
-		t_out->uFlags |= kAxconfTokF_Processed;
+	if( pmem != ( char * )0 ) {
+		if( state == 3 ) {
+			t_out->uFlags |= kAxconfTokF_Processed;
 
-		t_out->processed.pszEscaped = pmem;
-		t_out->pOwnedMem = ( void * )( ( ( axconf_size_t * )pmem ) - 2 );
+			t_out->processed.pszEscaped = pmem;
+			t_out->pOwnedMem = ( void * )( ( ( axconf_size_t * )pmem ) - 2 );
+		} else {
+			axconf_prc_free( ( void * )( ( ( axconf_size_t * )pmem ) - 2 ) );
+		}
 	}
 
 	return s;
@@ -2605,7 +4530,7 @@ static const char *axconf__skip_digits( const char *s, const char *e, unsigned r
 		++s;
 
 		/* digit separators */
-		if( ( *s == '\'' || *s == '_' ) && ( s + 1 ) < e ) {
+		if( ( s + 1 ) < e && ( *s == '\'' || *s == '_' ) ) {
 			++s;
 		}
 	}
@@ -2659,7 +4584,7 @@ static const char *axconf__skip_number( const char *s, const char *e, axconf_tok
 	}
 
 	isf = 0;
-	if( *q == '.' && q + 1 < e ) {
+	if( q + 1 < e && *q == '.' ) {
 		isf = 1;
 
 		exps = 1;
@@ -2678,7 +4603,7 @@ static const char *axconf__skip_number( const char *s, const char *e, axconf_tok
 		}
 	}
 
-	if( ( *q == 'e' || *q == 'E' || *q == 'p' || *q == 'P' ) && q + 3 < e ) {
+	if( q + 3 < e && ( *q == 'e' || *q == 'E' || *q == 'p' || *q == 'P' ) ) {
 		++q;
 
 		if( !isf ) {
@@ -2760,6 +4685,16 @@ AXCONF_FUNC axconf_token_t *AXCONF_CALL axconf_lex( axconf_t *p )
 	/* GCC thinks this might be used uninitialized; initialize to be safe */
 	cBytes = 0;
 
+	/* check if we have tokens that we've already read (these were lexed before
+	`  any of the checks below could fail, e.g., by axconf_lex_parallel) */
+	if( p->l_curr != p->l_tail ) {
+		t = !p->l_curr ? p->l_head : p->l_curr->l_next;
+		AXCONF_ASSERT( t != ( axconf_token_link_t * )0 &&
+			"Invalid internal lexer state" );
+		p->l_curr = t;
+		return &t->tok;
+	}
+
 	/* fail if the last report generated was fatal */
 	if( p->r_tail != ( axconf_report_t * )0 && p->r_tail->Severity == kAxconfSev_Panic ) {
 		return ( axconf_token_t * )0;
@@ -2770,15 +4705,6 @@ AXCONF_FUNC axconf_token_t *AXCONF_CALL axconf_lex( axconf_t *p )
 		return ( axconf_token_t * )0;
 	}
 
-	/* check if we have tokens that we've already read */
-	if( p->l_curr != p->l_tail ) {
-		t = !p->l_curr ? p->l_head : p->l_curr->l_next;
-		AXCONF_ASSERT( t != ( axconf_token_link_t * )0 &&
-			"Invalid internal lexer state" );
-		p->l_curr = t;
-		return &t->tok;
-	}
-
 	/* continue where we left off at, or start fresh if necessary */
 	b = !p->l_tail ? p->buf_s : p->l_tail->tok.pLexanE;
 	uFlags = b == p->buf_s ? kAxconfTokF_Start | kAxconfTokF_FileStart : 0;
@@ -2830,8 +4756,8 @@ AXCONF_FUNC axconf_token_t *AXCONF_CALL axconf_lex( axconf_t *p )
 
 	t->tok.pOwnedMem = ( void * )0;
 
-	/* check for eof */
-	if( b == p->buf_e ) {
+	/* check for eof (a chunk's last token may have run past where it stops) */
+	if( b == p->buf_e || ( p->lex_e != ( const char * )0 && b >= p->lex_e ) ) {
 		t->tok.type = kAxconfTok_EOF;
 		return &t->tok;
 	}
@@ -2973,6 +4899,359 @@ AXCONF_FUNC axconf_token_t *AXCONF_CALL axconf_unlex( axconf_t *p )
 ;
 #endif
 
+
+#if AXCONF_PARALLEL_ENABLED
+# if AXCONF_IMPLEMENT
+/*! \internal \brief One piece of a buffer being lexed by axconf_lex_parallel */
+typedef struct axconf__chunk_s
+{
+	/* Private lexer state, sharing the buffer and settings of the original */
+	axconf_t                        Cfg;
+	/* Number of line breaks in the chunk */
+	unsigned                        cLines;
+	/* Set if the chunk was lexed to its end without running into the middle
+	`  of a string or comment (so the next chunk starts between tokens) */
+	int                             bCleanEnd;
+} axconf__chunk_t;
+
+static void axconf__chunk_reset( axconf__chunk_t *c, const axconf_t *p, const char *s, const char *e )
+{
+	c->Cfg = *p;
+
+	/* lexing from `s` as though it were the start of the buffer means line
+	`  numbers are relative to it; they're fixed up when spliced */
+	c->Cfg.buf_s = ( char * )s;
+	c->Cfg.uBufFlags = kAxconfBufF_Borrowed;
+
+	/* tokens are lexed with the rest of the buffer in view (e.g., whether a
+	`  number has an exponent depends on what follows it); only the start of
+	`  a token past `e` is cut off */
+	c->Cfg.lex_e = e;
+
+	c->Cfg.l_head = ( axconf_token_link_t * )0;
+	c->Cfg.l_tail = ( axconf_token_link_t * )0;
+	c->Cfg.l_curr = ( axconf_token_link_t * )0;
+	c->Cfg.r_head = ( axconf_report_t * )0;
+	c->Cfg.r_tail = ( axconf_report_t * )0;
+	c->Cfg.r_outOfMemory.Severity = kAxconfSev_Silent;
+	c->Cfg.r_temp_i = 0;
+
+	c->Cfg.cMaxErrors = p->cMaxErrors - p->cErrors;
+	c->Cfg.cErrors = 0;
+	c->Cfg.cWarnings = 0;
+	c->Cfg.pContext = ( axconf_context_t * )0;
+
+	c->cLines = 0;
+	c->bCleanEnd = 0;
+}
+/*! \internal \brief Whether the lexer stopped because it reached the end */
+static int axconf__chunk_done( const axconf__chunk_t *c )
+{
+	return c->Cfg.l_tail != ( axconf_token_link_t * )0 && c->Cfg.l_tail->tok.type == kAxconfTok_EOF;
+}
+/*! \internal \brief Check that the end of a chunk isn't inside a token or comment
+
+	Every chunk but the last ends at the start of a line beginning with '['.
+	Lexing goes on past the end of the chunk until a token starts at or after
+	it, so that token (the end-of-file) starts right at the end unless a token
+	or comment ran across it (e.g., a string spanning lines).
+*/
+static int axconf__chunk_clean_end( const axconf__chunk_t *c )
+{
+	return axconf__chunk_done( c ) && c->Cfg.l_tail->tok.pLexanS == c->Cfg.lex_e;
+}
+static unsigned axconf__count_lines( const char *s, const char *e )
+{
+	unsigned n = 0;
+
+	/* "\r\n" is one line break, as in axconf_get_lineinfo */
+	for( ; s < e; ++s ) {
+		if( *s == '\n' || ( *s == '\r' && ( s + 1 == e || s[1] != '\n' ) ) ) {
+			++n;
+		}
+	}
+
+	return n;
+}
+static void AXJOB_CALL axconf__lex_chunk_f( void *pData )
+{
+	axconf__chunk_t *c;
+	axconf_token_t *t;
+
+	c = ( axconf__chunk_t * )pData;
+
+	do {
+		t = axconf_lex( &c->Cfg );
+	} while( t != ( axconf_token_t * )0 && t->type != kAxconfTok_EOF );
+
+	c->cLines = axconf__count_lines( c->Cfg.buf_s, c->Cfg.lex_e );
+	c->bCleanEnd = axconf__chunk_clean_end( c );
+}
+/*! \internal \brief Find the first line starting with '[' at or after `s` */
+static const char *axconf__find_split( const char *s, const char *e )
+{
+	while( s < e && ( s = ( const char * )axconf_memchr( ( const void * )s, '[', ( axconf_size_t )( e - s ) ) ) != ( const char * )0 ) {
+		if( s[ -1 ] == '\n' || s[ -1 ] == '\r' ) {
+			return s;
+		}
+
+		++s;
+	}
+
+	return ( const char * )0;
+}
+/*! \internal \brief Move the tokens and reports of a chunk to the end of `p`
+
+	Returns 0 if `p` must not lex any further (a fatal report, or too many
+	errors).
+*/
+static int axconf__splice_chunk( axconf_t *p, axconf__chunk_t *c, unsigned cBaseLines )
+{
+	axconf_token_link_t *t;
+	axconf_report_t *r, *rn;
+	const char *pErrTok;
+	int bMore;
+
+	bMore = axconf__chunk_done( c );
+	pErrTok = ( const char * )0;
+
+	for( r = c->Cfg.r_head; r != ( axconf_report_t * )0; r = rn ) {
+		rn = r->pNextReport;
+
+		if( r == &c->Cfg.r_outOfMemory ) {
+			/* the chunk's out-of-memory report lives in the chunk; move it */
+			if( p->r_outOfMemory.Severity == kAxconfSev_Silent ) {
+				p->r_outOfMemory = *r;
+				p->r_outOfMemory.pConfig = p;
+				axconf_memcpy( ( void * )p->r_temp, ( const void * )c->Cfg.r_temp, sizeof( p->r_temp ) );
+				p->r_outOfMemory.Args[ 0 ].s = p->r_temp + ( r->Args[ 0 ].s - c->Cfg.r_temp );
+				p->r_temp_i = c->Cfg.r_temp_i;
+				r = &p->r_outOfMemory;
+			} else {
+				r = ( axconf_report_t * )0;
+			}
+			bMore = 0;
+		} else if( r->MessageId == kAxconfMsg_TooManyErrors || pErrTok != ( const char * )0 ) {
+			/* past the error limit; axconf_lex will report that itself */
+			axconf_free( ( void * )r );
+			r = ( axconf_report_t * )0;
+		} else {
+			r->pConfig = p;
+			if( r->Location.uLine > 0 ) {
+				r->Location.uLine += cBaseLines;
+			}
+
+			if( r->Severity == kAxconfSev_Warning ) {
+				++p->cWarnings;
+			}
+			/* the report that reaches the limit came from the last token
+			`  that would have been lexed */
+			if( r->Severity <= kAxconfSev_Error && ++p->cErrors == p->cMaxErrors ) {
+				pErrTok = c->Cfg.l_tail != ( axconf_token_link_t * )0 ? c->Cfg.l_tail->tok.pLexanS : c->Cfg.buf_s;
+				if( r->Location.uLine > 0 ) {
+					pErrTok = r->Location.LineRef.s + ( r->Location.uColumn - 1 );
+				}
+				bMore = 0;
+			}
+		}
+
+		if( !r ) {
+			continue;
+		}
+
+		r->pNextReport = ( axconf_report_t * )0;
+		r->pPrevReport = p->r_tail;
+		if( r->pPrevReport != ( axconf_report_t * )0 ) {
+			r->pPrevReport->pNextReport = r;
+		} else {
+			p->r_head = r;
+		}
+		p->r_tail = r;
+	}
+
+	c->Cfg.r_head = ( axconf_report_t * )0;
+	c->Cfg.r_tail = ( axconf_report_t * )0;
+
+	if( pErrTok != ( const char * )0 ) {
+		for( t = c->Cfg.l_head; t != ( axconf_token_link_t * )0 && t->tok.pLexanS <= pErrTok; t = t->l_next ) {
+		}
+		if( t != ( axconf_token_link_t * )0 ) {
+			c->Cfg.l_tail = t->l_prev;
+			if( t->l_prev != ( axconf_token_link_t * )0 ) {
+				t->l_prev->l_next = ( axconf_token_link_t * )0;
+			} else {
+				c->Cfg.l_head = ( axconf_token_link_t * )0;
+			}
+			axconf__free_tokens( t );
+		}
+	}
+
+	/* the previous chunk's end-of-file is where this chunk starts */
+	if( p->l_tail != ( axconf_token_link_t * )0 && p->l_tail->tok.type == kAxconfTok_EOF ) {
+		t = p->l_tail;
+		p->l_tail = t->l_prev;
+		if( p->l_tail != ( axconf_token_link_t * )0 ) {
+			p->l_tail->l_next = ( axconf_token_link_t * )0;
+		} else {
+			p->l_head = ( axconf_token_link_t * )0;
+		}
+		axconf__free_tokens( t );
+
+		if( c->Cfg.l_head != ( axconf_token_link_t * )0 ) {
+			c->Cfg.l_head->tok.uFlags &= ~kAxconfTokF_FileStart;
+		}
+	}
+
+	if( c->Cfg.l_head != ( axconf_token_link_t * )0 ) {
+		c->Cfg.l_head->l_prev = p->l_tail;
+		if( p->l_tail != ( axconf_token_link_t * )0 ) {
+			p->l_tail->l_next = c->Cfg.l_head;
+		} else {
+			p->l_head = c->Cfg.l_head;
+		}
+		p->l_tail = c->Cfg.l_tail;
+	}
+
+	c->Cfg.l_head = ( axconf_token_link_t * )0;
+	c->Cfg.l_tail = ( axconf_token_link_t * )0;
+
+	return bMore;
+}
+# endif
+
+/*! Lex the whole buffer, splitting it between jobs
+
+	The buffer is divided into chunks at lines starting with '[' (up to
+	`cMaxChunks` of them, or four per worker if 0, and no smaller than
+	AXCONF_PARALLEL_MIN_CHUNK bytes) that are lexed in parallel. The tokens and
+	reports of each chunk are then spliced together in order, with their line
+	numbers adjusted, so the result is what lexing the buffer in one go would
+	have produced: the tokens are read back in order with axconf_lex, and the
+	reports are the same and in the same order. A split that turns out to fall
+	inside a multi-line string or comment is detected and the chunks on either
+	side of it are lexed again as one.
+
+	This must be called before any tokens have been lexed, from one of the job
+	system's workers (such as the thread that called axjob_init). Returns 1 if
+	the whole buffer was lexed, or 0 if lexing stopped early because of errors
+	(in which case the reports say why).
+*/
+AXCONF_FUNC int AXCONF_CALL axconf_lex_parallel( axconf_t *p, axjob_system_t *pJobs, unsigned cMaxChunks )
+# if AXCONF_IMPLEMENT
+{
+	axconf__chunk_t *pChunks;
+	axjob_desc_t *pDescs;
+	axjob_counter_t Counter;
+	axconf_size_t cBufBytes;
+	axconf_token_t *t;
+	const char *s, *e;
+	unsigned cChunks, cBaseLines;
+	unsigned i, j;
+	int bMore;
+
+	AXCONF_ASSERT( p->buf_s != ( char * )0 && "No buffer set for lexer" );
+	AXCONF_ASSERT( p->l_head == ( axconf_token_link_t * )0 && "Tokens were already lexed" );
+
+	cBufBytes = ( axconf_size_t )( p->buf_e - p->buf_s );
+
+	if( !cMaxChunks ) {
+		cMaxChunks = ( unsigned )axjob_count_workers( pJobs )*4;
+	}
+	cChunks = ( unsigned )( cBufBytes/AXCONF_PARALLEL_MIN_CHUNK );
+	if( cChunks > cMaxChunks ) {
+		cChunks = cMaxChunks;
+	}
+
+	pChunks = ( axconf__chunk_t * )0;
+	pDescs = ( axjob_desc_t * )0;
+	if( cChunks > 1 && p->l_head == ( axconf_token_link_t * )0 ) {
+		pChunks = ( axconf__chunk_t * )axconf_alloc( cChunks*( sizeof( *pChunks ) + sizeof( *pDescs ) ) );
+		pDescs = ( axjob_desc_t * )( pChunks + cChunks );
+	}
+
+	/* too small to be worth splitting (or no memory to do so) */
+	if( !pChunks ) {
+		do {
+			t = axconf_lex( p );
+		} while( t != ( axconf_token_t * )0 && t->type != kAxconfTok_EOF );
+
+		p->l_curr = ( axconf_token_link_t * )0;
+		return t != ( axconf_token_t * )0;
+	}
+
+	/* pick the chunks */
+	s = p->buf_s;
+	j = 0;
+	for( i = 1; i <= cChunks; ++i ) {
+		e = p->buf_e;
+		if( i < cChunks ) {
+			e = p->buf_s + cBufBytes/cChunks*i;
+			e = axconf__find_split( e > s ? e : s + 1, p->buf_e );
+			if( !e ) {
+				e = p->buf_e;
+				i = cChunks;
+			}
+		}
+
+		axconf__chunk_reset( &pChunks[ j ], p, s, e );
+		pDescs[ j ].pfnJob = &axconf__lex_chunk_f;
+		pDescs[ j ].pData = ( void * )&pChunks[ j ];
+		++j;
+
+		s = e;
+	}
+	cChunks = j;
+
+	axjob_counter_init( &Counter, 0 );
+	axjob_run( pJobs, pDescs, ( axth_u32_t )cChunks, &Counter );
+	axjob_wait( pJobs, &Counter, 0 );
+
+	/* splice them in order */
+	bMore = 1;
+	cBaseLines = 0;
+	for( i = 0; i < cChunks && bMore; i = j ) {
+		/* if the next chunk started in a string or comment, redo both as one */
+		for( j = i + 1; j < cChunks && !pChunks[ i ].bCleanEnd && axconf__chunk_done( &pChunks[ i ] ); ++j ) {
+			axconf__free_lexed( &pChunks[ i ].Cfg );
+			axconf__free_lexed( &pChunks[ j ].Cfg );
+
+			axconf__chunk_reset( &pChunks[ i ], p, pChunks[ i ].Cfg.buf_s, pChunks[ j ].Cfg.lex_e );
+			axconf__lex_chunk_f( ( void * )&pChunks[ i ] );
+		}
+
+		bMore = axconf__splice_chunk( p, &pChunks[ i ], cBaseLines );
+		cBaseLines += pChunks[ i ].cLines;
+	}
+
+	/* drop anything past where lexing stopped */
+	for( ; i < cChunks; ++i ) {
+		axconf__free_lexed( &pChunks[ i ].Cfg );
+	}
+	axconf_free( ( void * )pChunks );
+
+	p->l_curr = ( axconf_token_link_t * )0;
+	return p->l_tail != ( axconf_token_link_t * )0 && p->l_tail->tok.type == kAxconfTok_EOF;
+}
+# else
+;
+# endif
+#endif
+
 AXCONF_LEAVE_C
 
+#if AXCONF_CXX_ENABLED && defined( INCGUARD_AX_STRING_H_ ) && AXSTR_CXX_CLASSES_ENABLED
+inline axconf_section_t *AXCONF_CALL axconf_ctx_find_section( const axconf_context_t *pCtx, const ax::Str &Name )
+{
+	return axconf_ctx_find_section_n( pCtx, Name.get(), ( axconf_size_t )( Name.getEnd() - Name.get() ) );
+}
+inline axconf_var_t *AXCONF_CALL axconf_sect_find_var( const axconf_section_t *pSect, const ax::Str &Name )
+{
+	return axconf_sect_find_var_n( pSect, Name.get(), ( axconf_size_t )( Name.getEnd() - Name.get() ) );
+}
+inline axconf_var_t *AXCONF_CALL axconf_ctx_find( const axconf_context_t *pCtx, const ax::Str &Path )
+{
+	return axconf_ctx_find_n( pCtx, Path.get(), ( axconf_size_t )( Path.getEnd() - Path.get() ) );
+}
+#endif
+
 #endif
@@ -24,6 +24,27 @@ typedef ax_uptr_t          axdict_size_t;
 # define axdict_free(P_)   free(P_)
 #endif
 
+#ifndef AXDICT_SIMD_ENABLED
+# define AXDICT_SIMD_ENABLED       AX_INTRINSICS_ENABLED
+#endif
+
+#define AXDICT__SIMD_SSE2          0
+#define AXDICT__SIMD_NEON          0
+#if AXDICT_SIMD_ENABLED
+# if AX_INTRIN_SSE && ( defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) )
+#  undef  AXDICT__SIMD_SSE2
+#  define AXDICT__SIMD_SSE2        1
+#  include <emmintrin.h>
+# elif AX_INTRIN_NEON && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+#  undef  AXDICT__SIMD_NEON
+#  define AXDICT__SIMD_NEON        1
+#  include <arm_neon.h>
+# endif
+# if defined( _MSC_VER )
+#  include <intrin.h>
+# endif
+#endif
+
 namespace ax
 {
 
@@ -152,6 +173,165 @@ namespace ax
 			return pLookupBuf;
 		}
 
+		// Index of `ch` within the first `cKeys` (at most 16) of the sorted keys, or 0xFF
+		inline U8 findSmallKey( const U8( &aKeys )[ 16 ], U8 cKeys, U8 ch )
+		{
+#if AXDICT__SIMD_SSE2
+			const __m128i eq = _mm_cmpeq_epi8( _mm_loadu_si128( ( const __m128i * )&aKeys[0] ), _mm_set1_epi8( ( char )ch ) );
+			const unsigned m = unsigned( _mm_movemask_epi8( eq ) ) & ( ( 1U << cKeys ) - 1 );
+			if( !m ) {
+				return 0xFF;
+			}
+# if defined( _MSC_VER )
+			unsigned long i;
+			_BitScanForward( &i, m );
+			return U8( i );
+# else
+			return U8( __builtin_ctz( m ) );
+# endif
+#elif AXDICT__SIMD_NEON
+			// narrow each 0x00/0xFF lane to a nibble so the mask fits in 64 bits
+			const uint8x16_t eq = vceqq_u8( vld1q_u8( &aKeys[0] ), vdupq_n_u8( ch ) );
+			U64 m = vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( eq ), 4 ) ), 0 );
+			if( cKeys < 16 ) {
+				m &= ( U64( 1 ) << ( cKeys*4 ) ) - 1;
+			}
+			if( !m ) {
+				return 0xFF;
+			}
+# if defined( _MSC_VER )
+			unsigned long i;
+			_BitScanForward64( &i, m );
+			return U8( i/4 );
+# else
+			return U8( __builtin_ctzll( m )/4 );
+# endif
+#else
+			for( U8 i = 0; i < cKeys && aKeys[ i ] <= ch; ++i ) {
+				if( aKeys[ i ] == ch ) {
+					return i;
+				}
+			}
+
+			return 0xFF;
+#endif
+		}
+
+		// Size-classed free lists carved from large blocks of the allocator
+		//
+		// Everything is released at once by purge(). Requests too large for a
+		// size class get a block of their own, which also lasts until purge().
+		template< typename TAlloc >
+		class TDictionaryPool
+		{
+		public:
+			typedef typename TAlloc::AllocSizeType AllocSizeType;
+
+			static const UPtr kGranularity = 8;
+			static const UPtr kNumClasses  = 64;
+			static const UPtr kBlockBytes  = 65536;
+
+			inline TDictionaryPool()
+			: m_pBlocks( nullptr )
+			, m_pCurr( nullptr )
+			, m_pEnd( nullptr )
+			, m_cBlockBytes( 0 )
+			{
+				memset( ( void * )&m_apFree[0], 0, sizeof( m_apFree ) );
+			}
+
+			inline Void *alloc( TAlloc &a, UPtr cBytes )
+			{
+				cBytes = ( cBytes + kGranularity - 1 ) & ~( kGranularity - 1 );
+
+				const UPtr uClass = cBytes/kGranularity - 1;
+				if( uClass >= kNumClasses ) {
+					SBlock *const pBlock = newBlock( a, cBytes );
+					return pBlock != nullptr ? reinterpret_cast< Void * >( pBlock + 1 ) : nullptr;
+				}
+
+				if( m_apFree[ uClass ] != nullptr ) {
+					Void *const p = m_apFree[ uClass ];
+					m_apFree[ uClass ] = *reinterpret_cast< Void ** >( p );
+					return p;
+				}
+
+				if( UPtr( m_pEnd - m_pCurr ) < cBytes ) {
+					SBlock *const pBlock = newBlock( a, kBlockBytes - sizeof( SBlock ) );
+					if( !pBlock ) {
+						return nullptr;
+					}
+
+					m_pCurr = reinterpret_cast< U8 * >( pBlock + 1 );
+					m_pEnd = m_pCurr + pBlock->cBytes;
+				}
+
+				Void *const p = reinterpret_cast< Void * >( m_pCurr );
+				m_pCurr += cBytes;
+				return p;
+			}
+			inline Void dealloc( Void *p, UPtr cBytes )
+			{
+				cBytes = ( cBytes + kGranularity - 1 ) & ~( kGranularity - 1 );
+
+				const UPtr uClass = cBytes/kGranularity - 1;
+				if( !p || uClass >= kNumClasses ) {
+					return;
+				}
+
+				*reinterpret_cast< Void ** >( p ) = m_apFree[ uClass ];
+				m_apFree[ uClass ] = p;
+			}
+			inline Void purge( TAlloc &a )
+			{
+				while( m_pBlocks != nullptr ) {
+					SBlock *const pBlock = m_pBlocks;
+					m_pBlocks = pBlock->pNext;
+
+					a.deallocate( reinterpret_cast< Void * >( pBlock ), AllocSizeType( sizeof( SBlock ) + pBlock->cBytes ) );
+				}
+
+				memset( ( void * )&m_apFree[0], 0, sizeof( m_apFree ) );
+				m_pCurr = nullptr;
+				m_pEnd = nullptr;
+				m_cBlockBytes = 0;
+			}
+
+			// Number of bytes currently held from the allocator
+			inline UPtr memoryUsage() const
+			{
+				return m_cBlockBytes;
+			}
+
+		private:
+			struct SBlock
+			{
+				SBlock * pNext;
+				UPtr     cBytes;
+			};
+
+			Void *  m_apFree[ kNumClasses ];
+			SBlock *m_pBlocks;
+			U8 *    m_pCurr;
+			U8 *    m_pEnd;
+			UPtr    m_cBlockBytes;
+
+			inline SBlock *newBlock( TAlloc &a, UPtr cBytes )
+			{
+				SBlock *const pBlock = reinterpret_cast< SBlock * >( a.allocate( AllocSizeType( sizeof( SBlock ) + cBytes ) ) );
+				if( !AX_VERIFY_MEMORY( pBlock ) ) {
+					return nullptr;
+				}
+
+				pBlock->pNext = m_pBlocks;
+				pBlock->cBytes = cBytes;
+				m_pBlocks = pBlock;
+				m_cBlockBytes += sizeof( SBlock ) + cBytes;
+
+				return pBlock;
+			}
+		};
+
 	}
 
 	template< typename TElement, typename TPointer = TElement *, typename TAlloc = policy::DictionaryAllocator< TElement > >
@@ -353,6 +533,444 @@ namespace ax
 		AX_DELETE_COPYFUNCS( TDictionary );
 	};
 
+	// Same interface as TDictionary, but with a compact radix-tree layout
+	//
+	// Each node holds the run of key characters leading to it (so chains of
+	// single children collapse into one node), its entry, and its children:
+	// up to 16 in a small sorted table searched with SIMD, or a dense array
+	// indexed by character once it fans out further. Nodes come from a pool
+	// that is released as a whole by purge()/fini().
+	//
+	// Entries never move, so the pointers returned by find()/lookup() remain
+	// valid until purge()/fini(), as with TDictionary. Unlike TDictionary,
+	// find() of a key that is only a prefix of looked up keys may return null
+	// rather than an entry with no data.
+	template< typename TElement, typename TPointer = TElement *, typename TAlloc = policy::DictionaryAllocator< TElement > >
+	class TCompactDictionary: private TAlloc
+	{
+	public:
+		typedef TCompactDictionary< TElement, TPointer, TAlloc > ThisType;
+		typedef TAlloc                                           Allocator;
+		typedef typename Allocator::AllocSizeType                AllocSizeType;
+		typedef TElement                                         ElementType;
+		typedef TPointer                                         PointerType;
+
+		struct SEntry
+		{
+			TPointer pData;
+		};
+
+		inline TCompactDictionary()
+		: m_cEntries( 0 )
+		{
+			resetNode( m_Root, 0 );
+		}
+		inline ~TCompactDictionary()
+		{
+			fini();
+		}
+
+		inline Bool isInitialized() const
+		{
+			return m_cEntries > 0;
+		}
+		inline Bool init( const char *pszAllowed, ECase::Type casing = ECase::Sensitive )
+		{
+			AX_ASSERT( m_cEntries == 0 );
+			AX_ASSERT_NOT_NULL( pszAllowed );
+
+			m_cEntries = detail::generateConvmap( m_convmap, pszAllowed, casing );
+			AX_ASSERT_MSG( m_cEntries > 0, "Invalid characters in `pszAllowed`" );
+
+			resetNode( m_Root, 0 );
+			return m_cEntries > 0;
+		}
+		inline Void fini()
+		{
+			if( !isInitialized() ) {
+				return;
+			}
+
+			purge();
+			m_cEntries = 0;
+		}
+		inline Void purge()
+		{
+			AX_ASSERT( isInitialized() );
+
+			m_Pool.purge( *this );
+			resetNode( m_Root, 0 );
+		}
+
+		inline SEntry *find( const Str &key ) const
+		{
+			AX_ASSERT( isInitialized() );
+
+			return const_cast< ThisType * >( this )->findFromNode( const_cast< SNode * >( &m_Root ), key, EFindOption::ExistingOnly );
+		}
+		inline SEntry *lookup( const Str &key )
+		{
+			AX_ASSERT( isInitialized() );
+
+			return findFromNode( &m_Root, key, EFindOption::CreateIfNotExist );
+		}
+
+		inline SEntry *findFrom( const Str &key, SEntry &entry ) const
+		{
+			AX_ASSERT( isInitialized() );
+
+			SNode *const pNode = reinterpret_cast< SNode * >( &entry );
+			if( !pNode->pChildren ) {
+				return nullptr;
+			}
+
+			return const_cast< ThisType * >( this )->findFromNode( pNode, key, EFindOption::ExistingOnly );
+		}
+		inline SEntry *lookupFrom( const Str &key, SEntry &entry )
+		{
+			AX_ASSERT( isInitialized() );
+
+			return findFromNode( reinterpret_cast< SNode * >( &entry ), key, EFindOption::CreateIfNotExist );
+		}
+
+		inline Bool isValidChar( char ch ) const
+		{
+			return m_convmap[ U8( ch ) ] != 0xFF;
+		}
+
+		// Number of bytes currently held from the allocator
+		inline UPtr memoryUsage() const
+		{
+			return m_Pool.memoryUsage();
+		}
+
+	private:
+		static const U8 kMaxSmall = 16;
+		static const U8 kDenseCap = 0xFF;
+
+		struct SNode
+		{
+			// Must be first: an entry's address is its node's
+			SEntry Entry;
+			// SSmallChildren, or SNode *[ m_cEntries ] if cChildCap is kDenseCap
+			Void * pChildren;
+			U8     cChildren;
+			U8     cChildCap;
+			// Characters (as convmap indices) from the parent to this node
+			U8     cLabel;
+			U8     cLabelCap;
+			U8     aLabel[ 4 ];
+		};
+		struct SSmallChildren
+		{
+			// Sorted; always 16 bytes so it can be searched as one vector
+			U8      aKeys[ kMaxSmall ];
+			SNode * apChildren[ kMaxSmall ];
+		};
+
+		// Walks a key as a sequence of convmap indices
+		class CKeyCursor
+		{
+		public:
+			inline CKeyCursor( const Str &key, const U8( &convmap )[ 256 ] )
+			: m_pCurr( &m_aBuf[0] )
+			, m_pEnd( &m_aBuf[0] )
+			, m_rest( key )
+			, m_convmap( convmap )
+			, m_bInvalid( false )
+			{
+			}
+
+			inline Bool isInvalid() const
+			{
+				return m_bInvalid;
+			}
+			inline Bool atEnd()
+			{
+				return m_pCurr == m_pEnd && !refill();
+			}
+			inline U8 peek() const
+			{
+				return *m_pCurr;
+			}
+			inline Void advance()
+			{
+				++m_pCurr;
+			}
+
+		private:
+			U8         m_aBuf[ 128 ];
+			const U8 * m_pCurr;
+			const U8 * m_pEnd;
+			Str        m_rest;
+			const U8( &m_convmap )[ 256 ];
+			Bool       m_bInvalid;
+
+			inline Bool refill()
+			{
+				if( m_bInvalid || m_rest.isEmpty() ) {
+					return false;
+				}
+
+				U8 *const pLookup = detail::readKeyChars( m_aBuf, sizeof( m_aBuf ), m_rest );
+				if( !pLookup ) {
+					m_bInvalid = true;
+					return false;
+				}
+
+				U8 *p = pLookup;
+				while( *p != '\0' ) {
+					const U8 i = m_convmap[ *p ];
+					if( i == 0xFF ) {
+						// Invalid sequence
+						m_bInvalid = true;
+						return false;
+					}
+
+					*p++ = i;
+				}
+
+				m_pCurr = pLookup;
+				m_pEnd = p;
+				return m_pCurr != m_pEnd;
+			}
+		};
+
+		SNode                                m_Root;
+		detail::TDictionaryPool< Allocator > m_Pool;
+
+		U8                                   m_convmap[ 256 ];
+		U8                                   m_cEntries;
+
+		static inline UPtr nodeBytes( U8 cLabelCap )
+		{
+			const UPtr cBytes = offsetof( SNode, aLabel ) + cLabelCap;
+			return cBytes > sizeof( SNode ) ? cBytes : sizeof( SNode );
+		}
+		static inline UPtr smallBytes( U8 cCap )
+		{
+			return offsetof( SSmallChildren, apChildren ) + sizeof( SNode * )*cCap;
+		}
+		static inline Void resetNode( SNode &node, U8 cLabelCap )
+		{
+			memset( ( void * )&node, 0, offsetof( SNode, aLabel ) );
+			node.Entry.pData = nullptr;
+			node.cLabelCap = cLabelCap;
+		}
+
+		inline SNode *allocNode( const U8 *pLabel, U8 cLabel )
+		{
+			// round the label up to fill the allocation's size class
+			UPtr cBytes = nodeBytes( cLabel );
+			cBytes = ( cBytes + detail::TDictionaryPool< Allocator >::kGranularity - 1 ) & ~( detail::TDictionaryPool< Allocator >::kGranularity - 1 );
+
+			SNode *const pNode = reinterpret_cast< SNode * >( m_Pool.alloc( *this, cBytes ) );
+			if( !pNode ) {
+				return nullptr;
+			}
+
+			const UPtr cLabelCap = cBytes - offsetof( SNode, aLabel );
+			resetNode( *pNode, U8( cLabelCap < 0xFF ? cLabelCap : 0xFF ) );
+			memcpy( ( void * )&pNode->aLabel[0], ( const void * )pLabel, cLabel );
+			pNode->cLabel = cLabel;
+
+			return pNode;
+		}
+		inline Void deallocNode( SNode *pNode )
+		{
+			m_Pool.dealloc( reinterpret_cast< Void * >( pNode ), nodeBytes( pNode->cLabelCap ) );
+		}
+
+		inline SNode **findChildSlot( SNode *pNode, U8 ch ) const
+		{
+			if( !pNode->pChildren ) {
+				return nullptr;
+			}
+
+			if( pNode->cChildCap == kDenseCap ) {
+				SNode **const ppSlot = &reinterpret_cast< SNode ** >( pNode->pChildren )[ ch ];
+				return *ppSlot != nullptr ? ppSlot : nullptr;
+			}
+
+			SSmallChildren *const pSmall = reinterpret_cast< SSmallChildren * >( pNode->pChildren );
+			const U8 i = detail::findSmallKey( pSmall->aKeys, pNode->cChildren, ch );
+			return i != 0xFF ? &pSmall->apChildren[ i ] : nullptr;
+		}
+		inline Bool addChild( SNode *pNode, U8 ch, SNode *pChild )
+		{
+			if( pNode->cChildCap != kDenseCap && pNode->cChildren == pNode->cChildCap ) {
+				SSmallChildren *const pOld = reinterpret_cast< SSmallChildren * >( pNode->pChildren );
+
+				if( pNode->cChildCap == kMaxSmall ) {
+					// wide fan-out: switch to an array indexed by character
+					const UPtr cBytes = sizeof( SNode * )*m_cEntries;
+					SNode **const ppDense = reinterpret_cast< SNode ** >( m_Pool.alloc( *this, cBytes ) );
+					if( !ppDense ) {
+						return false;
+					}
+
+					memset( ( void * )ppDense, 0, cBytes );
+					for( U8 i = 0; i < pNode->cChildren; ++i ) {
+						ppDense[ pOld->aKeys[ i ] ] = pOld->apChildren[ i ];
+					}
+
+					m_Pool.dealloc( reinterpret_cast< Void * >( pOld ), smallBytes( pNode->cChildCap ) );
+					pNode->pChildren = reinterpret_cast< Void * >( ppDense );
+					pNode->cChildCap = kDenseCap;
+				} else {
+					const U8 cCap = pNode->cChildCap > 0 ? U8( pNode->cChildCap*2 ) : U8( 2 );
+
+					SSmallChildren *const pNew = reinterpret_cast< SSmallChildren * >( m_Pool.alloc( *this, smallBytes( cCap ) ) );
+					if( !pNew ) {
+						return false;
+					}
+
+					memset( ( void * )&pNew->aKeys[0], 0, sizeof( pNew->aKeys ) );
+					if( pOld != nullptr ) {
+						memcpy( ( void * )&pNew->aKeys[0], ( const void * )&pOld->aKeys[0], pNode->cChildren );
+						memcpy( ( void * )&pNew->apChildren[0], ( const void * )&pOld->apChildren[0], sizeof( SNode * )*pNode->cChildren );
+						m_Pool.dealloc( reinterpret_cast< Void * >( pOld ), smallBytes( pNode->cChildCap ) );
+					}
+
+					pNode->pChildren = reinterpret_cast< Void * >( pNew );
+					pNode->cChildCap = cCap;
+				}
+			}
+
+			if( pNode->cChildCap == kDenseCap ) {
+				reinterpret_cast< SNode ** >( pNode->pChildren )[ ch ] = pChild;
+				++pNode->cChildren;
+				return true;
+			}
+
+			SSmallChildren *const pSmall = reinterpret_cast< SSmallChildren * >( pNode->pChildren );
+
+			U8 i = pNode->cChildren;
+			while( i > 0 && pSmall->aKeys[ i - 1 ] > ch ) {
+				pSmall->aKeys[ i ] = pSmall->aKeys[ i - 1 ];
+				pSmall->apChildren[ i ] = pSmall->apChildren[ i - 1 ];
+				--i;
+			}
+
+			pSmall->aKeys[ i ] = ch;
+			pSmall->apChildren[ i ] = pChild;
+			++pNode->cChildren;
+
+			return true;
+		}
+
+		// Split the node in `*ppSlot` after `cPrefix` characters of its label,
+		// returning the new node that ends at that point
+		inline SNode *splitNode( SNode **ppSlot, U8 cPrefix )
+		{
+			SNode *const pNode = *ppSlot;
+
+			SNode *const pMid = allocNode( &pNode->aLabel[0], cPrefix );
+			if( !pMid ) {
+				return nullptr;
+			}
+
+			if( !addChild( pMid, pNode->aLabel[ cPrefix ], pNode ) ) {
+				deallocNode( pMid );
+				return nullptr;
+			}
+
+			pNode->cLabel -= cPrefix;
+			memmove( ( void * )&pNode->aLabel[0], ( const void * )&pNode->aLabel[ cPrefix ], pNode->cLabel );
+
+			*ppSlot = pMid;
+			return pMid;
+		}
+
+		inline SEntry *findFromNode( SNode *pNode, const Str &key, EFindOption::Type Opt )
+		{
+			AX_ASSERT_NOT_NULL( pNode );
+			AX_ASSERT( !key.isEmpty() );
+			AX_ASSERT( m_cEntries > 0 );
+
+			CKeyCursor cursor( key, m_convmap );
+
+			while( !cursor.atEnd() ) {
+				SNode **const ppChild = findChildSlot( pNode, cursor.peek() );
+				if( !ppChild ) {
+					if( Opt != EFindOption::CreateIfNotExist ) {
+						return nullptr;
+					}
+
+					return insertRemainder( pNode, cursor );
+				}
+
+				SNode *pChild = *ppChild;
+
+				U8 i = 0;
+				while( i < pChild->cLabel && !cursor.atEnd() && cursor.peek() == pChild->aLabel[ i ] ) {
+					cursor.advance();
+					++i;
+				}
+
+				if( cursor.isInvalid() ) {
+					return nullptr;
+				}
+
+				if( i < pChild->cLabel ) {
+					if( Opt != EFindOption::CreateIfNotExist ) {
+						return nullptr;
+					}
+
+					pChild = splitNode( ppChild, i );
+					if( !pChild ) {
+						return nullptr;
+					}
+				}
+
+				pNode = pChild;
+			}
+
+			if( cursor.isInvalid() ) {
+				return nullptr;
+			}
+
+			return &pNode->Entry;
+		}
+		inline SEntry *insertRemainder( SNode *pNode, CKeyCursor &cursor )
+		{
+			U8 aLabel[ 0xFF ];
+
+			while( !cursor.atEnd() ) {
+				U8 cLabel = 0;
+				while( cLabel < sizeof( aLabel ) && !cursor.atEnd() ) {
+					aLabel[ cLabel++ ] = cursor.peek();
+					cursor.advance();
+				}
+
+				if( cursor.isInvalid() ) {
+					return nullptr;
+				}
+
+				SNode *const pLeaf = allocNode( aLabel, cLabel );
+				if( !pLeaf ) {
+					return nullptr;
+				}
+
+				if( !addChild( pNode, aLabel[ 0 ], pLeaf ) ) {
+					deallocNode( pLeaf );
+					return nullptr;
+				}
+
+				pNode = pLeaf;
+			}
+
+			if( cursor.isInvalid() ) {
+				return nullptr;
+			}
+
+			return &pNode->Entry;
+		}
+
+		AX_DELETE_COPYFUNCS( TCompactDictionary );
+	};
+
 	typedef TDictionary< Void > CVoidDictionary;
+	typedef TCompactDictionary< Void > CVoidCompactDictionary;
 
 }
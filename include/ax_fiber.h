@@ -7,6 +7,12 @@
 	This library provides fiber support (using the operating system's native
 	capabilities where applicable).
 
+	On UNIX systems fibers are switched with a small assembly routine on x86-64
+	and AArch64, which only saves the registers the calling convention requires
+	to be preserved. Other architectures use ucontext, whose `swapcontext()`
+	makes a `sigprocmask()` system call on every switch. (See
+	AXFIBER_CONTEXT_ASM.)
+
 
 	USAGE
 	=====
@@ -35,6 +41,69 @@
 	systems.
 
 
+	FIBER POOLS
+	===========
+
+	`axfi_init()` allocates a fresh stack for each fiber and nothing stops a
+	fiber from running off the end of it. Programs that create fibers often
+	(such as per task) should use a pool instead:
+
+		axfi_pool_t pool;
+
+		axfi_pool_init( &pool, 64*1024, 0 );
+		axfi_pool_acquire( &pool, &fiber, &routine, pData );
+		...
+		axfi_pool_release( &pool, &fiber );
+		axfi_pool_fini( &pool );
+
+	On UNIX systems each pooled stack is reserved with `axmm_page_reserve()`
+	and has a no-access guard page below it, so an overflow faults immediately
+	instead of corrupting whatever lies beneath. Released stacks are kept and
+	handed out again, so a reused fiber costs a `makecontext()` and nothing
+	else: no allocation, no `getcontext()`, and no page faults. (With the
+	assembly backend there is no `makecontext()` either; the first frame is
+	written directly.) Stacks are
+	touched when they are created so their pages are already resident when the
+	fiber first runs.
+
+	Pass `kAxfiber_Pool_LazyCommit` for large stacks that are rarely used in
+	full. Their pages are left untouched and the OS only backs the pages that
+	the fiber actually reaches. (On Windows the stack is reserved in full and
+	only AXFIBER_POOL_LAZY_COMMIT_SIZE bytes are committed up front.)
+
+	`axfi_pool_get_stats()` reports the number of stacks in use and the
+	deepest any of the pool's stacks has been used (UNIX only), which is a
+	good guide for choosing the stack size.
+
+	A pool is not thread safe. Either give each thread its own or serialize
+	access to it. Pools require ax_memory.h to be included before this header
+	(see AXFIBER_POOL_ENABLED).
+
+
+	CONFIGURATION MACROS
+	====================
+
+	Define any of these prior to including this header, if you want to alter
+	the default functionality.
+
+		AXFIBER_CONTEXT_ASM
+		-------------------
+		Set to 1 to switch fibers with the built-in assembly routines rather
+		than ucontext on UNIX systems. Only x86-64 (System V) and AArch64 are
+		supported, and only with GCC-compatible compilers. Set to 0 to force
+		ucontext. (Default is 1 where supported.)
+
+		AXFIBER_POOL_ENABLED
+		--------------------
+		Set to 1 to provide the `axfi_pool_*` functions. (Default is 1 when
+		ax_memory.h has been included.)
+
+		AXFIBER_POOL_LAZY_COMMIT_SIZE
+		-----------------------------
+		Number of bytes committed up front for a lazily-committed stack on
+		Windows. (Default is 64KB.)
+
+
 	INTERACTIONS
 	============
 
@@ -43,6 +112,9 @@
 
 	This library will use ax_types if it has been included prior to this header.
 
+	Fiber pools use ax_memory's page functions. ax_memory.h will be included
+	automatically on compilers with `__has_include`.
+
 
 	LICENSE
 	=======
@@ -68,6 +140,9 @@
 # if __has_include( "ax_types.h" )
 #  include "ax_types.h"
 # endif
+# if __has_include( "ax_memory.h" )
+#  include "ax_memory.h"
+# endif
 #endif
 
 #ifdef AXFIBER_IMPLEMENTATION
@@ -114,6 +189,17 @@ typedef ax_uptr_t                   axfi_size_t;
 typedef size_t                      axfi_size_t;
 #endif
 
+#ifndef AXFIBER_POOL_ENABLED
+# ifdef INCGUARD_AX_MEMORY_H_
+#  define AXFIBER_POOL_ENABLED      1
+# else
+#  define AXFIBER_POOL_ENABLED      0
+# endif
+#endif
+#ifndef AXFIBER_POOL_LAZY_COMMIT_SIZE
+# define AXFIBER_POOL_LAZY_COMMIT_SIZE 65536
+#endif
+
 #ifndef __cplusplus
 # undef  AXFIBER_CXX_ENABLED
 # define AXFIBER_CXX_ENABLED        0
@@ -161,6 +247,35 @@ typedef size_t                      axfi_size_t;
 # define AXFIBER_IMPL_DEFINED       1
 #endif
 
+#ifndef AXFIBER_ARCH_DEFINED
+# ifdef INCGUARD_AX_PLATFORM_H_
+#  define AXFIBER_ARCH_X86_64       ( AX_ARCH_X86 && AX_ARCH_64BIT )
+#  define AXFIBER_ARCH_AARCH64      ( AX_ARCH_ARM && AX_ARCH_64BIT )
+# else
+#  define AXFIBER_ARCH_X86_64       0
+#  define AXFIBER_ARCH_AARCH64      0
+#  if defined( __amd64__ ) || defined( __x86_64__ ) || defined( _M_AMD64 )
+#   undef AXFIBER_ARCH_X86_64
+#   define AXFIBER_ARCH_X86_64      1
+#  elif defined( __aarch64__ )
+#   undef AXFIBER_ARCH_AARCH64
+#   define AXFIBER_ARCH_AARCH64     1
+#  endif
+# endif
+# define AXFIBER_ARCH_DEFINED       1
+#endif
+
+#ifndef AXFIBER_CONTEXT_ASM
+# if AXFIBER_IMPL_UNIX && defined( __GNUC__ ) && ( AXFIBER_ARCH_X86_64 || AXFIBER_ARCH_AARCH64 )
+#  define AXFIBER_CONTEXT_ASM       1
+# else
+#  define AXFIBER_CONTEXT_ASM       0
+# endif
+#endif
+#if AXFIBER_CONTEXT_ASM && !( AXFIBER_IMPL_UNIX && ( AXFIBER_ARCH_X86_64 || AXFIBER_ARCH_AARCH64 ) )
+# error AXFIBER_CONTEXT_ASM is only supported on UNIX x86-64 and AArch64
+#endif
+
 #if AXFIBER_IMPL_WINDOWS
 # undef WIN32_LEAN_AND_MEAN
 # define WIN32_LEAN_AND_MEAN        1
@@ -174,12 +289,16 @@ typedef size_t                      axfi_size_t;
 # undef Yield
 # undef AddJob
 #elif AXFIBER_IMPL_UNIX
-# if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
-#  define _XOPEN_SOURCE 1
+# if !AXFIBER_CONTEXT_ASM
+#  if defined(__APPLE__) && !defined(_XOPEN_SOURCE)
+#   define _XOPEN_SOURCE 1
+#  endif
+#  include <signal.h>
+#  include <ucontext.h>
 # endif
-# include <signal.h>
-# include <ucontext.h>
 # include <stdlib.h>
+# include <string.h>
+# include <sys/mman.h>
 #endif
 
 #ifndef AXFIBER_OS_CALL
@@ -208,7 +327,12 @@ typedef struct axfiber_s
 #if AXFIBER_IMPL_WINDOWS
 	LPVOID                          pFiber;
 #elif AXFIBER_IMPL_UNIX
+# if AXFIBER_CONTEXT_ASM
+	/* saved stack pointer; the callee-saved registers sit just above it */
+	void *                          pStackPointer;
+# else
 	ucontext_t                      Context;
+# endif
 	void *                          pStack;
 	void *                          pUserData;
 #else
@@ -216,6 +340,54 @@ typedef struct axfiber_s
 #endif
 } axfiber_t;
 
+#if AXFIBER_POOL_ENABLED
+typedef enum axfi_pool_flags_e
+{
+	/* Don't touch stacks up front; let the OS back them one page at a time */
+	kAxfiber_Pool_LazyCommit        = 0x01
+} axfi_pool_flags_t;
+
+typedef struct axfi_pool_stats_s
+{
+	/* Usable bytes in each stack */
+	axfi_size_t                     cStackBytes;
+	/* Deepest use of any stack so far, in bytes (not tracked on Windows) */
+	axfi_size_t                     cHighWaterBytes;
+	/* Stacks currently owned by the pool (in use or idle) */
+	axfi_size_t                     cStacks;
+	/* Stacks currently held by fibers */
+	axfi_size_t                     cInUse;
+	/* Greatest number of stacks held at once */
+	axfi_size_t                     cPeakInUse;
+	/* Total calls to axfi_pool_acquire() that succeeded */
+	axfi_size_t                     cAcquired;
+	/* How many of those were given an idle stack rather than a new one */
+	axfi_size_t                     cReused;
+} axfi_pool_stats_t;
+
+typedef struct axfi_pool_s
+{
+# if AXFIBER_IMPL_UNIX
+	/* Stacks waiting to be handed out again */
+	struct axfi__stack_s *          pIdle;
+	/* Every stack owned by the pool */
+	struct axfi__stack_s *          pAll;
+#  if !AXFIBER_CONTEXT_ASM
+	/* Captured once so acquiring a fiber needn't call getcontext() */
+	ucontext_t                      Template;
+#  endif
+	/* Size of a page, which is also the size of each guard */
+	axfi_size_t                     cPageBytes;
+# endif
+	/* Bytes reserved for each stack (excluding the guard) */
+	axfi_size_t                     cStackBytes;
+	/* Combination of axfi_pool_flags_t */
+	unsigned                        uFlags;
+	/* Counters reported by axfi_pool_get_stats() */
+	axfi_pool_stats_t               Stats;
+} axfi_pool_t;
+#endif
+
 #if AXFIBER_IMPLEMENT
 # if AXFIBER_IMPL_WINDOWS
 typedef struct axfi__tls_s
@@ -282,7 +454,174 @@ static void axfi__tls_drop( void )
 # elif AXFIBER_IMPL_UNIX
 static __thread axfiber_t *         axfi__g_pCurrentFiber = ( axfiber_t * )0;
 
+
+#  if AXFIBER_CONTEXT_ASM
+#   ifdef __APPLE__
+#    define AXFIBER__ASM_FUNC(Name_)\
+	".globl _" Name_ "\n"\
+	".private_extern _" Name_ "\n"\
+	".p2align 4\n"\
+	"_" Name_ ":\n"
+#   else
+#    define AXFIBER__ASM_FUNC(Name_)\
+	".globl " Name_ "\n"\
+	".hidden " Name_ "\n"\
+	".type " Name_ ", %function\n"\
+	".p2align 4\n"\
+	Name_ ":\n"
+#   endif
+
+#   ifdef __cplusplus
+extern "C" {
+#   endif
+/* save callee-saved state on the current stack, store SP in *ppOutStackPointer, then resume pStackPointer */
+__attribute__(( visibility( "hidden" ) )) void axfi__asm_switch( void **ppOutStackPointer, void *pStackPointer );
+/* first "return address" of a new fiber: calls the routine held in the frame's saved registers */
+__attribute__(( visibility( "hidden" ) )) void axfi__asm_entry( void );
+#   ifdef __cplusplus
+}
+#   endif
+
+#   if AXFIBER_ARCH_X86_64
+/*
+	Frame (from the saved stack pointer up):
+		+0  MXCSR (low 32 bits), x87 control word (next 16 bits)
+		+8  r15, r14, r13, r12, rbx, rbp
+		+56 return address
+	New fibers start in axfi__asm_entry with the routine in r12 and its
+	parameter in r13.
+*/
+#    define AXFIBER__FRAME_WORDS    8
+#    define AXFIBER__FRAME_ROUTINE  4
+#    define AXFIBER__FRAME_PARM     3
+#    define AXFIBER__FRAME_RETURN   7
+__asm__(
+	".text\n"
+	AXFIBER__ASM_FUNC( "axfi__asm_switch" )
+	"	pushq %rbp\n"
+	"	pushq %rbx\n"
+	"	pushq %r12\n"
+	"	pushq %r13\n"
+	"	pushq %r14\n"
+	"	pushq %r15\n"
+	"	subq $8, %rsp\n"
+	"	stmxcsr (%rsp)\n"
+	"	fnstcw 4(%rsp)\n"
+	"	movq %rsp, (%rdi)\n"
+	"	movq %rsi, %rsp\n"
+	"	ldmxcsr (%rsp)\n"
+	"	fldcw 4(%rsp)\n"
+	"	addq $8, %rsp\n"
+	"	popq %r15\n"
+	"	popq %r14\n"
+	"	popq %r13\n"
+	"	popq %r12\n"
+	"	popq %rbx\n"
+	"	popq %rbp\n"
+	"	ret\n"
+	AXFIBER__ASM_FUNC( "axfi__asm_entry" )
+	"	movq %r13, %rdi\n"
+	"	callq *%r12\n"
+	"	ud2\n"
+);
+#   elif AXFIBER_ARCH_AARCH64
+/*
+	Frame (from the saved stack pointer up):
+		+0   x19 .. x28
+		+80  x29 (frame pointer), x30 (return address)
+		+96  d8 .. d15
+		+160 FPCR, padding
+	New fibers start in axfi__asm_entry with the routine in x19 and its
+	parameter in x20.
+*/
+#    define AXFIBER__FRAME_WORDS    22
+#    define AXFIBER__FRAME_ROUTINE  0
+#    define AXFIBER__FRAME_PARM     1
+#    define AXFIBER__FRAME_RETURN   11
+__asm__(
+	".text\n"
+	AXFIBER__ASM_FUNC( "axfi__asm_switch" )
+	"	sub sp, sp, #176\n"
+	"	stp x19, x20, [sp, #0]\n"
+	"	stp x21, x22, [sp, #16]\n"
+	"	stp x23, x24, [sp, #32]\n"
+	"	stp x25, x26, [sp, #48]\n"
+	"	stp x27, x28, [sp, #64]\n"
+	"	stp x29, x30, [sp, #80]\n"
+	"	stp d8, d9, [sp, #96]\n"
+	"	stp d10, d11, [sp, #112]\n"
+	"	stp d12, d13, [sp, #128]\n"
+	"	stp d14, d15, [sp, #144]\n"
+	"	mrs x9, fpcr\n"
+	"	str x9, [sp, #160]\n"
+	"	mov x9, sp\n"
+	"	str x9, [x0]\n"
+	"	mov sp, x1\n"
+	"	ldr x9, [sp, #160]\n"
+	"	msr fpcr, x9\n"
+	"	ldp d14, d15, [sp, #144]\n"
+	"	ldp d12, d13, [sp, #128]\n"
+	"	ldp d10, d11, [sp, #112]\n"
+	"	ldp d8, d9, [sp, #96]\n"
+	"	ldp x29, x30, [sp, #80]\n"
+	"	ldp x27, x28, [sp, #64]\n"
+	"	ldp x25, x26, [sp, #48]\n"
+	"	ldp x23, x24, [sp, #32]\n"
+	"	ldp x21, x22, [sp, #16]\n"
+	"	ldp x19, x20, [sp, #0]\n"
+	"	add sp, sp, #176\n"
+	"	ret\n"
+	AXFIBER__ASM_FUNC( "axfi__asm_entry" )
+	"	mov x0, x20\n"
+	"	blr x19\n"
+	"	brk #0\n"
+);
+#   endif
+
+/* lay out the first frame of a fiber whose stack is pFiber->pStack (routines must never return) */
+static void axfi__start_context( axfiber_t *pFiber, axfi_size_t cStackBytes, axfi_fn_fiber_t pfnRoutine, void *pUserData )
+{
+	axfi_size_t *pFrame;
+	axfi_size_t i;
+
+	pFrame = ( axfi_size_t * )( ( ( axfi_size_t )pFiber->pStack + cStackBytes ) & ~( axfi_size_t )15 ) - AXFIBER__FRAME_WORDS;
+	for( i = 0; i < AXFIBER__FRAME_WORDS; ++i ) {
+		pFrame[ i ] = 0;
+	}
+
+#   if AXFIBER_ARCH_X86_64
+	/* default MXCSR (all exceptions masked) and x87 control word */
+	pFrame[ 0 ] = ( axfi_size_t )0x1F80 | ( ( axfi_size_t )0x037F << 32 );
+#   endif
+	pFrame[ AXFIBER__FRAME_ROUTINE ] = ( axfi_size_t )pfnRoutine;
+	pFrame[ AXFIBER__FRAME_PARM ] = ( axfi_size_t )pUserData;
+	pFrame[ AXFIBER__FRAME_RETURN ] = ( axfi_size_t )&axfi__asm_entry;
+
+	pFiber->pStackPointer = ( void * )pFrame;
+	pFiber->pUserData = pUserData;
+}
+#  else
 typedef void( *axfi__fn_context_routine_t )();
+
+/* getcontext() returns twice as far as the compiler knows, so keep it out of the callers */
+static int axfi__get_context( ucontext_t *pContext )
+{
+	return getcontext( pContext ) == 0;
+}
+
+/* finish a context captured with axfi__get_context() so it runs pfnRoutine on pFiber->pStack */
+static void axfi__start_context( axfiber_t *pFiber, axfi_size_t cStackBytes, axfi_fn_fiber_t pfnRoutine, void *pUserData )
+{
+	pFiber->Context.uc_link = 0;
+	pFiber->Context.uc_stack.ss_sp = pFiber->pStack;
+	pFiber->Context.uc_stack.ss_size = cStackBytes;
+	pFiber->Context.uc_stack.ss_flags = 0;
+
+	pFiber->pUserData = pUserData;
+
+	makecontext( &pFiber->Context, ( axfi__fn_context_routine_t )pfnRoutine, 1, pUserData );
+}
+#  endif
 # endif
 
 static void axfi__set_current( axfiber_t *pInFiber )
@@ -345,9 +684,14 @@ AXFIBER_FUNC axfiber_t *AXFIBER_CALL axfi_thread_to_fiber( axfiber_t *pDstFiber,
 	pDstFiber->pStack = ( void * )0;
 	pDstFiber->pUserData = pUserData;
 
+#  if AXFIBER_CONTEXT_ASM
+	/* filled in when switching away */
+	pDstFiber->pStackPointer = ( void * )0;
+#  else
 	if( getcontext( &pDstFiber->Context ) != 0 ) {
 		return ( axfiber_t * )0;
 	}
+#  endif
 
 	axfi__set_current( pDstFiber );
 	return pDstFiber;
@@ -392,21 +736,15 @@ AXFIBER_FUNC axfiber_t *AXFIBER_CALL axfi_init( axfiber_t *pDstFiber, axfi_size_
 		return ( axfiber_t * )0;
 	}
 
-	if( getcontext( &pDstFiber->Context ) != 0 ) {
+#  if !AXFIBER_CONTEXT_ASM
+	if( !axfi__get_context( &pDstFiber->Context ) ) {
 		axfi_free( pDstFiber->pStack );
 		pDstFiber->pStack = ( void * )0;
 		return ( axfiber_t * )0;
 	}
+#  endif
 
-	pDstFiber->Context.uc_link = 0;
-	pDstFiber->Context.uc_stack.ss_sp = pDstFiber->pStack;
-	pDstFiber->Context.uc_stack.ss_size = cStackBytes;
-	pDstFiber->Context.uc_stack.ss_flags = 0;
-
-	pDstFiber->pUserData = pUserData;
-
-	makecontext( &pDstFiber->Context, ( axfi__fn_context_routine_t )pfnRoutine, 1, pUserData );
-
+	axfi__start_context( pDstFiber, cStackBytes ? cStackBytes : 1024*1024, pfnRoutine, pUserData );
 	return pDstFiber;
 # else
 #  error Could not determine how to implement axfi_init()
@@ -456,7 +794,11 @@ AXFIBER_FUNC void AXFIBER_CALL axfi_switch( axfiber_t *pFiber )
 	}
 
 	axfi__set_current( pFiber );
+#  if AXFIBER_CONTEXT_ASM
+	axfi__asm_switch( &pCurrent->pStackPointer, pFiber->pStackPointer );
+#  else
 	swapcontext( &pCurrent->Context, &pFiber->Context );
+#  endif
 # else
 #  error Could not determine how to implement axfi_switch()
 # endif
@@ -531,4 +873,379 @@ AXFIBER_FUNC axfiber_t *AXFIBER_CALL axfi_get_current( void )
 }
 #endif
 
+#if AXFIBER_POOL_ENABLED
+# if AXFIBER_IMPLEMENT && AXFIBER_IMPL_UNIX
+/* Kept at the top of each pooled stack; the stack grows down from beneath it */
+typedef struct axfi__stack_s
+{
+	struct axfi__stack_s *          pNextIdle;
+	struct axfi__stack_s *          pNextAll;
+} axfi__stack_t;
+
+#  define AXFIBER__STACK_RECORD_BYTES ( ( sizeof( axfi__stack_t ) + 15 ) & ~( axfi_size_t )15 )
+
+static axfi_size_t axfi__pool_usable_bytes( const axfi_pool_t *pPool )
+{
+	return pPool->cStackBytes - AXFIBER__STACK_RECORD_BYTES;
+}
+static axfi__stack_t *axfi__pool_record( const axfi_pool_t *pPool, void *pStack )
+{
+	return ( axfi__stack_t * )( ( char * )pStack + axfi__pool_usable_bytes( pPool ) );
+}
+static char *axfi__pool_usable_base( const axfi_pool_t *pPool, axfi__stack_t *pRecord )
+{
+	return ( char * )pRecord - axfi__pool_usable_bytes( pPool );
+}
+static char *axfi__pool_reservation( const axfi_pool_t *pPool, axfi__stack_t *pRecord )
+{
+	return axfi__pool_usable_base( pPool, pRecord ) - pPool->cPageBytes;
+}
+
+static axfi__stack_t *axfi__pool_new_stack( axfi_pool_t *pPool )
+{
+	axfi__stack_t *pRecord;
+	axfi_size_t cReserveBytes;
+	axfi_size_t i;
+	char *pBase;
+	char *pStack;
+
+	cReserveBytes = pPool->cPageBytes + pPool->cStackBytes;
+
+	/* the guard is the lowest page, which is reserved but never committed */
+	if( !( pBase = ( char * )axmm_page_reserve( cReserveBytes ) ) ) {
+		return ( axfi__stack_t * )0;
+	}
+
+	pStack = pBase + pPool->cPageBytes;
+	if( !axmm_page_commit( ( void * )pStack, pPool->cStackBytes, axmem_pp_rw ) ) {
+		axmm_page_release( ( void * )pBase, cReserveBytes );
+		return ( axfi__stack_t * )0;
+	}
+
+	/* fault the pages in now rather than on the fiber's first run; zeroes keep the high-water scan valid */
+	if( ~pPool->uFlags & kAxfiber_Pool_LazyCommit ) {
+		for( i = 0; i < pPool->cStackBytes; i += pPool->cPageBytes ) {
+			( ( volatile char * )pStack )[ i ] = 0;
+		}
+	}
+
+	pRecord = axfi__pool_record( pPool, ( void * )pStack );
+	pRecord->pNextIdle = ( axfi__stack_t * )0;
+	pRecord->pNextAll = pPool->pAll;
+	pPool->pAll = pRecord;
+
+	++pPool->Stats.cStacks;
+	return pRecord;
+}
+static void axfi__pool_delete_stack( axfi_pool_t *pPool, axfi__stack_t *pRecord )
+{
+	axmm_page_release( ( void * )axfi__pool_reservation( pPool, pRecord ), pPool->cPageBytes + pPool->cStackBytes );
+	--pPool->Stats.cStacks;
+}
+
+/*
+	Stacks start out zeroed, so the deepest use is the lowest word that isn't
+	zero. Pages that were never made resident haven't been reached, and are
+	skipped without touching them (which would commit lazy stacks).
+*/
+static axfi_size_t axfi__pool_stack_usage( const axfi_pool_t *pPool, axfi__stack_t *pRecord )
+{
+#  if AXFIBER_OS_MACOSX
+	char uResident;
+#  else
+	unsigned char uResident;
+#  endif
+	const axfi_size_t *pWord;
+	const axfi_size_t *pEnd;
+	char *pPage;
+	char *pTop;
+
+	pTop = ( char * )pRecord;
+	for( pPage = axfi__pool_usable_base( pPool, pRecord ); pPage < pTop; pPage += pPool->cPageBytes ) {
+		uResident = 0;
+		if( mincore( ( void * )pPage, pPool->cPageBytes, &uResident ) == 0 && ( ~uResident & 1 ) ) {
+			continue;
+		}
+
+		pEnd = ( const axfi_size_t * )( pPage + pPool->cPageBytes < pTop ? pPage + pPool->cPageBytes : pTop );
+		for( pWord = ( const axfi_size_t * )pPage; pWord < pEnd; ++pWord ) {
+			if( *pWord != 0 ) {
+				return ( axfi_size_t )( pTop - ( const char * )pWord );
+			}
+		}
+	}
+
+	return 0;
+}
+static void axfi__pool_update_high_water( axfi_pool_t *pPool, axfi__stack_t *pRecord )
+{
+	axfi_size_t cUsed;
+
+	cUsed = axfi__pool_stack_usage( pPool, pRecord );
+	if( pPool->Stats.cHighWaterBytes < cUsed ) {
+		pPool->Stats.cHighWaterBytes = cUsed;
+	}
+}
+# endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Prepare a fiber pool whose stacks are each cStackBytes in size
+ *
+ * cStackBytes is rounded up to a whole number of pages. Zero selects 1MB, as
+ * with axfi_init(). uFlags is a combination of axfi_pool_flags_t.
+ *
+ * Returns pPool on success or NULL on failure.
+ */
+AXFIBER_FUNC axfi_pool_t *AXFIBER_CALL axfi_pool_init( axfi_pool_t *pPool, axfi_size_t cStackBytes, unsigned uFlags )
+# if AXFIBER_IMPLEMENT
+{
+	if( !pPool ) {
+		return ( axfi_pool_t * )0;
+	}
+
+	if( !cStackBytes ) {
+		cStackBytes = 1024*1024;
+	}
+
+	memset( ( void * )&pPool->Stats, 0, sizeof( pPool->Stats ) );
+	pPool->uFlags = uFlags;
+
+#  if AXFIBER_IMPL_WINDOWS
+	pPool->cStackBytes = cStackBytes;
+	pPool->Stats.cStackBytes = cStackBytes;
+#  elif AXFIBER_IMPL_UNIX
+	pPool->pIdle = ( axfi__stack_t * )0;
+	pPool->pAll = ( axfi__stack_t * )0;
+
+	pPool->cPageBytes = ( axfi_size_t )axmm_get_page_size();
+	pPool->cStackBytes = ( cStackBytes + pPool->cPageBytes - 1 ) & ~( pPool->cPageBytes - 1 );
+	pPool->Stats.cStackBytes = axfi__pool_usable_bytes( pPool );
+
+#   if !AXFIBER_CONTEXT_ASM
+	if( !axfi__get_context( &pPool->Template ) ) {
+		return ( axfi_pool_t * )0;
+	}
+#   endif
+#  else
+#   error Could not determine how to implement axfi_pool_init()
+#  endif
+
+	return pPool;
+}
+# else
+;
+# endif
+/*
+ * Release every stack owned by a pool
+ *
+ * No fiber may still be using one. Returns NULL.
+ */
+AXFIBER_FUNC axfi_pool_t *AXFIBER_CALL axfi_pool_fini( axfi_pool_t *pPool )
+# if AXFIBER_IMPLEMENT
+{
+#  if AXFIBER_IMPL_UNIX
+	axfi__stack_t *pRecord;
+	axfi__stack_t *pNext;
+#  endif
+
+	if( !pPool ) {
+		return ( axfi_pool_t * )0;
+	}
+
+#  if AXFIBER_IMPL_UNIX
+	for( pRecord = pPool->pAll; pRecord != ( axfi__stack_t * )0; pRecord = pNext ) {
+		pNext = pRecord->pNextAll;
+		axfi__pool_delete_stack( pPool, pRecord );
+	}
+
+	pPool->pIdle = ( axfi__stack_t * )0;
+	pPool->pAll = ( axfi__stack_t * )0;
+#  endif
+
+	return ( axfi_pool_t * )0;
+}
+# else
+;
+# endif
+/*
+ * Release the stacks a pool is holding on to for reuse
+ *
+ * Stacks still held by fibers are unaffected. Returns the number of stacks
+ * released.
+ */
+AXFIBER_FUNC axfi_size_t AXFIBER_CALL axfi_pool_trim( axfi_pool_t *pPool )
+# if AXFIBER_IMPLEMENT
+{
+#  if AXFIBER_IMPL_UNIX
+	axfi__stack_t **ppLink;
+	axfi__stack_t *pRecord;
+	axfi__stack_t *pIdle;
+	axfi_size_t cReleased;
+
+	if( !pPool || !pPool->pIdle ) {
+		return 0;
+	}
+
+	/* mark the idle stacks so they can be picked out of the list of all stacks */
+	for( pIdle = pPool->pIdle; pIdle != ( axfi__stack_t * )0; pIdle = pRecord ) {
+		pRecord = pIdle->pNextIdle;
+		pIdle->pNextIdle = pIdle;
+	}
+	pPool->pIdle = ( axfi__stack_t * )0;
+
+	cReleased = 0;
+	ppLink = &pPool->pAll;
+	while( ( pRecord = *ppLink ) != ( axfi__stack_t * )0 ) {
+		if( pRecord->pNextIdle != pRecord ) {
+			ppLink = &pRecord->pNextAll;
+			continue;
+		}
+
+		*ppLink = pRecord->pNextAll;
+
+		axfi__pool_update_high_water( pPool, pRecord );
+		axfi__pool_delete_stack( pPool, pRecord );
+		++cReleased;
+	}
+
+	return cReleased;
+#  else
+	( void )pPool;
+	return 0;
+#  endif
+}
+# else
+;
+# endif
+
+/*
+ * Initialize a fiber that runs on a stack from the pool
+ *
+ * Behaves like axfi_init() otherwise. The fiber must be given back with
+ * axfi_pool_release() rather than axfi_fini().
+ *
+ * Returns pDstFiber on success or NULL on failure.
+ */
+AXFIBER_FUNC axfiber_t *AXFIBER_CALL axfi_pool_acquire( axfi_pool_t *pPool, axfiber_t *pDstFiber, axfi_fn_fiber_t pfnRoutine, void *pUserData )
+# if AXFIBER_IMPLEMENT
+{
+#  if AXFIBER_IMPL_WINDOWS
+	SIZE_T cCommitBytes;
+
+	cCommitBytes = ( SIZE_T )pPool->cStackBytes;
+	if( ( pPool->uFlags & kAxfiber_Pool_LazyCommit ) && cCommitBytes > AXFIBER_POOL_LAZY_COMMIT_SIZE ) {
+		cCommitBytes = AXFIBER_POOL_LAZY_COMMIT_SIZE;
+	}
+
+	pDstFiber->pFiber = CreateFiberEx( cCommitBytes, ( SIZE_T )pPool->cStackBytes, 0, pfnRoutine, pUserData );
+	if( !pDstFiber->pFiber ) {
+		return ( axfiber_t * )0;
+	}
+
+	++pPool->Stats.cStacks;
+#  elif AXFIBER_IMPL_UNIX
+	axfi__stack_t *pRecord;
+
+	if( ( pRecord = pPool->pIdle ) != ( axfi__stack_t * )0 ) {
+		pPool->pIdle = pRecord->pNextIdle;
+		pRecord->pNextIdle = ( axfi__stack_t * )0;
+		++pPool->Stats.cReused;
+	} else if( !( pRecord = axfi__pool_new_stack( pPool ) ) ) {
+		return ( axfiber_t * )0;
+	}
+
+#   if !AXFIBER_CONTEXT_ASM
+	pDstFiber->Context = pPool->Template;
+#   endif
+	pDstFiber->pStack = ( void * )axfi__pool_usable_base( pPool, pRecord );
+
+	axfi__start_context( pDstFiber, axfi__pool_usable_bytes( pPool ), pfnRoutine, pUserData );
+#  else
+#   error Could not determine how to implement axfi_pool_acquire()
+#  endif
+
+	++pPool->Stats.cAcquired;
+	if( ++pPool->Stats.cInUse > pPool->Stats.cPeakInUse ) {
+		pPool->Stats.cPeakInUse = pPool->Stats.cInUse;
+	}
+
+	return pDstFiber;
+}
+# else
+;
+# endif
+/*
+ * Give a fiber's stack back to the pool it was acquired from
+ *
+ * The fiber must not be running. Returns NULL.
+ */
+AXFIBER_FUNC axfiber_t *AXFIBER_CALL axfi_pool_release( axfi_pool_t *pPool, axfiber_t *pFiber )
+# if AXFIBER_IMPLEMENT
+{
+#  if AXFIBER_IMPL_UNIX
+	axfi__stack_t *pRecord;
+#  endif
+
+	if( !pFiber ) {
+		return ( axfiber_t * )0;
+	}
+
+#  if AXFIBER_IMPL_WINDOWS
+	DeleteFiber( pFiber->pFiber );
+	pFiber->pFiber = ( LPVOID )0;
+
+	--pPool->Stats.cStacks;
+#  elif AXFIBER_IMPL_UNIX
+	if( !pFiber->pStack ) {
+		return ( axfiber_t * )0;
+	}
+
+	pRecord = axfi__pool_record( pPool, pFiber->pStack );
+	pRecord->pNextIdle = pPool->pIdle;
+	pPool->pIdle = pRecord;
+
+	pFiber->pStack = ( void * )0;
+#  else
+#   error Could not determine how to implement axfi_pool_release()
+#  endif
+
+	--pPool->Stats.cInUse;
+	return ( axfiber_t * )0;
+}
+# else
+;
+# endif
+
+/*
+ * Retrieve a pool's counters
+ *
+ * Finding the high-water mark means scanning every stack the pool owns, so
+ * avoid calling this in hot paths.
+ */
+AXFIBER_FUNC void AXFIBER_CALL axfi_pool_get_stats( axfi_pool_t *pPool, axfi_pool_stats_t *pOutStats )
+# if AXFIBER_IMPLEMENT
+{
+#  if AXFIBER_IMPL_UNIX
+	axfi__stack_t *pRecord;
+
+	for( pRecord = pPool->pAll; pRecord != ( axfi__stack_t * )0; pRecord = pRecord->pNextAll ) {
+		axfi__pool_update_high_water( pPool, pRecord );
+	}
+#  endif
+
+	*pOutStats = pPool->Stats;
+}
+# else
+;
+# endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
 #endif
@@ -0,0 +1,1074 @@
+/*
+
+	ax_job - public domain
+	Last update: 2026-10-14
+
+
+	This library provides a work-stealing job system built on top of ax_thread
+	(threads, atomics, worker IDs) and, optionally, ax_fiber.
+
+
+	USAGE
+	=====
+
+	Define AXJOB_IMPLEMENTATION in exactly one source file that includes this
+	header, before including it.
+
+	The following don't need to be defined, as default definitions will be
+	provided, but can be defined if you want to alter default functionality
+	without modifying this file.
+
+	AXJOB_FUNC and AXJOB_CALL control the function declaration and calling
+	conventions. Ensure that all source files including this use the same
+	definitions for these. (That can be done in your Makefile or project
+	settings.)
+
+
+	OVERVIEW
+	========
+
+	`axjob_init()` starts one worker per hardware thread (as reported by
+	`axth_count_cpu_threads()`) unless told otherwise. The thread calling
+	`axjob_init()` is worker 0; the others are created for the system. Each
+	worker's index is given to it with `axth_set_worker_id()`, so anything that
+	identifies threads through `axth_get_worker_id()` (such as ax_memory's
+	phased heap) works from within jobs.
+
+	Every worker owns a fixed-size Chase-Lev deque. Jobs submitted from a
+	worker are pushed onto the bottom of its deque and popped back off the
+	bottom (LIFO, keeping recently touched data in cache) while idle workers
+	steal from the top of a randomly chosen victim (FIFO). The owner's push and
+	pop are wait-free; stealing is lock-free. If a deque is full the job is run
+	right away instead of being queued.
+
+	Dependencies are expressed with counters. `axjob_run()` adds the number of
+	jobs to the counter given to it, and each job decrements it once it
+	returns. `axjob_wait()` then waits for the counter to drop to a target
+	value (usually zero):
+
+		- In a job running on a fiber, the fiber is parked and the worker
+		  switches to a free fiber from the pool to keep working. Once the
+		  counter reaches its target the parked fiber is resumed by whichever
+		  worker notices first.
+		- Otherwise (fibers disabled, on worker 0, or no free fiber) the caller
+		  runs other jobs until the counter reaches its target.
+
+	Workers that run out of work sleep on a semaphore and are woken as jobs are
+	submitted.
+
+
+	RESTRICTIONS
+	============
+
+	- Only one job system should be running at a time, as worker IDs are
+	  process-wide.
+	- Only the workers (including the thread that called `axjob_init()`) may
+	  submit or wait on jobs.
+	- A job that waits while on a fiber may continue on a different thread.
+	  Don't hold thread-affine state (OS mutexes, cached thread-local pointers)
+	  across `axjob_wait()`.
+	- All jobs must have finished before `axjob_fini()` is called.
+
+
+	CONFIGURATION MACROS
+	====================
+
+	Define any of these prior to including this header, if you want to alter
+	the default functionality.
+
+		AXJOB_FIBERS_ENABLED
+		--------------------
+		Set to 1 to allow jobs to run on fibers. Requires ax_fiber.h to be
+		included before this header. (Default is 1 when ax_fiber.h is
+		available.)
+
+		AXJOB_DEQUE_SIZE
+		----------------
+		Number of jobs each worker's deque can hold. Must be a power of two.
+		(Default is 4096.)
+
+		AXJOB_FIBER_STACK_SIZE
+		----------------------
+		Default stack size of each fiber, in bytes. (Default is 64KB.)
+
+		AXJOB_IDLE_SPIN_COUNT
+		---------------------
+		Number of times a worker looks for work without finding any before it
+		goes to sleep. (Default is 64.)
+
+
+	REPLACE JOB ALLOCATORS
+	======================
+
+	You can specify your own allocator to use with this library by defining the
+	axjob_alloc and axjob_free macros. By default they are defined to the
+	standard C library's malloc() and free(). Allocations are only made by
+	`axjob_init()`.
+
+
+	INTERACTIONS
+	============
+
+	This library requires ax_thread. It will be included automatically on
+	compilers with `__has_include`; otherwise include it before this header.
+
+	ax_fiber will be used if it has been included prior to this header.
+	When ax_fiber's pools are available (see AXFIBER_POOL_ENABLED) fiber stacks
+	come from a pool and so have guard pages.
+
+
+	LICENSE
+	=======
+
+	This software is in the public domain. Where that dedication is not
+	recognized, you are granted a perpetual, irrevocable license to copy
+	and modify this file as you see fit. There are no warranties of any
+	kind.
+
+*/
+
+#ifndef INCGUARD_AX_JOB_H_
+#define INCGUARD_AX_JOB_H_
+
+#ifndef AX_NO_PRAGMA_ONCE
+# pragma once
+#endif
+
+#if !defined( AX_NO_INCLUDES ) && defined( __has_include )
+# if __has_include( "ax_platform.h" )
+#  include "ax_platform.h"
+# endif
+# if __has_include( "ax_types.h" )
+#  include "ax_types.h"
+# endif
+# if __has_include( "ax_thread.h" )
+#  include "ax_thread.h"
+# endif
+# if __has_include( "ax_fiber.h" )
+#  include "ax_fiber.h"
+# endif
+#endif
+
+#ifndef INCGUARD_AX_THREAD_H_
+# error ax_job requires ax_thread.h
+#endif
+
+#ifdef AXJOB_IMPLEMENTATION
+# define AXJOB_IMPLEMENT            1
+#else
+# define AXJOB_IMPLEMENT            0
+#endif
+
+#ifndef AXJOB_FUNC
+# ifdef AX_FUNC
+#  define AXJOB_FUNC                AX_FUNC
+# else
+#  define AXJOB_FUNC                extern
+# endif
+#endif
+#ifndef AXJOB_CALL
+# ifdef AX_CALL
+#  define AXJOB_CALL                AX_CALL
+# else
+#  define AXJOB_CALL
+# endif
+#endif
+
+#ifndef AXJOB_FIBERS_ENABLED
+# ifdef INCGUARD_AX_FIBER_H_
+#  define AXJOB_FIBERS_ENABLED      1
+# else
+#  define AXJOB_FIBERS_ENABLED      0
+# endif
+#endif
+#if AXJOB_FIBERS_ENABLED && !defined( INCGUARD_AX_FIBER_H_ )
+# error AXJOB_FIBERS_ENABLED requires ax_fiber.h
+#endif
+
+#ifndef AXJOB_DEQUE_SIZE
+# define AXJOB_DEQUE_SIZE           4096
+#endif
+#if ( AXJOB_DEQUE_SIZE & ( AXJOB_DEQUE_SIZE - 1 ) ) != 0
+# error AXJOB_DEQUE_SIZE must be a power of two
+#endif
+
+#ifndef AXJOB_FIBER_STACK_SIZE
+# define AXJOB_FIBER_STACK_SIZE     (64*1024)
+#endif
+
+#ifndef AXJOB_IDLE_SPIN_COUNT
+# define AXJOB_IDLE_SPIN_COUNT      64
+#endif
+
+#ifndef axjob_alloc
+# include <stdlib.h>
+# define axjob_alloc(N_)            (malloc((N_)))
+# define axjob_free(P_)             (free((P_)))
+#endif
+
+#define AXJOB__CACHE_LINE           64
+
+#ifndef AXJOB__NOINLINE
+# if defined( _MSC_VER )
+#  define AXJOB__NOINLINE           __declspec( noinline )
+# elif defined( __GNUC__ ) || defined( __clang__ )
+#  define AXJOB__NOINLINE           __attribute__((noinline))
+# else
+#  define AXJOB__NOINLINE
+# endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Function run by a job */
+typedef void( AXJOB_CALL *axjob_fn_job_t )( void *pData );
+
+/* Description of a job to submit with `axjob_run()` */
+typedef struct axjob_desc_s
+{
+	/* Function to run */
+	axjob_fn_job_t                  pfnJob;
+	/* Parameter passed to the function */
+	void *                          pData;
+} axjob_desc_t;
+
+/* Number of unfinished jobs something depends on */
+typedef struct axjob_counter_s
+{
+	volatile axth_u32_t             uValue;
+} axjob_counter_t;
+
+#define AXJOB_COUNTER_INITIALIZER   {((axth_u32_t)0)}
+
+/* Settings for `axjob_init()` (zero-initialize for the defaults) */
+typedef struct axjob_config_s
+{
+	/* Number of workers, including the calling thread (0 for one per hardware thread) */
+	axth_u32_t                      cWorkers;
+	/* Number of fibers to run jobs on, including one for each worker thread (0 to run jobs on the worker threads directly) */
+	axth_u32_t                      cFibers;
+	/* Stack size of each fiber, in bytes (0 for AXJOB_FIBER_STACK_SIZE) */
+	axth_size_t                     cFiberStackBytes;
+} axjob_config_t;
+
+/* implementation: queued job */
+typedef struct axjob__entry_s
+{
+	axjob_fn_job_t                  pfnJob;
+	void *                          pData;
+	axjob_counter_t *               pCounter;
+} axjob__entry_t;
+
+/* implementation: Chase-Lev deque -- the owner works at the bottom, thieves take from the top */
+typedef struct axjob__deque_s
+{
+	/* index of the oldest job (advanced by thieves, and by the owner when taking the last job) */
+	volatile axth_u32_t             uTop;
+	char                            _pad0[ AXJOB__CACHE_LINE - sizeof( axth_u32_t ) ];
+	/* index one past the newest job (only written by the owner) */
+	volatile axth_u32_t             uBottom;
+	char                            _pad1[ AXJOB__CACHE_LINE - sizeof( axth_u32_t ) ];
+	/* AXJOB_DEQUE_SIZE entries */
+	axjob__entry_t *                pSlots;
+} axjob__deque_t;
+
+#if AXJOB_FIBERS_ENABLED
+/* implementation: pooled fiber */
+typedef struct axjob__fiber_s
+{
+	axfiber_t                       Fiber;
+	/* next fiber in the free or waiting list */
+	struct axjob__fiber_s *         pNext;
+	/* counter being waited on while parked */
+	axjob_counter_t *               pWaitCounter;
+	axth_u32_t                      uWaitTarget;
+} axjob__fiber_t;
+
+/* implementation: what to do with the fiber that was just switched away from */
+typedef enum axjob__handoff_e
+{
+	kAxjob__Handoff_None,
+	kAxjob__Handoff_Free,
+	kAxjob__Handoff_Wait
+} axjob__handoff_t;
+#endif
+
+struct axjob_system_s;
+
+/* implementation: per-worker state */
+typedef struct axjob__worker_s
+{
+	axjob__deque_t                  Deque;
+	/* system this worker belongs to */
+	struct axjob_system_s *         pSystem;
+	/* worker thread (unused for worker 0) */
+	axthread_t                      Thread;
+	/* worker ID */
+	axth_u32_t                      uIndex;
+	/* xorshift state for picking victims */
+	axth_u32_t                      uRandom;
+	/* set if the worker thread was created */
+	axth_u32_t                      bStarted;
+	/* set once the worker thread has left its loop */
+	volatile axth_u32_t             bExited;
+#if AXJOB_FIBERS_ENABLED
+	/* fiber of the worker thread itself */
+	axfiber_t                       HomeFiber;
+	/* pooled fiber currently running on this worker (NULL if none) */
+	axjob__fiber_t *                pCurrent;
+	/* fiber switched away from, to be settled by the fiber switched to */
+	axjob__fiber_t *                pHandoff;
+	axjob__handoff_t                Handoff;
+#endif
+} axjob__worker_t;
+
+/* Job system */
+typedef struct axjob_system_s
+{
+	/* array of cWorkers workers (cache-line aligned) */
+	axjob__worker_t *               pWorkers;
+	/* allocation holding pWorkers */
+	void *                          pWorkerMem;
+	axth_u32_t                      cWorkers;
+	/* set when shutting down */
+	volatile axth_u32_t             bQuit;
+	/* workers sleeping on WakeSem (or about to) */
+	volatile axth_u32_t             cSleeping;
+	axth_sem_t                      WakeSem;
+#if AXJOB_FIBERS_ENABLED
+	/* array of cFibers fibers */
+	axjob__fiber_t *                pFibers;
+	axth_u32_t                      cFibers;
+# if AXFIBER_POOL_ENABLED
+	/* stacks (with guard pages) for the fibers */
+	axfi_pool_t                     FiberPool;
+# endif
+	/* fibers available to run on */
+	axth_qmutex_t                   FreeLock;
+	axjob__fiber_t *                pFreeFibers;
+	/* fibers parked on counters */
+	axth_qmutex_t                   WaitLock;
+	axjob__fiber_t *                pWaitFibers;
+	volatile axth_u32_t             cWaitFibers;
+#endif
+} axjob_system_t;
+
+AXJOB_FUNC axjob_system_t *AXJOB_CALL axjob_fini( axjob_system_t *p );
+
+#if AXJOB_IMPLEMENT
+/* implementation: worker state of the calling thread (never inlined: fibers can resume on other threads) */
+static AXJOB__NOINLINE axjob__worker_t *axjob__current_worker( axjob_system_t *p )
+{
+	axth_u32_t i;
+
+	i = axth_get_worker_id();
+	return i < p->cWorkers ? &p->pWorkers[ i ] : ( axjob__worker_t * )0;
+}
+
+static int axjob__deque_push( axjob__deque_t *d, const axjob__entry_t *pEntry )
+{
+	axth_u32_t b, t;
+
+	b = d->uBottom;
+	t = d->uTop;
+	if( b - t >= AXJOB_DEQUE_SIZE ) {
+		return 0;
+	}
+
+	d->pSlots[ b & ( AXJOB_DEQUE_SIZE - 1 ) ] = *pEntry;
+	AX_COMPILER_FENCE();
+	d->uBottom = b + 1;
+
+	return 1;
+}
+static int axjob__deque_pop( axjob__deque_t *d, axjob__entry_t *pDst )
+{
+	axth_u32_t b, t;
+	int r;
+
+	/* claim the bottom slot before looking at the top, so a thief can't take it too */
+	b = d->uBottom - 1;
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &d->uBottom, b );
+	t = d->uTop;
+
+	if( ( axth_s32_t )( b - t ) < 0 ) {
+		d->uBottom = b + 1;
+		return 0;
+	}
+
+	*pDst = d->pSlots[ b & ( AXJOB_DEQUE_SIZE - 1 ) ];
+	if( b != t ) {
+		return 1;
+	}
+
+	/* last job; race the thieves for it */
+	r = AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &d->uTop, t + 1, t ) == t;
+	d->uBottom = b + 1;
+
+	return r;
+}
+static int axjob__deque_steal( axjob__deque_t *d, axjob__entry_t *pDst )
+{
+	axth_u32_t b, t;
+
+	t = d->uTop;
+	AX_COMPILER_FENCE();
+	b = d->uBottom;
+
+	if( ( axth_s32_t )( b - t ) <= 0 ) {
+		return 0;
+	}
+
+	/* the slot can't be reused before uTop moves past it, which the exchange checks */
+	*pDst = d->pSlots[ t & ( AXJOB_DEQUE_SIZE - 1 ) ];
+	return AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &d->uTop, t + 1, t ) == t;
+}
+static int axjob__deque_is_empty( const axjob__deque_t *d )
+{
+	return ( axth_s32_t )( d->uBottom - d->uTop ) <= 0;
+}
+
+static axth_u32_t axjob__random( axjob__worker_t *w )
+{
+	axth_u32_t x;
+
+	x = w->uRandom;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	w->uRandom = x;
+
+	return x;
+}
+
+/* implementation: find a job for `w`, from its own deque first, then from a random victim's */
+static int axjob__get_job( axjob_system_t *p, axjob__worker_t *w, axjob__entry_t *pDst )
+{
+	axth_u32_t i, n;
+
+	if( axjob__deque_pop( &w->Deque, pDst ) ) {
+		return 1;
+	}
+
+	i = axjob__random( w ) % p->cWorkers;
+	for( n = 0; n < p->cWorkers; ++n ) {
+		if( i != w->uIndex && axjob__deque_steal( &p->pWorkers[ i ].Deque, pDst ) ) {
+			return 1;
+		}
+
+		if( ++i == p->cWorkers ) {
+			i = 0;
+		}
+	}
+
+	return 0;
+}
+
+/* implementation: wake up to `cWanted` sleeping workers */
+static void axjob__wake( axjob_system_t *p, axth_u32_t cWanted )
+{
+	axth_u32_t cSleeping;
+
+	/* full barrier read; pairs with the increment in axjob__sleep() */
+	cSleeping = AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->cSleeping, 0, 0 );
+	while( cSleeping > 0 && cWanted > 0 ) {
+		axth_sem_signal( &p->WakeSem );
+		--cSleeping;
+		--cWanted;
+	}
+}
+
+static void axjob__execute( axjob_system_t *p, const axjob__entry_t *pEntry )
+{
+	pEntry->pfnJob( pEntry->pData );
+
+	if( pEntry->pCounter != ( axjob_counter_t * )0 ) {
+		( void )AX_ATOMIC_FETCH_SUB_FULL32( &pEntry->pCounter->uValue, 1 );
+#if AXJOB_FIBERS_ENABLED
+		/* a parked fiber may be ready now; somebody has to be awake to resume it */
+		if( p->cWaitFibers != 0 ) {
+			axjob__wake( p, 1 );
+		}
+#endif
+	}
+
+	( void )p;
+}
+
+# if AXJOB_FIBERS_ENABLED
+static axjob__fiber_t *axjob__pop_free_fiber( axjob_system_t *p )
+{
+	axjob__fiber_t *f;
+
+	if( !p->pFreeFibers ) {
+		return ( axjob__fiber_t * )0;
+	}
+
+	axth_qmutex_acquire( &p->FreeLock, AXTHREAD_DEFAULT_SPIN_COUNT );
+	if( ( f = p->pFreeFibers ) != ( axjob__fiber_t * )0 ) {
+		p->pFreeFibers = f->pNext;
+		f->pNext = ( axjob__fiber_t * )0;
+	}
+	axth_qmutex_release( &p->FreeLock );
+
+	return f;
+}
+/* implementation: remove a parked fiber whose counter has reached its target */
+static axjob__fiber_t *axjob__pop_ready_fiber( axjob_system_t *p, int bRemove )
+{
+	axjob__fiber_t **pp;
+	axjob__fiber_t *f;
+
+	if( !p->cWaitFibers ) {
+		return ( axjob__fiber_t * )0;
+	}
+
+	axth_qmutex_acquire( &p->WaitLock, AXTHREAD_DEFAULT_SPIN_COUNT );
+	for( pp = &p->pWaitFibers; ( f = *pp ) != ( axjob__fiber_t * )0; pp = &f->pNext ) {
+		if( f->pWaitCounter->uValue <= f->uWaitTarget ) {
+			if( bRemove ) {
+				*pp = f->pNext;
+				f->pNext = ( axjob__fiber_t * )0;
+				--p->cWaitFibers;
+			}
+
+			break;
+		}
+	}
+	axth_qmutex_release( &p->WaitLock );
+
+	return f;
+}
+
+/*
+	implementation: complete the switch away from the previous fiber
+
+	The previous fiber can't be made available to other workers until it has
+	actually been switched away from, so whichever fiber runs next on this
+	worker does that.
+*/
+static void axjob__settle( axjob_system_t *p )
+{
+	axjob__worker_t *w;
+	axjob__fiber_t *f;
+
+	w = axjob__current_worker( p );
+	f = w->pHandoff;
+
+	switch( w->Handoff ) {
+	case kAxjob__Handoff_None:
+		break;
+
+	case kAxjob__Handoff_Free:
+		axth_qmutex_acquire( &p->FreeLock, AXTHREAD_DEFAULT_SPIN_COUNT );
+		f->pNext = p->pFreeFibers;
+		p->pFreeFibers = f;
+		axth_qmutex_release( &p->FreeLock );
+		break;
+
+	case kAxjob__Handoff_Wait:
+		axth_qmutex_acquire( &p->WaitLock, AXTHREAD_DEFAULT_SPIN_COUNT );
+		f->pNext = p->pWaitFibers;
+		p->pWaitFibers = f;
+		++p->cWaitFibers;
+		axth_qmutex_release( &p->WaitLock );
+		break;
+	}
+
+	w->Handoff = kAxjob__Handoff_None;
+	w->pHandoff = ( axjob__fiber_t * )0;
+}
+/* implementation: switch the current worker to `pTo` (the worker's home fiber if NULL) */
+static void axjob__switch( axjob_system_t *p, axjob__worker_t *w, axjob__fiber_t *pTo, axjob__handoff_t Handoff )
+{
+	w->pHandoff = w->pCurrent;
+	w->Handoff = Handoff;
+	w->pCurrent = pTo;
+
+	axfi_switch( pTo != ( axjob__fiber_t * )0 ? &pTo->Fiber : &w->HomeFiber );
+
+	/* possibly on another worker now */
+	axjob__settle( p );
+}
+/* implementation: park the current fiber until the counter reaches its target (returns 0 if no fiber is free) */
+static int axjob__park( axjob_system_t *p, axjob__worker_t *w, axjob_counter_t *pCounter, axth_u32_t uTarget )
+{
+	axjob__fiber_t *pNext;
+
+	if( !( pNext = axjob__pop_free_fiber( p ) ) ) {
+		return 0;
+	}
+
+	w->pCurrent->pWaitCounter = pCounter;
+	w->pCurrent->uWaitTarget = uTarget;
+
+	axjob__switch( p, w, pNext, kAxjob__Handoff_Wait );
+	return 1;
+}
+# endif
+
+static int axjob__has_work( axjob_system_t *p )
+{
+	axth_u32_t i;
+
+	for( i = 0; i < p->cWorkers; ++i ) {
+		if( !axjob__deque_is_empty( &p->pWorkers[ i ].Deque ) ) {
+			return 1;
+		}
+	}
+
+# if AXJOB_FIBERS_ENABLED
+	if( axjob__pop_ready_fiber( p, 0 ) != ( axjob__fiber_t * )0 ) {
+		return 1;
+	}
+# endif
+
+	return 0;
+}
+static void axjob__sleep( axjob_system_t *p )
+{
+	/* announce the sleep before the final check so submitters either see us or we see their job */
+	( void )AX_ATOMIC_FETCH_ADD_FULL32( &p->cSleeping, 1 );
+	if( !p->bQuit && !axjob__has_work( p ) ) {
+		axth_sem_wait( &p->WakeSem );
+	}
+	( void )AX_ATOMIC_FETCH_SUB_FULL32( &p->cSleeping, 1 );
+}
+
+/* implementation: main loop of a worker (on its own thread, or on a pooled fiber) */
+static void axjob__work( axjob_system_t *p )
+{
+	axjob__worker_t *w;
+	axjob__entry_t Entry;
+	axth_u32_t cIdle = 0;
+	axth_u32_t cSpins = 1;
+# if AXJOB_FIBERS_ENABLED
+	axjob__fiber_t *f;
+# endif
+
+	while( !p->bQuit ) {
+		w = axjob__current_worker( p );
+
+# if AXJOB_FIBERS_ENABLED
+		/* resuming parked fibers first finishes older work before starting new work */
+		if( w->pCurrent != ( axjob__fiber_t * )0 && ( f = axjob__pop_ready_fiber( p, 1 ) ) != ( axjob__fiber_t * )0 ) {
+			axjob__switch( p, w, f, kAxjob__Handoff_Free );
+			cIdle = 0;
+			cSpins = 1;
+			continue;
+		}
+# endif
+
+		if( axjob__get_job( p, w, &Entry ) ) {
+			axjob__execute( p, &Entry );
+			cIdle = 0;
+			cSpins = 1;
+			continue;
+		}
+
+		if( ++cIdle < AXJOB_IDLE_SPIN_COUNT ) {
+			axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+			continue;
+		}
+
+		axjob__sleep( p );
+		cIdle = 0;
+		cSpins = 1;
+	}
+}
+
+# if AXJOB_FIBERS_ENABLED
+static AXFIBER_ENTRY_POINT( axjob__fiber_f, pParm )
+{
+	axjob_system_t *p;
+
+	p = ( axjob_system_t * )pParm;
+
+	for(;;) {
+		axjob__settle( p );
+		axjob__work( p );
+
+		/* shutting down; hand the worker back to its thread */
+		axjob__switch( p, axjob__current_worker( p ), ( axjob__fiber_t * )0, kAxjob__Handoff_Free );
+	}
+}
+# endif
+
+static int AXTHREAD_CALL axjob__thread_f( axthread_t *pThread, void *pParm )
+{
+	axjob__worker_t *w;
+	axjob_system_t *p;
+# if AXJOB_FIBERS_ENABLED
+	axjob__fiber_t *f;
+# endif
+
+	w = ( axjob__worker_t * )pParm;
+	p = w->pSystem;
+
+	axth_set_worker_id( w->uIndex );
+
+# if AXJOB_FIBERS_ENABLED
+	/* assigned by axjob_init() */
+	f = w->pCurrent;
+	w->pCurrent = ( axjob__fiber_t * )0;
+
+	if( f != ( axjob__fiber_t * )0 ) {
+		if( axfi_thread_to_fiber( &w->HomeFiber, ( void * )w ) != ( axfiber_t * )0 ) {
+			axjob__switch( p, w, f, kAxjob__Handoff_None );
+			axfi_fiber_to_thread();
+		} else {
+			w->pHandoff = f;
+			w->Handoff = kAxjob__Handoff_Free;
+			axjob__settle( p );
+
+			f = ( axjob__fiber_t * )0;
+		}
+	}
+
+	/* not enough fibers to go around; work on the thread directly */
+	if( !f ) {
+		axjob__work( p );
+	}
+# else
+	axjob__work( p );
+# endif
+
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &w->bExited, 1 );
+
+	( void )pThread;
+	return 0;
+}
+#endif
+
+/*
+ * Start a job system.
+ *
+ * [out] p: System to initialize
+ * [in]  pConfig: Settings to use (NULL for the defaults)
+ *
+ * The calling thread becomes worker 0. Returns p on success or NULL on failure.
+ */
+AXJOB_FUNC axjob_system_t *AXJOB_CALL axjob_init( axjob_system_t *p, const axjob_config_t *pConfig )
+#if AXJOB_IMPLEMENT
+{
+	axjob__worker_t *w;
+	axth_u32_t cWorkers;
+	axth_u32_t i;
+# if AXJOB_FIBERS_ENABLED
+	axth_size_t cStackBytes;
+# endif
+
+	cWorkers = pConfig != ( const axjob_config_t * )0 ? pConfig->cWorkers : 0;
+	if( !cWorkers ) {
+		cWorkers = axth_count_cpu_threads();
+	}
+	if( !cWorkers ) {
+		cWorkers = 1;
+	}
+
+	p->pWorkers = ( axjob__worker_t * )0;
+	p->cWorkers = 0;
+	p->bQuit = 0;
+	p->cSleeping = 0;
+# if AXJOB_FIBERS_ENABLED
+	p->pFibers = ( axjob__fiber_t * )0;
+	p->cFibers = 0;
+	axth_qmutex_init( &p->FreeLock );
+	p->pFreeFibers = ( axjob__fiber_t * )0;
+	axth_qmutex_init( &p->WaitLock );
+	p->pWaitFibers = ( axjob__fiber_t * )0;
+	p->cWaitFibers = 0;
+# endif
+
+	if( !axth_sem_init( &p->WakeSem, 0 ) ) {
+		return ( axjob_system_t * )0;
+	}
+
+# if AXJOB_FIBERS_ENABLED && AXFIBER_POOL_ENABLED
+	cStackBytes = pConfig != ( const axjob_config_t * )0 && pConfig->cFiberStackBytes ? pConfig->cFiberStackBytes : AXJOB_FIBER_STACK_SIZE;
+	if( !axfi_pool_init( &p->FiberPool, cStackBytes, 0 ) ) {
+		axth_sem_fini( &p->WakeSem );
+		return ( axjob_system_t * )0;
+	}
+# endif
+
+	p->pWorkerMem = axjob_alloc( sizeof( axjob__worker_t )*cWorkers + AXJOB__CACHE_LINE );
+	if( !p->pWorkerMem ) {
+# if AXJOB_FIBERS_ENABLED && AXFIBER_POOL_ENABLED
+		axfi_pool_fini( &p->FiberPool );
+# endif
+		axth_sem_fini( &p->WakeSem );
+		return ( axjob_system_t * )0;
+	}
+
+	p->pWorkers = ( axjob__worker_t * )( ( ( axth_size_t )p->pWorkerMem + AXJOB__CACHE_LINE - 1 ) & ~( axth_size_t )( AXJOB__CACHE_LINE - 1 ) );
+	for( i = 0; i < cWorkers; ++i ) {
+		w = &p->pWorkers[ i ];
+
+		w->Deque.uTop = 0;
+		w->Deque.uBottom = 0;
+		w->pSystem = p;
+		w->uIndex = i;
+		w->uRandom = 0x9E3779B9U*( i + 1 );
+		w->bStarted = 0;
+		w->bExited = 0;
+# if AXJOB_FIBERS_ENABLED
+		w->pCurrent = ( axjob__fiber_t * )0;
+		w->pHandoff = ( axjob__fiber_t * )0;
+		w->Handoff = kAxjob__Handoff_None;
+# endif
+
+		/* counted as it goes, so axjob_fini() only releases what was made */
+		if( !( w->Deque.pSlots = ( axjob__entry_t * )axjob_alloc( sizeof( axjob__entry_t )*AXJOB_DEQUE_SIZE ) ) ) {
+			axjob_fini( p );
+			return ( axjob_system_t * )0;
+		}
+		p->cWorkers = i + 1;
+	}
+
+# if AXJOB_FIBERS_ENABLED
+	if( pConfig != ( const axjob_config_t * )0 && pConfig->cFibers > 0 ) {
+#  if !AXFIBER_POOL_ENABLED
+		cStackBytes = pConfig->cFiberStackBytes ? pConfig->cFiberStackBytes : AXJOB_FIBER_STACK_SIZE;
+#  endif
+
+		if( !( p->pFibers = ( axjob__fiber_t * )axjob_alloc( sizeof( axjob__fiber_t )*pConfig->cFibers ) ) ) {
+			axjob_fini( p );
+			return ( axjob_system_t * )0;
+		}
+
+		for( i = 0; i < pConfig->cFibers; ++i ) {
+#  if AXFIBER_POOL_ENABLED
+			if( !axfi_pool_acquire( &p->FiberPool, &p->pFibers[ i ].Fiber, &axjob__fiber_f, ( void * )p ) ) {
+#  else
+			if( !axfi_init( &p->pFibers[ i ].Fiber, cStackBytes, &axjob__fiber_f, ( void * )p ) ) {
+#  endif
+				axjob_fini( p );
+				return ( axjob_system_t * )0;
+			}
+
+			p->pFibers[ i ].pNext = p->pFreeFibers;
+			p->pFibers[ i ].pWaitCounter = ( axjob_counter_t * )0;
+			p->pFibers[ i ].uWaitTarget = 0;
+			p->pFreeFibers = &p->pFibers[ i ];
+			p->cFibers = i + 1;
+		}
+
+		/* hand out the workers' first fibers now, so none of them miss out to early parkers */
+		for( i = 1; i < cWorkers; ++i ) {
+			p->pWorkers[ i ].pCurrent = axjob__pop_free_fiber( p );
+		}
+	}
+# endif
+
+	axth_set_worker_id( 0 );
+
+	for( i = 1; i < cWorkers; ++i ) {
+		w = &p->pWorkers[ i ];
+
+		if( !axthread_init_named( &w->Thread, "axjob worker", &axjob__thread_f, ( void * )w ) ) {
+			axjob_fini( p );
+			return ( axjob_system_t * )0;
+		}
+
+		w->bStarted = 1;
+	}
+
+	return p;
+}
+#else
+;
+#endif
+/*
+ * Stop a job system, waiting for its worker threads to exit.
+ *
+ * All jobs must have been completed. Returns NULL.
+ */
+AXJOB_FUNC axjob_system_t *AXJOB_CALL axjob_fini( axjob_system_t *p )
+#if AXJOB_IMPLEMENT
+{
+	axth_u32_t i;
+
+	if( !p ) {
+		return ( axjob_system_t * )0;
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &p->bQuit, 1 );
+	for( i = 1; i < p->cWorkers; ++i ) {
+		axth_sem_signal( &p->WakeSem );
+	}
+
+	for( i = 1; i < p->cWorkers; ++i ) {
+		if( !p->pWorkers[ i ].bStarted ) {
+			continue;
+		}
+
+		while( !p->pWorkers[ i ].bExited ) {
+			axth_yield();
+		}
+
+		axthread_fini( &p->pWorkers[ i ].Thread );
+	}
+
+# if AXJOB_FIBERS_ENABLED
+	for( i = 0; i < p->cFibers; ++i ) {
+#  if AXFIBER_POOL_ENABLED
+		axfi_pool_release( &p->FiberPool, &p->pFibers[ i ].Fiber );
+#  else
+		axfi_fini( &p->pFibers[ i ].Fiber );
+#  endif
+	}
+#  if AXFIBER_POOL_ENABLED
+	axfi_pool_fini( &p->FiberPool );
+#  endif
+	axjob_free( ( void * )p->pFibers );
+	p->pFibers = ( axjob__fiber_t * )0;
+	p->cFibers = 0;
+	p->pFreeFibers = ( axjob__fiber_t * )0;
+	p->pWaitFibers = ( axjob__fiber_t * )0;
+# endif
+
+	for( i = 0; i < p->cWorkers; ++i ) {
+		axjob_free( ( void * )p->pWorkers[ i ].Deque.pSlots );
+	}
+	axjob_free( p->pWorkerMem );
+	p->pWorkerMem = ( void * )0;
+	p->pWorkers = ( axjob__worker_t * )0;
+	p->cWorkers = 0;
+
+	axth_sem_fini( &p->WakeSem );
+	return ( axjob_system_t * )0;
+}
+#else
+;
+#endif
+
+/* Retrieve the number of workers (including the thread that started the system) */
+AXJOB_FUNC axth_u32_t AXJOB_CALL axjob_count_workers( const axjob_system_t *p )
+#if AXJOB_IMPLEMENT
+{
+	return p->cWorkers;
+}
+#else
+;
+#endif
+
+/* Set a counter's value (it must not be waited on while doing so) */
+AXJOB_FUNC axjob_counter_t *AXJOB_CALL axjob_counter_init( axjob_counter_t *pCounter, axth_u32_t uValue )
+#if AXJOB_IMPLEMENT
+{
+	pCounter->uValue = uValue;
+	return pCounter;
+}
+#else
+;
+#endif
+/* Retrieve a counter's current value */
+AXJOB_FUNC axth_u32_t AXJOB_CALL axjob_counter_get( const axjob_counter_t *pCounter )
+#if AXJOB_IMPLEMENT
+{
+	return pCounter->uValue;
+}
+#else
+;
+#endif
+
+/*
+ * Submit jobs.
+ *
+ * [in]    p: System to run the jobs on
+ * [in]    pJobs: Array of jobs
+ * [in]    cJobs: Number of jobs in the array
+ * [inout] pCounter: Incremented by cJobs now and decremented as each job
+ *                   finishes (may be NULL)
+ *
+ * Jobs are queued on the calling worker's deque (or run immediately if it's
+ * full, or if the caller isn't a worker).
+ */
+AXJOB_FUNC void AXJOB_CALL axjob_run( axjob_system_t *p, const axjob_desc_t *pJobs, axth_u32_t cJobs, axjob_counter_t *pCounter )
+#if AXJOB_IMPLEMENT
+{
+	axjob__worker_t *w;
+	axjob__entry_t Entry;
+	axth_u32_t i;
+
+	if( !cJobs ) {
+		return;
+	}
+
+	if( pCounter != ( axjob_counter_t * )0 ) {
+		( void )AX_ATOMIC_FETCH_ADD_FULL32( &pCounter->uValue, cJobs );
+	}
+
+	w = axjob__current_worker( p );
+	for( i = 0; i < cJobs; ++i ) {
+		Entry.pfnJob = pJobs[ i ].pfnJob;
+		Entry.pData = pJobs[ i ].pData;
+		Entry.pCounter = pCounter;
+
+		if( !w || !axjob__deque_push( &w->Deque, &Entry ) ) {
+			axjob__execute( p, &Entry );
+
+			/* the job may have waited and moved this fiber to another worker */
+			w = axjob__current_worker( p );
+		}
+	}
+
+	axjob__wake( p, cJobs );
+}
+#else
+;
+#endif
+
+/*
+ * Wait for a counter to drop to (or below) a target value.
+ *
+ * On a fiber this parks the fiber and lets the worker carry on with other
+ * jobs. Otherwise the calling thread runs other jobs while it waits.
+ */
+AXJOB_FUNC void AXJOB_CALL axjob_wait( axjob_system_t *p, axjob_counter_t *pCounter, axth_u32_t uTarget )
+#if AXJOB_IMPLEMENT
+{
+	axjob__worker_t *w;
+	axjob__entry_t Entry;
+	axth_u32_t cSpins = 1;
+
+	while( pCounter->uValue > uTarget ) {
+		w = axjob__current_worker( p );
+		if( !w ) {
+			axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+			continue;
+		}
+
+# if AXJOB_FIBERS_ENABLED
+		if( w->pCurrent != ( axjob__fiber_t * )0 && axjob__park( p, w, pCounter, uTarget ) ) {
+			return;
+		}
+# endif
+
+		if( axjob__get_job( p, w, &Entry ) ) {
+			axjob__execute( p, &Entry );
+			cSpins = 1;
+			continue;
+		}
+
+		axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	}
+}
+#else
+;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+/* headers included above may have included ax_array.hpp, whose parallel algorithms need all of this */
+#define AXJOB__DECLARED             1
+#if defined( INCGUARD_AX_ARRAY_HPP_ ) && defined( __cplusplus )
+# include "ax_array_parallel.hpp"
+#endif
+
+#endif
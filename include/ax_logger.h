@@ -75,6 +75,10 @@
 	AXLOG_SNPRINTFV is the name of the function to be used in place of
 	vsnprintf. Unless AXLOG_NO_PF is 1, this defaults to `axspfv`.
 
+	AXLOG_SNPRINTCFV is the name of the function that formats a compiled
+	format (see COMPILED FORMATS) into a buffer, taking the same arguments as
+	`axspcfv`. Unless AXLOG_NO_PF is 1, this defaults to `axspcfv`.
+
 	AXLOG_CUSTOM_VARARGS can be defined to 1 to indicate that <stdarg.h> should
 	not be included and to indicate that the following are all defined:
 
@@ -89,6 +93,46 @@
 	when building on Windows, and 0 otherwise. It should only be defined when
 	AX_IMPLEMENTATION is defined.
 
+	AXLOG_ASYNC_ENABLED controls whether the asynchronous backend (see
+	ASYNCHRONOUS LOGGING) is available. It requires ax_thread.
+
+		Default: 1 if ax_thread.h has been included (or can be found through
+		`__has_include`), 0 otherwise
+
+	AXLOG_ASYNC_RING_SIZE is the size, in bytes, of each thread's ring buffer
+	in asynchronous mode. It must be a power of two. Reports that would take
+	more than a quarter of a ring buffer are dispatched on the calling thread
+	instead.
+
+		Default: 65536
+
+	AXLOG_ASYNC_IDLE_SPIN_COUNT is the number of times the background thread
+	looks for reports without finding any before it goes to sleep.
+
+		Default: 64
+
+	AXLOG_DEFERRED_ENABLED controls whether `axlog_deferf()` queues reports
+	without formatting them (see DEFERRED FORMATTING). It requires the
+	asynchronous backend and ax_printf, and can't be used with
+	AXLOG_CUSTOM_VARARGS.
+
+		Default: 1 if those are available, 0 otherwise
+
+	AXLOG_COMPILED_ENABLED controls whether `axlog_submitcf()` is available
+	(see COMPILED FORMATS). It requires AXLOG_SNPRINTCFV, and so ax_printf
+	unless that was defined.
+
+		Default: 1 if ax_printf is used and AXLOG_CUSTOM_VARARGS is 0
+
+	AXLOG_FMTBUF_SIZE is the size, in chars, of the buffer messages are
+	formatted into. Longer messages are truncated.
+
+		Default: 1024
+
+	axlog_alloc and axlog_free can be defined to replace the allocator used for
+	the ring buffers. By default they are the standard C library's malloc() and
+	free(). Nothing else in this library allocates.
+
 
 	LOG FLAGS FORMAT
 	================
@@ -125,14 +169,124 @@
 	suppress a report from going through. A filter can even modify a log such
 	that its priority is altered (e.g., from "warning" to "error").
 
+	A filter can say which priorities it wants from each facility when it is
+	added (see `axlog_add_filter_ex()` and `axlog_interest_t`), and change that
+	later with `axlog_set_filter_interest()`. The filter is then only called for
+	reports it wants. A report that no filter wants is discarded before its
+	message is formatted or any system information is captured; checking costs
+	a single load and test (`AXLOG_IS_ENABLED()`), so verbose logging can be
+	left compiled in. Filters added with `axlog_add_filter()` want everything,
+	as does the default endpoint that is used while no endpoint is installed.
+	(A manager that changes priorities should want the priorities it changes.)
+
 
 	THREAD SAFETY
 	=============
 
-	Adding and removing filters is *NOT* thread safe. This should be done prior
-	to any multi-threaded logging operations.
+	When ax_thread is available, filters can be added and removed at any time,
+	including while other threads are logging. Submitting a report reads the
+	list of filters without taking a lock; adding or removing a filter publishes
+	a new list and waits for reports still using the old list to finish. Once
+	`axlog_remove_filter()` returns the filter will not be called again, so its
+	user data can be freed. (Do not add or remove filters from within a filter;
+	that would wait on itself forever.)
+
+	Without ax_thread, adding and removing filters is *NOT* thread safe. This
+	should then be done prior to any multi-threaded logging operations.
+
+	Logging *is* thread safe (as long as your filters are thread safe). In
+	asynchronous mode filters are only ever called from one thread at a time.
+
+
+	ASYNCHRONOUS LOGGING
+	====================
+
+	By default every report runs through the filters on the thread that
+	submitted it. After `axlog_async_start()` a report is instead copied
+	(strings included) into a lock-free ring buffer owned by the submitting
+	thread, and a single background thread runs the filters in submission
+	order. Logging then costs a copy and a read of the CPU's cycle counter
+	(`axth_get_cpu_cycles()`, which the background thread converts to time),
+	and filters never run concurrently with each other.
+
+	On Windows and Linux (4.14 and later) the ring buffer is published with
+	plain stores; the background thread makes them visible with a process-wide
+	barrier (`FlushProcessWriteBuffers()` or `membarrier()`) before it sleeps
+	and when the backend stops. Elsewhere a report costs a few atomic
+	operations more.
+
+	The submitting thread still captures its system information (see
+	`axlogf_sysinfo`), so thread IDs and error codes are those of the caller.
+
+	When a ring buffer is full the overflow policy decides what happens:
+
+		- `axlog_overflow_drop` discards the report.
+		- `axlog_overflow_block` waits for the background thread to make room.
+		- `axlog_overflow_count` discards the report; the background thread
+		  then submits a warning saying how many reports were lost.
+
+	`axlog_async_flush()` waits (up to a timeout) until every report submitted
+	before the call has been through the filters. If the background thread is
+	idle the caller drains the queues itself, so this is also suitable for crash
+	handlers. Panic reports (`axlogp_panic`) are flushed automatically.
+
+	`axlog_async_get_stats()` returns counters, including the time reports spent
+	queued before being dispatched.
+
+	Notes:
+
+		- Filters see a copy of the report, so changes they make are not seen
+		  by the submitter, and `axlog_submit_report()` cannot know whether a
+		  filter will reject a queued report.
+		- Reports submitted from the background thread (by a filter) are
+		  dispatched immediately.
+		- Ring buffers are kept for reuse when their thread exits and when
+		  `axlog_async_stop()` is called. On Windows a ring buffer belongs to a
+		  fiber rather than a thread.
+
+
+	DEFERRED FORMATTING
+	===================
+
+	`axlog_deferf()` (or `AXLOG_DEFER()`) takes the same arguments as
+	`axlog_submitf()`, but while the asynchronous backend is running it only
+	copies the format's arguments into the ring buffer (see `axpackf()` in
+	ax_printf) and leaves the formatting to the background thread. The message
+	comes out exactly as `axspfv()` would have made it at the time of the call,
+	extensions such as arrays (`%[3]f`) and `%m` included. Strings and arrays
+	the format refers to are copied, but the format string, file name, and
+	function name are not; they must stay valid, as string literals do.
+
+	A sink installed with `axlog_set_deferred_sink()` sees each deferred report
+	before it is formatted, packed arguments and all. Returning `axlog_cancel`
+	skips the formatting and the filters, so a sink can store the packed form
+	and have it formatted later, or by another program, with `axspkf()`.
+	Packed arguments use the host's type sizes, so that program has to be
+	built for the same platform.
+
+	`axlog_defercf()` (or `AXLOG_DEFERC()`) does the same with a compiled format
+	(see COMPILED FORMATS), so the arguments are packed without parsing the
+	format again. The compiled format must stay valid until the report has
+	been processed; `AXPF_FORMAT( "..." )` always does. A deferred sink sees
+	its source string as `pszFmt`.
+
+	When the backend isn't running, or AXLOG_DEFERRED_ENABLED is 0,
+	`axlog_deferf()` does the same as `axlog_submitf()`, and `axlog_defercf()`
+	the same as `axlog_submitcf()`.
+
+
+	COMPILED FORMATS
+	================
+
+	`axlog_submitcf()` (or `AXLOG_SUBMITC()`) takes a format compiled ahead of
+	time by `axpf_compile()` in place of the format string, so the format is
+	not parsed again on each call. The message is the same as `axlog_submitf()`
+	would have made with the source string.
+
+	In C++14 the format can instead be `AXPF_FORMAT( "..." )`, which is parsed
+	while compiling, and the arguments are checked against it:
 
-	Logging *is* thread safe (as long as your filters are thread safe).
+		AXLOG_SUBMITC( axlogp_info, AXPF_FORMAT( "%u items in %s" ), n, name );
 
 
 	INTERACTIONS
@@ -156,7 +310,14 @@
 	ax_printf
 	---------
 	Used by axlogf() if available. This can be disabled by defining
-	`AXLOG_NO_AXPF` prior to including this file.
+	`AXLOG_NO_AXPF` prior to including this file. Deferred formatting relies
+	on its packed arguments.
+
+	ax_thread
+	---------
+	Provides the background thread and atomics for asynchronous logging. It
+	will be included automatically on compilers with `__has_include` unless
+	AXLOG_ASYNC_ENABLED is 0.
 
 
 	LICENSE
@@ -193,6 +354,9 @@
 # if !AXLOG_NO_PF && __has_include( "ax_printf.h" )
 #  include "ax_printf.h"
 # endif
+# if ( !defined( AXLOG_ASYNC_ENABLED ) || AXLOG_ASYNC_ENABLED ) && __has_include( "ax_thread.h" )
+#  include "ax_thread.h"
+# endif
 #endif
 
 #ifndef AXLOG_TYPES_DEFINED
@@ -319,6 +483,27 @@ ax_static_assert( sizeof( axlog_u32_t ) == 4, "ax_logger: axlog_u32_t has invali
 # endif
 #endif
 
+/* determine whether the asynchronous backend is available */
+#ifndef AXLOG_ASYNC_ENABLED
+# ifdef INCGUARD_AX_THREAD_H_
+#  define AXLOG_ASYNC_ENABLED 1
+# else
+#  define AXLOG_ASYNC_ENABLED 0
+# endif
+#endif
+#if AXLOG_ASYNC_ENABLED && !defined( INCGUARD_AX_THREAD_H_ )
+# error ax_logger: AXLOG_ASYNC_ENABLED requires ax_thread.h
+#endif
+#ifndef AXLOG_ASYNC_RING_SIZE
+# define AXLOG_ASYNC_RING_SIZE 65536
+#endif
+#if AXLOG_ASYNC_RING_SIZE & ( AXLOG_ASYNC_RING_SIZE - 1 )
+# error ax_logger: AXLOG_ASYNC_RING_SIZE must be a power of two
+#endif
+#ifndef AXLOG_ASYNC_IDLE_SPIN_COUNT
+# define AXLOG_ASYNC_IDLE_SPIN_COUNT 64
+#endif
+
 /* determine the operating system */
 #ifndef AXLOG_OS_DEFINED
 # ifdef INCGUARD_AX_PLATFORM_H_
@@ -372,6 +557,18 @@ ax_static_assert( sizeof( axlog_u32_t ) == 4, "ax_logger: axlog_u32_t has invali
 # if AXLOG_OS_MACOSX
 #  include <pthread.h>
 # endif
+# if defined( _MSC_VER )
+#  include <intrin.h>
+# endif
+# if AXLOG_ASYNC_ENABLED
+#  include <stddef.h>
+#  include <stdlib.h>
+#  include <string.h>
+#  if !AXLOG_OS_WINDOWS
+#   include <pthread.h>
+#   include <time.h>
+#  endif
+# endif
 #endif
 
 /* printf()-like routines */
@@ -427,6 +624,39 @@ ax_static_assert( sizeof( axlog_u32_t ) == 4, "ax_logger: axlog_u32_t has invali
 # endif
 #endif
 
+/* determine whether reports can be submitted with compiled formats */
+#ifndef AXLOG_SNPRINTCFV
+# if !AXLOG_NO_PF
+#  define AXLOG_SNPRINTCFV axspcfv
+# endif
+#endif
+#ifndef AXLOG_COMPILED_ENABLED
+# if defined( AXLOG_SNPRINTCFV ) && !AXLOG_CUSTOM_VARARGS
+#  define AXLOG_COMPILED_ENABLED 1
+# else
+#  define AXLOG_COMPILED_ENABLED 0
+# endif
+#endif
+#if AXLOG_COMPILED_ENABLED && !defined( AXLOG_SNPRINTCFV )
+# error ax_logger: AXLOG_COMPILED_ENABLED requires AXLOG_SNPRINTCFV (or ax_printf)
+#endif
+
+/* determine whether reports can be queued before being formatted */
+#ifndef AXLOG_DEFERRED_ENABLED
+# if AXLOG_ASYNC_ENABLED && !AXLOG_NO_PF && !AXLOG_CUSTOM_VARARGS
+#  define AXLOG_DEFERRED_ENABLED 1
+# else
+#  define AXLOG_DEFERRED_ENABLED 0
+# endif
+#endif
+#if AXLOG_DEFERRED_ENABLED && ( !AXLOG_ASYNC_ENABLED || AXLOG_NO_PF || AXLOG_CUSTOM_VARARGS )
+# error ax_logger: AXLOG_DEFERRED_ENABLED requires the asynchronous backend, ax_printf, and <stdarg.h>
+#endif
+
+#ifndef AXLOG_FMTBUF_SIZE
+# define AXLOG_FMTBUF_SIZE 1024
+#endif
+
 /* VS style */
 #ifndef AXLOG_VS_STYLE
 # if AXLOG_OS_WINDOWS
@@ -769,7 +999,13 @@ typedef enum axlog_result_e
 	axlog_result_filternotfound,
 
 	/* operation was cancelled by a filter */
-	axlog_result_rejected
+	axlog_result_rejected,
+	/* report was discarded because the asynchronous queue was full */
+	axlog_result_dropped,
+	/* operation did not complete in the time allowed */
+	axlog_result_timeout,
+	/* report was discarded because no filter wants its priority and facility */
+	axlog_result_disabled
 } axlog_result_t;
 #define AXLOG_SUCCEEDED(X_)\
 	(((axlog_result_t)(X_))==axlog_result_ok)
@@ -797,6 +1033,80 @@ typedef enum axlog_send_e
 /* filter used for handling reports - 99% of the time, return `axlog_forward` */
 typedef axlog_send_t( AXLOG_CALL *axlog_filter_t )( void *, axlog_report_t *, const axlog_sysinfo_t * );
 
+/* bit representing a priority within a set of priorities (e.g., axlogp_info) */
+#define AXLOG_PRIORITY_BIT(Prio_)\
+	( 1U << ( ( (Prio_) & AXLOG_PRIORITY_MASK ) >> 6 ) )
+/* set of priorities at or above the given one */
+#define AXLOG_PRIORITIES_FROM(Prio_)\
+	( AXLOG_ALL_PRIORITIES & ~( AXLOG_PRIORITY_BIT(Prio_) - 1 ) )
+/* set of every priority */
+#define AXLOG_ALL_PRIORITIES 0xFFU
+
+/* reports a filter wants to receive */
+typedef struct axlog_interest_s
+{
+	/* set of priorities (see AXLOG_PRIORITY_BIT) wanted from each facility */
+	axlog_u8_t priorities[ AXLOG_FACILITY_MASK + 1 ];
+} axlog_interest_t;
+
+#if AXLOG_ASYNC_ENABLED
+/* what to do with a report when the submitting thread's ring buffer is full */
+typedef enum axlog_overflow_e
+{
+	/* discard the report */
+	axlog_overflow_drop,
+	/* wait until the background thread has made room */
+	axlog_overflow_block,
+	/* discard the report, and later submit a warning with the number lost */
+	axlog_overflow_count
+} axlog_overflow_t;
+
+/* counters for the asynchronous backend (approximate while it is running) */
+typedef struct axlog_async_stats_s
+{
+	/* reports copied into a ring buffer */
+	axth_u64_t submitted;
+	/* queued reports that have been through the filters */
+	axth_u64_t processed;
+	/* reports discarded because a ring buffer was full */
+	axth_u64_t dropped;
+	/* reports that had to wait for room in a ring buffer */
+	axth_u64_t blocked;
+	/* reports too large for a ring buffer, dispatched by the caller */
+	axth_u64_t direct;
+	/* total time processed reports spent queued, in nanoseconds */
+	axth_u64_t totalLatencyNs;
+	/* longest time a processed report spent queued, in nanoseconds */
+	axth_u64_t maxLatencyNs;
+	/* number of ring buffers (at most one per thread that has logged) */
+	axth_u32_t rings;
+} axlog_async_stats_t;
+#endif
+
+#if AXLOG_DEFERRED_ENABLED
+/* a report queued by axlog_deferf(), as seen by a deferred sink */
+typedef struct axlog_deferred_s
+{
+	/* the report's flags */
+	axlog_u16_t            flags;
+	/* arguments passed to axlog_deferf() (the strings are not copies) */
+	axlog_u32_t            line;
+	const char *           pszFile;
+	const char *           pszFunc;
+	const char *           pszFmt;
+	/* time the report was submitted, in nanoseconds (monotonic, converted from the cycle counter) */
+	axth_u64_t             timeNs;
+	/* packed arguments for pszFmt (see axpackf() and axspkf()) */
+	const void *           pArgs;
+	axlog_uptr_t           cArgs;
+	/* captured by the submitter if flags include axlogf_sysinfo, else NULL */
+	const axlog_sysinfo_t *pSysInfo;
+} axlog_deferred_t;
+
+/* sees deferred reports before they're formatted; `axlog_cancel` stops them there */
+typedef axlog_send_t( AXLOG_CALL *axlog_deferred_sink_t )( void *, const axlog_deferred_t * );
+#endif
+
 
 
 
@@ -822,6 +1132,9 @@ AXLOG_FUNC const char *AXLOG_CALL axlog_result_to_string( axlog_result_t r )
 	case axlog_result_filternotfound: return "filternotfound";
 
 	case axlog_result_rejected:       return "rejected";
+	case axlog_result_dropped:        return "dropped";
+	case axlog_result_timeout:        return "timeout";
+	case axlog_result_disabled:       return "disabled";
 	}
 
 	return "(unknown)";
@@ -830,6 +1143,25 @@ AXLOG_FUNC const char *AXLOG_CALL axlog_result_to_string( axlog_result_t r )
 ;
 #endif
 
+/* priorities that no filter wants, for each facility (see AXLOG_IS_ENABLED) */
+AXLOG_FUNC volatile axlog_u8_t axlog__g_disabled[ AXLOG_FACILITY_MASK + 1 ];
+#if AXLOG_IMPLEMENT
+volatile axlog_u8_t axlog__g_disabled[ AXLOG_FACILITY_MASK + 1 ];
+#endif
+
+/* whether a report with the given flags would reach any filter */
+#define AXLOG_IS_ENABLED(Flags_)\
+	( !( axlog__g_disabled[ (Flags_) & AXLOG_FACILITY_MASK ] & AXLOG_PRIORITY_BIT(Flags_) ) )
+
+AXLOG_FUNC axlog_bool_t AXLOG_CALL axlog_is_enabled( axlog_u16_t flags )
+#if AXLOG_IMPLEMENT
+{
+	return AXLOG_IS_ENABLED( flags );
+}
+#else
+;
+#endif
+
 #if AXLOG_IMPLEMENT
 
 # ifndef AXLOG_MAX_FILTERS
@@ -841,6 +1173,18 @@ AXLOG_FUNC const char *AXLOG_CALL axlog_result_to_string( axlog_result_t r )
 
 # define AXLOG__MAX_FACILITIES (AXLOG_FACILITY_MASK+1)
 
+# define AXLOG__CACHE_LINE 64
+
+/* filter registry can be changed while other threads log (needs ax_thread) */
+# if defined( INCGUARD_AX_THREAD_H_ )
+#  define AXLOG__SYNC_FILTERS 1
+# else
+#  define AXLOG__SYNC_FILTERS 0
+# endif
+
+/* number of separately counted groups of readers (must be a power of two) */
+# define AXLOG__READER_STRIPES 8
+
 struct axlog__filter_item_s;
 typedef struct axlog__filter_item_s axlog__filter_item_t;
 
@@ -848,27 +1192,67 @@ struct axlog__filter_item_s
 {
 	axlog_filter_t        pfnFilter;
 	void *                pUserData;
-	axlog__filter_item_t *pNext;
+	axlog_filter_type_t   type;
+	volatile axlog_u8_t   Wanted[ AXLOG__MAX_FACILITIES ];
 };
 
+/*
+	Immutable list of the installed filters, in calling order
+
+	Managers come first, then endpoints; within each group the most recently
+	added filter is first. Readers only ever see a published set, which is
+	never written to again until every reader that could have seen it is gone.
+*/
+typedef struct axlog__filter_set_s
+{
+	/* number of managers (the endpoints start at this index) */
+	axlog_u32_t                 cManagers;
+	/* total number of filters in the set */
+	axlog_u32_t                 cItems;
+	/* the filters */
+	const axlog__filter_item_t *pItems[ AXLOG_MAX_FILTERS ];
+} axlog__filter_set_t;
+
+/* count of readers for each grace period parity, one cache line per stripe */
+typedef struct axlog__reader_stripe_s
+{
+	volatile axlog_u32_t cReaders[ 2 ];
+	axlog_u8_t           Pad[ AXLOG__CACHE_LINE - 8 ];
+} axlog__reader_stripe_t;
+
 static axlog__filter_item_t  axlog__g_filters[ AXLOG_MAX_FILTERS ];
 static axlog_u32_t           axlog__g_usedFilters[ AXLOG__NUM_MASKS ];
 static axlog_u32_t           axlog__g_cFilters = 0;
 
-static axlog__filter_item_t *axlog__g_pEndpointHead = (axlog__filter_item_t*)0;
-static axlog__filter_item_t *axlog__g_pPassthruHead = (axlog__filter_item_t*)0;
+static axlog__filter_set_t           axlog__g_filterSets[ 2 ];
+static axlog__filter_set_t *volatile axlog__g_pFilterSet = &axlog__g_filterSets[ 0 ];
+# if AXLOG__SYNC_FILTERS
+static axth_amutex_t                 axlog__g_filterLock = AXTHREAD_AMUTEX_INITIALIZER;
+static axlog__reader_stripe_t        axlog__g_readers[ AXLOG__READER_STRIPES ];
+static volatile axlog_u32_t          axlog__g_uReaderEpoch = 0;
+# endif
 
 static const char *          axlog__g_pszFacilities[ AXLOG__MAX_FACILITIES ];
 static axlog_u32_t           axlog__g_cFacilities = 0;
 
-static axlog__filter_item_t **axlog__get_filter_list( axlog_filter_type_t t )
+/* index of the lowest set bit (x must not be zero) */
+static axlog_u32_t AXLOG_CALL axlog__ctz32( axlog_u32_t x )
 {
-	switch( t ) {
-	case axlog_filter_endpoint: return &axlog__g_pEndpointHead;
-	case axlog_filter_manager:  return &axlog__g_pPassthruHead;
-	}
+# if defined( _MSC_VER )
+	unsigned long i;
+
+	_BitScanForward( &i, ( unsigned long )x );
+	return ( axlog_u32_t )i;
+# elif defined( __GNUC__ ) || defined( __clang__ )
+	return ( axlog_u32_t )__builtin_ctz( x );
+# else
+	static const axlog_u8_t debruijn[ 32 ] = {
+		 0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+		31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+	};
 
-	return ( axlog__filter_item_t ** )0;
+	return debruijn[ ( ( x & ( 0U - x ) )*0x077CB531U ) >> 27 ];
+# endif
 }
 
 static void AXLOG_CALL axlog__set_used_filter( axlog_u32_t i )
@@ -888,19 +1272,158 @@ static axlog_u32_t AXLOG_CALL axlog__find_free_filter( void )
 			continue;
 		}
 
-		/* FIXME: Use the faster bit-search method */
-		for( j = 0; j < AXLOG__MASK_BITS; ++j ) {
-			if( ~axlog__g_usedFilters[i] & (1U<<j) ) {
-				continue;
-			}
+		j = i*AXLOG__MASK_BITS + axlog__ctz32( ~axlog__g_usedFilters[i] );
+		return j < AXLOG_MAX_FILTERS ? j : ~0U;
+	}
+
+	return ~0U;
+}
+
+/* serialize changes to the registry */
+static void AXLOG_CALL axlog__lock_filters( void )
+{
+# if AXLOG__SYNC_FILTERS
+	axth_amutex_acquire( &axlog__g_filterLock, AXTHREAD_DEFAULT_SPIN_COUNT );
+# endif
+}
+static void AXLOG_CALL axlog__unlock_filters( void )
+{
+# if AXLOG__SYNC_FILTERS
+	axth_amutex_release( &axlog__g_filterLock );
+# endif
+}
+
+/*
+	Begin reading the registry; returns a token to pass to axlog__leave_filters
+
+	Each reader counts itself in the current parity of the grace period. If a
+	writer flipped the parity in the meantime the count is moved, so a writer
+	waiting on the old parity never misses a reader that took the old set.
+*/
+static axlog_u32_t AXLOG_CALL axlog__enter_filters( void )
+{
+# if AXLOG__SYNC_FILTERS
+	axlog_u32_t uStripe, uEpoch;
+
+	/* threads have distinct stacks, so this spreads them over the stripes */
+	uStripe = ( ( axlog_u32_t )( ( axlog_uptr_t )&uEpoch >> 12 )*0x9E3779B9U ) >> 29;
+	uStripe &= AXLOG__READER_STRIPES - 1;
+
+	for(;;) {
+		uEpoch = axlog__g_uReaderEpoch & 1;
+		( void )AX_ATOMIC_FETCH_ADD_FULL32( &axlog__g_readers[ uStripe ].cReaders[ uEpoch ], 1 );
+		if( ( axlog__g_uReaderEpoch & 1 ) == uEpoch ) {
+			break;
+		}
+
+		( void )AX_ATOMIC_FETCH_SUB_FULL32( &axlog__g_readers[ uStripe ].cReaders[ uEpoch ], 1 );
+	}
+
+	return uStripe*2 + uEpoch;
+# else
+	return 0;
+# endif
+}
+/* finish reading the registry */
+static void AXLOG_CALL axlog__leave_filters( axlog_u32_t uToken )
+{
+# if AXLOG__SYNC_FILTERS
+	( void )AX_ATOMIC_FETCH_SUB_FULL32( &axlog__g_readers[ uToken/2 ].cReaders[ uToken%2 ], 1 );
+# else
+	( void )uToken;
+# endif
+}
+
+/* publish a new set then wait until no reader can still see the old one */
+static void AXLOG_CALL axlog__publish_filters( axlog__filter_set_t *pSet )
+{
+# if AXLOG__SYNC_FILTERS
+	axlog_u32_t uEpoch, i, cSpins;
+
+	( void )AX_ATOMIC_EXCHANGE_FULLPTR( &axlog__g_pFilterSet, pSet );
+
+	uEpoch = AX_ATOMIC_FETCH_ADD_FULL32( &axlog__g_uReaderEpoch, 1 ) & 1;
+	for( i = 0; i < AXLOG__READER_STRIPES; ++i ) {
+		cSpins = 1;
+		while( axlog__g_readers[ i ].cReaders[ uEpoch ] != 0 ) {
+			axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+		}
+	}
+# else
+	axlog__g_pFilterSet = pSet;
+# endif
+}
+
+/* the set not currently published (only valid while the registry is locked) */
+static axlog__filter_set_t *AXLOG_CALL axlog__spare_filters( void )
+{
+	return axlog__g_pFilterSet == &axlog__g_filterSets[ 0 ] ? &axlog__g_filterSets[ 1 ] : &axlog__g_filterSets[ 0 ];
+}
+
+/* find a filter in the given set; returns the index or ~0 */
+static axlog_u32_t AXLOG_CALL axlog__find_filter( const axlog__filter_set_t *pSet, axlog_filter_type_t type, axlog_filter_t pfnFilter, void *pUserParm )
+{
+	axlog_u32_t i;
 
-			return i*AXLOG__MASK_BITS + j;
+	for( i = 0; i < pSet->cItems; ++i ) {
+		const axlog__filter_item_t *const p = pSet->pItems[ i ];
+
+		if( p->type == type && p->pfnFilter == pfnFilter && p->pUserData == pUserParm ) {
+			return i;
 		}
 	}
 
 	return ~0U;
 }
 
+/* recalculate axlog__g_disabled from the published set */
+static void AXLOG_CALL axlog__update_enabled( void )
+{
+	const axlog__filter_set_t *const pSet = axlog__g_pFilterSet;
+	axlog_u32_t i, j, wanted;
+
+	for( i = 0; i < AXLOG__MAX_FACILITIES; ++i ) {
+		wanted = 0;
+
+		/* the default endpoint wants everything */
+		if( pSet->cManagers == pSet->cItems ) {
+			wanted = AXLOG_ALL_PRIORITIES;
+		}
+
+		for( j = 0; j < pSet->cItems && wanted != AXLOG_ALL_PRIORITIES; ++j ) {
+			wanted |= pSet->pItems[ j ]->Wanted[ i ];
+		}
+
+		axlog__g_disabled[ i ] = ( axlog_u8_t )( ~wanted & AXLOG_ALL_PRIORITIES );
+	}
+}
+
+#endif
+
+/* set an interest to the given priorities (see AXLOG_PRIORITY_BIT) for every facility */
+AXLOG_FUNC axlog_interest_t *AXLOG_CALL axlog_interest_init( axlog_interest_t *pDst, axlog_u32_t priorities )
+#if AXLOG_IMPLEMENT
+{
+	axlog_u32_t i;
+
+	for( i = 0; i < AXLOG_FACILITY_MASK + 1; ++i ) {
+		pDst->priorities[ i ] = ( axlog_u8_t )( priorities & AXLOG_ALL_PRIORITIES );
+	}
+
+	return pDst;
+}
+#else
+;
+#endif
+/* set the priorities an interest wants from one facility */
+AXLOG_FUNC axlog_interest_t *AXLOG_CALL axlog_interest_set( axlog_interest_t *pDst, axlog_u32_t uFacility, axlog_u32_t priorities )
+#if AXLOG_IMPLEMENT
+{
+	pDst->priorities[ uFacility & AXLOG_FACILITY_MASK ] = ( axlog_u8_t )( priorities & AXLOG_ALL_PRIORITIES );
+	return pDst;
+}
+#else
+;
 #endif
 
 /* possible results from trying to add a filter */
@@ -913,49 +1436,81 @@ typedef enum axlog_add_filter_result_e
 	axlog_add_filter_result_filterexists   = axlog_result_filterexists
 } axlog_add_filter_result_t;
 
-/* add a filter */
-AXLOG_FUNC axlog_add_filter_result_t AXLOG_CALL axlog_add_filter( axlog_filter_type_t type, axlog_filter_t pfnFilter, void *pUserParm )
+/* add a filter that only receives the reports described by pInterest (NULL for all) */
+AXLOG_FUNC axlog_add_filter_result_t AXLOG_CALL axlog_add_filter_ex( axlog_filter_type_t type, axlog_filter_t pfnFilter, void *pUserParm, const axlog_interest_t *pInterest )
 #if AXLOG_IMPLEMENT
 {
+	const axlog__filter_set_t *pOld;
+	axlog__filter_set_t *pNew;
 	axlog__filter_item_t *p;
-	axlog__filter_item_t **ppList;
-	axlog_u32_t i;
+	axlog_u32_t i, j, n;
 
 	if( !pfnFilter ) {
 		return axlog_add_filter_result_badarg;
 	}
 
-	if( !( ppList = axlog__get_filter_list( type ) ) ) {
+	if( type != axlog_filter_endpoint && type != axlog_filter_manager ) {
 		return axlog_add_filter_result_badarg;
 	}
 
-	if( axlog__g_cFilters == AXLOG_MAX_FILTERS ) {
-		return axlog_add_filter_result_toomanyfilters;
-	}
-	if( ( i = axlog__find_free_filter() ) == ~0U ) {
-		return axlog_add_filter_result_toomanyfilters;
+	axlog__lock_filters();
+
+	pOld = axlog__g_pFilterSet;
+
+	if( axlog__find_filter( pOld, type, pfnFilter, pUserParm ) != ~0U ) {
+		axlog__unlock_filters();
+		return axlog_add_filter_result_filterexists;
 	}
 
-	for( p = *ppList; p != ( axlog__filter_item_t * )0; p = p->pNext ) {
-		if( p->pfnFilter == pfnFilter && p->pUserData == pUserParm ) {
-			return axlog_add_filter_result_filterexists;
-		}
+	if( axlog__g_cFilters == AXLOG_MAX_FILTERS || ( i = axlog__find_free_filter() ) == ~0U ) {
+		axlog__unlock_filters();
+		return axlog_add_filter_result_toomanyfilters;
 	}
 
+	/* no published set refers to a free slot, so it can be written now */
 	p = &axlog__g_filters[ i ];
 	p->pfnFilter = pfnFilter;
 	p->pUserData = pUserParm;
-	p->pNext     = *ppList;
-	*ppList = p;
+	p->type      = type;
+	for( j = 0; j < AXLOG__MAX_FACILITIES; ++j ) {
+		p->Wanted[ j ] = !pInterest ? AXLOG_ALL_PRIORITIES : pInterest->priorities[ j ];
+	}
+
+	/* the new filter goes first within its group */
+	n = type == axlog_filter_manager ? 0 : pOld->cManagers;
+
+	pNew = axlog__spare_filters();
+	for( j = 0; j < n; ++j ) {
+		pNew->pItems[ j ] = pOld->pItems[ j ];
+	}
+	pNew->pItems[ n ] = p;
+	for( j = n; j < pOld->cItems; ++j ) {
+		pNew->pItems[ j + 1 ] = pOld->pItems[ j ];
+	}
+	pNew->cManagers = pOld->cManagers + ( type == axlog_filter_manager ? 1 : 0 );
+	pNew->cItems    = pOld->cItems + 1;
 
 	axlog__set_used_filter( i );
 	++axlog__g_cFilters;
 
+	axlog__publish_filters( pNew );
+	axlog__update_enabled();
+	axlog__unlock_filters();
+
 	return axlog_add_filter_result_ok;
 }
 #else
 ;
 #endif
+/* add a filter */
+AXLOG_FUNC axlog_add_filter_result_t AXLOG_CALL axlog_add_filter( axlog_filter_type_t type, axlog_filter_t pfnFilter, void *pUserParm )
+#if AXLOG_IMPLEMENT
+{
+	return axlog_add_filter_ex( type, pfnFilter, pUserParm, ( const axlog_interest_t * )0 );
+}
+#else
+;
+#endif
 
 /* possible results from trying to remove a filter */
 typedef enum axlog_remove_filter_result_e
@@ -966,35 +1521,90 @@ typedef enum axlog_remove_filter_result_e
 	axlog_remove_filter_result_filternotfound = axlog_result_filternotfound
 } axlog_remove_filter_result_t;
 
-/* remove a filter */
+/* remove a filter; once this returns the filter is no longer being called */
 AXLOG_FUNC axlog_remove_filter_result_t AXLOG_CALL axlog_remove_filter( axlog_filter_type_t type, axlog_filter_t pfnFilter, void *pUserParm )
 #if AXLOG_IMPLEMENT
 {
-	axlog__filter_item_t *p, *prior;
-	axlog__filter_item_t **ppList;
-	axlog_u32_t i;
+	const axlog__filter_set_t *pOld;
+	axlog__filter_set_t *pNew;
+	axlog_u32_t i, j, n;
 
-	if( !pfnFilter || !( ppList = axlog__get_filter_list( type ) ) ) {
+	if( !pfnFilter || ( type != axlog_filter_endpoint && type != axlog_filter_manager ) ) {
 		return axlog_remove_filter_result_badarg;
 	}
 
-	prior = ( axlog__filter_item_t * )0;
-	for( p = *ppList; p != ( axlog__filter_item_t * )0; prior=p, p=p->pNext ) {
-		if( p->pfnFilter != pfnFilter || p->pUserData != pUserParm ) {
-			continue;
-		}
+	axlog__lock_filters();
 
-		if( prior != ( axlog__filter_item_t * )0 ) {
-			prior->pNext = p->pNext;
-		}
+	pOld = axlog__g_pFilterSet;
+
+	if( ( n = axlog__find_filter( pOld, type, pfnFilter, pUserParm ) ) == ~0U ) {
+		axlog__unlock_filters();
+		return axlog_remove_filter_result_filternotfound;
+	}
+
+	i = ( axlog_u32_t )( axlog_uptr_t )( pOld->pItems[ n ] - &axlog__g_filters[0] );
+
+	pNew = axlog__spare_filters();
+	for( j = 0; j < n; ++j ) {
+		pNew->pItems[ j ] = pOld->pItems[ j ];
+	}
+	for( j = n + 1; j < pOld->cItems; ++j ) {
+		pNew->pItems[ j - 1 ] = pOld->pItems[ j ];
+	}
+	pNew->cManagers = pOld->cManagers - ( type == axlog_filter_manager ? 1 : 0 );
+	pNew->cItems    = pOld->cItems - 1;
 
-		i = ( axlog_u32_t )( axlog_uptr_t )( p - &axlog__g_filters[0] );
-		axlog__clear_used_filter( i );
-		--axlog__g_cFilters;
-		return axlog_remove_filter_result_ok;
+	/* the slot is only reused after the readers of the old set are done */
+	axlog__publish_filters( pNew );
+	axlog__update_enabled();
+
+	axlog__clear_used_filter( i );
+	--axlog__g_cFilters;
+
+	axlog__unlock_filters();
+	return axlog_remove_filter_result_ok;
+}
+#else
+;
+#endif
+
+/* possible results from trying to change which reports a filter receives */
+typedef enum axlog_set_filter_interest_result_e
+{
+	axlog_set_filter_interest_result_ok             = axlog_result_ok,
+
+	axlog_set_filter_interest_result_badarg         = axlog_result_badarg,
+	axlog_set_filter_interest_result_filternotfound = axlog_result_filternotfound
+} axlog_set_filter_interest_result_t;
+
+/* change which reports a filter receives (pInterest can be NULL for all) */
+AXLOG_FUNC axlog_set_filter_interest_result_t AXLOG_CALL axlog_set_filter_interest( axlog_filter_type_t type, axlog_filter_t pfnFilter, void *pUserParm, const axlog_interest_t *pInterest )
+#if AXLOG_IMPLEMENT
+{
+	axlog__filter_item_t *p;
+	axlog_u32_t i;
+
+	if( !pfnFilter ) {
+		return axlog_set_filter_interest_result_badarg;
 	}
 
-	return axlog_remove_filter_result_filternotfound;
+	axlog__lock_filters();
+
+	if( ( i = axlog__find_filter( axlog__g_pFilterSet, type, pfnFilter, pUserParm ) ) == ~0U ) {
+		axlog__unlock_filters();
+		return axlog_set_filter_interest_result_filternotfound;
+	}
+
+	/* readers may briefly see a mix of the old and new interests */
+	p = ( axlog__filter_item_t * )axlog__g_pFilterSet->pItems[ i ];
+	for( i = 0; i < AXLOG__MAX_FACILITIES; ++i ) {
+		p->Wanted[ i ] = !pInterest ? AXLOG_ALL_PRIORITIES : pInterest->priorities[ i ];
+	}
+
+	axlog__update_enabled();
+	axlog__unlock_filters();
+
+	return axlog_set_filter_interest_result_ok;
 }
 #else
 ;
@@ -1389,66 +1999,1270 @@ typedef enum axlog_submit_report_result_e
 	axlog_submit_report_result_ok       = axlog_result_ok,
 
 	axlog_submit_report_result_badarg   = axlog_result_badarg,
-	axlog_submit_report_result_rejected = axlog_result_rejected
+	axlog_submit_report_result_rejected = axlog_result_rejected,
+	axlog_submit_report_result_dropped  = axlog_result_dropped,
+	axlog_submit_report_result_disabled = axlog_result_disabled
 } axlog_submit_report_result_t;
 
-/* submit a report */
-AXLOG_FUNC axlog_submit_report_result_t AXLOG_CALL axlog_submit_report( axlog_report_t *pInoutReport )
 #if AXLOG_IMPLEMENT
+/* run a report through the filters on the calling thread */
+static axlog_submit_report_result_t AXLOG_CALL axlog__dispatch_report( axlog_report_t *pReport, const axlog_sysinfo_t *q )
 {
-	axlog__filter_item_t *p;
-	axlog_sysinfo_t si, *q;
+	const axlog__filter_set_t *pSet;
+	axlog_submit_report_result_t r;
+	axlog_u32_t uToken, i;
 
-	if( !pInoutReport || ( !pInoutReport->msg.s && axlog_get_cause( pInoutReport ) < axlogc_nomem ) ) {
-		return axlog_submit_report_result_badarg;
-	}
+	r = axlog_submit_report_result_ok;
 
-	q = ( axlog_sysinfo_t * )0;
-	if( pInoutReport->flags & axlogf_sysinfo ) {
-		axlog__capture_sysinfo( &si );
-		q = &si;
-	}
+	uToken = axlog__enter_filters();
+	pSet   = axlog__g_pFilterSet;
 
-	for( p = axlog__g_pPassthruHead; p != ( axlog__filter_item_t * )0; p = p->pNext ) {
-		if( p->pfnFilter( p->pUserData, pInoutReport, q ) == axlog_cancel ) {
-			return axlog_submit_report_result_rejected;
-		}
-	}
+	for( i = 0; i < pSet->cItems; ++i ) {
+		const axlog__filter_item_t *const p = pSet->pItems[ i ];
 
-	if( !axlog__g_pEndpointHead ) {
-		if( axlog__default_endpoint_filter( ( void * )0, pInoutReport, q ) == axlog_cancel ) {
-			return axlog_submit_report_result_rejected;
+		if( !( p->Wanted[ pReport->flags & AXLOG_FACILITY_MASK ] & AXLOG_PRIORITY_BIT( pReport->flags ) ) ) {
+			continue;
 		}
 
-		return axlog_submit_report_result_ok;
+		if( p->pfnFilter( p->pUserData, pReport, q ) == axlog_cancel ) {
+			r = axlog_submit_report_result_rejected;
+			break;
+		}
 	}
 
-	for( p = axlog__g_pEndpointHead; p != ( axlog__filter_item_t * )0; p = p->pNext ) {
-		if( p->pfnFilter( p->pUserData, pInoutReport, q ) == axlog_cancel ) {
-			return axlog_submit_report_result_rejected;
+	if( i == pSet->cItems && pSet->cManagers == pSet->cItems ) {
+		if( axlog__default_endpoint_filter( ( void * )0, pReport, q ) == axlog_cancel ) {
+			r = axlog_submit_report_result_rejected;
 		}
 	}
 
-	return axlog_submit_report_result_ok;
+	axlog__leave_filters( uToken );
+	return r;
 }
-#else
-;
 #endif
 
-/* possible results from trying to initialize a report */
-typedef enum axlog_init_report_result_e
+#if AXLOG_IMPLEMENT && AXLOG_ASYNC_ENABLED
+# ifndef axlog_alloc
+#  define axlog_alloc(N_)           (malloc((N_)))
+# endif
+# ifndef axlog_free
+#  define axlog_free(P_)            (free((P_)))
+# endif
+
+# define AXLOG__ASYNC_MASK          ( ( axth_u32_t )( AXLOG_ASYNC_RING_SIZE - 1 ) )
+# define AXLOG__ASYNC_MAX_RECORD    ( ( axth_u32_t )( AXLOG_ASYNC_RING_SIZE/4 ) )
+# define AXLOG__ASYNC_ALIGN(N_)     ( ( (N_) + 7 ) & ~( axlog_uptr_t )7 )
+# define AXLOG__ASYNC_NUM_STRS      6
+# define AXLOG__ASYNC_PANIC_MS      1000
+
+/* timestamp of a record; the consumer converts it to nanoseconds (see axlog__async_calibrate()) */
+# define AXLOG__ASYNC_TICKS()       axth_get_cpu_cycles()
+
+/* order everything the producer did before the plain store that follows */
+# if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+#  define AXLOG__ASYNC_RELEASE()    _ReadWriteBarrier()
+# elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+#  define AXLOG__ASYNC_RELEASE()    __asm__ __volatile__( "" : : : "memory" )
+# elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __aarch64__ )
+#  define AXLOG__ASYNC_RELEASE()    __asm__ __volatile__( "dmb ish" : : : "memory" )
+# else
+#  define AXLOG__ASYNC_RELEASE()    AX_MEMORY_BARRIER()
+# endif
+
+/* membarrier() commands (see axlog__async_fence_producers()) */
+# if AXLOG_OS_LINUX && defined( SYS_membarrier )
+#  define AXLOG__ASYNC_MEMBARRIER   1
+#  define AXLOG__ASYNC_MEMBARRIER_PRIVATE_EXPEDITED          ( 1 << 3 )
+#  define AXLOG__ASYNC_MEMBARRIER_REGISTER_PRIVATE_EXPEDITED ( 1 << 4 )
+# else
+#  define AXLOG__ASYNC_MEMBARRIER   0
+# endif
+
+/* kind of a record within a ring buffer */
+typedef enum axlog__async_kind_e
+{
+	/* unused space at the end of the buffer; the next record is at the start */
+	axlog__async_pad = 1,
+	/* a copied report */
+	axlog__async_report,
+	/* an unformatted report (see axlog__async_deferred_t) */
+	axlog__async_deferred
+} axlog__async_kind_t;
+
+/* header of a record in a ring buffer; the report's strings follow it */
+typedef struct axlog__async_record_s
 {
-	axlog_init_report_result_ok     = axlog_result_ok,
+	/* size of the record in bytes, including the header (multiple of 8) */
+	axth_u32_t      cBytes;
+	/* see axlog__async_kind_t */
+	axlog_u16_t     uKind;
+	/* the report's flags */
+	axlog_u16_t     flags;
+	/* time the report was submitted (see AXLOG__ASYNC_TICKS()) */
+	axth_u64_t      uTime;
+	/* captured by the submitter if flags include axlogf_sysinfo */
+	axlog_sysinfo_t SysInfo;
+	/* line information */
+	axlog_u32_t     line;
+	axlog_u32_t     column;
+	axlog_u32_t     rangeStart;
+	axlog_u32_t     rangeCount;
+	axlog_u32_t     rangePoint;
+	/* length+1 of mod, msg, file, func, expr, and linetext (0 if null) */
+	axlog_u32_t     cStrs[ AXLOG__ASYNC_NUM_STRS ];
+} axlog__async_record_t;
+
+struct axlog__async_ring_s;
+typedef struct axlog__async_ring_s axlog__async_ring_t;
+
+/* single-producer single-consumer queue of records */
+struct axlog__async_ring_s
+{
+	/* written by the consumer: position of the next record to process */
+	volatile axth_u32_t  uRead;
+	/* consumer's copy of cDropped, as of the last overflow warning */
+	axth_u32_t           cDropsSeen;
+	axlog_u8_t           Pad0[ AXLOG__CACHE_LINE - 8 ];
+
+	/* written by the producer: position after the last published record */
+	volatile axth_u32_t  uWrite;
+	/* producer's last reading of uRead (never ahead of it) */
+	axth_u32_t           uCachedRead;
+	/* set while the producer is using the ring (see axlog_async_stop()) */
+	volatile axth_u32_t  bBusy;
+	/* statistics */
+	volatile axth_u32_t  cSubmitted;
+	volatile axth_u32_t  cDropped;
+	volatile axth_u32_t  cBlocked;
+	volatile axth_u32_t  cDirect;
+	axth_u32_t           uReserved;
+	axlog_u8_t           Pad1[ AXLOG__CACHE_LINE - 32 ];
+
+	/* set while a thread owns the ring */
+	volatile axth_u32_t  bOwned;
+	axth_u32_t           uReserved2;
+	/* next ring in the list (fixed once the ring has been published) */
+	axlog__async_ring_t *pNext;
+	axlog_u8_t           Pad2[ AXLOG__CACHE_LINE - 8 - sizeof( void * ) ];
+
+	/* records */
+	axlog_u8_t           Data[ AXLOG_ASYNC_RING_SIZE ];
+};
 
-	axlog_init_report_result_badarg = axlog_result_badarg
-} axlog_init_report_result_t;
+/* state of the asynchronous backend */
+typedef struct axlog__async_s
+{
+	/* all rings ever allocated (rings are only freed by the C runtime) */
+	axlog__async_ring_t *volatile pRings;
+	/* set while reports should be queued */
+	volatile axth_u32_t           bActive;
+	/* set when the background thread should exit */
+	volatile axth_u32_t           bQuit;
+	/* set by the background thread as it exits */
+	volatile axth_u32_t           bExited;
+	/* see axlog_overflow_t */
+	volatile axth_u32_t           uOverflow;
+	/* held by whoever is processing records (background thread or a flush) */
+	volatile axth_u32_t           uConsumer;
+	/* non-zero while the background thread is about to sleep or sleeping */
+	volatile axth_u32_t           cSleeping;
+	/* set once a producer has signalled the sleeping background thread */
+	volatile axth_u32_t           bWakePending;
+	/* set once the thread-local key has been created */
+	axth_u32_t                    bHaveKey;
+	/* set if producers can use plain stores (see axlog__async_fence_producers()) */
+	volatile axth_u32_t           bFenced;
+
+	axth_sem_t                    WakeSem;
+	axthread_t                    Thread;
+
+	/* statistics (written by the consumer) */
+	axth_u64_t                    cProcessed;
+	axth_u64_t                    uTotalLatency;
+	axth_u64_t                    uMaxLatency;
+
+	/* calibration (consumer only): ticks and time at the start, and the rate between them */
+	axth_u64_t                    uBaseTicks;
+	axth_u64_t                    uBaseNanos;
+	double                        fNanosPerTick;
+
+# if AXLOG_DEFERRED_ENABLED
+	/* see axlog_set_deferred_sink() (changed only while holding uConsumer) */
+	axlog_deferred_sink_t         pfnDeferredSink;
+	void *                        pDeferredSinkData;
+# endif
+} axlog__async_t;
 
-/* initialize a report */
-AXLOG_FUNC axlog_init_report_result_t
-AXLOG_CALL axlog_init_reportexv
-(
-	char *             pszDstMsg,
-	axlog_uptr_t       cDstMsg,
+static axlog__async_t axlog__g_async;
+
+/* thread-local value of the background thread; its reports are never queued */
+# define AXLOG__ASYNC_WORKER        ( ( axlog__async_ring_t * )( void * )&axlog__g_async )
+
+# if AXLOG_OS_WINDOWS
+static DWORD         axlog__g_dwAsyncKey  = FLS_OUT_OF_INDEXES;
+static LARGE_INTEGER axlog__g_asyncFreq;
+#  define AXLOG__ASYNC_GET_RING()   ( ( axlog__async_ring_t * )FlsGetValue( axlog__g_dwAsyncKey ) )
+#  define AXLOG__ASYNC_SET_RING(P_) ( ( void )FlsSetValue( axlog__g_dwAsyncKey, ( void * )(P_) ) )
+# else
+static pthread_key_t axlog__g_asyncKey;
+#  define AXLOG__ASYNC_GET_RING()   ( ( axlog__async_ring_t * )pthread_getspecific( axlog__g_asyncKey ) )
+#  define AXLOG__ASYNC_SET_RING(P_) ( ( void )pthread_setspecific( axlog__g_asyncKey, ( const void * )(P_) ) )
+# endif
+
+/* monotonic time in nanoseconds */
+static axth_u64_t AXLOG_CALL axlog__async_now( void )
+{
+# if AXLOG_OS_WINDOWS
+	LARGE_INTEGER t;
+	axth_u64_t    f;
+
+	QueryPerformanceCounter( &t );
+	f = ( axth_u64_t )axlog__g_asyncFreq.QuadPart;
+
+	return ( ( axth_u64_t )t.QuadPart/f )*1000000000 + ( ( axth_u64_t )t.QuadPart%f )*1000000000/f;
+# else
+	struct timespec t;
+
+	clock_gettime( CLOCK_MONOTONIC, &t );
+	return ( axth_u64_t )t.tv_sec*1000000000 + ( axth_u64_t )t.tv_nsec;
+# endif
+}
+
+/* measure the rate of AXLOG__ASYNC_TICKS() since the backend started (consumer only) */
+static void AXLOG_CALL axlog__async_calibrate( void )
+{
+	axth_u64_t uNanos, uTicks;
+
+	uNanos = axlog__async_now();
+	uTicks = AXLOG__ASYNC_TICKS();
+
+	if( uTicks > axlog__g_async.uBaseTicks && uNanos > axlog__g_async.uBaseNanos ) {
+		axlog__g_async.fNanosPerTick = ( double )( uNanos - axlog__g_async.uBaseNanos )/( double )( uTicks - axlog__g_async.uBaseTicks );
+	}
+}
+
+/* convert a number of ticks to nanoseconds (consumer only) */
+static axth_u64_t AXLOG_CALL axlog__async_ticks_to_ns( axth_u64_t cTicks )
+{
+	return ( axth_u64_t )( ( double )cTicks*axlog__g_async.fNanosPerTick );
+}
+
+/* make the producers' plain stores visible to the calling thread (no-op unless bFenced is set) */
+static void AXLOG_CALL axlog__async_fence_producers( void )
+{
+	if( !axlog__g_async.bFenced ) {
+		return;
+	}
+
+# if AXLOG_OS_WINDOWS
+	FlushProcessWriteBuffers();
+# elif AXLOG__ASYNC_MEMBARRIER
+	( void )syscall( SYS_membarrier, AXLOG__ASYNC_MEMBARRIER_PRIVATE_EXPEDITED, 0 );
+# endif
+}
+
+/* determine whether axlog__async_fence_producers() can stand in for the producers' barriers */
+static axth_u32_t AXLOG_CALL axlog__async_init_fence( void )
+{
+# if AXLOG_OS_WINDOWS
+	return 1;
+# elif AXLOG__ASYNC_MEMBARRIER
+	return syscall( SYS_membarrier, AXLOG__ASYNC_MEMBARRIER_REGISTER_PRIVATE_EXPEDITED, 0 ) == 0;
+# else
+	return 0;
+# endif
+}
+
+/* give up a ring as its thread (or fiber) exits */
+# if AXLOG_OS_WINDOWS
+static VOID NTAPI axlog__async_release_ring( PVOID pRing )
+# else
+static void axlog__async_release_ring( void *pRing )
+# endif
+{
+	axlog__async_ring_t *r;
+
+	r = ( axlog__async_ring_t * )pRing;
+	if( !r || r == AXLOG__ASYNC_WORKER ) {
+		return;
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_REL32( &r->bOwned, 0 );
+}
+
+/* create the thread-local key that maps threads to rings */
+static int AXLOG_CALL axlog__async_init_key( void )
+{
+	if( axlog__g_async.bHaveKey ) {
+		return 1;
+	}
+
+# if AXLOG_OS_WINDOWS
+	if( !QueryPerformanceFrequency( &axlog__g_asyncFreq ) ) {
+		return 0;
+	}
+	if( ( axlog__g_dwAsyncKey = FlsAlloc( &axlog__async_release_ring ) ) == FLS_OUT_OF_INDEXES ) {
+		return 0;
+	}
+# else
+	if( pthread_key_create( &axlog__g_asyncKey, &axlog__async_release_ring ) != 0 ) {
+		return 0;
+	}
+# endif
+
+	axlog__g_async.bHaveKey = 1;
+	return 1;
+}
+
+/* retrieve the calling thread's ring, adopting or allocating one if needed */
+static axlog__async_ring_t *AXLOG_CALL axlog__async_ring( void )
+{
+	axlog__async_ring_t *r;
+	axlog__async_ring_t *pHead;
+
+	if( ( r = AXLOG__ASYNC_GET_RING() ) != ( axlog__async_ring_t * )0 ) {
+		return r == AXLOG__ASYNC_WORKER ? ( axlog__async_ring_t * )0 : r;
+	}
+
+	/* reuse the ring of a thread that has exited; its contents remain queued */
+	for( r = axlog__g_async.pRings; r != ( axlog__async_ring_t * )0; r = r->pNext ) {
+		if( !r->bOwned && AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &r->bOwned, 1, 0 ) == 0 ) {
+			break;
+		}
+	}
+
+	if( !r ) {
+		if( !( r = ( axlog__async_ring_t * )axlog_alloc( sizeof( *r ) ) ) ) {
+			return ( axlog__async_ring_t * )0;
+		}
+
+		memset( ( void * )r, 0, offsetof( axlog__async_ring_t, Data ) );
+		r->bOwned = 1;
+
+		do {
+			pHead = axlog__g_async.pRings;
+			r->pNext = pHead;
+		} while( AX_ATOMIC_COMPARE_EXCHANGE_FULLPTR( &axlog__g_async.pRings, r, pHead ) != ( void * )pHead );
+	}
+
+	AXLOG__ASYNC_SET_RING( r );
+	return r;
+}
+
+/* wake the background thread if it is asleep */
+static void AXLOG_CALL axlog__async_wake( void )
+{
+	if( axlog__g_async.cSleeping != 0 && AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.bWakePending, 1 ) == 0 ) {
+		axth_sem_signal( &axlog__g_async.WakeSem );
+	}
+}
+
+/* length of a report string (only meaningful if s is set) */
+static axlog_uptr_t AXLOG_CALL axlog__async_strlen( const axlog_str_t *p )
+{
+	if( !p->s ) {
+		return 0;
+	}
+	if( p->e != ( const char * )0 ) {
+		return ( axlog_uptr_t )( p->e - p->s );
+	}
+
+	return ( axlog_uptr_t )strlen( p->s );
+}
+
+/* result of trying to queue a report */
+typedef enum axlog__async_queue_e
+{
+	/* the report was copied into the calling thread's ring */
+	axlog__async_queued,
+	/* the ring was full and the report was discarded */
+	axlog__async_dropped,
+	/* the report has to be dispatched by the caller */
+	axlog__async_direct
+} axlog__async_queue_t;
+
+/* claim the calling thread's ring; NULL if the report has to be dispatched directly */
+static axlog__async_ring_t *AXLOG_CALL axlog__async_begin( void )
+{
+	axlog__async_ring_t *r;
+
+	if( !( r = axlog__async_ring() ) ) {
+		return ( axlog__async_ring_t * )0;
+	}
+
+	/* announce ourselves before checking that the backend is still running (see axlog_async_stop()) */
+	if( axlog__g_async.bFenced ) {
+		r->bBusy = 1;
+	} else {
+		( void )AX_ATOMIC_EXCHANGE_FULL32( &r->bBusy, 1 );
+	}
+	if( !axlog__g_async.bActive ) {
+		AXLOG__ASYNC_RELEASE();
+		r->bBusy = 0;
+		return ( axlog__async_ring_t * )0;
+	}
+
+	return r;
+}
+/* release a ring claimed by axlog__async_begin() */
+static void AXLOG_CALL axlog__async_end( axlog__async_ring_t *r )
+{
+	AXLOG__ASYNC_RELEASE();
+	r->bBusy = 0;
+}
+
+/* make room for a record of cBytes (at most AXLOG__ASYNC_MAX_RECORD); NULL if it must be dropped */
+static axlog__async_record_t *AXLOG_CALL axlog__async_reserve( axlog__async_ring_t *r, axth_u32_t cBytes, axth_u32_t *puNext )
+{
+	axlog__async_record_t *pRec;
+	axth_u32_t             uWrite, uOffset, cTail, cNeed;
+	axth_u32_t             cSpins;
+	int                    bBlocked;
+
+	/* a record that would straddle the end of the buffer starts over at the beginning instead */
+	uWrite  = r->uWrite;
+	uOffset = uWrite & AXLOG__ASYNC_MASK;
+	cTail   = AXLOG_ASYNC_RING_SIZE - uOffset;
+	cNeed   = cBytes > cTail ? cTail + cBytes : cBytes;
+
+	bBlocked = 0;
+	cSpins   = 1;
+	while( uWrite + cNeed - r->uCachedRead > AXLOG_ASYNC_RING_SIZE ) {
+		r->uCachedRead = r->uRead;
+		AX_COMPILER_FENCE();
+
+		if( uWrite + cNeed - r->uCachedRead <= AXLOG_ASYNC_RING_SIZE ) {
+			break;
+		}
+
+		if( axlog__g_async.uOverflow != axlog_overflow_block ) {
+			r->cDropped = r->cDropped + 1;
+			return ( axlog__async_record_t * )0;
+		}
+
+		if( !bBlocked ) {
+			r->cBlocked = r->cBlocked + 1;
+			bBlocked = 1;
+		}
+
+		axlog__async_wake();
+		axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	}
+
+	if( cBytes > cTail ) {
+		pRec = ( axlog__async_record_t * )&r->Data[ uOffset ];
+		pRec->cBytes = cTail;
+		pRec->uKind  = axlog__async_pad;
+		uOffset = 0;
+	}
+
+	pRec = ( axlog__async_record_t * )&r->Data[ uOffset ];
+	pRec->cBytes = cBytes;
+
+	*puNext = uWrite + cNeed;
+	return pRec;
+}
+/* publish the record from axlog__async_reserve() and release the ring */
+static void AXLOG_CALL axlog__async_commit( axlog__async_ring_t *r, axth_u32_t uNext )
+{
+	/* publish before the sleep check below; the background thread fences between announcing its sleep and its last look */
+	if( axlog__g_async.bFenced ) {
+		AXLOG__ASYNC_RELEASE();
+		r->uWrite = uNext;
+	} else {
+		( void )AX_ATOMIC_EXCHANGE_FULL32( &r->uWrite, uNext );
+	}
+	r->cSubmitted = r->cSubmitted + 1;
+
+	axlog__async_wake();
+	axlog__async_end( r );
+}
+
+/* copy a report into the calling thread's ring */
+static axlog__async_queue_t AXLOG_CALL axlog__async_enqueue( const axlog_report_t *pReport, const axlog_sysinfo_t *q )
+{
+	axlog__async_ring_t *  r;
+	axlog__async_record_t *pRec;
+	const axlog_str_t *    pStrs[ AXLOG__ASYNC_NUM_STRS ];
+	axlog_uptr_t           cStrs[ AXLOG__ASYNC_NUM_STRS ];
+	axlog_uptr_t           cBytes;
+	axlog_u8_t *           pDst;
+	axth_u32_t             uNext;
+	unsigned               i;
+
+	if( !( r = axlog__async_begin() ) ) {
+		return axlog__async_direct;
+	}
+
+	pStrs[ 0 ] = &pReport->mod;
+	pStrs[ 1 ] = &pReport->msg;
+	pStrs[ 2 ] = &pReport->info.file;
+	pStrs[ 3 ] = &pReport->info.func;
+	pStrs[ 4 ] = &pReport->info.expr;
+	pStrs[ 5 ] = &pReport->info.range.linetext;
+
+	cBytes = sizeof( axlog__async_record_t );
+	for( i = 0; i < AXLOG__ASYNC_NUM_STRS; ++i ) {
+		cStrs[ i ] = axlog__async_strlen( pStrs[ i ] );
+		if( pStrs[ i ]->s != ( const char * )0 ) {
+			cBytes += cStrs[ i ] + 1;
+		}
+	}
+	cBytes = AXLOG__ASYNC_ALIGN( cBytes );
+
+	if( cBytes > AXLOG__ASYNC_MAX_RECORD ) {
+		r->cDirect = r->cDirect + 1;
+		axlog__async_end( r );
+		return axlog__async_direct;
+	}
+
+	if( !( pRec = axlog__async_reserve( r, ( axth_u32_t )cBytes, &uNext ) ) ) {
+		axlog__async_end( r );
+		return axlog__async_dropped;
+	}
+
+	pRec->uKind      = axlog__async_report;
+	pRec->flags      = pReport->flags;
+	pRec->uTime      = AXLOG__ASYNC_TICKS();
+	pRec->line       = pReport->info.line;
+	pRec->column     = pReport->info.column;
+	pRec->rangeStart = pReport->info.range.start;
+	pRec->rangeCount = pReport->info.range.count;
+	pRec->rangePoint = pReport->info.range.point;
+	if( q != ( const axlog_sysinfo_t * )0 ) {
+		pRec->SysInfo = *q;
+	}
+
+	pDst = ( axlog_u8_t * )( pRec + 1 );
+	for( i = 0; i < AXLOG__ASYNC_NUM_STRS; ++i ) {
+		if( !pStrs[ i ]->s ) {
+			pRec->cStrs[ i ] = 0;
+			continue;
+		}
+
+		memcpy( ( void * )pDst, ( const void * )pStrs[ i ]->s, cStrs[ i ] );
+		pDst[ cStrs[ i ] ] = '\0';
+		pDst += cStrs[ i ] + 1;
+
+		pRec->cStrs[ i ] = ( axlog_u32_t )( cStrs[ i ] + 1 );
+	}
+
+	axlog__async_commit( r, uNext );
+	return axlog__async_queued;
+}
+
+# if AXLOG_DEFERRED_ENABLED
+/* follows the header of a deferred record; the packed arguments (see axpackf) come after it */
+typedef struct axlog__async_deferred_s
+{
+	/* arguments of axlog_deferf() (not copied) */
+	const char *         pszFmt;
+	const char *         pszFile;
+	const char *         pszFunc;
+	/* format passed to axlog_defercf() (not copied), else NULL */
+	const axpf_format_t *pCompiled;
+	/* size of the packed arguments in bytes */
+	axlog_u32_t          cArgs;
+	axlog_u32_t          uReserved;
+} axlog__async_deferred_t;
+
+/* offset of the packed arguments within a deferred record */
+#  define AXLOG__ASYNC_DEFERRED_HEADER\
+	( ( axth_u32_t )AXLOG__ASYNC_ALIGN( sizeof( axlog__async_record_t ) + sizeof( axlog__async_deferred_t ) ) )
+
+/* pack a deferred report's arguments with whichever form of the format there is */
+static axpf_ptrdiff_t AXLOG_CALL axlog__async_pack( void *pDst, axth_u32_t cDst, const char *pszFmt, const axpf_format_t *pCompiled, va_list fmtArgs )
+{
+	if( pCompiled != ( const axpf_format_t * )0 ) {
+		return axpackcfv( pDst, cDst, pCompiled, fmtArgs );
+	}
+
+	return axpackfv( pDst, cDst, pszFmt, fmtArgs );
+}
+
+/* pack a report's arguments into the calling thread's ring (pCompiled may be NULL) */
+static axlog__async_queue_t AXLOG_CALL axlog__async_enqueue_deferred
+(
+	axlog_u16_t            flags,
+	const char *           pszFile,
+	axlog_u32_t            line,
+	const char *           pszFunc,
+	const char *           pszFmt,
+	const axpf_format_t *  pCompiled,
+	va_list                fmtArgs,
+	const axlog_sysinfo_t *q
+)
+{
+	axlog__async_ring_t *    r;
+	axlog__async_record_t *  pRec;
+	axlog__async_deferred_t *d;
+	axpf_ptrdiff_t           cArgs;
+	axth_u32_t               uWrite, uNext, cRoom, cBytes;
+
+	if( !( r = axlog__async_begin() ) ) {
+		return axlog__async_direct;
+	}
+
+	/* pack straight into the space known to be free; this usually fits, saving a pass over the arguments */
+	uWrite = r->uWrite;
+	cRoom  = AXLOG_ASYNC_RING_SIZE - ( uWrite & AXLOG__ASYNC_MASK );
+	if( cRoom > AXLOG_ASYNC_RING_SIZE - ( uWrite - r->uCachedRead ) ) {
+		cRoom = AXLOG_ASYNC_RING_SIZE - ( uWrite - r->uCachedRead );
+	}
+	if( cRoom > AXLOG__ASYNC_MAX_RECORD ) {
+		cRoom = AXLOG__ASYNC_MAX_RECORD;
+	}
+
+	pRec = ( axlog__async_record_t * )&r->Data[ uWrite & AXLOG__ASYNC_MASK ];
+	if( cRoom > AXLOG__ASYNC_DEFERRED_HEADER ) {
+		cArgs = axlog__async_pack( ( void * )( ( axlog_u8_t * )pRec + AXLOG__ASYNC_DEFERRED_HEADER ), cRoom - AXLOG__ASYNC_DEFERRED_HEADER, pszFmt, pCompiled, fmtArgs );
+	} else {
+		cArgs = axlog__async_pack( ( void * )0, 0, pszFmt, pCompiled, fmtArgs );
+	}
+
+	if( cArgs < 0 || ( axlog_uptr_t )cArgs > AXLOG__ASYNC_MAX_RECORD ) {
+		r->cDirect = r->cDirect + 1;
+		axlog__async_end( r );
+		return axlog__async_direct;
+	}
+
+	cBytes = ( axth_u32_t )AXLOG__ASYNC_ALIGN( AXLOG__ASYNC_DEFERRED_HEADER + ( axth_u32_t )cArgs );
+	if( cBytes > AXLOG__ASYNC_MAX_RECORD ) {
+		r->cDirect = r->cDirect + 1;
+		axlog__async_end( r );
+		return axlog__async_direct;
+	}
+
+	if( cBytes <= cRoom ) {
+		pRec->cBytes = cBytes;
+		uNext = uWrite + cBytes;
+	} else {
+		if( !( pRec = axlog__async_reserve( r, cBytes, &uNext ) ) ) {
+			axlog__async_end( r );
+			return axlog__async_dropped;
+		}
+
+		( void )axlog__async_pack( ( void * )( ( axlog_u8_t * )pRec + AXLOG__ASYNC_DEFERRED_HEADER ), cBytes - AXLOG__ASYNC_DEFERRED_HEADER, pszFmt, pCompiled, fmtArgs );
+	}
+
+	pRec->uKind = axlog__async_deferred;
+	pRec->flags = flags;
+	pRec->uTime = AXLOG__ASYNC_TICKS();
+	pRec->line  = line;
+	if( q != ( const axlog_sysinfo_t * )0 ) {
+		pRec->SysInfo = *q;
+	}
+
+	d = ( axlog__async_deferred_t * )( pRec + 1 );
+	d->pszFmt    = pszFmt;
+	d->pszFile   = pszFile;
+	d->pszFunc   = pszFunc;
+	d->pCompiled = pCompiled;
+	d->cArgs     = ( axlog_u32_t )cArgs;
+
+	axlog__async_commit( r, uNext );
+	return axlog__async_queued;
+}
+# endif
+
+/* find the next record of a ring, skipping padding (consumer only) */
+static axlog__async_record_t *AXLOG_CALL axlog__async_peek( axlog__async_ring_t *r )
+{
+	axlog__async_record_t *pRec;
+	axth_u32_t             uRead;
+
+	for(;;) {
+		uRead = r->uRead;
+		if( uRead == r->uWrite ) {
+			return ( axlog__async_record_t * )0;
+		}
+		AX_COMPILER_FENCE();
+
+		pRec = ( axlog__async_record_t * )&r->Data[ uRead & AXLOG__ASYNC_MASK ];
+		if( pRec->uKind != axlog__async_pad ) {
+			return pRec;
+		}
+
+		( void )AX_ATOMIC_EXCHANGE_REL32( &r->uRead, uRead + pRec->cBytes );
+	}
+}
+
+/* point a report string at the next string of a record */
+static const char *AXLOG_CALL axlog__async_unpack_str( axlog_str_t *pDst, const char *p, axlog_u32_t cStr )
+{
+	if( !cStr ) {
+		pDst->s = ( const char * )0;
+		pDst->e = ( const char * )0;
+		return p;
+	}
+
+	pDst->s = p;
+	pDst->e = p + ( cStr - 1 );
+	return p + cStr;
+}
+
+# if AXLOG_DEFERRED_ENABLED
+/* format a deferred record and run it through the filters (consumer only) */
+static void AXLOG_CALL axlog__async_process_deferred( const axlog__async_record_t *pRec )
+{
+	const axlog__async_deferred_t *d;
+	const axlog_sysinfo_t *        q;
+	axlog_deferred_t               def;
+	axlog_report_t                 rep;
+	char                           szBuf[ AXLOG_FMTBUF_SIZE ];
+
+	d = ( const axlog__async_deferred_t * )( pRec + 1 );
+	q = ( pRec->flags & axlogf_sysinfo ) ? &pRec->SysInfo : ( const axlog_sysinfo_t * )0;
+
+	if( axlog__g_async.pfnDeferredSink != ( axlog_deferred_sink_t )0 ) {
+		def.flags    = pRec->flags;
+		def.line     = pRec->line;
+		def.pszFile  = d->pszFile;
+		def.pszFunc  = d->pszFunc;
+		def.pszFmt   = d->pszFmt;
+		def.timeNs   = axlog__g_async.uBaseNanos;
+		if( pRec->uTime > axlog__g_async.uBaseTicks ) {
+			def.timeNs += axlog__async_ticks_to_ns( pRec->uTime - axlog__g_async.uBaseTicks );
+		}
+		def.pArgs    = ( const void * )( ( const axlog_u8_t * )pRec + AXLOG__ASYNC_DEFERRED_HEADER );
+		def.cArgs    = d->cArgs;
+		def.pSysInfo = q;
+
+		if( axlog__g_async.pfnDeferredSink( axlog__g_async.pDeferredSinkData, &def ) == axlog_cancel ) {
+			return;
+		}
+	}
+
+	if( d->pCompiled != ( const axpf_format_t * )0 ) {
+		( void )axspkcf( szBuf, sizeof( szBuf ), d->pCompiled, ( const axlog_u8_t * )pRec + AXLOG__ASYNC_DEFERRED_HEADER, d->cArgs );
+	} else {
+		( void )axspkfe( szBuf, sizeof( szBuf ), d->pszFmt, ( const char * )0, ( const axlog_u8_t * )pRec + AXLOG__ASYNC_DEFERRED_HEADER, d->cArgs );
+	}
+
+	rep.flags = pRec->flags;
+
+	rep.mod.s = ( const char * )0;
+	rep.mod.e = ( const char * )0;
+	rep.msg.s = szBuf;
+	rep.msg.e = ( const char * )0;
+
+	rep.info.file.s = d->pszFile;
+	rep.info.file.e = ( const char * )0;
+	rep.info.line   = pRec->line;
+	rep.info.column = 0;
+
+	rep.info.func.s = d->pszFunc;
+	rep.info.func.e = ( const char * )0;
+	rep.info.expr.s = ( const char * )0;
+	rep.info.expr.e = ( const char * )0;
+
+	rep.info.range.linetext.s = ( const char * )0;
+	rep.info.range.linetext.e = ( const char * )0;
+
+	rep.info.range.start = 0;
+	rep.info.range.count = 0;
+	rep.info.range.point = 0;
+
+	( void )axlog__dispatch_report( &rep, q );
+}
+# endif
+
+/* update the statistics for a processed record, then release it (consumer only) */
+static void AXLOG_CALL axlog__async_retire( axlog__async_ring_t *r, const axlog__async_record_t *pRec )
+{
+	axth_u64_t uLatency, uNow;
+
+	uNow = AXLOG__ASYNC_TICKS();
+	uLatency = uNow > pRec->uTime ? axlog__async_ticks_to_ns( uNow - pRec->uTime ) : 0;
+
+	axlog__g_async.cProcessed    = axlog__g_async.cProcessed + 1;
+	axlog__g_async.uTotalLatency = axlog__g_async.uTotalLatency + uLatency;
+	if( axlog__g_async.uMaxLatency < uLatency ) {
+		axlog__g_async.uMaxLatency = uLatency;
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_REL32( &r->uRead, r->uRead + pRec->cBytes );
+}
+
+/* run the next record of a ring through the filters, then release it (consumer only) */
+static void AXLOG_CALL axlog__async_process( axlog__async_ring_t *r, const axlog__async_record_t *pRec )
+{
+	axlog_report_t rep;
+	const char *   p;
+
+# if AXLOG_DEFERRED_ENABLED
+	if( pRec->uKind == axlog__async_deferred ) {
+		axlog__async_process_deferred( pRec );
+		axlog__async_retire( r, pRec );
+		return;
+	}
+# endif
+
+	rep.flags = pRec->flags;
+
+	p = ( const char * )( pRec + 1 );
+	p = axlog__async_unpack_str( &rep.mod, p, pRec->cStrs[ 0 ] );
+	p = axlog__async_unpack_str( &rep.msg, p, pRec->cStrs[ 1 ] );
+	p = axlog__async_unpack_str( &rep.info.file, p, pRec->cStrs[ 2 ] );
+	p = axlog__async_unpack_str( &rep.info.func, p, pRec->cStrs[ 3 ] );
+	p = axlog__async_unpack_str( &rep.info.expr, p, pRec->cStrs[ 4 ] );
+	( void )axlog__async_unpack_str( &rep.info.range.linetext, p, pRec->cStrs[ 5 ] );
+
+	rep.info.line        = pRec->line;
+	rep.info.column      = pRec->column;
+	rep.info.range.start = pRec->rangeStart;
+	rep.info.range.count = pRec->rangeCount;
+	rep.info.range.point = pRec->rangePoint;
+
+	( void )axlog__dispatch_report( &rep, ( pRec->flags & axlogf_sysinfo ) ? &pRec->SysInfo : ( const axlog_sysinfo_t * )0 );
+
+	axlog__async_retire( r, pRec );
+}
+
+/* submit a warning for reports dropped since the last one (consumer only) */
+static void AXLOG_CALL axlog__async_report_drops( void )
+{
+	axlog__async_ring_t *r;
+	axlog_report_t       rep;
+	axth_u32_t           cDropped;
+	char                 szBuf[ 128 ];
+
+	for( r = axlog__g_async.pRings; r != ( axlog__async_ring_t * )0; r = r->pNext ) {
+		cDropped = r->cDropped - r->cDropsSeen;
+		if( !cDropped ) {
+			continue;
+		}
+
+		r->cDropsSeen += cDropped;
+		if( axlog__g_async.uOverflow != axlog_overflow_count ) {
+			continue;
+		}
+
+		AXLOG_SNPRINTF( szBuf, sizeof( szBuf ), "%u report(s) dropped; a ring buffer was full", ( unsigned )cDropped );
+		szBuf[ sizeof( szBuf ) - 1 ] = '\0';
+
+		memset( ( void * )&rep.info, 0, sizeof( rep.info ) );
+		rep.flags = axlogp_warning | axlogc_runtime | AXLOG_DEFAULT_FACILITY;
+		rep.mod.s = "ax_logger";
+		rep.mod.e = ( const char * )0;
+		rep.msg.s = szBuf;
+		rep.msg.e = ( const char * )0;
+
+		( void )axlog__dispatch_report( &rep, ( const axlog_sysinfo_t * )0 );
+	}
+}
+
+/* process queued reports submitted no later than uLimit (in ticks), oldest first (consumer only) */
+static axth_u32_t AXLOG_CALL axlog__async_drain( axth_u64_t uLimit )
+{
+	axlog__async_ring_t *  r, *pBestRing;
+	axlog__async_record_t *pRec, *pBest;
+	axth_u32_t             cProcessed;
+
+	cProcessed = 0;
+	for(;;) {
+		pBestRing = ( axlog__async_ring_t * )0;
+		pBest     = ( axlog__async_record_t * )0;
+
+		/* each ring is in order, so merging on the heads keeps the whole stream in order */
+		for( r = axlog__g_async.pRings; r != ( axlog__async_ring_t * )0; r = r->pNext ) {
+			if( !( pRec = axlog__async_peek( r ) ) || pRec->uTime > uLimit ) {
+				continue;
+			}
+
+			if( !pBest || pRec->uTime < pBest->uTime ) {
+				pBestRing = r;
+				pBest     = pRec;
+			}
+		}
+
+		if( !pBest ) {
+			break;
+		}
+
+		/* remeasure the rate of the timestamps once per pass that has any */
+		if( !cProcessed ) {
+			axlog__async_calibrate();
+		}
+
+		axlog__async_process( pBestRing, pBest );
+		++cProcessed;
+	}
+
+	axlog__async_report_drops();
+	return cProcessed;
+}
+
+/* determine whether every report submitted no later than uLimit (in ticks) has been processed */
+static int AXLOG_CALL axlog__async_is_flushed( axth_u64_t uLimit )
+{
+	axlog__async_ring_t *        r;
+	const axlog__async_record_t *pRec;
+	axth_u32_t                   uRead, uPos;
+	int                          bPending;
+
+	for( r = axlog__g_async.pRings; r != ( axlog__async_ring_t * )0; r = r->pNext ) {
+		do {
+			uRead = r->uRead;
+			uPos  = uRead;
+			AX_COMPILER_FENCE();
+
+			bPending = 0;
+			if( uPos != r->uWrite ) {
+				/* padding is always followed by a record */
+				pRec = ( const axlog__async_record_t * )&r->Data[ uPos & AXLOG__ASYNC_MASK ];
+				if( pRec->uKind == axlog__async_pad ) {
+					uPos += pRec->cBytes;
+					pRec = ( const axlog__async_record_t * )&r->Data[ uPos & AXLOG__ASYNC_MASK ];
+				}
+
+				bPending = pRec->uTime <= uLimit;
+			}
+
+			/* the record may have been overwritten if the consumer moved on */
+			AX_COMPILER_FENCE();
+		} while( r->uRead != uRead );
+
+		if( bPending ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* main loop of the background thread */
+static int AXTHREAD_CALL axlog__async_thread_f( axthread_t *pThread, void *pParm )
+{
+	axth_u32_t cProcessed;
+	axth_u32_t cIdle = 0;
+	axth_u32_t cSpins = 1;
+
+	( void )pThread;
+	( void )pParm;
+
+	AXLOG__ASYNC_SET_RING( AXLOG__ASYNC_WORKER );
+
+	while( !axlog__g_async.bQuit ) {
+		/* a flush is processing records on another thread */
+		if( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &axlog__g_async.uConsumer, 1, 0 ) != 0 ) {
+			axth_yield();
+			continue;
+		}
+
+		cProcessed = axlog__async_drain( ~( axth_u64_t )0 );
+		( void )AX_ATOMIC_EXCHANGE_REL32( &axlog__g_async.uConsumer, 0 );
+
+		if( cProcessed != 0 ) {
+			cIdle = 0;
+			cSpins = 1;
+			continue;
+		}
+
+		/* reports tend to come in bursts; waking up costs the producer a system call */
+		if( ++cIdle < AXLOG_ASYNC_IDLE_SPIN_COUNT ) {
+			axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+			continue;
+		}
+		cIdle = 0;
+		cSpins = 1;
+
+		/* announce the sleep before the final check so producers either see us or we see their report */
+		( void )AX_ATOMIC_FETCH_ADD_FULL32( &axlog__g_async.cSleeping, 1 );
+		axlog__async_fence_producers();
+		if( !axlog__g_async.bQuit && axlog__async_is_flushed( ~( axth_u64_t )0 ) ) {
+			axth_sem_wait( &axlog__g_async.WakeSem );
+		}
+		( void )AX_ATOMIC_FETCH_SUB_FULL32( &axlog__g_async.cSleeping, 1 );
+		( void )AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.bWakePending, 0 );
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.bExited, 1 );
+	return 0;
+}
+#endif
+
+#if AXLOG_ASYNC_ENABLED
+/* possible results from trying to start the asynchronous backend */
+typedef enum axlog_async_start_result_e
+{
+	axlog_async_start_result_ok     = axlog_result_ok,
+
+	axlog_async_start_result_fail   = axlog_result_fail,
+	axlog_async_start_result_badarg = axlog_result_badarg
+} axlog_async_start_result_t;
+
+/*
+ * Start processing reports on a background thread.
+ *
+ * If the backend is already running only the overflow policy is changed. This
+ * is not thread safe with respect to axlog_async_stop().
+ */
+AXLOG_FUNC axlog_async_start_result_t AXLOG_CALL axlog_async_start( axlog_overflow_t overflow )
+#if AXLOG_IMPLEMENT
+{
+	if( overflow != axlog_overflow_drop && overflow != axlog_overflow_block && overflow != axlog_overflow_count ) {
+		return axlog_async_start_result_badarg;
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.uOverflow, ( axth_u32_t )overflow );
+	if( axlog__g_async.bActive ) {
+		return axlog_async_start_result_ok;
+	}
+
+	if( !axlog__async_init_key() ) {
+		return axlog_async_start_result_fail;
+	}
+
+	axlog__g_async.bQuit        = 0;
+	axlog__g_async.bExited      = 0;
+	axlog__g_async.cSleeping    = 0;
+	axlog__g_async.bWakePending = 0;
+
+	/* rings are empty while stopped, so nothing still queued predates the new base */
+	axlog__g_async.uBaseNanos    = axlog__async_now();
+	axlog__g_async.uBaseTicks    = AXLOG__ASYNC_TICKS();
+	axlog__g_async.fNanosPerTick = 1.0;
+
+	if( !axlog__g_async.bFenced ) {
+		axlog__g_async.bFenced = axlog__async_init_fence();
+	}
+
+	if( !axth_sem_init( &axlog__g_async.WakeSem, 0 ) ) {
+		return axlog_async_start_result_fail;
+	}
+	if( !axthread_init_named( &axlog__g_async.Thread, "axlog async", &axlog__async_thread_f, ( void * )0 ) ) {
+		axth_sem_fini( &axlog__g_async.WakeSem );
+		return axlog_async_start_result_fail;
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.bActive, 1 );
+	return axlog_async_start_result_ok;
+}
+#else
+;
+#endif
+
+/*
+ * Stop the background thread after processing every queued report.
+ *
+ * Reports submitted afterward are dispatched by the calling thread again. Must
+ * not be called from a filter.
+ */
+AXLOG_FUNC void AXLOG_CALL axlog_async_stop( void )
+#if AXLOG_IMPLEMENT
+{
+	axlog__async_ring_t *r;
+
+	if( !axlog__g_async.bActive ) {
+		return;
+	}
+
+	/* new reports are dispatched directly; wait out those already being queued */
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.bActive, 0 );
+	axlog__async_fence_producers();
+	for( r = axlog__g_async.pRings; r != ( axlog__async_ring_t * )0; r = r->pNext ) {
+		while( r->bBusy ) {
+			axth_yield();
+		}
+	}
+
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &axlog__g_async.bQuit, 1 );
+	axth_sem_signal( &axlog__g_async.WakeSem );
+	while( !axlog__g_async.bExited ) {
+		axth_yield();
+	}
+	axthread_fini( &axlog__g_async.Thread );
+
+	/* whatever the background thread didn't get to */
+	while( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &axlog__g_async.uConsumer, 1, 0 ) != 0 ) {
+		axth_yield();
+	}
+	( void )axlog__async_drain( ~( axth_u64_t )0 );
+	( void )AX_ATOMIC_EXCHANGE_REL32( &axlog__g_async.uConsumer, 0 );
+
+	axth_sem_fini( &axlog__g_async.WakeSem );
+}
+#else
+;
+#endif
+
+/* determine whether reports are currently being queued */
+AXLOG_FUNC axlog_bool_t AXLOG_CALL axlog_async_is_active( void )
+#if AXLOG_IMPLEMENT
+{
+	return axlog__g_async.bActive != 0;
+}
+#else
+;
+#endif
+
+/* possible results from trying to flush the asynchronous backend */
+typedef enum axlog_async_flush_result_e
+{
+	axlog_async_flush_result_ok      = axlog_result_ok,
+
+	axlog_async_flush_result_timeout = axlog_result_timeout
+} axlog_async_flush_result_t;
+
+/*
+ * Wait until every report submitted before this call has been through the
+ * filters, or until uTimeoutMs milliseconds have passed (~0U waits forever).
+ *
+ * If the background thread isn't busy then the calling thread processes the
+ * queued reports itself. Succeeds immediately when called from a filter or if
+ * the backend isn't running.
+ */
+AXLOG_FUNC axlog_async_flush_result_t AXLOG_CALL axlog_async_flush( axth_u32_t uTimeoutMs )
+#if AXLOG_IMPLEMENT
+{
+	axth_u64_t uLimit, uDeadline;
+
+	if( !axlog__g_async.bActive || AXLOG__ASYNC_GET_RING() == AXLOG__ASYNC_WORKER ) {
+		return axlog_async_flush_result_ok;
+	}
+
+	uLimit = AXLOG__ASYNC_TICKS();
+	uDeadline = uTimeoutMs == ~0U ? ~( axth_u64_t )0 : axlog__async_now() + ( axth_u64_t )uTimeoutMs*1000000;
+
+	for(;;) {
+		if( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &axlog__g_async.uConsumer, 1, 0 ) == 0 ) {
+			( void )axlog__async_drain( uLimit );
+			( void )AX_ATOMIC_EXCHANGE_REL32( &axlog__g_async.uConsumer, 0 );
+			return axlog_async_flush_result_ok;
+		}
+
+		if( axlog__async_is_flushed( uLimit ) ) {
+			return axlog_async_flush_result_ok;
+		}
+		if( axlog__async_now() >= uDeadline ) {
+			return axlog_async_flush_result_timeout;
+		}
+
+		axth_yield();
+	}
+}
+#else
+;
+#endif
+
+/* retrieve the asynchronous backend's counters */
+AXLOG_FUNC void AXLOG_CALL axlog_async_get_stats( axlog_async_stats_t *pDst )
+#if AXLOG_IMPLEMENT
+{
+	axlog__async_ring_t *r;
+
+	if( !pDst ) {
+		return;
+	}
+
+	pDst->submitted      = 0;
+	pDst->processed      = axlog__g_async.cProcessed;
+	pDst->dropped        = 0;
+	pDst->blocked        = 0;
+	pDst->direct         = 0;
+	pDst->totalLatencyNs = axlog__g_async.uTotalLatency;
+	pDst->maxLatencyNs   = axlog__g_async.uMaxLatency;
+	pDst->rings          = 0;
+
+	for( r = axlog__g_async.pRings; r != ( axlog__async_ring_t * )0; r = r->pNext ) {
+		pDst->submitted += r->cSubmitted;
+		pDst->dropped   += r->cDropped;
+		pDst->blocked   += r->cBlocked;
+		pDst->direct    += r->cDirect;
+		++pDst->rings;
+	}
+}
+#else
+;
+#endif
+
+# if AXLOG_DEFERRED_ENABLED
+/*
+ * Set the function that sees deferred reports before they're formatted (NULL
+ * for none).
+ *
+ * Waits for the report being processed, if any. Must not be called from a
+ * filter or from the sink itself.
+ */
+AXLOG_FUNC void AXLOG_CALL axlog_set_deferred_sink( axlog_deferred_sink_t pfnSink, void *pUserParm )
+#if AXLOG_IMPLEMENT
+{
+	while( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &axlog__g_async.uConsumer, 1, 0 ) != 0 ) {
+		axth_yield();
+	}
+
+	axlog__g_async.pfnDeferredSink   = pfnSink;
+	axlog__g_async.pDeferredSinkData = pUserParm;
+
+	( void )AX_ATOMIC_EXCHANGE_REL32( &axlog__g_async.uConsumer, 0 );
+}
+#else
+;
+#endif
+# endif
+#endif
+
+/* submit a report */
+AXLOG_FUNC axlog_submit_report_result_t AXLOG_CALL axlog_submit_report( axlog_report_t *pInoutReport )
+#if AXLOG_IMPLEMENT
+{
+	axlog_sysinfo_t si, *q;
+
+	if( !pInoutReport || ( !pInoutReport->msg.s && axlog_get_cause( pInoutReport ) < axlogc_nomem ) ) {
+		return axlog_submit_report_result_badarg;
+	}
+
+	if( !AXLOG_IS_ENABLED( pInoutReport->flags ) ) {
+		return axlog_submit_report_result_disabled;
+	}
+
+	q = ( axlog_sysinfo_t * )0;
+	if( pInoutReport->flags & axlogf_sysinfo ) {
+		axlog__capture_sysinfo( &si );
+		q = &si;
+	}
+
+# if AXLOG_ASYNC_ENABLED
+	if( axlog__g_async.bActive ) {
+		switch( axlog__async_enqueue( pInoutReport, q ) ) {
+		case axlog__async_queued:
+			if( axlog_get_priority( pInoutReport ) == axlogp_panic ) {
+				( void )axlog_async_flush( AXLOG__ASYNC_PANIC_MS );
+			}
+			return axlog_submit_report_result_ok;
+
+		case axlog__async_dropped:
+			return axlog_submit_report_result_dropped;
+
+		case axlog__async_direct:
+			break;
+		}
+	}
+# endif
+
+	return axlog__dispatch_report( pInoutReport, q );
+}
+#else
+;
+#endif
+
+/* possible results from trying to initialize a report */
+typedef enum axlog_init_report_result_e
+{
+	axlog_init_report_result_ok       = axlog_result_ok,
+
+	axlog_init_report_result_badarg   = axlog_result_badarg,
+	/* the report was initialized, but its message was not formatted */
+	axlog_init_report_result_disabled = axlog_result_disabled
+} axlog_init_report_result_t;
+
+/* initialize a report (the message is left empty if no filter wants it) */
+AXLOG_FUNC axlog_init_report_result_t
+AXLOG_CALL axlog_init_reportexv
+(
+	char *             pszDstMsg,
+	axlog_uptr_t       cDstMsg,
 	axlog_report_t *   pDstReport,
 	axlog_u16_t        flags,
 	const axlog_str_t *pFile,
@@ -1460,11 +3274,19 @@ AXLOG_CALL axlog_init_reportexv
 )
 #if AXLOG_IMPLEMENT
 {
+	axlog_init_report_result_t r;
+
 	if( !pszDstMsg || !cDstMsg || !pDstReport || !pszFmt ) {
 		return axlog_init_report_result_badarg;
 	}
 
-	AXLOG_SNPRINTFV( pszDstMsg, cDstMsg, pszFmt, fmtArgs );
+	r = axlog_init_report_result_ok;
+	if( AXLOG_IS_ENABLED( flags ) ) {
+		AXLOG_SNPRINTFV( pszDstMsg, cDstMsg, pszFmt, fmtArgs );
+	} else {
+		*pszDstMsg = '\0';
+		r = axlog_init_report_result_disabled;
+	}
 
 	pDstReport->flags = flags;
 
@@ -1490,7 +3312,7 @@ AXLOG_CALL axlog_init_reportexv
 	pDstReport->info.range.count = 0;
 	pDstReport->info.range.point = 0;
 
-	return axlog_init_report_result_ok;
+	return r;
 }
 #else
 ;
@@ -1552,11 +3374,19 @@ AXLOG_CALL axlog_init_reportv
 )
 #if AXLOG_IMPLEMENT
 {
+	axlog_init_report_result_t r;
+
 	if( !pszDstMsg || !cDstMsg || !pDstReport || !pszFmt ) {
 		return axlog_init_report_result_badarg;
 	}
 
-	AXLOG_SNPRINTFV( pszDstMsg, cDstMsg, pszFmt, fmtArgs );
+	r = axlog_init_report_result_ok;
+	if( AXLOG_IS_ENABLED( flags ) ) {
+		AXLOG_SNPRINTFV( pszDstMsg, cDstMsg, pszFmt, fmtArgs );
+	} else {
+		*pszDstMsg = '\0';
+		r = axlog_init_report_result_disabled;
+	}
 
 	pDstReport->flags = flags;
 
@@ -1582,7 +3412,7 @@ AXLOG_CALL axlog_init_reportv
 	pDstReport->info.range.count = 0;
 	pDstReport->info.range.point = 0;
 
-	return axlog_init_report_result_ok;
+	return r;
 }
 #else
 ;
@@ -1629,10 +3459,6 @@ AXLOG_CALLF axlog_init_report
 ;
 #endif
 
-#ifndef AXLOG_FMTBUF_SIZE
-# define AXLOG_FMTBUF_SIZE 1024
-#endif
-
 /* log a message (with an expression) */
 AXLOG_FUNC axlog_submit_report_result_t
 AXLOG_CALL axlog_submitexprfv
@@ -1650,6 +3476,10 @@ AXLOG_CALL axlog_submitexprfv
 	axlog_report_t rep;
 	char           szBuf[ AXLOG_FMTBUF_SIZE ];
 
+	if( !AXLOG_IS_ENABLED( flags ) ) {
+		return axlog_submit_report_result_disabled;
+	}
+
 	if
 	(
 		axlog_init_reportv
@@ -1711,6 +3541,10 @@ AXLOG_CALL axlog_submitfv
 	axlog_report_t rep;
 	char           szBuf[ AXLOG_FMTBUF_SIZE ];
 
+	if( !AXLOG_IS_ENABLED( flags ) ) {
+		return axlog_submit_report_result_disabled;
+	}
+
 	if
 	(
 		axlog_init_reportv
@@ -1755,6 +3589,139 @@ AXLOG_CALLF axlog_submitf
 ;
 #endif
 
+#if AXLOG_COMPILED_ENABLED
+/* initialize a report from a compiled format (see axpf_compile) */
+AXLOG_FUNC axlog_init_report_result_t
+AXLOG_CALL axlog_init_reportcv
+(
+	char *               pszDstMsg,
+	axlog_uptr_t         cDstMsg,
+	axlog_report_t *     pDstReport,
+	axlog_u16_t          flags,
+	const char *         pszFile,
+	axlog_u32_t          line,
+	const char *         pszFunc,
+	const char *         pszExpr,
+	const axpf_format_t *pFmt,
+	AXLOG_VA_T           fmtArgs
+)
+# if AXLOG_IMPLEMENT
+{
+	axlog_init_report_result_t r;
+
+	if( !pszDstMsg || !cDstMsg || !pDstReport || !pFmt ) {
+		return axlog_init_report_result_badarg;
+	}
+
+	r = axlog_init_report_result_ok;
+	if( AXLOG_IS_ENABLED( flags ) ) {
+		AXLOG_SNPRINTCFV( pszDstMsg, cDstMsg, pFmt, fmtArgs );
+	} else {
+		*pszDstMsg = '\0';
+		r = axlog_init_report_result_disabled;
+	}
+
+	pDstReport->flags = flags;
+
+	pDstReport->mod.s = ( const char * )0;
+	pDstReport->mod.e = ( const char * )0;
+	pDstReport->msg.s = pszDstMsg;
+	pDstReport->msg.e = ( const char * )0;
+
+	pDstReport->info.file.s = pszFile;
+	pDstReport->info.file.e = ( const char * )0;
+	pDstReport->info.line   = line;
+	pDstReport->info.column = 0;
+
+	pDstReport->info.func.s = pszFunc;
+	pDstReport->info.func.e = ( const char * )0;
+	pDstReport->info.expr.s = pszExpr;
+	pDstReport->info.expr.e = ( const char * )0;
+
+	pDstReport->info.range.linetext.s = ( const char * )0;
+	pDstReport->info.range.linetext.e = ( const char * )0;
+
+	pDstReport->info.range.start = 0;
+	pDstReport->info.range.count = 0;
+	pDstReport->info.range.point = 0;
+
+	return r;
+}
+# else
+;
+# endif
+
+/* log a message with a compiled format (see COMPILED FORMATS) */
+AXLOG_FUNC axlog_submit_report_result_t
+AXLOG_CALL axlog_submitcfv
+(
+	axlog_u16_t          flags,
+	const char *         pszFile,
+	axlog_u32_t          line,
+	const char *         pszFunc,
+	const axpf_format_t *pFmt,
+	AXLOG_VA_T           fmtArgs
+)
+# if AXLOG_IMPLEMENT
+{
+	axlog_report_t rep;
+	char           szBuf[ AXLOG_FMTBUF_SIZE ];
+
+	if( !AXLOG_IS_ENABLED( flags ) ) {
+		return axlog_submit_report_result_disabled;
+	}
+
+	if
+	(
+		axlog_init_reportcv
+		(
+			szBuf, AXLOG_FMTBUF_SIZE,
+			&rep,
+			flags,
+			pszFile, line, pszFunc, ( const char * )0,
+			pFmt, fmtArgs
+		) != axlog_init_report_result_ok
+	) {
+		return axlog_submit_report_result_badarg;
+	}
+
+	return axlog_submit_report( &rep );
+}
+# else
+;
+# endif
+AXLOG_FUNC  axlog_submit_report_result_t
+AXLOG_CALLF axlog_submitcf
+(
+	axlog_u16_t          flags,
+	const char *         pszFile,
+	axlog_u32_t          line,
+	const char *         pszFunc,
+	const axpf_format_t *pFmt,
+	...
+)
+# if AXLOG_IMPLEMENT
+{
+	axlog_submit_report_result_t r;
+	AXLOG_VA_T                   fmtArgs;
+
+	AXLOG_VA_S( fmtArgs, pFmt );
+	r = axlog_submitcfv( flags, pszFile, line, pszFunc, pFmt, fmtArgs );
+	AXLOG_VA_E( fmtArgs );
+
+	return r;
+}
+# else
+;
+# endif
+
+/* log a message from the current source location with axlog_submitcf() */
+# define AXLOG_SUBMITC(Flags_,...)\
+	( !AXLOG_IS_ENABLED( (Flags_) )\
+	? axlog_submit_report_result_disabled\
+	: axlog_submitcf( (Flags_), __FILE__, __LINE__, AXLOG_FUNCTION, __VA_ARGS__ ) )
+#endif /*AXLOG_COMPILED_ENABLED*/
+
 /* log a debug (axlogp_debug) message */
 AXLOG_FUNC axlog_submit_report_result_t
 AXLOG_CALL axlog_debugfv
@@ -2110,6 +4077,185 @@ AXLOG_CALLF axlogf( axlog_u16_t flags, const char *pszFmt, ... )
 ;
 #endif
 
+/*
+ * Log a message, leaving the formatting to the background thread.
+ *
+ * See DEFERRED FORMATTING. `pszFmt`, `pszFile`, and `pszFunc` must stay valid
+ * until the report has been processed (e.g., string literals).
+ */
+AXLOG_FUNC axlog_submit_report_result_t
+AXLOG_CALL axlog_deferfv
+(
+	axlog_u16_t flags,
+	const char *pszFile,
+	axlog_u32_t line,
+	const char *pszFunc,
+	const char *pszFmt,
+	AXLOG_VA_T  fmtArgs
+)
+#if AXLOG_IMPLEMENT
+{
+# if AXLOG_DEFERRED_ENABLED
+	axlog_sysinfo_t si, *q;
+
+	if( !AXLOG_IS_ENABLED( flags ) ) {
+		return axlog_submit_report_result_disabled;
+	}
+
+	if( !pszFmt ) {
+		return axlog_submit_report_result_badarg;
+	}
+
+	if( axlog__g_async.bActive ) {
+		q = ( axlog_sysinfo_t * )0;
+		if( flags & axlogf_sysinfo ) {
+			axlog__capture_sysinfo( &si );
+			q = &si;
+		}
+
+		switch( axlog__async_enqueue_deferred( flags, pszFile, line, pszFunc, pszFmt, ( const axpf_format_t * )0, fmtArgs, q ) ) {
+		case axlog__async_queued:
+			if( ( flags & AXLOG_PRIORITY_MASK ) == axlogp_panic ) {
+				( void )axlog_async_flush( AXLOG__ASYNC_PANIC_MS );
+			}
+			return axlog_submit_report_result_ok;
+
+		case axlog__async_dropped:
+			return axlog_submit_report_result_dropped;
+
+		case axlog__async_direct:
+			break;
+		}
+	}
+# endif
+
+	return axlog_submitfv( flags, pszFile, line, pszFunc, pszFmt, fmtArgs );
+}
+#else
+;
+#endif
+AXLOG_FUNC  axlog_submit_report_result_t
+AXLOG_CALLF axlog_deferf
+(
+	axlog_u16_t flags,
+	const char *pszFile,
+	axlog_u32_t line,
+	const char *pszFunc,
+	const char *pszFmt,
+	...
+)
+#if AXLOG_IMPLEMENT
+{
+	axlog_submit_report_result_t r;
+	AXLOG_VA_T                   fmtArgs;
+
+	AXLOG_VA_S( fmtArgs, pszFmt );
+	r = axlog_deferfv( flags, pszFile, line, pszFunc, pszFmt, fmtArgs );
+	AXLOG_VA_E( fmtArgs );
+
+	return r;
+}
+#else
+;
+#endif
+
+/* log a message from the current source location with axlog_deferf() */
+#define AXLOG_DEFER(Flags_,...)\
+	( !AXLOG_IS_ENABLED( (Flags_) )\
+	? axlog_submit_report_result_disabled\
+	: axlog_deferf( (Flags_), __FILE__, __LINE__, AXLOG_FUNCTION, __VA_ARGS__ ) )
+
+#if AXLOG_COMPILED_ENABLED
+/*
+ * Log a message with a compiled format, leaving the formatting to the
+ * background thread.
+ *
+ * See DEFERRED FORMATTING. `pFmt` must stay valid until the report has been
+ * processed, as must `pszFile` and `pszFunc`.
+ */
+AXLOG_FUNC axlog_submit_report_result_t
+AXLOG_CALL axlog_defercfv
+(
+	axlog_u16_t          flags,
+	const char *         pszFile,
+	axlog_u32_t          line,
+	const char *         pszFunc,
+	const axpf_format_t *pFmt,
+	AXLOG_VA_T           fmtArgs
+)
+# if AXLOG_IMPLEMENT
+{
+#  if AXLOG_DEFERRED_ENABLED
+	axlog_sysinfo_t si, *q;
+
+	if( !AXLOG_IS_ENABLED( flags ) ) {
+		return axlog_submit_report_result_disabled;
+	}
+
+	if( !pFmt ) {
+		return axlog_submit_report_result_badarg;
+	}
+
+	if( axlog__g_async.bActive ) {
+		q = ( axlog_sysinfo_t * )0;
+		if( flags & axlogf_sysinfo ) {
+			axlog__capture_sysinfo( &si );
+			q = &si;
+		}
+
+		switch( axlog__async_enqueue_deferred( flags, pszFile, line, pszFunc, pFmt->pText, pFmt, fmtArgs, q ) ) {
+		case axlog__async_queued:
+			if( ( flags & AXLOG_PRIORITY_MASK ) == axlogp_panic ) {
+				( void )axlog_async_flush( AXLOG__ASYNC_PANIC_MS );
+			}
+			return axlog_submit_report_result_ok;
+
+		case axlog__async_dropped:
+			return axlog_submit_report_result_dropped;
+
+		case axlog__async_direct:
+			break;
+		}
+	}
+#  endif
+
+	return axlog_submitcfv( flags, pszFile, line, pszFunc, pFmt, fmtArgs );
+}
+# else
+;
+# endif
+AXLOG_FUNC  axlog_submit_report_result_t
+AXLOG_CALLF axlog_defercf
+(
+	axlog_u16_t          flags,
+	const char *         pszFile,
+	axlog_u32_t          line,
+	const char *         pszFunc,
+	const axpf_format_t *pFmt,
+	...
+)
+# if AXLOG_IMPLEMENT
+{
+	axlog_submit_report_result_t r;
+	AXLOG_VA_T                   fmtArgs;
+
+	AXLOG_VA_S( fmtArgs, pFmt );
+	r = axlog_defercfv( flags, pszFile, line, pszFunc, pFmt, fmtArgs );
+	AXLOG_VA_E( fmtArgs );
+
+	return r;
+}
+# else
+;
+# endif
+
+/* log a message from the current source location with axlog_defercf() */
+# define AXLOG_DEFERC(Flags_,...)\
+	( !AXLOG_IS_ENABLED( (Flags_) )\
+	? axlog_submit_report_result_disabled\
+	: axlog_defercf( (Flags_), __FILE__, __LINE__, AXLOG_FUNCTION, __VA_ARGS__ ) )
+#endif /*AXLOG_COMPILED_ENABLED*/
+
 
 
 
@@ -2129,6 +4275,20 @@ inline const char *AXLOG_CALL axlog_result_to_string( axlog_remove_filter_result
 {
 	return axlog_result_to_string( axlog_result_t( r ) );
 }
+inline const char *AXLOG_CALL axlog_result_to_string( axlog_set_filter_interest_result_t r )
+{
+	return axlog_result_to_string( axlog_result_t( r ) );
+}
+# if AXLOG_ASYNC_ENABLED
+inline const char *AXLOG_CALL axlog_result_to_string( axlog_async_start_result_t r )
+{
+	return axlog_result_to_string( axlog_result_t( r ) );
+}
+inline const char *AXLOG_CALL axlog_result_to_string( axlog_async_flush_result_t r )
+{
+	return axlog_result_to_string( axlog_result_t( r ) );
+}
+# endif
 inline const char *AXLOG_CALL axlog_result_to_string( axlog_set_facilities_result_t r )
 {
 	return axlog_result_to_string( axlog_result_t( r ) );
@@ -2142,6 +4302,41 @@ inline const char *AXLOG_CALL axlog_result_to_string( axlog_init_report_result_t
 	return axlog_result_to_string( axlog_result_t( r ) );
 }
 
+# if AXLOG_COMPILED_ENABLED && AXPF_CXX_CONSTEXPR_ENABLED
+// log a message with a compile-time format (see AXPF_FORMAT in ax_printf)
+template< typename TLit, typename... TArgs >
+inline     axlog_submit_report_result_t
+AXLOG_CALL axlog_submitcf
+(
+	axlog_u16_t                     flags,
+	const char *                    pszFile,
+	axlog_u32_t                     line,
+	const char *                    pszFunc,
+	ax::detail::TPfFormat< TLit >   fmt,
+	TArgs...                        args
+)
+{
+	AXPF__CHECK_ARGS( TLit, TArgs );
+	return axlog_submitcf( flags, pszFile, line, pszFunc, fmt.get(), args... );
+}
+// log a message with a compile-time format, leaving the formatting to the background thread
+template< typename TLit, typename... TArgs >
+inline     axlog_submit_report_result_t
+AXLOG_CALL axlog_defercf
+(
+	axlog_u16_t                     flags,
+	const char *                    pszFile,
+	axlog_u32_t                     line,
+	const char *                    pszFunc,
+	ax::detail::TPfFormat< TLit >   fmt,
+	TArgs...                        args
+)
+{
+	AXPF__CHECK_ARGS( TLit, TArgs );
+	return axlog_defercf( flags, pszFile, line, pszFunc, fmt.get(), args... );
+}
+# endif
+
 // set a range of facility names
 template< axlog_u32_t tFacilities >
 inline     axlog_set_facilities_result_t
@@ -2364,6 +4559,11 @@ namespace ax
 				return CReportProxy( m_flags, file, line, column, function );
 			}
 
+			inline bool isEnabled() const
+			{
+				return AXLOG_IS_ENABLED( m_flags );
+			}
+
 			inline const CReportProxy &submit( const axlog_str_t &message ) const
 			{
 				axlog_report_t rep;
@@ -2436,6 +4636,10 @@ namespace ax
 	axlog_report_t rep;\
 	char           buf[ AXLOG_FMTBUF_SIZE ];\
 	\
+	if( !AXLOG_IS_ENABLED( ((Flags_)&~AXLOG_FACILITY_MASK)|AXLOG_DEFAULT_FACILITY ) ) {\
+		return;\
+	}\
+	\
 	AXLOG_VA_T args;\
 	AXLOG_VA_S( args, Fmt_ );\
 	axlog_init_reportexv( buf, sizeof(buf), &rep,\
@@ -2452,6 +4656,10 @@ namespace ax
 		axlog_report_t rep;
 		char           buf[ AXLOG_FMTBUF_SIZE ];
 
+		if( !AXLOG_IS_ENABLED( axlog_u16_t(prio)|AXLOG_DEFAULT_FACILITY ) ) {
+			return;
+		}
+
 		axlog_init_reportexv( buf, sizeof(buf), &rep,
 			(axlog_u16_t(prio)|AXLOG_DEFAULT_FACILITY), &file, line,
 			(const axlog_str_t *)0, (const axlog_str_t *)0, pszFmt, args );
@@ -2481,6 +4689,10 @@ namespace ax
 		axlog_report_t rep;
 		char           buf[ AXLOG_FMTBUF_SIZE ];
 
+		if( !AXLOG_IS_ENABLED( axlog_u16_t(prio)|AXLOG_DEFAULT_FACILITY ) ) {
+			return;
+		}
+
 		axlog_init_reportexv( buf, sizeof(buf), &rep,
 			(axlog_u16_t(prio)|AXLOG_DEFAULT_FACILITY), (const axlog_str_t *)0,
 			0, (const axlog_str_t *)0, (const axlog_str_t *)0, pszFmt, args );
@@ -2616,12 +4828,14 @@ namespace ax
 
 # if AXLOG_TRACE_ENABLED
 #  define AX_TRACE(...)\
-	axlog_submitf\
+	( !AXLOG_IS_ENABLED( axlogp_debug | AXLOG_DEFAULT_FACILITY )\
+	? axlog_submit_report_result_disabled\
+	: axlog_submitf\
 	(\
 		axlogp_debug | axlogc_trace | AXLOG_DEFAULT_FACILITY,\
 		__FILE__, __LINE__, AXLOG_FUNCTION,\
 		__VA_ARGS__\
-	)
+	) )
 # else
 #  define AX_TRACE(...) ((void)0)
 # endif
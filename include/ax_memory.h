@@ -35,6 +35,12 @@
 		----------------
 		Enables the C++ parts of this. All C++ code is in the `ax` namespace.
 
+		AXMM_PHASED_STATS_ENABLED
+		-------------------------
+		Enables per-tag and per-thread statistics for the phased-heap (blocks
+		in use, bytes used, bytes wasted, and high-water marks). Disabled by
+		default; when disabled no counters are stored or updated.
+
 
 	REPLACE HEAP ALLOCATORS
 	========================
@@ -183,6 +189,10 @@
 # define AXMM_LISTENERS_ENABLED     1
 #endif
 
+#ifndef AXMM_PHASED_STATS_ENABLED
+# define AXMM_PHASED_STATS_ENABLED  0
+#endif
+
 #ifndef AXMM_FORCEINLINE
 # ifdef AX_FORCEINLINE
 #  define AXMM_FORCEINLINE          AX_FORCEINLINE
@@ -202,6 +212,8 @@ typedef ax_u32_t                    axmm_u32_t;
 typedef ax_s32_t                    axmm_s32_t;
 typedef ax_u16_t                    axmm_u16_t;
 typedef ax_s16_t                    axmm_s16_t;
+typedef ax_u8_t                     axmm_u8_t;
+typedef ax_s8_t                     axmm_s8_t;
 typedef ax_ptrdiff_t                axmm_ptrdiff_t;
 typedef ax_size_t                   axmm_size_t;
 # elif defined( _MSC_VER )
@@ -212,6 +224,8 @@ typedef unsigned __int32            axmm_u32_t;
 typedef   signed __int32            axmm_s32_t;
 typedef unsigned __int16            axmm_u16_t;
 typedef   signed __int16            axmm_s16_t;
+typedef unsigned __int8             axmm_u8_t;
+typedef   signed __int8             axmm_s8_t;
 typedef ptrdiff_t                   axmm_ptrdiff_t;
 typedef size_t                      axmm_size_t;
 # else
@@ -223,6 +237,8 @@ typedef uint32_t                    axmm_u32_t;
 typedef  int32_t                    axmm_s32_t;
 typedef uint16_t                    axmm_u16_t;
 typedef  int16_t                    axmm_s16_t;
+typedef uint8_t                     axmm_u8_t;
+typedef  int8_t                     axmm_s8_t;
 typedef ptrdiff_t                   axmm_ptrdiff_t;
 typedef size_t                      axmm_size_t;
 # endif
@@ -234,6 +250,8 @@ ax_static_assert( sizeof( axmm_s32_t ) == 4, "ax_memory: size mismatch" );
 ax_static_assert( sizeof( axmm_u32_t ) == 4, "ax_memory: size mismatch" );
 ax_static_assert( sizeof( axmm_s16_t ) == 2, "ax_memory: size mismatch" );
 ax_static_assert( sizeof( axmm_u16_t ) == 2, "ax_memory: size mismatch" );
+ax_static_assert( sizeof( axmm_s8_t ) == 1, "ax_memory: size mismatch" );
+ax_static_assert( sizeof( axmm_u8_t ) == 1, "ax_memory: size mismatch" );
 ax_static_assert( sizeof( axmm_ptrdiff_t ) == sizeof( void * ), "ax_memory: size mismatch" );
 ax_static_assert( sizeof( axmm_size_t ) == sizeof( void * ), "ax_memory: size mismatch" );
 #endif
@@ -277,9 +295,9 @@ ax_static_assert( sizeof( axmm_size_t ) == sizeof( void * ), "ax_memory: size mi
 #  define axmm_atomic_sub32(Dst_,Src_)\
 	((axmm_u32_t)(__sync_fetch_and_sub((volatile axmm_u32_t*)(Dst_),(axmm_u32_t)(Src_))))
 #  define axmm_atomic_xchg32(Dst_,Src_)\
-	((axmm_u32_t)(__sync_lock_test_and_set((volatile axmm_u32_t*)(Dst_),(axmm_u32_t)(Src_))))
+	((axmm_u32_t)(__atomic_exchange_n((volatile axmm_u32_t*)(Dst_),(axmm_u32_t)(Src_),__ATOMIC_SEQ_CST)))
 #  define axmm_atomic_cmpxchg32(Dst_,Src_,Cmp_)\
-	((axmm_u32_t)(__sync_val_compare_and_swap((volatile axmm_u32_t*)(Dst_),(axmm_u32_t)(Src_),(axmm_u32_t)(Cmp_))))
+	((axmm_u32_t)(__sync_val_compare_and_swap((volatile axmm_u32_t*)(Dst_),(axmm_u32_t)(Cmp_),(axmm_u32_t)(Src_))))
 # else
 #  error ax_memory: unimplemented atomic operations on this platform/compiler
 # endif
@@ -629,7 +647,7 @@ static void AXMM_CALL axmm__wlock_listeners( void )
 #  ifdef INCGUARD_AX_THREAD_H_
 	axth_rwlock_wracquire( &axmm__g_listenerLock );
 #  else
-	while( axmm_atomic_cmpxchg32( &axmm__g_listenerLock.w, 1, 0 ) != 1 ) {
+	while( axmm_atomic_cmpxchg32( &axmm__g_listenerLock.w, 1, 0 ) != 0 ) {
 		axmm_spin();
 	}
 
@@ -1045,6 +1063,14 @@ AXMM__LEAVE_C
 	  invoked upon freeing the memory.
 	- Reference counting is enabled on memory objects. Memory will only be
 	  freed once all reference counts reach zero.
+	- A root object can own an arena (`axmm_h_alloc_arena()`). Objects made
+	  with `axmm_h_suballoc()` anywhere beneath it are then carved from the
+	  arena contiguously, and freeing the root releases the whole arena at
+	  once. At-free functions of the arena's objects are kept in a compact
+	  list and run at that point; no walk of the tree is needed unless objects
+	  from outside the arena were attached to it.
+	- Arena objects can't outlive their root (even if referenced) and must not
+	  be detached from it. Allocating from an arena is not thread-safe.
 
 ===============================================================================
 */
@@ -1060,6 +1086,11 @@ AXMM__ENTER_C
 # define AXMM_HMALLOC_THREADSAFE    1
 #endif
 
+#ifndef AXMM_H_ARENA_CHUNK_SIZE
+/* Default number of bytes an arena grows by (when not specified to `axmm_h_alloc_arena()`) */
+# define AXMM_H_ARENA_CHUNK_SIZE    (64*1024)
+#endif
+
 typedef void( *axmm_pfn_fini_t )( void * );
 
 typedef struct axmm__h_alloc_s
@@ -1072,9 +1103,88 @@ typedef struct axmm__h_alloc_s
 	axmm_pfn_fini_t         fini;
 } axmm__h_alloc_t;
 
+/* The top bits of `refcnt` flag objects that own an arena, or were carved from one */
+#define AXMM__H_REFCNT_MASK         0x3FFFFFFFU
+#define AXMM__H_ARENA_OWNER         0x80000000U
+#define AXMM__H_ARENA_MEMBER        0x40000000U
+
+/* Registered at-free function of an arena object */
+typedef struct axmm__h_dtor_s
+{
+	struct axmm__h_dtor_s *next;
+	axmm__h_alloc_t *       a;
+} axmm__h_dtor_t;
+
+/* Additional memory for an arena (the data follows at `AXMM__H_CHUNK_BYTES`) */
+typedef struct axmm__h_chunk_s
+{
+	struct axmm__h_chunk_s *next;
+} axmm__h_chunk_t;
+
+/* Arena owned by a root object -- stored at `AXMM__H_ARENA_BYTES` before the root's header */
+typedef struct axmm__h_arena_s
+{
+	axmm__h_chunk_t *       chunks;
+	axmm_u8_t *             cur;
+	axmm_u8_t *             end;
+	axmm__h_dtor_t *        dtors;
+	axmm_size_t             chunk_n;
+	axmm_u32_t              foreign_cnt; /* objects from outside the arena attached within */
+} axmm__h_arena_t;
+
+#define AXMM__H_ALIGN(N_)           ( ( (N_) + 15 ) & ~( axmm__c( axmm_size_t )( 15 ) ) )
+#define AXMM__H_ARENA_BYTES         AXMM__H_ALIGN( sizeof( axmm__h_arena_t ) )
+#define AXMM__H_CHUNK_BYTES         AXMM__H_ALIGN( sizeof( axmm__h_chunk_t ) )
+
+AXMM_FUNC void *AXMM_CALL axmm_h_free( void *p );
+AXMM_FUNC void *AXMM_CALL axmm_h_attach( void *subobject, void *superobject );
+
 #if AXMM_IMPLEMENT
+/* implementation: find the arena `a` was carved from (or owns), if any */
+static axmm__h_arena_t *AXMM_CALL axmm__h_find_arena( const axmm__h_alloc_t *a )
+{
+	while( a != AXMM_NULL(const axmm__h_alloc_t) ) {
+		if( a->refcnt & AXMM__H_ARENA_OWNER ) {
+			return axmm__rc( axmm__h_arena_t * )( axmm__pc( axmm_u8_t *, a ) - AXMM__H_ARENA_BYTES );
+		}
+		if( ~a->refcnt & AXMM__H_ARENA_MEMBER ) {
+			break;
+		}
+
+		a = a->a_prnt;
+	}
+
+	return AXMM_NULL(axmm__h_arena_t);
+}
+/* implementation: take `n` bytes (a multiple of 16) from an arena */
+static void *AXMM_CALL axmm__h_arena_carve( axmm__h_arena_t *ar, axmm_size_t n )
+{
+	axmm__h_chunk_t *chunk;
+	axmm_size_t chunk_n;
+	void *p;
+
+	if( axmm__c( axmm_size_t )( ar->end - ar->cur ) < n ) {
+		chunk_n = n > ar->chunk_n ? n : ar->chunk_n;
+		if( !( chunk = axmm__c( axmm__h_chunk_t * )( axmm_def_h_alloc( AXMM__H_CHUNK_BYTES + chunk_n ) ) ) ) {
+			return AXMM_NULL(void);
+		}
+
+		chunk->next = ar->chunks;
+		ar->chunks = chunk;
+
+		ar->cur = axmm__rc( axmm_u8_t * )( chunk ) + AXMM__H_CHUNK_BYTES;
+		ar->end = ar->cur + chunk_n;
+	}
+
+	p = axmm__c( void * )( ar->cur );
+	ar->cur += n;
+	return p;
+}
+
 static void AXMM_CALL axmm__h_unlink( axmm__h_alloc_t *a )
 {
+	axmm__h_arena_t *ar;
+
 	if( a->a_prev != AXMM_NULL(axmm__h_alloc_t) ) {
 		a->a_prev->a_next = a->a_next;
 	} else if( a->a_prnt != AXMM_NULL(axmm__h_alloc_t) ) {
@@ -1085,6 +1195,64 @@ static void AXMM_CALL axmm__h_unlink( axmm__h_alloc_t *a )
 	} else if( a->a_prnt != AXMM_NULL(axmm__h_alloc_t) ) {
 		a->a_prnt->a_tail = a->a_prev;
 	}
+
+	if( a->a_prnt != AXMM_NULL(axmm__h_alloc_t) && ( ~a->refcnt & AXMM__H_ARENA_MEMBER ) ) {
+		if( ( ar = axmm__h_find_arena( a->a_prnt ) ) != AXMM_NULL(axmm__h_arena_t) ) {
+			--ar->foreign_cnt;
+		}
+	}
+
+	a->a_prnt = AXMM_NULL(axmm__h_alloc_t);
+	a->a_prev = AXMM_NULL(axmm__h_alloc_t);
+	a->a_next = AXMM_NULL(axmm__h_alloc_t);
+}
+/* implementation: free an arena and its root (`a`), running the at-free functions of the arena's objects */
+static void AXMM_CALL axmm__h_arena_release( axmm__h_alloc_t *a )
+{
+	axmm__h_arena_t *ar;
+	axmm__h_chunk_t *chunk, *next;
+	axmm__h_alloc_t *n, *after;
+	axmm__h_dtor_t *d;
+	axmm_pfn_fini_t fini;
+
+	ar = axmm__h_find_arena( a );
+
+	/* most recently registered first */
+	for( d = ar->dtors; d != AXMM_NULL(axmm__h_dtor_t); d = d->next ) {
+		if( ( fini = d->a->fini ) != axmm__c( axmm_pfn_fini_t )(0) ) {
+			d->a->fini = axmm__c( axmm_pfn_fini_t )(0);
+			fini( axmm__c( void * )( d->a + 1 ) );
+		}
+	}
+
+	/* objects from outside the arena have to be found and freed individually */
+	n = a->a_head;
+	while( n != AXMM_NULL(axmm__h_alloc_t) && ar->foreign_cnt > 0 ) {
+		if( n->a_head != AXMM_NULL(axmm__h_alloc_t) && ( n->refcnt & AXMM__H_ARENA_MEMBER ) ) {
+			n = n->a_head;
+			continue;
+		}
+
+		after = n;
+		while( after != a && !after->a_next ) {
+			after = after->a_prnt;
+		}
+		after = after != a ? after->a_next : AXMM_NULL(axmm__h_alloc_t);
+
+		if( ~n->refcnt & AXMM__H_ARENA_MEMBER ) {
+			axmm__h_unlink( n );
+			axmm_h_free( axmm__c( void * )( n + 1 ) );
+		}
+
+		n = after;
+	}
+
+	for( chunk = ar->chunks; chunk != AXMM_NULL(axmm__h_chunk_t); chunk = next ) {
+		next = chunk->next;
+		axmm_def_h_free( axmm__c( void * )( chunk ) );
+	}
+
+	axmm_def_h_free( axmm__c( void * )( ar ) );
 }
 #endif
 
@@ -1117,10 +1285,99 @@ AXMM_FUNC void *AXMM_CALL axmm_h_alloc( axmm_size_t n )
 #else
 ;
 #endif
+/* Allocate a root object owning an arena of (initially) `arena_n` bytes for the objects beneath it (0 for the default) */
+AXMM_FUNC void *AXMM_CALL axmm_h_alloc_arena( axmm_size_t n, axmm_size_t arena_n )
+#if AXMM_IMPLEMENT
+{
+	axmm__h_arena_t *ar;
+	axmm__h_alloc_t *p;
+	axmm_size_t root_n;
+	void *vp;
+
+	arena_n = AXMM__H_ALIGN( arena_n != 0 ? arena_n : AXMM_H_ARENA_CHUNK_SIZE );
+	root_n = AXMM__H_ALIGN( sizeof( axmm__h_alloc_t ) + n );
+
+	/* the arena, the root, and the first part of the arena's memory all share one allocation */
+	if( !( vp = axmm_def_h_alloc( AXMM__H_ARENA_BYTES + root_n + arena_n ) ) ) {
+		return AXMM_NULL(void);
+	}
+
+	ar = axmm__c( axmm__h_arena_t * )( vp );
+	p = axmm__rc( axmm__h_alloc_t * )( axmm__c( axmm_u8_t * )( vp ) + AXMM__H_ARENA_BYTES );
+
+	ar->chunks      = AXMM_NULL(axmm__h_chunk_t);
+	ar->cur         = axmm__rc( axmm_u8_t * )( p ) + root_n;
+	ar->end         = ar->cur + arena_n;
+	ar->dtors       = AXMM_NULL(axmm__h_dtor_t);
+	ar->chunk_n     = arena_n;
+	ar->foreign_cnt = 0;
+
+	p->n      = n;
+	p->refcnt = 1 | AXMM__H_ARENA_OWNER;
+	p->a_prnt = AXMM_NULL(axmm__h_alloc_t);
+	p->a_head = AXMM_NULL(axmm__h_alloc_t);
+	p->a_tail = AXMM_NULL(axmm__h_alloc_t);
+	p->a_prev = AXMM_NULL(axmm__h_alloc_t);
+	p->a_next = AXMM_NULL(axmm__h_alloc_t);
+	p->fini   = ( axmm_pfn_fini_t )0;
+
+	vp = axmm__c( void * )( p + 1 );
+
+	memset( vp, 0, n );
+	return vp;
+}
+#else
+;
+#endif
+/* Allocate an object attached to `superobject` (carved from its arena if it has one; a root if `superobject` is NULL) */
+AXMM_FUNC void *AXMM_CALL axmm_h_suballoc( void *superobject, axmm_size_t n )
+#if AXMM_IMPLEMENT
+{
+	axmm__h_arena_t *ar;
+	axmm__h_alloc_t *p;
+	void *vp;
+
+	if( !superobject ) {
+		return axmm_h_alloc( n );
+	}
+
+	ar = axmm__h_find_arena( axmm__c( axmm__h_alloc_t * )( superobject ) - 1 );
+	if( !ar ) {
+		if( !( vp = axmm_h_alloc( n ) ) ) {
+			return AXMM_NULL(void);
+		}
+
+		return axmm_h_attach( vp, superobject );
+	}
+
+	if( !( vp = axmm__h_arena_carve( ar, AXMM__H_ALIGN( sizeof( axmm__h_alloc_t ) + n ) ) ) ) {
+		return AXMM_NULL(void);
+	}
+
+	p = axmm__c( axmm__h_alloc_t * )( vp );
+
+	p->n      = n;
+	p->refcnt = 1 | AXMM__H_ARENA_MEMBER;
+	p->a_prnt = AXMM_NULL(axmm__h_alloc_t);
+	p->a_head = AXMM_NULL(axmm__h_alloc_t);
+	p->a_tail = AXMM_NULL(axmm__h_alloc_t);
+	p->a_prev = AXMM_NULL(axmm__h_alloc_t);
+	p->a_next = AXMM_NULL(axmm__h_alloc_t);
+	p->fini   = ( axmm_pfn_fini_t )0;
+
+	vp = axmm__c( void * )( p + 1 );
+
+	memset( vp, 0, n );
+	return axmm_h_attach( vp, superobject );
+}
+#else
+;
+#endif
 AXMM_FUNC void *AXMM_CALL axmm_h_free( void *p )
 #if AXMM_IMPLEMENT
 {
 	axmm__h_alloc_t *a;
+	axmm_pfn_fini_t fini;
 
 	if( !p ) {
 		return AXMM_NULL(void);
@@ -1128,26 +1385,36 @@ AXMM_FUNC void *AXMM_CALL axmm_h_free( void *p )
 
 	a = ( axmm__h_alloc_t * )p - 1;
 # if AXMM_HMALLOC_THREADSAFE
-	if( axmm_atomic_sub32( &a->refcnt, 1 ) > 1 ) {
+	if( ( axmm_atomic_sub32( &a->refcnt, 1 ) & AXMM__H_REFCNT_MASK ) > 1 ) {
 		return AXMM_NULL(void);
 	}
 # else
-	if( --a->refcnt != 0 ) {
+	if( ( --a->refcnt & AXMM__H_REFCNT_MASK ) != 0 ) {
 		return AXMM_NULL(void);
 	}
 # endif
 
 	axmm__h_unlink( a );
 
-	if( a->fini != axmm__c( axmm_pfn_fini_t )(0) ) {
-		a->fini( p );
+	/* cleared so an arena doesn't run it a second time */
+	if( ( fini = a->fini ) != axmm__c( axmm_pfn_fini_t )(0) ) {
+		a->fini = axmm__c( axmm_pfn_fini_t )(0);
+		fini( p );
+	}
+
+	if( a->refcnt & AXMM__H_ARENA_OWNER ) {
+		axmm__h_arena_release( a );
+		return AXMM_NULL(void);
 	}
 
 	while( a->a_head != AXMM_NULL(axmm__h_alloc_t) ) {
 		axmm_h_free( axmm__c( void * )( a->a_head + 1 ) );
 	}
 
-	axmm_def_h_free( axmm__c( void * )( a ) );
+	/* arena memory is only released with the arena */
+	if( ~a->refcnt & AXMM__H_ARENA_MEMBER ) {
+		axmm_def_h_free( axmm__c( void * )( a ) );
+	}
 	return AXMM_NULL(void);
 }
 #else
@@ -1171,9 +1438,28 @@ AXMM_FUNC void *AXMM_CALL axmm_h_addref( void *p )
 AXMM_FUNC void *AXMM_CALL axmm_h_atfree( void *p, axmm_pfn_fini_t pfn_fini )
 #if AXMM_IMPLEMENT
 {
+	axmm__h_alloc_t *a;
+	axmm__h_arena_t *ar;
+	axmm__h_dtor_t *d;
+
 	axmm_assert( p != AXMM_NULL(void) );
 
-	( axmm__c( axmm__h_alloc_t * )( p ) - 1 )->fini = pfn_fini;
+	a = axmm__c( axmm__h_alloc_t * )( p ) - 1;
+
+	/* arena objects aren't freed individually, so the arena keeps track of them */
+	if( ( a->refcnt & AXMM__H_ARENA_MEMBER ) && pfn_fini != axmm__c( axmm_pfn_fini_t )(0) && a->fini == axmm__c( axmm_pfn_fini_t )(0) ) {
+		if( ( ar = axmm__h_find_arena( a ) ) != AXMM_NULL(axmm__h_arena_t) ) {
+			if( !( d = axmm__c( axmm__h_dtor_t * )( axmm__h_arena_carve( ar, AXMM__H_ALIGN( sizeof( axmm__h_dtor_t ) ) ) ) ) ) {
+				return AXMM_NULL(void);
+			}
+
+			d->a = a;
+			d->next = ar->dtors;
+			ar->dtors = d;
+		}
+	}
+
+	a->fini = pfn_fini;
 	return p;
 }
 #else
@@ -1229,6 +1515,13 @@ AXMM_FUNC void *AXMM_CALL axmm_h_attach( void *subobject, void *superobject )
 	}
 	prnt->a_tail = chld;
 
+	if( ~chld->refcnt & AXMM__H_ARENA_MEMBER ) {
+		axmm__h_arena_t *const ar = axmm__h_find_arena( prnt );
+		if( ar != AXMM_NULL(axmm__h_arena_t) ) {
+			++ar->foreign_cnt;
+		}
+	}
+
 	return subobject;
 }
 #else
@@ -1305,14 +1598,13 @@ namespace ax
 	{
 		return axmm_h_alloc( n );
 	}
+	AXMM_FORCEINLINE void *AXMM_CALL h_allocArena( axmm_size_t n, axmm_size_t cArenaBytes = 0 )
+	{
+		return axmm_h_alloc_arena( n, cArenaBytes );
+	}
 	AXMM_FORCEINLINE void *AXMM_CALL h_suballoc( void *superobject, axmm_size_t n )
 	{
-		void *const subobject = axmm_h_alloc( n );
-		if( !subobject ) {
-			return AXMM_NULL(void);
-		}
-
-		return !superobject ? subobject : axmm_h_attach( subobject, superobject );
+		return axmm_h_suballoc( superobject, n );
 	}
 	AXMM_FORCEINLINE void *AXMM_CALL h_dealloc( void *p )
 	{
@@ -1508,7 +1800,7 @@ AXMM_FUNC void *AXMM_CALL axmm_page_reserve( axmm_size_t cBytes )
 	void *p;
 
 	p = mmap( AXMM_NULL(void), cBytes, PROT_NONE, MAP_PRIVATE|MAP_ANON, -1, 0 );
-	if( !p ) {
+	if( p == MAP_FAILED ) {
 		return AXMM_NULL(void);
 	}
 
@@ -1530,7 +1822,7 @@ AXMM_FUNC void *AXMM_CALL axmm_page_commit( void *pBase, axmm_size_t cBytes, axm
 	void *p;
 
 	p = mmap( pBase, cBytes, axmm__posix_protf( uProtFlags ), MAP_FIXED|MAP_SHARED|MAP_ANON, -1, 0 );
-	if( !p ) {
+	if( p == MAP_FAILED ) {
 		return AXMM_NULL(void);
 	}
 
@@ -1732,15 +2024,19 @@ namespace ax
 
 	To allocate a block:
 	
-		① Atomic-fetch-then-add on the "split position" for the array.
-		② If the split position has the high-bit set, then a lock is held and
-		`  we must wait for it to be released. Spin-loop until the high-bit is
+		① Atomic-increment the "writers count." (See "Synchronization.")
+		② Read the "split position" for the array. If it has the high-bit set,
+		`  then a lock is held and we must wait for it to be released.
+		`  Atomic-decrement the writers count, spin-loop until the high-bit is
 		`  not set, then try again from ①.
-		③ If the split position is out of range, then handle "out of memory"
-		`  in whichever way is appropriate.
-		④ The value we retrieved from the atomic-fetch-and-add gives us the
-		`  block index we can use. Change its tag to whatever tag we've
-		`  allocated. Done.
+		③ If the split position is out of range, then atomic-decrement the
+		`  writers count and handle "out of memory" in whichever way is
+		`  appropriate.
+		④ Atomic-compare-and-set the split position to one past the value we
+		`  read. If this fails, go back to ②.
+		⑤ The value we read gives us the block index we can use. Change its
+		`  tag to whatever tag we've allocated, then atomic-decrement the
+		`  writers count. Done.
 
 	To deallocate a *tag*:
 
@@ -1773,11 +2069,30 @@ namespace ax
 		`  then spin until it is not.
 		② Attempt to atomic-compare-and-set the value to the read current
 		`  position with the high-bit newly set. If this fails, go back to ①.
-		③ Do whatever you need to with the lock. Do not attempt to grab the
+		③ Spin until the writers count reaches zero.
+		④ Do whatever you need to with the lock. Do not attempt to grab the
 		`  lock again from the same thread -- it is not re-entrant.
-		④ Release the lock with an atomic-set to the new value of "current
+		⑤ Release the lock with an atomic-set to the new value of "current
 		`  position." (The high-bit must not be set; it must be cleared.)
 
+	Threads register with the heap to receive their local data. These records
+	are cache-line aligned (to prevent false sharing between workers) and live
+	in address space that is reserved up front but only committed as records
+	are first handed out. Unregistering a thread hands its partially used
+	working blocks back to the heap, where they wait on a per-tag list of spare
+	blocks (linked through their unused last 16 bytes) until a thread that has
+	run out of room in its own working block for that tag continues them. Its
+	record then goes on a free list for the next thread to register.
+	Threads that allocate without registering are registered automatically.
+	Call `axmm_phased_thread_fini()` before a thread that used any phased heap
+	exits, so its records go back to their heaps; otherwise each such thread
+	holds one of the heap's `AXMM_MAX_THREADS` records until `fini`.
+
+	Each thread can be bound to `AXMM_MAX_HEAPS_PER_THREAD` heaps at once.
+	`axmm_phased_fini()` drops the calling thread's binding, and a binding to a
+	heap that has since been finished (checked against a global list of live
+	heaps) is reused once the thread runs out of free ones.
+
 	The thread has a local set of sixteen block pointers. The pointers
 	correspond to the tags for the blocks. (The pointers can be indexes instead
 	as long as the thread has access to the base address to resolve the
@@ -1823,18 +2138,25 @@ namespace ax
 
 
 
-	Synchronization Bug
-	-------------------
+	Synchronization
+	---------------
 
-	If a tag is being freed while other tags are still being allocated there's
-	the possibility that a tag that has just been allocated will be touched in
-	the process of the tag that's being free'd. See axmm_phased_free() and
-	axmm__phased_block_fetch().
+	A block fetch claims its slot in the array and then writes the slot's tag.
+	A tag being freed (or a multiple block allocation) rearranges the array, so
+	it must not run between those two steps of any fetch. Doing so could free
+	(or hand out twice) a block that was just allocated for another tag.
 
-	This can be solved by either adjusting the algorithm to just always avoid
-	the fetch-add, or by using a separate "writers count" that tracks the
-	number of interested allocators. (Things that are fetching a block and
-	marking that block as active.)
+	To prevent this, fetches never use a fetch-add on the split position.
+	Instead they claim a slot with a compare-and-set that fails while the lock
+	is held, and they keep a separate "writers count" raised for as long as
+	they are fetching a block and marking that block as active. The lock holder
+	waits for the writers count to drain before touching the array. Because of
+	this, freeing a tag can overlap allocations on other tags from any thread
+	without the caller needing a global barrier. Allocations that are served
+	from a thread's working block never touch either value.
+
+	Freeing a tag while another thread is allocating with that *same* tag is
+	still a logic error.
 
 ===============================================================================
 */
@@ -1856,8 +2178,13 @@ AXMM__ENTER_C
 #endif
 
 #ifndef AXMM_MAX_THREADS
-/* Maximum number of threads to support for the tagged heap allocator */
-# define AXMM_MAX_THREADS           ( sizeof( void * )*8 )
+/* Maximum number of threads that can be registered with a tagged heap at once (address space is reserved for these; memory is committed on demand) */
+# define AXMM_MAX_THREADS           1024
+#endif
+
+#ifndef AXMM_MAX_HEAPS_PER_THREAD
+/* Maximum number of tagged heaps a single thread can be registered with at once */
+# define AXMM_MAX_HEAPS_PER_THREAD  8
 #endif
 
 #ifndef AXMM_BLOCK_INDEX_BITS
@@ -1918,20 +2245,74 @@ typedef struct axmm__phased_block_s
 	axmm_u32_t                      cBytesUsed;
 } axmm__phased_block_t;
 
+/* Link for a partially used block handed back to the heap -- kept in the last 16 bytes of the block */
+typedef struct axmm__phased_spare_s
+{
+	/* Next spare block of the same tag (or NULL) */
+	void *                          pNext;
+	/* Number of bytes used in this block when it was handed back */
+	axmm_u32_t                      cBytesUsed;
+} axmm__phased_spare_t;
+
+/* Retrieve the link of a spare block */
+#define AXMM__PHASED_SPARE_OF(Block_)\
+	( axmm__rc( axmm__phased_spare_t * )( axmm__rc( axmm_size_t )( Block_ ) + AXMM_BLOCK_SIZE - 16 ) )
+
+#if AXMM_PHASED_STATS_ENABLED
+/* Statistics for a tag of the phased-heap (or a thread's share of that tag) */
+typedef struct axmm_phased_stats_s
+{
+	/* Number of blocks currently held by the tag */
+	axmm_u32_t                      cBlocks;
+	/* Highest value `cBlocks` has reached (not reset by `axmm_phased_free()`) */
+	axmm_u32_t                      cPeakBlocks;
+	/* Number of bytes handed out to the user -- aligned to `AXMM_PHASED_HEAP_ALIGNMENT` */
+	axmm_u64_t                      cBytesUsed;
+	/* Number of bytes left unusable at the end of blocks by the block-switch policy */
+	axmm_u64_t                      cBytesWasted;
+} axmm_phased_stats_t;
+#endif
+
 /* Per-thread data for the phased-heap allocator */
 typedef struct axmm__phased_heap_thread_s
 {
 	/* Current working block for each of the tags */
 	axmm__phased_block_t            workingBlocks       [ AXMM_MAX_TAGS ];
+#if AXMM_PHASED_STATS_ENABLED
+	/* Allocations made by this thread for each of the tags (only written by the owning thread) */
+	axmm_phased_stats_t             stats               [ AXMM_MAX_TAGS ];
+#endif
+	/* Next record in the heap's free list (only valid while unregistered) */
+	struct axmm__phased_heap_thread_s *pNextFree;
 } axmm__phased_heap_thread_t;
 
+/* Distance between per-thread records -- rounded up to the cache line size to avoid false sharing */
+#define AXMM__PHASED_THREAD_STRIDE\
+	( ( sizeof( axmm__phased_heap_thread_t ) + AXMM_CACHE_SIZE - 1 ) & ~( axmm__c( axmm_size_t )( AXMM_CACHE_SIZE - 1 ) ) )
+
 /* Primary structure for a phased-heap */
 typedef struct axmm_phased_heap_s
 {
-	/* Per-thread data */
-	axmm__phased_heap_thread_t      threads             [ AXMM_MAX_THREADS ];
+	/* Per-thread records -- `AXMM_MAX_THREADS` are reserved, `cThreads` have been handed out (`AXMM__PHASED_THREAD_STRIDE` apart) */
+	void *                          pThreads;
+	/* Number of per-thread records that have been initialized */
+	axmm_u32_t                      cThreads;
+	/* Number of bytes of `pThreads` that have been committed */
+	axmm_size_t                     cThreadBytes;
+	/* Records of unregistered threads, ready to be handed out again */
+	axmm__phased_heap_thread_t *    pFreeThreads;
+	/* Lock for `cThreads`, `cThreadBytes`, and `pFreeThreads` */
+	axmm_u32_t                      uThreadLock;
+	/* Unique identifier for this instance (so a thread can't mistake a new heap at the same address for an old one) */
+	axmm_u32_t                      uSerial;
+	/* Next heap in the list of initialized heaps */
+	struct axmm_phased_heap_s *     pNextLive;
 	/* Current divide between used and free block indexes in `blockIndexes` */
 	axmm_u32_t                      uSplitPos;
+	/* Number of block fetches currently in progress (the lock waits for this to be zero) */
+	axmm_u32_t                      cWriters;
+	/* Partially used blocks handed back by unregistered threads, for each of the tags (changed only under the lock) */
+	void *                          pSpareBlocks        [ AXMM_MAX_TAGS ];
 	/* BlockIndexes[ 0 < i < uSplitPos ] are allocated; `blockIndexes[ uSplitPos <= i < AXMM_MAX_INDEXES ]` are available */
 	AXMM_BLOCK_INDEX_TYPE           blockIndexes        [ AXMM_MAX_INDEXES ];
 	/* Base address for the blocks -- should be aligned to `AXMM_PHASED_HEAP_ALIGNMENT` */
@@ -1940,6 +2321,14 @@ typedef struct axmm_phased_heap_s
 	axmm_u32_t                      cMaxBlocks;
 	/* Flags */
 	unsigned                        uFlags;
+#if AXMM_PHASED_STATS_ENABLED
+	/* Number of blocks held by each tag (atomic) */
+	axmm_u32_t                      cTagBlocks          [ AXMM_MAX_TAGS ];
+	/* Highest value each of `cTagBlocks` has reached (atomic) */
+	axmm_u32_t                      cTagPeakBlocks      [ AXMM_MAX_TAGS ];
+	/* Highest number of blocks used across all tags at once (atomic) */
+	axmm_u32_t                      cPeakBlocks;
+#endif
 } axmm_phased_heap_t;
 
 typedef enum axmm__phased_heap_flag_e
@@ -1974,20 +2363,117 @@ typedef enum axmm__phased_heap_flag_e
 	axmm_page_protect((BlockPtr_),(NumBytes_),axmem_pp_noaccess)
 #endif
 
+#if AXMM_IMPLEMENT
+/* implementation: a phased-heap the current thread is registered with */
+typedef struct axmm__phased_binding_s
+{
+	/* The heap (or NULL if this binding is unused) */
+	axmm_phased_heap_t *            pHeap;
+	/* `pHeap->uSerial` at the time of registration */
+	axmm_u32_t                      uSerial;
+	/* The record handed out to this thread */
+	axmm__phased_heap_thread_t *    pThread;
+} axmm__phased_binding_t;
+
+static AXMM_THREADLOCAL axmm__phased_binding_t axmm__g_phasedBindings[ AXMM_MAX_HEAPS_PER_THREAD ];
+
+/* implementation: find the current thread's binding for `p` */
+static axmm__phased_binding_t *AXMM_CALL axmm__phased_find_binding( const axmm_phased_heap_t *p )
+{
+	axmm_u32_t i;
+
+	for( i = 0; i < AXMM_MAX_HEAPS_PER_THREAD; ++i ) {
+		if( axmm__g_phasedBindings[ i ].pHeap == p && axmm__g_phasedBindings[ i ].uSerial == p->uSerial ) {
+			return &axmm__g_phasedBindings[ i ];
+		}
+	}
+
+	return AXMM_NULL(axmm__phased_binding_t);
+}
+/* implementation: drop the current thread's binding for `p` (its record goes away with the heap) */
+static void AXMM_CALL axmm__phased_forget_binding( const axmm_phased_heap_t *p )
+{
+	axmm__phased_binding_t *b;
+
+	if( ( b = axmm__phased_find_binding( p ) ) == AXMM_NULL(axmm__phased_binding_t) ) {
+		return;
+	}
+
+	b->pHeap = AXMM_NULL(axmm_phased_heap_t);
+	b->uSerial = 0;
+	b->pThread = AXMM_NULL(axmm__phased_heap_thread_t);
+}
+/* implementation: every initialized phased-heap, so stale thread bindings can be told apart from live ones */
+static axmm_phased_heap_t *         axmm__g_pPhasedLive = AXMM_NULL(axmm_phased_heap_t);
+/* implementation: lock for `axmm__g_pPhasedLive` */
+static axmm_u32_t                   axmm__g_uPhasedLiveLock = 0;
+
+/* implementation: acquire the live heap list lock */
+static void AXMM_CALL axmm__phased_lock_live( void )
+{
+	while( axmm_atomic_xchg32( &axmm__g_uPhasedLiveLock, 1 ) != 0 ) {
+		axmm_spin();
+	}
+}
+/* implementation: release the live heap list lock */
+static void AXMM_CALL axmm__phased_unlock_live( void )
+{
+	axmm_atomic_xchg32( &axmm__g_uPhasedLiveLock, 0 );
+}
+/* implementation: determine whether `p` is an initialized heap with serial `uSerial` (without dereferencing `p` otherwise) */
+static int AXMM_CALL axmm__phased_is_live( const axmm_phased_heap_t *p, axmm_u32_t uSerial )
+{
+	const axmm_phased_heap_t *q;
+	int r;
+
+	r = 0;
+	axmm__phased_lock_live();
+	for( q = axmm__g_pPhasedLive; q != AXMM_NULL(axmm_phased_heap_t); q = q->pNextLive ) {
+		if( q == p ) {
+			r = q->uSerial == uSerial;
+			break;
+		}
+	}
+	axmm__phased_unlock_live();
+
+	return r;
+}
+#endif
+
 /* Initialize a phased-heap allocator -- if pBaseOrNull is not-NULL then cBaseBytesOrZero must be valid */
 AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_init( axmm_phased_heap_t *p, void *pBaseOrNull, axmm_size_t cBaseBytesOrZero )
 #if AXMM_IMPLEMENT
 {
-	axmm_size_t i, j;
+	static axmm_u32_t uNextSerial = 0;
+	axmm_size_t i;
+#if AXMM_PHASED_STATS_ENABLED
+	axmm_size_t j;
+#endif
 
-	for( i = 0; i < AXMM_MAX_THREADS; ++i ) {
-		for( j = 0; j < AXMM_MAX_TAGS; ++j ) {
-			p->threads[ i ].workingBlocks[ j ].pBlockBase = AXMM_NULL(void);
-			p->threads[ i ].workingBlocks[ j ].cBytesUsed = AXMM_BLOCK_SIZE;
-		}
+	p->pThreads = axmm_page_reserve( AXMM__PHASED_THREAD_STRIDE*AXMM_MAX_THREADS );
+	if( !p->pThreads ) {
+		return AXMM_NULL(axmm_phased_heap_t);
 	}
+	p->cThreads = 0;
+	p->cThreadBytes = 0;
+	p->pFreeThreads = AXMM_NULL(axmm__phased_heap_thread_t);
+	p->uThreadLock = 0;
+	p->uSerial = axmm_atomic_add32( &uNextSerial, 1 ) + 1;
 
 	p->uSplitPos = 0;
+	p->cWriters = 0;
+
+	for( i = 0; i < AXMM_MAX_TAGS; ++i ) {
+		p->pSpareBlocks[ i ] = AXMM_NULL(void);
+	}
+
+#if AXMM_PHASED_STATS_ENABLED
+	for( j = 0; j < AXMM_MAX_TAGS; ++j ) {
+		p->cTagBlocks[ j ] = 0;
+		p->cTagPeakBlocks[ j ] = 0;
+	}
+	p->cPeakBlocks = 0;
+#endif
 
 	for( i = 0; i < AXMM_MAX_INDEXES; ++i ) {
 		p->blockIndexes[ i ] = ( AXMM_BLOCK_INDEX_TYPE )i;
@@ -1998,6 +2484,7 @@ AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_init( axmm_phased_heap_t *p,
 		? pBaseOrNull
 		: axmm__phased_reserve( AXMM_NULL(void), AXMM_MAX_ADDRESSABLE_BLOCK_BYTES );
 	if( !p->pBaseBlock ) {
+		axmm_page_release( p->pThreads, AXMM__PHASED_THREAD_STRIDE*AXMM_MAX_THREADS );
 		return AXMM_NULL(axmm_phased_heap_t);
 	}
 
@@ -2008,6 +2495,10 @@ AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_init( axmm_phased_heap_t *p,
 			: AXMM_MAX_BLOCKS
 		);
 	if( !p->cMaxBlocks ) {
+		if( pBaseOrNull == AXMM_NULL(void) ) {
+			axmm__phased_release( p->pBaseBlock, AXMM_MAX_ADDRESSABLE_BLOCK_BYTES );
+		}
+		axmm_page_release( p->pThreads, AXMM__PHASED_THREAD_STRIDE*AXMM_MAX_THREADS );
 		return AXMM_NULL(axmm_phased_heap_t);
 	}
 
@@ -2016,6 +2507,11 @@ AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_init( axmm_phased_heap_t *p,
 		p->uFlags |= axmem__phasedf_usrptr;
 	}
 
+	axmm__phased_lock_live();
+	p->pNextLive = axmm__g_pPhasedLive;
+	axmm__g_pPhasedLive = p;
+	axmm__phased_unlock_live();
+
 	return p;
 }
 #else
@@ -2026,6 +2522,21 @@ AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_init( axmm_phased_heap_t *p,
 AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_fini( axmm_phased_heap_t *p )
 #if AXMM_IMPLEMENT
 {
+	axmm_phased_heap_t **pp;
+
+	axmm__phased_lock_live();
+	for( pp = &axmm__g_pPhasedLive; *pp != AXMM_NULL(axmm_phased_heap_t); pp = &( *pp )->pNextLive ) {
+		if( *pp == p ) {
+			*pp = p->pNextLive;
+			break;
+		}
+	}
+	axmm__phased_unlock_live();
+	p->pNextLive = AXMM_NULL(axmm_phased_heap_t);
+
+	/* other threads' bindings are found to be stale when they run out of free ones */
+	axmm__phased_forget_binding( p );
+
 	if( p->uFlags & axmem__phasedf_usrptr ) {
 		axmm__phased_protect_rw( p->pBaseBlock, (axmm__c(axmm_size_t)(p->cMaxBlocks))*AXMM_BLOCK_SIZE );
 	} else {
@@ -2034,70 +2545,114 @@ AXMM_FUNC axmm_phased_heap_t *AXMM_CALL axmm_phased_fini( axmm_phased_heap_t *p
 	p->pBaseBlock = AXMM_NULL(void);
 	p->cMaxBlocks = 0;
 
+	axmm_page_release( p->pThreads, AXMM__PHASED_THREAD_STRIDE*AXMM_MAX_THREADS );
+	p->pThreads = AXMM_NULL(void);
+	p->cThreads = 0;
+	p->cThreadBytes = 0;
+	p->pFreeThreads = AXMM_NULL(axmm__phased_heap_thread_t);
+
 	return AXMM_NULL(axmm_phased_heap_t);
 }
 #else
 ;
 #endif
 
-/* Retrieve the axmm__phased_heap_thread_t for the current thread and the given phased-heap */
-AXMM_FUNC axmm__phased_heap_thread_t *AXMM_CALL axmm_phased_thread( axmm_phased_heap_t *p )
+/* Retrieve the per-thread record at index `i` of the phased-heap */
+#define AXMM__PHASED_THREAD_AT(Heap_,Index_)\
+	( axmm__rc( axmm__phased_heap_thread_t * )( axmm__rc( axmm_size_t )( (Heap_)->pThreads ) + axmm__c( axmm_size_t )( Index_ )*AXMM__PHASED_THREAD_STRIDE ) )
+
 #if AXMM_IMPLEMENT
+/* implementation: find a binding the current thread can use for a new heap, reclaiming one to a finished heap if needed */
+static axmm__phased_binding_t *AXMM_CALL axmm__phased_free_binding( void )
 {
-	axmm_u32_t uWorkerId;
+	axmm__phased_binding_t *b;
+	axmm_u32_t i;
 
-	uWorkerId = axmm_get_worker_id();
-	if( uWorkerId >= AXMM_MAX_THREADS ) {
-		return AXMM_NULL(axmm__phased_heap_thread_t);
+	for( i = 0; i < AXMM_MAX_HEAPS_PER_THREAD; ++i ) {
+		if( !axmm__g_phasedBindings[ i ].pHeap ) {
+			return &axmm__g_phasedBindings[ i ];
+		}
 	}
 
-	return &p->threads[ uWorkerId ];
-}
-#else
-;
-#endif
+	for( i = 0; i < AXMM_MAX_HEAPS_PER_THREAD; ++i ) {
+		b = &axmm__g_phasedBindings[ i ];
+		if( !axmm__phased_is_live( b->pHeap, b->uSerial ) ) {
+			/* the record went away with its heap */
+			b->pHeap = AXMM_NULL(axmm_phased_heap_t);
+			b->uSerial = 0;
+			b->pThread = AXMM_NULL(axmm__phased_heap_thread_t);
+			return b;
+		}
+	}
 
-/* Fetch a single block from the phased-heap (this is not a user allocation) */
-AXMM_FUNC void *AXMM_CALL axmm__phased_block_fetch( axmm_phased_heap_t *p, unsigned uTag )
-#if AXMM_IMPLEMENT
+	return AXMM_NULL(axmm__phased_binding_t);
+}
+/* implementation: acquire the per-thread record lock */
+static void AXMM_CALL axmm__phased_lock_threads( axmm_phased_heap_t *p )
 {
-	AXMM_BLOCK_INDEX_TYPE uBlockIndex;
-	axmm_u32_t uFetchedPos = 0;
+	while( axmm_atomic_xchg32( &p->uThreadLock, 1 ) != 0 ) {
+		axmm_spin();
+	}
+}
+/* implementation: release the per-thread record lock */
+static void AXMM_CALL axmm__phased_unlock_threads( axmm_phased_heap_t *p )
+{
+	axmm_atomic_xchg32( &p->uThreadLock, 0 );
+}
+/* implementation: take a record from the free list, or initialize a new one */
+static axmm__phased_heap_thread_t *AXMM_CALL axmm__phased_new_thread( axmm_phased_heap_t *p )
+{
+	axmm__phased_heap_thread_t *t;
+	axmm_size_t cNeededBytes, cPageBytes;
+	axmm_u32_t i;
 
-	for(;;) {
-		/* (1) Fetch-add on the split position */
-		uFetchedPos = axmm_atomic_add32( &p->uSplitPos, 1 );
-		if( ~uFetchedPos & 0x80000000 ) {
-			break;
+	axmm__phased_lock_threads( p );
+
+	if( ( t = p->pFreeThreads ) != AXMM_NULL(axmm__phased_heap_thread_t) ) {
+		p->pFreeThreads = t->pNextFree;
+		axmm__phased_unlock_threads( p );
+
+		t->pNextFree = AXMM_NULL(axmm__phased_heap_thread_t);
+		return t;
+	}
+
+	if( p->cThreads >= AXMM_MAX_THREADS ) {
+		axmm__phased_unlock_threads( p );
+		return AXMM_NULL(axmm__phased_heap_thread_t);
+	}
+
+	cNeededBytes = axmm__c( axmm_size_t )( p->cThreads + 1 )*AXMM__PHASED_THREAD_STRIDE;
+	if( cNeededBytes > p->cThreadBytes ) {
+		cPageBytes = axmm_get_page_size();
+		cNeededBytes = ( cNeededBytes + cPageBytes - 1 ) & ~( cPageBytes - 1 );
+
+		if( !axmm_page_commit( axmm__rc( void * )( axmm__rc( axmm_size_t )( p->pThreads ) + p->cThreadBytes ), cNeededBytes - p->cThreadBytes, axmem_pp_rw ) ) {
+			axmm__phased_unlock_threads( p );
+			return AXMM_NULL(axmm__phased_heap_thread_t);
 		}
 
-		/* (2) High-bit is set (a lock is held); wait for release */
-		do {
-			axmm_spin();
-			uFetchedPos = *axmm__c( volatile axmm_u32_t * )( &p->uSplitPos );
-		} while( uFetchedPos & 0x80000000 );
+		p->cThreadBytes = cNeededBytes;
 	}
 
-	/* (3) Split position is out of range; out of memory */
-	if( uFetchedPos >= p->cMaxBlocks ) {
-		return AXMM_NULL(void);
+	t = AXMM__PHASED_THREAD_AT( p, p->cThreads );
+	for( i = 0; i < AXMM_MAX_TAGS; ++i ) {
+		t->workingBlocks[ i ].pBlockBase = AXMM_NULL(void);
+		t->workingBlocks[ i ].cBytesUsed = AXMM_BLOCK_SIZE;
+#if AXMM_PHASED_STATS_ENABLED
+		t->stats[ i ].cBlocks = 0;
+		t->stats[ i ].cPeakBlocks = 0;
+		t->stats[ i ].cBytesUsed = 0;
+		t->stats[ i ].cBytesWasted = 0;
+#endif
 	}
+	t->pNextFree = AXMM_NULL(axmm__phased_heap_thread_t);
 
-	/* (4) Set the tag for this block */
-	uBlockIndex = p->blockIndexes[ uFetchedPos ] & ( AXMM_MAX_INDEXES - 1 );
-	p->blockIndexes[ uFetchedPos ] =
-		uBlockIndex |
-		axmm__c( AXMM_BLOCK_INDEX_TYPE )( uTag << AXMM_BLOCK_INDEX_BITS );
+	/* publish the record to `axmm_phased_free()` only once it's initialized */
+	axmm_atomic_add32( &p->cThreads, 1 );
 
-	/* Done */
-	return
-		axmm__rc( void * )(
-			((axmm_size_t)p->pBaseBlock) +
-			((axmm_size_t)uBlockIndex)*AXMM_BLOCK_SIZE
-		);
+	axmm__phased_unlock_threads( p );
+	return t;
 }
-#else
-;
 #endif
 
 AXMM_FUNC axmm_u32_t AXMM_CALL axmm__phased_lock( axmm_phased_heap_t *p )
@@ -2108,12 +2663,17 @@ AXMM_FUNC axmm_u32_t AXMM_CALL axmm__phased_lock( axmm_phased_heap_t *p )
 	for(;;) {
 		uSplitPos = p->uSplitPos;
 
-		uSplitPos = axmm_atomic_cmpxchg32( &p->uSplitPos, uSplitPos|0x80000000, uSplitPos&0x7FFFFFFF );
-		if( uSplitPos & 0x80000000 ) {
+		uSplitPos &= 0x7FFFFFFF;
+		if( axmm_atomic_cmpxchg32( &p->uSplitPos, uSplitPos|0x80000000, uSplitPos ) != uSplitPos ) {
 			axmm_spin();
 			continue;
 		}
 
+		/* Wait for in-flight block fetches to finish marking their blocks */
+		while( axmm_atomic_cmpxchg32( &p->cWriters, 0, 0 ) != 0 ) {
+			axmm_spin();
+		}
+
 		return uSplitPos;
 	}
 }
@@ -2129,7 +2689,341 @@ AXMM_FUNC void AXMM_CALL axmm__phased_unlock( axmm_phased_heap_t *p, axmm_u32_t
 ;
 #endif
 
-/* Allocate memory from the phased-heap */
+#if AXMM_IMPLEMENT
+/* implementation: hand a partially used working block back to the heap as a spare for `uTag` (the lock must be held) */
+static void AXMM_CALL axmm__phased_push_spare( axmm_phased_heap_t *p, axmm_u32_t uTag, const axmm__phased_block_t *tb )
+{
+	axmm__phased_spare_t *s;
+
+	/* a full block has no room for the link, nor anything to offer */
+	if( !tb->pBlockBase || tb->cBytesUsed + 16 > AXMM_BLOCK_SIZE ) {
+		return;
+	}
+
+	s = AXMM__PHASED_SPARE_OF( tb->pBlockBase );
+	s->pNext = p->pSpareBlocks[ uTag ];
+	s->cBytesUsed = tb->cBytesUsed;
+	p->pSpareBlocks[ uTag ] = tb->pBlockBase;
+}
+/* implementation: allocate `cBytes` from the first spare block of `uTag` if it has room, keeping whichever of it and the working block has more space (returns NULL otherwise) */
+static void *AXMM_CALL axmm__phased_spare_alloc( axmm_phased_heap_t *p, axmm__phased_heap_thread_t *t, unsigned uTag, axmm_u32_t cBytes )
+{
+	axmm__phased_block_t *tb;
+	axmm__phased_spare_t *s;
+	axmm_u32_t uSplitPos, cBytesUsed;
+	void *b, *u;
+
+	uSplitPos = axmm__phased_lock( p );
+
+	b = p->pSpareBlocks[ uTag ];
+	if( !b ) {
+		axmm__phased_unlock( p, uSplitPos );
+		return AXMM_NULL(void);
+	}
+
+	s = AXMM__PHASED_SPARE_OF( b );
+	if( s->cBytesUsed + cBytes > AXMM_BLOCK_SIZE ) {
+		axmm__phased_unlock( p, uSplitPos );
+		return AXMM_NULL(void);
+	}
+
+	u = axmm__rc( void * )( axmm__rc( axmm_size_t )( b ) + s->cBytesUsed );
+	cBytesUsed = s->cBytesUsed + cBytes;
+
+	/* unlink before the allocation can overwrite the link */
+	p->pSpareBlocks[ uTag ] = s->pNext;
+
+	tb = &t->workingBlocks[ uTag ];
+	if( cBytesUsed < tb->cBytesUsed ) {
+		axmm__phased_push_spare( p, uTag, tb );
+		tb->pBlockBase = b;
+		tb->cBytesUsed = cBytesUsed;
+	} else {
+		axmm__phased_block_t sb;
+
+		sb.pBlockBase = b;
+		sb.cBytesUsed = cBytesUsed;
+		axmm__phased_push_spare( p, uTag, &sb );
+	}
+
+	axmm__phased_unlock( p, uSplitPos );
+	return u;
+}
+#endif
+
+/* Register the current thread with the phased-heap, returning its record (or NULL if no more threads can be registered) */
+AXMM_FUNC axmm__phased_heap_thread_t *AXMM_CALL axmm_phased_register_thread( axmm_phased_heap_t *p )
+#if AXMM_IMPLEMENT
+{
+	axmm__phased_binding_t *b;
+
+	if( ( b = axmm__phased_find_binding( p ) ) != AXMM_NULL(axmm__phased_binding_t) ) {
+		return b->pThread;
+	}
+
+	if( ( b = axmm__phased_free_binding() ) == AXMM_NULL(axmm__phased_binding_t) ) {
+		/* ERROR: This thread is registered with too many heaps */
+		return AXMM_NULL(axmm__phased_heap_thread_t);
+	}
+
+	b->pThread = axmm__phased_new_thread( p );
+	if( !b->pThread ) {
+		/* ERROR: Too many threads are registered with this heap */
+		return AXMM_NULL(axmm__phased_heap_thread_t);
+	}
+
+	b->pHeap = p;
+	b->uSerial = p->uSerial;
+
+	return b->pThread;
+}
+#else
+;
+#endif
+
+/* Unregister the current thread from the phased-heap -- its partially used working blocks go back to the heap */
+AXMM_FUNC void AXMM_CALL axmm_phased_unregister_thread( axmm_phased_heap_t *p )
+#if AXMM_IMPLEMENT
+{
+	axmm__phased_binding_t *b;
+	axmm__phased_block_t *tb;
+	axmm_u32_t uSplitPos, i;
+
+	if( ( b = axmm__phased_find_binding( p ) ) == AXMM_NULL(axmm__phased_binding_t) ) {
+		return;
+	}
+
+	/* `axmm_phased_free()` resets working blocks under the lock too */
+	uSplitPos = axmm__phased_lock( p );
+	for( i = 0; i < AXMM_MAX_TAGS; ++i ) {
+		tb = &b->pThread->workingBlocks[ i ];
+
+		axmm__phased_push_spare( p, i, tb );
+		tb->pBlockBase = AXMM_NULL(void);
+		tb->cBytesUsed = AXMM_BLOCK_SIZE;
+	}
+	axmm__phased_unlock( p, uSplitPos );
+
+	axmm__phased_lock_threads( p );
+	b->pThread->pNextFree = p->pFreeThreads;
+	p->pFreeThreads = b->pThread;
+	axmm__phased_unlock_threads( p );
+
+	b->pHeap = AXMM_NULL(axmm_phased_heap_t);
+	b->uSerial = 0;
+	b->pThread = AXMM_NULL(axmm__phased_heap_thread_t);
+}
+#else
+;
+#endif
+
+/* Unregister the current thread from every phased-heap it's registered with (call before a thread that used a phased-heap exits) */
+AXMM_FUNC void AXMM_CALL axmm_phased_thread_fini( void )
+#if AXMM_IMPLEMENT
+{
+	axmm__phased_binding_t *b;
+	axmm_u32_t i;
+
+	for( i = 0; i < AXMM_MAX_HEAPS_PER_THREAD; ++i ) {
+		b = &axmm__g_phasedBindings[ i ];
+		if( !b->pHeap ) {
+			continue;
+		}
+
+		if( axmm__phased_is_live( b->pHeap, b->uSerial ) ) {
+			axmm_phased_unregister_thread( b->pHeap );
+			continue;
+		}
+
+		b->pHeap = AXMM_NULL(axmm_phased_heap_t);
+		b->uSerial = 0;
+		b->pThread = AXMM_NULL(axmm__phased_heap_thread_t);
+	}
+}
+#else
+;
+#endif
+
+/* Retrieve the axmm__phased_heap_thread_t for the current thread and the given phased-heap (registering the thread if needed) */
+AXMM_FUNC axmm__phased_heap_thread_t *AXMM_CALL axmm_phased_thread( axmm_phased_heap_t *p )
+#if AXMM_IMPLEMENT
+{
+	axmm__phased_binding_t *b;
+
+	if( ( b = axmm__phased_find_binding( p ) ) != AXMM_NULL(axmm__phased_binding_t) ) {
+		return b->pThread;
+	}
+
+	return axmm_phased_register_thread( p );
+}
+#else
+;
+#endif
+
+/* Fetch a single block from the phased-heap (this is not a user allocation) */
+AXMM_FUNC void *AXMM_CALL axmm__phased_block_fetch( axmm_phased_heap_t *p, unsigned uTag )
+#if AXMM_IMPLEMENT
+{
+	AXMM_BLOCK_INDEX_TYPE uBlockIndex;
+	axmm_u32_t uFetchedPos = 0;
+
+	for(;;) {
+		/* (1) Announce the fetch so a lock holder waits for it */
+		axmm_atomic_add32( &p->cWriters, 1 );
+
+		/* (2) High-bit is set (a lock is held); wait for release */
+		uFetchedPos = *axmm__c( volatile axmm_u32_t * )( &p->uSplitPos );
+		if( uFetchedPos & 0x80000000 ) {
+			axmm_atomic_sub32( &p->cWriters, 1 );
+			do {
+				axmm_spin();
+				uFetchedPos = *axmm__c( volatile axmm_u32_t * )( &p->uSplitPos );
+			} while( uFetchedPos & 0x80000000 );
+			continue;
+		}
+
+		/* (3) Split position is out of range; out of memory */
+		if( uFetchedPos >= p->cMaxBlocks ) {
+			axmm_atomic_sub32( &p->cWriters, 1 );
+			return AXMM_NULL(void);
+		}
+
+		/* (4) Claim the slot; fails if another fetch or a lock got there first */
+		if( axmm_atomic_cmpxchg32( &p->uSplitPos, uFetchedPos + 1, uFetchedPos ) == uFetchedPos ) {
+			break;
+		}
+
+		axmm_atomic_sub32( &p->cWriters, 1 );
+	}
+
+	/* (5) Set the tag for this block */
+	uBlockIndex = p->blockIndexes[ uFetchedPos ] & ( AXMM_MAX_INDEXES - 1 );
+	p->blockIndexes[ uFetchedPos ] =
+		uBlockIndex |
+		axmm__c( AXMM_BLOCK_INDEX_TYPE )( uTag << AXMM_BLOCK_INDEX_BITS );
+
+	axmm_atomic_sub32( &p->cWriters, 1 );
+
+	/* Done */
+	return
+		axmm__rc( void * )(
+			((axmm_size_t)p->pBaseBlock) +
+			((axmm_size_t)uBlockIndex)*AXMM_BLOCK_SIZE
+		);
+}
+#else
+;
+#endif
+
+/* Fetch `cBlocks` adjacent blocks from the phased-heap (this is not a user allocation) */
+AXMM_FUNC void *AXMM_CALL axmm__phased_blocks_fetch( axmm_phased_heap_t *p, unsigned uTag, axmm_u32_t cBlocks )
+#if AXMM_IMPLEMENT
+{
+	/* One bit per block index; set if that block is in the free section */
+	axmm_u32_t freeBits[ AXMM_MAX_INDEXES/32 ];
+	AXMM_BLOCK_INDEX_TYPE uBlockIndex;
+	axmm_u32_t uSplitPos, uFreeEnd, uRunBase, cRun;
+	axmm_u32_t i;
+
+	axmm_assert( cBlocks > 0 );
+
+	/* (1) Acquire the lock */
+	uSplitPos = axmm__phased_lock( p );
+
+	uFreeEnd = p->cMaxBlocks;
+	if( uSplitPos >= uFreeEnd || uFreeEnd - uSplitPos < cBlocks ) {
+		axmm__phased_unlock( p, uSplitPos );
+		return AXMM_NULL(void);
+	}
+
+	/* (2) Search for enough contiguous blocks in the free section */
+	for( i = 0; i < AXMM_MAX_INDEXES/32; ++i ) {
+		freeBits[ i ] = 0;
+	}
+	for( i = uSplitPos; i < uFreeEnd; ++i ) {
+		uBlockIndex = p->blockIndexes[ i ] & AXMM_BLOCK_INDEX_MASK;
+		freeBits[ uBlockIndex/32 ] |= 1U<<( uBlockIndex%32 );
+	}
+
+	uRunBase = 0;
+	cRun = 0;
+	for( i = 0; i < uFreeEnd && cRun < cBlocks; ++i ) {
+		if( ~freeBits[ i/32 ] & ( 1U<<( i%32 ) ) ) {
+			cRun = 0;
+			continue;
+		}
+
+		if( !cRun++ ) {
+			uRunBase = i;
+		}
+	}
+
+	if( cRun < cBlocks ) {
+		/* ERROR: Too fragmented (or out of memory) */
+		axmm__phased_unlock( p, uSplitPos );
+		return AXMM_NULL(void);
+	}
+
+	/* (3) Move the run into the used section, adjusting the split position */
+	for( i = uSplitPos; i < uFreeEnd; ++i ) {
+		uBlockIndex = p->blockIndexes[ i ] & AXMM_BLOCK_INDEX_MASK;
+		if( uBlockIndex < uRunBase || uBlockIndex >= uRunBase + cBlocks ) {
+			continue;
+		}
+
+		p->blockIndexes[ i ] = p->blockIndexes[ uSplitPos ];
+		p->blockIndexes[ uSplitPos ] =
+			uBlockIndex |
+			axmm__c( AXMM_BLOCK_INDEX_TYPE )( uTag << AXMM_BLOCK_INDEX_BITS );
+		++uSplitPos;
+	}
+
+	/* (4) Release the lock */
+	axmm__phased_unlock( p, uSplitPos );
+
+	return
+		axmm__rc( void * )(
+			((axmm_size_t)p->pBaseBlock) +
+			((axmm_size_t)uRunBase)*AXMM_BLOCK_SIZE
+		);
+}
+#else
+;
+#endif
+
+#if AXMM_PHASED_STATS_ENABLED && AXMM_IMPLEMENT
+/* implementation: raise `*pPeak` to `uValue` if it's lower */
+static void AXMM_CALL axmm__phased_stats_peak( axmm_u32_t *pPeak, axmm_u32_t uValue )
+{
+	axmm_u32_t uPeak;
+
+	do {
+		uPeak = *axmm__c( volatile axmm_u32_t * )( pPeak );
+		if( uPeak >= uValue ) {
+			break;
+		}
+	} while( axmm_atomic_cmpxchg32( pPeak, uValue, uPeak ) != uPeak );
+}
+/* implementation: record `cBlocks` blocks fetched by thread `t` for `uTag`, wasting `cWastedBytes` */
+static void AXMM_CALL axmm__phased_stats_fetched( axmm_phased_heap_t *p, axmm__phased_heap_thread_t *t, unsigned uTag, axmm_u32_t cBlocks, axmm_u32_t cWastedBytes )
+{
+	axmm_phased_stats_t *ts;
+	axmm_u32_t cTagBlocks;
+
+	ts = &t->stats[ uTag ];
+	ts->cBlocks += cBlocks;
+	if( ts->cPeakBlocks < ts->cBlocks ) {
+		ts->cPeakBlocks = ts->cBlocks;
+	}
+	ts->cBytesWasted += cWastedBytes;
+
+	cTagBlocks = axmm_atomic_add32( &p->cTagBlocks[ uTag ], cBlocks ) + cBlocks;
+	axmm__phased_stats_peak( &p->cTagPeakBlocks[ uTag ], cTagBlocks );
+	axmm__phased_stats_peak( &p->cPeakBlocks, *axmm__c( volatile axmm_u32_t * )( &p->uSplitPos ) & 0x7FFFFFFF );
+}
+#endif
+
+/* Allocate memory from the phased-heap */
 AXMM_FUNC void *AXMM_CALL axmm_phased_alloc( axmm_phased_heap_t *p, unsigned uTag, axmm_size_t cBytes )
 #if AXMM_IMPLEMENT
 {
@@ -2141,20 +3035,6 @@ AXMM_FUNC void *AXMM_CALL axmm_phased_alloc( axmm_phased_heap_t *p, unsigned uTa
 		cBytes += 16 - cBytes%16;
 	}
 
-	if( cBytes > AXMM_BLOCK_SIZE ) {
-		/* FIXME: Use contiguous allocation method instead of erroring */
-		/*
-		axmm__phased_lock( p );
-		② Search for enough contiguous blocks, and remove them from that
-		`  section of the array. (Again, order does not matter, but to speed up
-		`  the algorithm it is preferred that these blocks are kept in order.)
-		③ Adjust the split position (the allocated blocks should be in the
-		`  "used" section rather than the "free" section now). 
-		axmm__phased_unlock( p );
-		*/
-		return AXMM_NULL(void);
-	}
-
 	t = axmm_phased_thread( p );
 	if( !t ) {
 		/* ERROR: Cannot make an allocation from this thread */
@@ -2162,9 +3042,47 @@ AXMM_FUNC void *AXMM_CALL axmm_phased_alloc( axmm_phased_heap_t *p, unsigned uTa
 	}
 
 	tb = &t->workingBlocks[ uTag ];
-	if( tb->cBytesUsed + cBytes > AXMM_BLOCK_SIZE ) {
+	if( cBytes > AXMM_BLOCK_SIZE ) {
+		axmm_u32_t cBlocks, cLastBytes;
+
+		cBlocks = axmm__c( axmm_u32_t )( AXMM__INTDIV( cBytes, AXMM_BLOCK_SIZE ) );
+		cLastBytes = axmm__c( axmm_u32_t )( cBytes - ( axmm__c( axmm_size_t )( cBlocks - 1 ) )*AXMM_BLOCK_SIZE );
+
+		u = axmm__phased_blocks_fetch( p, uTag, cBlocks );
+		if( !u ) {
+			/* ERROR: Out of memory (or no run of free blocks is long enough) */
+			return AXMM_NULL(void);
+		}
+
+		/* Waste whichever has less space: the working block or the last block of the run */
+		if( cLastBytes < tb->cBytesUsed ) {
+#if AXMM_PHASED_STATS_ENABLED
+			axmm__phased_stats_fetched( p, t, uTag, cBlocks, AXMM_BLOCK_SIZE - tb->cBytesUsed );
+#endif
+			tb->pBlockBase = axmm__rc( void * )( axmm__rc( axmm_size_t )( u ) + ( axmm__c( axmm_size_t )( cBlocks - 1 ) )*AXMM_BLOCK_SIZE );
+			tb->cBytesUsed = cLastBytes;
+		}
+#if AXMM_PHASED_STATS_ENABLED
+		else {
+			axmm__phased_stats_fetched( p, t, uTag, cBlocks, AXMM_BLOCK_SIZE - cLastBytes );
+		}
+#endif
+
+		axmm__phased_commit( u, ( axmm__c( axmm_size_t )( cBlocks ) )*AXMM_BLOCK_SIZE );
+	} else if( tb->cBytesUsed + cBytes > AXMM_BLOCK_SIZE ) {
 		void *b;
 
+		/* Continue a block handed back by an unregistered thread before taking a new one */
+		if( *axmm__c( void *volatile * )( &p->pSpareBlocks[ uTag ] ) != AXMM_NULL(void) ) {
+			u = axmm__phased_spare_alloc( p, t, uTag, axmm__c( axmm_u32_t )( cBytes ) );
+			if( u != AXMM_NULL(void) ) {
+#if AXMM_PHASED_STATS_ENABLED
+				t->stats[ uTag ].cBytesUsed += cBytes;
+#endif
+				return u;
+			}
+		}
+
 		b = axmm__phased_block_fetch( p, uTag );
 		if( !b ) {
 			/* ERROR: Out of memory */
@@ -2173,9 +3091,17 @@ AXMM_FUNC void *AXMM_CALL axmm_phased_alloc( axmm_phased_heap_t *p, unsigned uTa
 
 		u = b;
 		if( cBytes < tb->cBytesUsed ) {
+#if AXMM_PHASED_STATS_ENABLED
+			axmm__phased_stats_fetched( p, t, uTag, 1, AXMM_BLOCK_SIZE - tb->cBytesUsed );
+#endif
 			tb->pBlockBase = b;
 			tb->cBytesUsed = axmm__c( axmm_u32_t )( cBytes );
 		}
+#if AXMM_PHASED_STATS_ENABLED
+		else {
+			axmm__phased_stats_fetched( p, t, uTag, 1, axmm__c( axmm_u32_t )( AXMM_BLOCK_SIZE - cBytes ) );
+		}
+#endif
 
 		axmm__phased_commit( b, AXMM_BLOCK_SIZE );
 	} else {
@@ -2183,6 +3109,10 @@ AXMM_FUNC void *AXMM_CALL axmm_phased_alloc( axmm_phased_heap_t *p, unsigned uTa
 		tb->cBytesUsed += axmm__c( axmm_u32_t )( cBytes );
 	}
 
+#if AXMM_PHASED_STATS_ENABLED
+	t->stats[ uTag ].cBytesUsed += cBytes;
+#endif
+
 	return u;
 }
 #else
@@ -2193,8 +3123,9 @@ AXMM_FUNC void *AXMM_CALL axmm_phased_alloc( axmm_phased_heap_t *p, unsigned uTa
 AXMM_FUNC void AXMM_CALL axmm_phased_free( axmm_phased_heap_t *p, unsigned uTag )
 #if AXMM_IMPLEMENT
 {
+	axmm__phased_heap_thread_t *t;
 	AXMM_BLOCK_INDEX_TYPE uBlockIndex;
-	axmm_u32_t uSplitPos;
+	axmm_u32_t uSplitPos, cThreads;
 	axmm_u32_t uIndexPlusOne, i;
 	unsigned uTestTag;
 
@@ -2224,16 +3155,82 @@ AXMM_FUNC void AXMM_CALL axmm_phased_free( axmm_phased_heap_t *p, unsigned uTag
 		p->blockIndexes[ i ] = p->blockIndexes[ uSplitPos ];
 		p->blockIndexes[ uSplitPos ] = uBlockIndex;
 	}
-	for( i = 0; i < AXMM_MAX_THREADS; ++i ) {
-		p->threads[ i ].workingBlocks[ uTag ].pBlockBase = AXMM_NULL(void);
-		p->threads[ i ].workingBlocks[ uTag ].cBytesUsed = AXMM_BLOCK_SIZE;
+	p->pSpareBlocks[ uTag ] = AXMM_NULL(void);
+	cThreads = *axmm__c( volatile axmm_u32_t * )( &p->cThreads );
+	for( i = 0; i < cThreads; ++i ) {
+		t = AXMM__PHASED_THREAD_AT( p, i );
+
+		t->workingBlocks[ uTag ].pBlockBase = AXMM_NULL(void);
+		t->workingBlocks[ uTag ].cBytesUsed = AXMM_BLOCK_SIZE;
+#if AXMM_PHASED_STATS_ENABLED
+		t->stats[ uTag ].cBlocks = 0;
+		t->stats[ uTag ].cBytesUsed = 0;
+		t->stats[ uTag ].cBytesWasted = 0;
+#endif
 	}
+#if AXMM_PHASED_STATS_ENABLED
+	p->cTagBlocks[ uTag ] = 0;
+#endif
 	axmm__phased_unlock( p, uSplitPos );
 }
 #else
 ;
 #endif
 
+#if AXMM_PHASED_STATS_ENABLED
+/* Retrieve the statistics of a tag across all threads */
+AXMM_FUNC void AXMM_CALL axmm_phased_get_tag_stats( const axmm_phased_heap_t *p, unsigned uTag, axmm_phased_stats_t *pStats )
+# if AXMM_IMPLEMENT
+{
+	const axmm__phased_heap_thread_t *t;
+	axmm_u32_t i, cThreads;
+
+	axmm_assert( uTag < AXMM_MAX_TAGS );
+	axmm_assert( pStats != AXMM_NULL(axmm_phased_stats_t) );
+
+	pStats->cBlocks = *axmm__c( const volatile axmm_u32_t * )( &p->cTagBlocks[ uTag ] );
+	pStats->cPeakBlocks = *axmm__c( const volatile axmm_u32_t * )( &p->cTagPeakBlocks[ uTag ] );
+	pStats->cBytesUsed = 0;
+	pStats->cBytesWasted = 0;
+
+	/* unregistered records still count; their blocks are held until the tag is freed */
+	cThreads = *axmm__c( const volatile axmm_u32_t * )( &p->cThreads );
+	for( i = 0; i < cThreads; ++i ) {
+		t = AXMM__PHASED_THREAD_AT( p, i );
+
+		pStats->cBytesUsed += t->stats[ uTag ].cBytesUsed;
+		pStats->cBytesWasted += t->stats[ uTag ].cBytesWasted;
+	}
+}
+# else
+;
+# endif
+
+/* Retrieve the statistics of a tag for a single thread's record (from `axmm_phased_register_thread()`) */
+AXMM_FUNC void AXMM_CALL axmm_phased_get_thread_stats( const axmm__phased_heap_thread_t *t, unsigned uTag, axmm_phased_stats_t *pStats )
+# if AXMM_IMPLEMENT
+{
+	axmm_assert( t != AXMM_NULL(axmm__phased_heap_thread_t) );
+	axmm_assert( uTag < AXMM_MAX_TAGS );
+	axmm_assert( pStats != AXMM_NULL(axmm_phased_stats_t) );
+
+	*pStats = t->stats[ uTag ];
+}
+# else
+;
+# endif
+
+/* Retrieve the highest number of blocks that have been in use at once (across all tags) */
+AXMM_FUNC axmm_u32_t AXMM_CALL axmm_phased_get_peak_blocks( const axmm_phased_heap_t *p )
+# if AXMM_IMPLEMENT
+{
+	return *axmm__c( const volatile axmm_u32_t * )( &p->cPeakBlocks );
+}
+# else
+;
+# endif
+#endif
+
 AXMM__LEAVE_C
 
 #if AXMM_CXX_ENABLED
@@ -2266,10 +3263,818 @@ namespace ax
 		{
 			axmm_phased_free( this, uTag );
 		}
-	};
 
-}
-#endif
+		AXMM_FORCEINLINE bool registerThread()
+		{
+			return axmm_phased_register_thread( this ) != AXMM_NULL(axmm__phased_heap_thread_t);
+		}
+		AXMM_FORCEINLINE void unregisterThread()
+		{
+			axmm_phased_unregister_thread( this );
+		}
+
+#if AXMM_PHASED_STATS_ENABLED
+		AXMM_FORCEINLINE axmm_phased_stats_t tagStats( unsigned uTag ) const
+		{
+			axmm_phased_stats_t stats;
+			axmm_phased_get_tag_stats( this, uTag, &stats );
+			return stats;
+		}
+		AXMM_FORCEINLINE axmm_phased_stats_t threadStats( unsigned uTag )
+		{
+			axmm_phased_stats_t stats;
+			axmm_phased_get_thread_stats( axmm_phased_thread( this ), uTag, &stats );
+			return stats;
+		}
+		AXMM_FORCEINLINE axmm_u32_t peakBlocks() const
+		{
+			return axmm_phased_get_peak_blocks( this );
+		}
+#endif
+	};
+
+}
+#endif
+
+
+
+
+/*
+===============================================================================
+
+	Slab Allocator
+	--------------
+
+	General purpose allocator for small objects with mixed lifetimes (list
+	nodes, dictionary entries, string objects, etc).
+
+	- One contiguous range of address space is reserved (on first use) and
+	  split into slabs of `AXMM_SLAB_SIZE` bytes. Each slab is aligned to its
+	  size, so the header of the slab owning any object is found by masking the
+	  object's address.
+	- Each slab holds objects of one size class. There are eight classes in
+	  16-byte steps up to 128 bytes, then four classes per power of two up to
+	  `AXMM_SLAB_MAX_OBJECT_SIZE`. Larger requests go to `axmm_def_alloc`.
+	- Every thread has a cache with a list of slabs per size class. The owning
+	  thread allocates from (and frees to) its own slabs without any atomic
+	  operations.
+	- Frees from other threads are pushed onto the slab's "remote free" stack.
+	  The first such free also queues the slab on its owner's "pending" stack,
+	  so the owner collects the whole batch with a single exchange the next
+	  time it runs out of objects in a slab.
+	- When a slab becomes empty (and is not the slab currently being allocated
+	  from) all of its pages but the first are decommitted and the slab goes to
+	  a global free list, where any size class can pick it up again.
+	- Call `axmm_slab_thread_fini()` before a thread that used the allocator
+	  exits. Its slabs are abandoned to a per-class list for other threads to
+	  adopt, and its cache is recycled.
+
+	Allocations and frees are reported to the allocation listeners (see
+	`axmm_add_listener()`) when any are installed.
+
+===============================================================================
+*/
+
+AXMM__ENTER_C
+
+#ifndef AXMM_SLAB_SIZE
+/* Size of each slab -- must be a power of two and a multiple of the page size */
+# define AXMM_SLAB_SIZE             (64*1024)
+#endif
+
+#ifndef AXMM_SLAB_RESERVE_SIZE
+/* Amount of address space to reserve for slabs (committed one slab at a time) */
+# define AXMM_SLAB_RESERVE_SIZE\
+	axmm__c( axmm_size_t )( sizeof( void * ) > 4 ? ( axmm__c( axmm_u64_t )( 16 )<<30 ) : ( axmm__c( axmm_u64_t )( 256 )<<20 ) )
+#endif
+
+#ifndef AXMM_SLAB_MAX_CACHES
+/* Maximum number of threads that can have a slab cache at once */
+# define AXMM_SLAB_MAX_CACHES       1024
+#endif
+
+/* Largest object served from a slab */
+#define AXMM_SLAB_MAX_OBJECT_SIZE   4096
+/* Number of size classes (see above) */
+#define AXMM__SLAB_NUM_CLASSES      28
+
+/* Number of bytes at the start of each slab reserved for its header */
+#define AXMM__SLAB_HEADER_BYTES     ( 2*AXMM_CACHE_SIZE )
+
+/* Header at the start of each slab */
+typedef struct axmm__slab_s
+{
+	/* Neighbors in the owner's list for this size class (or in the abandoned list) */
+	struct axmm__slab_s *           pPrev;
+	struct axmm__slab_s *           pNext;
+	/* Objects freed by the owner (or collected from `uRemoteFree`) */
+	void *                          pLocalFree;
+	/* Offset of the first byte that has never been handed out */
+	axmm_u32_t                      uBump;
+	/* Number of objects currently handed out */
+	axmm_u32_t                      cUsed;
+	/* Size class and object size */
+	axmm_u32_t                      uClass;
+	axmm_u32_t                      cObjectBytes;
+	/* Set if this slab is on its owner's "full" list rather than the available list */
+	axmm_u32_t                      bFull;
+
+	/* Keep the fields written by other threads off of the owner's cache line */
+	axmm_u8_t                       padding             [ AXMM_CACHE_SIZE - 3*sizeof( void * ) - 5*sizeof( axmm_u32_t ) ];
+
+	/* Owning cache, or NULL if this slab is abandoned or free */
+	struct axmm__slab_cache_s *volatile pOwner;
+	/* Offset of the first object freed by another thread (atomic stack; 0 if empty) */
+	axmm_u32_t                      uRemoteFree;
+	/* Set while this slab is linked into a cache's pending stack (atomic) */
+	axmm_u32_t                      uPendingFlag;
+	/* Next slab (index plus one) in the pending stack */
+	axmm_u32_t                      uNextPending;
+	/* Next slab (index plus one) in the global free list */
+	axmm_u32_t                      uNextFreeSlab;
+} axmm__slab_t;
+
+/* A thread's slabs for a single size class */
+typedef struct axmm__slab_class_cache_s
+{
+	/* Slabs with space available -- the head is the slab being allocated from */
+	axmm__slab_t *                  pHead;
+	/* Slabs that had no space left the last time they were checked */
+	axmm__slab_t *                  pFull;
+} axmm__slab_class_cache_t;
+
+/* Per-thread cache for the slab allocator */
+typedef struct axmm__slab_cache_s
+{
+	/* Slabs owned by this cache for each size class */
+	axmm__slab_class_cache_t        classes             [ AXMM__SLAB_NUM_CLASSES ];
+	/* Slabs (index plus one) that have received remote frees (atomic stack; 0 if empty) */
+	axmm_u32_t                      uPending;
+	/* Next cache in the free list (only valid while unused) */
+	struct axmm__slab_cache_s *     pNextFree;
+} axmm__slab_cache_t;
+
+/* Distance between caches -- rounded up to the cache line size to avoid false sharing */
+#define AXMM__SLAB_CACHE_STRIDE\
+	( ( sizeof( axmm__slab_cache_t ) + AXMM_CACHE_SIZE - 1 ) & ~( axmm__c( axmm_size_t )( AXMM_CACHE_SIZE - 1 ) ) )
+
+#if AXMM_IMPLEMENT
+/* implementation: global state of the slab allocator */
+typedef struct axmm__slab_heap_s
+{
+	/* Base of the slabs (aligned to `AXMM_SLAB_SIZE`) */
+	axmm_u8_t *                     pBase;
+	/* Number of slabs that fit in the reservation */
+	axmm_u32_t                      cMaxSlabs;
+	/* Number of slabs that have ever been handed out (atomic) */
+	axmm_u32_t                      cUsedSlabs;
+	/* Empty slabs (index plus one) with all but their first page decommitted */
+	axmm_u32_t                      uFreeSlabs;
+	/* Lock for `uFreeSlabs`, `abandoned`, and the cache fields below */
+	axmm_u32_t                      uLock;
+	/* Slabs left behind by threads that finished */
+	axmm__slab_t *                  abandoned           [ AXMM__SLAB_NUM_CLASSES ];
+	/* Per-thread caches (`AXMM_SLAB_MAX_CACHES` reserved; `cCaches` initialized) */
+	axmm_u8_t *                     pCaches;
+	axmm_u32_t                      cCaches;
+	axmm_size_t                     cCacheBytes;
+	axmm__slab_cache_t *            pFreeCaches;
+	/* Page size (cached) */
+	axmm_size_t                     cPageBytes;
+	/* 0 = uninitialized, 1 = initializing, 2 = ready, 3 = failed */
+	axmm_u32_t                      uState;
+} axmm__slab_heap_t;
+
+static axmm__slab_heap_t axmm__g_slab;
+static AXMM_THREADLOCAL axmm__slab_cache_t *axmm__g_pSlabCache = AXMM_NULL(axmm__slab_cache_t);
+
+/* implementation: find the size class for a request of `cBytes` (1 to `AXMM_SLAB_MAX_OBJECT_SIZE`) */
+static axmm_u32_t AXMM_CALL axmm__slab_class( axmm_size_t cBytes )
+{
+	axmm_u32_t n, uBit;
+
+	if( cBytes <= 128 ) {
+		return axmm__c( axmm_u32_t )( ( cBytes + 15 )/16 ) - ( cBytes > 0 ? 1 : 0 );
+	}
+
+	n = axmm__c( axmm_u32_t )( cBytes - 1 );
+	uBit = 7;
+	while( ( n >> ( uBit + 1 ) ) != 0 ) {
+		++uBit;
+	}
+
+	return 8 + ( uBit - 7 )*4 + ( ( n >> ( uBit - 2 ) ) & 3 );
+}
+/* implementation: size of the objects in a size class */
+static axmm_u32_t AXMM_CALL axmm__slab_class_size( axmm_u32_t uClass )
+{
+	axmm_u32_t uBit;
+
+	if( uClass < 8 ) {
+		return ( uClass + 1 )*16;
+	}
+
+	uBit = 7 + ( uClass - 8 )/4;
+	return ( 1U << uBit ) + ( ( uClass - 8 )%4 + 1 )*( 1U << ( uBit - 2 ) );
+}
+
+/* implementation: slab containing `p` (which must be within the slab reservation) */
+#define AXMM__SLAB_OF(P_)\
+	( axmm__rc( axmm__slab_t * )( axmm__rc( axmm_size_t )( P_ ) & ~( axmm__c( axmm_size_t )( AXMM_SLAB_SIZE - 1 ) ) ) )
+/* implementation: index of slab `S_` */
+#define AXMM__SLAB_INDEX(S_)\
+	( axmm__c( axmm_u32_t )( ( axmm__rc( axmm_u8_t * )( S_ ) - axmm__g_slab.pBase )/AXMM_SLAB_SIZE ) )
+/* implementation: slab at index `I_` */
+#define AXMM__SLAB_AT(I_)\
+	( axmm__rc( axmm__slab_t * )( axmm__g_slab.pBase + axmm__c( axmm_size_t )( I_ )*AXMM_SLAB_SIZE ) )
+
+/* implementation: acquire the slab allocator's global lock */
+static void AXMM_CALL axmm__slab_lock( void )
+{
+	while( axmm_atomic_xchg32( &axmm__g_slab.uLock, 1 ) != 0 ) {
+		axmm_spin();
+	}
+}
+/* implementation: release the slab allocator's global lock */
+static void AXMM_CALL axmm__slab_unlock( void )
+{
+	axmm_atomic_xchg32( &axmm__g_slab.uLock, 0 );
+}
+
+/* implementation: reserve the slabs if that hasn't happened yet; returns 0 on failure */
+static int AXMM_CALL axmm__slab_init( void )
+{
+	axmm_u8_t *pReserved;
+	axmm_u32_t uState;
+
+	for(;;) {
+		uState = axmm_atomic_cmpxchg32( &axmm__g_slab.uState, 1, 0 );
+		if( uState == 0 ) {
+			break;
+		}
+		if( uState == 2 ) {
+			return 1;
+		}
+		if( uState == 3 ) {
+			return 0;
+		}
+
+		axmm_spin();
+	}
+
+	/* over-reserve by one slab so the base can be aligned to the slab size */
+	pReserved = axmm__c( axmm_u8_t * )( axmm_page_reserve( AXMM_SLAB_RESERVE_SIZE + AXMM_SLAB_SIZE ) );
+	axmm__g_slab.pCaches = axmm__c( axmm_u8_t * )( axmm_page_reserve( AXMM__SLAB_CACHE_STRIDE*AXMM_SLAB_MAX_CACHES ) );
+	if( !pReserved || !axmm__g_slab.pCaches ) {
+		axmm_atomic_xchg32( &axmm__g_slab.uState, 3 );
+		return 0;
+	}
+
+	axmm__g_slab.pBase = axmm__rc( axmm_u8_t * )( ( axmm__rc( axmm_size_t )( pReserved ) + AXMM_SLAB_SIZE - 1 ) & ~( axmm__c( axmm_size_t )( AXMM_SLAB_SIZE - 1 ) ) );
+	axmm__g_slab.cMaxSlabs = axmm__c( axmm_u32_t )( AXMM_SLAB_RESERVE_SIZE/AXMM_SLAB_SIZE );
+	axmm__g_slab.cPageBytes = axmm_get_page_size();
+
+	axmm_atomic_xchg32( &axmm__g_slab.uState, 2 );
+	return 1;
+}
+
+/* implementation: retrieve (or create) the calling thread's cache */
+static axmm__slab_cache_t *AXMM_CALL axmm__slab_cache( void )
+{
+	axmm__slab_cache_t *c;
+	axmm_size_t cNeededBytes;
+	axmm_u32_t i;
+
+	if( ( c = axmm__g_pSlabCache ) != AXMM_NULL(axmm__slab_cache_t) ) {
+		return c;
+	}
+
+	if( !axmm__slab_init() ) {
+		return AXMM_NULL(axmm__slab_cache_t);
+	}
+
+	axmm__slab_lock();
+	if( ( c = axmm__g_slab.pFreeCaches ) != AXMM_NULL(axmm__slab_cache_t) ) {
+		axmm__g_slab.pFreeCaches = c->pNextFree;
+	} else if( axmm__g_slab.cCaches < AXMM_SLAB_MAX_CACHES ) {
+		cNeededBytes = axmm__c( axmm_size_t )( axmm__g_slab.cCaches + 1 )*AXMM__SLAB_CACHE_STRIDE;
+		cNeededBytes = ( cNeededBytes + axmm__g_slab.cPageBytes - 1 ) & ~( axmm__g_slab.cPageBytes - 1 );
+		if( cNeededBytes > axmm__g_slab.cCacheBytes ) {
+			if( !axmm_page_commit( axmm__g_slab.pCaches + axmm__g_slab.cCacheBytes, cNeededBytes - axmm__g_slab.cCacheBytes, axmem_pp_rw ) ) {
+				axmm__slab_unlock();
+				return AXMM_NULL(axmm__slab_cache_t);
+			}
+			axmm__g_slab.cCacheBytes = cNeededBytes;
+		}
+
+		c = axmm__rc( axmm__slab_cache_t * )( axmm__g_slab.pCaches + axmm__c( axmm_size_t )( axmm__g_slab.cCaches )*AXMM__SLAB_CACHE_STRIDE );
+		++axmm__g_slab.cCaches;
+	}
+	axmm__slab_unlock();
+
+	if( !c ) {
+		/* ERROR: Too many threads are using the slab allocator */
+		return AXMM_NULL(axmm__slab_cache_t);
+	}
+
+	for( i = 0; i < AXMM__SLAB_NUM_CLASSES; ++i ) {
+		c->classes[ i ].pHead = AXMM_NULL(axmm__slab_t);
+		c->classes[ i ].pFull = AXMM_NULL(axmm__slab_t);
+	}
+	/* `uPending` is left alone; stale entries from a previous owner are harmless */
+	c->pNextFree = AXMM_NULL(axmm__slab_cache_t);
+
+	axmm__g_pSlabCache = c;
+	return c;
+}
+
+/* implementation: unlink `s` from whichever of its owner's lists it is in */
+static void AXMM_CALL axmm__slab_unlink( axmm__slab_class_cache_t *cc, axmm__slab_t *s )
+{
+	if( s->pPrev != AXMM_NULL(axmm__slab_t) ) {
+		s->pPrev->pNext = s->pNext;
+	} else if( s->bFull ) {
+		cc->pFull = s->pNext;
+	} else {
+		cc->pHead = s->pNext;
+	}
+	if( s->pNext != AXMM_NULL(axmm__slab_t) ) {
+		s->pNext->pPrev = s->pPrev;
+	}
+
+	s->pPrev = AXMM_NULL(axmm__slab_t);
+	s->pNext = AXMM_NULL(axmm__slab_t);
+}
+/* implementation: link `s` into its owner's available list (at the head if `bHead` is set, otherwise just after it) */
+static void AXMM_CALL axmm__slab_link_available( axmm__slab_class_cache_t *cc, axmm__slab_t *s, int bHead )
+{
+	s->bFull = 0;
+	if( bHead || !cc->pHead ) {
+		s->pPrev = AXMM_NULL(axmm__slab_t);
+		s->pNext = cc->pHead;
+		if( cc->pHead != AXMM_NULL(axmm__slab_t) ) {
+			cc->pHead->pPrev = s;
+		}
+		cc->pHead = s;
+	} else {
+		s->pPrev = cc->pHead;
+		s->pNext = cc->pHead->pNext;
+		if( s->pNext != AXMM_NULL(axmm__slab_t) ) {
+			s->pNext->pPrev = s;
+		}
+		cc->pHead->pNext = s;
+	}
+}
+/* implementation: link `s` into its owner's full list */
+static void AXMM_CALL axmm__slab_link_full( axmm__slab_class_cache_t *cc, axmm__slab_t *s )
+{
+	s->bFull = 1;
+	s->pPrev = AXMM_NULL(axmm__slab_t);
+	s->pNext = cc->pFull;
+	if( cc->pFull != AXMM_NULL(axmm__slab_t) ) {
+		cc->pFull->pPrev = s;
+	}
+	cc->pFull = s;
+}
+
+/* implementation: decommit an empty slab (already unlinked) and put it on the global free list */
+static void AXMM_CALL axmm__slab_release( axmm__slab_t *s )
+{
+	s->pOwner = AXMM_NULL(axmm__slab_cache_t);
+	axmm_page_decommit( axmm__rc( axmm_u8_t * )( s ) + axmm__g_slab.cPageBytes, AXMM_SLAB_SIZE - axmm__g_slab.cPageBytes );
+
+	axmm__slab_lock();
+	s->uNextFreeSlab = axmm__g_slab.uFreeSlabs;
+	axmm__g_slab.uFreeSlabs = AXMM__SLAB_INDEX( s ) + 1;
+	axmm__slab_unlock();
+}
+
+/* implementation: move the remote frees of `s` onto its local free list; returns the number collected */
+static axmm_u32_t AXMM_CALL axmm__slab_collect( axmm__slab_t *s )
+{
+	axmm_u32_t uOffset, cCollected;
+	void *pObject;
+
+	uOffset = axmm_atomic_xchg32( &s->uRemoteFree, 0 );
+	cCollected = 0;
+	while( uOffset != 0 ) {
+		pObject = axmm__c( void * )( axmm__rc( axmm_u8_t * )( s ) + uOffset );
+		uOffset = *axmm__c( axmm_u32_t * )( pObject );
+
+		*axmm__c( void ** )( pObject ) = s->pLocalFree;
+		s->pLocalFree = pObject;
+		++cCollected;
+	}
+
+	s->cUsed -= cCollected;
+	return cCollected;
+}
+/* implementation: note that objects were returned to an owned slab, moving or releasing it as needed */
+static void AXMM_CALL axmm__slab_returned( axmm__slab_class_cache_t *cc, axmm__slab_t *s )
+{
+	if( !s->cUsed && s != cc->pHead ) {
+		axmm__slab_unlink( cc, s );
+		axmm__slab_release( s );
+		return;
+	}
+
+	if( s->bFull ) {
+		axmm__slab_unlink( cc, s );
+		axmm__slab_link_available( cc, s, 0 );
+	}
+}
+/* implementation: collect the remote frees of every slab on the cache's pending stack */
+static void AXMM_CALL axmm__slab_process_pending( axmm__slab_cache_t *c )
+{
+	axmm__slab_t *s;
+	axmm_u32_t uSlab;
+
+	uSlab = axmm_atomic_xchg32( &c->uPending, 0 );
+	while( uSlab != 0 ) {
+		s = AXMM__SLAB_AT( uSlab - 1 );
+		uSlab = s->uNextPending;
+
+		/* only the thread that unlinks the slab from a pending stack clears its flag */
+		axmm_atomic_xchg32( &s->uPendingFlag, 0 );
+
+		if( s->pOwner == c && axmm__slab_collect( s ) > 0 ) {
+			axmm__slab_returned( &c->classes[ s->uClass ], s );
+		}
+	}
+}
+
+/* implementation: give the cache a slab with space available for `uClass` at the head of its list */
+static axmm__slab_t *AXMM_CALL axmm__slab_acquire( axmm__slab_cache_t *c, axmm_u32_t uClass )
+{
+	axmm__slab_class_cache_t *cc;
+	axmm__slab_t *s;
+	axmm_u32_t uSlab;
+	int bCommit;
+
+	cc = &c->classes[ uClass ];
+
+	/* adopt an abandoned slab with space available, if any */
+	for(;;) {
+		axmm__slab_lock();
+		if( ( s = axmm__g_slab.abandoned[ uClass ] ) != AXMM_NULL(axmm__slab_t) ) {
+			axmm__g_slab.abandoned[ uClass ] = s->pNext;
+		}
+		axmm__slab_unlock();
+
+		if( !s ) {
+			break;
+		}
+
+		s->pOwner = c;
+		axmm__slab_collect( s );
+
+		if( s->pLocalFree != AXMM_NULL(void) || s->uBump + s->cObjectBytes <= AXMM_SLAB_SIZE ) {
+			axmm__slab_link_available( cc, s, 1 );
+			return s;
+		}
+
+		axmm__slab_link_full( cc, s );
+	}
+
+	/* reuse a free slab, or carve out a new one */
+	axmm__slab_lock();
+	if( ( uSlab = axmm__g_slab.uFreeSlabs ) != 0 ) {
+		axmm__g_slab.uFreeSlabs = AXMM__SLAB_AT( uSlab - 1 )->uNextFreeSlab;
+	}
+	axmm__slab_unlock();
+
+	if( uSlab != 0 ) {
+		s = AXMM__SLAB_AT( uSlab - 1 );
+		bCommit = axmm_page_commit( axmm__rc( axmm_u8_t * )( s ) + axmm__g_slab.cPageBytes, AXMM_SLAB_SIZE - axmm__g_slab.cPageBytes, axmem_pp_rw ) != AXMM_NULL(void);
+	} else {
+		uSlab = axmm_atomic_add32( &axmm__g_slab.cUsedSlabs, 1 );
+		if( uSlab >= axmm__g_slab.cMaxSlabs ) {
+			/* ERROR: Out of slabs */
+			axmm_atomic_sub32( &axmm__g_slab.cUsedSlabs, 1 );
+			return AXMM_NULL(axmm__slab_t);
+		}
+
+		s = AXMM__SLAB_AT( uSlab );
+		bCommit = axmm_page_commit( s, AXMM_SLAB_SIZE, axmem_pp_rw ) != AXMM_NULL(void);
+		if( bCommit ) {
+			s->uPendingFlag = 0;
+			s->uNextPending = 0;
+		}
+	}
+
+	if( !bCommit ) {
+		/* ERROR: Out of memory (the slab's header is still usable, so keep it around) */
+		axmm__slab_lock();
+		s->uNextFreeSlab = axmm__g_slab.uFreeSlabs;
+		axmm__g_slab.uFreeSlabs = AXMM__SLAB_INDEX( s ) + 1;
+		axmm__slab_unlock();
+		return AXMM_NULL(axmm__slab_t);
+	}
+
+	s->pLocalFree = AXMM_NULL(void);
+	s->uBump = AXMM__SLAB_HEADER_BYTES;
+	s->cUsed = 0;
+	s->uClass = uClass;
+	s->cObjectBytes = axmm__slab_class_size( uClass );
+	s->uRemoteFree = 0;
+	s->uNextFreeSlab = 0;
+	s->pOwner = c;
+
+	axmm__slab_link_available( cc, s, 1 );
+	return s;
+}
+
+/* implementation: take an object from `s` if it has one */
+static void *AXMM_CALL axmm__slab_pop( axmm__slab_t *s )
+{
+	void *p;
+
+	if( ( p = s->pLocalFree ) != AXMM_NULL(void) ) {
+		s->pLocalFree = *axmm__c( void ** )( p );
+	} else if( s->uBump + s->cObjectBytes <= AXMM_SLAB_SIZE ) {
+		p = axmm__c( void * )( axmm__rc( axmm_u8_t * )( s ) + s->uBump );
+		s->uBump += s->cObjectBytes;
+	} else {
+		return AXMM_NULL(void);
+	}
+
+	++s->cUsed;
+	return p;
+}
+
+/* implementation: allocate an object of a given size class for the cache */
+static void *AXMM_CALL axmm__slab_alloc_class( axmm__slab_cache_t *c, axmm_u32_t uClass )
+{
+	axmm__slab_class_cache_t *cc;
+	axmm__slab_t *s;
+	void *p;
+
+	cc = &c->classes[ uClass ];
+	if( ( s = cc->pHead ) != AXMM_NULL(axmm__slab_t) && ( p = axmm__slab_pop( s ) ) != AXMM_NULL(void) ) {
+		return p;
+	}
+
+	/* the head slab is exhausted; take back remote frees in one batch */
+	axmm__slab_process_pending( c );
+
+	while( ( s = cc->pHead ) != AXMM_NULL(axmm__slab_t) ) {
+		if( ( p = axmm__slab_pop( s ) ) != AXMM_NULL(void) ) {
+			return p;
+		}
+
+		/* a notification might have gone to a previous owner; check directly */
+		if( axmm__slab_collect( s ) > 0 ) {
+			continue;
+		}
+
+		axmm__slab_unlink( cc, s );
+		axmm__slab_link_full( cc, s );
+	}
+
+	if( !axmm__slab_acquire( c, uClass ) ) {
+		return AXMM_NULL(void);
+	}
+
+	return axmm__slab_pop( cc->pHead );
+}
+
+/* implementation: return `p` to slab `s` from a thread that doesn't own it */
+static void AXMM_CALL axmm__slab_free_remote( axmm__slab_t *s, void *p )
+{
+	axmm__slab_cache_t *pOwner;
+	axmm_u32_t uOffset, uHead;
+
+	uOffset = axmm__c( axmm_u32_t )( axmm__rc( axmm_u8_t * )( p ) - axmm__rc( axmm_u8_t * )( s ) );
+	do {
+		uHead = *axmm__c( volatile axmm_u32_t * )( &s->uRemoteFree );
+		*axmm__c( axmm_u32_t * )( p ) = uHead;
+	} while( axmm_atomic_cmpxchg32( &s->uRemoteFree, uOffset, uHead ) != uHead );
+
+	/* queue the slab for its owner unless it's already queued somewhere */
+	if( axmm_atomic_xchg32( &s->uPendingFlag, 1 ) != 0 ) {
+		return;
+	}
+
+	if( ( pOwner = s->pOwner ) == AXMM_NULL(axmm__slab_cache_t) ) {
+		/* abandoned; the adopting thread collects the remote frees */
+		axmm_atomic_xchg32( &s->uPendingFlag, 0 );
+		return;
+	}
+
+	do {
+		uHead = *axmm__c( volatile axmm_u32_t * )( &pOwner->uPending );
+		s->uNextPending = uHead;
+	} while( axmm_atomic_cmpxchg32( &pOwner->uPending, AXMM__SLAB_INDEX( s ) + 1, uHead ) != uHead );
+}
+#endif
+
+/* Retrieve the number of bytes that will actually be reserved for an allocation of `cBytes` through `axmm_slab_alloc()` */
+AXMM_FUNC axmm_size_t AXMM_CALL axmm_slab_good_size( axmm_size_t cBytes )
+#if AXMM_IMPLEMENT
+{
+	if( cBytes > AXMM_SLAB_MAX_OBJECT_SIZE ) {
+		return cBytes;
+	}
+
+	return axmm__slab_class_size( axmm__slab_class( cBytes ) );
+}
+#else
+;
+#endif
+
+/* Allocate `cBytes` from the slab allocator (aligned to 16 bytes; returns NULL on failure) */
+AXMM_FUNC void *AXMM_CALL axmm_slab_alloc( axmm_size_t cBytes )
+#if AXMM_IMPLEMENT
+{
+	axmm__slab_cache_t *c;
+	void *p;
+# if AXMM_LISTENERS_ENABLED
+	axmm_alloc_t details;
+	int bListening;
+
+	bListening = *axmm__c( volatile axmm_u32_t * )( &axmm__g_cListeners ) != 0;
+	if( bListening ) {
+		details.pBytes       = AXMM_NULL(void);
+		details.cBytes       = cBytes;
+		details.pszName      = AXMM_NULL(const char);
+		details.cNameBytes   = 0;
+		details.uTag         = 0;
+		details.uFlags       = 0;
+		details.uAlign       = 16;
+		details.uAlignOffset = 0;
+
+		axmm_prealloc( &details );
+	}
+# endif
+
+	if( cBytes > AXMM_SLAB_MAX_OBJECT_SIZE || ( c = axmm__slab_cache() ) == AXMM_NULL(axmm__slab_cache_t) ) {
+		p = axmm_def_alloc( cBytes );
+	} else {
+		p = axmm__slab_alloc_class( c, axmm__slab_class( cBytes ) );
+	}
+
+# if AXMM_LISTENERS_ENABLED
+	if( bListening ) {
+		details.pBytes = p;
+		axmm_postalloc( &details );
+	}
+# endif
+
+	return p;
+}
+#else
+;
+#endif
+
+/* Free memory allocated with `axmm_slab_alloc()` (from any thread) */
+AXMM_FUNC void AXMM_CALL axmm_slab_free( void *p )
+#if AXMM_IMPLEMENT
+{
+	axmm__slab_cache_t *c;
+	axmm__slab_t *s;
+	int bInSlab;
+# if AXMM_LISTENERS_ENABLED
+	axmm_free_t details;
+	int bListening;
+# endif
+
+	if( !p ) {
+		return;
+	}
+
+	bInSlab =
+		axmm__g_slab.pBase != AXMM_NULL(axmm_u8_t) &&
+		axmm__c( axmm_size_t )( axmm__rc( axmm_u8_t * )( p ) - axmm__g_slab.pBase ) < axmm__c( axmm_size_t )( axmm__g_slab.cMaxSlabs )*AXMM_SLAB_SIZE;
+	s = bInSlab ? AXMM__SLAB_OF( p ) : AXMM_NULL(axmm__slab_t);
+
+# if AXMM_LISTENERS_ENABLED
+	bListening = *axmm__c( volatile axmm_u32_t * )( &axmm__g_cListeners ) != 0;
+	if( bListening ) {
+		details.pBytes = p;
+		details.cBytes = s != AXMM_NULL(axmm__slab_t) ? s->cObjectBytes : 0;
+
+		axmm_prefree( &details );
+	}
+# endif
+
+	if( !s ) {
+		axmm_def_free( p );
+	} else if( ( c = axmm__g_pSlabCache ) != AXMM_NULL(axmm__slab_cache_t) && s->pOwner == c ) {
+		*axmm__c( void ** )( p ) = s->pLocalFree;
+		s->pLocalFree = p;
+		--s->cUsed;
+
+		axmm__slab_returned( &c->classes[ s->uClass ], s );
+	} else {
+		axmm__slab_free_remote( s, p );
+	}
+
+# if AXMM_LISTENERS_ENABLED
+	if( bListening ) {
+		axmm_postfree( &details );
+	}
+# endif
+}
+#else
+;
+#endif
+
+/* Release the calling thread's slab cache (call before a thread that used the slab allocator exits) */
+AXMM_FUNC void AXMM_CALL axmm_slab_thread_fini( void )
+#if AXMM_IMPLEMENT
+{
+	axmm__slab_class_cache_t *cc;
+	axmm__slab_cache_t *c;
+	axmm__slab_t *s, *pNext;
+	axmm_u32_t i;
+	int iList;
+
+	if( ( c = axmm__g_pSlabCache ) == AXMM_NULL(axmm__slab_cache_t) ) {
+		return;
+	}
+
+	axmm__slab_process_pending( c );
+
+	for( i = 0; i < AXMM__SLAB_NUM_CLASSES; ++i ) {
+		cc = &c->classes[ i ];
+
+		for( iList = 0; iList < 2; ++iList ) {
+			for( s = iList ? cc->pFull : cc->pHead; s != AXMM_NULL(axmm__slab_t); s = pNext ) {
+				pNext = s->pNext;
+
+				s->pPrev = AXMM_NULL(axmm__slab_t);
+				s->pNext = AXMM_NULL(axmm__slab_t);
+				s->bFull = 0;
+
+				if( !s->cUsed ) {
+					axmm__slab_release( s );
+					continue;
+				}
+
+				s->pOwner = AXMM_NULL(axmm__slab_cache_t);
+
+				axmm__slab_lock();
+				s->pNext = axmm__g_slab.abandoned[ i ];
+				axmm__g_slab.abandoned[ i ] = s;
+				axmm__slab_unlock();
+			}
+		}
+
+		cc->pHead = AXMM_NULL(axmm__slab_t);
+		cc->pFull = AXMM_NULL(axmm__slab_t);
+	}
+
+	/* clear the flags of anything queued since; none of it belongs to us now */
+	axmm__slab_process_pending( c );
+
+	axmm__slab_lock();
+	c->pNextFree = axmm__g_slab.pFreeCaches;
+	axmm__g_slab.pFreeCaches = c;
+	axmm__slab_unlock();
+
+	axmm__g_pSlabCache = AXMM_NULL(axmm__slab_cache_t);
+}
+#else
+;
+#endif
+
+AXMM__LEAVE_C
+
+#if AXMM_CXX_ENABLED
+namespace ax
+{
+
+	namespace policy
+	{
+
+		// Allocator policy backed by the slab allocator; usable with TMutArr, TDictionary, and TList
+		template< typename TElement >
+		struct SlabAllocator
+		{
+			typedef axmm_size_t AllocSizeType;
+
+			inline void *allocate( AllocSizeType cBytes )
+			{
+				return axmm_slab_alloc( cBytes );
+			}
+			inline void *allocate( AllocSizeType cBytes, AllocSizeType &cAllocedBytes )
+			{
+				void *const p = axmm_slab_alloc( cBytes );
+				cAllocedBytes = p != AXMM_NULL(void) ? axmm_slab_good_size( cBytes ) : 0;
+				return p;
+			}
+			inline void deallocate( void *pBytes, AllocSizeType cBytes )
+			{
+				((void)cBytes);
+				axmm_slab_free( pBytes );
+			}
+		};
+
+	}
+
+}
+#endif
+
 
 
 
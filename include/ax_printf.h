@@ -4,12 +4,6 @@
 	Last update: 2015-10-01 Aaron Miller
 
 
-	TODO
-
-	- Add proper %g and %e support.
-	- Test %f more, and add support for #INF, #NAN, etc.
-
-
 	See: http://www.cplusplus.com/reference/cstdio/printf/
 	See: http://www.unix.com/man-page/FreeBSD/9/printf/
 	See: http://www.unix.com/man-page/freebsd/3/syslog/
@@ -61,6 +55,17 @@
 # define AXPF_CXX_OVERLOADS_ENABLED 1
 #endif
 
+/* compile-time formats (AXPF_FORMAT) need C++14 constexpr */
+#ifndef AXPF_CXX_CONSTEXPR_ENABLED
+# if defined( _MSVC_LANG ) && _MSVC_LANG >= 201402L
+#  define AXPF_CXX_CONSTEXPR_ENABLED 1
+# elif defined( __cplusplus ) && __cplusplus >= 201402L
+#  define AXPF_CXX_CONSTEXPR_ENABLED 1
+# else
+#  define AXPF_CXX_CONSTEXPR_ENABLED 0
+# endif
+#endif
+
 #ifndef AXPF_STDFILE_ENABLED
 # define AXPF_STDFILE_ENABLED       1
 #endif
@@ -69,6 +74,16 @@
 # define AXPF_UTF8CONV_ENABLED      1
 #endif
 
+/* %g without a precision prints the shortest digits that read back as the same double, not six */
+#ifndef AXPF_SHORTEST_G_ENABLED
+# define AXPF_SHORTEST_G_ENABLED    0
+#endif
+
+/* bytes of output staged before a FILE or callback sink is called */
+#ifndef AXPF_WRITE_BUFFER_SIZE
+# define AXPF_WRITE_BUFFER_SIZE     512
+#endif
+
 #ifndef AXPF_PARM_ANNO
 # ifdef AX_PRINTF_PARM
 #  define AXPF_PARM_ANNO            AX_PRINTF_PARM
@@ -141,6 +156,8 @@ extern "C" {
 #if !AXPF_CXX_ENABLED
 # undef AXPF_CXX_OVERLOADS_ENABLED
 # define AXPF_CXX_OVERLOADS_ENABLED 0
+# undef AXPF_CXX_CONSTEXPR_ENABLED
+# define AXPF_CXX_CONSTEXPR_ENABLED 0
 #endif
 
 #ifdef AX_TYPES_DEFINED
@@ -199,6 +216,59 @@ typedef unsigned long long int      axpf_ulonglong_t;
 
 typedef axpf_ptrdiff_t( AXPF_CALL *axpf_write_fn_t )( void *, const char *, const char * );
 
+/*
+	Growable output buffer (see axbpf)
+
+	Output goes straight into `p[ i ]` onward, advancing `i`, and the result
+	is NUL-terminated at `p[ i ]`, so `n` counts the byte the NUL needs. When
+	the buffer is full `pfnGrow` is called to make `n` at least
+	`i + cMin + 1`, updating `p` as needed; it returns 0 on failure, which
+	stops formatting with an error. A NULL `pfnGrow` makes the buffer fixed,
+	and output that doesn't fit is dropped.
+*/
+typedef struct axpf_buffer_s axpf_buffer_t;
+typedef int( AXPF_CALL *axpf_grow_fn_t )( axpf_buffer_t *, axpf_size_t cMin );
+struct axpf_buffer_s
+{
+	char          *p;       /* storage; may be NULL while n is 0 */
+	axpf_size_t    i;       /* bytes written so far */
+	axpf_size_t    n;       /* size of p, including room for the NUL */
+	axpf_grow_fn_t pfnGrow; /* makes more room, or NULL for a fixed buffer */
+	void          *pUser;   /* for pfnGrow */
+};
+
+/*
+	Compiled format (see axpf_compile)
+
+	A format string parsed ahead of time into a list of instructions, each a
+	run of literal text from `pText` followed by at most one directive. The
+	fields of `struct axpf__insn_` are internal.
+*/
+struct axpf__insn_
+{
+	axpf_u32_t lit;          /* offset of the literal text in pText */
+	axpf_u32_t litlen;       /* bytes of literal text before the directive */
+	axpf_u32_t repeats;
+	axpf_u32_t arraysize;
+	int width;
+	int precision;
+	axpf_u16_t flags;        /* kAxPF_* */
+	unsigned char lenspec;   /* axpf__lengthSpecifier_t */
+	unsigned char stars;     /* kAxPFS_*: fields read from the arguments */
+	unsigned char kind;      /* kAxPFK_* */
+	char spec;
+	char arrayprint[ 4 ];
+};
+typedef struct axpf_format_s
+{
+	const struct axpf__insn_ *pInsns;
+	axpf_size_t               cInsns;
+	const char *              pText;
+} axpf_format_t;
+
+/* alignment packed arguments (see axpackf) should be stored at */
+#define AXPF_PACK_ALIGN 8
+
 struct axpf__state_;
 
 struct axpf__write_mem_data_
@@ -233,7 +303,9 @@ AXPF_CALL axpf__write_mem_f
 
 	memcpy( ( void * )&md->p[ md->i ], ( const void * )s, n );
 	md->i += n;
-	md->p[ md->i ] = '\0';
+	if( md->i < md->n ) {
+		md->p[ md->i ] = '\0';
+	}
 
 	return n;
 }
@@ -260,7 +332,7 @@ AXPF_CALL axpf__write_memdup_f
 		return 0;
 	}
 
-	if( md->i + n > md->n ) {
+	if( md->i + n >= md->n ) {
 		axpf_size_t capacity;
 
 		capacity = md->i + n + 1;
@@ -465,6 +537,26 @@ enum
 	/* [Internal] Use a lower-case radix (for pointer printing) */
 	kAxPF_Pointer = 1<<15
 };
+/* [Internal] fields of a directive given as '*' (see axpf__insn_) */
+enum
+{
+	kAxPFS_Repeats = 1<<0,
+	kAxPFS_Array = 1<<1,
+	kAxPFS_Width = 1<<2,
+	kAxPFS_Precision = 1<<3
+};
+/* [Internal] how axpf__exec runs an instruction */
+enum
+{
+	/* Literal text only */
+	kAxPFK_Literal,
+	/* Any directive */
+	kAxPFK_Generic,
+	/* A plain "%s" */
+	kAxPFK_Str,
+	/* A plain "%d" or "%i" */
+	kAxPFK_Int
+};
 typedef enum
 {
 	kAxLS_None,
@@ -482,6 +574,17 @@ typedef enum
 	kAxLS_I64
 } axpf__lengthSpecifier_t;
 
+/* [Internal] where the arguments come from (see axpackf) */
+enum
+{
+	/* Read from the va_list */
+	kAxPM_None,
+	/* Read from the va_list and store into the packed arguments; no output */
+	kAxPM_Pack,
+	/* Read from the packed arguments */
+	kAxPM_Unpack
+};
+
 #define AXPF__MAX_ARRAY_PRINT 4
 struct axpf__state_
 {
@@ -502,6 +605,21 @@ struct axpf__state_
 	const char *s;
 	const char *e;
 	const char *p;
+
+	int argmode;
+	unsigned char *pkbase;
+	axpf_size_t pkpos;
+	axpf_size_t pksize;
+
+	/*
+		output window: bytes go to [wp, we) and are handed over (to pfn_write
+		from wbuf, or by committing to the axpf_buffer_t in write_data when
+		pfn_write is NULL) only when it fills or formatting ends
+	*/
+	char *wb;
+	char *wp;
+	char *we;
+	char wbuf[ AXPF_WRITE_BUFFER_SIZE ];
 };
 
 #if AXPF_IMPLEMENT
@@ -532,1301 +650,3175 @@ static int axpf__check( struct axpf__state_ *s, int ch )
 }
 static int axpf__checks( struct axpf__state_ *s, const char *p )
 {
-	if( s->p < s->e && *s->p == *p ) {
-		const char *q;
+	const char *q;
 
-		q = s->p + 1;
-		while( *q++ == *++p ) {
-			if( !*p ) {
-				break;
-			}
-		}
-		if( !*p ) {
-			s->p = q;
-			return 1;
+	for( q = s->p; *p != '\0'; ++q, ++p ) {
+		if( q >= s->e || *q != *p ) {
+			return 0;
 		}
 	}
 
-	return 0;
+	s->p = q;
+	return 1;
 }
 
-static int axpf__write( struct axpf__state_ *s, const char *p, const char *e )
+static void axpf__add_written( struct axpf__state_ *s, axpf_size_t n )
 {
-	axpf_ptrdiff_t r;
+	if( s->num_written + n >= s->num_written ) {
+		s->num_written += n;
+	} else {
+		s->num_written = ( ~( axpf_size_t )0 ) - 1;
+	}
+}
+/* bytes produced so far, including those still in the output window */
+static axpf_size_t axpf__count( const struct axpf__state_ *s )
+{
+	axpf_size_t n;
 
-	if( p == e ) {
-		return 1;
+	n = s->num_written + ( axpf_size_t )( s->wp - s->wb );
+	return n >= s->num_written ? n : ( ~( axpf_size_t )0 ) - 1;
+}
+
+static void axpf__window( struct axpf__state_ *s )
+{
+	axpf_buffer_t *b;
+
+	if( s->pfn_write != ( axpf_write_fn_t )0 ) {
+		s->wb = &s->wbuf[ 0 ];
+		s->wp = &s->wbuf[ 0 ];
+		s->we = &s->wbuf[ sizeof( s->wbuf ) ];
+		return;
 	}
 
-	if( s->flags & kAxPF_FSPath ) {
-		const char *q, *b;
-		char chslash = '/';
+	b = ( axpf_buffer_t * )s->write_data;
+	if( !b->p || b->i >= b->n ) {
+		s->wb = ( char * )0;
+		s->wp = ( char * )0;
+		s->we = ( char * )0;
+		return;
+	}
 
-		b = p;
-		for( q = p; q < e; ++q ) {
-			if( *q != '\\' ) {
-				continue;
-			}
+	s->wb = b->p + b->i;
+	s->wp = s->wb;
+	s->we = b->p + b->n - 1;
+}
+/*
+	hand over the output window, then make room for at least `cWant` more
+	bytes if the sink can; returns 0 on error. A fixed buffer stays full.
+*/
+static int axpf__flush( struct axpf__state_ *s, axpf_size_t cWant, int final )
+{
+	axpf_buffer_t *b;
+	axpf_ptrdiff_t r;
+	const char *q;
 
-			r = 0;
-			if( b != q && ( r = s->pfn_write( s->write_data, b, q ) ) == -1 ) {
-				s->diderror = 1;
-				return 0;
+	if( s->pfn_write != ( axpf_write_fn_t )0 ) {
+		q = s->wp;
+
+		/* don't split a UTF-8 sequence across calls; the sink may convert it */
+		if( !final ) {
+			const char *t;
+
+			for( t = s->wp; t > s->wb && t > s->wp - 4; ) {
+				unsigned char c;
+
+				c = ( unsigned char )*--t;
+				if( ( c & 0xC0 ) != 0x80 ) {
+					if( c >= 0xC0 && ( s->wp - t ) < ( c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2 ) ) {
+						q = t;
+					}
+					break;
+				}
 			}
+		}
 
-			b = q + 1;
-			if( ( s->pfn_write( s->write_data, &chslash, &chslash + 1 ) ) == -1 ) {
+		if( q != s->wb ) {
+			if( ( r = s->pfn_write( s->write_data, s->wb, q ) ) == -1 ) {
 				s->diderror = 1;
 				return 0;
 			}
 
-			if( s->num_written + 1 + ( axpf_size_t )r >= s->num_written ) {
-				s->num_written += 1 + ( axpf_size_t )r;
-			} else {
-				s->num_written = ( ~( axpf_size_t )0 ) - 1;
-			}
+			axpf__add_written( s, ( axpf_size_t )r );
+		}
+
+		if( q != s->wp ) {
+			memmove( ( void * )s->wb, ( const void * )q, ( axpf_size_t )( s->wp - q ) );
 		}
+		s->wp = s->wb + ( s->wp - q );
 
-		p = b;
+		return 1;
 	}
 
-	r = s->pfn_write( s->write_data, p, e );
-	if( r == -1 ) {
-		s->diderror = 1;
-		return 0;
+	b = ( axpf_buffer_t * )s->write_data;
+
+	axpf__add_written( s, ( axpf_size_t )( s->wp - s->wb ) );
+	b->i += ( axpf_size_t )( s->wp - s->wb );
+	s->wb = s->wp;
+
+	if( final || !b->pfnGrow ) {
+		return 1;
 	}
 
-	if( s->num_written + ( axpf_size_t )r >= s->num_written ) {
-		s->num_written += ( axpf_size_t )r;
-	} else {
-		s->num_written = ( ~( axpf_size_t )0 ) - 1;
+	if( !b->pfnGrow( b, cWant ) ) {
+		s->diderror = 1;
+		return 0;
 	}
 
+	axpf__window( s );
 	return 1;
 }
-static int axpf__writech( struct axpf__state_ *s, char ch )
-{
-	return axpf__write( s, &ch, &ch + 1 );
-}
 
-static char *axpf__utoa( char *end, axpf_umax_t i, unsigned radix, int flags )
+static int axpf__write_slow( struct axpf__state_ *s, const char *p, const char *e )
 {
-	static const char *lower = "0123456789abcdefghijklmnopqrstuvwxyz";
-	static const char *upper = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-
-	const char *digits;
-	unsigned groupingdist, groupingbase;
-	char groupingchar;
-	char *p;
-
-	if( radix < 2 ) { radix = 2; }
-	if( radix > 36 ) { radix = 36; }
+	axpf_size_t n, room;
 
-	digits = ( flags & 1 ) ? upper : lower;
+	while( p < e ) {
+		room = ( axpf_size_t )( s->we - s->wp );
+		if( !room ) {
+			if( !axpf__flush( s, ( axpf_size_t )( e - p ), 0 ) ) {
+				return 0;
+			}
 
-	/* TODO: Grab information from locale */
-	groupingbase = ( flags & 4 ) ? 3 : 9999;
-	groupingdist = groupingbase + 1;
-	groupingchar = ',';
+			/* large spans skip the staging buffer */
+			if( s->pfn_write != ( axpf_write_fn_t )0 && s->wp == s->wb && ( ~s->flags & kAxPF_FSPath ) && ( axpf_size_t )( e - p ) >= sizeof( s->wbuf ) ) {
+				axpf_ptrdiff_t r;
 
-	p = end - 1;
+				if( ( r = s->pfn_write( s->write_data, p, e ) ) == -1 ) {
+					s->diderror = 1;
+					return 0;
+				}
 
-	*p = '\0';
+				axpf__add_written( s, ( axpf_size_t )r );
+				return 1;
+			}
 
-	while( i > 0 ) {
-		if( !--groupingdist ) {
-			groupingdist = groupingbase;
-			*--p = groupingchar;
+			if( ( room = ( axpf_size_t )( s->we - s->wp ) ) == 0 ) {
+				return 1;
+			}
 		}
-		*--p = digits[ i%radix ];
-		i /= radix;
-	}
-	if( *p == '\0' && ( ~flags & 2 ) ) {
-		*--p = '0';
-	}
-
-	return p;
-}
-static int axpf__dtoax( char *buf, char *outsign, double f, int usescinot, unsigned maxdigits, unsigned radix )
-{
-	/*
-		ORIGINAL: http://www.edaboard.com/thread5585.html (by cb30)
-	*/
-	union {
-		axpf_s64_t i;
-		double f;
-	} x;
-	axpf_s64_t mantissa, whole, fract;
-	axpf_s16_t exp2;
 
-	( void )usescinot;
+		n = ( axpf_size_t )( e - p );
+		if( n > room ) {
+			n = room;
+		}
 
-	if( !f ) {
-		*buf++ = '0';
-		*buf++ = '.';
-		*buf++ = '0';
-		*buf   = '\0';
+		if( s->flags & kAxPF_FSPath ) {
+			axpf_size_t i;
 
-		return 0;
-	}
+			for( i = 0; i < n; ++i ) {
+				s->wp[ i ] = p[ i ] == '\\' ? '/' : p[ i ];
+			}
+		} else {
+			memcpy( ( void * )s->wp, ( const void * )p, n );
+		}
 
-	x.f = f;
-	if( x.i < 0 ) {
-		x.i &= ~( 1ULL<<63 );
-		*outsign = '-';
-	} else {
-		*outsign = '+';
+		s->wp += n;
+		p += n;
 	}
 
-	exp2 = ( ( axpf_s16_t )( ( x.i>>52 ) & 0x7FF ) ) - 1023;
-	mantissa = ( x.i & 0x1FFFFFFFFFFFFF ) | 0x10000000000000;
-	whole = 0;
-	fract = 0;
+	return 1;
+}
+static int axpf__write( struct axpf__state_ *s, const char *p, const char *e )
+{
+	axpf_size_t n;
 
-	if( exp2 >= 63 ) {
-		*buf = '\0';
+	if( p == e || s->argmode == kAxPM_Pack ) {
 		return 1;
 	}
 
-	if( exp2 < -52 ) {
-		*buf = '\0';
-		return -1;
+	n = ( axpf_size_t )( e - p );
+	if( n <= ( axpf_size_t )( s->we - s->wp ) && ( ~s->flags & kAxPF_FSPath ) ) {
+		memcpy( ( void * )s->wp, ( const void * )p, n );
+		s->wp += n;
+		return 1;
 	}
 
-	if( exp2 >= 52 ) {
-		whole = mantissa << ( exp2 - 52 );
-	} else if( exp2 >= 0 ) {
-		whole = mantissa >> ( 52 - exp2 );
-		fract = ( mantissa << ( exp2 + 1 ) ) & 0x1FFFFFFFFFFFFF;
-	} else {
-		fract = ( mantissa & 0x1FFFFFFFFFFFFF ) >> -( exp2 + 1 );
+	return axpf__write_slow( s, p, e );
+}
+static int axpf__writech( struct axpf__state_ *s, char ch )
+{
+	if( s->wp != s->we && ch != '\\' && s->argmode != kAxPM_Pack ) {
+		*s->wp++ = ch;
+		return 1;
 	}
 
-	if( !whole ) {
-		*buf++ = '0';
-	} else {
-		char tmp[ 32 ];
-		char *p;
+	return axpf__write( s, &ch, &ch + 1 );
+}
 
-		p = axpf__utoa( &tmp[ sizeof( tmp ) - 1 ], whole, radix, 0 );
-		while( *p != '\0' ) {
-			*buf++ = *p++;
-		}
-	}
+/*
+	Packed arguments (see axpackf) are the values a format string consumes,
+	in order, each stored as the bytes of the type va_arg reads it as. Data a
+	format only points to (strings, arrays, hex dumps) is copied in as well.
+*/
 
-	*buf++ = '.';
+/* reserve n bytes of packed arguments at alignment a; NULL if there's no room */
+static unsigned char *axpf__pk_reserve( struct axpf__state_ *s, axpf_size_t n, axpf_size_t a )
+{
+	axpf_size_t i;
 
-	if( !fract ) {
-		*buf++ = '0';
-	} else {
-		unsigned numdigits = 0;
+	i = ( s->pkpos + ( a - 1 ) ) & ~( a - 1 );
+	s->pkpos = i + n;
 
-		if( maxdigits > 32 ) {
-			maxdigits = 32;
+	if( s->pkpos > s->pksize || s->pkpos < i ) {
+		if( s->argmode == kAxPM_Unpack || s->pkpos < i ) {
+			s->diderror = 1;
+			s->pkpos = s->pksize;
 		}
 
-		for( numdigits = 0; numdigits < maxdigits; ++numdigits ) {
-			fract *= 10;
-			*buf++ = ( char )( ( fract >> 53 ) + '0' );
-			fract &= 0x1FFFFFFFFFFFFF;
-		}
+		return ( unsigned char * )0;
 	}
 
-	*buf = '\0';
-	return 0;
+	return s->pkbase + i;
 }
+static void axpf__pk_put( struct axpf__state_ *s, const void *p, axpf_size_t n )
+{
+	unsigned char *d;
 
-static int axpf__pad( struct axpf__state_ *s, unsigned num, char ch )
+	if( ( d = axpf__pk_reserve( s, n, 1 ) ) != ( unsigned char * )0 ) {
+		memcpy( ( void * )d, p, n );
+	}
+}
+static void axpf__pk_get( struct axpf__state_ *s, void *p, axpf_size_t n )
 {
-	static const char spaces[] = "                ";
-	static const char zeroes[] = "0000000000000000";
-	const char *p;
+	const unsigned char *q;
 
-	p = ( ch == ' ' ? &spaces[0] : ( ch == '0' ? &zeroes[0] : NULL ) );
+	if( ( q = axpf__pk_reserve( s, n, 1 ) ) != ( const unsigned char * )0 ) {
+		memcpy( p, ( const void * )q, n );
+	} else {
+		memset( p, 0, n );
+	}
+}
 
-	if( !p ) {
-		while( num-- > 0 ) {
-			if( !axpf__writech( s, ch ) ) {
-				return 0;
-			}
-		}
+/* read the next argument into Dst_ (an lvalue of type Ty_), packing it if needed */
+#define AXPF__ARG(S_,Ty_,Dst_)\
+	do {\
+		if( (S_)->argmode == kAxPM_Unpack ) {\
+			axpf__pk_get( (S_), ( void * )&(Dst_), sizeof( Ty_ ) );\
+		} else {\
+			(Dst_) = va_arg( (S_)->args, Ty_ );\
+			if( (S_)->argmode == kAxPM_Pack ) {\
+				axpf__pk_put( (S_), ( const void * )&(Dst_), sizeof( Ty_ ) );\
+			}\
+		}\
+	} while( 0 )
+
+/* length of a string as formatted, honoring the precision */
+static axpf_size_t axpf__strlen( const struct axpf__state_ *s, const char *p )
+{
+	const char *e;
 
-		return 1;
+	if( ~s->flags & kAxPF_Precision ) {
+		return ( axpf_size_t )( strchr( p, '\0' ) - p );
 	}
 
-	while( num > 0 ) {
-		unsigned n = num;
+	for( e = p; e < p + s->precision && *e != '\0'; ++e ) {
+	}
 
-		if( n > sizeof( spaces ) - 1 ) {
-			n = sizeof( spaces ) - 1;
-		}
+	return ( axpf_size_t )( e - p );
+}
+static axpf_size_t axpf__wstrlen( const struct axpf__state_ *s, const wchar_t *p )
+{
+	const wchar_t *e;
 
-		if( !axpf__write( s, p, p + n ) ) {
-			return 0;
-		}
+	if( ~s->flags & kAxPF_Precision ) {
+		return ( axpf_size_t )( wcschr( p, L'\0' ) - p );
+	}
 
-		num -= n;
+	for( e = p; e < p + s->precision && *e != L'\0'; ++e ) {
 	}
 
-	return 1;
+	return ( axpf_size_t )( e - p );
 }
-static int axpf__write_uintx( struct axpf__state_ *s, axpf_umax_t i, char sign )
+
+/* copy a string (of cbChar-byte characters) into the packed arguments; returns its offset */
+static axpf_size_t axpf__pk_put_str( struct axpf__state_ *s, const void *p, axpf_size_t cChars, axpf_size_t cbChar )
 {
-	const char *prefix;
-	unsigned prefixlen;
-	unsigned numberlen, numbersignlen;
-	unsigned numpadzeroes;
-	unsigned numpadspaces;
-	unsigned padinfringe;
-	char buf[ 128 ];
-	char *p;
-	int f;
+	unsigned char *d;
+	axpf_size_t i;
 
-	f = 0;
-	if( s->flags & kAxPF_Upper ) { f |= 1; }
-	if( ( s->flags & kAxPF_Precision ) && s->precision == 0 ) { f |= 2; }
-	if( s->flags & kAxPF_Group ) { f |= 4; }
+	d = axpf__pk_reserve( s, ( cChars + 1 )*cbChar, cbChar );
+	i = s->pkpos - ( cChars + 1 )*cbChar;
+	if( d != ( unsigned char * )0 ) {
+		memcpy( ( void * )d, p, cChars*cbChar );
+		memset( ( void * )( d + cChars*cbChar ), 0, cbChar );
+	}
 
-	p = axpf__utoa( &buf[ sizeof( buf ) ], i, s->radix, f );
+	return i;
+}
 
-	prefix = NULL;
-	prefixlen = 0;
-	if( s->flags & ( kAxPF_Radix | kAxPF_Pointer ) ) {
-		int useupper;
+/* read a string argument (%s, or the names of %b when not bounded) */
+static const char *axpf__arg_str( struct axpf__state_ *s, int bounded )
+{
+	const char *p;
+	axpf_u32_t tag;
+	axpf_size_t n;
 
-		if( ( s->flags & kAxPF_Pointer ) || ( ~s->flags & kAxPF_Upper ) ) {
-			useupper = 0;
-		} else {
-			useupper = 1;
+	if( s->argmode == kAxPM_Unpack ) {
+		AXPF__ARG( s, axpf_u32_t, tag );
+		if( !tag || !( p = ( const char * )axpf__pk_reserve( s, tag, 1 ) ) ) {
+			return ( const char * )0;
 		}
 
-		switch( s->radix ) {
-		case 2:
-			prefixlen = 2;
-			prefix = useupper ? "0B" : "0b";
-			break;
-		case 8:
-			prefixlen = 1;
-			prefix = "0";
-			break;
-		case 16:
-			prefixlen = 2;
-			prefix = useupper ? "0X" : "0x";
-			break;
-		default:
-			break;
-		}
+		return p[ tag - 1 ] == '\0' ? p : "";
 	}
-	numberlen = ( unsigned )( axpf_size_t )( &buf[ sizeof( buf ) - 1 ] - p );
 
-	if( !sign ) {
-		if( s->flags & kAxPF_Sign ) {
-			sign = '+';
-		} else if( s->flags & kAxPF_Space ) {
-			sign = ' ';
+	p = va_arg( s->args, const char * );
+	if( s->argmode == kAxPM_Pack ) {
+		n = !p ? 0 : ( bounded ? axpf__strlen( s, p ) : ( axpf_size_t )( strchr( p, '\0' ) - p ) );
+		tag = p != ( const char * )0 ? ( axpf_u32_t )( n + 1 ) : 0;
+		axpf__pk_put( s, ( const void * )&tag, sizeof( tag ) );
+		if( tag != 0 ) {
+			( void )axpf__pk_put_str( s, ( const void * )p, n, 1 );
 		}
 	}
-	numbersignlen = numberlen + +( sign != '\0' );
 
-	numpadzeroes = 0;
-	if( ( s->flags & kAxPF_Precision ) && ( unsigned )s->precision > numbersignlen ) {
-		numpadzeroes = s->precision - numbersignlen;
-	}
+	return p;
+}
+/* read a wide string argument (%S or %ls) */
+static const wchar_t *axpf__arg_wstr( struct axpf__state_ *s )
+{
+	const wchar_t *p;
+	axpf_u32_t tag;
+	axpf_size_t n;
 
-	numpadspaces = 0;
-	padinfringe = numbersignlen + prefixlen + numpadzeroes;
-	if( ( s->flags & kAxPF_Width ) && ( unsigned )s->width > padinfringe ) {
-		if( s->flags & kAxPF_Zero ) {
-			numpadzeroes += s->width - padinfringe;
-		} else {
-			numpadspaces += s->width - padinfringe;
+	if( s->argmode == kAxPM_Unpack ) {
+		AXPF__ARG( s, axpf_u32_t, tag );
+		if( !tag || !( p = ( const wchar_t * )axpf__pk_reserve( s, tag*sizeof( wchar_t ), sizeof( wchar_t ) ) ) ) {
+			return ( const wchar_t * )0;
 		}
-	}
 
-	if( ~s->flags & kAxPF_Left ) {
-		if( !axpf__pad( s, numpadspaces, ' ' ) ) {
-			return 0;
-		}
+		return p[ tag - 1 ] == L'\0' ? p : L"";
 	}
 
-	if( sign ) {
-		if( !axpf__writech( s, sign ) ) {
-			return 0;
+	p = va_arg( s->args, const wchar_t * );
+	if( s->argmode == kAxPM_Pack ) {
+		n = p != ( const wchar_t * )0 ? axpf__wstrlen( s, p ) : 0;
+		tag = p != ( const wchar_t * )0 ? ( axpf_u32_t )( n + 1 ) : 0;
+		axpf__pk_put( s, ( const void * )&tag, sizeof( tag ) );
+		if( tag != 0 ) {
+			( void )axpf__pk_put_str( s, ( const void * )p, n, sizeof( wchar_t ) );
 		}
 	}
 
-	if( prefix != NULL && prefixlen > 0 ) {
-		if( !axpf__write( s, prefix, prefix + prefixlen ) ) {
-			return 0;
-		}
-	}
-	axpf__pad( s, numpadzeroes, '0' );
+	return p;
+}
 
-	if( !axpf__write( s, p, &buf[ sizeof( buf ) - 1 ] ) ) {
-		return 0;
-	}
+/* size of one element of an array (%[N]...); 0 if nothing would be printed */
+static axpf_size_t axpf__array_elem_size( const struct axpf__state_ *s, char spec )
+{
+	switch( spec ) {
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'r':
+		switch( s->lenspec ) {
+		case kAxLS_None: return sizeof( int );
+		case kAxLS_hh:   return sizeof( char );
+		case kAxLS_h:    return sizeof( short int );
+		case kAxLS_l:    /*fallthrough*/
+		case kAxLS_L:    return sizeof( long int );
+		case kAxLS_ll:   return sizeof( axpf_longlong_t );
+		case kAxLS_j:    return sizeof( axpf_smax_t );
+		case kAxLS_z:    /*fallthrough*/
+		case kAxLS_I:    /*fallthrough*/
+		case kAxLS_t:    return sizeof( axpf_size_t );
+		case kAxLS_I32:  return sizeof( axpf_s32_t );
+		case kAxLS_I64:  return sizeof( axpf_s64_t );
+		}
+		break;
 
-	if( s->flags & kAxPF_Left ) {
-		if( !axpf__pad( s, numpadspaces, ' ' ) ) {
-			return 0;
+	case 'f':
+	case 'e':
+	case 'g':
+	case 'a':
+		if( s->lenspec == kAxLS_None ) {
+			return sizeof( float );
+		} else if( s->lenspec == kAxLS_l ) {
+			return sizeof( double );
+		} else if( s->lenspec == kAxLS_L ) {
+			return sizeof( long double );
 		}
-	}
+		break;
 
-	return 1;
-}
-static int axpf__write_int( struct axpf__state_ *s, axpf_smax_t i )
-{
-	while( s->repeats-- > 0 ) {
-		if( i < 0 ) {
-			if( !axpf__write_uintx( s, ( axpf_umax_t )-i, '-' ) ) {
-				return 0;
-			}
-		} else if( !axpf__write_uintx( s, ( axpf_umax_t )i, '\0' ) ) {
-			return 0;
+	case 'c':
+	case 'C':
+		if( s->lenspec == kAxLS_None && spec != 'C' ) {
+			return sizeof( char );
+		} else if( s->lenspec == kAxLS_l || spec == 'C' ) {
+			return sizeof( wchar_t );
 		}
+		break;
+
+	case 'p':
+		return sizeof( axpf_size_t );
 	}
 
-	return 1;
+	return 0;
 }
-static int axpf__write_uint( struct axpf__state_ *s, axpf_umax_t i )
+
+/*
+	Read the pointer argument of an array, or of a hex dump (cBytes set)
+
+	When packing, the pointed-to data is stored as a tag (0 for NULL, else the
+	size of the data plus one) followed by the data, aligned. An array of
+	strings becomes a table of offsets (from the start of the table, plus one,
+	or 0 for NULL) followed by the strings.
+*/
+static const void *axpf__arg_block( struct axpf__state_ *s, char spec, axpf_size_t cBytes )
 {
-	while( s->repeats-- > 0 ) {
-		if( !axpf__write_uintx( s, i, '\0' ) ) {
-			return 0;
+	const unsigned char *p;
+	unsigned char *d, *ptag;
+	axpf_u32_t tag, off;
+	axpf_size_t i, n, start;
+
+	if( s->argmode == kAxPM_Unpack ) {
+		AXPF__ARG( s, axpf_u32_t, tag );
+		if( !tag ) {
+			return ( const void * )0;
 		}
+
+		return axpf__pk_reserve( s, tag - 1, AXPF_PACK_ALIGN );
 	}
 
-	return 1;
-}
+	p = va_arg( s->args, const unsigned char * );
+	if( s->argmode != kAxPM_Pack ) {
+		return ( const void * )p;
+	}
 
-static int axpf__write_floatd( struct axpf__state_ *s, double f, char spec )
-{
-	unsigned maxdigits;
-	char buf[ 128 ], *p, *end, *dec;
-	char sign;
-	int r;
+	ptag = axpf__pk_reserve( s, sizeof( tag ), 1 );
+	if( !p ) {
+		tag = 0;
+		if( ptag != ( unsigned char * )0 ) {
+			memcpy( ( void * )ptag, ( const void * )&tag, sizeof( tag ) );
+		}
 
-	maxdigits = ( s->flags & kAxPF_Precision ) ? s->precision : 6;
-	sign = '\0';
-	p = &buf[ sizeof( buf )/2 ];
-	r = axpf__dtoax( p, &sign, ( double )f, 0, maxdigits, s->radix );
-	if( r < 0 ) {
-		buf[ 0 ] = '#'; buf[ 1 ] = 'S'; buf[ 2 ] = '\0';
-		p = &buf[ 0 ];
-	} else if( r > 0 ) {
-		buf[ 0 ] = '#'; buf[ 1 ] = 'L'; buf[ 2 ] = '\0';
-		p = &buf[ 0 ];
+		return ( const void * )p;
 	}
 
-	if( sign != '-' && ( ~s->flags & kAxPF_Sign ) ) {
-		sign = '\0';
+	if( !cBytes && spec == 's' && s->lenspec != kAxLS_None && s->lenspec != kAxLS_l ) {
+		n = 0;
+	} else if( !cBytes && ( spec == 's' || spec == 'S' ) ) {
+		n = s->arraysize*sizeof( axpf_u32_t );
+	} else if( !cBytes ) {
+		n = s->arraysize*axpf__array_elem_size( s, spec );
+	} else {
+		n = cBytes;
 	}
 
-	end = strchr( p, '\0' );
+	d = axpf__pk_reserve( s, n, AXPF_PACK_ALIGN );
+	start = s->pkpos - n;
 
-	if( spec == 'g' ) {
-		while( end > &buf[ 0 ] && *( end - 1 ) == '0' ) {
-			*--end = '\0';
+	if( spec == 's' && s->lenspec == kAxLS_None && !cBytes ) {
+		const char *const *pp = ( const char *const * )( const void * )p;
+
+		for( i = 0; i < s->arraysize; ++i ) {
+			off = !pp[ i ] ? 0 : ( axpf_u32_t )( axpf__pk_put_str( s, ( const void * )pp[ i ], axpf__strlen( s, pp[ i ] ), 1 ) - start + 1 );
+			if( d != ( unsigned char * )0 ) {
+				memcpy( ( void * )( d + i*sizeof( off ) ), ( const void * )&off, sizeof( off ) );
+			}
 		}
+	} else if( ( spec == 'S' || ( spec == 's' && s->lenspec == kAxLS_l ) ) && !cBytes ) {
+		const wchar_t *const *pp = ( const wchar_t *const * )( const void * )p;
 
-		if( end > &buf[ 0 ] && *( end - 1 ) == '.' ) {
-			*--end = '\0';
+		for( i = 0; i < s->arraysize; ++i ) {
+			off = !pp[ i ] ? 0 : ( axpf_u32_t )( axpf__pk_put_str( s, ( const void * )pp[ i ], axpf__wstrlen( s, pp[ i ] ), sizeof( wchar_t ) ) - start + 1 );
+			if( d != ( unsigned char * )0 ) {
+				memcpy( ( void * )( d + i*sizeof( off ) ), ( const void * )&off, sizeof( off ) );
+			}
 		}
+	} else if( d != ( unsigned char * )0 ) {
+		memcpy( ( void * )d, ( const void * )p, n );
 	}
 
-	dec = strchr( p, '.' );
-	if( !dec ) {
-		dec = end;
+	tag = ( axpf_u32_t )( s->pkpos - start + 1 );
+	if( ptag != ( unsigned char * )0 ) {
+		memcpy( ( void * )ptag, ( const void * )&tag, sizeof( tag ) );
 	}
 
-	if( ( s->flags & kAxPF_Precision ) && s->precision > 0 && r == 0 ) {
-		unsigned numdigits;
+	return ( const void * )p;
+}
+/* element i of an array of strings (see axpf__arg_block) */
+static const char *axpf__array_str( const struct axpf__state_ *s, const void *p, axpf_size_t i )
+{
+	axpf_u32_t off;
 
-		if( *dec != '.' ) {
-			dec[ 0 ] = '.';
-			dec[ 1 ] = '\0';
-			end = &dec[ 1 ];
-		}
+	if( s->argmode != kAxPM_Unpack ) {
+		return ( ( const char *const * )p )[ i ];
+	}
 
-		numdigits = ( unsigned )( axpf_size_t )( end - dec ) - 1;
-		while( ( int )numdigits < s->precision && numdigits < 32 ) {
-			*end++ = '0';
-			++numdigits;
-		}
+	memcpy( ( void * )&off, ( const void * )( ( const unsigned char * )p + i*sizeof( off ) ), sizeof( off ) );
+	return !off ? ( const char * )0 : ( const char * )p + off - 1;
+}
+static const wchar_t *axpf__array_wstr( const struct axpf__state_ *s, const void *p, axpf_size_t i )
+{
+	axpf_u32_t off;
 
-		*end = '\0';
+	if( s->argmode != kAxPM_Unpack ) {
+		return ( ( const wchar_t *const * )p )[ i ];
 	}
 
-	if( ( s->flags & kAxPF_Width ) && s->width > 0 && r == 0 ) {
-		unsigned numwidth;
-		char ch;
-
-		ch = ( s->flags & kAxPF_Zero ) ? '0' : ' ';
+	memcpy( ( void * )&off, ( const void * )( ( const unsigned char * )p + i*sizeof( off ) ), sizeof( off ) );
+	return !off ? ( const wchar_t * )0 : ( const wchar_t * )( const void * )( ( const char * )p + off - 1 );
+}
 
-		numwidth = ( unsigned )( axpf_size_t )( dec - p );
-		if( ch != '0' && sign != '\0' ) {
-			*--p = sign;
-			sign = '\0';
-			++numwidth;
-		}
+/* read the pointer of %n; NULL when it must not be written to */
+static void *axpf__arg_count_ptr( struct axpf__state_ *s )
+{
+	void *p;
 
-		while( ( int )numwidth < s->width && numwidth < 32 ) {
-			*--p = ch;
-			++numwidth;
-		}
+	if( s->argmode == kAxPM_Unpack ) {
+		return ( void * )0;
 	}
 
-	if( sign != '\0' ) {
-		*--p = sign;
+	p = va_arg( s->args, void * );
+	return s->argmode == kAxPM_Pack ? ( void * )0 : p;
+}
+/* the error code for %m (captured when packing) */
+static int axpf__arg_errno( struct axpf__state_ *s )
+{
+	int err;
+
+	if( s->argmode == kAxPM_None ) {
+		return ( int )errno;
 	}
 
-	while( s->repeats-- > 0 ) {
-		if( !axpf__write( s, p, end ) ) {
-			return 0;
-		}
+	err = ( int )errno;
+	if( s->argmode == kAxPM_Pack ) {
+		axpf__pk_put( s, ( const void * )&err, sizeof( err ) );
+	} else {
+		axpf__pk_get( s, ( void * )&err, sizeof( err ) );
 	}
 
-	return 1;
+	return err;
 }
 
-static int axpf__write_char( struct axpf__state_ *s, int ch )
+/* signed integer argument as read for the current length specifier */
+static axpf_smax_t axpf__arg_int( struct axpf__state_ *s )
 {
-	while( s->repeats-- > 0 ) {
-		if( !axpf__writech( s, ch ) ) {
-			return 0;
-		}
+	switch( s->lenspec ) {
+#define P_(Ty_) { Ty_ v; AXPF__ARG( s, Ty_, v ); return ( axpf_smax_t )v; }
+	case kAxLS_l:   P_( long int )
+	case kAxLS_ll:  /*fallthrough*/
+	case kAxLS_L:   P_( axpf_longlong_t )
+	case kAxLS_t:   /*fallthrough*/
+	case kAxLS_I:   P_( axpf_ptrdiff_t )
+	case kAxLS_z:   P_( axpf_size_t )
+	case kAxLS_j:   P_( axpf_smax_t )
+	case kAxLS_I32: P_( axpf_s32_t )
+	case kAxLS_I64: P_( axpf_s64_t )
+	default:        P_( int )
+#undef P_
 	}
-
-	return 1;
 }
-static int axpf__writewch( struct axpf__state_ *s, wchar_t ch )
+/* unsigned integer argument as read for the current length specifier */
+static axpf_umax_t axpf__arg_uint( struct axpf__state_ *s )
 {
-	( void )s;
-	( void )ch;
-
-	return 0;
+	switch( s->lenspec ) {
+#define P_(Ty_) { Ty_ v; AXPF__ARG( s, Ty_, v ); return ( axpf_umax_t )v; }
+	case kAxLS_l:   P_( unsigned long int )
+	case kAxLS_ll:  /*fallthrough*/
+	case kAxLS_L:   P_( axpf_ulonglong_t )
+	case kAxLS_t:   P_( axpf_ptrdiff_t )
+	case kAxLS_z:   /*fallthrough*/
+	case kAxLS_I:   P_( axpf_size_t )
+	case kAxLS_j:   P_( axpf_umax_t )
+	case kAxLS_I32: P_( axpf_u32_t )
+	case kAxLS_I64: P_( axpf_u64_t )
+	default:        P_( unsigned int )
+#undef P_
+	}
 }
-static int axpf__write_wchar( struct axpf__state_ *s, wchar_t ch )
+
+static char *axpf__utoa( char *end, axpf_umax_t i, unsigned radix, int flags )
 {
-	while( s->repeats-- > 0 ) {
-		if( !axpf__writewch( s, ch ) ) {
-			return 0;
+	static const char *lower = "0123456789abcdefghijklmnopqrstuvwxyz";
+	static const char *upper = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	const char *digits;
+	unsigned groupingdist, groupingbase;
+	char groupingchar;
+	char *p;
+
+	if( radix < 2 ) { radix = 2; }
+	if( radix > 36 ) { radix = 36; }
+
+	digits = ( flags & 1 ) ? upper : lower;
+
+	/* TODO: Grab information from locale */
+	groupingbase = ( flags & 4 ) ? 3 : 9999;
+	groupingdist = groupingbase + 1;
+	groupingchar = ',';
+
+	p = end - 1;
+
+	*p = '\0';
+
+	while( i > 0 ) {
+		if( !--groupingdist ) {
+			groupingdist = groupingbase;
+			*--p = groupingchar;
 		}
+		*--p = digits[ i%radix ];
+		i /= radix;
+	}
+	if( *p == '\0' && ( ~flags & 2 ) ) {
+		*--p = '0';
 	}
 
-	return 1;
+	return p;
 }
+/*
+	Floating-point digit generation
 
-static int axpf__write_str( struct axpf__state_ *s, const char *p )
+	Shortest round-trip digits come from Grisu3 over the cached powers of ten
+	below; the rare inputs Grisu3 can't decide fall back to Dragon4 over a
+	small bignum. Fixed-precision digits are exact and rounded half-to-even:
+	doubles with a binary exponent in [-60, 11] use a 64-bit integer/fraction
+	split, everything else the same bignum ratio Dragon4 uses.
+
+	All generators write ASCII digits without a terminator and report the
+	decimal exponent of the first digit through `outx`.
+*/
+
+/* most significant digits a fixed-precision conversion can produce */
+#define AXPF__FLT_MAXPREC           64
+#define AXPF__FLT_MAXDIGITS         ( 310 + AXPF__FLT_MAXPREC + 2 )
+
+/* a bignum only ever holds ~1110 bits; see axpf__dgen_init() */
+#define AXPF__BIG_WORDS             40
+
+struct axpf__big_ {
+	unsigned   n;
+	axpf_u32_t w[ AXPF__BIG_WORDS ];
+};
+
+static void axpf__big_set( struct axpf__big_ *b, axpf_u64_t v )
 {
-	const char *e;
+	b->w[ 0 ] = ( axpf_u32_t )v;
+	b->w[ 1 ] = ( axpf_u32_t )( v>>32 );
+	b->n = b->w[ 1 ] ? 2 : ( b->w[ 0 ] ? 1 : 0 );
+}
+static void axpf__big_mul( struct axpf__big_ *b, axpf_u32_t m )
+{
+	axpf_u64_t c;
+	unsigned i;
 
-	if( !p ) {
-		p = "(null)";
-		e = p + 6;
-		if( s->flags & kAxPF_Precision ) {
-			if( s->precision <= 6 ) {
-				e = &p[ s->precision ];
-			}
-		}
-	} else if( s->flags & kAxPF_Precision ) {
-		e = &p[ s->precision ];
-	} else {
-		e = strchr( p, '\0' );
+	c = 0;
+	for( i = 0; i < b->n; ++i ) {
+		c += ( axpf_u64_t )b->w[ i ]*m;
+		b->w[ i ] = ( axpf_u32_t )c;
+		c >>= 32;
 	}
 
-	while( s->repeats-- > 0 ) {
-		if( !axpf__write( s, p, e ) ) {
-			return 0;
-		}
+	if( c != 0 ) {
+		b->w[ b->n++ ] = ( axpf_u32_t )c;
+	}
+}
+static void axpf__big_mul_pow10( struct axpf__big_ *b, unsigned e )
+{
+	static const axpf_u32_t pow10[ 9 ] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+	};
+
+	while( e >= 9 ) {
+		axpf__big_mul( b, 1000000000 );
+		e -= 9;
 	}
 
-	return 1;
+	if( e > 0 ) {
+		axpf__big_mul( b, pow10[ e ] );
+	}
 }
-static int axpf__write_wstr( struct axpf__state_ *s, const wchar_t *p )
+static void axpf__big_shl( struct axpf__big_ *b, unsigned sh )
 {
-	const wchar_t *e;
+	unsigned ws, bs, i;
 
-	if( !p ) {
-		p = L"(null)";
-		e = p + 6;
-		if( s->flags & kAxPF_Precision ) {
-			if( s->precision <= 6 ) {
-				e = &p[ s->precision ];
-			}
-		}
-	} else if( s->flags & kAxPF_Precision ) {
-		e = &p[ s->precision ];
-	} else {
-		e = wcschr( p, L'\0' );
+	if( !b->n ) {
+		return;
 	}
 
-	while( s->repeats-- > 0 ) {
-		/* FIXME: If `AXPF_UTF8CONV_ENABLED == 1` then just forward to the writer */
-		while( p < e ) {
-			if( !axpf__writewch( s, *p++ ) ) {
-				return 0;
-			}
+	ws = sh/32;
+	bs = sh%32;
+
+	if( bs != 0 ) {
+		b->w[ b->n ] = 0;
+		for( i = b->n; i > 0; --i ) {
+			b->w[ i + ws ] = ( b->w[ i ]<<bs ) | ( b->w[ i - 1 ]>>( 32 - bs ) );
+		}
+		b->w[ ws ] = b->w[ 0 ]<<bs;
+
+		b->n += ws + 1;
+		if( !b->w[ b->n - 1 ] ) {
+			--b->n;
+		}
+	} else if( ws != 0 ) {
+		for( i = b->n; i > 0; --i ) {
+			b->w[ i - 1 + ws ] = b->w[ i - 1 ];
 		}
+
+		b->n += ws;
 	}
 
-	return 1;
+	for( i = 0; i < ws; ++i ) {
+		b->w[ i ] = 0;
+	}
 }
-
-static int axpf__write_syserr( struct axpf__state_ *s, int err )
+static int axpf__big_cmp( const struct axpf__big_ *a, const struct axpf__big_ *b )
 {
-	char errbuf[ 128 ];
+	unsigned i;
 
-#if defined( _MSC_VER ) && defined( __STDC_WANT_SECURE_LIB__ )
-	if( strerror_s( errbuf, sizeof( errbuf ), err ) != 0 ) {
-		errbuf[ 0 ] = '('; errbuf[ 1 ] = 'n'; errbuf[ 2 ] = 'u';
-		errbuf[ 3 ] = 'l'; errbuf[ 4 ] = 'l'; errbuf[ 5 ] = ')';
-		errbuf[ 6 ] = '\0';
+	if( a->n != b->n ) {
+		return a->n < b->n ? -1 : 1;
 	}
-#else
-	strncpy( errbuf, strerror( err ), sizeof( errbuf ) - 1 );
-#endif
-	errbuf[ sizeof( errbuf ) - 1 ] = '\0';
 
-	while( s->repeats-- > 0 ) {
-		if( !axpf__write( s, errbuf, strchr( errbuf, '\0' ) ) ) {
-			return 0;
+	for( i = a->n; i > 0; --i ) {
+		if( a->w[ i - 1 ] != b->w[ i - 1 ] ) {
+			return a->w[ i - 1 ] < b->w[ i - 1 ] ? -1 : 1;
 		}
 	}
 
-	return 1;
+	return 0;
 }
-static int axpf__write_bitfield( struct axpf__state_ *s, int bits,
-const char *names )
+/* compare a + b against c */
+static int axpf__big_addcmp( const struct axpf__big_ *a, const struct axpf__big_ *b, const struct axpf__big_ *c )
 {
-	int needcomma;
-
-	if( !names || !*names ) {
-		return 0;
+	struct axpf__big_ t;
+	axpf_u64_t x;
+	unsigned i, n;
+
+	n = a->n > b->n ? a->n : b->n;
+	x = 0;
+	for( i = 0; i < n; ++i ) {
+		x += ( i < a->n ? a->w[ i ] : 0 );
+		x += ( i < b->n ? b->w[ i ] : 0 );
+		t.w[ i ] = ( axpf_u32_t )x;
+		x >>= 32;
 	}
-
-	if( !s->repeats ) {
-		return 1;
+	if( x != 0 ) {
+		t.w[ n++ ] = ( axpf_u32_t )x;
 	}
+	t.n = n;
 
-	s->radix = *( const unsigned char * )names;
-	if( s->radix == 1 ) {
-		s->radix = 10;
-	}
+	return axpf__big_cmp( &t, c );
+}
+/* a -= b, where a >= b */
+static void axpf__big_sub( struct axpf__big_ *a, const struct axpf__big_ *b )
+{
+	axpf_u64_t d;
+	axpf_u32_t borrow;
+	unsigned i;
 
-	++names;
+	borrow = 0;
+	for( i = 0; i < a->n; ++i ) {
+		d = ( axpf_u64_t )a->w[ i ] - ( i < b->n ? b->w[ i ] : 0 ) - borrow;
+		a->w[ i ] = ( axpf_u32_t )d;
+		borrow = ( axpf_u32_t )( d>>32 ) & 1;
+	}
 
-	if( !axpf__write_uint( s, ( unsigned )bits ) ) {
-		return 0;
+	while( a->n > 0 && !a->w[ a->n - 1 ] ) {
+		--a->n;
 	}
+}
+/*
+	r = r mod s, returning the quotient; requires r < 10*s and the top word of
+	s to be in [8, 429496729] (see axpf__big_prep()) so that the estimate
+	below is never more than one too small
+*/
+static unsigned axpf__big_divstep( struct axpf__big_ *r, const struct axpf__big_ *s )
+{
+	axpf_u64_t c, d;
+	axpf_u32_t borrow;
+	unsigned q, i, n;
 
-	if( !axpf__writech( s, ' ' ) || !axpf__writech( s, '<' ) ) {
+	n = s->n;
+	if( r->n < n ) {
 		return 0;
 	}
 
-	needcomma = 0;
-	while( *names && bits ) {
-		unsigned bit;
-
-		bit = ( ( unsigned )*names++ ) - 1;
-		if( bits & ( 1<<bit ) ) {
-			const char *p;
-
-			bits &= ~( 1<<bit );
+	q = r->w[ n - 1 ]/( s->w[ n - 1 ] + 1 );
+	if( q != 0 ) {
+		c = 0;
+		borrow = 0;
+		for( i = 0; i < n; ++i ) {
+			c += ( axpf_u64_t )s->w[ i ]*q;
+			d = ( axpf_u64_t )r->w[ i ] - ( axpf_u32_t )c - borrow;
+			r->w[ i ] = ( axpf_u32_t )d;
+			borrow = ( axpf_u32_t )( d>>32 ) & 1;
+			c >>= 32;
+		}
 
-			if( needcomma ) {
-				axpf__writech( s, ',' );
-			}
+		while( r->n > 0 && !r->w[ r->n - 1 ] ) {
+			--r->n;
+		}
+	}
 
-			p = names;
-			while( *names > ' ' ) {
-				++names;
-			}
+	if( axpf__big_cmp( r, s ) >= 0 ) {
+		axpf__big_sub( r, s );
+		++q;
+	}
 
-			if( !axpf__write( s, p, names ) ) {
-				return 0;
-			}
+	return q;
+}
+/* shift needed to bring the top word of s into range for axpf__big_divstep() */
+static unsigned axpf__big_prep( const struct axpf__big_ *s )
+{
+	axpf_u32_t top;
+	unsigned hb;
 
-			needcomma = 1;
-		}
+	top = s->w[ s->n - 1 ];
+	for( hb = 31; !( top & ( 1UL<<hb ) ); --hb ) {
 	}
 
-	if( !axpf__writech( s, '>' ) ) {
-		return 0;
+	return ( 32 + 27 - hb )%32;
+}
+
+/* floor( e*log10( 2 ) ) for |e| < 1650 */
+static int axpf__floor_log10_pow2( int e )
+{
+	if( e >= 0 ) {
+		return ( int )( ( ( axpf_u32_t )e*78913 )>>18 );
 	}
 
-	return 1;
+	return -( int )( ( ( axpf_u32_t )-e*78913 )>>18 ) - 1;
 }
-static int axpf__write_hex_dump( struct axpf__state_ *s, const unsigned char *p,
-const char *delimiter )
+/* floor( log10( m*2^e2 ) ), or one less */
+static int axpf__dexp_estimate( axpf_u64_t m, int e2 )
 {
-	const char *delimend;
-	unsigned count = 16;
-	unsigned n;
-	unsigned i;
+	int nbits;
 
-	if( !s->repeats ) {
-		return 1;
+	nbits = 0;
+	while( m >> nbits ) {
+		++nbits;
 	}
 
-	if( !delimiter || !*delimiter ) {
-		delimiter = " ";
-	}
+	return axpf__floor_log10_pow2( e2 + nbits - 1 );
+}
 
-	delimend = strchr( delimiter, '\0' );
-	n = ( unsigned )( axpf_size_t )( delimend - delimiter );
+/* ---- Grisu3 ---- */
 
-	s->radix = 16;
+struct axpf__diyfp_ {
+	axpf_u64_t f;
+	int        e;
+};
 
-	if( ( s->flags & kAxPF_Width ) && s->width > 0 ) {
-		count = s->width;
+/* 10^k for k = -348, -340, ..., 340 as normalized 64-bit significands */
+static const axpf_u64_t axpf__g_cachedpow_f[ 87 ] = {
+	0xFA8FD5A0081C0288ULL, 0xBAAEE17FA23EBF76ULL, 0x8B16FB203055AC76ULL,
+	0xCF42894A5DCE35EAULL, 0x9A6BB0AA55653B2DULL, 0xE61ACF033D1A45DFULL,
+	0xAB70FE17C79AC6CAULL, 0xFF77B1FCBEBCDC4FULL, 0xBE5691EF416BD60CULL,
+	0x8DD01FAD907FFC3CULL, 0xD3515C2831559A83ULL, 0x9D71AC8FADA6C9B5ULL,
+	0xEA9C227723EE8BCBULL, 0xAECC49914078536DULL, 0x823C12795DB6CE57ULL,
+	0xC21094364DFB5637ULL, 0x9096EA6F3848984FULL, 0xD77485CB25823AC7ULL,
+	0xA086CFCD97BF97F4ULL, 0xEF340A98172AACE5ULL, 0xB23867FB2A35B28EULL,
+	0x84C8D4DFD2C63F3BULL, 0xC5DD44271AD3CDBAULL, 0x936B9FCEBB25C996ULL,
+	0xDBAC6C247D62A584ULL, 0xA3AB66580D5FDAF6ULL, 0xF3E2F893DEC3F126ULL,
+	0xB5B5ADA8AAFF80B8ULL, 0x87625F056C7C4A8BULL, 0xC9BCFF6034C13053ULL,
+	0x964E858C91BA2655ULL, 0xDFF9772470297EBDULL, 0xA6DFBD9FB8E5B88FULL,
+	0xF8A95FCF88747D94ULL, 0xB94470938FA89BCFULL, 0x8A08F0F8BF0F156BULL,
+	0xCDB02555653131B6ULL, 0x993FE2C6D07B7FACULL, 0xE45C10C42A2B3B06ULL,
+	0xAA242499697392D3ULL, 0xFD87B5F28300CA0EULL, 0xBCE5086492111AEBULL,
+	0x8CBCCC096F5088CCULL, 0xD1B71758E219652CULL, 0x9C40000000000000ULL,
+	0xE8D4A51000000000ULL, 0xAD78EBC5AC620000ULL, 0x813F3978F8940984ULL,
+	0xC097CE7BC90715B3ULL, 0x8F7E32CE7BEA5C70ULL, 0xD5D238A4ABE98068ULL,
+	0x9F4F2726179A2245ULL, 0xED63A231D4C4FB27ULL, 0xB0DE65388CC8ADA8ULL,
+	0x83C7088E1AAB65DBULL, 0xC45D1DF942711D9AULL, 0x924D692CA61BE758ULL,
+	0xDA01EE641A708DEAULL, 0xA26DA3999AEF774AULL, 0xF209787BB47D6B85ULL,
+	0xB454E4A179DD1877ULL, 0x865B86925B9BC5C2ULL, 0xC83553C5C8965D3DULL,
+	0x952AB45CFA97A0B3ULL, 0xDE469FBD99A05FE3ULL, 0xA59BC234DB398C25ULL,
+	0xF6C69A72A3989F5CULL, 0xB7DCBF5354E9BECEULL, 0x88FCF317F22241E2ULL,
+	0xCC20CE9BD35C78A5ULL, 0x98165AF37B2153DFULL, 0xE2A0B5DC971F303AULL,
+	0xA8D9D1535CE3B396ULL, 0xFB9B7CD9A4A7443CULL, 0xBB764C4CA7A44410ULL,
+	0x8BAB8EEFB6409C1AULL, 0xD01FEF10A657842CULL, 0x9B10A4E5E9913129ULL,
+	0xE7109BFBA19C0C9DULL, 0xAC2820D9623BF429ULL, 0x80444B5E7AA7CF85ULL,
+	0xBF21E44003ACDD2DULL, 0x8E679C2F5E44FF8FULL, 0xD433179D9C8CB841ULL,
+	0x9E19DB92B4E31BA9ULL, 0xEB96BF6EBADF77D9ULL, 0xAF87023B9BF0EE6BULL,
+};
+static const short axpf__g_cachedpow_e[ 87 ] = {
+	-1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+	-901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+	-582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+	-263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+	56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+	375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+	694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+	1013, 1039, 1066,
+};
+
+static void axpf__diyfp_normalize( struct axpf__diyfp_ *x )
+{
+	while( !( x->f & 0xFFC0000000000000ULL ) ) {
+		x->f <<= 10;
+		x->e -= 10;
+	}
+	while( !( x->f & 0x8000000000000000ULL ) ) {
+		x->f <<= 1;
+		x->e -= 1;
 	}
+}
+static struct axpf__diyfp_ axpf__diyfp_mul( struct axpf__diyfp_ x, axpf_u64_t yf, int ye )
+{
+	struct axpf__diyfp_ r;
+	axpf_u64_t a, b, c, d, ac, bc, ad, bd, t;
 
-	s->flags = kAxPF_Precision;
-	s->precision = 2;
-	for( i = 0; i < count; ++i ) {
-		if( i > 0 && !axpf__writech( s, delimiter[ ( i - 1 )%n ] ) ) {
-			return 0;
-		}
+	a = x.f>>32; b = x.f & 0xFFFFFFFF;
+	c = yf>>32;  d = yf & 0xFFFFFFFF;
 
-		if( !axpf__write_uintx( s, p[ i ], '\0' ) ) {
-			return 0;
-		}
-	}
+	ac = a*c; bc = b*c;
+	ad = a*d; bd = b*d;
 
-	return 1;
+	t = ( bd>>32 ) + ( ad & 0xFFFFFFFF ) + ( bc & 0xFFFFFFFF ) + ( 1U<<31 );
+
+	r.f = ac + ( ad>>32 ) + ( bc>>32 ) + ( t>>32 );
+	r.e = x.e + ye + 64;
+
+	return r;
 }
 
-static int axpf__find( struct axpf__state_ *s, int ch, int doflush )
+static int axpf__grisu3_weed( char *digs, int n, axpf_u64_t distw, axpf_u64_t unsafe, axpf_u64_t rest, axpf_u64_t tenk, axpf_u64_t unit )
 {
-	const char *p;
-	axpf_size_t n;
+	axpf_u64_t smalld, bigd;
 
-	n = ( axpf_size_t )( s->e - s->p );
-	if( !n ) {
-		return 0;
+	smalld = distw - unit;
+	bigd = distw + unit;
+
+	while( rest < smalld && unsafe - rest >= tenk && ( rest + tenk < smalld || smalld - rest >= rest + tenk - smalld ) ) {
+		--digs[ n - 1 ];
+		rest += tenk;
 	}
 
-	p = ( const char * )memchr( ( const void * )s->p, ch, n );
-	if( !p ) {
+	if( rest < bigd && unsafe - rest >= tenk && ( rest + tenk < bigd || bigd - rest > rest + tenk - bigd ) ) {
 		return 0;
 	}
 
-	if( doflush && s->p != p ) {
-		if( !axpf__write( s, s->p, p ) ) {
-			return 0;
-		}
+	return 2*unit <= rest && rest <= unsafe - 4*unit;
+}
+/* shortest digits, or 0 when Grisu3 can't guarantee them */
+static int axpf__grisu3( char *digs, int *outx, axpf_u64_t m, int e2, int lowercloser )
+{
+	static const axpf_u32_t pow10[ 10 ] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+	};
+
+	struct axpf__diyfp_ w, lo, hi, one;
+	axpf_u64_t cf, unit, unsafe, distw, frac, rest;
+	axpf_u32_t integ, div;
+	int k, i, kappa, n;
+
+	w.f = m;
+	w.e = e2;
+	axpf__diyfp_normalize( &w );
+
+	hi.f = ( m<<1 ) + 1;
+	hi.e = e2 - 1;
+	axpf__diyfp_normalize( &hi );
+
+	if( lowercloser ) {
+		lo.f = ( m<<2 ) - 1;
+		lo.e = e2 - 2;
+	} else {
+		lo.f = ( m<<1 ) - 1;
+		lo.e = e2 - 1;
 	}
+	lo.f <<= lo.e - hi.e;
+	lo.e = hi.e;
 
-	s->p = p;
-	return 1;
-}
+	/* pick 10^-k so the scaled exponent lands in [-60, -32] */
+	k = -61 - w.e;
+	k = k != 0 ? axpf__floor_log10_pow2( k ) + 1 : 0;
+	i = ( 348 + k - 1 )/8 + 1;
+	cf = axpf__g_cachedpow_f[ i ];
 
-static int axpf__getdigit( int ch, unsigned radix )
-{
-	unsigned rlo, rhi;
-	unsigned c;
+	w = axpf__diyfp_mul( w, cf, axpf__g_cachedpow_e[ i ] );
+	lo = axpf__diyfp_mul( lo, cf, axpf__g_cachedpow_e[ i ] );
+	hi = axpf__diyfp_mul( hi, cf, axpf__g_cachedpow_e[ i ] );
 
-	rlo = radix < 10 ? radix : 10;
-	rhi = radix > 10 ? radix - 10 : 0;
+	/* digit generation over the widened (unsafe) interval */
+	unit = 1;
+	lo.f -= unit;
+	hi.f += unit;
+	unsafe = hi.f - lo.f;
+	distw = hi.f - w.f;
 
-	c = ( unsigned )ch;
-	if( c >= '0' && c < '0' + rlo ) {
-		return ch - '0';
-	}
+	one.e = w.e;
+	one.f = 1ULL<<-one.e;
 
-	if( c >= 'a' && c < 'a' + rhi ) {
-		return ch - 'a' + 10;
+	integ = ( axpf_u32_t )( hi.f>>-one.e );
+	frac = hi.f & ( one.f - 1 );
+
+	for( kappa = 1; kappa < 10 && integ >= pow10[ kappa ]; ++kappa ) {
 	}
-	if( c >= 'A' && c < 'A' + rhi ) {
-		return ch - 'A' + 10;
+	div = pow10[ kappa - 1 ];
+
+	n = 0;
+	while( kappa > 0 ) {
+		digs[ n++ ] = ( char )( '0' + integ/div );
+		integ %= div;
+		--kappa;
+
+		rest = ( ( axpf_u64_t )integ<<-one.e ) + frac;
+		if( rest < unsafe ) {
+			if( !axpf__grisu3_weed( digs, n, distw, unsafe, rest, ( axpf_u64_t )div<<-one.e, unit ) ) {
+				return 0;
+			}
+
+			*outx = -( -348 + 8*i ) + kappa + n - 1;
+			return n;
+		}
+
+		div /= 10;
 	}
 
-	return -1;
+	for(;;) {
+		frac *= 10;
+		unit *= 10;
+		unsafe *= 10;
+
+		digs[ n++ ] = ( char )( '0' + ( int )( frac>>-one.e ) );
+		frac &= one.f - 1;
+		--kappa;
+
+		if( frac < unsafe ) {
+			if( !axpf__grisu3_weed( digs, n, distw*unit, unsafe, frac, one.f, unit ) ) {
+				return 0;
+			}
+
+			*outx = -( -348 + 8*i ) + kappa + n - 1;
+			return n;
+		}
+	}
 }
 
-static unsigned axpf__step_uint( struct axpf__state_ *s )
+/* ---- Dragon4 (exact shortest digits) ---- */
+
+static int axpf__dragon4( char *digs, int *outx, axpf_u64_t m, int e2, int lowercloser )
 {
-	unsigned r = 0;
+	struct axpf__big_ r, s, mp, mm;
+	unsigned sh;
+	int k, n, d, even, lo, hi;
+
+	even = !( m & 1 );
+
+	axpf__big_set( &r, m );
+	axpf__big_set( &s, 1 );
+	axpf__big_set( &mm, 1 );
+	axpf__big_shl( &r, ( unsigned )( ( e2 > 0 ? e2 : 0 ) + 1 + lowercloser ) );
+	axpf__big_shl( &s, ( unsigned )( ( e2 < 0 ? -e2 : 0 ) + 1 + lowercloser ) );
+	axpf__big_shl( &mm, ( unsigned )( e2 > 0 ? e2 : 0 ) );
+	mp = mm;
+	axpf__big_shl( &mp, ( unsigned )lowercloser );
+
+	k = axpf__dexp_estimate( m, e2 );
+	if( k >= 0 ) {
+		axpf__big_mul_pow10( &s, ( unsigned )k );
+	} else {
+		axpf__big_mul_pow10( &r, ( unsigned )-k );
+		axpf__big_mul_pow10( &mp, ( unsigned )-k );
+		axpf__big_mul_pow10( &mm, ( unsigned )-k );
+	}
 
+	/* bring the high boundary below 10^(k+1) */
 	for(;;) {
-		int n;
+		struct axpf__big_ s10;
 
-		n = axpf__getdigit( axpf__look( s ), 10 );
-		if( n < 0 ) {
+		s10 = s;
+		axpf__big_mul( &s10, 10 );
+		d = axpf__big_addcmp( &r, &mp, &s10 );
+		if( d < 0 || ( d == 0 && !even ) ) {
 			break;
 		}
 
-		if( r < ( 1L<<( sizeof( int )*8 - 2 ) ) ) {
-			r *= 10;
-			r += n;
+		s = s10;
+		++k;
+	}
+
+	sh = axpf__big_prep( &s );
+	axpf__big_shl( &r, sh );
+	axpf__big_shl( &s, sh );
+	axpf__big_shl( &mp, sh );
+	axpf__big_shl( &mm, sh );
+
+	n = 0;
+	for(;;) {
+		d = ( int )axpf__big_divstep( &r, &s );
+
+		lo = axpf__big_cmp( &r, &mm );
+		lo = even ? lo <= 0 : lo < 0;
+		hi = axpf__big_addcmp( &r, &mp, &s );
+		hi = even ? hi >= 0 : hi > 0;
+
+		if( lo || hi ) {
+			break;
 		}
-		axpf__skip( s );
+
+		digs[ n++ ] = ( char )( '0' + d );
+		axpf__big_mul( &r, 10 );
+		axpf__big_mul( &mp, 10 );
+		axpf__big_mul( &mm, 10 );
 	}
 
-	return r;
+	if( lo && hi ) {
+		axpf__big_shl( &r, 1 );
+		lo = axpf__big_cmp( &r, &s );
+		d += lo > 0 || ( lo == 0 && ( d & 1 ) );
+	} else if( hi ) {
+		++d;
+	}
+	digs[ n++ ] = ( char )( '0' + d );
+
+	*outx = k;
+	return n;
 }
-static int axpf__step_int( struct axpf__state_ *s )
+
+/* shortest digits that read back as m*2^e2; m must be nonzero */
+static int axpf__dtoa_shortest( char *digs, int *outx, axpf_u64_t m, int e2, int lowercloser )
 {
-	int m = 1;
+	int n;
 
-	if( axpf__check( s, '-' ) ) {
-		m = -1;
+	if( ( n = axpf__grisu3( digs, outx, m, e2, lowercloser ) ) != 0 ) {
+		return n;
 	}
 
-	return m*( int )axpf__step_uint( s );
+	return axpf__dragon4( digs, outx, m, e2, lowercloser );
 }
-static int axpf__step( struct axpf__state_ *s )
-{
-	char spec;
 
-	if( !axpf__find( s, '%', 1 ) ) {
-		axpf__write( s, s->p, s->e );
-		return 0;
-	}
+/* ---- exact fixed-precision digits ---- */
 
-	axpf__skip( s );
+struct axpf__dgen_ {
+	const char        *ip, *ie;  /* pending integer digits (64-bit path) */
+	axpf_u64_t         fr, mask; /* fraction bits (64-bit path) */
+	unsigned           sh;       /* fraction width (64-bit path) */
+	int                big;      /* remaining value is r/s */
+	struct axpf__big_  r, s;
+	char               ibuf[ 24 ];
+};
 
-	if( axpf__check( s, '%' ) ) {
-		axpf__writech( s, '%' );
-		return 1;
-	}
+/* prepare g for m*2^e2 (m nonzero); returns the exponent of the first digit */
+static int axpf__dgen_init( struct axpf__dgen_ *g, axpf_u64_t m, int e2 )
+{
+	struct axpf__big_ s10;
+	axpf_u64_t i;
+	unsigned sh;
+	int k;
 
-	s->repeats = 1;
-	s->arraysize = 0;
-	s->arrayprint[ 0 ] = '{';
-	s->arrayprint[ 1 ] = ',';
-	s->arrayprint[ 2 ] = ' ';
-	s->arrayprint[ 3 ] = '}';
-	s->flags = 0;
-	s->width = 0;
-	s->precision = 0;
-	s->lenspec = kAxLS_None;
-	s->radix = 10;
+	g->ip = &g->ibuf[ 0 ];
+	g->ie = &g->ibuf[ 0 ];
 
-	/* repeats */
-	if( axpf__check( s, '{' ) ) {
-		if( axpf__check( s, '*' ) ) {
-			s->repeats = va_arg( s->args, unsigned );
+	if( e2 >= -60 && e2 <= 11 ) {
+		char *p;
+
+		g->big = 0;
+		if( e2 >= 0 ) {
+			i = m<<e2;
+			g->sh = 0;
+			g->fr = 0;
+			g->mask = 0;
 		} else {
-			s->repeats = axpf__step_uint( s );
+			g->sh = ( unsigned )-e2;
+			g->mask = ( 1ULL<<g->sh ) - 1;
+			g->fr = m & g->mask;
+			i = m>>g->sh;
 		}
 
-		( void )axpf__check( s, '}' );
-	}
-
-	/* array */
-	if( axpf__check( s, '[' ) ) {
-		unsigned n = 0;
+		if( i != 0 ) {
+			p = &g->ibuf[ sizeof( g->ibuf ) ];
+			g->ie = p;
+			while( i != 0 ) {
+				*--p = ( char )( '0' + i%10 );
+				i /= 10;
+			}
+			g->ip = p;
 
-		if( axpf__check( s, '*' ) ) {
-			s->arraysize = va_arg( s->args, axpf_size_t );
-		} else {
-			s->arraysize = axpf__step_uint( s );
+			return ( int )( g->ie - g->ip ) - 1;
 		}
-		s->flags |= kAxPF_Array;
 
-		while( n < AXPF__MAX_ARRAY_PRINT ) {
-			if( axpf__check( s, ']' ) ) {
+		/* skip leading fraction zeros, keeping the first digit pending */
+		k = -1;
+		for(;;) {
+			g->fr *= 10;
+			if( g->fr>>g->sh ) {
 				break;
 			}
-
-			s->arrayprint[ n++ ] = axpf__read( s );
+			--k;
 		}
+		g->ibuf[ 0 ] = ( char )( '0' + ( g->fr>>g->sh ) );
+		g->fr &= g->mask;
+		g->ie = &g->ibuf[ 1 ];
 
-		if( n == AXPF__MAX_ARRAY_PRINT ) {
-			( void )axpf__check( s, ']' );
-		} else if( n > 0 ) {
-			/* the last character specified is the closing value */
-			s->arrayprint[ AXPF__MAX_ARRAY_PRINT - 1 ] = s->arrayprint[ n - 1 ];
+		return k;
+	}
 
-			/* if a space was omitted then don't space elements out */
-			if( n < 4 ) {
-				s->arrayprint[ 2 ] = '\0';
-			}
+	/*
+		r/s = m*2^e2/10^k in [1, 10); the largest operand is s near the
+		bottom of the subnormal range, ~2^1075 before axpf__big_prep()
+	*/
+	g->big = 1;
+	axpf__big_set( &g->r, m );
+	axpf__big_set( &g->s, 1 );
+	if( e2 >= 0 ) {
+		axpf__big_shl( &g->r, ( unsigned )e2 );
+	} else {
+		axpf__big_shl( &g->s, ( unsigned )-e2 );
+	}
 
-			/* if a delimiter was omitted then assume a comma */
-			if( n < 3 ) {
-				s->arrayprint[ 1 ] = ',';
-			}
-		}
+	k = axpf__dexp_estimate( m, e2 );
+	if( k >= 0 ) {
+		axpf__big_mul_pow10( &g->s, ( unsigned )k );
+	} else {
+		axpf__big_mul_pow10( &g->r, ( unsigned )-k );
 	}
 
-	/* flags */
-	unsigned fcount;
-	do {
-		fcount = 0;
+	s10 = g->s;
+	axpf__big_mul( &s10, 10 );
+	if( axpf__big_cmp( &g->r, &s10 ) >= 0 ) {
+		g->s = s10;
+		++k;
+	}
 
-		if( axpf__check( s, '-' ) ) {
-			s->flags |= kAxPF_Left;
-			++fcount;
-		}
-		if( axpf__check( s, '+' ) ) {
-			s->flags |= kAxPF_Sign;
-			++fcount;
-		}
-		if( axpf__check( s, ' ' ) ) {
-			s->flags |= kAxPF_Space;
-			++fcount;
-		}
-		if( axpf__check( s, '#' ) ) {
-			s->flags |= kAxPF_Radix;
-			++fcount;
-		}
-		if( axpf__check( s, '0' ) ) {
-			s->flags |= kAxPF_Zero;
-			++fcount;
-		}
-		if( axpf__check( s, '\'' ) ) {
-			s->flags |= kAxPF_Group;
-			++fcount;
-		}
-		if( axpf__check( s, '/' ) ) {
-			s->flags |= kAxPF_FSPath;
-			++fcount;
-		}
-	} while( fcount > 0 );
+	sh = axpf__big_prep( &g->s );
+	axpf__big_shl( &g->r, sh );
+	axpf__big_shl( &g->s, sh );
 
-	/* width */
-	if( axpf__check( s, '*' ) ) {
-		s->width = va_arg( s->args, int );
-		s->flags |= kAxPF_Width;
-	} else if( axpf__getdigit( axpf__look( s ), 10 ) >= 0 ) {
-		s->width = axpf__step_int( s );
-		s->flags |= kAxPF_Width;
+	return k;
+}
+static int axpf__dgen_next( struct axpf__dgen_ *g )
+{
+	int d;
+
+	if( g->ip < g->ie ) {
+		return *g->ip++ - '0';
 	}
 
-	/* precision */
-	if( axpf__check( s, '.' ) ) {
-		if( axpf__check( s, '*' ) ) {
-			s->precision = va_arg( s->args, int );
-			s->flags |= kAxPF_Precision;
-		} else if( axpf__getdigit( axpf__look( s ), 10 ) >= 0 ) {
-			s->precision = axpf__step_int( s );
-			s->flags |= kAxPF_Precision;
-		}
+	if( g->big ) {
+		d = ( int )axpf__big_divstep( &g->r, &g->s );
+		axpf__big_mul( &g->r, 10 );
+		return d;
 	}
 
-	/* length specifier */
-	if( axpf__check( s, 'h' ) ) {
-		if( axpf__check( s, 'h' ) ) {
-			s->lenspec = kAxLS_hh;
-		} else {
-			s->lenspec = kAxLS_h;
-		}
-	} else if( axpf__check( s, 'l' ) ) {
-		if( axpf__check( s, 'l' ) ) {
-			s->lenspec = kAxLS_ll;
-		} else {
-			s->lenspec = kAxLS_l;
-		}
-	} else if( axpf__check( s, 'j' ) ) {
-		s->lenspec = kAxLS_j;
-	} else if( axpf__check( s, 'z' ) ) {
-		s->lenspec = kAxLS_z;
-	} else if( axpf__check( s, 't' ) ) {
-		s->lenspec = kAxLS_t;
-	} else if( axpf__check( s, 'L' ) ) {
-		s->lenspec = kAxLS_L;
-	} else if( axpf__check( s, 'q' ) ) {
-		s->lenspec = kAxLS_I64;
-	} else if( axpf__check( s, 'w' ) ) {
-		s->lenspec = kAxLS_l;
-	} else if( axpf__check( s, 'I' ) ) {
-		if( axpf__checks( s, "32" ) ) {
-			s->lenspec = kAxLS_I32;
-		} else if( axpf__checks( s, "64" ) ) {
-			s->lenspec = kAxLS_I64;
-		} else {
-			s->lenspec = kAxLS_I;
-		}
-	}
+	g->fr *= 10;
+	d = ( int )( g->fr>>g->sh );
+	g->fr &= g->mask;
 
-	spec = axpf__read( s );
-	if( spec >= 'A' && spec <= 'Z' && spec!='C' && spec!='D' && spec!='S' ) {
-		s->flags |= kAxPF_Upper;
-		spec = spec - 'A' + 'a';
+	return d;
+}
+/* nonzero if anything remains after the digits generated so far */
+static int axpf__dgen_rest( const struct axpf__dgen_ *g )
+{
+	const char *p;
+
+	for( p = g->ip; p < g->ie; ++p ) {
+		if( *p != '0' ) {
+			return 1;
+		}
 	}
 
-	/* arrays require special handling */
-	if( s->flags & kAxPF_Array ) {
-		const void *ptrbase;
-		unsigned repeats;
+	return g->big ? g->r.n != 0 : g->fr != 0;
+}
 
-		if( spec == 'r' ) {
-			s->radix = va_arg( s->args, unsigned int );
-		}
-		ptrbase = va_arg( s->args, const void * );
+/*
+	digits of m*2^e2 rounded half-to-even to `prec` significant digits, or to
+	`prec` digits after the decimal point if `fracmode` is set; returns the
+	digit count, which is 0 if the value rounds to zero
+*/
+static int axpf__dtoa_fixed( char *digs, int *outx, axpf_u64_t m, int e2, int prec, int fracmode )
+{
+	struct axpf__dgen_ g;
+	int x, n, want, d, up;
 
-		if( spec == 'a' ) {
-			spec = 'f';
-			s->radix = 16;
-		}
+	*outx = 0;
+	if( !m ) {
+		return 0;
+	}
 
-		repeats = s->repeats;
-		while( repeats-- > 0 ) {
-			union {
-				const void *p;
-				const int *i; const unsigned int *u;
-				const signed char *sc; const unsigned char *usc;
-				const short int *si; const unsigned short int *usi;
-				const long int *li; const unsigned long int *uli;
-#ifdef _MSC_VER
-				const __int64 *lli; const unsigned __int64 *ulli;
-#else
-				const long long int *lli; const unsigned long long int *ulli;
-#endif
-				const axpf_smax_t *im; const axpf_umax_t *uim;
-				const axpf_size_t *sz;
-				const axpf_ptrdiff_t *pd;
-				const axpf_s32_t *i32; const axpf_u32_t *ui32;
-				const axpf_s64_t *i64; const axpf_u64_t *ui64;
-				const float *f;
-				const double *d;
-				const long double *ld;
-				const char *c;
-				const wchar_t *wc;
-				const char *const *s;
-				const wchar_t *const *ws;
-			} x;
-			axpf_size_t i;
+	/* m*2^e2 < 10^(x+2), so there's nothing to produce if x + 2 + prec < 0 */
+	if( fracmode && axpf__dexp_estimate( m, e2 ) + 2 + prec < 0 ) {
+		return 0;
+	}
 
-			if( !ptrbase ) {
-				const char buf[] = "(null)";
-				axpf__write( s, buf, buf + sizeof(buf) - 1 );
-				continue;
-			}
+	x = axpf__dgen_init( &g, m, e2 );
+	want = fracmode ? x + 1 + prec : prec;
+	if( want < 0 ) {
+		return 0;
+	}
 
-			axpf__writech( s, s->arrayprint[ 0 ] );
+	for( n = 0; n < want; ++n ) {
+		digs[ n ] = ( char )( '0' + axpf__dgen_next( &g ) );
+	}
 
-			x.p = ptrbase;
-			for( i = 0; i < s->arraysize; ++i ) {
-				if( i > 0 ) {
-					axpf__writech( s, s->arrayprint[ 1 ] );
-				}
-				if( s->arrayprint[ 2 ] == ' ' ) {
-					axpf__writech( s, ' ' );
-				}
+	d = axpf__dgen_next( &g );
+	up = d > 5 || ( d == 5 && ( axpf__dgen_rest( &g ) || ( n > 0 && ( digs[ n - 1 ] & 1 ) ) ) );
+	if( up ) {
+		int i;
 
-				s->repeats = 1;
-				switch( spec ) {
-				case 'd':
-				case 'i':
-					switch( s->lenspec ) {
-#define P_(F_) axpf__write_int( s, x.F_[i] ); break
-					case kAxLS_None: P_( i );
-					case kAxLS_hh:   P_( sc );
-					case kAxLS_h:    P_( si );
-					case kAxLS_l:    /*fallthrough*/
-					case kAxLS_L:    P_( li );
-					case kAxLS_ll:   P_( lli );
-					case kAxLS_j:    P_( im );
-					case kAxLS_z:    P_( sz );
-					case kAxLS_I:    /*fallthrough*/
-					case kAxLS_t:    P_( pd );
-					case kAxLS_I32:  P_( i32 );
-					case kAxLS_I64:  P_( i64 );
-#undef P_
-					}
-					break;
+		for( i = n; i > 0 && digs[ i - 1 ] == '9'; --i ) {
+			digs[ i - 1 ] = '0';
+		}
 
-				case 'u':
-				case 'o':
-				case 'x':
-				case 'r':
-					if( spec == 'o' ) {
-						s->radix = 8;
-					} else if( spec == 'x' ) {
-						s->radix = 16;
-					} else if( spec == 'r' ) {
-						s->radix = va_arg( s->args, unsigned int );
-					}
+		if( i > 0 ) {
+			++digs[ i - 1 ];
+		} else {
+			/* carried out of the leading digit */
+			++x;
+			if( n == 0 ) {
+				++n;
+			} else if( fracmode ) {
+				digs[ n++ ] = '0';
+			}
+			digs[ 0 ] = '1';
+		}
+	}
 
-					switch( s->lenspec ) {
-#define P_(F_) axpf__write_uint( s, x.F_[i] ); break
-					case kAxLS_None: P_( u );
-					case kAxLS_hh:   P_( usc );
-					case kAxLS_h:    P_( usi );
-					case kAxLS_l:    /*fallthrough*/
-					case kAxLS_L:    P_( uli );
-					case kAxLS_ll:   P_( ulli );
-					case kAxLS_j:    P_( uim );
-					case kAxLS_I:    /*fallthrough*/
-					case kAxLS_z:    P_( sz );
-					case kAxLS_t:    P_( pd );
-					case kAxLS_I32:  P_( ui32 );
-					case kAxLS_I64:  P_( ui64 );
-#undef P_
-					}
-					break;
+	*outx = x;
+	return n;
+}
 
-				case 'f':
-				case 'e':
-				case 'g':
-					if( s->lenspec == kAxLS_None ) {
-						axpf__write_floatd( s, ( double )x.f[ i ], spec );
-					} else if( s->lenspec == kAxLS_l ) {
-						axpf__write_floatd( s, x.d[ i ], spec );
-					} else if( s->lenspec == kAxLS_L ) {
-						axpf__write_floatd( s, ( double )x.ld[ i ], spec );
-					}
-					break;
+static int axpf__pad( struct axpf__state_ *s, unsigned num, char ch )
+{
+	axpf_size_t n;
 
-				case 'c':
-				case 'C':
-					if( s->lenspec == kAxLS_None && spec != 'C' ) {
-						axpf__write_char( s, x.c[ i ] );
-					} else if( s->lenspec == kAxLS_l || spec == 'C' ) {
-						axpf__write_wchar( s, x.wc[ i ] );
-					}
-					break;
+	if( s->argmode == kAxPM_Pack ) {
+		return 1;
+	}
 
-				case 's':
-				case 'S':
-					if( s->lenspec == kAxLS_None && spec != 'S' ) {
-						axpf__write_str( s, x.s[ i ] );
-					} else if( s->lenspec == kAxLS_l || spec == 'S' ) {
-						axpf__write_wstr( s, x.ws[ i ] );
-					}
-					break;
+	if( ch == '\\' && ( s->flags & kAxPF_FSPath ) ) {
+		ch = '/';
+	}
 
-				case 'p':
-					s->radix = 16;
-					s->flags |= kAxPF_Radix | kAxPF_Pointer | kAxPF_Precision;
-					s->precision = sizeof( void * )*2;
-					axpf__write_uint( s, x.sz[ i ] );
-					break;
-				}
+	while( num > 0 ) {
+		n = ( axpf_size_t )( s->we - s->wp );
+		if( !n ) {
+			if( !axpf__flush( s, num, 0 ) ) {
+				return 0;
 			}
 
-			if( s->arrayprint[ 2 ] == ' ' ) {
-				axpf__writech( s, ' ' );
+			if( ( n = ( axpf_size_t )( s->we - s->wp ) ) == 0 ) {
+				return 1;
 			}
+		}
 
-			axpf__writech( s, s->arrayprint[ 3 ] );
+		if( n > num ) {
+			n = num;
 		}
 
-		return !s->diderror;
+		memset( ( void * )s->wp, ch, n );
+		s->wp += n;
+		num -= ( unsigned )n;
 	}
 
-	/* check the specifier */
-	switch( spec ) {
-	case 'd':
-	case 'i':
-		if( s->lenspec == kAxLS_l ) {
-			axpf__write_int( s, va_arg( s->args, long int ) );
-		} else if( s->lenspec == kAxLS_ll || s->lenspec == kAxLS_L ) {
-			axpf__write_int( s, va_arg( s->args, axpf_longlong_t ) );
-		} else if( s->lenspec == kAxLS_t || s->lenspec == kAxLS_I ) {
-			axpf__write_int( s, va_arg( s->args, axpf_ptrdiff_t ) );
-		} else if( s->lenspec == kAxLS_z ) {
-			axpf__write_int( s, va_arg( s->args, axpf_size_t ) );
-		} else if( s->lenspec == kAxLS_j ) {
-			axpf__write_int( s, va_arg( s->args, axpf_smax_t ) );
-		} else if( s->lenspec == kAxLS_I32 ) {
-			axpf__write_int( s, va_arg( s->args, axpf_s32_t ) );
-		} else if( s->lenspec == kAxLS_I64 ) {
-			axpf__write_int( s, va_arg( s->args, axpf_s64_t ) );
-		} else {
-			axpf__write_int( s, va_arg( s->args, int ) );
-		}
-		break;
+	return 1;
+}
+static int axpf__write_uintx( struct axpf__state_ *s, axpf_umax_t i, char sign )
+{
+	const char *prefix;
+	unsigned prefixlen;
+	unsigned numberlen, numbersignlen;
+	unsigned numpadzeroes;
+	unsigned numpadspaces;
+	unsigned padinfringe;
+	char buf[ 128 ];
+	char *p;
+	int f;
 
-	case 'u':
-	case 'o':
-	case 'x':
-	case 'r':
-		if( spec == 'o' ) {
-			s->radix = 8;
-		} else if( spec == 'x' ) {
-			s->radix = 16;
-		} else if( spec == 'r' ) {
-			s->radix = va_arg( s->args, unsigned int );
-		}
-
-		if( s->lenspec == kAxLS_l ) {
-			axpf__write_uint( s, va_arg( s->args, unsigned long int ) );
-		} else if( s->lenspec == kAxLS_ll || s->lenspec == kAxLS_L ) {
-			axpf__write_uint( s, va_arg( s->args, axpf_ulonglong_t ) );
-		} else if( s->lenspec == kAxLS_t ) {
-			axpf__write_uint( s, va_arg( s->args, axpf_ptrdiff_t ) );
-		} else if( s->lenspec == kAxLS_z || s->lenspec == kAxLS_I ) {
-			axpf__write_uint( s, va_arg( s->args, axpf_size_t ) );
-		} else if( s->lenspec == kAxLS_j ) {
-			axpf__write_uint( s, va_arg( s->args, axpf_umax_t ) );
-		} else if( s->lenspec == kAxLS_I32 ) {
-			axpf__write_uint( s, va_arg( s->args, axpf_u32_t ) );
-		} else if( s->lenspec == kAxLS_I64 ) {
-			axpf__write_uint( s, va_arg( s->args, axpf_u64_t ) );
-		} else {
-			axpf__write_uint( s, va_arg( s->args, unsigned int ) );
-		}
-		break;
+	if( s->argmode == kAxPM_Pack ) {
+		return 1;
+	}
 
-	case 'f':
-	case 'e':
-	case 'g':
-	case 'a':
-		if( spec == 'a' ) {
-			spec = 'f';
-			s->radix = 16;
-		}
+	f = 0;
+	if( s->flags & kAxPF_Upper ) { f |= 1; }
+	if( ( s->flags & kAxPF_Precision ) && s->precision == 0 ) { f |= 2; }
+	if( s->flags & kAxPF_Group ) { f |= 4; }
 
-		if( s->lenspec == kAxLS_None ) {
-			axpf__write_floatd( s, va_arg( s->args, double ), spec );
-		} else if( s->lenspec == kAxLS_l || s->lenspec == kAxLS_L ) {
-			axpf__write_floatd( s, ( double )va_arg( s->args, long double ),
-				spec );
-		}
-		break;
+	p = axpf__utoa( &buf[ sizeof( buf ) ], i, s->radix, f );
 
-	case 'c':
-	case 'C':
-		if( s->lenspec == kAxLS_None && spec != 'C' ) {
-			axpf__write_char( s, va_arg( s->args, int ) );
-		} else if( s->lenspec == kAxLS_l || spec == 'C' ) {
-			axpf__write_wchar( s, va_arg( s->args, int/*wint_t*/ ) );
+	prefix = NULL;
+	prefixlen = 0;
+	if( s->flags & ( kAxPF_Radix | kAxPF_Pointer ) ) {
+		int useupper;
+
+		if( ( s->flags & kAxPF_Pointer ) || ( ~s->flags & kAxPF_Upper ) ) {
+			useupper = 0;
+		} else {
+			useupper = 1;
 		}
-		break;
 
-	case 's':
+		switch( s->radix ) {
+		case 2:
+			prefixlen = 2;
+			prefix = useupper ? "0B" : "0b";
+			break;
+		case 8:
+			prefixlen = 1;
+			prefix = "0";
+			break;
+		case 16:
+			prefixlen = 2;
+			prefix = useupper ? "0X" : "0x";
+			break;
+		default:
+			break;
+		}
+	}
+	numberlen = ( unsigned )( axpf_size_t )( &buf[ sizeof( buf ) - 1 ] - p );
+
+	if( !sign ) {
+		if( s->flags & kAxPF_Sign ) {
+			sign = '+';
+		} else if( s->flags & kAxPF_Space ) {
+			sign = ' ';
+		}
+	}
+	numbersignlen = numberlen + +( sign != '\0' );
+
+	numpadzeroes = 0;
+	if( ( s->flags & kAxPF_Precision ) && ( unsigned )s->precision > numbersignlen ) {
+		numpadzeroes = s->precision - numbersignlen;
+	}
+
+	numpadspaces = 0;
+	padinfringe = numbersignlen + prefixlen + numpadzeroes;
+	if( ( s->flags & kAxPF_Width ) && ( unsigned )s->width > padinfringe ) {
+		if( s->flags & kAxPF_Zero ) {
+			numpadzeroes += s->width - padinfringe;
+		} else {
+			numpadspaces += s->width - padinfringe;
+		}
+	}
+
+	if( ~s->flags & kAxPF_Left ) {
+		if( !axpf__pad( s, numpadspaces, ' ' ) ) {
+			return 0;
+		}
+	}
+
+	if( sign ) {
+		if( !axpf__writech( s, sign ) ) {
+			return 0;
+		}
+	}
+
+	if( prefix != NULL && prefixlen > 0 ) {
+		if( !axpf__write( s, prefix, prefix + prefixlen ) ) {
+			return 0;
+		}
+	}
+	axpf__pad( s, numpadzeroes, '0' );
+
+	if( !axpf__write( s, p, &buf[ sizeof( buf ) - 1 ] ) ) {
+		return 0;
+	}
+
+	if( s->flags & kAxPF_Left ) {
+		if( !axpf__pad( s, numpadspaces, ' ' ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+static int axpf__write_int( struct axpf__state_ *s, axpf_smax_t i )
+{
+	while( s->repeats-- > 0 ) {
+		if( i < 0 ) {
+			if( !axpf__write_uintx( s, ( axpf_umax_t )-i, '-' ) ) {
+				return 0;
+			}
+		} else if( !axpf__write_uintx( s, ( axpf_umax_t )i, '\0' ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+static int axpf__write_uint( struct axpf__state_ *s, axpf_umax_t i )
+{
+	while( s->repeats-- > 0 ) {
+		if( !axpf__write_uintx( s, i, '\0' ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* remove trailing fraction zeros (and a bare decimal point) from [b, e) */
+static char *axpf__flt_trim( char *b, char *e )
+{
+	char *p;
+
+	for( p = b; p < e && *p != '.'; ++p ) {
+	}
+	if( p == e ) {
+		return e;
+	}
+
+	while( *( e - 1 ) == '0' ) {
+		--e;
+	}
+	if( *( e - 1 ) == '.' ) {
+		--e;
+	}
+
+	return e;
+}
+/* positional digits: integer part, then `fd` fraction digits */
+static char *axpf__flt_fixed( char *p, const char *digs, int n, int x, int fd, int alt, int trim )
+{
+	char *b;
+	int i;
+
+	b = p;
+
+	if( x < 0 ) {
+		*p++ = '0';
+	} else {
+		for( i = 0; i <= x; ++i ) {
+			*p++ = i < n ? digs[ i ] : '0';
+		}
+	}
+
+	if( fd > 0 || alt ) {
+		*p++ = '.';
+	}
+
+	for( i = x + 1; i <= x + fd; ++i ) {
+		*p++ = i >= 0 && i < n ? digs[ i ] : '0';
+	}
+
+	return trim ? axpf__flt_trim( b, p ) : p;
+}
+/* one digit, `fd` fraction digits, then the exponent (at least two digits) */
+static char *axpf__flt_exp( char *p, const char *digs, int n, int x, int fd, int alt, int trim, char e )
+{
+	char tmp[ 8 ], *b, *q;
+	int i;
+
+	b = p;
+	*p++ = n > 0 ? digs[ 0 ] : '0';
+	if( fd > 0 || alt ) {
+		*p++ = '.';
+	}
+	for( i = 1; i <= fd; ++i ) {
+		*p++ = i < n ? digs[ i ] : '0';
+	}
+	if( trim ) {
+		p = axpf__flt_trim( b, p );
+	}
+
+	*p++ = e;
+	*p++ = x < 0 ? '-' : '+';
+	if( x < 0 ) {
+		x = -x;
+	}
+
+	q = &tmp[ sizeof( tmp ) ];
+	do {
+		*--q = ( char )( '0' + x%10 );
+		x /= 10;
+	} while( x > 0 );
+	if( q == &tmp[ sizeof( tmp ) - 1 ] ) {
+		*--q = '0';
+	}
+
+	while( q < &tmp[ sizeof( tmp ) ] ) {
+		*p++ = *q++;
+	}
+
+	return p;
+}
+/* %a: hexadecimal significand and binary exponent */
+static char *axpf__flt_hex( char *p, axpf_u64_t frac, int bexp, int prec, int alt, int upper )
+{
+	const char *hexdigits;
+	unsigned lead;
+	int e, i, nd;
+
+	hexdigits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+
+	lead = bexp != 0;
+	e = bexp != 0 ? bexp - 1023 : ( frac != 0 ? -1022 : 0 );
+
+	if( prec >= 0 && prec < 13 ) {
+		axpf_u64_t rem, half;
+		unsigned sh;
+
+		sh = ( unsigned )( 13 - prec )*4;
+		rem = frac & ( ( 1ULL<<sh ) - 1 );
+		half = 1ULL<<( sh - 1 );
+		frac >>= sh;
+
+		if( rem > half || ( rem == half && ( ( prec > 0 ? frac : lead ) & 1 ) ) ) {
+			if( ( ++frac>>( prec*4 ) ) != 0 ) {
+				frac = 0;
+				++lead;
+			}
+		}
+		frac <<= sh;
+
+		nd = prec;
+	} else if( prec < 0 ) {
+		for( nd = 13; nd > 0 && !( ( frac>>( ( 13 - nd )*4 ) ) & 0xF ); --nd ) {
+		}
+	} else {
+		nd = prec;
+	}
+
+	*p++ = '0';
+	*p++ = upper ? 'X' : 'x';
+	*p++ = hexdigits[ lead ];
+	if( nd > 0 || alt ) {
+		*p++ = '.';
+	}
+	for( i = 0; i < nd; ++i ) {
+		*p++ = i < 13 ? hexdigits[ ( frac>>( ( 12 - i )*4 ) ) & 0xF ] : '0';
+	}
+
+	*p++ = upper ? 'P' : 'p';
+	if( e < 0 ) {
+		*p++ = '-';
+		e = -e;
+	} else {
+		*p++ = '+';
+	}
+	if( e >= 1000 ) { *p++ = ( char )( '0' + e/1000 ); }
+	if( e >= 100 )  { *p++ = ( char )( '0' + e/100%10 ); }
+	if( e >= 10 )   { *p++ = ( char )( '0' + e/10%10 ); }
+	*p++ = ( char )( '0' + e%10 );
+
+	return p;
+}
+
+/*
+	%f, %e, %g and (with radix 16) %a, following C99 unless
+	AXPF_SHORTEST_G_ENABLED is set, in which case %g without a precision
+	prints the shortest digits that read back as the same double; precisions
+	above AXPF__FLT_MAXPREC are clamped
+*/
+static int axpf__write_floatd( struct axpf__state_ *s, double f, char spec )
+{
+	union {
+		axpf_u64_t i;
+		double f;
+	} x;
+	char digs[ AXPF__FLT_MAXDIGITS ];
+	char buf[ AXPF__FLT_MAXDIGITS + 16 ];
+	char *p, *body;
+	axpf_u64_t m, frac;
+	unsigned total, pad, prefixlen;
+	int bexp, e2, prec, alt, upper, finite, n, dx, sd;
+	char sign;
+
+	if( s->argmode == kAxPM_Pack ) {
+		return 1;
+	}
+
+	x.f = f;
+	frac = x.i & 0xFFFFFFFFFFFFFULL;
+	bexp = ( int )( ( x.i>>52 ) & 0x7FF );
+
+	if( x.i>>63 ) {
+		sign = '-';
+	} else if( s->flags & kAxPF_Sign ) {
+		sign = '+';
+	} else if( s->flags & kAxPF_Space ) {
+		sign = ' ';
+	} else {
+		sign = '\0';
+	}
+
+	prec = ( s->flags & kAxPF_Precision ) && s->precision >= 0 ? s->precision : -1;
+	if( prec > AXPF__FLT_MAXPREC ) {
+		prec = AXPF__FLT_MAXPREC;
+	}
+	alt = ( s->flags & kAxPF_Radix ) != 0;
+	upper = ( s->flags & kAxPF_Upper ) != 0;
+	finite = bexp != 0x7FF;
+	prefixlen = 0;
+
+	body = &buf[ 0 ];
+	p = body;
+	if( !finite ) {
+		const char *q;
+
+		q = frac != 0 ? ( upper ? "NAN" : "nan" ) : ( upper ? "INF" : "inf" );
+		while( *q != '\0' ) {
+			*p++ = *q++;
+		}
+	} else if( s->radix == 16 ) {
+		p = axpf__flt_hex( p, frac, bexp, prec, alt, upper );
+		prefixlen = 2;
+	} else {
+		if( bexp != 0 ) {
+			m = frac | ( 1ULL<<52 );
+			e2 = bexp - 1075;
+		} else {
+			m = frac;
+			e2 = -1074;
+		}
+
+		switch( spec ) {
+		case 'e':
+			prec = prec < 0 ? 6 : prec;
+			n = axpf__dtoa_fixed( digs, &dx, m, e2, prec + 1, 0 );
+			p = axpf__flt_exp( p, digs, n, dx, prec, alt, 0, upper ? 'E' : 'e' );
+			break;
+
+		case 'g':
+			/* sd is the number of significant digits shown */
+			if( prec < 0 && AXPF_SHORTEST_G_ENABLED ) {
+				n = 0;
+				dx = 0;
+				if( m != 0 ) {
+					n = axpf__dtoa_shortest( digs, &dx, m, e2, frac == 0 && bexp > 1 );
+				}
+				sd = n > 0 ? n : 1;
+				prec = 17;
+			} else {
+				prec = prec < 0 ? 6 : ( prec > 0 ? prec : 1 );
+				n = axpf__dtoa_fixed( digs, &dx, m, e2, prec, 0 );
+				sd = prec;
+			}
+
+			if( dx < -4 || dx >= prec ) {
+				p = axpf__flt_exp( p, digs, n, dx, sd - 1, alt, !alt, upper ? 'E' : 'e' );
+			} else {
+				p = axpf__flt_fixed( p, digs, n, dx, sd > dx + 1 ? sd - dx - 1 : 0, alt, !alt );
+			}
+			break;
+
+		default:
+			prec = prec < 0 ? 6 : prec;
+			n = axpf__dtoa_fixed( digs, &dx, m, e2, prec, 1 );
+			p = axpf__flt_fixed( p, digs, n, dx, prec, alt, 0 );
+			break;
+		}
+	}
+
+	total = ( unsigned )( axpf_size_t )( p - body ) + ( sign != '\0' );
+	pad = ( s->flags & kAxPF_Width ) && s->width > 0 && ( unsigned )s->width > total ? ( unsigned )s->width - total : 0;
+
+	while( s->repeats-- > 0 ) {
+		if( ( ~s->flags & kAxPF_Left ) && ( !finite || ( ~s->flags & kAxPF_Zero ) ) ) {
+			if( !axpf__pad( s, pad, ' ' ) ) {
+				return 0;
+			}
+		}
+
+		if( sign != '\0' && !axpf__writech( s, sign ) ) {
+			return 0;
+		}
+
+		if( ( ~s->flags & kAxPF_Left ) && finite && ( s->flags & kAxPF_Zero ) ) {
+			if( !axpf__write( s, body, body + prefixlen ) || !axpf__pad( s, pad, '0' ) || !axpf__write( s, body + prefixlen, p ) ) {
+				return 0;
+			}
+		} else if( !axpf__write( s, body, p ) ) {
+			return 0;
+		}
+
+		if( s->flags & kAxPF_Left ) {
+			if( !axpf__pad( s, pad, ' ' ) ) {
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+static int axpf__write_char( struct axpf__state_ *s, int ch )
+{
+	while( s->repeats-- > 0 ) {
+		if( !axpf__writech( s, ch ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+static int axpf__writewch( struct axpf__state_ *s, wchar_t ch )
+{
+	( void )s;
+	( void )ch;
+
+	return 0;
+}
+static int axpf__write_wchar( struct axpf__state_ *s, wchar_t ch )
+{
+	while( s->repeats-- > 0 ) {
+		if( !axpf__writewch( s, ch ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int axpf__write_str( struct axpf__state_ *s, const char *p )
+{
+	const char *e;
+
+	if( !p ) {
+		p = "(null)";
+		e = p + 6;
+		if( s->flags & kAxPF_Precision ) {
+			if( s->precision <= 6 ) {
+				e = &p[ s->precision ];
+			}
+		}
+	} else {
+		e = p + axpf__strlen( s, p );
+	}
+
+	while( s->repeats-- > 0 ) {
+		if( !axpf__write( s, p, e ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+static int axpf__write_wstr( struct axpf__state_ *s, const wchar_t *p )
+{
+	const wchar_t *e;
+
+	if( !p ) {
+		p = L"(null)";
+		e = p + 6;
+		if( s->flags & kAxPF_Precision ) {
+			if( s->precision <= 6 ) {
+				e = &p[ s->precision ];
+			}
+		}
+	} else {
+		e = p + axpf__wstrlen( s, p );
+	}
+
+	while( s->repeats-- > 0 ) {
+		/* FIXME: If `AXPF_UTF8CONV_ENABLED == 1` then just forward to the writer */
+		while( p < e ) {
+			if( !axpf__writewch( s, *p++ ) ) {
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+static int axpf__write_syserr( struct axpf__state_ *s, int err )
+{
+	char errbuf[ 128 ];
+
+	if( s->argmode == kAxPM_Pack ) {
+		return 1;
+	}
+
+#if defined( _MSC_VER ) && defined( __STDC_WANT_SECURE_LIB__ )
+	if( strerror_s( errbuf, sizeof( errbuf ), err ) != 0 ) {
+		errbuf[ 0 ] = '('; errbuf[ 1 ] = 'n'; errbuf[ 2 ] = 'u';
+		errbuf[ 3 ] = 'l'; errbuf[ 4 ] = 'l'; errbuf[ 5 ] = ')';
+		errbuf[ 6 ] = '\0';
+	}
+#else
+	strncpy( errbuf, strerror( err ), sizeof( errbuf ) - 1 );
+#endif
+	errbuf[ sizeof( errbuf ) - 1 ] = '\0';
+
+	while( s->repeats-- > 0 ) {
+		if( !axpf__write( s, errbuf, strchr( errbuf, '\0' ) ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+static int axpf__write_bitfield( struct axpf__state_ *s, int bits,
+const char *names )
+{
+	int needcomma;
+
+	if( s->argmode == kAxPM_Pack ) {
+		return 1;
+	}
+
+	if( !names || !*names ) {
+		return 0;
+	}
+
+	if( !s->repeats ) {
+		return 1;
+	}
+
+	s->radix = *( const unsigned char * )names;
+	if( s->radix == 1 ) {
+		s->radix = 10;
+	}
+
+	++names;
+
+	if( !axpf__write_uint( s, ( unsigned )bits ) ) {
+		return 0;
+	}
+
+	if( !axpf__writech( s, ' ' ) || !axpf__writech( s, '<' ) ) {
+		return 0;
+	}
+
+	needcomma = 0;
+	while( *names && bits ) {
+		unsigned bit;
+
+		bit = ( ( unsigned )*names++ ) - 1;
+		if( bits & ( 1<<bit ) ) {
+			const char *p;
+
+			bits &= ~( 1<<bit );
+
+			if( needcomma ) {
+				axpf__writech( s, ',' );
+			}
+
+			p = names;
+			while( *names > ' ' ) {
+				++names;
+			}
+
+			if( !axpf__write( s, p, names ) ) {
+				return 0;
+			}
+
+			needcomma = 1;
+		}
+	}
+
+	if( !axpf__writech( s, '>' ) ) {
+		return 0;
+	}
+
+	return 1;
+}
+static int axpf__write_hex_dump( struct axpf__state_ *s, const unsigned char *p,
+const char *delimiter )
+{
+	const char *delimend;
+	unsigned count = 16;
+	unsigned n;
+	unsigned i;
+
+	if( s->argmode == kAxPM_Pack ) {
+		return 1;
+	}
+
+	if( !s->repeats ) {
+		return 1;
+	}
+
+	if( !p ) {
+		const char buf[] = "(null)";
+		return axpf__write( s, buf, buf + sizeof(buf) - 1 );
+	}
+
+	if( !delimiter || !*delimiter ) {
+		delimiter = " ";
+	}
+
+	delimend = strchr( delimiter, '\0' );
+	n = ( unsigned )( axpf_size_t )( delimend - delimiter );
+
+	s->radix = 16;
+
+	if( ( s->flags & kAxPF_Width ) && s->width > 0 ) {
+		count = s->width;
+	}
+
+	s->flags = kAxPF_Precision;
+	s->precision = 2;
+	for( i = 0; i < count; ++i ) {
+		if( i > 0 && !axpf__writech( s, delimiter[ ( i - 1 )%n ] ) ) {
+			return 0;
+		}
+
+		if( !axpf__write_uintx( s, p[ i ], '\0' ) ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static int axpf__find( struct axpf__state_ *s, int ch, int doflush )
+{
+	const char *p;
+	axpf_size_t n;
+
+	n = ( axpf_size_t )( s->e - s->p );
+	if( !n ) {
+		return 0;
+	}
+
+	p = ( const char * )memchr( ( const void * )s->p, ch, n );
+	if( !p ) {
+		return 0;
+	}
+
+	if( doflush && s->p != p ) {
+		if( !axpf__write( s, s->p, p ) ) {
+			return 0;
+		}
+	}
+
+	s->p = p;
+	return 1;
+}
+
+static int axpf__getdigit( int ch, unsigned radix )
+{
+	unsigned rlo, rhi;
+	unsigned c;
+
+	rlo = radix < 10 ? radix : 10;
+	rhi = radix > 10 ? radix - 10 : 0;
+
+	c = ( unsigned )ch;
+	if( c >= '0' && c < '0' + rlo ) {
+		return ch - '0';
+	}
+
+	if( c >= 'a' && c < 'a' + rhi ) {
+		return ch - 'a' + 10;
+	}
+	if( c >= 'A' && c < 'A' + rhi ) {
+		return ch - 'A' + 10;
+	}
+
+	return -1;
+}
+
+static unsigned axpf__step_uint( struct axpf__state_ *s )
+{
+	unsigned r = 0;
+
+	for(;;) {
+		int n;
+
+		n = axpf__getdigit( axpf__look( s ), 10 );
+		if( n < 0 ) {
+			break;
+		}
+
+		if( r < ( 1L<<( sizeof( int )*8 - 2 ) ) ) {
+			r *= 10;
+			r += n;
+		}
+		axpf__skip( s );
+	}
+
+	return r;
+}
+static int axpf__step_int( struct axpf__state_ *s )
+{
+	int m = 1;
+
+	if( axpf__check( s, '-' ) ) {
+		m = -1;
+	}
+
+	return m*( int )axpf__step_uint( s );
+}
+/* parse the directive at s->p (just past its '%') into `d` */
+static void axpf__parse( struct axpf__state_ *s, struct axpf__insn_ *d )
+{
+	unsigned fcount;
+	char spec;
+
+	d->repeats = 1;
+	d->arraysize = 0;
+	d->arrayprint[ 0 ] = '{';
+	d->arrayprint[ 1 ] = ',';
+	d->arrayprint[ 2 ] = ' ';
+	d->arrayprint[ 3 ] = '}';
+	d->flags = 0;
+	d->width = 0;
+	d->precision = 0;
+	d->lenspec = kAxLS_None;
+	d->stars = 0;
+
+	/* repeats */
+	if( axpf__check( s, '{' ) ) {
+		if( axpf__check( s, '*' ) ) {
+			d->stars |= kAxPFS_Repeats;
+		} else {
+			d->repeats = axpf__step_uint( s );
+		}
+
+		( void )axpf__check( s, '}' );
+	}
+
+	/* array */
+	if( axpf__check( s, '[' ) ) {
+		unsigned n = 0;
+
+		if( axpf__check( s, '*' ) ) {
+			d->stars |= kAxPFS_Array;
+		} else {
+			d->arraysize = axpf__step_uint( s );
+		}
+		d->flags |= kAxPF_Array;
+
+		while( n < AXPF__MAX_ARRAY_PRINT ) {
+			if( axpf__check( s, ']' ) ) {
+				break;
+			}
+
+			d->arrayprint[ n++ ] = axpf__read( s );
+		}
+
+		if( n == AXPF__MAX_ARRAY_PRINT ) {
+			( void )axpf__check( s, ']' );
+		} else if( n > 0 ) {
+			/* the last character specified is the closing value */
+			d->arrayprint[ AXPF__MAX_ARRAY_PRINT - 1 ] = d->arrayprint[ n - 1 ];
+
+			/* if a space was omitted then don't space elements out */
+			if( n < 4 ) {
+				d->arrayprint[ 2 ] = '\0';
+			}
+
+			/* if a delimiter was omitted then assume a comma */
+			if( n < 3 ) {
+				d->arrayprint[ 1 ] = ',';
+			}
+		}
+	}
+
+	/* flags */
+	do {
+		fcount = 0;
+
+		if( axpf__check( s, '-' ) ) {
+			d->flags |= kAxPF_Left;
+			++fcount;
+		}
+		if( axpf__check( s, '+' ) ) {
+			d->flags |= kAxPF_Sign;
+			++fcount;
+		}
+		if( axpf__check( s, ' ' ) ) {
+			d->flags |= kAxPF_Space;
+			++fcount;
+		}
+		if( axpf__check( s, '#' ) ) {
+			d->flags |= kAxPF_Radix;
+			++fcount;
+		}
+		if( axpf__check( s, '0' ) ) {
+			d->flags |= kAxPF_Zero;
+			++fcount;
+		}
+		if( axpf__check( s, '\'' ) ) {
+			d->flags |= kAxPF_Group;
+			++fcount;
+		}
+		if( axpf__check( s, '/' ) ) {
+			d->flags |= kAxPF_FSPath;
+			++fcount;
+		}
+	} while( fcount > 0 );
+
+	/* width */
+	if( axpf__check( s, '*' ) ) {
+		d->stars |= kAxPFS_Width;
+		d->flags |= kAxPF_Width;
+	} else if( axpf__getdigit( axpf__look( s ), 10 ) >= 0 ) {
+		d->width = axpf__step_int( s );
+		d->flags |= kAxPF_Width;
+	}
+
+	/* precision */
+	if( axpf__check( s, '.' ) ) {
+		if( axpf__check( s, '*' ) ) {
+			d->stars |= kAxPFS_Precision;
+			d->flags |= kAxPF_Precision;
+		} else if( axpf__getdigit( axpf__look( s ), 10 ) >= 0 ) {
+			d->precision = axpf__step_int( s );
+			d->flags |= kAxPF_Precision;
+		}
+	}
+
+	/* length specifier */
+	if( axpf__check( s, 'h' ) ) {
+		if( axpf__check( s, 'h' ) ) {
+			d->lenspec = kAxLS_hh;
+		} else {
+			d->lenspec = kAxLS_h;
+		}
+	} else if( axpf__check( s, 'l' ) ) {
+		if( axpf__check( s, 'l' ) ) {
+			d->lenspec = kAxLS_ll;
+		} else {
+			d->lenspec = kAxLS_l;
+		}
+	} else if( axpf__check( s, 'j' ) ) {
+		d->lenspec = kAxLS_j;
+	} else if( axpf__check( s, 'z' ) ) {
+		d->lenspec = kAxLS_z;
+	} else if( axpf__check( s, 't' ) ) {
+		d->lenspec = kAxLS_t;
+	} else if( axpf__check( s, 'L' ) ) {
+		d->lenspec = kAxLS_L;
+	} else if( axpf__check( s, 'q' ) ) {
+		d->lenspec = kAxLS_I64;
+	} else if( axpf__check( s, 'w' ) ) {
+		d->lenspec = kAxLS_l;
+	} else if( axpf__check( s, 'I' ) ) {
+		if( axpf__checks( s, "32" ) ) {
+			d->lenspec = kAxLS_I32;
+		} else if( axpf__checks( s, "64" ) ) {
+			d->lenspec = kAxLS_I64;
+		} else {
+			d->lenspec = kAxLS_I;
+		}
+	}
+
+	spec = axpf__read( s );
+	if( spec >= 'A' && spec <= 'Z' && spec!='C' && spec!='D' && spec!='S' ) {
+		d->flags |= kAxPF_Upper;
+		spec = spec - 'A' + 'a';
+	}
+	d->spec = spec;
+
+	/* the common directives get a shorter path through axpf__exec */
+	d->kind = kAxPFK_Generic;
+	if( !d->flags && !d->stars && d->repeats == 1 && d->lenspec == kAxLS_None ) {
+		if( spec == 's' ) {
+			d->kind = kAxPFK_Str;
+		} else if( spec == 'd' || spec == 'i' ) {
+			d->kind = kAxPFK_Int;
+		}
+	}
+}
+/* load a parsed directive into the state, reading the fields given as '*' */
+static void axpf__apply( struct axpf__state_ *s, const struct axpf__insn_ *d )
+{
+	s->repeats = d->repeats;
+	s->arraysize = d->arraysize;
+	s->arrayprint[ 0 ] = d->arrayprint[ 0 ];
+	s->arrayprint[ 1 ] = d->arrayprint[ 1 ];
+	s->arrayprint[ 2 ] = d->arrayprint[ 2 ];
+	s->arrayprint[ 3 ] = d->arrayprint[ 3 ];
+	s->flags = d->flags;
+	s->width = d->width;
+	s->precision = d->precision;
+	s->lenspec = ( axpf__lengthSpecifier_t )d->lenspec;
+	s->radix = 10;
+
+	if( d->stars != 0 ) {
+		if( d->stars & kAxPFS_Repeats ) {
+			AXPF__ARG( s, unsigned, s->repeats );
+		}
+		if( d->stars & kAxPFS_Array ) {
+			AXPF__ARG( s, axpf_size_t, s->arraysize );
+		}
+		if( d->stars & kAxPFS_Width ) {
+			AXPF__ARG( s, int, s->width );
+		}
+		if( d->stars & kAxPFS_Precision ) {
+			AXPF__ARG( s, int, s->precision );
+		}
+	}
+}
+/* format the directive loaded by axpf__apply */
+static int axpf__emit( struct axpf__state_ *s, char spec )
+{
+	void *ptrcount;
+
+	/* arrays require special handling */
+	if( s->flags & kAxPF_Array ) {
+		const void *ptrbase;
+		unsigned repeats;
+
+		if( spec == 'r' ) {
+			AXPF__ARG( s, unsigned int, s->radix );
+		}
+		ptrbase = axpf__arg_block( s, spec, 0 );
+
+		if( spec == 'a' ) {
+			spec = 'f';
+			s->radix = 16;
+		}
+
+		repeats = s->repeats;
+		while( repeats-- > 0 ) {
+			union {
+				const void *p;
+				const int *i; const unsigned int *u;
+				const signed char *sc; const unsigned char *usc;
+				const short int *si; const unsigned short int *usi;
+				const long int *li; const unsigned long int *uli;
+#ifdef _MSC_VER
+				const __int64 *lli; const unsigned __int64 *ulli;
+#else
+				const long long int *lli; const unsigned long long int *ulli;
+#endif
+				const axpf_smax_t *im; const axpf_umax_t *uim;
+				const axpf_size_t *sz;
+				const axpf_ptrdiff_t *pd;
+				const axpf_s32_t *i32; const axpf_u32_t *ui32;
+				const axpf_s64_t *i64; const axpf_u64_t *ui64;
+				const float *f;
+				const double *d;
+				const long double *ld;
+				const char *c;
+				const wchar_t *wc;
+			} x;
+			axpf_size_t i;
+
+			if( !ptrbase ) {
+				const char buf[] = "(null)";
+				axpf__write( s, buf, buf + sizeof(buf) - 1 );
+				continue;
+			}
+
+			axpf__writech( s, s->arrayprint[ 0 ] );
+
+			x.p = ptrbase;
+			for( i = 0; i < s->arraysize; ++i ) {
+				if( i > 0 ) {
+					axpf__writech( s, s->arrayprint[ 1 ] );
+				}
+				if( s->arrayprint[ 2 ] == ' ' ) {
+					axpf__writech( s, ' ' );
+				}
+
+				s->repeats = 1;
+				switch( spec ) {
+				case 'd':
+				case 'i':
+					switch( s->lenspec ) {
+#define P_(F_) axpf__write_int( s, x.F_[i] ); break
+					case kAxLS_None: P_( i );
+					case kAxLS_hh:   P_( sc );
+					case kAxLS_h:    P_( si );
+					case kAxLS_l:    /*fallthrough*/
+					case kAxLS_L:    P_( li );
+					case kAxLS_ll:   P_( lli );
+					case kAxLS_j:    P_( im );
+					case kAxLS_z:    P_( sz );
+					case kAxLS_I:    /*fallthrough*/
+					case kAxLS_t:    P_( pd );
+					case kAxLS_I32:  P_( i32 );
+					case kAxLS_I64:  P_( i64 );
+#undef P_
+					}
+					break;
+
+				case 'u':
+				case 'o':
+				case 'x':
+				case 'r':
+					if( spec == 'o' ) {
+						s->radix = 8;
+					} else if( spec == 'x' ) {
+						s->radix = 16;
+					} else if( spec == 'r' ) {
+						AXPF__ARG( s, unsigned int, s->radix );
+					}
+
+					switch( s->lenspec ) {
+#define P_(F_) axpf__write_uint( s, x.F_[i] ); break
+					case kAxLS_None: P_( u );
+					case kAxLS_hh:   P_( usc );
+					case kAxLS_h:    P_( usi );
+					case kAxLS_l:    /*fallthrough*/
+					case kAxLS_L:    P_( uli );
+					case kAxLS_ll:   P_( ulli );
+					case kAxLS_j:    P_( uim );
+					case kAxLS_I:    /*fallthrough*/
+					case kAxLS_z:    P_( sz );
+					case kAxLS_t:    P_( pd );
+					case kAxLS_I32:  P_( ui32 );
+					case kAxLS_I64:  P_( ui64 );
+#undef P_
+					}
+					break;
+
+				case 'f':
+				case 'e':
+				case 'g':
+					if( s->lenspec == kAxLS_None ) {
+						axpf__write_floatd( s, ( double )x.f[ i ], spec );
+					} else if( s->lenspec == kAxLS_l ) {
+						axpf__write_floatd( s, x.d[ i ], spec );
+					} else if( s->lenspec == kAxLS_L ) {
+						axpf__write_floatd( s, ( double )x.ld[ i ], spec );
+					}
+					break;
+
+				case 'c':
+				case 'C':
+					if( s->lenspec == kAxLS_None && spec != 'C' ) {
+						axpf__write_char( s, x.c[ i ] );
+					} else if( s->lenspec == kAxLS_l || spec == 'C' ) {
+						axpf__write_wchar( s, x.wc[ i ] );
+					}
+					break;
+
+				case 's':
+				case 'S':
+					if( s->lenspec == kAxLS_None && spec != 'S' ) {
+						axpf__write_str( s, axpf__array_str( s, x.p, i ) );
+					} else if( s->lenspec == kAxLS_l || spec == 'S' ) {
+						axpf__write_wstr( s, axpf__array_wstr( s, x.p, i ) );
+					}
+					break;
+
+				case 'p':
+					s->radix = 16;
+					s->flags |= kAxPF_Radix | kAxPF_Pointer | kAxPF_Precision;
+					s->precision = sizeof( void * )*2;
+					axpf__write_uint( s, x.sz[ i ] );
+					break;
+				}
+			}
+
+			if( s->arrayprint[ 2 ] == ' ' ) {
+				axpf__writech( s, ' ' );
+			}
+
+			axpf__writech( s, s->arrayprint[ 3 ] );
+		}
+
+		return !s->diderror;
+	}
+
+	/* check the specifier */
+	switch( spec ) {
+	case 'd':
+	case 'i':
+		axpf__write_int( s, axpf__arg_int( s ) );
+		break;
+
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'r':
+		if( spec == 'o' ) {
+			s->radix = 8;
+		} else if( spec == 'x' ) {
+			s->radix = 16;
+		} else if( spec == 'r' ) {
+			AXPF__ARG( s, unsigned int, s->radix );
+		}
+
+		axpf__write_uint( s, axpf__arg_uint( s ) );
+		break;
+
+	case 'f':
+	case 'e':
+	case 'g':
+	case 'a':
+		if( spec == 'a' ) {
+			spec = 'f';
+			s->radix = 16;
+		}
+
+		if( s->lenspec == kAxLS_None ) {
+			double f;
+
+			AXPF__ARG( s, double, f );
+			axpf__write_floatd( s, f, spec );
+		} else if( s->lenspec == kAxLS_l || s->lenspec == kAxLS_L ) {
+			long double f;
+
+			AXPF__ARG( s, long double, f );
+			axpf__write_floatd( s, ( double )f, spec );
+		}
+		break;
+
+	case 'c':
+	case 'C':
+		if( s->lenspec == kAxLS_None && spec != 'C' ) {
+			int ch;
+
+			AXPF__ARG( s, int, ch );
+			axpf__write_char( s, ch );
+		} else if( s->lenspec == kAxLS_l || spec == 'C' ) {
+			int/*wint_t*/ ch;
+
+			AXPF__ARG( s, int, ch );
+			axpf__write_wchar( s, ch );
+		}
+		break;
+
+	case 's':
 	case 'S':
 		if( s->lenspec == kAxLS_None && spec != 'S' ) {
-			axpf__write_str( s, va_arg( s->args, const char * ) );
+			axpf__write_str( s, axpf__arg_str( s, 1 ) );
 		} else if( s->lenspec == kAxLS_l || spec == 'S' ) {
-			axpf__write_wstr( s, va_arg( s->args, const wchar_t * ) );
+			axpf__write_wstr( s, axpf__arg_wstr( s ) );
+		}
+		break;
+
+	case 'p':
+		s->radix = 16;
+		s->flags |= kAxPF_Radix | kAxPF_Pointer | kAxPF_Precision;
+		s->precision = sizeof( void * )*2;
+		{
+			axpf_size_t ptr;
+
+			AXPF__ARG( s, axpf_size_t, ptr );
+			axpf__write_uint( s, ptr );
+		}
+		break;
+
+	case 'n':
+		if( !( ptrcount = axpf__arg_count_ptr( s ) ) ) {
+			break;
+		}
+
+		switch( s->lenspec ) {
+#define P_(Ty_) *( Ty_ * )ptrcount = ( Ty_ )axpf__count( s ); break
+		case kAxLS_None: P_( int );
+		case kAxLS_hh:   P_( signed char );
+		case kAxLS_h:    P_( short int );
+		case kAxLS_l:    /*fallthrough*/
+		case kAxLS_L:    P_( long int );
+#ifdef _MSC_VER
+		case kAxLS_ll:   P_( __int64 );
+#else
+		case kAxLS_ll:   P_( long long int );
+#endif
+		case kAxLS_j:    P_( axpf_smax_t );
+		case kAxLS_z:    P_( axpf_size_t );
+		case kAxLS_I:    /*fallthrough*/
+		case kAxLS_t:    P_( axpf_ptrdiff_t );
+		case kAxLS_I32:  P_( axpf_s32_t );
+		case kAxLS_I64:  P_( axpf_s64_t );
+#undef P_
+		}
+		break;
+
+	case 'm':
+		axpf__write_syserr( s, s->width != 0 ? s->width : axpf__arg_errno( s ) );
+		break;
+
+	case 'b':
+		{
+			int bits;
+			const char *names;
+
+			AXPF__ARG( s, int, bits );
+			names = axpf__arg_str( s, 0 );
+
+			axpf__write_bitfield( s, bits, names );
+		}
+		break;
+	case 'D':
+		{
+			const unsigned char *data;
+			const char *delm;
+
+			data = ( const unsigned char * )axpf__arg_block( s, spec,
+				( s->flags & kAxPF_Width ) && s->width > 0 ? ( axpf_size_t )s->width : 16 );
+			delm = axpf__arg_str( s, 0 );
+
+			axpf__write_hex_dump( s, data, delm );
+		}
+		break;
+	}
+
+	return !s->diderror;
+}
+static int axpf__step( struct axpf__state_ *s )
+{
+	struct axpf__insn_ d;
+
+	if( !axpf__find( s, '%', 1 ) ) {
+		axpf__write( s, s->p, s->e );
+		return 0;
+	}
+
+	axpf__skip( s );
+
+	if( axpf__check( s, '%' ) ) {
+		axpf__writech( s, '%' );
+		return 1;
+	}
+
+	axpf__parse( s, &d );
+	axpf__apply( s, &d );
+
+	return axpf__emit( s, d.spec );
+}
+
+static void axpf__begin( struct axpf__state_ *s )
+{
+	s->num_written = 0;
+	s->diderror = 0;
+	s->flags = 0;
+	axpf__window( s );
+}
+static axpf_ptrdiff_t axpf__end( struct axpf__state_ *s )
+{
+	( void )axpf__flush( s, 0, 1 );
+	if( !s->pfn_write ) {
+		axpf_buffer_t *b;
+
+		b = ( axpf_buffer_t * )s->write_data;
+		if( b->p != ( char * )0 && b->n > 0 ) {
+			b->p[ b->i < b->n ? b->i : b->n - 1 ] = '\0';
+		}
+	}
+
+	if( s->diderror ) {
+		return -1;
+	}
+
+	return ( axpf_ptrdiff_t )s->num_written;
+}
+
+static axpf_ptrdiff_t axpf__run( struct axpf__state_ *s, const char *fmt, const char *fmte )
+{
+	s->s = fmt;
+	s->p = fmt;
+	s->e = !fmte ? strchr( fmt, '\0' ) : fmte;
+
+	axpf__begin( s );
+
+	while( axpf__step( s ) ) {
+	}
+
+	return axpf__end( s );
+}
+/* pack the argument of a directive that reads one plain value; 0 if it has to go through axpf__emit */
+static int axpf__pack_scalar( struct axpf__state_ *s, const struct axpf__insn_ *d )
+{
+	if( d->stars != 0 || ( d->flags & kAxPF_Array ) ) {
+		return 0;
+	}
+
+	s->flags = d->flags;
+	s->precision = d->precision;
+	s->lenspec = ( axpf__lengthSpecifier_t )d->lenspec;
+
+	switch( d->spec ) {
+	case 'd':
+	case 'i':
+		( void )axpf__arg_int( s );
+		return 1;
+
+	case 'u':
+	case 'o':
+	case 'x':
+		( void )axpf__arg_uint( s );
+		return 1;
+
+	case 'f':
+	case 'e':
+	case 'g':
+	case 'a':
+		if( s->lenspec == kAxLS_None ) {
+			double f;
+
+			AXPF__ARG( s, double, f );
+			return 1;
+		} else if( s->lenspec == kAxLS_l || s->lenspec == kAxLS_L ) {
+			long double f;
+
+			AXPF__ARG( s, long double, f );
+			return 1;
+		}
+		break;
+
+	case 'c':
+		if( s->lenspec == kAxLS_None ) {
+			int ch;
+
+			AXPF__ARG( s, int, ch );
+			return 1;
+		}
+		break;
+
+	case 's':
+		if( s->lenspec == kAxLS_None ) {
+			( void )axpf__arg_str( s, 1 );
+			return 1;
 		}
 		break;
 
-	case 'p':
-		s->radix = 16;
-		s->flags |= kAxPF_Radix | kAxPF_Pointer | kAxPF_Precision;
-		s->precision = sizeof( void * )*2;
-		axpf__write_uint( s, va_arg( s->args, axpf_size_t ) );
-		break;
+	case 'p':
+		{
+			axpf_size_t ptr;
+
+			AXPF__ARG( s, axpf_size_t, ptr );
+		}
+		return 1;
+	}
+
+	return 0;
+}
+/* as axpf__run, but for a compiled format (see axpf_compile) */
+static axpf_ptrdiff_t axpf__exec( struct axpf__state_ *s, const axpf_format_t *f )
+{
+	const struct axpf__insn_ *d, *e;
+	const char *p;
+
+	s->s = f->pText;
+	s->p = f->pText;
+	s->e = f->pText;
+
+	axpf__begin( s );
+
+	d = f->pInsns;
+	e = d + f->cInsns;
+	for( ; d != e; ++d ) {
+		if( d->litlen != 0 ) {
+			axpf__write( s, f->pText + d->lit, f->pText + d->lit + d->litlen );
+		}
+
+		if( d->kind == kAxPFK_Literal ) {
+			continue;
+		}
+
+		if( d->kind == kAxPFK_Str && s->argmode == kAxPM_None ) {
+			p = va_arg( s->args, const char * );
+			s->flags = 0;
+			if( p != ( const char * )0 ) {
+				axpf__write( s, p, strchr( p, '\0' ) );
+			} else {
+				s->repeats = 1;
+				axpf__write_str( s, p );
+			}
+		} else if( d->kind == kAxPFK_Int && s->argmode == kAxPM_None ) {
+			s->repeats = 1;
+			s->flags = 0;
+			s->radix = 10;
+			axpf__write_int( s, ( axpf_smax_t )va_arg( s->args, int ) );
+		} else if( s->argmode == kAxPM_Pack && axpf__pack_scalar( s, d ) ) {
+			/* nothing is written when packing, so there's no need to go through axpf__emit */
+		} else {
+			axpf__apply( s, d );
+			axpf__emit( s, d->spec );
+		}
+
+		if( s->diderror ) {
+			break;
+		}
+	}
+
+	return axpf__end( s );
+}
+
+static int AXPF_CALL axpf__grow_dup_f( axpf_buffer_t *b, axpf_size_t cMin )
+{
+	axpf_size_t capacity;
+	char *p;
+
+	capacity = b->i + cMin + 1;
+	if( capacity < b->n*2 ) {
+		capacity = b->n*2;
+	}
+	if( capacity < 64 ) {
+		capacity = 64;
+	}
+
+	p = ( char * )( !b->p ? axpf_alloc( capacity ) : axpf_realloc( ( void * )b->p, capacity ) );
+	if( !p ) {
+		return 0;
+	}
+
+	b->p = p;
+	b->n = capacity;
+
+	return 1;
+}
+
+# if defined( va_copy )
+#  define axpf__va_copy va_copy
+# elif defined( __va_copy )
+#  define axpf__va_copy __va_copy
+# elif defined(__has_builtin) && __has_builtin(__builtin_va_copy)
+#  define axpf__va_copy __builtin_va_copy
+# else
+#  error ax_printf: `va_copy` not defined.
+# endif
+
+#endif /* AXPF_IMPLEMENT */
+
+#if AXPF_IMPLEMENT
+/* point FILE output to the console directly where that's needed */
+static void axpf__sink( struct axpf__state_ *s )
+{
+# if AXPF__WINCON
+	if( s->pfn_write == &axpf__write_fp_f ) {
+		HANDLE h;
+		DWORD dwMode;
+
+		h = INVALID_HANDLE_VALUE;
+		if( s->write_data == ( void * )stdout ) {
+			h = GetStdHandle( STD_OUTPUT_HANDLE );
+		} else if( s->write_data == ( void * )stderr ) {
+			h = GetStdHandle( STD_ERROR_HANDLE );
+		}
+
+		if( h != INVALID_HANDLE_VALUE && GetConsoleMode( h, &dwMode ) ) {
+			s->pfn_write  = &axpf__write_con_f;
+			s->write_data = ( void * )h;
+		}
+	}
+# else
+	( void )s;
+# endif
+}
+#endif
+
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpf__main
+(
+	struct axpf__state_ *s,
+	const char *fmt,
+	const char *fmte,
+	va_list args
+)
+#if AXPF_IMPLEMENT
+{
+	axpf__sink( s );
+
+	s->argmode = kAxPM_None;
+	axpf__va_copy( s->args, args );
+
+	return axpf__run( s, fmt, fmte );
+}
+#else
+;
+#endif
+/* as axpf__main, for a compiled format */
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpf__mainc
+(
+	struct axpf__state_ *s,
+	const axpf_format_t *f,
+	va_list args
+)
+#if AXPF_IMPLEMENT
+{
+	axpf__sink( s );
+
+	s->argmode = kAxPM_None;
+	axpf__va_copy( s->args, args );
+
+	return axpf__exec( s, f );
+}
+#else
+;
+#endif
+
+#if AXPF_STDFILE_ENABLED
+
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axfpfev
+(
+	FILE *fp,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	va_list args
+)
+AXPF_FUNC_ANNO(2,4)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )fp;
+
+	return axpf__main( &s, fmt, fmte, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axfpfv
+(
+	FILE *fp,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	va_list args
+)
+AXPF_FUNC_ANNO(2,3)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )fp;
+
+	return axpf__main( &s, fmt, ( const char * )0, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axfpfe
+(
+	FILE *fp,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	...
+)
+AXPF_FUNC_ANNO(2,4)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+	axpf_ptrdiff_t r;
+	va_list args;
+
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )fp;
 
-	case 'n':
-		switch( s->lenspec ) {
-#define P_(Ty_) *va_arg( s->args, Ty_ * ) = ( Ty_ )s->num_written; break
-		case kAxLS_None: P_( int );
-		case kAxLS_hh:   P_( signed char );
-		case kAxLS_h:    P_( short int );
-		case kAxLS_l:    /*fallthrough*/
-		case kAxLS_L:    P_( long int );
-#ifdef _MSC_VER
-		case kAxLS_ll:   P_( __int64 );
+	va_start( args, fmte );
+	r = axpf__main( &s, fmt, fmte, args );
+	va_end( args );
+
+	return r;
+}
 #else
-		case kAxLS_ll:   P_( long long int );
+;
 #endif
-		case kAxLS_j:    P_( axpf_smax_t );
-		case kAxLS_z:    P_( axpf_size_t );
-		case kAxLS_I:    /*fallthrough*/
-		case kAxLS_t:    P_( axpf_ptrdiff_t );
-		case kAxLS_I32:  P_( axpf_s32_t );
-		case kAxLS_I64:  P_( axpf_s64_t );
-#undef P_
-		}
-		break;
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axfpf
+(
+	FILE *fp,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	...
+)
+AXPF_FUNC_ANNO(2,3)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+	axpf_ptrdiff_t r;
+	va_list args;
 
-	case 'm':
-		axpf__write_syserr( s, s->width != 0 ? s->width : ( int )errno );
-		break;
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )fp;
 
-	case 'b':
-		{
-			int bits;
-			const char *names;
+	va_start( args, fmt );
+	r = axpf__main( &s, fmt, ( const char * )0, args );
+	va_end( args );
+
+	return r;
+}
+#else
+;
+#endif
 
-			bits = va_arg( s->args, int );
-			names = va_arg( s->args, const char * );
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axerrfev
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	va_list args
+)
+AXPF_FUNC_ANNO(1,3)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
 
-			axpf__write_bitfield( s, bits, names );
-		}
-		break;
-	case 'D':
-		{
-			const unsigned char *data;
-			const char *delm;
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stderr;
 
-			data = va_arg( s->args, const unsigned char * );
-			delm = va_arg( s->args, const char * );
+	return axpf__main( &s, fmt, fmte, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axerrfv
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	va_list args
+)
+AXPF_FUNC_ANNO(1,2)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
 
-			axpf__write_hex_dump( s, data, delm );
-		}
-		break;
-	}
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stderr;
 
-	return !s->diderror;
+	return axpf__main( &s, fmt, ( const char * )0, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axerrfe
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	...
+)
+AXPF_FUNC_ANNO(1,3)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+	axpf_ptrdiff_t r;
+	va_list args;
+
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stderr;
+
+	va_start( args, fmte );
+	r = axpf__main( &s, fmt, fmte, args );
+	va_end( args );
+
+	return r;
 }
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axerrf
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	...
+)
+AXPF_FUNC_ANNO(1,2)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+	axpf_ptrdiff_t r;
+	va_list args;
 
-#endif /* AXPF_IMPLEMENT */
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stderr;
+
+	va_start( args, fmt );
+	r = axpf__main( &s, fmt, ( const char * )0, args );
+	va_end( args );
+
+	return r;
+}
+#else
+;
+#endif
 
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axpf__main
+AXPF_CALL axpfev
 (
-	struct axpf__state_ *s,
+	AXPF_PARM_ANNO
 	const char *fmt,
 	const char *fmte,
 	va_list args
 )
+AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
-# if AXPF__WINCON
-	if( s->pfn_write == &axpf__write_fp_f ) {
-		HANDLE h;
-		DWORD dwMode;
+	struct axpf__state_ s;
 
-		h = INVALID_HANDLE_VALUE;
-		if( s->write_data == ( void * )stdout ) {
-			h = GetStdHandle( STD_OUTPUT_HANDLE );
-		} else if( s->write_data == ( void * )stderr ) {
-			h = GetStdHandle( STD_ERROR_HANDLE );
-		}
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stdout;
 
-		if( h != INVALID_HANDLE_VALUE && GetConsoleMode( h, &dwMode ) ) {
-			s->pfn_write  = &axpf__write_con_f;
-			s->write_data = ( void * )h;
-		}
-	}
-# endif
-	s->s = fmt;
-	s->p = fmt;
-	s->e = !fmte ? strchr( fmt, '\0' ) : fmte;
+	return axpf__main( &s, fmt, fmte, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpfv
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	va_list args
+)
+AXPF_FUNC_ANNO(1,2)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
 
-	s->num_written = 0;
-# if defined( va_copy )
-#  define axpf__va_copy va_copy
-# elif defined( __va_copy )
-#  define axpf__va_copy __va_copy
-# elif defined(__has_builtin) && __has_builtin(__builtin_va_copy)
-#  define axpf__va_copy __builtin_va_copy
-# else
-#  error ax_printf: `va_copy` not defined.
-# endif
-	axpf__va_copy( s->args, args );
-# undef axpf__va_copy
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stdout;
 
-	s->diderror = 0;
+	return axpf__main( &s, fmt, ( const char * )0, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpfe
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	...
+)
+AXPF_FUNC_ANNO(1,3)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+	axpf_ptrdiff_t r;
+	va_list args;
+
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stdout;
+
+	va_start( args, fmte );
+	r = axpf__main( &s, fmt, fmte, args );
+	va_end( args );
+
+	return r;
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpf
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	...
+)
+AXPF_FUNC_ANNO(1,2)
+#if AXPF_IMPLEMENT
+{
+	struct axpf__state_ s;
+	axpf_ptrdiff_t r;
+	va_list args;
 
-	while( axpf__step( s ) ) {
-	}
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )stdout;
 
-	if( s->diderror ) {
-		return -1;
-	}
+	va_start( args, fmt );
+	r = axpf__main( &s, fmt, ( const char * )0, args );
+	va_end( args );
 
-	return ( axpf_ptrdiff_t )s->num_written;
+	return r;
 }
 #else
 ;
 #endif
 
-#if AXPF_STDFILE_ENABLED
+#endif /*AXPF_STDFILE_ENABLED*/
+
+/*
+	Format into a growable buffer (see axpf_buffer_t), appending at `i`
 
+	Output is written straight into the buffer's storage, without staging.
+	Returns the number of bytes appended, or -1 on error (including
+	`pfnGrow` failing), in which case `i` reflects what was appended before
+	the error.
+*/
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axfpfev
+AXPF_CALL axbpfev
 (
-	FILE *fp,
+	axpf_buffer_t *pBuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	const char *fmte,
@@ -1837,8 +3829,8 @@ AXPF_FUNC_ANNO(2,4)
 {
 	struct axpf__state_ s;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )fp;
+	s.pfn_write = ( axpf_write_fn_t )0;
+	s.write_data = ( void * )pBuf;
 
 	return axpf__main( &s, fmt, fmte, args );
 }
@@ -1846,9 +3838,9 @@ AXPF_FUNC_ANNO(2,4)
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axfpfv
+AXPF_CALL axbpfv
 (
-	FILE *fp,
+	axpf_buffer_t *pBuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	va_list args
@@ -1856,20 +3848,15 @@ AXPF_CALL axfpfv
 AXPF_FUNC_ANNO(2,3)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
-
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )fp;
-
-	return axpf__main( &s, fmt, ( const char * )0, args );
+	return axbpfev( pBuf, fmt, ( const char * )0, args );
 }
 #else
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axfpfe
+AXPF_CALL axbpfe
 (
-	FILE *fp,
+	axpf_buffer_t *pBuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	const char *fmte,
@@ -1878,15 +3865,11 @@ AXPF_CALL axfpfe
 AXPF_FUNC_ANNO(2,4)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
 	axpf_ptrdiff_t r;
 	va_list args;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )fp;
-
 	va_start( args, fmte );
-	r = axpf__main( &s, fmt, fmte, args );
+	r = axbpfev( pBuf, fmt, fmte, args );
 	va_end( args );
 
 	return r;
@@ -1895,9 +3878,9 @@ AXPF_FUNC_ANNO(2,4)
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axfpf
+AXPF_CALL axbpf
 (
-	FILE *fp,
+	axpf_buffer_t *pBuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	...
@@ -1905,15 +3888,11 @@ AXPF_CALL axfpf
 AXPF_FUNC_ANNO(2,3)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
 	axpf_ptrdiff_t r;
 	va_list args;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )fp;
-
 	va_start( args, fmt );
-	r = axpf__main( &s, fmt, ( const char * )0, args );
+	r = axbpfev( pBuf, fmt, ( const char * )0, args );
 	va_end( args );
 
 	return r;
@@ -1923,75 +3902,252 @@ AXPF_FUNC_ANNO(2,3)
 #endif
 
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axerrfev
+AXPF_CALL axspfev
 (
+	char *buf,
+	axpf_size_t nbuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	const char *fmte,
 	va_list args
 )
-AXPF_FUNC_ANNO(1,3)
+AXPF_FUNC_ANNO(3,5)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
+	axpf_buffer_t b;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stderr;
+	b.p = buf;
+	b.i = 0;
+	b.n = buf != ( char * )0 ? nbuf : 0;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
 
-	return axpf__main( &s, fmt, fmte, args );
+	return axbpfev( &b, fmt, fmte, args );
 }
 #else
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axerrfv
+AXPF_CALL axspfv
 (
+	char *buf,
+	axpf_size_t nbuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	va_list args
 )
-AXPF_FUNC_ANNO(1,2)
+AXPF_FUNC_ANNO(3,4)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
+	return axspfev( buf, nbuf, fmt, ( const char * )0, args );
+}
+#else
+;
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axspfe
+(
+	char *buf,
+	axpf_size_t nbuf,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	...
+)
+AXPF_FUNC_ANNO(3,5)
+#if AXPF_IMPLEMENT
+{
+	axpf_ptrdiff_t r;
+	va_list args;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stderr;
+	va_start( args, fmte );
+	r = axspfev( buf, nbuf, fmt, fmte, args );
+	va_end( args );
 
-	return axpf__main( &s, fmt, ( const char * )0, args );
+	return r;
 }
 #else
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axerrfe
+AXPF_CALL axspf
+(
+	char *buf,
+	axpf_size_t nbuf,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	...
+)
+AXPF_FUNC_ANNO(3,4)
+#if AXPF_IMPLEMENT
+{
+	axpf_ptrdiff_t r;
+	va_list args;
+
+	va_start( args, fmt );
+	r = axspfev( buf, nbuf, fmt, ( const char * )0, args );
+	va_end( args );
+
+	return r;
+}
+#else
+;
+#endif
+
+AXPF_FUNC const char *
+AXPF_CALL axffev
+(
+	char *buf,
+	axpf_size_t nbuf,
+	AXPF_PARM_ANNO
+	const char *fmts,
+	const char *fmte,
+	va_list args
+)
+AXPF_FUNC_ANNO(3,5)
+#if AXPF_IMPLEMENT
+{
+	( void )axspfev( buf, nbuf, fmts, fmte, args );
+	return buf;
+}
+#else
+;
+#endif
+AXPF_FUNC const char *
+AXPF_CALL axffe
+(
+	char *buf,
+	axpf_size_t nbuf,
+	AXPF_PARM_ANNO
+	const char *fmts,
+	const char *fmte,
+	...
+)
+AXPF_FUNC_ANNO(3,5)
+#if AXPF_IMPLEMENT
+{
+	va_list args;
+
+	va_start( args, fmte );
+	( void )axspfev( buf, nbuf, fmts, fmte, args );
+	va_end( args );
+
+	return buf;
+}
+#else
+;
+#endif
+AXPF_FUNC const char *
+AXPF_CALL axffv
+(
+	char *buf,
+	axpf_size_t nbuf,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	va_list args
+)
+AXPF_FUNC_ANNO(3,4)
+#if AXPF_IMPLEMENT
+{
+	( void )axspfev( buf, nbuf, fmt, ( const char * )0, args );
+	return buf;
+}
+#else
+;
+#endif
+AXPF_FUNC const char *
+AXPF_CALL axff
+(
+	char *buf,
+	axpf_size_t nbuf,
+	AXPF_PARM_ANNO
+	const char *fmt,
+	...
+)
+AXPF_FUNC_ANNO(3,4)
+#if AXPF_IMPLEMENT
+{
+	va_list args;
+
+	va_start( args, fmt );
+	( void )axspfev( buf, nbuf, fmt, ( const char * )0, args );
+	va_end( args );
+
+	return buf;
+}
+#else
+;
+#endif
+
+AXPF_FUNC char *
+AXPF_CALL axdupfev
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	va_list args
+)
+AXPF_FUNC_ANNO(1,3)
+#if AXPF_IMPLEMENT
+{
+	axpf_buffer_t b;
+
+	b.p = ( char * )0;
+	b.i = 0;
+	b.n = 0;
+	b.pfnGrow = &axpf__grow_dup_f;
+	b.pUser = ( void * )0;
+
+	if( axbpfev( &b, fmt, fmte, args ) < 0 ) {
+		axpf_free( ( void * )b.p );
+		return ( char * )0;
+	}
+
+	return b.p;
+}
+#else
+;
+#endif
+AXPF_FUNC char *
+AXPF_CALL axdupfe
+(
+	AXPF_PARM_ANNO
+	const char *fmt,
+	const char *fmte,
+	...
+)
+AXPF_FUNC_ANNO(1,3)
+#if AXPF_IMPLEMENT
+{
+	va_list args;
+	char *p;
+
+	va_start( args, fmte );
+	p = axdupfev( fmt, fmte, args );
+	va_end( args );
+
+	return p;
+}
+#else
+;
+#endif
+AXPF_FUNC char *
+AXPF_CALL axdupfv
 (
 	AXPF_PARM_ANNO
 	const char *fmt,
-	const char *fmte,
-	...
+	va_list args
 )
-AXPF_FUNC_ANNO(1,3)
+AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
-	axpf_ptrdiff_t r;
-	va_list args;
-
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stderr;
-
-	va_start( args, fmte );
-	r = axpf__main( &s, fmt, fmte, args );
-	va_end( args );
-
-	return r;
+	return axdupfev( fmt, ( const char * )0, args );
 }
 #else
 ;
 #endif
-AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axerrf
+AXPF_FUNC char *
+AXPF_CALL axdupf
 (
 	AXPF_PARM_ANNO
 	const char *fmt,
@@ -2000,25 +4156,21 @@ AXPF_CALL axerrf
 AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
-	axpf_ptrdiff_t r;
 	va_list args;
-
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stderr;
+	char *p;
 
 	va_start( args, fmt );
-	r = axpf__main( &s, fmt, ( const char * )0, args );
+	p = axdupfev( fmt, ( const char * )0, args );
 	va_end( args );
 
-	return r;
+	return p;
 }
 #else
 ;
 #endif
 
-AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axpfev
+AXPF_FUNC const char *
+AXPF_CALL axfev
 (
 	AXPF_PARM_ANNO
 	const char *fmt,
@@ -2028,65 +4180,73 @@ AXPF_CALL axpfev
 AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
+	static axpf_size_t bufi = 0;
+	static char buf[ 0x10000 ];
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stdout;
+	axpf_buffer_t b;
+	axpf_ptrdiff_t r;
 
-	return axpf__main( &s, fmt, fmte, args );
+	b.p = &buf[ bufi ];
+	b.i = 0;
+	b.n = sizeof( buf ) - bufi;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
+
+	r = axbpfev( &b, fmt, fmte, args );
+	if( r < 0 ) {
+		return ( char * )0;
+	}
+
+	bufi += ( axpf_size_t )r;
+	if( bufi + 0x200 >= sizeof( buf ) ) {
+		bufi = 0;
+	}
+
+	return b.p;
 }
 #else
 ;
 #endif
-AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axpfv
+AXPF_FUNC const char *
+AXPF_CALL axfe
 (
 	AXPF_PARM_ANNO
 	const char *fmt,
-	va_list args
+	const char *fmte,
+	...
 )
-AXPF_FUNC_ANNO(1,2)
+AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
+	va_list args;
+	const char *p;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stdout;
+	va_start( args, fmte );
+	p = axfev( fmt, fmte, args );
+	va_end( args );
 
-	return axpf__main( &s, fmt, ( const char * )0, args );
+	return p;
 }
 #else
 ;
 #endif
-AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axpfe
+AXPF_FUNC const char *
+AXPF_CALL axfv
 (
 	AXPF_PARM_ANNO
 	const char *fmt,
-	const char *fmte,
-	...
+	va_list args
 )
-AXPF_FUNC_ANNO(1,3)
+AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
-	axpf_ptrdiff_t r;
-	va_list args;
-
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stdout;
-
-	va_start( args, fmte );
-	r = axpf__main( &s, fmt, fmte, args );
-	va_end( args );
-
-	return r;
+	return axfev( fmt, ( const char * )0, args );
 }
 #else
 ;
 #endif
-AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axpf
+AXPF_FUNC const char *
+AXPF_CALL axf
 (
 	AXPF_PARM_ANNO
 	const char *fmt,
@@ -2095,30 +4255,39 @@ AXPF_CALL axpf
 AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__state_ s;
-	axpf_ptrdiff_t r;
+	const char *p;
 	va_list args;
 
-	s.pfn_write = &axpf__write_fp_f;
-	s.write_data = ( void * )stdout;
-
 	va_start( args, fmt );
-	r = axpf__main( &s, fmt, ( const char * )0, args );
+	p = axfev( fmt, ( const char * )0, args );
 	va_end( args );
 
-	return r;
+	return p;
 }
 #else
 ;
 #endif
 
-#endif /*AXPF_STDFILE_ENABLED*/
-
+/*
+	Packed arguments
+
+	axpackf*() store the arguments a format string consumes into `pDst`
+	instead of formatting them, so that axspkf*() can format them later (or
+	elsewhere) with the same result axspf*() would have had at the time of
+	the call. The strings, arrays, and data the format refers to are copied,
+	so only the format string itself has to outlive the packed arguments. %m
+	uses the errno at the time of packing, and %n is ignored.
+
+	`pDst` should be aligned to `AXPF_PACK_ALIGN`. The size of the packed
+	arguments is returned even when it's larger than `nDst` (in which case
+	`pDst` holds an incomplete copy that must not be used), or -1 on error.
+	Packed arguments are only readable by code built for the same platform.
+*/
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axspfev
+AXPF_CALL axpackfev
 (
-	char *buf,
-	axpf_size_t nbuf,
+	void *pDst,
+	axpf_size_t nDst,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	const char *fmte,
@@ -2127,32 +4296,40 @@ AXPF_CALL axspfev
 AXPF_FUNC_ANNO(3,5)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__write_mem_data_ m;
+	axpf_buffer_t b;
 	struct axpf__state_ s;
 	axpf_ptrdiff_t r;
 
-	m.p = buf;
-	m.i = 0;
-	m.n = nbuf;
+	b.p = ( char * )0;
+	b.i = 0;
+	b.n = 0;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
 
-	s.pfn_write = &axpf__write_mem_f;
-	s.write_data = ( void * )&m;
+	s.pfn_write = ( axpf_write_fn_t )0;
+	s.write_data = ( void * )&b;
 
-	r = axpf__main( &s, fmt, fmte, args );
-	if( m.n > 0 ) {
-		m.p[ m.i < m.n ? m.i : m.n - 1 ] = '\0';
+	s.argmode = kAxPM_Pack;
+	s.pkbase = ( unsigned char * )pDst;
+	s.pkpos = 0;
+	s.pksize = pDst != ( void * )0 ? nDst : 0;
+	axpf__va_copy( s.args, args );
+
+	r = axpf__run( &s, fmt, fmte );
+	if( r < 0 ) {
+		return r;
 	}
 
-	return r;
+	return ( axpf_ptrdiff_t )s.pkpos;
 }
 #else
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axspfv
+AXPF_CALL axpackfv
 (
-	char *buf,
-	axpf_size_t nbuf,
+	void *pDst,
+	axpf_size_t nDst,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	va_list args
@@ -2160,16 +4337,16 @@ AXPF_CALL axspfv
 AXPF_FUNC_ANNO(3,4)
 #if AXPF_IMPLEMENT
 {
-	return axspfev( buf, nbuf, fmt, ( const char * )0, args );
+	return axpackfev( pDst, nDst, fmt, ( const char * )0, args );
 }
 #else
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axspfe
+AXPF_CALL axpackfe
 (
-	char *buf,
-	axpf_size_t nbuf,
+	void *pDst,
+	axpf_size_t nDst,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	const char *fmte,
@@ -2182,7 +4359,7 @@ AXPF_FUNC_ANNO(3,5)
 	va_list args;
 
 	va_start( args, fmte );
-	r = axspfev( buf, nbuf, fmt, fmte, args );
+	r = axpackfev( pDst, nDst, fmt, fmte, args );
 	va_end( args );
 
 	return r;
@@ -2191,10 +4368,10 @@ AXPF_FUNC_ANNO(3,5)
 ;
 #endif
 AXPF_FUNC axpf_ptrdiff_t
-AXPF_CALL axspf
+AXPF_CALL axpackf
 (
-	char *buf,
-	axpf_size_t nbuf,
+	void *pDst,
+	axpf_size_t nDst,
 	AXPF_PARM_ANNO
 	const char *fmt,
 	...
@@ -2206,7 +4383,7 @@ AXPF_FUNC_ANNO(3,4)
 	va_list args;
 
 	va_start( args, fmt );
-	r = axspfev( buf, nbuf, fmt, ( const char * )0, args );
+	r = axpackfev( pDst, nDst, fmt, ( const char * )0, args );
 	va_end( args );
 
 	return r;
@@ -2215,285 +4392,450 @@ AXPF_FUNC_ANNO(3,4)
 ;
 #endif
 
-AXPF_FUNC const char *
-AXPF_CALL axffev
+/*
+	Format packed arguments (from axpackf) into `buf`, as axspf would have
+
+	`fmt` and `fmte` must be the same format string the arguments were
+	packed with. Returns -1 if the packed arguments run out early.
+*/
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axspkfe
 (
 	char *buf,
 	axpf_size_t nbuf,
-	AXPF_PARM_ANNO
-	const char *fmts,
+	const char *fmt,
 	const char *fmte,
-	va_list args
+	const void *pArgs,
+	axpf_size_t cArgs
 )
-AXPF_FUNC_ANNO(3,5)
 #if AXPF_IMPLEMENT
 {
-	( void )axspfev( buf, nbuf, fmts, fmte, args );
-	return buf;
+	axpf_buffer_t b;
+	struct axpf__state_ s;
+
+	b.p = buf;
+	b.i = 0;
+	b.n = buf != ( char * )0 ? nbuf : 0;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
+
+	s.pfn_write = ( axpf_write_fn_t )0;
+	s.write_data = ( void * )&b;
+
+	s.argmode = kAxPM_Unpack;
+	s.pkbase = ( unsigned char * )pArgs;
+	s.pkpos = 0;
+	s.pksize = pArgs != ( const void * )0 ? cArgs : 0;
+
+	return axpf__run( &s, fmt, fmte );
 }
 #else
 ;
 #endif
-AXPF_FUNC const char *
-AXPF_CALL axffe
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axspkf
 (
 	char *buf,
 	axpf_size_t nbuf,
-	AXPF_PARM_ANNO
-	const char *fmts,
-	const char *fmte,
-	...
+	const char *fmt,
+	const void *pArgs,
+	axpf_size_t cArgs
 )
-AXPF_FUNC_ANNO(3,5)
 #if AXPF_IMPLEMENT
 {
-	va_list args;
-
-	va_start( args, fmte );
-	( void )axspfev( buf, nbuf, fmts, fmte, args );
-	va_end( args );
-
-	return buf;
+	return axspkfe( buf, nbuf, fmt, ( const char * )0, pArgs, cArgs );
 }
 #else
 ;
 #endif
-AXPF_FUNC const char *
-AXPF_CALL axffv
+
+/*
+	Compiled formats
+
+	axpf_compile*() parse a format string once into an axpf_format_t, which
+	the *cf*() functions below then format with, skipping the parse. The
+	output is the same as the equivalent axspf*() call. Compiled formats are
+	read-only, so one can be shared between threads.
+
+	axpf_compile_to() builds the format in `pDst`, which should be aligned
+	like a pointer, and copies the format string into it, so the string
+	needn't outlive the result. It returns the number of bytes needed, even
+	when that's larger than `nDst` (in which case nothing is written), or
+	-1 if the format string is too long. axpf_compile() does the same into
+	memory from axpf_alloc, to be released with axpf_free_format().
+
+	In C++14, AXPF_FORMAT( "..." ) compiles a string literal at compile time
+	instead, and checks the arguments passed with it (see below).
+
+	axpackcf*() and axspkcf() pack and format arguments like axpackf*() and
+	axspkf() (see Packed arguments). The packed form is the same either way,
+	so arguments packed with a compiled format can be formatted with its
+	source string, and the other way around.
+*/
+#if AXPF_IMPLEMENT
+/* parse [fmt, fmte) into up to `cDst` instructions; returns how many it has */
+static axpf_size_t axpf__compile( struct axpf__insn_ *pDst, axpf_size_t cDst, const char *fmt, const char *fmte )
+{
+	struct axpf__state_ s;
+	struct axpf__insn_ d;
+	const char *lit, *q;
+	axpf_size_t n;
+
+	s.s = fmt;
+	s.p = fmt;
+	s.e = fmte;
+
+	n = 0;
+	lit = fmt;
+	while( s.p < s.e ) {
+		q = ( const char * )memchr( ( const void * )s.p, '%', ( axpf_size_t )( s.e - s.p ) );
+		if( !q ) {
+			break;
+		}
+
+		s.p = q + 1;
+		memset( ( void * )&d, 0, sizeof( d ) );
+
+		if( axpf__check( &s, '%' ) ) {
+			/* "%%" just ends the literal run after its first '%' */
+			d.kind = kAxPFK_Literal;
+			++q;
+		} else {
+			axpf__parse( &s, &d );
+		}
+
+		d.lit = ( axpf_u32_t )( lit - fmt );
+		d.litlen = ( axpf_u32_t )( q - lit );
+		if( n < cDst ) {
+			pDst[ n ] = d;
+		}
+		++n;
+
+		lit = s.p;
+	}
+
+	if( lit < s.e ) {
+		memset( ( void * )&d, 0, sizeof( d ) );
+		d.kind = kAxPFK_Literal;
+		d.lit = ( axpf_u32_t )( lit - fmt );
+		d.litlen = ( axpf_u32_t )( s.e - lit );
+		if( n < cDst ) {
+			pDst[ n ] = d;
+		}
+		++n;
+	}
+
+	return n;
+}
+#endif
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpf_compile_to
 (
-	char *buf,
-	axpf_size_t nbuf,
+	void *pDst,
+	axpf_size_t nDst,
 	AXPF_PARM_ANNO
 	const char *fmt,
-	va_list args
+	const char *fmte
 )
-AXPF_FUNC_ANNO(3,4)
 #if AXPF_IMPLEMENT
 {
-	( void )axspfev( buf, nbuf, fmt, ( const char * )0, args );
-	return buf;
+	axpf_format_t *f;
+	struct axpf__insn_ *pInsns;
+	axpf_size_t cInsns, cText, n;
+
+	if( !fmte ) {
+		fmte = strchr( fmt, '\0' );
+	}
+
+	cText = ( axpf_size_t )( fmte - fmt );
+	if( cText != ( axpf_size_t )( axpf_u32_t )cText ) {
+		return -1;
+	}
+
+	cInsns = axpf__compile( ( struct axpf__insn_ * )0, 0, fmt, fmte );
+	n = sizeof( axpf_format_t ) + cInsns*sizeof( struct axpf__insn_ ) + cText + 1;
+	if( !pDst || nDst < n ) {
+		return ( axpf_ptrdiff_t )n;
+	}
+
+	f = ( axpf_format_t * )pDst;
+	pInsns = ( struct axpf__insn_ * )( f + 1 );
+
+	( void )axpf__compile( pInsns, cInsns, fmt, fmte );
+	memcpy( ( void * )( pInsns + cInsns ), ( const void * )fmt, cText );
+	( ( char * )( pInsns + cInsns ) )[ cText ] = '\0';
+
+	f->pInsns = pInsns;
+	f->cInsns = cInsns;
+	f->pText = ( const char * )( pInsns + cInsns );
+
+	return ( axpf_ptrdiff_t )n;
 }
 #else
 ;
 #endif
-AXPF_FUNC const char *
-AXPF_CALL axff
+AXPF_FUNC axpf_format_t *
+AXPF_CALL axpf_compile
 (
-	char *buf,
-	axpf_size_t nbuf,
 	AXPF_PARM_ANNO
 	const char *fmt,
-	...
+	const char *fmte
 )
-AXPF_FUNC_ANNO(3,4)
 #if AXPF_IMPLEMENT
 {
-	va_list args;
+	axpf_ptrdiff_t n;
+	void *p;
 
-	va_start( args, fmt );
-	( void )axspfev( buf, nbuf, fmt, ( const char * )0, args );
-	va_end( args );
+	if( ( n = axpf_compile_to( ( void * )0, 0, fmt, fmte ) ) < 0 ) {
+		return ( axpf_format_t * )0;
+	}
 
-	return buf;
+	if( !( p = axpf_alloc( ( axpf_size_t )n ) ) ) {
+		return ( axpf_format_t * )0;
+	}
+
+	( void )axpf_compile_to( p, ( axpf_size_t )n, fmt, fmte );
+	return ( axpf_format_t * )p;
+}
+#else
+;
+#endif
+AXPF_FUNC void
+AXPF_CALL axpf_free_format
+(
+	axpf_format_t *f
+)
+#if AXPF_IMPLEMENT
+{
+	axpf_free( ( void * )f );
 }
 #else
 ;
 #endif
 
-AXPF_FUNC char *
-AXPF_CALL axdupfev
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axbpcfv
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
-	const char *fmte,
+	axpf_buffer_t *pBuf,
+	const axpf_format_t *f,
 	va_list args
 )
-AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
-	struct axpf__write_mem_data_ m;
 	struct axpf__state_ s;
-	axpf_ptrdiff_t r;
-
-	m.p = ( char * )0;
-	m.i = 0;
-	m.n = 0;
 
-	s.pfn_write = &axpf__write_memdup_f;
-	s.write_data = ( void * )&m;
-
-	r = axpf__main( &s, fmt, fmte, args );
-	if( r < 0 ) {
-		axpf_free( ( void * )m.p );
-		return ( char * )0;
-	}
+	s.pfn_write = ( axpf_write_fn_t )0;
+	s.write_data = ( void * )pBuf;
 
-	return m.p;
+	return axpf__mainc( &s, f, args );
 }
 #else
 ;
 #endif
-AXPF_FUNC char *
-AXPF_CALL axdupfe
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axbpcf
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
-	const char *fmte,
+	axpf_buffer_t *pBuf,
+	const axpf_format_t *f,
 	...
 )
-AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
+	axpf_ptrdiff_t r;
 	va_list args;
-	char *p;
 
-	va_start( args, fmte );
-	p = axdupfev( fmt, fmte, args );
+	va_start( args, f );
+	r = axbpcfv( pBuf, f, args );
 	va_end( args );
 
-	return p;
+	return r;
 }
 #else
 ;
 #endif
-AXPF_FUNC char *
-AXPF_CALL axdupfv
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axspcfv
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
+	char *buf,
+	axpf_size_t nbuf,
+	const axpf_format_t *f,
 	va_list args
 )
-AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	return axdupfev( fmt, ( const char * )0, args );
+	axpf_buffer_t b;
+
+	b.p = buf;
+	b.i = 0;
+	b.n = buf != ( char * )0 ? nbuf : 0;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
+
+	return axbpcfv( &b, f, args );
 }
 #else
 ;
 #endif
-AXPF_FUNC char *
-AXPF_CALL axdupf
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axspcf
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
+	char *buf,
+	axpf_size_t nbuf,
+	const axpf_format_t *f,
 	...
 )
-AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
+	axpf_ptrdiff_t r;
 	va_list args;
-	char *p;
 
-	va_start( args, fmt );
-	p = axdupfev( fmt, ( const char * )0, args );
+	va_start( args, f );
+	r = axspcfv( buf, nbuf, f, args );
 	va_end( args );
 
-	return p;
+	return r;
 }
 #else
 ;
 #endif
-
-AXPF_FUNC const char *
-AXPF_CALL axfev
+/* as axpackfv (see Packed arguments), for a compiled format */
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpackcfv
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
-	const char *fmte,
+	void *pDst,
+	axpf_size_t nDst,
+	const axpf_format_t *f,
 	va_list args
 )
-AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
-	static axpf_size_t bufi = 0;
-	static char buf[ 0x10000 ];
-
-	struct axpf__write_mem_data_ m;
+	axpf_buffer_t b;
 	struct axpf__state_ s;
 	axpf_ptrdiff_t r;
 
-	m.p = &buf[ bufi ];
-	m.i = 0;
-	m.n = sizeof( buf ) - bufi;
+	b.p = ( char * )0;
+	b.i = 0;
+	b.n = 0;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
 
-	s.pfn_write = &axpf__write_mem_f;
-	s.write_data = ( void * )&m;
+	s.pfn_write = ( axpf_write_fn_t )0;
+	s.write_data = ( void * )&b;
 
-	r = axpf__main( &s, fmt, fmte, args );
-	if( r < 0 ) {
-		return ( char * )0;
-	}
+	s.argmode = kAxPM_Pack;
+	s.pkbase = ( unsigned char * )pDst;
+	s.pkpos = 0;
+	s.pksize = pDst != ( void * )0 ? nDst : 0;
+	axpf__va_copy( s.args, args );
 
-	bufi += ( axpf_size_t )r;
-	if( bufi + 0x200 >= sizeof( buf ) ) {
-		bufi = 0;
+	r = axpf__exec( &s, f );
+	if( r < 0 ) {
+		return r;
 	}
 
-	return m.p;
+	return ( axpf_ptrdiff_t )s.pkpos;
 }
 #else
 ;
 #endif
-AXPF_FUNC const char *
-AXPF_CALL axfe
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axpackcf
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
-	const char *fmte,
+	void *pDst,
+	axpf_size_t nDst,
+	const axpf_format_t *f,
 	...
 )
-AXPF_FUNC_ANNO(1,3)
 #if AXPF_IMPLEMENT
 {
+	axpf_ptrdiff_t r;
 	va_list args;
-	const char *p;
 
-	va_start( args, fmte );
-	p = axfev( fmt, fmte, args );
+	va_start( args, f );
+	r = axpackcfv( pDst, nDst, f, args );
 	va_end( args );
 
-	return p;
+	return r;
 }
 #else
 ;
 #endif
-AXPF_FUNC const char *
-AXPF_CALL axfv
+/* as axspkf, for a compiled format */
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axspkcf
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
+	char *buf,
+	axpf_size_t nbuf,
+	const axpf_format_t *f,
+	const void *pArgs,
+	axpf_size_t cArgs
+)
+#if AXPF_IMPLEMENT
+{
+	axpf_buffer_t b;
+	struct axpf__state_ s;
+
+	b.p = buf;
+	b.i = 0;
+	b.n = buf != ( char * )0 ? nbuf : 0;
+	b.pfnGrow = ( axpf_grow_fn_t )0;
+	b.pUser = ( void * )0;
+
+	s.pfn_write = ( axpf_write_fn_t )0;
+	s.write_data = ( void * )&b;
+
+	s.argmode = kAxPM_Unpack;
+	s.pkbase = ( unsigned char * )pArgs;
+	s.pkpos = 0;
+	s.pksize = pArgs != ( const void * )0 ? cArgs : 0;
+
+	return axpf__exec( &s, f );
+}
+#else
+;
+#endif
+#if AXPF_STDFILE_ENABLED
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axfpcfv
+(
+	FILE *fp,
+	const axpf_format_t *f,
 	va_list args
 )
-AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	return axfev( fmt, ( const char * )0, args );
+	struct axpf__state_ s;
+
+	s.pfn_write = &axpf__write_fp_f;
+	s.write_data = ( void * )fp;
+
+	return axpf__mainc( &s, f, args );
 }
 #else
 ;
 #endif
-AXPF_FUNC const char *
-AXPF_CALL axf
+AXPF_FUNC axpf_ptrdiff_t
+AXPF_CALL axfpcf
 (
-	AXPF_PARM_ANNO
-	const char *fmt,
+	FILE *fp,
+	const axpf_format_t *f,
 	...
 )
-AXPF_FUNC_ANNO(1,2)
 #if AXPF_IMPLEMENT
 {
-	const char *p;
+	axpf_ptrdiff_t r;
 	va_list args;
 
-	va_start( args, fmt );
-	p = axfev( fmt, ( const char * )0, args );
+	va_start( args, f );
+	r = axfpcfv( fp, f, args );
 	va_end( args );
 
-	return p;
+	return r;
 }
 #else
 ;
 #endif
+#endif /*AXPF_STDFILE_ENABLED*/
 
 #ifdef __cplusplus
 }
@@ -2573,6 +4915,459 @@ inline const char *axff( char( &buf )[ tMaxBuf ], AXPF_PARM_ANNO const char *fmt
 
 	return buf;
 }
+template< axpf_size_t tMaxBuf >
+inline axpf_ptrdiff_t axspkfe( char( &buf )[ tMaxBuf ], const char *fmt, const char *fmte,
+const void *pArgs, axpf_size_t cArgs )
+{
+	return axspkfe( buf, tMaxBuf, fmt, fmte, pArgs, cArgs );
+}
+template< axpf_size_t tMaxBuf >
+inline axpf_ptrdiff_t axspkf( char( &buf )[ tMaxBuf ], const char *fmt, const void *pArgs,
+axpf_size_t cArgs )
+{
+	return axspkfe( buf, tMaxBuf, fmt, ( const char * )0, pArgs, cArgs );
+}
+#endif /*AXPF_CXX_OVERLOADS_ENABLED*/
+
+#if AXPF_CXX_OVERLOADS_ENABLED
+template< axpf_size_t tMaxBuf >
+inline axpf_ptrdiff_t axspcfv( char( &buf )[ tMaxBuf ], const axpf_format_t *f, va_list args )
+{
+	return axspcfv( buf, tMaxBuf, f, args );
+}
+template< axpf_size_t tMaxBuf >
+inline axpf_ptrdiff_t axspcf( char( &buf )[ tMaxBuf ], const axpf_format_t *f, ... )
+{
+	axpf_ptrdiff_t r;
+	va_list args;
+
+	va_start( args, f );
+	r = axspcfv( buf, tMaxBuf, f, args );
+	va_end( args );
+
+	return r;
+}
+template< axpf_size_t tMaxBuf >
+inline axpf_ptrdiff_t axspkcf( char( &buf )[ tMaxBuf ], const axpf_format_t *f, const void *pArgs,
+axpf_size_t cArgs )
+{
+	return axspkcf( buf, tMaxBuf, f, pArgs, cArgs );
+}
 #endif /*AXPF_CXX_OVERLOADS_ENABLED*/
 
+#if AXPF_CXX_CONSTEXPR_ENABLED
+/*
+	Compile-time formats
+
+	AXPF_FORMAT( "..." ) parses a string literal as the program is compiled,
+	giving an object the overloads of axspcf(), axbpcf() and axfpcf() below
+	accept. A malformed directive or an unknown conversion fails the build,
+	as does passing the wrong number of arguments, or passing an integer,
+	floating point value or pointer where the format expects another of
+	those. (Only the parse is checked for "%[N]r", which reads a radix per
+	element.)
+*/
+namespace ax { namespace detail {
+
+	// not constexpr, so reaching this while compiling a format is an error
+	inline void pfBadFormat() {}
+
+	struct SPfCounts
+	{
+		axpf_size_t cInsns;
+		axpf_size_t cArgs;
+		bool        bChecked;
+	};
+
+	// class of an argument as passed: 'i'nteger, 'f'loating point, 'p'ointer
+	template< typename T > struct TPfArgClass                         { static constexpr char value = 'i'; };
+	template< typename T > struct TPfArgClass< T * >                  { static constexpr char value = 'p'; };
+	template<>             struct TPfArgClass< float >                { static constexpr char value = 'f'; };
+	template<>             struct TPfArgClass< double >               { static constexpr char value = 'f'; };
+	template<>             struct TPfArgClass< long double >          { static constexpr char value = 'f'; };
+	template<>             struct TPfArgClass< decltype( nullptr ) >  { static constexpr char value = 'p'; };
+
+	constexpr char pfRead( const char *f, axpf_size_t &i )
+	{
+		return f[ i ] != '\0' ? f[ i++ ] : '\0';
+	}
+	constexpr bool pfCheck( const char *f, axpf_size_t &i, char ch )
+	{
+		if( f[ i ] != ch ) {
+			return false;
+		}
+
+		++i;
+		return true;
+	}
+	constexpr bool pfIsDigit( char ch )
+	{
+		return ch >= '0' && ch <= '9';
+	}
+	constexpr unsigned pfUint( const char *f, axpf_size_t &i )
+	{
+		unsigned r = 0;
+
+		while( pfIsDigit( f[ i ] ) ) {
+			if( r < ( 1U<<( sizeof( int )*8 - 2 ) ) ) {
+				r = r*10 + unsigned( f[ i ] - '0' );
+			}
+			++i;
+		}
+
+		return r;
+	}
+	constexpr void pfArg( SPfCounts &r, char *pArgs, char cls )
+	{
+		if( pArgs != nullptr ) {
+			pArgs[ r.cArgs ] = cls;
+		}
+		++r.cArgs;
+	}
+
+	// mirrors axpf__parse, also noting the arguments the directive reads
+	constexpr axpf_size_t pfDirective( const char *f, axpf_size_t i, axpf__insn_ &d, SPfCounts &r, char *pArgs )
+	{
+		d.repeats = 1;
+		d.arrayprint[ 0 ] = '{';
+		d.arrayprint[ 1 ] = ',';
+		d.arrayprint[ 2 ] = ' ';
+		d.arrayprint[ 3 ] = '}';
+
+		if( pfCheck( f, i, '{' ) ) {
+			if( pfCheck( f, i, '*' ) ) {
+				d.stars |= kAxPFS_Repeats;
+				pfArg( r, pArgs, 'i' );
+			} else {
+				d.repeats = pfUint( f, i );
+			}
+
+			( void )pfCheck( f, i, '}' );
+		}
+
+		if( pfCheck( f, i, '[' ) ) {
+			unsigned n = 0;
+
+			if( pfCheck( f, i, '*' ) ) {
+				d.stars |= kAxPFS_Array;
+				pfArg( r, pArgs, 'i' );
+			} else {
+				d.arraysize = pfUint( f, i );
+			}
+			d.flags |= kAxPF_Array;
+
+			while( n < AXPF__MAX_ARRAY_PRINT ) {
+				if( pfCheck( f, i, ']' ) ) {
+					break;
+				}
+
+				d.arrayprint[ n++ ] = pfRead( f, i );
+			}
+
+			if( n == AXPF__MAX_ARRAY_PRINT ) {
+				( void )pfCheck( f, i, ']' );
+			} else if( n > 0 ) {
+				d.arrayprint[ AXPF__MAX_ARRAY_PRINT - 1 ] = d.arrayprint[ n - 1 ];
+				if( n < 4 ) {
+					d.arrayprint[ 2 ] = '\0';
+				}
+				if( n < 3 ) {
+					d.arrayprint[ 1 ] = ',';
+				}
+			}
+		}
+
+		for(;;) {
+			if( pfCheck( f, i, '-' ) ) {
+				d.flags |= kAxPF_Left;
+			} else if( pfCheck( f, i, '+' ) ) {
+				d.flags |= kAxPF_Sign;
+			} else if( pfCheck( f, i, ' ' ) ) {
+				d.flags |= kAxPF_Space;
+			} else if( pfCheck( f, i, '#' ) ) {
+				d.flags |= kAxPF_Radix;
+			} else if( pfCheck( f, i, '0' ) ) {
+				d.flags |= kAxPF_Zero;
+			} else if( pfCheck( f, i, '\'' ) ) {
+				d.flags |= kAxPF_Group;
+			} else if( pfCheck( f, i, '/' ) ) {
+				d.flags |= kAxPF_FSPath;
+			} else {
+				break;
+			}
+		}
+
+		if( pfCheck( f, i, '*' ) ) {
+			d.stars |= kAxPFS_Width;
+			d.flags |= kAxPF_Width;
+			pfArg( r, pArgs, 'i' );
+		} else if( pfIsDigit( f[ i ] ) ) {
+			d.width = int( pfUint( f, i ) );
+			d.flags |= kAxPF_Width;
+		}
+
+		if( pfCheck( f, i, '.' ) ) {
+			if( pfCheck( f, i, '*' ) ) {
+				d.stars |= kAxPFS_Precision;
+				d.flags |= kAxPF_Precision;
+				pfArg( r, pArgs, 'i' );
+			} else if( pfIsDigit( f[ i ] ) ) {
+				d.precision = int( pfUint( f, i ) );
+				d.flags |= kAxPF_Precision;
+			}
+		}
+
+		if( pfCheck( f, i, 'h' ) ) {
+			d.lenspec = pfCheck( f, i, 'h' ) ? kAxLS_hh : kAxLS_h;
+		} else if( pfCheck( f, i, 'l' ) ) {
+			d.lenspec = pfCheck( f, i, 'l' ) ? kAxLS_ll : kAxLS_l;
+		} else if( pfCheck( f, i, 'j' ) ) {
+			d.lenspec = kAxLS_j;
+		} else if( pfCheck( f, i, 'z' ) ) {
+			d.lenspec = kAxLS_z;
+		} else if( pfCheck( f, i, 't' ) ) {
+			d.lenspec = kAxLS_t;
+		} else if( pfCheck( f, i, 'L' ) ) {
+			d.lenspec = kAxLS_L;
+		} else if( pfCheck( f, i, 'q' ) ) {
+			d.lenspec = kAxLS_I64;
+		} else if( pfCheck( f, i, 'w' ) ) {
+			d.lenspec = kAxLS_l;
+		} else if( pfCheck( f, i, 'I' ) ) {
+			if( f[ i ] == '3' && f[ i + 1 ] == '2' ) {
+				d.lenspec = kAxLS_I32;
+				i += 2;
+			} else if( f[ i ] == '6' && f[ i + 1 ] == '4' ) {
+				d.lenspec = kAxLS_I64;
+				i += 2;
+			} else {
+				d.lenspec = kAxLS_I;
+			}
+		}
+
+		char spec = pfRead( f, i );
+		if( spec >= 'A' && spec <= 'Z' && spec!='C' && spec!='D' && spec!='S' ) {
+			d.flags |= kAxPF_Upper;
+			spec = char( spec - 'A' + 'a' );
+		}
+		d.spec = spec;
+
+		d.kind = kAxPFK_Generic;
+		if( !d.flags && !d.stars && d.repeats == 1 && d.lenspec == kAxLS_None ) {
+			if( spec == 's' ) {
+				d.kind = kAxPFK_Str;
+			} else if( spec == 'd' || spec == 'i' ) {
+				d.kind = kAxPFK_Int;
+			}
+		}
+
+		// the arguments read, as axpf__emit reads them
+		const bool bNarrow = d.lenspec == kAxLS_None;
+		const bool bWide = d.lenspec == kAxLS_l;
+		switch( spec ) {
+		case 'd': case 'i': case 'u': case 'o': case 'x':
+			pfArg( r, pArgs, ( d.flags & kAxPF_Array ) ? 'p' : 'i' );
+			break;
+
+		case 'r':
+			pfArg( r, pArgs, 'i' );
+			if( d.flags & kAxPF_Array ) {
+				pfArg( r, pArgs, 'p' );
+				r.bChecked = false;
+			} else {
+				pfArg( r, pArgs, 'i' );
+			}
+			break;
+
+		case 'f': case 'e': case 'g': case 'a':
+			if( !bNarrow && !bWide && d.lenspec != kAxLS_L ) {
+				pfBadFormat();
+			}
+			pfArg( r, pArgs, ( d.flags & kAxPF_Array ) ? 'p' : 'f' );
+			break;
+
+		case 'c': case 'C': case 's': case 'S':
+			if( !( bNarrow && ( spec == 'c' || spec == 's' ) ) && !bWide && spec != 'C' && spec != 'S' ) {
+				pfBadFormat();
+			}
+			pfArg( r, pArgs, ( spec == 'c' || spec == 'C' ) && !( d.flags & kAxPF_Array ) ? 'i' : 'p' );
+			break;
+
+		case 'p':
+			pfArg( r, pArgs, 'p' );
+			break;
+
+		case 'n':
+		case 'm':
+		case 'b':
+		case 'D':
+			if( d.flags & kAxPF_Array ) {
+				pfBadFormat();
+			}
+			if( spec == 'n' ) {
+				pfArg( r, pArgs, 'p' );
+			} else if( spec == 'b' ) {
+				pfArg( r, pArgs, 'i' );
+				pfArg( r, pArgs, 'p' );
+			} else if( spec == 'D' ) {
+				pfArg( r, pArgs, 'p' );
+				pfArg( r, pArgs, 'p' );
+			}
+			break;
+
+		default:
+			pfBadFormat();
+			break;
+		}
+
+		return i;
+	}
+
+	// mirrors axpf__compile; the instructions and argument classes are only
+	// stored when `pInsns` and `pArgs` are given
+	constexpr SPfCounts pfWalk( const char *f, axpf__insn_ *pInsns, char *pArgs )
+	{
+		SPfCounts r = { 0, 0, true };
+		axpf_size_t i = 0, lit = 0;
+
+		while( f[ i ] != '\0' ) {
+			if( f[ i ] != '%' ) {
+				++i;
+				continue;
+			}
+
+			axpf_size_t q = i++;
+			axpf__insn_ d = {};
+
+			if( pfCheck( f, i, '%' ) ) {
+				d.kind = kAxPFK_Literal;
+				++q;
+			} else {
+				i = pfDirective( f, i, d, r, pArgs );
+			}
+
+			d.lit = axpf_u32_t( lit );
+			d.litlen = axpf_u32_t( q - lit );
+			if( pInsns != nullptr ) {
+				pInsns[ r.cInsns ] = d;
+			}
+			++r.cInsns;
+
+			lit = i;
+		}
+
+		if( lit < i ) {
+			axpf__insn_ d = {};
+
+			d.kind = kAxPFK_Literal;
+			d.lit = axpf_u32_t( lit );
+			d.litlen = axpf_u32_t( i - lit );
+			if( pInsns != nullptr ) {
+				pInsns[ r.cInsns ] = d;
+			}
+			++r.cInsns;
+		}
+
+		return r;
+	}
+
+	template< axpf_size_t tInsns, axpf_size_t tArgs >
+	struct TPfCompiled
+	{
+		axpf__insn_ insns[ tInsns > 0 ? tInsns : 1 ];
+		char        args[ tArgs > 0 ? tArgs : 1 ];
+	};
+	template< axpf_size_t tInsns, axpf_size_t tArgs >
+	constexpr TPfCompiled< tInsns, tArgs > pfBuild( const char *f )
+	{
+		TPfCompiled< tInsns, tArgs > r = {};
+
+		( void )pfWalk( f, r.insns, r.args );
+		return r;
+	}
+
+	// `TLit::get()` returns the format string (see AXPF_FORMAT)
+	template< typename TLit >
+	class TPfFormat
+	{
+	public:
+		static constexpr SPfCounts kCounts = pfWalk( TLit::get(), nullptr, nullptr );
+
+		typedef TPfCompiled< kCounts.cInsns, kCounts.cArgs > Compiled;
+		static constexpr Compiled      kCompiled = pfBuild< kCounts.cInsns, kCounts.cArgs >( TLit::get() );
+		static constexpr axpf_format_t kFormat   = { kCompiled.insns, kCounts.cInsns, TLit::get() };
+
+		inline const axpf_format_t *get() const
+		{
+			return &kFormat;
+		}
+
+		// whether arguments of these types can be passed with the format
+		template< typename... TArgs >
+		static constexpr bool accepts()
+		{
+			const char classes[] = { TPfArgClass< TArgs >::value..., '\0' };
+
+			if( !kCounts.bChecked ) {
+				return true;
+			}
+			if( sizeof...( TArgs ) != kCounts.cArgs ) {
+				return false;
+			}
+
+			for( axpf_size_t i = 0; i < kCounts.cArgs; ++i ) {
+				if( classes[ i ] != kCompiled.args[ i ] ) {
+					return false;
+				}
+			}
+
+			return true;
+		}
+	};
+# ifndef __cpp_inline_variables
+	template< typename TLit > constexpr SPfCounts TPfFormat< TLit >::kCounts;
+	template< typename TLit > constexpr typename TPfFormat< TLit >::Compiled TPfFormat< TLit >::kCompiled;
+	template< typename TLit > constexpr axpf_format_t TPfFormat< TLit >::kFormat;
+# endif
+
+}}
+
+# define AXPF_FORMAT(Lit_)\
+	( []() {\
+		struct SLit_ { static constexpr const char *get() { return Lit_; } };\
+		return ::ax::detail::TPfFormat< SLit_ >();\
+	}() )
+
+# define AXPF__CHECK_ARGS(TLit_,TArgs_)\
+	static_assert( ::ax::detail::TPfFormat< TLit_ >::template accepts< TArgs_... >(),\
+		"ax_printf: arguments don't match the format" )
+
+template< typename TLit, typename... TArgs >
+inline axpf_ptrdiff_t axbpcf( axpf_buffer_t *pBuf, ax::detail::TPfFormat< TLit > f, TArgs... args )
+{
+	AXPF__CHECK_ARGS( TLit, TArgs );
+	return axbpcf( pBuf, f.get(), args... );
+}
+template< typename TLit, typename... TArgs >
+inline axpf_ptrdiff_t axspcf( char *buf, axpf_size_t nbuf, ax::detail::TPfFormat< TLit > f, TArgs... args )
+{
+	AXPF__CHECK_ARGS( TLit, TArgs );
+	return axspcf( buf, nbuf, f.get(), args... );
+}
+template< axpf_size_t tMaxBuf, typename TLit, typename... TArgs >
+inline axpf_ptrdiff_t axspcf( char( &buf )[ tMaxBuf ], ax::detail::TPfFormat< TLit > f, TArgs... args )
+{
+	AXPF__CHECK_ARGS( TLit, TArgs );
+	return axspcf( buf, tMaxBuf, f.get(), args... );
+}
+# if AXPF_STDFILE_ENABLED
+template< typename TLit, typename... TArgs >
+inline axpf_ptrdiff_t axfpcf( FILE *fp, ax::detail::TPfFormat< TLit > f, TArgs... args )
+{
+	AXPF__CHECK_ARGS( TLit, TArgs );
+	return axfpcf( fp, f.get(), args... );
+}
+# endif
+#endif /*AXPF_CXX_CONSTEXPR_ENABLED*/
+
 #endif
@@ -0,0 +1,956 @@
+/*
+
+	ax_profile - public domain
+	Last update: 2026-10-15
+
+
+	This library records hierarchical profiling zones into per-thread ring
+	buffers at a cost of a couple of timestamp reads each, and exports them in
+	the Chrome trace event format (loaded by Perfetto and chrome://tracing).
+
+
+	USAGE
+	=====
+
+	Define AXPROF_IMPLEMENTATION in exactly one source file that includes this
+	header, before including it.
+
+	The following don't need to be defined, as default definitions will be
+	provided, but can be defined if you want to alter default functionality
+	without modifying this file.
+
+	AXPROF_FUNC and AXPROF_CALL control the function declaration and calling
+	conventions. Ensure that all source files including this use the same
+	definitions for these. (That can be done in your Makefile or project
+	settings.)
+
+
+	OVERVIEW
+	========
+
+	Call `axprof_init()` to start recording, then mark zones:
+
+		void update_world( world_t *w )
+		{
+			AXPROF_ZONE_BEGIN( update, "update_world" );
+			...
+			AXPROF_ZONE_END( update );
+		}
+
+	In C++, `AXPROF_SCOPE( "name" )` (or `AXPROF_SCOPE_FUNC()`) ends the zone at
+	the end of the enclosing block instead. Zones nest freely; the trace viewer
+	works out the hierarchy from the times.
+
+	Each zone site is a static `axprof_zone_t` (name, file and line), and its
+	address identifies it. Beginning a zone reads the CPU's timestamp counter
+	(the same counter as `axth_get_cpu_cycles()`, read inline); ending it reads
+	the counter again and appends one 32-byte record to the calling thread's
+	ring buffer. That takes no locks, atomics or calls.
+
+	Each thread gets a ring buffer the first time it records something while a
+	session is running. The thread is its buffer's only writer. The exporter
+	reads from any thread without stopping the writers. Once a ring is full the
+	oldest records are overwritten, and the exporter skips any it can't read
+	intact. The thread's name (from `axth_get_thread_name()`, unless set with
+	`axprof_set_thread_name()`) and worker ID (from `axth_get_worker_id()`) are
+	captured when its buffer is created.
+
+	A zone is recorded by the thread that ends it. A job that waits across
+	`axjob_wait()` on a fiber can resume on another worker, so its zone shows
+	up on that worker's track.
+
+	Timestamps are converted to time by calibrating the counter against
+	`axtm_nanoseconds()` over the whole session (at least 1ms), each time a
+	trace is exported.
+
+
+	RESTRICTIONS
+	============
+
+	- Only one session runs at a time, and sessions are process-wide.
+	- No thread may be inside `axprof_end()`, `axprof_mark()` or an allocator
+	  listener callback while `axprof_fini()` runs. Zones that merely began
+	  before it are fine.
+	- The counter must tick at a constant rate and agree between cores (an
+	  invariant TSC on x86, or the generic timer on AArch64).
+
+
+	CONFIGURATION MACROS
+	====================
+
+	Define any of these prior to including this header, if you want to alter
+	the default functionality.
+
+		AXPROF_ENABLED
+		--------------
+		Set to 0 to compile out the zone macros (AXPROF_ZONE_BEGIN,
+		AXPROF_ZONE_END, AXPROF_MARK, AXPROF_SCOPE and AXPROF_SCOPE_FUNC);
+		they then expand to nothing. The functions remain available.
+		(Default is 1.)
+
+		AXPROF_RING_SIZE
+		----------------
+		Number of records in each thread's ring buffer. Must be a power of two.
+		Each record is 32 bytes. (Default is 16384, for 512KB per thread.)
+
+
+	REPLACE PROFILER ALLOCATORS
+	===========================
+
+	You can specify your own allocator to use with this library by defining the
+	axprof_alloc and axprof_free macros. By default they are defined to the
+	standard C library's malloc() and free(). Ring buffers are allocated the
+	first time each thread records something, and freed by `axprof_fini()`.
+
+
+	INTERACTIONS
+	============
+
+	This library requires ax_thread (atomics, the cycle counter, worker IDs and
+	thread names) and ax_time (calibration). They will be included
+	automatically on compilers with `__has_include`; otherwise include them
+	before this header.
+
+	In C++, if ax_memory has been included prior to this header (with
+	AXMM_LISTENERS_ENABLED), `ax::CProfileAllocListener` is available. Add it
+	with `ax::addListener()` to record every allocation and free as an instant
+	event (with its size) inside whichever zone is running, along with a
+	"heap" counter track of the bytes it has seen allocated.
+
+
+	LICENSE
+	=======
+
+	This software is in the public domain. Where that dedication is not
+	recognized, you are granted a perpetual, irrevocable license to copy
+	and modify this file as you see fit. There are no warranties of any
+	kind.
+
+*/
+
+#ifndef INCGUARD_AX_PROFILE_H_
+#define INCGUARD_AX_PROFILE_H_
+
+#ifndef AX_NO_PRAGMA_ONCE
+# pragma once
+#endif
+
+#if !defined( AX_NO_INCLUDES ) && defined( __has_include )
+# if __has_include( "ax_platform.h" )
+#  include "ax_platform.h"
+# endif
+# if __has_include( "ax_types.h" )
+#  include "ax_types.h"
+# endif
+# if __has_include( "ax_thread.h" )
+#  include "ax_thread.h"
+# endif
+# if __has_include( "ax_time.h" )
+#  include "ax_time.h"
+# endif
+#endif
+
+#ifndef INCGUARD_AX_THREAD_H_
+# error ax_profile requires ax_thread.h
+#endif
+#ifndef INCGUARD_AX_TIME_H_
+# error ax_profile requires ax_time.h
+#endif
+
+#ifdef AXPROF_IMPLEMENTATION
+# define AXPROF_IMPLEMENT           1
+#else
+# define AXPROF_IMPLEMENT           0
+#endif
+
+#ifndef AXPROF_FUNC
+# ifdef AX_FUNC
+#  define AXPROF_FUNC               AX_FUNC
+# else
+#  define AXPROF_FUNC               extern
+# endif
+#endif
+#ifndef AXPROF_CALL
+# ifdef AX_CALL
+#  define AXPROF_CALL               AX_CALL
+# else
+#  define AXPROF_CALL
+# endif
+#endif
+
+#ifndef AXPROF_ENABLED
+# define AXPROF_ENABLED             1
+#endif
+
+#ifndef AXPROF_RING_SIZE
+# define AXPROF_RING_SIZE           16384
+#endif
+#if ( AXPROF_RING_SIZE & ( AXPROF_RING_SIZE - 1 ) ) != 0
+# error AXPROF_RING_SIZE must be a power of two
+#endif
+
+#ifndef axprof_alloc
+# include <stdlib.h>
+# define axprof_alloc(N_)           (malloc((N_)))
+# define axprof_free(P_)            (free((P_)))
+#endif
+
+#ifndef AXPROF_THREADLOCAL
+# if !defined( _MSC_VER )
+#  define AXPROF_THREADLOCAL        __thread
+# else
+#  define AXPROF_THREADLOCAL        __declspec(thread)
+# endif
+#endif
+
+#ifndef AXPROF__INLINE
+# if defined( _MSC_VER )
+#  define AXPROF__INLINE            static __forceinline
+# elif defined( __GNUC__ ) || defined( __clang__ )
+#  define AXPROF__INLINE            static __inline__ __attribute__((always_inline))
+# else
+#  define AXPROF__INLINE            static
+# endif
+#endif
+
+/* implementation: read the cycle counter inline where we know how to */
+#if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+# include <intrin.h>
+# define AXPROF__TICKS()            ( ( axprof_u64_t )__rdtsc() )
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+# include <x86intrin.h>
+# define AXPROF__TICKS()            ( ( axprof_u64_t )__rdtsc() )
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __aarch64__ ) && !defined( __APPLE__ )
+# define AXPROF__TICKS()            axprof__cntvct()
+#else
+# define AXPROF__TICKS()            ( ( axprof_u64_t )axth_get_cpu_cycles() )
+#endif
+
+/* implementation: order a record's contents before the head that publishes it */
+#if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+# define AXPROF__PUBLISH()          _ReadWriteBarrier()
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+# define AXPROF__PUBLISH()          __asm__ __volatile__( "" : : : "memory" )
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __aarch64__ )
+# define AXPROF__PUBLISH()          __asm__ __volatile__( "dmb ishst" : : : "memory" )
+#else
+# define AXPROF__PUBLISH()          AX_MEMORY_BARRIER()
+#endif
+
+#define AXPROF__JOIN_(X_,Y_)        X_##Y_
+#define AXPROF__JOIN(X_,Y_)         AXPROF__JOIN_(X_,Y_)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef axth_u32_t                  axprof_u32_t;
+typedef axth_u64_t                  axprof_u64_t;
+
+/* What a record describes */
+typedef enum axprof_kind_e
+{
+	/* a zone; the record holds its begin and end ticks */
+	axprof_kind_zone,
+	/* an instant event from `axprof_mark()`; the record holds its tick and argument */
+	axprof_kind_mark,
+	/* an allocation seen by the allocator listener */
+	axprof_kind_alloc,
+	/* a free seen by the allocator listener */
+	axprof_kind_free
+} axprof_kind_t;
+
+/* A place in the code that records; its address identifies it */
+typedef struct axprof_zone_s
+{
+	/* Name shown in the trace */
+	const char *                    pszName;
+	/* Source location */
+	const char *                    pszFile;
+	axprof_u32_t                    uLine;
+	/* One of `axprof_kind_t` */
+	axprof_u32_t                    uKind;
+} axprof_zone_t;
+
+/* A record in a thread's ring buffer */
+typedef struct axprof_event_s
+{
+	const axprof_zone_t *           pZone;
+	/* Tick the zone began, or the tick of an instant event */
+	axprof_u64_t                    uBegin;
+	/* Tick the zone ended; for allocator events, the heap counter afterward */
+	axprof_u64_t                    uEnd;
+	/* Argument of an instant event, or the size of an allocation or free */
+	axprof_u64_t                    uArg;
+} axprof_event_t;
+
+/* Receives the exported trace; returns nonzero on success */
+typedef int( AXPROF_CALL *axprof_fn_write_t )( void *pUser, const char *pData, axprof_u32_t cBytes );
+
+/* implementation: a thread's ring buffer */
+typedef struct axprof__thread_s
+{
+	struct axprof__thread_s *       pNext;
+	/* track ID in the exported trace */
+	axprof_u32_t                    uIndex;
+	axprof_u32_t                    uWorkerId;
+	char                            szName[ 64 ];
+	/* records exported so far (only touched by the exporter) */
+	axprof_u32_t                    uRead;
+	char                            _pad0[ 64 ];
+	/* records written so far (only written by the owning thread) */
+	volatile axprof_u32_t           uHead;
+	char                            _pad1[ 64 - sizeof( axprof_u32_t ) ];
+	axprof_event_t                  Events[ AXPROF_RING_SIZE ];
+} axprof__thread_t;
+
+/* implementation: the calling thread's buffer, valid while `uSession` matches */
+typedef struct axprof__local_s
+{
+	axprof__thread_t *              pThread;
+	axprof_u32_t                    uSession;
+	char                            szName[ 64 ];
+} axprof__local_t;
+
+extern AXPROF_THREADLOCAL axprof__local_t axprof__g_local;
+/* implementation: running session, or 0 if none */
+extern volatile axprof_u32_t        axprof__g_uSession;
+
+/* implementation: find or create the calling thread's buffer (null if no session is running) */
+AXPROF_FUNC axprof__thread_t *AXPROF_CALL axprof__attach( void );
+
+#if ( defined( __GNUC__ ) || defined( __clang__ ) ) && defined( __aarch64__ ) && !defined( __APPLE__ )
+AXPROF__INLINE axprof_u64_t axprof__cntvct( void )
+{
+	axprof_u64_t t;
+	__asm__ __volatile__( "mrs %0, cntvct_el0" : "=r" (t) );
+	return t;
+}
+#endif
+
+/* Read the cycle counter */
+AXPROF__INLINE axprof_u64_t axprof_ticks( void )
+{
+	return AXPROF__TICKS();
+}
+
+/* implementation: append a record to the calling thread's ring */
+AXPROF__INLINE void axprof__record( const axprof_zone_t *pZone, axprof_u64_t uBegin, axprof_u64_t uEnd, axprof_u64_t uArg )
+{
+	axprof__thread_t *p;
+	axprof_event_t *e;
+	axprof_u32_t h;
+
+	p = axprof__g_local.pThread;
+	if( !p || axprof__g_local.uSession != axprof__g_uSession ) {
+		p = axprof__attach();
+		if( !p ) {
+			return;
+		}
+	}
+
+	h = p->uHead;
+	e = &p->Events[ h & ( AXPROF_RING_SIZE - 1 ) ];
+	e->pZone = pZone;
+	e->uBegin = uBegin;
+	e->uEnd = uEnd;
+	e->uArg = uArg;
+
+	AXPROF__PUBLISH();
+	p->uHead = h + 1;
+}
+
+/* End a zone that began at `uBegin` (from `axprof_ticks()`) */
+AXPROF__INLINE void axprof_end( const axprof_zone_t *pZone, axprof_u64_t uBegin )
+{
+	axprof__record( pZone, uBegin, axprof_ticks(), 0 );
+}
+/* Record an instant event with an argument */
+AXPROF__INLINE void axprof_mark( const axprof_zone_t *pZone, axprof_u64_t uArg )
+{
+	const axprof_u64_t t = axprof_ticks();
+	axprof__record( pZone, t, t, uArg );
+}
+
+/*
+ * Start a session, discarding anything recorded by a previous one.
+ *
+ * Returns nonzero on success (including when a session is already running).
+ */
+AXPROF_FUNC int AXPROF_CALL axprof_init( void );
+/* Stop the session and free every thread's ring buffer */
+AXPROF_FUNC void AXPROF_CALL axprof_fini( void );
+
+/* Name the calling thread's track, overriding `axth_get_thread_name()` */
+AXPROF_FUNC void AXPROF_CALL axprof_set_thread_name( const char *pszName );
+
+/* Calibrate the cycle counter against `axtm_nanoseconds()`; returns nanoseconds per tick */
+AXPROF_FUNC double AXPROF_CALL axprof_calibrate( void );
+/* Convert a tick from `axprof_ticks()` to nanoseconds since the session started (as of the last calibration) */
+AXPROF_FUNC double AXPROF_CALL axprof_ticks_to_ns( axprof_u64_t uTicks );
+
+/*
+ * Write every record made since the last export as a Chrome trace (JSON).
+ *
+ * Returns nonzero on success, or zero if `pfnWrite` failed.
+ */
+AXPROF_FUNC int AXPROF_CALL axprof_export_chrome( axprof_fn_write_t pfnWrite, void *pUser );
+/* Same as `axprof_export_chrome()`, but writes to a file */
+AXPROF_FUNC int AXPROF_CALL axprof_export_chrome_file( const char *pszFilename );
+
+#if AXPROF_ENABLED
+# define AXPROF_ZONE_BEGIN(Var_,Name_)\
+	static const axprof_zone_t Var_##_axprof_zone = { (Name_), __FILE__, __LINE__, axprof_kind_zone };\
+	const axprof_u64_t Var_##_axprof_begin = axprof_ticks()
+# define AXPROF_ZONE_END(Var_)\
+	axprof_end( &Var_##_axprof_zone, Var_##_axprof_begin )
+# define AXPROF_MARK(Name_,Arg_)\
+	do {\
+		static const axprof_zone_t axprof__markZone = { (Name_), __FILE__, __LINE__, axprof_kind_mark };\
+		axprof_mark( &axprof__markZone, ( axprof_u64_t )( Arg_ ) );\
+	} while(0)
+#else
+# define AXPROF_ZONE_BEGIN(Var_,Name_)
+# define AXPROF_ZONE_END(Var_)      ( ( void )0 )
+# define AXPROF_MARK(Name_,Arg_)    ( ( void )0 )
+#endif
+
+#if AXPROF_IMPLEMENT
+# include <stdio.h>
+
+AXPROF_THREADLOCAL axprof__local_t  axprof__g_local;
+volatile axprof_u32_t               axprof__g_uSession  = 0;
+
+static axprof_u32_t                 axprof__g_uLastSession = 0;
+static volatile axprof_u32_t        axprof__g_uLock     = 0;
+static axprof__thread_t *volatile   axprof__g_pThreads  = ( axprof__thread_t * )0;
+static axprof_u32_t                 axprof__g_cThreads  = 0;
+
+/* calibration: counter and clock when the session started, and the rate between them */
+static axprof_u64_t                 axprof__g_uBaseTicks = 0;
+static axprof_u64_t                 axprof__g_uBaseNanos = 0;
+static double                       axprof__g_fNanosPerTick = 1.0;
+
+static void axprof__lock( void )
+{
+	while( AX_ATOMIC_EXCHANGE_FULL32( &axprof__g_uLock, 1 ) != 0 ) {
+		AX_CPU_PAUSE();
+	}
+}
+static void axprof__unlock( void )
+{
+	( void )AX_ATOMIC_EXCHANGE_FULL32( &axprof__g_uLock, 0 );
+}
+
+static axprof_u64_t axprof__nanoseconds( void )
+{
+	int s, ns;
+
+	if( !axtm_nanoseconds( &s, &ns ) ) {
+		return 0;
+	}
+
+	return ( axprof_u64_t )( unsigned )s*1000000000ULL + ( axprof_u64_t )( unsigned )ns;
+}
+
+static void axprof__copy_name( char *pszDst, const char *pszSrc )
+{
+	axprof_u32_t i;
+
+	for( i = 0; pszSrc[ i ] != '\0' && i + 1 < 64; ++i ) {
+		pszDst[ i ] = pszSrc[ i ];
+	}
+	pszDst[ i ] = '\0';
+}
+#endif
+
+AXPROF_FUNC axprof__thread_t *AXPROF_CALL axprof__attach( void )
+#if AXPROF_IMPLEMENT
+{
+	axprof__thread_t *p;
+	axprof_u32_t uSession;
+
+	uSession = axprof__g_uSession;
+	if( !uSession ) {
+		return ( axprof__thread_t * )0;
+	}
+
+	p = ( axprof__thread_t * )axprof_alloc( sizeof( *p ) );
+	if( !p ) {
+		return ( axprof__thread_t * )0;
+	}
+
+	p->uWorkerId = axth_get_worker_id();
+	axprof__copy_name( p->szName, axprof__g_local.szName[0] != '\0' ? axprof__g_local.szName : axth_get_thread_name() );
+	p->uRead = 0;
+	p->uHead = 0;
+
+	axprof__lock();
+	p->uIndex = ++axprof__g_cThreads;
+	p->pNext = axprof__g_pThreads;
+	axprof__g_pThreads = p;
+	axprof__unlock();
+
+	axprof__g_local.pThread = p;
+	axprof__g_local.uSession = uSession;
+
+	return p;
+}
+#else
+;
+#endif
+
+AXPROF_FUNC int AXPROF_CALL axprof_init( void )
+#if AXPROF_IMPLEMENT
+{
+	if( axprof__g_uSession != 0 ) {
+		return 1;
+	}
+
+	axprof__g_uBaseNanos = axprof__nanoseconds();
+	axprof__g_uBaseTicks = axprof_ticks();
+	axprof__g_fNanosPerTick = 1.0;
+	if( !axprof__g_uBaseNanos ) {
+		return 0;
+	}
+
+	/* a fresh session number leaves every thread's cached buffer stale */
+	if( ++axprof__g_uLastSession == 0 ) {
+		++axprof__g_uLastSession;
+	}
+
+	AX_MEMORY_BARRIER();
+	axprof__g_uSession = axprof__g_uLastSession;
+
+	return 1;
+}
+#else
+;
+#endif
+
+AXPROF_FUNC void AXPROF_CALL axprof_fini( void )
+#if AXPROF_IMPLEMENT
+{
+	axprof__thread_t *p, *q;
+
+	axprof__g_uSession = 0;
+	AX_MEMORY_BARRIER();
+
+	axprof__lock();
+	p = axprof__g_pThreads;
+	axprof__g_pThreads = ( axprof__thread_t * )0;
+	axprof__g_cThreads = 0;
+	axprof__unlock();
+
+	while( p != ( axprof__thread_t * )0 ) {
+		q = p->pNext;
+		axprof_free( ( void * )p );
+		p = q;
+	}
+}
+#else
+;
+#endif
+
+AXPROF_FUNC void AXPROF_CALL axprof_set_thread_name( const char *pszName )
+#if AXPROF_IMPLEMENT
+{
+	axprof__copy_name( axprof__g_local.szName, pszName );
+
+	if( axprof__g_local.pThread != ( axprof__thread_t * )0 && axprof__g_local.uSession == axprof__g_uSession ) {
+		axprof__copy_name( axprof__g_local.pThread->szName, pszName );
+	}
+}
+#else
+;
+#endif
+
+AXPROF_FUNC double AXPROF_CALL axprof_calibrate( void )
+#if AXPROF_IMPLEMENT
+{
+	axprof_u64_t uNanos, uTicks;
+
+	/* the longer the baseline the better; insist on a millisecond */
+	do {
+		uNanos = axprof__nanoseconds();
+		uTicks = axprof_ticks();
+	} while( uNanos - axprof__g_uBaseNanos < 1000000 );
+
+	if( uTicks > axprof__g_uBaseTicks ) {
+		axprof__g_fNanosPerTick = ( double )( uNanos - axprof__g_uBaseNanos )/( double )( uTicks - axprof__g_uBaseTicks );
+	}
+
+	return axprof__g_fNanosPerTick;
+}
+#else
+;
+#endif
+
+AXPROF_FUNC double AXPROF_CALL axprof_ticks_to_ns( axprof_u64_t uTicks )
+#if AXPROF_IMPLEMENT
+{
+	if( uTicks <= axprof__g_uBaseTicks ) {
+		return 0.0;
+	}
+
+	return ( double )( uTicks - axprof__g_uBaseTicks )*axprof__g_fNanosPerTick;
+}
+#else
+;
+#endif
+
+#if AXPROF_IMPLEMENT
+/* implementation: buffered writer for the exporter */
+typedef struct axprof__writer_s
+{
+	axprof_fn_write_t               pfnWrite;
+	void *                          pUser;
+	int                             bFailed;
+	axprof_u32_t                    cBytes;
+	char                            Buf[ 4096 ];
+} axprof__writer_t;
+
+static void axprof__flush( axprof__writer_t *w )
+{
+	if( w->cBytes > 0 && !w->bFailed && !w->pfnWrite( w->pUser, w->Buf, w->cBytes ) ) {
+		w->bFailed = 1;
+	}
+	w->cBytes = 0;
+}
+static void axprof__putc( axprof__writer_t *w, char ch )
+{
+	if( w->cBytes == sizeof( w->Buf ) ) {
+		axprof__flush( w );
+	}
+	w->Buf[ w->cBytes++ ] = ch;
+}
+static void axprof__puts( axprof__writer_t *w, const char *s )
+{
+	while( *s != '\0' ) {
+		axprof__putc( w, *s++ );
+	}
+}
+static void axprof__put_u64( axprof__writer_t *w, axprof_u64_t x )
+{
+	char buf[ 24 ];
+	axprof_u32_t i;
+
+	i = sizeof( buf );
+	do {
+		buf[ --i ] = ( char )( '0' + x%10 );
+		x /= 10;
+	} while( x != 0 );
+
+	while( i < sizeof( buf ) ) {
+		axprof__putc( w, buf[ i++ ] );
+	}
+}
+/* nanoseconds as the microseconds the format wants, to three decimal places */
+static void axprof__put_us( axprof__writer_t *w, double fNanos )
+{
+	axprof_u64_t n;
+
+	n = fNanos > 0.0 ? ( axprof_u64_t )( fNanos + 0.5 ) : 0;
+	axprof__put_u64( w, n/1000 );
+	axprof__putc( w, '.' );
+	axprof__putc( w, ( char )( '0' + n/100%10 ) );
+	axprof__putc( w, ( char )( '0' + n/10%10 ) );
+	axprof__putc( w, ( char )( '0' + n%10 ) );
+}
+static void axprof__put_json_str( axprof__writer_t *w, const char *s )
+{
+	static const char szHex[] = "0123456789abcdef";
+
+	axprof__putc( w, '\"' );
+	for( ; *s != '\0'; ++s ) {
+		const unsigned char ch = ( unsigned char )*s;
+
+		if( ch == '\"' || ch == '\\' ) {
+			axprof__putc( w, '\\' );
+			axprof__putc( w, ( char )ch );
+		} else if( ch < 0x20 ) {
+			axprof__puts( w, "\\u00" );
+			axprof__putc( w, szHex[ ch >> 4 ] );
+			axprof__putc( w, szHex[ ch & 0xF ] );
+		} else {
+			axprof__putc( w, ( char )ch );
+		}
+	}
+	axprof__putc( w, '\"' );
+}
+
+static void axprof__put_event( axprof__writer_t *w, const axprof__thread_t *t, const axprof_event_t *e, int *pbFirst )
+{
+	const axprof_zone_t *const z = e->pZone;
+
+	axprof__puts( w, *pbFirst ? "\n" : ",\n" );
+	*pbFirst = 0;
+
+	axprof__puts( w, "{\"name\":" );
+	axprof__put_json_str( w, z->pszName );
+	axprof__puts( w, ",\"ph\":" );
+	axprof__puts( w, z->uKind == axprof_kind_zone ? "\"X\"" : "\"i\",\"s\":\"t\"" );
+	axprof__puts( w, ",\"ts\":" );
+	axprof__put_us( w, axprof_ticks_to_ns( e->uBegin ) );
+	if( z->uKind == axprof_kind_zone ) {
+		axprof__puts( w, ",\"dur\":" );
+		axprof__put_us( w, e->uEnd > e->uBegin ? ( double )( e->uEnd - e->uBegin )*axprof__g_fNanosPerTick : 0.0 );
+	}
+	axprof__puts( w, ",\"pid\":1,\"tid\":" );
+	axprof__put_u64( w, t->uIndex );
+	axprof__puts( w, ",\"args\":{" );
+	if( z->uKind != axprof_kind_zone ) {
+		axprof__puts( w, z->uKind == axprof_kind_mark ? "\"value\":" : "\"bytes\":" );
+		axprof__put_u64( w, e->uArg );
+		axprof__putc( w, ',' );
+	}
+	axprof__puts( w, "\"file\":" );
+	axprof__put_json_str( w, z->pszFile );
+	axprof__puts( w, ",\"line\":" );
+	axprof__put_u64( w, z->uLine );
+	axprof__puts( w, "}}" );
+
+	if( z->uKind == axprof_kind_alloc || z->uKind == axprof_kind_free ) {
+		axprof__puts( w, ",\n{\"name\":\"heap\",\"ph\":\"C\",\"ts\":" );
+		axprof__put_us( w, axprof_ticks_to_ns( e->uBegin ) );
+		axprof__puts( w, ",\"pid\":1,\"args\":{\"bytes\":" );
+		axprof__put_u64( w, e->uEnd );
+		axprof__puts( w, "}}" );
+	}
+}
+
+/* implementation: export the records a thread made since the last export */
+static void axprof__export_thread( axprof__writer_t *w, axprof__thread_t *t, int *pbFirst )
+{
+	axprof_event_t Batch[ 64 ];
+	axprof_u32_t uHead, uFrom, uTo, uNow, i;
+
+	uHead = t->uHead;
+	AX_MEMORY_BARRIER();
+
+	uFrom = t->uRead;
+	if( uHead - uFrom > AXPROF_RING_SIZE ) {
+		uFrom = uHead - AXPROF_RING_SIZE;
+	}
+
+	while( uFrom != uHead ) {
+		uTo = uHead - uFrom > 64 ? uFrom + 64 : uHead;
+		for( i = uFrom; i != uTo; ++i ) {
+			Batch[ i - uFrom ] = t->Events[ i & ( AXPROF_RING_SIZE - 1 ) ];
+		}
+
+		/* anything the writer may have lapped while we copied is torn */
+		AX_MEMORY_BARRIER();
+		uNow = t->uHead;
+		for( i = uFrom; i != uTo; ++i ) {
+			if( uNow - i <= AXPROF_RING_SIZE ) {
+				axprof__put_event( w, t, &Batch[ i - uFrom ], pbFirst );
+			}
+		}
+
+		uFrom = uTo;
+	}
+
+	t->uRead = uHead;
+}
+#endif
+
+AXPROF_FUNC int AXPROF_CALL axprof_export_chrome( axprof_fn_write_t pfnWrite, void *pUser )
+#if AXPROF_IMPLEMENT
+{
+	axprof__writer_t *w;
+	axprof__thread_t *t;
+	int bFirst, bOk;
+
+	w = ( axprof__writer_t * )axprof_alloc( sizeof( *w ) );
+	if( !w ) {
+		return 0;
+	}
+
+	w->pfnWrite = pfnWrite;
+	w->pUser = pUser;
+	w->bFailed = 0;
+	w->cBytes = 0;
+
+	axprof_calibrate();
+
+	axprof__puts( w, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+	bFirst = 1;
+
+	/* the list only grows at its head while a session runs, so it can be walked unlocked */
+	axprof__lock();
+	t = axprof__g_pThreads;
+	axprof__unlock();
+
+	for( ; t != ( axprof__thread_t * )0; t = t->pNext ) {
+		axprof__puts( w, bFirst ? "\n" : ",\n" );
+		bFirst = 0;
+
+		axprof__puts( w, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" );
+		axprof__put_u64( w, t->uIndex );
+		axprof__puts( w, ",\"args\":{\"name\":" );
+		if( t->szName[0] != '\0' ) {
+			axprof__put_json_str( w, t->szName );
+		} else {
+			axprof__puts( w, "\"thread " );
+			axprof__put_u64( w, t->uIndex );
+			axprof__putc( w, '\"' );
+		}
+		axprof__puts( w, ",\"worker\":" );
+		axprof__put_u64( w, t->uWorkerId );
+		axprof__puts( w, "}}" );
+
+		axprof__export_thread( w, t, &bFirst );
+	}
+
+	axprof__puts( w, "\n]}\n" );
+	axprof__flush( w );
+
+	bOk = !w->bFailed;
+	axprof_free( ( void * )w );
+
+	return bOk;
+}
+#else
+;
+#endif
+
+#if AXPROF_IMPLEMENT
+static int AXPROF_CALL axprof__write_file_f( void *pUser, const char *pData, axprof_u32_t cBytes )
+{
+	return fwrite( ( const void * )pData, 1, cBytes, ( FILE * )pUser ) == cBytes;
+}
+#endif
+
+AXPROF_FUNC int AXPROF_CALL axprof_export_chrome_file( const char *pszFilename )
+#if AXPROF_IMPLEMENT
+{
+	FILE *fp;
+	int bOk;
+
+# if defined( _MSC_VER ) && defined( __STDC_WANT_SECURE_LIB__ )
+	if( fopen_s( &fp, pszFilename, "wb" ) != 0 ) {
+		fp = ( FILE * )0;
+	}
+# else
+	fp = fopen( pszFilename, "wb" );
+# endif
+	if( !fp ) {
+		return 0;
+	}
+
+	bOk = axprof_export_chrome( &axprof__write_file_f, ( void * )fp );
+	if( fclose( fp ) != 0 ) {
+		bOk = 0;
+	}
+
+	return bOk;
+}
+#else
+;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+namespace ax
+{
+
+	/*! \brief Records a zone from its construction until its destruction.
+	 *
+	 *  Use `AXPROF_SCOPE()` rather than naming one of these directly.
+	 */
+	class CProfileScope
+	{
+	public:
+		inline CProfileScope( const axprof_zone_t *pZone )
+		: m_pZone( pZone )
+		, m_uBegin( axprof_ticks() )
+		{
+		}
+		inline ~CProfileScope()
+		{
+			axprof_end( m_pZone, m_uBegin );
+		}
+
+	private:
+		const axprof_zone_t *       m_pZone;
+		axprof_u64_t                m_uBegin;
+
+		CProfileScope( const CProfileScope & );
+		CProfileScope &operator=( const CProfileScope & );
+	};
+
+# if defined( INCGUARD_AX_MEMORY_H_ ) && AXMM_CXX_ENABLED && AXMM_LISTENERS_ENABLED
+	/*! \brief Records allocations and frees on the profiler's timeline.
+	 *
+	 *  Each is an instant event on the calling thread's track carrying the
+	 *  size, and updates a "heap" counter track with the bytes allocated
+	 *  since this listener was added. Frees only count if the allocator
+	 *  reports their size.
+	 */
+	class CProfileAllocListener: public IAllocatorListener
+	{
+	public:
+		inline CProfileAllocListener()
+		: IAllocatorListener()
+		, m_cLiveBytes( 0 )
+		{
+		}
+		virtual ~CProfileAllocListener()
+		{
+		}
+
+		virtual void preAlloc( const AllocDetails & )
+		{
+		}
+		virtual void postAlloc( const AllocDetails &details )
+		{
+			static const axprof_zone_t zone = { "alloc", __FILE__, __LINE__, axprof_kind_alloc };
+
+			if( !details.pBytes ) {
+				return;
+			}
+
+			const axprof_u64_t t = axprof_ticks();
+			const axprof_u64_t cLive = AX_ATOMIC_FETCH_ADD_FULL64( &m_cLiveBytes, ( axth_u64_t )details.cBytes ) + details.cBytes;
+			axprof__record( &zone, t, cLive, details.cBytes );
+		}
+
+		virtual void preFree( const FreeDetails & )
+		{
+		}
+		virtual void postFree( const FreeDetails &details )
+		{
+			static const axprof_zone_t zone = { "free", __FILE__, __LINE__, axprof_kind_free };
+
+			if( !details.pBytes ) {
+				return;
+			}
+
+			const axprof_u64_t t = axprof_ticks();
+			const axprof_u64_t cLive = AX_ATOMIC_FETCH_SUB_FULL64( &m_cLiveBytes, ( axth_u64_t )details.cBytes ) - details.cBytes;
+			axprof__record( &zone, t, cLive, details.cBytes );
+		}
+
+	private:
+		volatile axth_u64_t         m_cLiveBytes;
+	};
+# endif
+
+}
+
+# if AXPROF_ENABLED
+#  define AXPROF_SCOPE(Name_)\
+	static const axprof_zone_t AXPROF__JOIN(axprof__zone,__LINE__) = { (Name_), __FILE__, __LINE__, axprof_kind_zone };\
+	const ax::CProfileScope AXPROF__JOIN(axprof__scope,__LINE__)( &AXPROF__JOIN(axprof__zone,__LINE__) )
+#  define AXPROF_SCOPE_FUNC()       AXPROF_SCOPE( __FUNCTION__ )
+# else
+#  define AXPROF_SCOPE(Name_)
+#  define AXPROF_SCOPE_FUNC()
+# endif
+#endif
+
+#endif
@@ -27,6 +27,23 @@
 	for implementation. If set to 1 then then the standard c string routines
 	will be used internally. Otherwise, a naive implementation will be used.
 
+	AXSTR_SIMD_ENABLED controls whether the scanning routines (axstr_len,
+	axstr_findchr, axstr_findstrn, axstr_casecmpn, axstr_skip_whitespace and
+	axstr_skip_line, and their ranged variants) use vector instructions. The
+	instruction set is picked at compile time: AVX2 if the compiler targets it,
+	otherwise SSE2 on x86/x64 and NEON on AArch64. It defaults to
+	AX_INTRINSICS_ENABLED from ax_platform, or 1. Routines that the C library
+	provides are still taken from there when AXSTR_STDSTR_ENABLED is 1.
+
+	AXSTR_SIMD_DISPATCH_ENABLED, if set to 1 on an SSE2 build, additionally
+	compiles AVX2 versions of the length and character search kernels and picks
+	between them on first use based on what the CPU supports. Defaults to 0.
+
+	axstr_validate_utf8_n checks whole blocks with table lookups when byte
+	shuffles are available: AVX2, SSSE3 (when the compiler targets it, or picked
+	at runtime by AXSTR_SIMD_DISPATCH_ENABLED) and NEON. Plain SSE2 builds only
+	skip runs of ASCII that way.
+
 	AXSTR_WINSTR_ENABLED works like AXSTR_STDSTR_ENABLED. If set to 1 it will
 	use certain Windows SafeString functions in places where standard C does not
 	provide the same functionality. This is ignored on non-Windows platforms.
@@ -52,6 +69,22 @@
 	based on the functionality here. All functions in the class are inlined, but
 	the functions they reference (such as axstr_to_uint) aren't.
 
+	AXSTR_MUTSTR_INLINE_BYTES sets how many bytes (including the terminating
+	NUL) each ax::TMutStr can hold without allocating; defaults to 24. Longer
+	strings go through the allocator policy, growing geometrically when
+	appended to. ax::ArenaStr allocates from an ax::StrArena, which releases
+	all of its strings at once.
+
+	axstr_intern_n() stores strings in an intern table (axstr_intern_table_t)
+	and returns a handle (axstr_interned_t) with the length and murmur3 hash
+	precomputed. Each distinct string is stored once per table, so handles can
+	be compared by pointer. ax::InternedStr wraps such a handle for C++.
+	AXSTR_INTERN_THREADSAFE controls whether tables may be used from several
+	threads at once; it requires ax_thread and defaults to 1 when ax_thread is
+	available. AXSTR_INTERN_SHARDS (default 16) sets how many separately
+	locked shards a table has, and AXSTR_INTERN_BLOCK_SIZE (default 16384) the
+	size of the arena blocks strings are copied into.
+
 
 	REPLACE STRING ALLOCATORS
 	=========================
@@ -74,6 +107,13 @@
 	Calls ax_static_assert to verify compile-time assumptions, such as the size
 	of axstr_utf8_t, but only if ax_static_assert is defined.
 
+	ax_thread
+	---------
+	When AXSTR_INTERN_THREADSAFE is 1, intern tables lock their shards with
+	AX_ATOMIC_EXCHANGE_FULL32() and publish new entries with
+	AX_MEMORY_BARRIER(). Only these macros are used, so ax_thread's
+	implementation need not be linked in.
+
 
 	LICENSE
 	=======
@@ -118,6 +158,9 @@
 # if __has_include( "ax_types.h" )
 #  include "ax_types.h"
 # endif
+# if ( !defined( AXSTR_INTERN_THREADSAFE ) || AXSTR_INTERN_THREADSAFE ) && __has_include( "ax_thread.h" )
+#  include "ax_thread.h"
+# endif
 #endif
 
 #ifndef AXSTR_OUT_Z
@@ -188,6 +231,17 @@ ax_static_assert( sizeof( axstr_utf32_t ) == 4, "ax_string: axstr_utf32_t has in
 # define AXSTR_STDSTR_ENABLED       1
 #endif
 
+#ifndef AXSTR_SIMD_ENABLED
+# ifdef AX_INTRINSICS_ENABLED
+#  define AXSTR_SIMD_ENABLED        AX_INTRINSICS_ENABLED
+# else
+#  define AXSTR_SIMD_ENABLED        1
+# endif
+#endif
+#ifndef AXSTR_SIMD_DISPATCH_ENABLED
+# define AXSTR_SIMD_DISPATCH_ENABLED 0
+#endif
+
 #ifndef AXSTR_WINSTR_ENABLED
 # ifndef __GNUC__
 #  define AXSTR_WINSTR_ENABLED      1
@@ -460,6 +514,521 @@ typedef enum
 # endif
 #endif
 
+/* select the vector kernels used by the scanning routines */
+#define AXSTR__SIMD_AVX2            0
+#define AXSTR__SIMD_SSE2            0
+#define AXSTR__SIMD_NEON            0
+#if AXSTR_SIMD_ENABLED && AXSTR_IMPLEMENT
+# if defined( __AVX2__ )
+#  undef  AXSTR__SIMD_AVX2
+#  define AXSTR__SIMD_AVX2          1
+# elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#  undef  AXSTR__SIMD_SSE2
+#  define AXSTR__SIMD_SSE2          1
+# elif ( defined( __ARM_NEON ) && defined( __aarch64__ ) ) || defined( _M_ARM64 )
+#  undef  AXSTR__SIMD_NEON
+#  define AXSTR__SIMD_NEON          1
+# endif
+#endif
+#define AXSTR__SIMD                 ( AXSTR__SIMD_AVX2 | AXSTR__SIMD_SSE2 | AXSTR__SIMD_NEON )
+
+#if AXSTR__SIMD_SSE2 && AXSTR_SIMD_DISPATCH_ENABLED && ( defined( __GNUC__ ) || defined( _MSC_VER ) )
+# define AXSTR__SIMD_DISPATCH       1
+#else
+# define AXSTR__SIMD_DISPATCH       0
+#endif
+#if AXSTR__SIMD_DISPATCH && defined( __GNUC__ )
+# define AXSTR__AVX2_FUNC           __attribute__((target("avx2")))
+# define AXSTR__SSSE3_FUNC          __attribute__((target("ssse3")))
+#else
+# define AXSTR__AVX2_FUNC
+# define AXSTR__SSSE3_FUNC
+#endif
+
+/* the UTF-8 validator needs byte shuffles, which plain SSE2 lacks */
+#if AXSTR__SIMD_AVX2 || AXSTR__SIMD_DISPATCH
+# define AXSTR__UTF8_AVX2           1
+#else
+# define AXSTR__UTF8_AVX2           0
+#endif
+#if AXSTR__SIMD_DISPATCH || ( AXSTR__SIMD_SSE2 && defined( __SSSE3__ ) )
+# define AXSTR__UTF8_SSSE3          1
+#else
+# define AXSTR__UTF8_SSSE3          0
+#endif
+
+#if AXSTR__SIMD
+# if AXSTR__SIMD_NEON
+#  include <arm_neon.h>
+# elif AXSTR__SIMD_AVX2 || AXSTR__SIMD_DISPATCH
+#  include <immintrin.h>
+# elif AXSTR__UTF8_SSSE3
+#  include <tmmintrin.h>
+# else
+#  include <emmintrin.h>
+# endif
+# if defined( _MSC_VER )
+#  include <intrin.h>
+# endif
+
+/*
+ *  The NUL-terminated kernels read whole aligned blocks, which can extend past
+ *  the end of the string (but never into another page). That is fine for the
+ *  hardware but not for AddressSanitizer, so it is told to look away.
+ */
+# if defined( __SANITIZE_ADDRESS__ )
+#  define AXSTR__NO_ASAN            __attribute__((no_sanitize_address))
+# elif defined( __has_feature )
+#  if __has_feature( address_sanitizer )
+#   define AXSTR__NO_ASAN           __attribute__((no_sanitize_address))
+#  endif
+# endif
+# ifndef AXSTR__NO_ASAN
+#  define AXSTR__NO_ASAN
+# endif
+
+/* smallest page size of any supported target; unaligned loads that stay
+   within one page can't fault */
+# define AXSTR__PAGE_BYTES          4096
+
+# if AXSTR__SIMD_AVX2
+typedef __m256i                     axstr__vec_t;
+typedef unsigned int                axstr__vmask_t;
+#  define AXSTR__VBYTES             32
+#  define AXSTR__VSHIFT             0
+#  define AXSTR__VFULL              ( ( axstr__vmask_t )0xFFFFFFFFU )
+#  define AXSTR__VLOAD(P_)          _mm256_load_si256( ( const __m256i * )( P_ ) )
+#  define AXSTR__VLOADU(P_)         _mm256_loadu_si256( ( const __m256i * )( P_ ) )
+#  define AXSTR__VSET(C_)           _mm256_set1_epi8( ( char )( C_ ) )
+#  define AXSTR__VEQ(A_,B_)         _mm256_cmpeq_epi8( (A_), (B_) )
+#  define AXSTR__VLE(A_,B_)         _mm256_cmpeq_epi8( _mm256_subs_epu8( (A_), (B_) ), _mm256_setzero_si256() )
+#  define AXSTR__VAND(A_,B_)        _mm256_and_si256( (A_), (B_) )
+#  define AXSTR__VOR(A_,B_)         _mm256_or_si256( (A_), (B_) )
+#  define AXSTR__VSUB(A_,B_)        _mm256_sub_epi8( (A_), (B_) )
+#  define AXSTR__VMASK(V_)          ( ( axstr__vmask_t )_mm256_movemask_epi8( (V_) ) )
+# elif AXSTR__SIMD_SSE2
+typedef __m128i                     axstr__vec_t;
+typedef unsigned int                axstr__vmask_t;
+#  define AXSTR__VBYTES             16
+#  define AXSTR__VSHIFT             0
+#  define AXSTR__VFULL              ( ( axstr__vmask_t )0xFFFFU )
+#  define AXSTR__VLOAD(P_)          _mm_load_si128( ( const __m128i * )( P_ ) )
+#  define AXSTR__VLOADU(P_)         _mm_loadu_si128( ( const __m128i * )( P_ ) )
+#  define AXSTR__VSET(C_)           _mm_set1_epi8( ( char )( C_ ) )
+#  define AXSTR__VEQ(A_,B_)         _mm_cmpeq_epi8( (A_), (B_) )
+#  define AXSTR__VLE(A_,B_)         _mm_cmpeq_epi8( _mm_subs_epu8( (A_), (B_) ), _mm_setzero_si128() )
+#  define AXSTR__VAND(A_,B_)        _mm_and_si128( (A_), (B_) )
+#  define AXSTR__VOR(A_,B_)         _mm_or_si128( (A_), (B_) )
+#  define AXSTR__VSUB(A_,B_)        _mm_sub_epi8( (A_), (B_) )
+#  define AXSTR__VMASK(V_)          ( ( axstr__vmask_t )_mm_movemask_epi8( (V_) ) )
+# else
+typedef uint8x16_t                  axstr__vec_t;
+typedef uint64_t                    axstr__vmask_t;
+#  define AXSTR__VBYTES             16
+#  define AXSTR__VSHIFT             2
+#  define AXSTR__VFULL              ( ~( axstr__vmask_t )0 )
+#  define AXSTR__VLOAD(P_)          vld1q_u8( ( const uint8_t * )( P_ ) )
+#  define AXSTR__VLOADU(P_)         vld1q_u8( ( const uint8_t * )( P_ ) )
+#  define AXSTR__VSET(C_)           vdupq_n_u8( ( uint8_t )( C_ ) )
+#  define AXSTR__VEQ(A_,B_)         vceqq_u8( (A_), (B_) )
+#  define AXSTR__VLE(A_,B_)         vcleq_u8( (A_), (B_) )
+#  define AXSTR__VAND(A_,B_)        vandq_u8( (A_), (B_) )
+#  define AXSTR__VOR(A_,B_)         vorrq_u8( (A_), (B_) )
+#  define AXSTR__VSUB(A_,B_)        vsubq_u8( (A_), (B_) )
+/* NEON has no movemask; narrowing by four keeps one nibble per byte */
+#  define AXSTR__VMASK(V_)          vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( (V_) ), 4 ) ), 0 )
+# endif
+
+/* mask bits of one byte (masks have 1 << AXSTR__VSHIFT bits per byte) */
+# define AXSTR__VLOWBITS            ( ( ( axstr__vmask_t )1 << ( 1 << AXSTR__VSHIFT ) ) - 1 )
+
+# define AXSTR__VALIGN(P_)\
+	( ( const char * )( ( axstr_size_t )( P_ ) & ~( axstr_size_t )( AXSTR__VBYTES - 1 ) ) )
+# define AXSTR__VCROSSES_PAGE(P_)\
+	( ( ( axstr_size_t )( P_ ) & ( AXSTR__PAGE_BYTES - 1 ) ) > AXSTR__PAGE_BYTES - AXSTR__VBYTES )
+
+/*! \internal
+ *  \brief Index of the first byte flagged in a (nonzero) kernel mask. */
+static axstr_size_t axstr__vfirst( axstr__vmask_t m )
+{
+# if defined( _MSC_VER )
+	unsigned long i;
+
+#  if AXSTR__SIMD_NEON
+	_BitScanForward64( &i, m );
+#  else
+	_BitScanForward( &i, ( unsigned long )m );
+#  endif
+	return ( axstr_size_t )i >> AXSTR__VSHIFT;
+# elif AXSTR__SIMD_NEON
+	return ( axstr_size_t )__builtin_ctzll( m ) >> AXSTR__VSHIFT;
+# else
+	return ( axstr_size_t )__builtin_ctz( m );
+# endif
+}
+
+# if !AXSTR_STDSTR_ENABLED
+/*! \internal
+ *  \brief Find the `NUL` terminator of a string. */
+AXSTR__NO_ASAN static const char *axstr__vlen( const char *p )
+{
+	const axstr__vec_t z = AXSTR__VSET( 0 );
+	const char *a;
+	axstr__vmask_t m;
+
+	a = AXSTR__VALIGN( p );
+	m = AXSTR__VMASK( AXSTR__VEQ( AXSTR__VLOAD( a ), z ) ) & ( AXSTR__VFULL << ( ( axstr_size_t )( p - a ) << AXSTR__VSHIFT ) );
+	while( !m ) {
+		a += AXSTR__VBYTES;
+		m = AXSTR__VMASK( AXSTR__VEQ( AXSTR__VLOAD( a ), z ) );
+	}
+
+	return a + axstr__vfirst( m );
+}
+# endif
+/*! \internal
+ *  \brief Find the first `ch` byte or `NUL` terminator in a string. */
+AXSTR__NO_ASAN static const char *axstr__vchr( const char *p, unsigned char ch )
+{
+	const axstr__vec_t z = AXSTR__VSET( 0 );
+	const axstr__vec_t c = AXSTR__VSET( ch );
+	const char *a;
+	axstr__vec_t v;
+	axstr__vmask_t m;
+
+	a = AXSTR__VALIGN( p );
+	v = AXSTR__VLOAD( a );
+	m = AXSTR__VMASK( AXSTR__VOR( AXSTR__VEQ( v, z ), AXSTR__VEQ( v, c ) ) ) & ( AXSTR__VFULL << ( ( axstr_size_t )( p - a ) << AXSTR__VSHIFT ) );
+	while( !m ) {
+		a += AXSTR__VBYTES;
+		v = AXSTR__VLOAD( a );
+		m = AXSTR__VMASK( AXSTR__VOR( AXSTR__VEQ( v, z ), AXSTR__VEQ( v, c ) ) );
+	}
+
+	return a + axstr__vfirst( m );
+}
+
+# if AXSTR__SIMD_DISPATCH
+#  if !AXSTR_STDSTR_ENABLED
+/*! \internal
+ *  \brief AVX2 version of axstr__vlen() for runtime dispatch. */
+AXSTR__AVX2_FUNC AXSTR__NO_ASAN static const char *axstr__vlen_avx2( const char *p )
+{
+	const __m256i z = _mm256_setzero_si256();
+	const char *a;
+	unsigned int m;
+
+	a = ( const char * )( ( axstr_size_t )p & ~( axstr_size_t )31 );
+	m = ( unsigned int )_mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_load_si256( ( const __m256i * )a ), z ) ) & ( 0xFFFFFFFFU << ( p - a ) );
+	while( !m ) {
+		a += 32;
+		m = ( unsigned int )_mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_load_si256( ( const __m256i * )a ), z ) );
+	}
+
+	return a + axstr__vfirst( m );
+}
+#  endif
+/*! \internal
+ *  \brief AVX2 version of axstr__vchr() for runtime dispatch. */
+AXSTR__AVX2_FUNC AXSTR__NO_ASAN static const char *axstr__vchr_avx2( const char *p, unsigned char ch )
+{
+	const __m256i z = _mm256_setzero_si256();
+	const __m256i c = _mm256_set1_epi8( ( char )ch );
+	const char *a;
+	__m256i v;
+	unsigned int m;
+
+	a = ( const char * )( ( axstr_size_t )p & ~( axstr_size_t )31 );
+	v = _mm256_load_si256( ( const __m256i * )a );
+	m = ( unsigned int )_mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( v, z ), _mm256_cmpeq_epi8( v, c ) ) ) & ( 0xFFFFFFFFU << ( p - a ) );
+	while( !m ) {
+		a += 32;
+		v = _mm256_load_si256( ( const __m256i * )a );
+		m = ( unsigned int )_mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( v, z ), _mm256_cmpeq_epi8( v, c ) ) );
+	}
+
+	return a + axstr__vfirst( m );
+}
+
+/*! \internal
+ *  \brief Whether the CPU and OS support AVX2. */
+static int axstr__has_avx2( void )
+{
+#  if defined( _MSC_VER )
+	int r[ 4 ];
+
+	__cpuid( r, 1 );
+	/* OSXSAVE and AVX, then the OS must save the YMM registers */
+	if( ( r[ 2 ] & 0x18000000 ) != 0x18000000 || ( _xgetbv( 0 ) & 6 ) != 6 ) {
+		return 0;
+	}
+
+	__cpuidex( r, 7, 0 );
+	return ( r[ 1 ] & 0x20 ) != 0;
+#  else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports( "avx2" );
+#  endif
+}
+/*! \internal
+ *  \brief Whether the CPU supports SSSE3. */
+static int axstr__has_ssse3( void )
+{
+#  if defined( _MSC_VER )
+	int r[ 4 ];
+
+	__cpuid( r, 1 );
+	return ( r[ 2 ] & 0x200 ) != 0;
+#  else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports( "ssse3" );
+#  endif
+}
+
+typedef const char *( *axstr__vlen_fn_t )( const char * );
+typedef const char *( *axstr__vchr_fn_t )( const char *, unsigned char );
+
+#  if !AXSTR_STDSTR_ENABLED
+static axstr__vlen_fn_t axstr__g_pfnVLen = ( axstr__vlen_fn_t )0;
+#  endif
+static axstr__vchr_fn_t axstr__g_pfnVChr = ( axstr__vchr_fn_t )0;
+
+/*! \internal
+ *  \brief Pick the kernels for this CPU. Racing threads store the same
+ *         values, so this needs no synchronization. */
+static void axstr__vdispatch( void )
+{
+	const int bAVX2 = axstr__has_avx2();
+
+#  if !AXSTR_STDSTR_ENABLED
+	axstr__g_pfnVLen = bAVX2 ? &axstr__vlen_avx2 : &axstr__vlen;
+#  endif
+	axstr__g_pfnVChr = bAVX2 ? &axstr__vchr_avx2 : &axstr__vchr;
+}
+#  if !AXSTR_STDSTR_ENABLED
+static const char *axstr__len_kernel( const char *p )
+{
+	if( !axstr__g_pfnVLen ) {
+		axstr__vdispatch();
+	}
+
+	return axstr__g_pfnVLen( p );
+}
+#  endif
+static const char *axstr__chr_kernel( const char *p, unsigned char ch )
+{
+	if( !axstr__g_pfnVChr ) {
+		axstr__vdispatch();
+	}
+
+	return axstr__g_pfnVChr( p, ch );
+}
+# else
+#  define axstr__len_kernel         axstr__vlen
+#  define axstr__chr_kernel         axstr__vchr
+# endif
+
+/*! \internal
+ *  \brief Whether `n` bytes at `p` match `pszFind`, stopping at a `NUL` in
+ *         `p`. (`pszFind` must not contain `NUL` within `n` bytes.) */
+static int axstr__vmatch( const char *p, const char *pszFind, axstr_size_t n )
+{
+	axstr_size_t i;
+
+	for( i = 0; i < n; ++i ) {
+		if( p[ i ] != pszFind[ i ] ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+/*! \internal
+ *  \brief Find `n` (at least two) bytes of `pszFind` in a string.
+ *
+ *  Candidates are filtered by comparing the first byte of `pszFind`, and the
+ *  byte `k` further in, against a whole block of positions at once. Only the
+ *  positions where both match get compared in full.
+ */
+AXSTR__NO_ASAN static const char *axstr__vstr( const char *p, const char *pszFind, axstr_size_t n )
+{
+	const axstr__vec_t z = AXSTR__VSET( 0 );
+	const axstr__vec_t f = AXSTR__VSET( pszFind[ 0 ] );
+	const axstr_size_t k = n - 1 < AXSTR__VBYTES ? n - 1 : AXSTR__VBYTES;
+	const axstr__vec_t g = AXSTR__VSET( pszFind[ k ] );
+	const char *a;
+	axstr__vec_t v;
+	axstr__vmask_t keep, m;
+	axstr_size_t i;
+
+	a = AXSTR__VALIGN( p );
+	keep = AXSTR__VFULL << ( ( axstr_size_t )( p - a ) << AXSTR__VSHIFT );
+	for(;;) {
+		v = AXSTR__VLOAD( a );
+
+		/* the string ends in this block, so the second load could run past
+		   the readable memory; finish one byte at a time */
+		if( AXSTR__VMASK( AXSTR__VEQ( v, z ) ) & keep ) {
+			for( a = p > a ? p : a; *a != '\0'; ++a ) {
+				if( *a == pszFind[ 0 ] && axstr__vmatch( a, pszFind, n ) ) {
+					return a;
+				}
+			}
+
+			return ( const char * )0;
+		}
+
+		/* no NUL in this block means the next block is readable too, and
+		   k <= AXSTR__VBYTES keeps the second load within it */
+		m = AXSTR__VMASK( AXSTR__VAND( AXSTR__VEQ( v, f ), AXSTR__VEQ( AXSTR__VLOADU( a + k ), g ) ) ) & keep;
+		while( m != 0 ) {
+			i = axstr__vfirst( m );
+			if( axstr__vmatch( a + i, pszFind, n ) ) {
+				return a + i;
+			}
+
+			m &= ~( AXSTR__VLOWBITS << ( i << AXSTR__VSHIFT ) );
+		}
+
+		a += AXSTR__VBYTES;
+		keep = AXSTR__VFULL;
+	}
+}
+# if !AXSTR_STDSTR_ENABLED
+/*! \internal
+ *  \brief Whether the next block of two strings is equal ignoring ASCII case
+ *         and holds no `NUL`. The caller checks that neither load crosses a
+ *         page. */
+AXSTR__NO_ASAN static int axstr__vcaseeq( const char *p, const char *q )
+{
+	const axstr__vec_t z  = AXSTR__VSET( 0 );
+	const axstr__vec_t ca = AXSTR__VSET( 'A' );
+	const axstr__vec_t cn = AXSTR__VSET( 'Z' - 'A' );
+	const axstr__vec_t lc = AXSTR__VSET( 0x20 );
+	axstr__vec_t x, y;
+
+	x = AXSTR__VLOADU( p );
+	y = AXSTR__VLOADU( q );
+	if( AXSTR__VMASK( AXSTR__VEQ( x, z ) ) != 0 ) {
+		return 0;
+	}
+
+	x = AXSTR__VOR( x, AXSTR__VAND( AXSTR__VLE( AXSTR__VSUB( x, ca ), cn ), lc ) );
+	y = AXSTR__VOR( y, AXSTR__VAND( AXSTR__VLE( AXSTR__VSUB( y, ca ), cn ), lc ) );
+	return AXSTR__VMASK( AXSTR__VEQ( x, y ) ) == AXSTR__VFULL;
+}
+# endif
+/*! \internal
+ *  \brief Count the leading ASCII bytes before any `NUL` in the next block of
+ *         a string. The caller checks that the load doesn't cross a page. */
+AXSTR__NO_ASAN static axstr_size_t axstr__vascii( const char *p )
+{
+	const axstr__vec_t z = AXSTR__VSET( 0 );
+	const axstr__vec_t h = AXSTR__VSET( 0x80 );
+	axstr__vec_t v;
+	axstr__vmask_t m;
+
+	v = AXSTR__VLOADU( p );
+	m = AXSTR__VMASK( AXSTR__VOR( AXSTR__VEQ( v, z ), AXSTR__VLE( h, v ) ) );
+	return m != 0 ? axstr__vfirst( m ) : AXSTR__VBYTES;
+}
+/*! \internal
+ *  \brief Find the first byte that is not whitespace (`> ' '`), or the `NUL`
+ *         terminator, in a string. */
+AXSTR__NO_ASAN static const char *axstr__vwhite( const char *p )
+{
+	const axstr__vec_t z = AXSTR__VSET( 0 );
+	const axstr__vec_t w = AXSTR__VSET( ' ' );
+	const char *a;
+	axstr__vec_t v;
+	axstr__vmask_t m;
+
+	a = AXSTR__VALIGN( p );
+	v = AXSTR__VLOAD( a );
+	m = ( ( AXSTR__VMASK( AXSTR__VLE( v, w ) ) ^ AXSTR__VFULL ) | AXSTR__VMASK( AXSTR__VEQ( v, z ) ) ) & ( AXSTR__VFULL << ( ( axstr_size_t )( p - a ) << AXSTR__VSHIFT ) );
+	while( !m ) {
+		a += AXSTR__VBYTES;
+		v = AXSTR__VLOAD( a );
+		m = ( AXSTR__VMASK( AXSTR__VLE( v, w ) ) ^ AXSTR__VFULL ) | AXSTR__VMASK( AXSTR__VEQ( v, z ) );
+	}
+
+	return a + axstr__vfirst( m );
+}
+/*! \internal
+ *  \brief Find the first byte in `[p,e)` that is not whitespace (`> ' '`) or
+ *         is `NUL`, or return `e`. */
+static const char *axstr__vwhite_e( const char *p, const char *e )
+{
+	const axstr__vec_t z = AXSTR__VSET( 0 );
+	const axstr__vec_t w = AXSTR__VSET( ' ' );
+	axstr__vec_t v;
+	axstr__vmask_t m;
+
+	while( e - p >= AXSTR__VBYTES ) {
+		v = AXSTR__VLOADU( p );
+		m = ( AXSTR__VMASK( AXSTR__VLE( v, w ) ) ^ AXSTR__VFULL ) | AXSTR__VMASK( AXSTR__VEQ( v, z ) );
+		if( m != 0 ) {
+			return p + axstr__vfirst( m );
+		}
+
+		p += AXSTR__VBYTES;
+	}
+
+	while( p < e && *( const unsigned char * )p <= ' ' && *p != '\0' ) {
+		++p;
+	}
+
+	return p;
+}
+/*! \internal
+ *  \brief Find the first `\r`, `\n` or `NUL` in a string. */
+AXSTR__NO_ASAN static const char *axstr__veol( const char *p )
+{
+	const axstr__vec_t z  = AXSTR__VSET( 0 );
+	const axstr__vec_t cr = AXSTR__VSET( '\r' );
+	const axstr__vec_t lf = AXSTR__VSET( '\n' );
+	const char *a;
+	axstr__vec_t v;
+	axstr__vmask_t m;
+
+	a = AXSTR__VALIGN( p );
+	v = AXSTR__VLOAD( a );
+	m = AXSTR__VMASK( AXSTR__VOR( AXSTR__VEQ( v, z ), AXSTR__VOR( AXSTR__VEQ( v, cr ), AXSTR__VEQ( v, lf ) ) ) ) & ( AXSTR__VFULL << ( ( axstr_size_t )( p - a ) << AXSTR__VSHIFT ) );
+	while( !m ) {
+		a += AXSTR__VBYTES;
+		v = AXSTR__VLOAD( a );
+		m = AXSTR__VMASK( AXSTR__VOR( AXSTR__VEQ( v, z ), AXSTR__VOR( AXSTR__VEQ( v, cr ), AXSTR__VEQ( v, lf ) ) ) );
+	}
+
+	return a + axstr__vfirst( m );
+}
+/*! \internal
+ *  \brief Find the first `\r` or `\n` in `[p,e)`, or return `e`. */
+static const char *axstr__veol_e( const char *p, const char *e )
+{
+	const axstr__vec_t cr = AXSTR__VSET( '\r' );
+	const axstr__vec_t lf = AXSTR__VSET( '\n' );
+	axstr__vec_t v;
+	axstr__vmask_t m;
+
+	while( e - p >= AXSTR__VBYTES ) {
+		v = AXSTR__VLOADU( p );
+		m = AXSTR__VMASK( AXSTR__VOR( AXSTR__VEQ( v, cr ), AXSTR__VEQ( v, lf ) ) );
+		if( m != 0 ) {
+			return p + axstr__vfirst( m );
+		}
+
+		p += AXSTR__VBYTES;
+	}
+
+	while( p < e && *p != '\r' && *p != '\n' ) {
+		++p;
+	}
+
+	return p;
+}
+#endif /*AXSTR__SIMD*/
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -662,10 +1231,26 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_casecmpn( const char *pszFirst, const c
 #  endif
 # else
 	axstr_size_t i;
+#  if AXSTR__SIMD
+	int bVector;
+
+	bVector = 1;
+#  endif
 
 	i = 0;
 
 	while( i < cBytes ) {
+#  if AXSTR__SIMD
+		/* whole blocks at once, until one holds a difference or the end */
+		if( bVector && cBytes - i >= AXSTR__VBYTES && !AXSTR__VCROSSES_PAGE( pszFirst + i ) && !AXSTR__VCROSSES_PAGE( pszSecond + i ) ) {
+			if( axstr__vcaseeq( pszFirst + i, pszSecond + i ) ) {
+				i += AXSTR__VBYTES;
+				continue;
+			}
+
+			bVector = 0;
+		}
+#  endif
 		if( pszFirst[ i ] != pszSecond[ i ] ) {
 			char c, d;
 
@@ -992,6 +1577,8 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_len( const char *pszSource )
 {
 # if AXSTR_STDSTR_ENABLED
 	return !pszSource ? 0 : strlen( pszSource );
+# elif AXSTR__SIMD
+	return !pszSource ? 0 : ( axstr_size_t )( axstr__len_kernel( pszSource ) - pszSource );
 # else
 	const char *p;
 
@@ -1033,6 +1620,16 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_chlen( const char *pszSource )
 	while( *p != '\0' ) {
 		const axstr_utf8_t *q;
 
+# if AXSTR__SIMD
+		/* ASCII is one codepoint per byte */
+		if( *p < 0x80 && !AXSTR__VCROSSES_PAGE( p ) ) {
+			q = p + axstr__vascii( ( const char * )p );
+			n += ( axstr_size_t )( q - p );
+			p = q;
+			continue;
+		}
+# endif
+
 		++n;
 		if( ( *p & 0xF0 ) == 0xF0 ) {
 			q = p + 4;
@@ -1747,7 +2344,7 @@ AXSTR_FUNC axstr_utf32_t AXSTR_CALL axstr_step_utf16_decode( const axstr_utf16_t
 AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_step_utf8_encode( axstr_utf8_t **ppUTF8Dst, axstr_utf8_t *pUTF8DstEnd, axstr_utf32_t uCodepoint )
 #if AXSTR_IMPLEMENT
 {
-	if( uCodepoint > 0x10000 ) {
+	if( uCodepoint >= 0x10000 ) {
 		if( *ppUTF8Dst + 4 >= pUTF8DstEnd ) {
 			return 0;
 		}
@@ -1812,7 +2409,7 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_step_utf16_encode( axstr_utf16_t **ppUT
 			return 0;
 		}
 
-		( *ppUTF16Dst )[0] = 0xD800 | ( axstr_utf16_t )( ( uCodepoint >> 10 ) & 0x3FF );
+		( *ppUTF16Dst )[0] = 0xD800 | ( axstr_utf16_t )( ( ( uCodepoint - 0x10000 ) >> 10 ) & 0x3FF );
 		( *ppUTF16Dst )[1] = 0xDC00 | ( axstr_utf16_t )( ( uCodepoint >>  0 ) & 0x3FF );
 
 		*ppUTF16Dst += 2;
@@ -1832,74 +2429,682 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_step_utf16_encode( axstr_utf16_t **ppUT
 ;
 #endif
 
-/*!
- * \brief Convert a chunk of UTF-8 data to UTF-16 data, returning the number of
- *        codepoints written.
- *
- * This assumes the byte-order of the host machine.
- */
-AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_counted_utf8_to_utf16( axstr_utf16_t *pUTF16Dst, axstr_size_t cMaxDstUTF16Chars, const axstr_utf8_t *pUTF8Src )
 #if AXSTR_IMPLEMENT
+/*! \internal
+ *  \brief Find the first byte in `[p,e)` that isn't ASCII, or return `e`. */
+static const axstr_utf8_t *axstr__ascii_run8( const axstr_utf8_t *p, const axstr_utf8_t *e )
 {
-	axstr_utf16_t *dstp;
-	axstr_utf16_t *dste;
-	const axstr_utf8_t *srcp;
-	const axstr_utf8_t *srce;
+# if AXSTR__SIMD
+	const axstr__vec_t h = AXSTR__VSET( 0x80 );
+	axstr__vmask_t m;
 
-	dstp = pUTF16Dst;
-	dste = dstp + cMaxDstUTF16Chars;
-	srcp = pUTF8Src;
-	srce = ( const axstr_utf8_t * )( ~( axstr_size_t )0 );
+	while( e - p >= AXSTR__VBYTES ) {
+		m = AXSTR__VMASK( AXSTR__VLE( h, AXSTR__VLOADU( p ) ) );
+		if( m != 0 ) {
+			return p + axstr__vfirst( m );
+		}
 
-	while( *srcp != '\0' ) {
-		axstr_utf32_t uCodepoint;
+		p += AXSTR__VBYTES;
+	}
+# endif
 
-		uCodepoint = axstr_step_utf8_decode( &srcp, srce );
-		if( !axstr_step_utf16_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	while( p < e && *p < 0x80 ) {
+		++p;
 	}
 
-	*dstp = ( axstr_utf16_t )'\0';
-	return ( axstr_size_t )( dstp - pUTF16Dst );
+	return p;
 }
-#else
-;
-#endif
-/*!
- * \brief Convert a chunk of UTF-8 data to UTF-16 data, returning the number of
- *        codepoints written.
- *
- * This assumes the byte-order of the host machine.
- */
-AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_counted_utf8_to_utf16_n( axstr_utf16_t *pUTF16Dst, axstr_size_t cMaxDstUTF16Chars, const axstr_utf8_t *pUTF8Src, const axstr_utf8_t *pUTF8SrcEnd )
-#if AXSTR_IMPLEMENT
+/*! \internal
+ *  \brief Find the first unit in `[p,e)` that isn't ASCII, or return `e`. */
+static const axstr_utf16_t *axstr__ascii_run16( const axstr_utf16_t *p, const axstr_utf16_t *e )
 {
-	axstr_utf16_t *dstp;
-	axstr_utf16_t *dste;
-	const axstr_utf8_t *srcp;
-	const axstr_utf8_t *srce;
-
-	dstp = pUTF16Dst;
-	dste = dstp + cMaxDstUTF16Chars;
-	srcp = pUTF8Src;
-	srce = pUTF8SrcEnd;
+# if AXSTR__SIMD_AVX2 || AXSTR__SIMD_SSE2
+	const __m128i z = _mm_setzero_si128();
+	const __m128i h = _mm_set1_epi16( ( short )0xFF80 );
 
-	while( srcp < srce ) {
-		axstr_utf32_t uCodepoint;
+	while( e - p >= 8 ) {
+		if( _mm_movemask_epi8( _mm_cmpeq_epi16( _mm_and_si128( _mm_loadu_si128( ( const __m128i * )p ), h ), z ) ) != 0xFFFF ) {
+			break;
+		}
 
-		uCodepoint = axstr_step_utf8_decode( &srcp, srce );
-		if( !axstr_step_utf16_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
+		p += 8;
+	}
+# elif AXSTR__SIMD_NEON
+	while( e - p >= 8 ) {
+		if( vmaxvq_u16( vld1q_u16( ( const uint16_t * )p ) ) >= 0x80 ) {
+			break;
 		}
+
+		p += 8;
 	}
+# endif
 
-	*dstp = ( axstr_utf16_t )'\0';
-	return ( axstr_size_t )( dstp - pUTF16Dst );
+	while( p < e && *p < 0x80 ) {
+		++p;
+	}
+
+	return p;
 }
-#else
-;
-#endif
+/*! \internal
+ *  \brief Widen `n` ASCII bytes to UTF-16. */
+static void axstr__widen_ascii( axstr_utf16_t *d, const axstr_utf8_t *s, axstr_size_t n )
+{
+	axstr_size_t i;
+
+	i = 0;
+# if AXSTR__SIMD_AVX2 || AXSTR__SIMD_SSE2
+	for( ; n - i >= 16; i += 16 ) {
+		const __m128i z = _mm_setzero_si128();
+		const __m128i v = _mm_loadu_si128( ( const __m128i * )( s + i ) );
+
+		_mm_storeu_si128( ( __m128i * )( d + i + 0 ), _mm_unpacklo_epi8( v, z ) );
+		_mm_storeu_si128( ( __m128i * )( d + i + 8 ), _mm_unpackhi_epi8( v, z ) );
+	}
+# elif AXSTR__SIMD_NEON
+	for( ; n - i >= 16; i += 16 ) {
+		const uint8x16_t v = vld1q_u8( ( const uint8_t * )( s + i ) );
+
+		vst1q_u16( ( uint16_t * )( d + i + 0 ), vmovl_u8( vget_low_u8( v ) ) );
+		vst1q_u16( ( uint16_t * )( d + i + 8 ), vmovl_high_u8( v ) );
+	}
+# endif
+	for( ; i < n; ++i ) {
+		d[ i ] = ( axstr_utf16_t )s[ i ];
+	}
+}
+/*! \internal
+ *  \brief Narrow `n` ASCII UTF-16 units to bytes. */
+static void axstr__narrow_ascii( axstr_utf8_t *d, const axstr_utf16_t *s, axstr_size_t n )
+{
+	axstr_size_t i;
+
+	i = 0;
+# if AXSTR__SIMD_AVX2 || AXSTR__SIMD_SSE2
+	for( ; n - i >= 16; i += 16 ) {
+		const __m128i a = _mm_loadu_si128( ( const __m128i * )( s + i + 0 ) );
+		const __m128i b = _mm_loadu_si128( ( const __m128i * )( s + i + 8 ) );
+
+		_mm_storeu_si128( ( __m128i * )( d + i ), _mm_packus_epi16( a, b ) );
+	}
+# elif AXSTR__SIMD_NEON
+	for( ; n - i >= 16; i += 16 ) {
+		const uint16x8_t a = vld1q_u16( ( const uint16_t * )( s + i + 0 ) );
+		const uint16x8_t b = vld1q_u16( ( const uint16_t * )( s + i + 8 ) );
+
+		vst1q_u8( ( uint8_t * )( d + i ), vcombine_u8( vmovn_u16( a ), vmovn_u16( b ) ) );
+	}
+# endif
+	for( ; i < n; ++i ) {
+		d[ i ] = ( axstr_utf8_t )s[ i ];
+	}
+}
+/*! \internal
+ *  \brief Length of a `NUL`-terminated UTF-16 string, in units. */
+static axstr_size_t axstr__utf16_len( const axstr_utf16_t *p )
+{
+	const axstr_utf16_t *s;
+
+	for( s = p; *p != 0; ++p ) {
+	}
+
+	return ( axstr_size_t )( p - s );
+}
+
+/*! \internal
+ *  \brief Convert UTF-8 in `[p,e)` to UTF-16 at `*ppDst`, keeping one unit
+ *         free for a terminator.
+ *
+ *  Runs of ASCII are copied a block at a time, everything else goes through
+ *  the step functions. On overflow `*ppDst` is left after the last unit that
+ *  fit and `0` is returned.
+ */
+static axstr_bool_t axstr__utf8_to_utf16_e( axstr_utf16_t **ppDst, axstr_utf16_t *pDstEnd, const axstr_utf8_t *p, const axstr_utf8_t *e )
+{
+	const axstr_utf8_t *q;
+	axstr_utf16_t *d;
+	axstr_size_t n;
+
+	d = *ppDst;
+	while( p < e ) {
+		q = axstr__ascii_run8( p, e );
+		if( q != p ) {
+			n = ( axstr_size_t )( q - p );
+			if( n >= ( axstr_size_t )( pDstEnd - d ) ) {
+				n = pDstEnd > d ? ( axstr_size_t )( pDstEnd - d ) - 1 : 0;
+				axstr__widen_ascii( d, p, n );
+				*ppDst = d + n;
+				return 0;
+			}
+
+			axstr__widen_ascii( d, p, n );
+			d += n;
+			p = q;
+			continue;
+		}
+
+		if( !axstr_step_utf16_encode( &d, pDstEnd, axstr_step_utf8_decode( &p, e ) ) ) {
+			*ppDst = d;
+			return 0;
+		}
+	}
+
+	*ppDst = d;
+	return 1;
+}
+/*! \internal
+ *  \brief Convert UTF-16 in `[p,e)` to UTF-8 at `*ppDst`, keeping one byte
+ *         free for a terminator. (See axstr__utf8_to_utf16_e().) */
+static axstr_bool_t axstr__utf16_to_utf8_e( axstr_utf8_t **ppDst, axstr_utf8_t *pDstEnd, const axstr_utf16_t *p, const axstr_utf16_t *e )
+{
+	const axstr_utf16_t *q;
+	axstr_utf8_t *d;
+	axstr_size_t n;
+
+	d = *ppDst;
+	while( p < e ) {
+		q = axstr__ascii_run16( p, e );
+		if( q != p ) {
+			n = ( axstr_size_t )( q - p );
+			if( n >= ( axstr_size_t )( pDstEnd - d ) ) {
+				n = pDstEnd > d ? ( axstr_size_t )( pDstEnd - d ) - 1 : 0;
+				axstr__narrow_ascii( d, p, n );
+				*ppDst = d + n;
+				return 0;
+			}
+
+			axstr__narrow_ascii( d, p, n );
+			d += n;
+			p = q;
+			continue;
+		}
+
+		if( !axstr_step_utf8_encode( &d, pDstEnd, axstr_step_utf16_decode( &p, e ) ) ) {
+			*ppDst = d;
+			return 0;
+		}
+	}
+
+	*ppDst = d;
+	return 1;
+}
+#endif
+
+/*!
+ * \brief Count the UTF-16 units that converting a chunk of UTF-8 data
+ *        produces, not counting the `NUL` terminator.
+ *
+ * This matches what axstr_utf8_to_utf16_n() writes, so a buffer of one more
+ * unit than this is always large enough.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_utf8_to_utf16_len_n( const axstr_utf8_t *pUTF8Src, const axstr_utf8_t *pUTF8SrcEnd )
+#if AXSTR_IMPLEMENT
+{
+	const axstr_utf8_t *p;
+	const axstr_utf8_t *q;
+	axstr_size_t n;
+
+	n = 0;
+	p = pUTF8Src;
+	while( p < pUTF8SrcEnd ) {
+		q = axstr__ascii_run8( p, pUTF8SrcEnd );
+		n += ( axstr_size_t )( q - p );
+		p = q;
+
+		if( p < pUTF8SrcEnd ) {
+			n += axstr_step_utf8_decode( &p, pUTF8SrcEnd ) >= 0x10000 ? 2 : 1;
+		}
+	}
+
+	return n;
+}
+#else
+;
+#endif
+/*!
+ * \brief Count the UTF-16 units that converting a `NUL`-terminated UTF-8
+ *        string produces, not counting the `NUL` terminator.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_utf8_to_utf16_len( const axstr_utf8_t *pUTF8Src )
+#if AXSTR_IMPLEMENT
+{
+	return axstr_utf8_to_utf16_len_n( pUTF8Src, pUTF8Src + axstr_len( ( const char * )pUTF8Src ) );
+}
+#else
+;
+#endif
+/*!
+ * \brief Count the bytes that converting a chunk of UTF-16 data to UTF-8
+ *        produces, not counting the `NUL` terminator.
+ *
+ * This matches what axstr_utf16_to_utf8_n() writes, so a buffer of one more
+ * byte than this is always large enough.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_utf16_to_utf8_len_n( const axstr_utf16_t *pUTF16Src, const axstr_utf16_t *pUTF16SrcEnd )
+#if AXSTR_IMPLEMENT
+{
+	const axstr_utf16_t *p;
+	const axstr_utf16_t *q;
+	axstr_utf32_t uCodepoint;
+	axstr_size_t n;
+
+	n = 0;
+	p = pUTF16Src;
+	while( p < pUTF16SrcEnd ) {
+		q = axstr__ascii_run16( p, pUTF16SrcEnd );
+		n += ( axstr_size_t )( q - p );
+		p = q;
+
+		if( p < pUTF16SrcEnd ) {
+			uCodepoint = axstr_step_utf16_decode( &p, pUTF16SrcEnd );
+			n += uCodepoint < 0x80 ? 1 : uCodepoint < 0x800 ? 2 : uCodepoint < 0x10000 ? 3 : 4;
+		}
+	}
+
+	return n;
+}
+#else
+;
+#endif
+/*!
+ * \brief Count the bytes that converting a `NUL`-terminated UTF-16 string to
+ *        UTF-8 produces, not counting the `NUL` terminator.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_utf16_to_utf8_len( const axstr_utf16_t *pUTF16Src )
+#if AXSTR_IMPLEMENT
+{
+	return axstr_utf16_to_utf8_len_n( pUTF16Src, pUTF16Src + axstr__utf16_len( pUTF16Src ) );
+}
+#else
+;
+#endif
+
+#if AXSTR_IMPLEMENT && ( AXSTR__UTF8_AVX2 || AXSTR__UTF8_SSSE3 || AXSTR__SIMD_NEON )
+/*
+ *  Block validation after Keiser and Lemire, "Validating UTF-8 in less than
+ *  one instruction per byte". Each byte is classified together with the byte
+ *  before it through three 16-entry tables (high and low nibble of the earlier
+ *  byte, high nibble of the later one); the bits that survive ANDing the three
+ *  lookups name an error. Third and fourth bytes of a sequence are checked
+ *  separately against the lead two and three bytes back.
+ */
+# define AXSTR__U8_TOO_SHORT        0x01 /* lead not followed by a continuation */
+# define AXSTR__U8_TOO_LONG         0x02 /* ASCII followed by a continuation */
+# define AXSTR__U8_OVERLONG_3       0x04 /* E0 80..9F */
+# define AXSTR__U8_TOO_LARGE        0x08 /* F4 90..BF, or F5..FF */
+# define AXSTR__U8_SURROGATE        0x10 /* ED A0..BF */
+# define AXSTR__U8_OVERLONG_2       0x20 /* C0 or C1 */
+# define AXSTR__U8_TOO_LARGE_1000   0x40 /* F5..FF 80..8F */
+# define AXSTR__U8_OVERLONG_4       0x40 /* F0 80..8F */
+# define AXSTR__U8_TWO_CONTS        0x80 /* continuation after continuation */
+# define AXSTR__U8_CARRY            ( AXSTR__U8_TOO_SHORT | AXSTR__U8_TOO_LONG | AXSTR__U8_TWO_CONTS )
+
+/* rows: high nibble of the first byte, low nibble of the first byte, high
+   nibble of the second byte, and the bytes that can't end a block */
+static const axstr_utf8_t axstr__g_utf8_lut[ 4 ][ 16 ] = {
+	{
+		AXSTR__U8_TOO_LONG, AXSTR__U8_TOO_LONG, AXSTR__U8_TOO_LONG, AXSTR__U8_TOO_LONG,
+		AXSTR__U8_TOO_LONG, AXSTR__U8_TOO_LONG, AXSTR__U8_TOO_LONG, AXSTR__U8_TOO_LONG,
+		AXSTR__U8_TWO_CONTS, AXSTR__U8_TWO_CONTS, AXSTR__U8_TWO_CONTS, AXSTR__U8_TWO_CONTS,
+		AXSTR__U8_TOO_SHORT | AXSTR__U8_OVERLONG_2,
+		AXSTR__U8_TOO_SHORT,
+		AXSTR__U8_TOO_SHORT | AXSTR__U8_OVERLONG_3 | AXSTR__U8_SURROGATE,
+		AXSTR__U8_TOO_SHORT | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000 | AXSTR__U8_OVERLONG_4
+	},
+	{
+		AXSTR__U8_CARRY | AXSTR__U8_OVERLONG_3 | AXSTR__U8_OVERLONG_2 | AXSTR__U8_OVERLONG_4,
+		AXSTR__U8_CARRY | AXSTR__U8_OVERLONG_2,
+		AXSTR__U8_CARRY,
+		AXSTR__U8_CARRY,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000 | AXSTR__U8_SURROGATE,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000,
+		AXSTR__U8_CARRY | AXSTR__U8_TOO_LARGE | AXSTR__U8_TOO_LARGE_1000
+	},
+	{
+		AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT,
+		AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT,
+		AXSTR__U8_TOO_LONG | AXSTR__U8_OVERLONG_2 | AXSTR__U8_TWO_CONTS | AXSTR__U8_OVERLONG_3 | AXSTR__U8_TOO_LARGE_1000 | AXSTR__U8_OVERLONG_4,
+		AXSTR__U8_TOO_LONG | AXSTR__U8_OVERLONG_2 | AXSTR__U8_TWO_CONTS | AXSTR__U8_OVERLONG_3 | AXSTR__U8_TOO_LARGE,
+		AXSTR__U8_TOO_LONG | AXSTR__U8_OVERLONG_2 | AXSTR__U8_TWO_CONTS | AXSTR__U8_SURROGATE | AXSTR__U8_TOO_LARGE,
+		AXSTR__U8_TOO_LONG | AXSTR__U8_OVERLONG_2 | AXSTR__U8_TWO_CONTS | AXSTR__U8_SURROGATE | AXSTR__U8_TOO_LARGE,
+		AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT, AXSTR__U8_TOO_SHORT
+	},
+	{
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+	}
+};
+
+/*! \internal
+ *  \brief Back up from the end of the blocks checked so far to the start of
+ *         the sequence that may straddle it, if any. */
+static const axstr_utf8_t *axstr__utf8_resume( const axstr_utf8_t *p, const axstr_utf8_t *a )
+{
+	const axstr_utf8_t *q;
+
+	for( q = a; q > p && a - q < 3; ) {
+		--q;
+		if( *q >= 0xC0 ) {
+			return q;
+		}
+		if( *q < 0x80 ) {
+			break;
+		}
+	}
+
+	return a;
+}
+
+# if AXSTR__UTF8_AVX2
+/*! \internal
+ *  \brief Skip the valid UTF-8 in `[p,e)` a block at a time, returning where
+ *         the scalar validator has to take over. */
+AXSTR__AVX2_FUNC static const axstr_utf8_t *axstr__utf8_run_avx2( const axstr_utf8_t *p, const axstr_utf8_t *e )
+{
+	const __m256i t1 = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 0 ] ) );
+	const __m256i t2 = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 1 ] ) );
+	const __m256i t3 = _mm256_broadcastsi128_si256( _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 2 ] ) );
+	const __m256i tail = _mm256_inserti128_si256( _mm256_set1_epi8( -1 ), _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 3 ] ), 1 );
+	const __m256i lo = _mm256_set1_epi8( 0x0F );
+	const axstr_utf8_t *a;
+	__m256i v, prev, incomplete, err, sh, p1, p2, p3;
+
+	prev = _mm256_setzero_si256();
+	incomplete = _mm256_setzero_si256();
+	for( a = p; e - a >= 32; a += 32 ) {
+		v = _mm256_loadu_si256( ( const __m256i * )a );
+		if( !_mm256_movemask_epi8( v ) ) {
+			err = incomplete;
+		} else {
+			/* the block shifted back by one, two and three bytes */
+			sh = _mm256_permute2x128_si256( prev, v, 0x21 );
+			p1 = _mm256_alignr_epi8( v, sh, 15 );
+			p2 = _mm256_alignr_epi8( v, sh, 14 );
+			p3 = _mm256_alignr_epi8( v, sh, 13 );
+
+			err = _mm256_and_si256( _mm256_and_si256(
+				_mm256_shuffle_epi8( t1, _mm256_and_si256( _mm256_srli_epi16( p1, 4 ), lo ) ),
+				_mm256_shuffle_epi8( t2, _mm256_and_si256( p1, lo ) ) ),
+				_mm256_shuffle_epi8( t3, _mm256_and_si256( _mm256_srli_epi16( v, 4 ), lo ) ) );
+			err = _mm256_xor_si256( err, _mm256_and_si256( _mm256_or_si256(
+				_mm256_subs_epu8( p2, _mm256_set1_epi8( 0xE0 - 0x80 ) ),
+				_mm256_subs_epu8( p3, _mm256_set1_epi8( 0xF0 - 0x80 ) ) ), _mm256_set1_epi8( ( char )0x80 ) ) );
+			incomplete = _mm256_subs_epu8( v, tail );
+		}
+		if( !_mm256_testz_si256( err, err ) ) {
+			break;
+		}
+
+		prev = v;
+	}
+
+	return axstr__utf8_resume( p, a );
+}
+# endif
+# if AXSTR__UTF8_SSSE3
+/*! \internal
+ *  \brief SSSE3 version of axstr__utf8_run_avx2(). */
+AXSTR__SSSE3_FUNC static const axstr_utf8_t *axstr__utf8_run_ssse3( const axstr_utf8_t *p, const axstr_utf8_t *e )
+{
+	const __m128i t1 = _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 0 ] );
+	const __m128i t2 = _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 1 ] );
+	const __m128i t3 = _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 2 ] );
+	const __m128i tail = _mm_loadu_si128( ( const __m128i * )axstr__g_utf8_lut[ 3 ] );
+	const __m128i lo = _mm_set1_epi8( 0x0F );
+	const __m128i z = _mm_setzero_si128();
+	const axstr_utf8_t *a;
+	__m128i v, prev, incomplete, err, p1, p2, p3;
+
+	prev = z;
+	incomplete = z;
+	for( a = p; e - a >= 16; a += 16 ) {
+		v = _mm_loadu_si128( ( const __m128i * )a );
+		if( !_mm_movemask_epi8( v ) ) {
+			err = incomplete;
+		} else {
+			p1 = _mm_alignr_epi8( v, prev, 15 );
+			p2 = _mm_alignr_epi8( v, prev, 14 );
+			p3 = _mm_alignr_epi8( v, prev, 13 );
+
+			err = _mm_and_si128( _mm_and_si128(
+				_mm_shuffle_epi8( t1, _mm_and_si128( _mm_srli_epi16( p1, 4 ), lo ) ),
+				_mm_shuffle_epi8( t2, _mm_and_si128( p1, lo ) ) ),
+				_mm_shuffle_epi8( t3, _mm_and_si128( _mm_srli_epi16( v, 4 ), lo ) ) );
+			err = _mm_xor_si128( err, _mm_and_si128( _mm_or_si128(
+				_mm_subs_epu8( p2, _mm_set1_epi8( 0xE0 - 0x80 ) ),
+				_mm_subs_epu8( p3, _mm_set1_epi8( 0xF0 - 0x80 ) ) ), _mm_set1_epi8( ( char )0x80 ) ) );
+			incomplete = _mm_subs_epu8( v, tail );
+		}
+		if( _mm_movemask_epi8( _mm_cmpeq_epi8( err, z ) ) != 0xFFFF ) {
+			break;
+		}
+
+		prev = v;
+	}
+
+	return axstr__utf8_resume( p, a );
+}
+# endif
+# if AXSTR__SIMD_NEON
+/*! \internal
+ *  \brief NEON version of axstr__utf8_run_avx2(). */
+static const axstr_utf8_t *axstr__utf8_run_neon( const axstr_utf8_t *p, const axstr_utf8_t *e )
+{
+	const uint8x16_t t1 = vld1q_u8( axstr__g_utf8_lut[ 0 ] );
+	const uint8x16_t t2 = vld1q_u8( axstr__g_utf8_lut[ 1 ] );
+	const uint8x16_t t3 = vld1q_u8( axstr__g_utf8_lut[ 2 ] );
+	const uint8x16_t tail = vld1q_u8( axstr__g_utf8_lut[ 3 ] );
+	const uint8x16_t lo = vdupq_n_u8( 0x0F );
+	const axstr_utf8_t *a;
+	uint8x16_t v, prev, incomplete, err, p1, p2, p3;
+
+	prev = vdupq_n_u8( 0 );
+	incomplete = prev;
+	for( a = p; e - a >= 16; a += 16 ) {
+		v = vld1q_u8( a );
+		if( vmaxvq_u8( v ) < 0x80 ) {
+			err = incomplete;
+		} else {
+			p1 = vextq_u8( prev, v, 15 );
+			p2 = vextq_u8( prev, v, 14 );
+			p3 = vextq_u8( prev, v, 13 );
+
+			err = vandq_u8( vandq_u8(
+				vqtbl1q_u8( t1, vshrq_n_u8( p1, 4 ) ),
+				vqtbl1q_u8( t2, vandq_u8( p1, lo ) ) ),
+				vqtbl1q_u8( t3, vshrq_n_u8( v, 4 ) ) );
+			err = veorq_u8( err, vandq_u8( vorrq_u8(
+				vqsubq_u8( p2, vdupq_n_u8( 0xE0 - 0x80 ) ),
+				vqsubq_u8( p3, vdupq_n_u8( 0xF0 - 0x80 ) ) ), vdupq_n_u8( 0x80 ) ) );
+			incomplete = vqsubq_u8( v, tail );
+		}
+		if( vmaxvq_u8( err ) != 0 ) {
+			break;
+		}
+
+		prev = v;
+	}
+
+	return axstr__utf8_resume( p, a );
+}
+# endif
+
+# if AXSTR__SIMD_DISPATCH
+typedef const axstr_utf8_t *( *axstr__utf8_run_fn_t )( const axstr_utf8_t *, const axstr_utf8_t * );
+
+static axstr__utf8_run_fn_t axstr__g_pfnUTF8Run = ( axstr__utf8_run_fn_t )0;
+
+/*! \internal
+ *  \brief Kernel for CPUs with neither AVX2 nor SSSE3; checks nothing. */
+static const axstr_utf8_t *axstr__utf8_run_none( const axstr_utf8_t *p, const axstr_utf8_t *e )
+{
+	( void )e;
+	return p;
+}
+static const axstr_utf8_t *axstr__utf8_run_kernel( const axstr_utf8_t *p, const axstr_utf8_t *e )
+{
+	if( !axstr__g_pfnUTF8Run ) {
+		axstr__g_pfnUTF8Run = axstr__has_avx2() ? &axstr__utf8_run_avx2 : axstr__has_ssse3() ? &axstr__utf8_run_ssse3 : &axstr__utf8_run_none;
+	}
+
+	return axstr__g_pfnUTF8Run( p, e );
+}
+# elif AXSTR__UTF8_AVX2
+#  define axstr__utf8_run_kernel    axstr__utf8_run_avx2
+# elif AXSTR__UTF8_SSSE3
+#  define axstr__utf8_run_kernel    axstr__utf8_run_ssse3
+# else
+#  define axstr__utf8_run_kernel    axstr__utf8_run_neon
+# endif
+# define AXSTR__UTF8_RUN            1
+#else
+# define AXSTR__UTF8_RUN            0
+#endif
+
+/*!
+ * \brief Check whether a chunk of data is well-formed UTF-8.
+ *
+ * Overlong encodings, surrogates and codepoints past `U+10FFFF` are rejected,
+ * as are truncated sequences. `NUL` bytes are allowed.
+ *
+ * \param  pSrc         Start of the data.
+ * \param  pSrcEnd      End of the data.
+ * \param  ppOutInvalid Optional. Receives the first byte of the first invalid
+ *                      sequence, or `pSrcEnd` if there was none.
+ * \return `1` if the data is valid UTF-8; `0` otherwise.
+ */
+AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_validate_utf8_n( const char *pSrc, const char *pSrcEnd, const char **ppOutInvalid )
+#if AXSTR_IMPLEMENT
+{
+	const axstr_utf8_t *p;
+	const axstr_utf8_t *e;
+	axstr_utf8_t lo, hi;
+	axstr_size_t i, n;
+
+	p = ( const axstr_utf8_t * )pSrc;
+	e = ( const axstr_utf8_t * )pSrcEnd;
+#if AXSTR__UTF8_RUN
+	/* whole blocks first; the scalar loop below finishes the tail, or finds
+	   exactly where the first bad block went wrong */
+	p = axstr__utf8_run_kernel( p, e );
+#endif
+	for(;;) {
+		p = axstr__ascii_run8( p, e );
+		if( p == e ) {
+			break;
+		}
+
+		/* lead bytes and the range of the first continuation byte, per table
+		   3-7 of the Unicode standard */
+		if( *p < 0xC2 || *p > 0xF4 ) {
+			break;
+		}
+
+		n = *p < 0xE0 ? 2 : ( *p < 0xF0 ? 3 : 4 );
+		if( ( axstr_size_t )( e - p ) < n ) {
+			break;
+		}
+
+		lo = 0x80;
+		hi = 0xBF;
+		switch( *p ) {
+		case 0xE0: lo = 0xA0; break;
+		case 0xED: hi = 0x9F; break;
+		case 0xF0: lo = 0x90; break;
+		case 0xF4: hi = 0x8F; break;
+		}
+
+		if( p[ 1 ] < lo || p[ 1 ] > hi ) {
+			break;
+		}
+
+		for( i = 2; i < n; ++i ) {
+			if( ( p[ i ] & 0xC0 ) != 0x80 ) {
+				break;
+			}
+		}
+		if( i < n ) {
+			break;
+		}
+
+		p += n;
+	}
+
+	if( ppOutInvalid != ( const char ** )0 ) {
+		*ppOutInvalid = ( const char * )p;
+	}
+
+	return ( axstr_bool_t )( p == e );
+}
+#else
+;
+#endif
+/*!
+ * \brief Check whether a `NUL`-terminated string is well-formed UTF-8.
+ *
+ * \sa axstr_validate_utf8_n()
+ */
+AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_validate_utf8( const char *pszSrc, const char **ppOutInvalid )
+#if AXSTR_IMPLEMENT
+{
+	return axstr_validate_utf8_n( pszSrc, pszSrc + axstr_len( pszSrc ), ppOutInvalid );
+}
+#else
+;
+#endif
+
+/*!
+ * \brief Convert a chunk of UTF-8 data to UTF-16 data, returning the number of
+ *        codepoints written.
+ *
+ * This assumes the byte-order of the host machine.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_counted_utf8_to_utf16( axstr_utf16_t *pUTF16Dst, axstr_size_t cMaxDstUTF16Chars, const axstr_utf8_t *pUTF8Src )
+#if AXSTR_IMPLEMENT
+{
+	axstr_utf16_t *dstp;
+
+	dstp = pUTF16Dst;
+	if( !axstr__utf8_to_utf16_e( &dstp, pUTF16Dst + cMaxDstUTF16Chars, pUTF8Src, pUTF8Src + axstr_len( ( const char * )pUTF8Src ) ) ) {
+		return 0;
+	}
+
+	*dstp = ( axstr_utf16_t )'\0';
+	return ( axstr_size_t )( dstp - pUTF16Dst );
+}
+#else
+;
+#endif
+/*!
+ * \brief Convert a chunk of UTF-8 data to UTF-16 data, returning the number of
+ *        codepoints written.
+ *
+ * This assumes the byte-order of the host machine.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_counted_utf8_to_utf16_n( axstr_utf16_t *pUTF16Dst, axstr_size_t cMaxDstUTF16Chars, const axstr_utf8_t *pUTF8Src, const axstr_utf8_t *pUTF8SrcEnd )
+#if AXSTR_IMPLEMENT
+{
+	axstr_utf16_t *dstp;
+
+	dstp = pUTF16Dst;
+	if( !axstr__utf8_to_utf16_e( &dstp, pUTF16Dst + cMaxDstUTF16Chars, pUTF8Src, pUTF8SrcEnd ) ) {
+		return 0;
+	}
+
+	*dstp = ( axstr_utf16_t )'\0';
+	return ( axstr_size_t )( dstp - pUTF16Dst );
+}
+#else
+;
+#endif
 /*!
  * \brief Convert a chunk of UTF-8 data to UTF-32 data, returning the number of
  *        codepoints written.
@@ -1976,22 +3181,10 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_counted_utf16_to_utf8( axstr_utf8_t *pU
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf8_t *dstp;
-	axstr_utf8_t *dste;
-	const axstr_utf16_t *srcp;
-	const axstr_utf16_t *srce;
 
 	dstp = pUTF8Dst;
-	dste = dstp + cMaxDstUTF8Bytes;
-	srcp = pUTF16Src;
-	srce = ( const axstr_utf16_t * )( ~( axstr_size_t )0 );
-
-	while( *srcp != '\0' ) {
-		axstr_utf32_t uCodepoint;
-
-		uCodepoint = axstr_step_utf16_decode( &srcp, srce );
-		if( !axstr_step_utf8_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	if( !axstr__utf16_to_utf8_e( &dstp, pUTF8Dst + cMaxDstUTF8Bytes, pUTF16Src, pUTF16Src + axstr__utf16_len( pUTF16Src ) ) ) {
+		return 0;
 	}
 
 	*dstp = '\0';
@@ -2010,22 +3203,10 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_counted_utf16_to_utf8_n( axstr_utf8_t *
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf8_t *dstp;
-	axstr_utf8_t *dste;
-	const axstr_utf16_t *srcp;
-	const axstr_utf16_t *srce;
 
 	dstp = pUTF8Dst;
-	dste = dstp + cMaxDstUTF8Bytes;
-	srcp = pUTF16Src;
-	srce = pUTF16SrcEnd;
-
-	while( srcp < srce ) {
-		axstr_utf32_t uCodepoint;
-
-		uCodepoint = axstr_step_utf16_decode( &srcp, srce );
-		if( !axstr_step_utf8_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	if( !axstr__utf16_to_utf8_e( &dstp, pUTF8Dst + cMaxDstUTF8Bytes, pUTF16Src, pUTF16SrcEnd ) ) {
+		return 0;
 	}
 
 	*dstp = '\0';
@@ -2103,22 +3284,10 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_utf8_to_utf16( axstr_utf16_t *pUTF16Dst
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf16_t *dstp;
-	axstr_utf16_t *dste;
-	const axstr_utf8_t *srcp;
-	const axstr_utf8_t *srce;
 
 	dstp = pUTF16Dst;
-	dste = dstp + cMaxDstUTF16Chars;
-	srcp = pUTF8Src;
-	srce = ( const axstr_utf8_t * )( ~( axstr_size_t )0 );
-
-	while( *srcp != '\0' ) {
-		axstr_utf32_t uCodepoint;
-
-		uCodepoint = axstr_step_utf8_decode( &srcp, srce );
-		if( !axstr_step_utf16_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	if( !axstr__utf8_to_utf16_e( &dstp, pUTF16Dst + cMaxDstUTF16Chars, pUTF8Src, pUTF8Src + axstr_len( ( const char * )pUTF8Src ) ) ) {
+		return 0;
 	}
 
 	*dstp = ( axstr_utf16_t )'\0';
@@ -2136,22 +3305,10 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_utf8_to_utf16_n( axstr_utf16_t *pUTF16D
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf16_t *dstp;
-	axstr_utf16_t *dste;
-	const axstr_utf8_t *srcp;
-	const axstr_utf8_t *srce;
 
 	dstp = pUTF16Dst;
-	dste = dstp + cMaxDstUTF16Chars;
-	srcp = pUTF8Src;
-	srce = pUTF8SrcEnd;
-
-	while( srcp < srce ) {
-		axstr_utf32_t uCodepoint;
-
-		uCodepoint = axstr_step_utf8_decode( &srcp, srce );
-		if( !axstr_step_utf16_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	if( !axstr__utf8_to_utf16_e( &dstp, pUTF16Dst + cMaxDstUTF16Chars, pUTF8Src, pUTF8SrcEnd ) ) {
+		return 0;
 	}
 
 	*dstp = ( axstr_utf16_t )'\0';
@@ -2233,22 +3390,10 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_utf16_to_utf8( axstr_utf8_t *pUTF8Dst,
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf8_t *dstp;
-	axstr_utf8_t *dste;
-	const axstr_utf16_t *srcp;
-	const axstr_utf16_t *srce;
 
 	dstp = pUTF8Dst;
-	dste = dstp + cMaxDstUTF8Bytes;
-	srcp = pUTF16Src;
-	srce = ( const axstr_utf16_t * )( ~( axstr_size_t )0 );
-
-	while( *srcp != '\0' ) {
-		axstr_utf32_t uCodepoint;
-
-		uCodepoint = axstr_step_utf16_decode( &srcp, srce );
-		if( !axstr_step_utf8_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	if( !axstr__utf16_to_utf8_e( &dstp, pUTF8Dst + cMaxDstUTF8Bytes, pUTF16Src, pUTF16Src + axstr__utf16_len( pUTF16Src ) ) ) {
+		return 0;
 	}
 
 	*dstp = '\0';
@@ -2266,22 +3411,10 @@ AXSTR_FUNC axstr_bool_t AXSTR_CALL axstr_utf16_to_utf8_n( axstr_utf8_t *pUTF8Dst
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf8_t *dstp;
-	axstr_utf8_t *dste;
-	const axstr_utf16_t *srcp;
-	const axstr_utf16_t *srce;
 
 	dstp = pUTF8Dst;
-	dste = dstp + cMaxDstUTF8Bytes;
-	srcp = pUTF16Src;
-	srce = pUTF16SrcEnd;
-
-	while( srcp < srce ) {
-		axstr_utf32_t uCodepoint;
-
-		uCodepoint = axstr_step_utf16_decode( &srcp, srce );
-		if( !axstr_step_utf8_encode( &dstp, dste, uCodepoint ) ) {
-			return 0;
-		}
+	if( !axstr__utf16_to_utf8_e( &dstp, pUTF8Dst + cMaxDstUTF8Bytes, pUTF16Src, pUTF16SrcEnd ) ) {
+		return 0;
 	}
 
 	*dstp = '\0';
@@ -2445,6 +3578,9 @@ static axstr_bool_t AXSTR_CALL axstr_stream_bytes_( void **ppDstBuf, axstr_size_
  * Does not explicitly write a `NUL`-terminator. (Useful when writing to a
  * (potentially memory mapped) file.)
  *
+ * If `pDstBuf` is `NULL` nothing is written, and the exact size needed for the
+ * result is returned instead.
+ *
  * \return Number of bytes written.
  */
 AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding_n( void *pDstBuf, axstr_size_t cDstBytes, const char *pszSrc, axstr_size_t cSrcBytes, axstr_encoding_t enc, axstr_byteordermark_t bom )
@@ -2452,17 +3588,48 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding_n( void *pDstBuf, axstr_siz
 {
 	const axstr_utf8_t *s;
 	const axstr_utf8_t *e;
+	const axstr_utf8_t *q;
+	axstr_size_t cUnitBytes;
+	axstr_size_t cTotal;
 	axstr_size_t n;
 	void *d;
 
+	s = ( const axstr_utf8_t * )pszSrc;
+	e = s + ( cSrcBytes == AXSTR_UNKNOWN_LENGTH ? axstr_len( pszSrc ) : cSrcBytes );
+
+	cUnitBytes = ( enc == axstr_enc_utf16_be || enc == axstr_enc_utf16_le ) ? 2 : 4;
+
+	/* just measure */
+	if( !pDstBuf ) {
+		unsigned char bom_bytes[ 4 ];
+
+		cTotal = axstr_write_bom( &bom_bytes[ 0 ], sizeof( bom_bytes ), enc, bom );
+		if( enc == axstr_enc_utf8 ) {
+			return cTotal + ( axstr_size_t )( e - s );
+		}
+		if( cUnitBytes == 2 ) {
+			return cTotal + 2*axstr_utf8_to_utf16_len_n( s, e );
+		}
+
+		while( s < e ) {
+			q = axstr__ascii_run8( s, e );
+			cTotal += 4*( axstr_size_t )( q - s );
+			s = q;
+
+			if( s < e ) {
+				( void )axstr_step_utf8_decode( &s, e );
+				cTotal += 4;
+			}
+		}
+
+		return cTotal;
+	}
+
 	n = axstr_write_bom( pDstBuf, cDstBytes, enc, bom );
 
 	d = ( void * )( ( unsigned char * )pDstBuf + n );
 	n = cDstBytes - n;
 
-	s = ( const axstr_utf8_t * )pszSrc;
-	e = s + ( cSrcBytes == AXSTR_UNKNOWN_LENGTH ? axstr_len( pszSrc ) : cSrcBytes );
-
 	if( enc == axstr_enc_utf8 ) {
 		if( !axstr_stream_bytes_( &d, &n, ( const void * )s, ( axstr_size_t )( e - s ) ) ) {
 			return 0;
@@ -2471,16 +3638,42 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding_n( void *pDstBuf, axstr_siz
 		return cDstBytes - n;
 	}
 
-	do {
+	while( s < e ) {
 		axstr_utf32_t cp;
 		unsigned char bytes[ 4 ];
 		axstr_size_t nbytes;
 
+		/* runs of ASCII are one unit per byte, with the byte in the low end */
+		q = axstr__ascii_run8( s, e );
+		if( q != s ) {
+			unsigned char *b;
+			axstr_size_t lo;
+
+			if( ( axstr_size_t )( q - s )*cUnitBytes > n ) {
+				return 0;
+			}
+
+			lo = ( enc == axstr_enc_utf16_be || enc == axstr_enc_utf32_be ) ? cUnitBytes - 1 : 0;
+			for( b = ( unsigned char * )d; s < q; b += cUnitBytes ) {
+				b[ 0 ] = 0;
+				b[ 1 ] = 0;
+				if( cUnitBytes == 4 ) {
+					b[ 2 ] = 0;
+					b[ 3 ] = 0;
+				}
+				b[ lo ] = *s++;
+			}
+
+			n -= ( axstr_size_t )( b - ( unsigned char * )d );
+			d = ( void * )b;
+			continue;
+		}
+
 		cp = axstr_step_utf8_decode( &s, e );
 
 		nbytes = 0;
 
-		if( enc == axstr_enc_utf16_be || enc == axstr_enc_utf16_le ) {
+		if( cUnitBytes == 2 ) {
 			axstr_utf16_t utf16[ 2 ];
 
 			if( cp < 0x10000 ) {
@@ -2488,7 +3681,7 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding_n( void *pDstBuf, axstr_siz
 				utf16[ 1 ] = 0;
 				nbytes = 2;
 			} else {
-				utf16[ 0 ] = 0xD800 | ( axstr_utf16_t )( ( cp >> 10 ) & 0x3FF );
+				utf16[ 0 ] = 0xD800 | ( axstr_utf16_t )( ( ( cp - 0x10000 ) >> 10 ) & 0x3FF );
 				utf16[ 1 ] = 0xDC00 | ( axstr_utf16_t )( ( cp >>  0 ) & 0x3FF );
 				nbytes = 4;
 			}
@@ -2521,7 +3714,7 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding_n( void *pDstBuf, axstr_siz
 		if( !axstr_stream_bytes_( &d, &n, &bytes[0], nbytes ) ) {
 			return 0;
 		}
-	} while( s < e );
+	}
 
 	return cDstBytes - n;
 }
@@ -2535,6 +3728,9 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding_n( void *pDstBuf, axstr_siz
  * Does not explicitly write a `NUL`-terminator. (Useful when writing to a
  * (potentially memory mapped) file.)
  *
+ * If `pDstBuf` is `NULL` nothing is written, and the exact size needed for the
+ * result is returned instead.
+ *
  * \return Number of bytes written.
  */
 AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_to_encoding( void *pDstBuf, axstr_size_t cDstBytes, const char *pszSrc, axstr_encoding_t enc, axstr_byteordermark_t bom )
@@ -2613,7 +3809,7 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_from_encoding( void *pDstBuf, axstr_siz
 #if AXSTR_IMPLEMENT
 {
 	axstr_size_t cBytesWritten = 0;
-	axstr_utf8_t Temp[ 4 ];
+	axstr_utf8_t Temp[ 5 ];
 	axstr_utf8_t *dstp;
 	axstr_utf8_t *dste;
 
@@ -2712,28 +3908,10 @@ AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_from_encoding( void *pDstBuf, axstr_siz
 		/* Do a byte-swapped decode if needed */
 		if( axstr__is_native_byteorder( enc ) ) {
 			if( !pDstBuf ) {
-				while( p < e ) {
-					dstp = &Temp[ 0 ];
-					dste = &Temp[ sizeof( Temp ) ];
-
-					v = axstr_step_utf16_decode( &p, e );
-					if( !axstr_step_utf8_encode( &dstp, dste, axstr_step_utf16_decode( &p, e ) ) ) {
-						break;
-					}
-
-					cBytesWritten += ( axstr_size_t )( dstp - &Temp[ 0 ] );
-				}
-
-				return cBytesWritten;
-			}
-
-			while( p < e ) {
-				v = axstr_step_utf16_decode( &p, e );
-				if( !axstr_step_utf8_encode( &dstp, dste, v ) ) {
-					break;
-				}
+				return axstr_utf16_to_utf8_len_n( p, e );
 			}
 
+			( void )axstr__utf16_to_utf8_e( &dstp, dste, p, e );
 			return ( axstr_size_t )( dstp - ( axstr_utf8_t * )pDstBuf );
 		} else {
 			axstr_utf16_t SrcTemp[ 2 ];
@@ -2942,7 +4120,20 @@ AXSTR_FUNC char *AXSTR_CALL axstr_findchr( const char *pszText, axstr_utf32_t ch
 
 	*utf8p = '\0';
 
-	return ( char * )strstr( pszText, ( const char * )utf8 );
+	return ( char * )strstr( pszText, ( const char * )utf8 );
+# elif AXSTR__SIMD
+	const char *p;
+
+	if( ch <= 0x7F ) {
+		p = axstr__chr_kernel( pszText, ( unsigned char )ch );
+		return *p == ( char )ch ? ( char * )p : ( char * )0;
+	}
+
+	if( !axstr_step_utf8_encode( &utf8p, utf8e, ch ) ) {
+		return ( char * )0;
+	}
+
+	return ( char * )axstr__vstr( pszText, ( const char * )utf8, ( axstr_size_t )( utf8p - &utf8[ 0 ] ) );
 # else
 	const axstr_utf8_t *p;
 	const axstr_utf8_t *q;
@@ -2998,12 +4189,27 @@ AXSTR_FUNC char *AXSTR_CALL axstr_findchr( const char *pszText, axstr_utf32_t ch
 AXSTR_FUNC char *AXSTR_CALL axstr_findstrn( const char *pszText, const char *pszFind, axstr_size_t cFindBytes )
 #if AXSTR_IMPLEMENT
 {
+# if AXSTR__SIMD
+	const char *p;
+	axstr_size_t n;
+
+	/* only the bytes before a NUL in pszFind are searched for */
+	for( n = 0; n < cFindBytes && pszFind[ n ] != '\0'; ++n ) {
+	}
+
+	if( n < 2 ) {
+		p = axstr__chr_kernel( pszText, ( unsigned char )*pszFind );
+		return *p == *pszFind ? ( char * )p : ( char * )0;
+	}
+
+	return ( char * )axstr__vstr( pszText, pszFind, n );
+# else
 	const char *p;
 	const char *q;
 
+#  if AXSTR_STDSTR_ENABLED
 	q = pszText;
 
-# if AXSTR_STDSTR_ENABLED
 	do {
 		p = strchr( q, *pszFind );
 		if( !p ) {
@@ -3012,7 +4218,9 @@ AXSTR_FUNC char *AXSTR_CALL axstr_findstrn( const char *pszText, const char *psz
 
 		q = p + 1;
 	} while( strncmp( pszFind, p, cFindBytes ) != 0 );
-# else
+#  else
+	q = pszText;
+
 	do {
 		p = axstr_findchr( q, *pszFind );
 		if( !p ) {
@@ -3021,9 +4229,10 @@ AXSTR_FUNC char *AXSTR_CALL axstr_findstrn( const char *pszText, const char *psz
 
 		q = p + 1;
 	} while( !axstr_cmpn( pszFind, p, cFindBytes ) );
-# endif
+#  endif
 
 	return ( char * )p;
+# endif
 }
 #else
 ;
@@ -3338,6 +4547,17 @@ AXSTR_FUNC const char *AXSTR_CALL axstr_skip_whitespace_e( const char *p, const
 #if AXSTR_IMPLEMENT
 {
 	axstr_utf8_t ch;
+
+# if AXSTR__SIMD
+	/* the last byte is left to the loop below, which returns NULL if the
+	   whitespace runs up to e */
+	if( !e ) {
+		p = p != ( const char * )0 ? axstr__vwhite( p ) : p;
+	} else if( p != ( const char * )0 && p < e ) {
+		p = axstr__vwhite_e( p, e - 1 );
+	}
+# endif
+
 	for(;;) {
 		ch = ( axstr_utf8_t )axstr__deref( p );
 		if( ch > ' ' || !ch ) {
@@ -3357,11 +4577,15 @@ AXSTR_FUNC const char *AXSTR_CALL axstr_skip_whitespace_e( const char *p, const
 AXSTR_FUNC const char *AXSTR_CALL axstr_skip_whitespace( const char *p )
 #if AXSTR_IMPLEMENT
 {
+# if AXSTR__SIMD
+	return axstr__vwhite( p );
+# else
 	while( axstr_iswhite( *( const axstr_utf8_t * )p ) && *p != '\0' ) {
 		++p;
 	}
 
 	return p;
+# endif
 }
 #else
 ;
@@ -3371,6 +4595,10 @@ AXSTR_FUNC const char *AXSTR_CALL axstr_skip_whitespace( const char *p )
 AXSTR_FUNC const char *AXSTR_CALL axstr_skip_line_e( const char *p, const char *e )
 #if AXSTR_IMPLEMENT
 {
+# if AXSTR__SIMD
+	p = axstr__veol_e( p, e );
+# endif
+
 	while( p < e ) {
 		if( *p == '\r' ) {
 			++p;
@@ -3393,6 +4621,10 @@ AXSTR_FUNC const char *AXSTR_CALL axstr_skip_line_e( const char *p, const char *
 AXSTR_FUNC const char *AXSTR_CALL axstr_skip_line( const char *p )
 #if AXSTR_IMPLEMENT
 {
+# if AXSTR__SIMD
+	p = axstr__veol( p );
+# endif
+
 	while( *p != '\0' ) {
 		if( *p == '\r' ) {
 			++p;
@@ -4189,49 +5421,527 @@ AXSTR_FUNC unsigned int AXSTR_CALL axstr_murmur3_ranged_seeded( const char *s, c
 			( ( (unsigned int)(unsigned char)s[2] ) <<  8 ) |
 			( ( (unsigned int)(unsigned char)s[3] ) <<  0 );
 
-		s += 4;
+		s += 4;
+
+		h ^= axstr__murmur3_scramble( k );
+		h  = ( h << 13 ) | ( h >> 19 );
+		h  = h*5 + 0xE6546B64;
+	}
+
+	k = 0;
+	while( s != e ) {
+		k <<= 8;
+		k  |= *s;
+
+		s += 1;
+	}
+
+	h ^= axstr__murmur3_scramble( k );
+
+	h ^= len;
+	h ^= h >> 16;
+	h *= 0x85EBCA6B;
+	h ^= h >> 13;
+	h *= 0xC2B2AE35;
+	h ^= h >> 16;
+
+	return h;
+}
+#else
+;
+#endif
+
+AXSTR_FUNC unsigned int AXSTR_CALL axstr_murmur3_ranged( const char *s, const char *e )
+#if AXSTR_IMPLEMENT
+{
+	return axstr_murmur3_ranged_seeded( s, e, AXSTR_MURMUR3_DEFAULT_SEED );
+}
+#else
+;
+#endif
+
+AXSTR_FUNC unsigned int AXSTR_CALL axstr_murmur3_psz( const char *s )
+#if AXSTR_IMPLEMENT
+{
+	return axstr_murmur3_ranged_seeded( s, (const char *)0, AXSTR_MURMUR3_DEFAULT_SEED );
+}
+#else
+;
+#endif
+
+/*
+===============================================================================
+
+	STRING INTERNING
+
+===============================================================================
+*/
+
+#ifndef AXSTR_INTERN_THREADSAFE
+# ifdef INCGUARD_AX_THREAD_H_
+#  define AXSTR_INTERN_THREADSAFE   1
+# else
+#  define AXSTR_INTERN_THREADSAFE   0
+# endif
+#endif
+#if AXSTR_INTERN_THREADSAFE && !defined( INCGUARD_AX_THREAD_H_ )
+# error ax_string: AXSTR_INTERN_THREADSAFE requires ax_thread.h
+#endif
+
+/* number of separately locked shards per table; power of two, at most 256 */
+#ifndef AXSTR_INTERN_SHARDS
+# define AXSTR_INTERN_SHARDS        16
+#endif
+/* size of the arena blocks interned strings are carved from */
+#ifndef AXSTR_INTERN_BLOCK_SIZE
+# define AXSTR_INTERN_BLOCK_SIZE    16384
+#endif
+
+/*!
+ * \brief A string stored in an intern table.
+ *
+ * Each distinct byte sequence is stored once per table, so two handles from
+ * the same table refer to equal strings if, and only if, they are the same
+ * pointer. `uHash` is `axstr_murmur3_ranged()` of the text, computed once when
+ * the string was first interned. The text is always `NUL`-terminated but may
+ * also contain embedded `NUL`s; `cBytes` is authoritative.
+ *
+ * Handles stay valid until the table they came from is finalized.
+ */
+typedef struct axstr_interned_s
+{
+	unsigned int uHash;
+	axstr_size_t cBytes;
+	char         szText[ 1 ];
+} axstr_interned_t;
+
+/*! \internal
+ *  \brief Open-addressed slot array of a shard.
+ *
+ *  Slots only ever go from null to set while the array is current. Growing
+ *  allocates a new array and retires the old one (kept until fini) so lookups
+ *  running without the lock never touch freed memory. */
+typedef struct axstr__intern_slots_s
+{
+	struct axstr__intern_slots_s *    pRetired;
+	axstr_size_t                      cSlots;
+	const axstr_interned_t *volatile  apSlots[ 1 ];
+} axstr__intern_slots_t;
+
+/*! \internal
+ *  \brief Arena block; string records follow the header. */
+typedef struct axstr__intern_block_s
+{
+	struct axstr__intern_block_s *    pNext;
+	axstr_size_t                      cUsed;
+	axstr_size_t                      cMax;
+} axstr__intern_block_t;
+
+/*! \internal */
+typedef struct axstr__intern_shard_s
+{
+	axstr__intern_slots_t *volatile   pSlots;
+	axstr__intern_block_t *           pBlocks;
+	axstr_size_t                      cEntries;
+#if AXSTR_INTERN_THREADSAFE
+	volatile axth_u32_t               Lock;
+#endif
+} axstr__intern_shard_t;
+
+/*!
+ * \brief Table of interned strings.
+ *
+ * A zero-filled table is valid and empty, so a static table needs no
+ * initialization. Looking up a string that is already interned does not take
+ * any lock. Interning a new string locks only the shard selected by its hash,
+ * so threads interning unrelated strings rarely contend.
+ */
+typedef struct axstr_intern_table_s
+{
+	axstr__intern_shard_t             Shards[ AXSTR_INTERN_SHARDS ];
+} axstr_intern_table_t;
+
+#if AXSTR_INTERN_THREADSAFE
+# define AXSTR__INTERN_LOCK(Shard_)     axstr__intern_lock( Shard_ )
+# define AXSTR__INTERN_UNLOCK(Shard_)   ( ( void )AX_ATOMIC_EXCHANGE_FULL32( &( Shard_ )->Lock, 0 ) )
+# define AXSTR__INTERN_PUBLISH()        AX_MEMORY_BARRIER()
+/* slot pointers are read without the lock; GCC and Clang get real atomics so
+   the pairing is visible to ThreadSanitizer, elsewhere a volatile access (an
+   acquire/release on MSVC) after the publish barrier does the job */
+# if defined( __GNUC__ ) || defined( __clang__ )
+#  define AXSTR__INTERN_LOAD(Src_)      __atomic_load_n( &( Src_ ), __ATOMIC_ACQUIRE )
+#  define AXSTR__INTERN_STORE(Dst_,V_)  __atomic_store_n( &( Dst_ ), ( V_ ), __ATOMIC_RELEASE )
+# else
+#  define AXSTR__INTERN_LOAD(Src_)      ( Src_ )
+#  define AXSTR__INTERN_STORE(Dst_,V_)  ( ( Dst_ ) = ( V_ ) )
+# endif
+#else
+# define AXSTR__INTERN_LOCK(Shard_)     ( ( void )0 )
+# define AXSTR__INTERN_UNLOCK(Shard_)   ( ( void )0 )
+# define AXSTR__INTERN_PUBLISH()        ( ( void )0 )
+# define AXSTR__INTERN_LOAD(Src_)       ( Src_ )
+# define AXSTR__INTERN_STORE(Dst_,V_)   ( ( Dst_ ) = ( V_ ) )
+#endif
+
+#if AXSTR_IMPLEMENT
+/*! \internal */
+static axstr_intern_table_t axstr__g_internTable;
+
+#if AXSTR_INTERN_THREADSAFE
+/*! \internal
+ *  \brief Lock a shard.
+ *
+ *  This spins on the atomic macros directly rather than using axth_qmutex_t so
+ *  that ax_string doesn't need ax_thread's implementation at link time. Only
+ *  inserts of new strings take the lock, so it is held briefly and rarely. */
+static void axstr__intern_lock( axstr__intern_shard_t *pShard )
+{
+	while( AX_ATOMIC_EXCHANGE_FULL32( &pShard->Lock, 1 ) != 0 ) {
+		while( AXSTR__INTERN_LOAD( pShard->Lock ) != 0 ) {
+			AX_CPU_PAUSE();
+		}
+	}
+}
+#endif
+
+/*! \internal */
+static axstr__intern_shard_t *axstr__intern_shard( axstr_intern_table_t *pTable, unsigned int uHash )
+{
+	/* slots are indexed by the low bits, so pick the shard from the high ones */
+	return &pTable->Shards[ ( uHash >> 24 ) & ( AXSTR_INTERN_SHARDS - 1 ) ];
+}
+
+/*! \internal */
+static axstr_bool_t axstr__intern_match( const axstr_interned_t *p, unsigned int uHash, const char *s, axstr_size_t n )
+{
+	axstr_size_t i;
+
+	if( p->uHash != uHash || p->cBytes != n ) {
+		return 0;
+	}
+
+	for( i = 0; i < n; ++i ) {
+		if( p->szText[ i ] != s[ i ] ) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*! \internal
+ *  \brief Find a string in a slot array; safe without the shard's lock. */
+static const axstr_interned_t *axstr__intern_probe( const axstr__intern_slots_t *pSlots, unsigned int uHash, const char *s, axstr_size_t n )
+{
+	const axstr_interned_t *p;
+	axstr_size_t uMask, i;
+
+	if( !pSlots ) {
+		return ( const axstr_interned_t * )0;
+	}
+
+	uMask = pSlots->cSlots - 1;
+	i = ( axstr_size_t )uHash & uMask;
+
+	while( ( p = AXSTR__INTERN_LOAD( pSlots->apSlots[ i ] ) ) != ( const axstr_interned_t * )0 ) {
+		if( axstr__intern_match( p, uHash, s, n ) ) {
+			return p;
+		}
+
+		i = ( i + 1 ) & uMask;
+	}
+
+	return ( const axstr_interned_t * )0;
+}
+
+/*! \internal */
+static void axstr__intern_place( axstr__intern_slots_t *pSlots, const axstr_interned_t *pStr )
+{
+	axstr_size_t uMask, i;
+
+	uMask = pSlots->cSlots - 1;
+	i = ( axstr_size_t )pStr->uHash & uMask;
+
+	while( pSlots->apSlots[ i ] != ( const axstr_interned_t * )0 ) {
+		i = ( i + 1 ) & uMask;
+	}
+
+	AXSTR__INTERN_STORE( pSlots->apSlots[ i ], pStr );
+}
+
+/*! \internal
+ *  \brief Ensure the current slot array can take one more entry (load <= 1/2). */
+static axstr__intern_slots_t *axstr__intern_reserve( axstr__intern_shard_t *pShard )
+{
+	axstr__intern_slots_t *pOld, *pNew;
+	axstr_size_t cSlots, i;
+
+	pOld = pShard->pSlots;
+	if( pOld != ( axstr__intern_slots_t * )0 && ( pShard->cEntries + 1 )*2 <= pOld->cSlots ) {
+		return pOld;
+	}
+
+	cSlots = pOld != ( axstr__intern_slots_t * )0 ? pOld->cSlots*2 : 64;
+
+	pNew = ( axstr__intern_slots_t * )axstr_alloc( sizeof( *pNew ) + ( cSlots - 1 )*sizeof( pNew->apSlots[ 0 ] ) );
+	if( !pNew ) {
+		return ( axstr__intern_slots_t * )0;
+	}
+
+	pNew->pRetired = pOld;
+	pNew->cSlots = cSlots;
+	for( i = 0; i < cSlots; ++i ) {
+		pNew->apSlots[ i ] = ( const axstr_interned_t * )0;
+	}
+
+	if( pOld != ( axstr__intern_slots_t * )0 ) {
+		for( i = 0; i < pOld->cSlots; ++i ) {
+			if( pOld->apSlots[ i ] != ( const axstr_interned_t * )0 ) {
+				axstr__intern_place( pNew, pOld->apSlots[ i ] );
+			}
+		}
+	}
+
+	/* readers must not see the new array before its contents */
+	AXSTR__INTERN_PUBLISH();
+	AXSTR__INTERN_STORE( pShard->pSlots, pNew );
+
+	return pNew;
+}
+
+/*! \internal
+ *  \brief Carve a string record out of the shard's arena. */
+static axstr_interned_t *axstr__intern_arena_alloc( axstr__intern_shard_t *pShard, axstr_size_t cTextBytes )
+{
+	axstr__intern_block_t *pBlock;
+	axstr_size_t cBytes, cMax;
+	char *p;
+
+	cBytes = sizeof( axstr_interned_t ) + cTextBytes;
+	cBytes = ( cBytes + sizeof( axstr_size_t ) - 1 ) & ~( sizeof( axstr_size_t ) - 1 );
+
+	pBlock = pShard->pBlocks;
+	if( !pBlock || pBlock->cMax - pBlock->cUsed < cBytes ) {
+		/* large strings get a block of their own so the current one stays in use */
+		cMax = AXSTR_INTERN_BLOCK_SIZE - sizeof( axstr__intern_block_t );
+		if( cBytes > cMax/4 ) {
+			cMax = cBytes;
+		}
+
+		pBlock = ( axstr__intern_block_t * )axstr_alloc( sizeof( *pBlock ) + cMax );
+		if( !pBlock ) {
+			return ( axstr_interned_t * )0;
+		}
+
+		pBlock->cUsed = 0;
+		pBlock->cMax = cMax;
+
+		if( cMax == cBytes && pShard->pBlocks != ( axstr__intern_block_t * )0 ) {
+			pBlock->pNext = pShard->pBlocks->pNext;
+			pShard->pBlocks->pNext = pBlock;
+		} else {
+			pBlock->pNext = pShard->pBlocks;
+			pShard->pBlocks = pBlock;
+		}
+	}
+
+	p = ( char * )( pBlock + 1 ) + pBlock->cUsed;
+	pBlock->cUsed += cBytes;
+
+	return ( axstr_interned_t * )p;
+}
+#endif
+
+/*!
+ * \brief Initialize an intern table.
+ *
+ * This is equivalent to zero-filling it.
+ */
+AXSTR_FUNC void AXSTR_CALL axstr_intern_init( axstr_intern_table_t *pTable )
+#if AXSTR_IMPLEMENT
+{
+	unsigned int i;
+
+	for( i = 0; i < AXSTR_INTERN_SHARDS; ++i ) {
+		pTable->Shards[ i ].pSlots = ( axstr__intern_slots_t * )0;
+		pTable->Shards[ i ].pBlocks = ( axstr__intern_block_t * )0;
+		pTable->Shards[ i ].cEntries = 0;
+#if AXSTR_INTERN_THREADSAFE
+		pTable->Shards[ i ].Lock = 0;
+#endif
+	}
+}
+#else
+;
+#endif
+
+/*!
+ * \brief Free all memory owned by an intern table.
+ *
+ * All handles from the table become invalid. The table is left empty and can
+ * be used again. This must not run concurrently with any other use of the
+ * table.
+ */
+AXSTR_FUNC void AXSTR_CALL axstr_intern_fini( axstr_intern_table_t *pTable )
+#if AXSTR_IMPLEMENT
+{
+	axstr__intern_slots_t *pSlots, *pPrevSlots;
+	axstr__intern_block_t *pBlock, *pNextBlock;
+	unsigned int i;
+
+	for( i = 0; i < AXSTR_INTERN_SHARDS; ++i ) {
+		for( pSlots = pTable->Shards[ i ].pSlots; pSlots != ( axstr__intern_slots_t * )0; pSlots = pPrevSlots ) {
+			pPrevSlots = pSlots->pRetired;
+			axstr_free( ( void * )pSlots );
+		}
+		for( pBlock = pTable->Shards[ i ].pBlocks; pBlock != ( axstr__intern_block_t * )0; pBlock = pNextBlock ) {
+			pNextBlock = pBlock->pNext;
+			axstr_free( ( void * )pBlock );
+		}
+	}
+
+	axstr_intern_init( pTable );
+}
+#else
+;
+#endif
+
+/*!
+ * \brief Retrieve the process-wide intern table.
+ *
+ * This is what `ax::InternedStr` uses when no table is given. It is never
+ * finalized automatically.
+ */
+AXSTR_FUNC axstr_intern_table_t *AXSTR_CALL axstr_intern_global( void )
+#if AXSTR_IMPLEMENT
+{
+	return &axstr__g_internTable;
+}
+#else
+;
+#endif
+
+/*!
+ * \brief Look up a string without interning it.
+ *
+ * This never locks or allocates.
+ *
+ * \return The interned string if present, or `NULL` otherwise.
+ */
+AXSTR_FUNC const axstr_interned_t *AXSTR_CALL axstr_intern_find_n( axstr_intern_table_t *pTable, const char *s, axstr_size_t cBytes )
+#if AXSTR_IMPLEMENT
+{
+	unsigned int uHash;
+
+	if( !s ) {
+		s = "";
+		cBytes = 0;
+	}
+
+	uHash = axstr_murmur3_ranged_seeded( s, s + cBytes, AXSTR_MURMUR3_DEFAULT_SEED );
+	return axstr__intern_probe( AXSTR__INTERN_LOAD( axstr__intern_shard( pTable, uHash )->pSlots ), uHash, s, cBytes );
+}
+#else
+;
+#endif
+
+/*!
+ * \brief Intern a string, copying it into the table if it is not present yet.
+ *
+ * \param  pTable Table to intern into.
+ * \param  s      Text of the string. Need not be `NUL`-terminated.
+ * \param  cBytes Length of `s` in bytes.
+ * \return The unique handle for the string in this table, or `NULL` if memory
+ *         could not be allocated.
+ */
+AXSTR_FUNC const axstr_interned_t *AXSTR_CALL axstr_intern_n( axstr_intern_table_t *pTable, const char *s, axstr_size_t cBytes )
+#if AXSTR_IMPLEMENT
+{
+	axstr__intern_shard_t *pShard;
+	axstr__intern_slots_t *pSlots;
+	const axstr_interned_t *pFound;
+	axstr_interned_t *pStr;
+	unsigned int uHash;
+	axstr_size_t i;
+
+	if( !s ) {
+		s = "";
+		cBytes = 0;
+	}
 
-		h ^= axstr__murmur3_scramble( k );
-		h  = ( h << 13 ) | ( h >> 19 );
-		h  = h*5 + 0xE6546B64;
+	uHash = axstr_murmur3_ranged_seeded( s, s + cBytes, AXSTR_MURMUR3_DEFAULT_SEED );
+	pShard = axstr__intern_shard( pTable, uHash );
+
+	/* common case: already interned */
+	pFound = axstr__intern_probe( AXSTR__INTERN_LOAD( pShard->pSlots ), uHash, s, cBytes );
+	if( pFound != ( const axstr_interned_t * )0 ) {
+		return pFound;
 	}
 
-	k = 0;
-	while( s != e ) {
-		k <<= 8;
-		k  |= *s;
+	AXSTR__INTERN_LOCK( pShard );
 
-		s += 1;
+	/* another thread may have inserted it since the unlocked probe */
+	pFound = axstr__intern_probe( AXSTR__INTERN_LOAD( pShard->pSlots ), uHash, s, cBytes );
+	if( pFound != ( const axstr_interned_t * )0 ) {
+		AXSTR__INTERN_UNLOCK( pShard );
+		return pFound;
 	}
 
-	h ^= axstr__murmur3_scramble( k );
+	pSlots = axstr__intern_reserve( pShard );
+	pStr = pSlots != ( axstr__intern_slots_t * )0 ? axstr__intern_arena_alloc( pShard, cBytes ) : ( axstr_interned_t * )0;
+	if( !pStr ) {
+		AXSTR__INTERN_UNLOCK( pShard );
+		return ( const axstr_interned_t * )0;
+	}
 
-	h ^= len;
-	h ^= h >> 16;
-	h *= 0x85EBCA6B;
-	h ^= h >> 13;
-	h *= 0xC2B2AE35;
-	h ^= h >> 16;
+	pStr->uHash = uHash;
+	pStr->cBytes = cBytes;
+	for( i = 0; i < cBytes; ++i ) {
+		pStr->szText[ i ] = s[ i ];
+	}
+	pStr->szText[ cBytes ] = '\0';
 
-	return h;
+	/* the record must be complete before a reader can reach it */
+	AXSTR__INTERN_PUBLISH();
+	axstr__intern_place( pSlots, pStr );
+	++pShard->cEntries;
+
+	AXSTR__INTERN_UNLOCK( pShard );
+	return pStr;
 }
 #else
 ;
 #endif
 
-AXSTR_FUNC unsigned int AXSTR_CALL axstr_murmur3_ranged( const char *s, const char *e )
+/*!
+ * \brief Intern a `NUL`-terminated string.
+ */
+AXSTR_FUNC const axstr_interned_t *AXSTR_CALL axstr_intern( axstr_intern_table_t *pTable, const char *psz )
 #if AXSTR_IMPLEMENT
 {
-	return axstr_murmur3_ranged_seeded( s, e, AXSTR_MURMUR3_DEFAULT_SEED );
+	return axstr_intern_n( pTable, psz, psz != ( const char * )0 ? axstr_len( psz ) : 0 );
 }
 #else
 ;
 #endif
 
-AXSTR_FUNC unsigned int AXSTR_CALL axstr_murmur3_psz( const char *s )
+/*!
+ * \brief Count the distinct strings in a table.
+ *
+ * While other threads are interning this is only a snapshot.
+ */
+AXSTR_FUNC axstr_size_t AXSTR_CALL axstr_intern_count( const axstr_intern_table_t *pTable )
 #if AXSTR_IMPLEMENT
 {
-	return axstr_murmur3_ranged_seeded( s, (const char *)0, AXSTR_MURMUR3_DEFAULT_SEED );
+	axstr_size_t n;
+	unsigned int i;
+
+	n = 0;
+	for( i = 0; i < AXSTR_INTERN_SHARDS; ++i ) {
+		n += pTable->Shards[ i ].cEntries;
+	}
+
+	return n;
 }
 #else
 ;
@@ -4690,6 +6400,11 @@ namespace ax
 
 #ifndef AXSTR_OBJMUTSTR_ENABLED
 # define AXSTR_OBJMUTSTR_ENABLED 0
+#endif
+
+/* bytes of inline storage in each TMutStr, including the NUL; must be > 0 */
+#ifndef AXSTR_MUTSTR_INLINE_BYTES
+# define AXSTR_MUTSTR_INLINE_BYTES 24
 #endif
 
 	template< typename T > class TArr;
@@ -4814,6 +6529,13 @@ namespace ax
 		, m_cStr( src.m_cStr )
 		{
 		}
+		/*! \brief Copy assignment. */
+		inline Str &operator=( const Str &src )
+		{
+			m_pStr = src.m_pStr;
+			m_cStr = src.m_cStr;
+			return *this;
+		}
 		/*! \brief Construct from a specific character. */
 		inline Str( const char chMyChar )
 		: m_pStr( axstr__getCharPtr( ( unsigned char )chMyChar ) )
@@ -6471,6 +8193,121 @@ namespace ax
 
 
 
+	/*
+	===========================================================================
+
+		INTERNED STRING
+
+		Handle to a string stored in an intern table.
+
+	===========================================================================
+	*/
+
+	/*!
+	 * \brief Handle to a string interned in an `axstr_intern_table_t`.
+	 *
+	 * Comparing two handles is a pointer compare and `murmur3()` is a load,
+	 * which makes these cheap keys for lookup tables. Only compare handles that
+	 * came from the same table. Constructing one from a `Str` interns the
+	 * string (in `axstr_intern_global()` unless a table is given), and handles
+	 * convert back to `Str` implicitly.
+	 *
+	 * A default-constructed handle is null; it reads as an empty string but is
+	 * not equal to an interned empty string.
+	 */
+	class InternedStr
+	{
+	public:
+		typedef axstr_size_t SizeType;
+
+		/*! \brief Null handle. */
+		inline InternedStr()
+		: m_pStr( ( const axstr_interned_t * )0 )
+		{
+		}
+		/*! \brief Wrap a handle returned by `axstr_intern_n()`. */
+		inline explicit InternedStr( const axstr_interned_t *pStr )
+		: m_pStr( pStr )
+		{
+		}
+		/*! \brief Intern a string.
+		 *  \note  The handle is null if the table could not allocate. */
+		inline explicit InternedStr( Str s, axstr_intern_table_t *pTable = axstr_intern_global() )
+		: m_pStr( axstr_intern_n( pTable, s.get(), s.len() ) )
+		{
+		}
+
+		/*! \brief Retrieve the handle of a string only if it is already
+		 *         interned; otherwise a null handle. */
+		static inline InternedStr find( Str s, axstr_intern_table_t *pTable = axstr_intern_global() )
+		{
+			return InternedStr( axstr_intern_find_n( pTable, s.get(), s.len() ) );
+		}
+
+		/*! \brief Retrieve the underlying record (may be `NULL`). */
+		inline const axstr_interned_t *handle() const
+		{
+			return m_pStr;
+		}
+		/*! \brief Retrieve the `NUL`-terminated text. */
+		inline const char *get() const
+		{
+			return m_pStr != ( const axstr_interned_t * )0 ? m_pStr->szText : "";
+		}
+		/*! \brief Length of the string in bytes. */
+		inline SizeType len() const
+		{
+			return m_pStr != ( const axstr_interned_t * )0 ? m_pStr->cBytes : 0;
+		}
+		/*! \brief The murmur3 hash of this string, as `Str::murmur3()` would
+		 *         compute it. */
+		inline unsigned int murmur3() const
+		{
+			return m_pStr != ( const axstr_interned_t * )0 ? m_pStr->uHash : Str().murmur3();
+		}
+
+		/*! \brief Determine whether this is a null handle. */
+		inline bool isNull() const
+		{
+			return m_pStr == ( const axstr_interned_t * )0;
+		}
+		/*! \brief Determine whether this string is empty. */
+		inline bool isEmpty() const
+		{
+			return len() == 0;
+		}
+		/*! \brief Determine whether this string is not empty. */
+		inline bool isUsed() const
+		{
+			return len() > 0;
+		}
+
+		/*! \brief View this string as a `Str`. */
+		inline Str view() const
+		{
+			return Str( get(), len() );
+		}
+		inline operator Str() const
+		{
+			return view();
+		}
+
+		inline bool operator==( const InternedStr &x ) const
+		{
+			return m_pStr == x.m_pStr;
+		}
+		inline bool operator!=( const InternedStr &x ) const
+		{
+			return m_pStr != x.m_pStr;
+		}
+
+	private:
+		const axstr_interned_t *m_pStr;
+	};
+
+
+
+
 	/*
 	===========================================================================
 
@@ -6481,6 +8318,131 @@ namespace ax
 	===========================================================================
 	*/
 
+	/*!
+	 * \brief Bump allocator for batches of temporary strings.
+	 *
+	 * `ArenaStr` (or any `TMutStr` using `policy::ArenaStringAllocator`) takes
+	 * its storage from here. Freeing a single string only gives memory back if
+	 * it was the most recent allocation; `reset()` releases everything at once.
+	 * Strings must not be used after the arena they allocated from is reset or
+	 * destroyed. Not thread-safe.
+	 */
+	class StrArena
+	{
+	public:
+		typedef axstr_size_t SizeType;
+
+		inline explicit StrArena( SizeType cBlockBytes = 4096 )
+		: m_pHead( ( SBlock * )0 )
+		, m_cBlockBytes( cBlockBytes > sizeof( SBlock ) ? cBlockBytes : 4096 )
+		{
+		}
+		inline ~StrArena()
+		{
+			purge();
+		}
+
+		/// \brief Allocate `cBytes` bytes (unaligned).
+		inline void *allocate( SizeType cBytes )
+		{
+			SBlock *pBlock = m_pHead;
+
+			if( !pBlock || pBlock->cMax - pBlock->cUsed < cBytes ) {
+				// large requests get their own block so the current one stays in use
+				const SizeType cDefault = m_cBlockBytes - sizeof( SBlock );
+				const bool bLarge = cBytes > cDefault/4;
+				const SizeType cMax = bLarge ? cBytes : cDefault;
+
+				pBlock = ( SBlock * )axstr_alloc( sizeof( SBlock ) + cMax );
+				if( !pBlock ) {
+					return ( void * )0;
+				}
+
+				pBlock->cUsed = 0;
+				pBlock->cMax = cMax;
+
+				if( bLarge && m_pHead != ( SBlock * )0 ) {
+					pBlock->pPrev = m_pHead->pPrev;
+					m_pHead->pPrev = pBlock;
+				} else {
+					pBlock->pPrev = m_pHead;
+					m_pHead = pBlock;
+				}
+			}
+
+			char *const p = blockData_( pBlock ) + pBlock->cUsed;
+			pBlock->cUsed += cBytes;
+
+			return ( void * )p;
+		}
+		/// \brief Give back an allocation if it was the most recent one.
+		inline void deallocate( void *p, SizeType cBytes )
+		{
+			if( !m_pHead || !p || cBytes > m_pHead->cUsed ) {
+				return;
+			}
+
+			if( ( char * )p + cBytes == blockData_( m_pHead ) + m_pHead->cUsed ) {
+				m_pHead->cUsed -= cBytes;
+			}
+		}
+
+		/// \brief Release all allocations, keeping one block for reuse.
+		inline void reset()
+		{
+			if( !m_pHead ) {
+				return;
+			}
+
+			SBlock *const pKeep = m_pHead;
+			m_pHead = pKeep->pPrev;
+			purge();
+
+			pKeep->pPrev = ( SBlock * )0;
+			pKeep->cUsed = 0;
+			m_pHead = pKeep;
+		}
+		/// \brief Release all allocations and all memory.
+		inline void purge()
+		{
+			while( m_pHead != ( SBlock * )0 ) {
+				SBlock *const pPrev = m_pHead->pPrev;
+				axstr_free( ( void * )m_pHead );
+				m_pHead = pPrev;
+			}
+		}
+
+		/// \brief Total amount of memory this arena holds.
+		inline SizeType memSize() const
+		{
+			SizeType n = sizeof( *this );
+			for( const SBlock *p = m_pHead; p != ( const SBlock * )0; p = p->pPrev ) {
+				n += sizeof( SBlock ) + p->cMax;
+			}
+
+			return n;
+		}
+
+	private:
+		struct SBlock
+		{
+			SBlock * pPrev;
+			SizeType cUsed;
+			SizeType cMax;
+		};
+
+		SBlock * m_pHead;
+		SizeType m_cBlockBytes;
+
+		static inline char *blockData_( SBlock *p )
+		{
+			return reinterpret_cast< char * >( p + 1 );
+		}
+
+		StrArena( const StrArena & );
+		StrArena &operator=( const StrArena & );
+	};
+
 	namespace policy
 	{
 
@@ -6619,6 +8581,62 @@ namespace ax
 			}
 		};
 
+		/*!
+		 * \brief Allocates from a `StrArena`, or from the heap (as with
+		 *        `DefaultStringAllocator`) if no arena was given.
+		 *
+		 * Swapping two strings also swaps their arenas, so storage always stays
+		 * with the allocator it came from.
+		 */
+		struct ArenaStringAllocator
+		{
+			typedef axstr_size_t AllocSizeType;
+
+			inline ArenaStringAllocator()
+			: m_pArena( ( StrArena * )0 )
+			{
+			}
+			inline ArenaStringAllocator( StrArena &arena )
+			: m_pArena( &arena )
+			{
+			}
+
+			inline void *allocate( AllocSizeType cBytes, AllocSizeType &cAllocedBytes )
+			{
+				void *const p = m_pArena != ( StrArena * )0 ? m_pArena->allocate( cBytes ) : axstr_alloc( cBytes );
+				cAllocedBytes = !p ? 0 : cBytes;
+				return p;
+			}
+			inline void deallocate( void *pBytes, AllocSizeType cBytes )
+			{
+				if( m_pArena != ( StrArena * )0 ) {
+					m_pArena->deallocate( pBytes, cBytes );
+					return;
+				}
+
+				axstr_free( pBytes );
+			}
+
+			inline void swap( ArenaStringAllocator &x, char *&a, char *&b )
+			{
+				StrArena *const pArena = m_pArena;
+				m_pArena = x.m_pArena;
+				x.m_pArena = pArena;
+
+				char *const temp = a;
+				a = b;
+				b = temp;
+			}
+
+			inline StrArena *arena() const
+			{
+				return m_pArena;
+			}
+
+		private:
+			StrArena *m_pArena;
+		};
+
 	}
 
 	namespace detail
@@ -7604,18 +9622,31 @@ namespace ax
 	template< typename Allocator >
 	class TMutStr: private Allocator, public detail::MutStrCore
 	{
+	template< typename OtherAllocator >
+	friend class TMutStr;
 	public:
 		typedef TMutStr< Allocator >              Self;
 		typedef detail::MutStrCore::DiffType      DiffType;
 		typedef detail::MutStrCore::SizeType      SizeType;
 		typedef typename Allocator::AllocSizeType AllocSizeType;
 
+		/// Strings shorter than this are stored inside the object itself
+		static const SizeType kInlineBytes = AXSTR_MUTSTR_INLINE_BYTES;
+
 		TMutStr()
 		: Allocator()
 		, detail::MutStrCore()
 		, m_cAllocedBytes( 0 )
 		{
 		}
+		/// \brief Construct with a specific allocator instance (e.g., a
+		///        `policy::ArenaStringAllocator` for a `StrArena`).
+		explicit TMutStr( const Allocator &alloc )
+		: Allocator( alloc )
+		, detail::MutStrCore()
+		, m_cAllocedBytes( 0 )
+		{
+		}
 		TMutStr( const TMutStr &other )
 		: Allocator( other )
 		, detail::MutStrCore()
@@ -7630,6 +9661,13 @@ namespace ax
 		{
 			assign( other );
 		}
+		TMutStr( Str other, const Allocator &alloc )
+		: Allocator( alloc )
+		, detail::MutStrCore()
+		, m_cAllocedBytes( 0 )
+		{
+			assign( other );
+		}
 #if AXSTR_CXX11_MOVE_ENABLED
 		TMutStr( TMutStr &&x )
 		: Allocator( static_cast< Allocator && >( x ) )
@@ -7637,6 +9675,7 @@ namespace ax
 		, m_cAllocedBytes( x.m_cAllocedBytes )
 		{
 			x.m_cAllocedBytes = 0;
+			takeInline_( x.m_inline );
 		}
 		template< typename A >
 		TMutStr( TMutStr< A > &&x )
@@ -7645,16 +9684,18 @@ namespace ax
 		, m_cAllocedBytes( x.m_cAllocedBytes )
 		{
 			x.m_cAllocedBytes = 0;
+			takeInline_( x.m_inline );
 		}
 #endif
 		~TMutStr()
 		{
+			purge();
 		}
 
 		/// \brief Total amount of memory this object is using
 		inline AllocSizeType memSize() const
 		{
-			return sizeof( *this ) + m_cAllocedBytes;
+			return sizeof( *this ) + ( isInline_() ? 0 : m_cAllocedBytes );
 		}
 		/// \brief Maximum capacity of the current object (before reallocation)
 		inline SizeType max() const
@@ -7665,6 +9706,10 @@ namespace ax
 		/// \brief  Prepare this string to hold enough space for a string of
 		///         `cLen`-bytes.
 		///
+		/// Lengths below `kInlineBytes` use the inline buffer rather than the
+		/// allocator. Otherwise this allocates (close to) exactly what was
+		/// asked for; appending operations grow geometrically instead.
+		///
 		/// If this fails, this object is *still* valid.
 		///
 		/// \return `true` if this succceeded; `false` otherwise.
@@ -7674,12 +9719,19 @@ namespace ax
 				return true;
 			}
 
-			const SizeType n = cLen + ( 16 - ( cLen + 15 )%16 );
-
+			char *p;
 			SizeType cAllocedBytes = 0;
-			char *const p = ( char * )Allocator::allocate( n, cAllocedBytes );
-			if( !p ) {
-				return false;
+
+			if( cLen < kInlineBytes ) {
+				p = &m_inline[ 0 ];
+				cAllocedBytes = kInlineBytes;
+			} else {
+				const SizeType n = cLen + ( 16 - ( cLen + 15 )%16 );
+
+				p = ( char * )Allocator::allocate( n, cAllocedBytes );
+				if( !p ) {
+					return false;
+				}
 			}
 
 			if( m_cLen > cLen ) {
@@ -7692,7 +9744,9 @@ namespace ax
 				*p = '\0';
 			}
 
-			Allocator::deallocate( ( void * )m_data, m_cAllocedBytes );
+			if( !isInline_() ) {
+				Allocator::deallocate( ( void * )m_data, m_cAllocedBytes );
+			}
 			m_data = p;
 
 			m_cAllocedBytes = cAllocedBytes;
@@ -7718,9 +9772,12 @@ namespace ax
 		/// Remove all dynamic memory associated with this string.
 		inline TMutStr &purge()
 		{
-			Allocator::deallocate( m_data, m_cAllocedBytes );
+			if( !isInline_() ) {
+				Allocator::deallocate( m_data, m_cAllocedBytes );
+			}
 			m_cAllocedBytes = 0;
 			m_data = ( char * )0;
+			m_cLen = 0;
 
 			return *this;
 		}
@@ -7831,7 +9888,7 @@ namespace ax
 				return true;
 			}
 
-			if( m_cLen + s.len() < m_cLen || !reserve( m_cLen + s.len() ) ) {
+			if( m_cLen + s.len() < m_cLen || !grow_( m_cLen + s.len() ) ) {
 				return false;
 			}
 
@@ -7869,7 +9926,7 @@ namespace ax
 		/// \brief Insert text at the end of the string.
 		inline bool tryAppend( Str s )
 		{
-			if( m_cLen + s.len() < m_cLen || !reserve( m_cLen + s.len() ) ) {
+			if( m_cLen + s.len() < m_cLen || !grow_( m_cLen + s.len() ) ) {
 				return false;
 			}
 
@@ -7948,51 +10005,57 @@ namespace ax
 
 #ifdef INCGUARD_AX_PRINTF_H_
 	private:
-		static inline axpf_ptrdiff_t
-		AXPF_CALL axpfWrite_f
-		(
-			void *data,
-			const char *s,
-			const char *e
-		)
+		// Grows this string for axbpfev(); `pBuf->i` bytes are already in
+		// m_data past the last commit, so they're kept across the reserve.
+		static int AXPF_CALL axpfGrow_f( axpf_buffer_t *pBuf, axpf_size_t cMin )
 		{
-			Self *md;
+			Self *const md = reinterpret_cast< Self * >( pBuf->pUser );
 
-			md = reinterpret_cast< Self * >( data );
-			if( !md ) {
-				return axpf_ptrdiff_t( -1 );
+			const SizeType cUsed = SizeType( pBuf->i );
+			const SizeType cWant = cUsed + SizeType( cMin );
+			if( cWant < cUsed ) {
+				return 0;
 			}
 
-			const SizeType oldLen = md->len();
-			if( !md->tryAppend( Str( s, e ) ) ) {
-				return axpf_ptrdiff_t( -1 );
+			md->m_cLen = cUsed;
+			if( !md->grow_( cWant ) ) {
+				return 0;
 			}
 
-			const SizeType newLen = md->len();
-
-			const axpf_ptrdiff_t cWritten = axpf_ptrdiff_t( axpf_size_t( newLen - oldLen ) );
-			return cWritten;
+			pBuf->p = md->m_data;
+			pBuf->n = axpf_size_t( md->m_cAllocedBytes );
+			return 1;
 		}
 
 	public:
+		/// rief Format onto the end of this string.
+		///
+		/// Output is written directly into this string's storage, which
+		/// grows as needed. On failure the string is left as it was.
 		inline bool appendfv( AXPF_PARM_ANNO Str formatStr, va_list args ) AXPF_FUNC_ANNO(1,2)
 		{
-			struct axpf__state_ s;
+			if( !m_cAllocedBytes && !reserve( 0 ) ) {
+				return false;
+			}
 
-			s.pfn_write  = &axpfWrite_f;
-			s.write_data = reinterpret_cast< void * >( this );
+			axpf_buffer_t b;
+
+			b.p       = m_data;
+			b.i       = axpf_size_t( m_cLen );
+			b.n       = axpf_size_t( m_cAllocedBytes );
+			b.pfnGrow = &axpfGrow_f;
+			b.pUser   = reinterpret_cast< void * >( this );
 
 			const SizeType cLen = m_cLen;
-			const axpf_ptrdiff_t r = axpf__main( &s, formatStr.get(), formatStr.getEnd(), args );
+			const axpf_ptrdiff_t r = axbpfev( &b, formatStr.get(), formatStr.getEnd(), args );
 			if( r < 0 ) {
 				m_cLen = cLen;
-				if( m_data != ( char * )0 ) {
-					m_data[ m_cLen ] = '\0';
-				}
+				m_data[ m_cLen ] = '\0';
 
 				return false;
 			}
 
+			m_cLen = SizeType( b.i );
 			return true;
 		}
 
@@ -8049,7 +10112,7 @@ namespace ax
 		inline bool tryAppendPath( Str s, char chPathSep = AXSTR_DIRSEP_CH )
 		{
 			if( !endsWithDirSep() && !s.startsWithDirSep() ) {
-				if( m_cLen + s.len() + 1 <= m_cLen || !reserve( m_cLen + s.len() + 1 ) ) {
+				if( m_cLen + s.len() + 1 <= m_cLen || !grow_( m_cLen + s.len() + 1 ) ) {
 					return false;
 				}
 
@@ -8444,8 +10507,24 @@ namespace ax
 
 		inline TMutStr &swap( TMutStr &other )
 		{
+			// the allocator exchanges the storage it owns; inline buffers stay
+			// put, so their contents are exchanged and pointers fixed up
 			Allocator::swap( other, m_data, other.m_data );
 
+			if( m_data == &other.m_inline[ 0 ] || other.m_data == &m_inline[ 0 ] ) {
+				char temp[ kInlineBytes ];
+				axstr__memcpy( temp, m_inline, kInlineBytes );
+				axstr__memcpy( m_inline, other.m_inline, kInlineBytes );
+				axstr__memcpy( other.m_inline, temp, kInlineBytes );
+
+				if( m_data == &other.m_inline[ 0 ] ) {
+					m_data = &m_inline[ 0 ];
+				}
+				if( other.m_data == &m_inline[ 0 ] ) {
+					other.m_data = &other.m_inline[ 0 ];
+				}
+			}
+
 			const SizeType cLen = m_cLen;
 			m_cLen = other.m_cLen;
 			other.m_cLen = cLen;
@@ -8459,9 +10538,36 @@ namespace ax
 
 	private:
 		AllocSizeType m_cAllocedBytes;
+		char          m_inline[ kInlineBytes ];
+
+		inline bool isInline_() const
+		{
+			return m_data == &m_inline[ 0 ];
+		}
+		/// After a move: point at our own inline buffer if `x`'s was in use.
+		inline void takeInline_( char *pOtherInline )
+		{
+			if( m_data == pOtherInline ) {
+				axstr__memcpy( m_inline, pOtherInline, m_cLen + 1 );
+				m_data = &m_inline[ 0 ];
+			}
+		}
+		/// Reserve for appending: grow by at least half the current capacity
+		/// so that repeated appends don't reallocate each time.
+		inline bool grow_( SizeType cLen )
+		{
+			if( m_cAllocedBytes >= cLen + 1 ) {
+				return true;
+			}
+
+			const SizeType cGeometric = max() + max()/2;
+			return reserve( cLen > cGeometric ? cLen : cGeometric );
+		}
 	};
 
 	typedef TMutStr< policy::DefaultStringAllocator > MutStr;
+	/// String allocating from a `StrArena` (e.g., `ArenaStr s( arena );`)
+	typedef TMutStr< policy::ArenaStringAllocator > ArenaStr;
 
 	template< axstr_size_t tBufSize, typename OverflowAllocator = policy::DefaultStringAllocator >
 	using TSmallStr = TMutStr< policy::SmallStringAllocator< tBufSize, OverflowAllocator > >;
@@ -677,9 +677,9 @@ GCC/Clang Atomics
 #elif defined( __GNUC__ ) || defined( __clang__ )
 
 # define AX_ATOMIC_EXCHANGE_FULL32( Dst, Src )\
-	( ( axth_u32_t )( __sync_lock_test_and_set( ( volatile axth_u32_t * )( Dst ), ( axth_u32_t )( Src ) ) ) )
+	( ( axth_u32_t )( __atomic_exchange_n( ( volatile axth_u32_t * )( Dst ), ( axth_u32_t )( Src ), __ATOMIC_SEQ_CST ) ) )
 # define AX_ATOMIC_COMPARE_EXCHANGE_FULL32( Dst, Src, Cmp )\
-	( ( axth_u32_t )( __sync_val_compare_and_swap( ( volatile axth_u32_t * )( Dst ), ( axth_u32_t )( Src ), ( axth_u32_t )( Cmp ) ) ) )
+	( ( axth_u32_t )( __sync_val_compare_and_swap( ( volatile axth_u32_t * )( Dst ), ( axth_u32_t )( Cmp ), ( axth_u32_t )( Src ) ) ) )
 
 # define AX_ATOMIC_FETCH_ADD_FULL32( Dst, Src )\
 	( ( axth_u32_t )( __sync_fetch_and_add( ( volatile axth_u32_t * )( Dst ), ( axth_u32_t )( Src ) ) ) )
@@ -694,9 +694,9 @@ GCC/Clang Atomics
 
 
 # define AX_ATOMIC_EXCHANGE_FULL64( Dst, Src )\
-	( ( axth_u64_t )( __sync_lock_test_and_set( ( volatile axth_u64_t * )( Dst ), ( axth_u64_t )( Src ) ) ) )
+	( ( axth_u64_t )( __atomic_exchange_n( ( volatile axth_u64_t * )( Dst ), ( axth_u64_t )( Src ), __ATOMIC_SEQ_CST ) ) )
 # define AX_ATOMIC_COMPARE_EXCHANGE_FULL64( Dst, Src, Cmp )\
-	( ( axth_u64_t )( __sync_val_compare_and_swap( ( volatile axth_u64_t * )( Dst ), ( axth_u64_t )( Src ), ( axth_u64_t )( Cmp ) ) ) )
+	( ( axth_u64_t )( __sync_val_compare_and_swap( ( volatile axth_u64_t * )( Dst ), ( axth_u64_t )( Cmp ), ( axth_u64_t )( Src ) ) ) )
 
 # define AX_ATOMIC_FETCH_ADD_FULL64( Dst, Src )\
 	( ( axth_u64_t )( __sync_fetch_and_add( ( volatile axth_u64_t * )( Dst ), ( axth_u64_t )( Src ) ) ) )
@@ -711,9 +711,9 @@ GCC/Clang Atomics
 
 
 # define AX_ATOMIC_EXCHANGE_FULLPTR( Dst, Src )\
-	( ( void * )( __sync_lock_test_and_set( ( void *volatile * )( Dst ), ( void * )( Src ) ) ) )
+	( ( void * )( __atomic_exchange_n( ( void *volatile * )( Dst ), ( void * )( Src ), __ATOMIC_SEQ_CST ) ) )
 # define AX_ATOMIC_COMPARE_EXCHANGE_FULLPTR( Dst, Src, Cmp )\
-	( ( void * )( __sync_val_compare_and_swap( ( void *volatile * )( Dst ), ( void * )( Src ), ( void * )( Cmp ) ) ) )
+	( ( void * )( __sync_val_compare_and_swap( ( void *volatile * )( Dst ), ( void * )( Cmp ), ( void * )( Src ) ) ) )
 
 /*
 ----------------
@@ -1875,12 +1875,15 @@ static void axth__x86_cpuid( axth_u32_t *pCPUInfo, axth_u32_t uFunc, axth_u32_t
 
 AXTHREAD_UNUSED static int axth__x86_streq12( const char *a, const char *b )
 {
-	const axth_u32_t *p, *q;
+	unsigned i;
 
-	p = ( const axth_u32_t * )a;
-	q = ( const axth_u32_t * )b;
+	for( i = 0; i < 12; ++i ) {
+		if( a[ i ] != b[ i ] ) {
+			return 0;
+		}
+	}
 
-	return p[0]==q[0] && p[1]==q[1] && p[2]==q[2] && p[3]==q[3];
+	return 1;
 }
 axth__x86_info_t *axth__x86_info( void )
 {
@@ -1905,12 +1908,12 @@ axth__x86_info_t *axth__x86_info( void )
 		info.uF81ECX = 0;
 		info.uF81EDX = 0;
 
-		/* CPUID( EAX=00h ) → EAX: highest function number; EBX,ECX,EDX: vendor string */
+		/* CPUID( EAX=00h ) → EAX: highest function number; EBX,EDX,ECX: vendor string */
 		axth__x86_cpuid( &Regs[0], 0, 0 );
 		info.uLastNormalId = Regs[ EAX ];
 		*( axth_u32_t * )&info.szVendor[ 0x00 ] = Regs[ EBX ];
-		*( axth_u32_t * )&info.szVendor[ 0x04 ] = Regs[ ECX ];
-		*( axth_u32_t * )&info.szVendor[ 0x08 ] = Regs[ EDX ];
+		*( axth_u32_t * )&info.szVendor[ 0x04 ] = Regs[ EDX ];
+		*( axth_u32_t * )&info.szVendor[ 0x08 ] = Regs[ ECX ];
 		*( axth_u32_t * )&info.szVendor[ 0x0C ] = 0;
 
 		if( axth__x86_streq12( info.szVendor, "GenuineIntel" ) ) {
@@ -1965,7 +1968,7 @@ axth__x86_info_t *axth__x86_info( void )
 			*( axth_u32_t * )&info.szBrand[ 0x28 ] = Regs[ ECX ];
 			*( axth_u32_t * )&info.szBrand[ 0x2C ] = Regs[ EDX ];
 
-			*( axth_u32_t * )&info.szBrand[ 0x30 ] = 0;
+			info.szBrand[ 0x2F ] = '\0';
 		}
 
 		didinit = 1;
@@ -2528,7 +2531,6 @@ typedef struct axthread_s
 #  include <sys/prctl.h>
 # endif
 # if AXTHREAD_OS_WINDOWS
-#  define AXTHREAD__NO_NAME_COPY 1
 static void axth__win32_setThreadName( axthread_t *p, const char *pszName )
 {
 # if defined( _MSC_VER ) || defined( __INTEL_COMPILER )
@@ -2564,15 +2566,30 @@ static void axth__win32_setThreadName( axthread_t *p, const char *pszName )
 	((void)pszName);
 }
 # endif
+/* copy of the calling thread's name, for axth_get_thread_name() */
+# if defined( _MSC_VER )
+static __declspec( thread ) char    axth__g_szThreadName[ 64 ];
+# else
+static __thread char                axth__g_szThreadName[ 64 ];
+# endif
+
 static void axth__setCurrentThreadName( axthread_t *pThread, const char *pszName )
 {
+	axth_size_t i;
+
+	for( i = 0; pszName[ i ] != '\0' && i + 1 < sizeof( axth__g_szThreadName ); ++i ) {
+		axth__g_szThreadName[ i ] = pszName[ i ];
+	}
+	axth__g_szThreadName[ i ] = '\0';
+
 # if AXTHREAD_OS_WINDOWS
-	axth__win32_setThreadName( pThread, pszName );
+	/* the OS name was already given by whoever knows the thread's ID (axthread_init_named() or axthread_set_name()) */
 # elif AXTHREAD_MODEL_PTHREAD
 #  if AXTHREAD_OS_MACOSX
 #   ifdef __OBJC__
 	[[NSThread currentThread] setName:[NSString stringWithUTF8Encoding:pszName]];
 #   endif
+	pthread_setname_np( pszName );
 #  endif
 #  if AXTHREAD_OS_LINUX
 	union {
@@ -2583,7 +2600,6 @@ static void axth__setCurrentThreadName( axthread_t *pThread, const char *pszName
 	x.p = pszName;
 	prctl( PR_SET_NAME, x.l, 0, 0, 0 );
 #  endif
-	pthread_setname_np( pszName );
 # else
 #  pragma warning "ax_thread: Could not determine how to set current thread's name"
 # endif
@@ -2817,6 +2833,14 @@ AXTHREAD_FUNC void AXTHREAD_CALL axthread_set_name( axthread_t *p, const char *p
 {
 # if AXTHREAD_OS_WINDOWS
 	axth__win32_setThreadName( p, pszName );
+	if( p->dwThreadId == GetCurrentThreadId() ) {
+		axth__setCurrentThreadName( p, pszName );
+	}
+# elif AXTHREAD_MODEL_PTHREAD
+	/* only the thread itself can be renamed here */
+	if( pthread_equal( p->thread, pthread_self() ) ) {
+		axth__setCurrentThreadName( p, pszName );
+	}
 # else
 	( void )p;
 	( void )pszName;
@@ -2826,6 +2850,20 @@ AXTHREAD_FUNC void AXTHREAD_CALL axthread_set_name( axthread_t *p, const char *p
 ;
 #endif
 
+/*
+ * Get the name the calling thread was given by axthread_init_named() or
+ * axthread_set_name(), or an empty string if it has none. The string belongs
+ * to the calling thread and lives as long as it does.
+ */
+AXTHREAD_FUNC const char *AXTHREAD_CALL axth_get_thread_name( void )
+#if AXTHREAD_IMPLEMENT
+{
+	return &axth__g_szThreadName[ 0 ];
+}
+#else
+;
+#endif
+
 AXTHREAD_FUNC void AXTHREAD_CALL axthread_signal_quit( axthread_t *p )
 #if AXTHREAD_IMPLEMENT
 {
@@ -2996,7 +3034,7 @@ AXTHREAD_FUNC int AXTHREAD_CALL axth_qmutex_try_acquire_unsafe( axth_qmutex_t *p
 AXTHREAD_FUNC int AXTHREAD_CALL axth_qmutex_try_acquire( axth_qmutex_t *p )
 #if AXTHREAD_IMPLEMENT
 {
-	if( AX_ATOMIC_FETCH_ADD_FULL32( p, 1 ) == 0 ) {
+	if( AX_ATOMIC_FETCH_ADD_FULL32( p, 1 ) != 0 ) {
 		AX_ATOMIC_FETCH_SUB_FULL32( p, 1 );
 		return 0;
 	}
@@ -3012,11 +3050,11 @@ AXTHREAD_FUNC void AXTHREAD_CALL axth_qmutex_acquire( axth_qmutex_t *p, axth_u32
 {
 	/* wait for access to the lock */
 	while( AX_ATOMIC_FETCH_ADD_FULL32( p, 1 ) != 0 ) {
+		/* access not granted; decrement (before waiting, so the lock can be seen free) */
+		AX_ATOMIC_FETCH_SUB_FULL32( p, 1 );
+
 		/* don't overload the lock */
 		axth_backoff( &cSpins, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
-
-		/* access not granted; decrement */
-		AX_ATOMIC_FETCH_SUB_FULL32( p, 1 );
 	}
 }
 #else
@@ -3106,175 +3144,228 @@ namespace ax
 
 
 
-
 /*
 ===============================================================================
 
-	QUICK (SPIN) SEMAPHORE - NON-RECURSIVE
+	PARKING
+
+	Sleeping until a 32-bit value changes, for the locks below. This uses
+	futex() on Linux and WaitOnAddress() on Windows 8 and later. Elsewhere
+	"parking" just yields.
 
 ===============================================================================
 */
 
-AXTHREAD__ENTER_C
-
-#ifndef AXTHREAD_QSEM_SLEEP_ENABLED
-# ifdef INCGUARD_AXTIME_H_
-#  define AXTHREAD_QSEM_SLEEP_ENABLED 1
+#ifndef AXTHREAD_PARK_DEFINED
+# define AXTHREAD_PARK_FUTEX        0
+# define AXTHREAD_PARK_WAITONADDRESS 0
+# define AXTHREAD_PARK_YIELD        0
+# if AXTHREAD_OS_LINUX
+#  undef AXTHREAD_PARK_FUTEX
+#  define AXTHREAD_PARK_FUTEX       1
+# elif AXTHREAD_OS_WINDOWS && _WIN32_WINNT >= 0x0602
+#  undef AXTHREAD_PARK_WAITONADDRESS
+#  define AXTHREAD_PARK_WAITONADDRESS 1
 # else
-#  define AXTHREAD_QSEM_SLEEP_ENABLED 0
+#  undef AXTHREAD_PARK_YIELD
+#  define AXTHREAD_PARK_YIELD       1
 # endif
-#endif
-#ifndef AXTHREAD_QSEM_SLEEP_RESISTANCE_MS
-# define AXTHREAD_QSEM_SLEEP_RESISTANCE_MS 20
+# define AXTHREAD_PARK_DEFINED      1
 #endif
 
-typedef struct axth_qsem_s
-{
-	volatile axth_u32_t             uCur;
-	axth_u32_t                      uMax;
-} axth_qsem_t;
+#if AXTHREAD_PARK_FUTEX && AXTHREAD_IMPLEMENT
+# include <limits.h>
+# include <linux/futex.h>
+# include <sys/syscall.h>
+#elif AXTHREAD_PARK_WAITONADDRESS && defined( _MSC_VER )
+# pragma comment( lib, "Synchronization.lib" )
+#endif
 
-#define AXTHREAD_QSEM_MAXIMUM       ((axth_u32_t)0x7FFFFFFFUL)
-#define AXTHREAD_QSEM_INITIALIZER   {((axth_u32_t)0),AXTHREAD_QSEM_MAXIMUM}
+/* every parking channel (see axth__park()) */
+#define AXTHREAD__PARK_ANY          0xFFFFFFFF
 
-AXTHREAD_FUNC axth_qsem_t *AXTHREAD_CALL axth_qsem_init( axth_qsem_t *p, axth_u32_t uBase, axth_u32_t uMax )
 #if AXTHREAD_IMPLEMENT
+/*
+ * implementation: sleep while *p is uValue (may return spuriously)
+ *
+ * uChannels selects which calls to axth__wake() can wake the thread: only
+ * those whose channels overlap. (Where the OS can't filter wakes, every wake
+ * reaches every thread parked on p.)
+ */
+static void axth__park( volatile axth_u32_t *p, axth_u32_t uValue, axth_u32_t uChannels )
 {
-	if( uBase > uMax ) {
-		return ( axth_qsem_t * )0;
-	}
-
-	p->uCur = uBase;
-	p->uMax = uMax;
-
-	return p;
+# if AXTHREAD_PARK_FUTEX
+	syscall( SYS_futex, p, FUTEX_WAIT_BITSET_PRIVATE, uValue, ( void * )0, ( void * )0, uChannels );
+# elif AXTHREAD_PARK_WAITONADDRESS
+	( void )uChannels;
+	WaitOnAddress( ( volatile VOID * )p, ( PVOID )&uValue, sizeof( uValue ), INFINITE );
+# else
+	( void )p;
+	( void )uValue;
+	( void )uChannels;
+	axth_yield();
+# endif
 }
-#else
-;
-#endif
-AXTHREAD_FUNC axth_qsem_t *AXTHREAD_CALL axth_qsem_fini( axth_qsem_t *p )
-#if AXTHREAD_IMPLEMENT
+/* implementation: wake one (or all, if bAll) of the threads parked on p in any of uChannels */
+static void axth__wake( volatile axth_u32_t *p, int bAll, axth_u32_t uChannels )
 {
+# if AXTHREAD_PARK_FUTEX
+	syscall( SYS_futex, p, FUTEX_WAKE_BITSET_PRIVATE, bAll ? INT_MAX : 1, ( void * )0, ( void * )0, uChannels );
+# elif AXTHREAD_PARK_WAITONADDRESS
+	( void )uChannels;
+	if( bAll ) {
+		WakeByAddressAll( ( PVOID )p );
+	} else {
+		WakeByAddressSingle( ( PVOID )p );
+	}
+# else
 	( void )p;
-	return ( axth_qsem_t * )0;
+	( void )bAll;
+	( void )uChannels;
+# endif
 }
-#else
-;
 #endif
 
-AXTHREAD_FUNC int AXTHREAD_CALL axth_qsem_signal( axth_qsem_t *p, axth_u32_t count, axth_u32_t *ppriorcount )
-#if AXTHREAD_IMPLEMENT
-{
-	axth_u32_t uMax;
-	axth_u32_t cSpin = 1;
 
-	uMax = p->uMax;
-	for(;;) {
-		const axth_u32_t uCur = p->uCur;
-		const axth_u32_t uNew = uCur + count;
 
-		if( uNew > uMax ) {
-			return 0;
-		}
 
-		if( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uCur, uNew, uCur ) == uNew ) {
-			if( ppriorcount != ( axth_u32_t * )0 ) {
-				*ppriorcount = uCur;
-			}
+/*
+===============================================================================
 
-			break;
-		}
+	TICKET MUTEX - NON-RECURSIVE, FAIR
 
-		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
-	}
+	Waiters are served in the order they arrived. Each waiter takes a ticket
+	with a single atomic increment and then only reads the lock until its
+	number comes up, backing off in proportion to the number of threads ahead
+	of it. This keeps the lock's cache line quiet under contention, where
+	axth_qmutex_t has every waiter writing to it constantly.
 
-	return 1;
+	Because the lock is handed over strictly in order, a waiter that isn't
+	running when its turn comes stalls everyone behind it. So only the first
+	AXTHREAD_TMUTEX_SPIN_AHEAD waiters spin; the rest park, and each release
+	wakes the waiter that has just become second in line. Spinning waiters
+	that run out of patience (such as when there are more threads than CPUs)
+	park as well.
+
+	Fairness has a price when threads outnumber CPUs: every hand-over then
+	needs a context switch to one particular thread. Prefer axth_amutex_t
+	there, or when waiters may have to wait long enough that sleeping is
+	better than spinning.
+
+===============================================================================
+*/
+
+AXTHREAD__ENTER_C
+
+#ifndef AXTHREAD_TMUTEX_SPIN_COUNT
+# define AXTHREAD_TMUTEX_SPIN_COUNT 32
+#endif
+/* waiters further back in the queue than this park rather than spin */
+#ifndef AXTHREAD_TMUTEX_SPIN_AHEAD
+# define AXTHREAD_TMUTEX_SPIN_AHEAD 2
+#endif
+/* spins a waiter may spend before parking (kept short: the thread being waited on may not be running) */
+#ifndef AXTHREAD_TMUTEX_MAX_SPIN_COUNT
+# define AXTHREAD_TMUTEX_MAX_SPIN_COUNT 1024
+#endif
+
+typedef struct axth_tmutex_s
+{
+	/* next ticket to be handed out */
+	volatile axth_u32_t             uNext;
+	/* ticket of the thread allowed to hold the lock */
+	volatile axth_u32_t             uServing;
+	/* waiters parked on uServing */
+	volatile axth_u32_t             cParked;
+} axth_tmutex_t;
+#define AXTHREAD_TMUTEX_INITIALIZER { 0, 0, 0 }
+
+AXTHREAD_FUNC axth_tmutex_t *AXTHREAD_CALL axth_tmutex_init( axth_tmutex_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	p->uNext = 0;
+	p->uServing = 0;
+	p->cParked = 0;
+	return p;
 }
 #else
 ;
 #endif
-
-AXTHREAD_FUNC int AXTHREAD_CALL axth_qsem_try_wait( axth_qsem_t *p )
+AXTHREAD_FUNC axth_tmutex_t *AXTHREAD_CALL axth_tmutex_fini( axth_tmutex_t *p )
 #if AXTHREAD_IMPLEMENT
 {
-	axth_u32_t uCur;
-	axth_u32_t uNew;
-
-	uCur = p->uCur;
-	if( !uCur ) {
-		return 0;
-	}
-
-	uNew = uCur - 1;
-	return AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uCur, uNew, uCur ) == uNew;
+	( void )p;
+	return ( axth_tmutex_t * )0;
 }
 #else
 ;
 #endif
 
-AXTHREAD_FUNC void AXTHREAD_CALL axth_qsem_wait( axth_qsem_t *p )
+/* Attempt to acquire the lock without waiting (fails if anyone holds or is waiting for it) */
+AXTHREAD_FUNC int AXTHREAD_CALL axth_tmutex_try_acquire( axth_tmutex_t *p )
 #if AXTHREAD_IMPLEMENT
 {
-# if AXTHREAD_QSEM_SLEEP_ENABLED
-	axth_u32_t uBaseMs;
+	axth_u32_t uServing;
 
-	uBaseMs = axtm_milliseconds_lowlatency();
-	while( !axth_qsem_try_wait( p ) ) {
-		axth_u32_t uElapsedMs;
+	uServing = p->uServing;
+	return AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uNext, uServing + 1, uServing ) == uServing;
+}
+#else
+;
+#endif
+/* Acquires the lock (!!! NON-RECURSIVE !!!), spinning cSpins for each thread ahead of the caller */
+AXTHREAD_FUNC void AXTHREAD_CALL axth_tmutex_acquire( axth_tmutex_t *p, axth_u32_t cSpins )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_u32_t uTicket;
+	axth_u32_t uServing;
+	axth_u32_t cAhead;
+	axth_u32_t cWaited;
+
+	uTicket = AX_ATOMIC_FETCH_ADD_FULL32( &p->uNext, 1 );
+
+	cWaited = 0;
+	while( ( uServing = p->uServing ) != uTicket ) {
+		cAhead = uTicket - uServing;
+
+		/* far back in the queue, or a thread ahead isn't running: sleep until nearly our turn */
+		if( cAhead > AXTHREAD_TMUTEX_SPIN_AHEAD || cWaited > AXTHREAD_TMUTEX_MAX_SPIN_COUNT ) {
+			AX_ATOMIC_FETCH_ADD_FULL32( &p->cParked, 1 );
+			if( ( uServing = p->uServing ) != uTicket ) {
+				axth__park( &p->uServing, uServing, ( axth_u32_t )1 << ( uTicket & 31 ) );
+			}
+			AX_ATOMIC_FETCH_SUB_FULL32( &p->cParked, 1 );
 
-		uElapsedMs = axtm_milliseconds_lowlatency() - uBaseMs;
-		if( uElapsedMs >= AXTHREAD_QSEM_SLEEP_RESISTANCE_MS ) {
-			axth_yield();
+			cWaited = 0;
+			continue;
 		}
 
-		axth_local_spin( AXTHREAD_DEFAULT_SPIN_COUNT );
+		axth_local_spin( cAhead*cSpins );
+		cWaited += cAhead*cSpins + 1;
 	}
-# else
-	axth_u32_t cSpin = 1;
 
-	while( !axth_qsem_try_wait( p ) ) {
-		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
-	}
-# endif
+	/* don't let the critical section's accesses move above the wait */
+	AX_COMPILER_FENCE();
 }
 #else
 ;
 #endif
-
-#ifdef INCGUARD_AXTIME_H_
-# define AXTHREAD_QSEM_TIMED_WAIT_DEFINED 1
-AXTHREAD_FUNC int AXTHREAD_CALL axth_qsem_timed_wait( axth_qsem_t *p, axth_u32_t milliseconds )
-# if AXTHREAD_IMPLEMENT
+/* Releases the lock, passing it to the next waiter */
+AXTHREAD_FUNC void AXTHREAD_CALL axth_tmutex_release( axth_tmutex_t *p )
+#if AXTHREAD_IMPLEMENT
 {
-	axth_u32_t uBaseMs;
-	axth_u32_t cSpin = 1;
-
-	uBaseMs = axtm_milliseconds_lowlatency();
-	while( !axth_qsem_try_wait( p ) ) {
-		axth_u32_t uElapsed;
-
-		uElapsed = axtm_milliseconds_lowlatency() - uBaseMs;
-		if( uElapsed >= milliseconds ) {
-			return 0;
-		}
+	axth_u32_t uServing;
 
-#  if AXTHREAD_QSEM_SLEEP_ENABLED
-		if( uElapsed >= AXTHREAD_QSEM_SLEEP_RESISTANCE_MS ) {
-			axth_yield();
-		}
-#  endif
+	uServing = AX_ATOMIC_FETCH_ADD_FULL32( &p->uServing, 1 ) + 1;
 
-		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	/* waiters park on the channel of their ticket; wake whoever is now first and second in line */
+	if( p->cParked != 0 ) {
+		axth__wake( &p->uServing, 1, ( ( axth_u32_t )1 << ( uServing & 31 ) ) | ( ( axth_u32_t )1 << ( ( uServing + 1 ) & 31 ) ) );
 	}
-
-	return 1;
 }
-# else
-;
-# endif
 #else
-# define AXTHREAD_QSEM_TIMED_WAIT_DEFINED 0
-#endif /*INCGUARD_AXTIME_H_*/
+;
+#endif
 
 AXTHREAD__LEAVE_C
 
@@ -3282,53 +3373,55 @@ AXTHREAD__LEAVE_C
 namespace ax
 {
 
-	/// Simple implementation of a semaphore which avoids OS scheduling
-	class CQuickSemaphore
+	/// Fair (first come, first served) spin-lock
+	class CTicketMutex
 	{
 	public:
-		static const axth_u32_t kMaxCount = AXTHREAD_QSEM_MAXIMUM;
-
-		/// Constructor
-		AXTHREAD_INLINE CQuickSemaphore( axth_u32_t baseCount = 0, axth_u32_t maxCount = kMaxCount )
-		: m_semaphore()
+		AXTHREAD_INLINE CTicketMutex()
+		: m_mutex()
 		{
-			if( !axth_qsem_init( &m_semaphore, baseCount, maxCount ) ) {
-				axth_cxx_error( "axth_qsem_init failed" );
+			if( !axth_tmutex_init( &m_mutex ) ) {
+				axth_cxx_error( "axth_tmutex_init failed" );
 			}
 		}
-		/// Destructor
-		AXTHREAD_INLINE ~CQuickSemaphore()
+		AXTHREAD_INLINE ~CTicketMutex()
 		{
-			axth_qsem_fini( &m_semaphore) ;
+			axth_tmutex_fini( &m_mutex );
 		}
-		/// Signal the semaphore (increases current count by the amount given)
-		AXTHREAD_INLINE bool signal( axth_u32_t count = 1, axth_u32_t *pPrevCount = ( axth_u32_t * )0 )
+
+		/// Attempts to acquire the lock without waiting
+		AXTHREAD_INLINE bool tryAcquire()
 		{
-			return !!axth_qsem_signal( &m_semaphore, count, pPrevCount );
+			return !!axth_tmutex_try_acquire( &m_mutex );
 		}
-		/// wait for the semaphore to be signalled (decreases current count by one upon returning)
-		AXTHREAD_INLINE void wait()
+		/// Acquires the lock
+		AXTHREAD_INLINE void acquire( axth_u32_t spinCount = AXTHREAD_TMUTEX_SPIN_COUNT )
 		{
-			axth_qsem_wait( &m_semaphore );
+			axth_tmutex_acquire( &m_mutex, spinCount );
 		}
-#if AXTHREAD_QSEM_TIMED_WAIT_DEFINED
-		/// wait for the semaphore to be signalled for a specific amount of time (decreases current count by one upon returning)
-		AXTHREAD_INLINE bool timedWait( axth_u32_t milliseconds )
+		/// Releases the lock
+		AXTHREAD_INLINE void release()
 		{
-			return !!axth_qsem_timed_wait( &m_semaphore, milliseconds );
+			axth_tmutex_release( &m_mutex );
 		}
-#endif
-		/// Check to see whether this signal is triggered (this will decrement upon successful return)
-		AXTHREAD_INLINE bool tryWait()
+
+
+		// For compatibility with TLockGuard<>
+
+		AXTHREAD_INLINE void lock()
 		{
-			return !!axth_qsem_try_wait( &m_semaphore );
+			acquire();
+		}
+		AXTHREAD_INLINE void unlock()
+		{
+			release();
 		}
 
 	private:
-		axth_qsem_t                 m_semaphore;
+		axth_tmutex_t               m_mutex;
 
 # ifdef AX_DELETE_COPYFUNCS
-		AX_DELETE_COPYFUNCS( CQuickSemaphore );
+		AX_DELETE_COPYFUNCS( CTicketMutex );
 # endif
 	};
 
@@ -3341,52 +3434,433 @@ namespace ax
 /*
 ===============================================================================
 
-	READ / WRITE LOCK
+	ADAPTIVE MUTEX - NON-RECURSIVE
+
+	Spins briefly, then sleeps in the kernel until the lock is released. The
+	uncontended paths are a single atomic operation and never enter the
+	kernel. (See PARKING for how waiters sleep.)
+
+	The lock's value is 0 when free, 1 when held, and 2 when held with threads
+	(possibly) asleep on it.
 
 ===============================================================================
 */
 
 AXTHREAD__ENTER_C
 
-typedef struct axth_rwlock_s
-{
-	volatile axth_u32_t cReaders;
-	volatile axth_u32_t uWriting;
-} axth_rwlock_t;
-
-#define AXTHREAD_RWLOCK_MAX_READERS ((axth_u32_t)128)
-#define AXTHREAD_RWLOCK_INITIALIZER {((axth_u32_t)0),((axth_u32_t)0)}
-
-#if AXTHREAD_IMPLEMENT
-static void axth_rwlock__acquire_write_privilege( axth_rwlock_t *p )
-{
-	axth_u32_t cSpin = 1;
-	while( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uWriting, 1, 0 ) != 1 ) {
-		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
-	}
-}
-static void axth_rwlock__release_write_privilege( axth_rwlock_t *p )
-{
-	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriting, 0 );
-}
-#endif
+typedef volatile axth_u32_t axth_amutex_t;
+#define AXTHREAD_AMUTEX_INITIALIZER ((axth_u32_t)0)
 
-AXTHREAD_FUNC axth_rwlock_t *AXTHREAD_CALL axth_rwlock_init( axth_rwlock_t *p )
+AXTHREAD_FUNC axth_amutex_t *AXTHREAD_CALL axth_amutex_init( axth_amutex_t *p )
 #if AXTHREAD_IMPLEMENT
 {
-	p->cReaders = 0;
-	p->uWriting = 0;
-
+	*p = AXTHREAD_AMUTEX_INITIALIZER;
 	return p;
 }
 #else
 ;
 #endif
-AXTHREAD_FUNC axth_rwlock_t *AXTHREAD_CALL axth_rwlock_fini( axth_rwlock_t *p )
+AXTHREAD_FUNC axth_amutex_t *AXTHREAD_CALL axth_amutex_fini( axth_amutex_t *p )
 #if AXTHREAD_IMPLEMENT
 {
 	( void )p;
-	return ( axth_rwlock_t * )0;
+	return ( axth_amutex_t * )0;
+}
+#else
+;
+#endif
+
+/* Attempt to acquire the lock without waiting */
+AXTHREAD_FUNC int AXTHREAD_CALL axth_amutex_try_acquire( axth_amutex_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	return AX_ATOMIC_COMPARE_EXCHANGE_FULL32( p, 1, 0 ) == 0;
+}
+#else
+;
+#endif
+/* Acquires the lock (!!! NON-RECURSIVE !!!), trying cSpins times before sleeping */
+AXTHREAD_FUNC void AXTHREAD_CALL axth_amutex_acquire( axth_amutex_t *p, axth_u32_t cSpins )
+#if AXTHREAD_IMPLEMENT
+{
+	/* only read while spinning, so the holder's cache line isn't stolen */
+	while( cSpins-- > 0 ) {
+		if( *p == 0 && AX_ATOMIC_COMPARE_EXCHANGE_FULL32( p, 1, 0 ) == 0 ) {
+			return;
+		}
+
+		AX_CPU_PAUSE();
+	}
+
+	/* mark the lock as having sleepers; seeing 0 means it was taken */
+	while( AX_ATOMIC_EXCHANGE_FULL32( p, 2 ) != 0 ) {
+		axth__park( p, 2, AXTHREAD__PARK_ANY );
+	}
+}
+#else
+;
+#endif
+/* Releases the lock, waking a sleeper if there are any */
+AXTHREAD_FUNC void AXTHREAD_CALL axth_amutex_release( axth_amutex_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	if( AX_ATOMIC_EXCHANGE_FULL32( p, 0 ) == 2 ) {
+		axth__wake( p, 0, AXTHREAD__PARK_ANY );
+	}
+}
+#else
+;
+#endif
+
+AXTHREAD__LEAVE_C
+
+#if AXTHREAD_CXX_ENABLED
+namespace ax
+{
+
+	/// Mutex that spins briefly and then sleeps until released
+	class CAdaptiveMutex
+	{
+	public:
+		AXTHREAD_INLINE CAdaptiveMutex()
+		: m_mutex()
+		{
+			if( !axth_amutex_init( &m_mutex ) ) {
+				axth_cxx_error( "axth_amutex_init failed" );
+			}
+		}
+		AXTHREAD_INLINE ~CAdaptiveMutex()
+		{
+			axth_amutex_fini( &m_mutex );
+		}
+
+		/// Attempts to acquire the lock without waiting
+		AXTHREAD_INLINE bool tryAcquire()
+		{
+			return !!axth_amutex_try_acquire( &m_mutex );
+		}
+		/// Acquires the lock
+		AXTHREAD_INLINE void acquire( axth_u32_t spinCount = AXTHREAD_DEFAULT_SPIN_COUNT )
+		{
+			axth_amutex_acquire( &m_mutex, spinCount );
+		}
+		/// Releases the lock
+		AXTHREAD_INLINE void release()
+		{
+			axth_amutex_release( &m_mutex );
+		}
+		/// Retrieves the current value of the lock
+		AXTHREAD_INLINE axth_u32_t getValue() const
+		{
+			return m_mutex;
+		}
+
+
+		// For compatibility with TLockGuard<>
+
+		AXTHREAD_INLINE void lock()
+		{
+			acquire();
+		}
+		AXTHREAD_INLINE void unlock()
+		{
+			release();
+		}
+
+	private:
+		axth_amutex_t               m_mutex;
+
+# ifdef AX_DELETE_COPYFUNCS
+		AX_DELETE_COPYFUNCS( CAdaptiveMutex );
+# endif
+	};
+
+}
+#endif /*AXTHREAD_CXX_ENABLED*/
+
+
+
+
+/*
+===============================================================================
+
+	QUICK (SPIN) SEMAPHORE - NON-RECURSIVE
+
+===============================================================================
+*/
+
+AXTHREAD__ENTER_C
+
+#ifndef AXTHREAD_QSEM_SLEEP_ENABLED
+# ifdef INCGUARD_AXTIME_H_
+#  define AXTHREAD_QSEM_SLEEP_ENABLED 1
+# else
+#  define AXTHREAD_QSEM_SLEEP_ENABLED 0
+# endif
+#endif
+#ifndef AXTHREAD_QSEM_SLEEP_RESISTANCE_MS
+# define AXTHREAD_QSEM_SLEEP_RESISTANCE_MS 20
+#endif
+
+typedef struct axth_qsem_s
+{
+	volatile axth_u32_t             uCur;
+	axth_u32_t                      uMax;
+} axth_qsem_t;
+
+#define AXTHREAD_QSEM_MAXIMUM       ((axth_u32_t)0x7FFFFFFFUL)
+#define AXTHREAD_QSEM_INITIALIZER   {((axth_u32_t)0),AXTHREAD_QSEM_MAXIMUM}
+
+AXTHREAD_FUNC axth_qsem_t *AXTHREAD_CALL axth_qsem_init( axth_qsem_t *p, axth_u32_t uBase, axth_u32_t uMax )
+#if AXTHREAD_IMPLEMENT
+{
+	if( uBase > uMax ) {
+		return ( axth_qsem_t * )0;
+	}
+
+	p->uCur = uBase;
+	p->uMax = uMax;
+
+	return p;
+}
+#else
+;
+#endif
+AXTHREAD_FUNC axth_qsem_t *AXTHREAD_CALL axth_qsem_fini( axth_qsem_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	( void )p;
+	return ( axth_qsem_t * )0;
+}
+#else
+;
+#endif
+
+AXTHREAD_FUNC int AXTHREAD_CALL axth_qsem_signal( axth_qsem_t *p, axth_u32_t count, axth_u32_t *ppriorcount )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_u32_t uMax;
+	axth_u32_t cSpin = 1;
+
+	uMax = p->uMax;
+	for(;;) {
+		const axth_u32_t uCur = p->uCur;
+		const axth_u32_t uNew = uCur + count;
+
+		if( uNew > uMax ) {
+			return 0;
+		}
+
+		if( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uCur, uNew, uCur ) == uCur ) {
+			if( ppriorcount != ( axth_u32_t * )0 ) {
+				*ppriorcount = uCur;
+			}
+
+			break;
+		}
+
+		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	}
+
+	return 1;
+}
+#else
+;
+#endif
+
+AXTHREAD_FUNC int AXTHREAD_CALL axth_qsem_try_wait( axth_qsem_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_u32_t uCur;
+	axth_u32_t uNew;
+
+	uCur = p->uCur;
+	if( !uCur ) {
+		return 0;
+	}
+
+	uNew = uCur - 1;
+	return AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uCur, uNew, uCur ) == uCur;
+}
+#else
+;
+#endif
+
+AXTHREAD_FUNC void AXTHREAD_CALL axth_qsem_wait( axth_qsem_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+# if AXTHREAD_QSEM_SLEEP_ENABLED
+	axth_u32_t uBaseMs;
+
+	uBaseMs = axtm_milliseconds_lowlatency();
+	while( !axth_qsem_try_wait( p ) ) {
+		axth_u32_t uElapsedMs;
+
+		uElapsedMs = axtm_milliseconds_lowlatency() - uBaseMs;
+		if( uElapsedMs >= AXTHREAD_QSEM_SLEEP_RESISTANCE_MS ) {
+			axth_yield();
+		}
+
+		axth_local_spin( AXTHREAD_DEFAULT_SPIN_COUNT );
+	}
+# else
+	axth_u32_t cSpin = 1;
+
+	while( !axth_qsem_try_wait( p ) ) {
+		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	}
+# endif
+}
+#else
+;
+#endif
+
+#ifdef INCGUARD_AXTIME_H_
+# define AXTHREAD_QSEM_TIMED_WAIT_DEFINED 1
+AXTHREAD_FUNC int AXTHREAD_CALL axth_qsem_timed_wait( axth_qsem_t *p, axth_u32_t milliseconds )
+# if AXTHREAD_IMPLEMENT
+{
+	axth_u32_t uBaseMs;
+	axth_u32_t cSpin = 1;
+
+	uBaseMs = axtm_milliseconds_lowlatency();
+	while( !axth_qsem_try_wait( p ) ) {
+		axth_u32_t uElapsed;
+
+		uElapsed = axtm_milliseconds_lowlatency() - uBaseMs;
+		if( uElapsed >= milliseconds ) {
+			return 0;
+		}
+
+#  if AXTHREAD_QSEM_SLEEP_ENABLED
+		if( uElapsed >= AXTHREAD_QSEM_SLEEP_RESISTANCE_MS ) {
+			axth_yield();
+		}
+#  endif
+
+		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	}
+
+	return 1;
+}
+# else
+;
+# endif
+#else
+# define AXTHREAD_QSEM_TIMED_WAIT_DEFINED 0
+#endif /*INCGUARD_AXTIME_H_*/
+
+AXTHREAD__LEAVE_C
+
+#if AXTHREAD_CXX_ENABLED
+namespace ax
+{
+
+	/// Simple implementation of a semaphore which avoids OS scheduling
+	class CQuickSemaphore
+	{
+	public:
+		static const axth_u32_t kMaxCount = AXTHREAD_QSEM_MAXIMUM;
+
+		/// Constructor
+		AXTHREAD_INLINE CQuickSemaphore( axth_u32_t baseCount = 0, axth_u32_t maxCount = kMaxCount )
+		: m_semaphore()
+		{
+			if( !axth_qsem_init( &m_semaphore, baseCount, maxCount ) ) {
+				axth_cxx_error( "axth_qsem_init failed" );
+			}
+		}
+		/// Destructor
+		AXTHREAD_INLINE ~CQuickSemaphore()
+		{
+			axth_qsem_fini( &m_semaphore) ;
+		}
+		/// Signal the semaphore (increases current count by the amount given)
+		AXTHREAD_INLINE bool signal( axth_u32_t count = 1, axth_u32_t *pPrevCount = ( axth_u32_t * )0 )
+		{
+			return !!axth_qsem_signal( &m_semaphore, count, pPrevCount );
+		}
+		/// wait for the semaphore to be signalled (decreases current count by one upon returning)
+		AXTHREAD_INLINE void wait()
+		{
+			axth_qsem_wait( &m_semaphore );
+		}
+#if AXTHREAD_QSEM_TIMED_WAIT_DEFINED
+		/// wait for the semaphore to be signalled for a specific amount of time (decreases current count by one upon returning)
+		AXTHREAD_INLINE bool timedWait( axth_u32_t milliseconds )
+		{
+			return !!axth_qsem_timed_wait( &m_semaphore, milliseconds );
+		}
+#endif
+		/// Check to see whether this signal is triggered (this will decrement upon successful return)
+		AXTHREAD_INLINE bool tryWait()
+		{
+			return !!axth_qsem_try_wait( &m_semaphore );
+		}
+
+	private:
+		axth_qsem_t                 m_semaphore;
+
+# ifdef AX_DELETE_COPYFUNCS
+		AX_DELETE_COPYFUNCS( CQuickSemaphore );
+# endif
+	};
+
+}
+#endif /*AXTHREAD_CXX_ENABLED*/
+
+
+
+
+/*
+===============================================================================
+
+	READ / WRITE LOCK
+
+===============================================================================
+*/
+
+AXTHREAD__ENTER_C
+
+typedef struct axth_rwlock_s
+{
+	volatile axth_u32_t cReaders;
+	volatile axth_u32_t uWriting;
+} axth_rwlock_t;
+
+#define AXTHREAD_RWLOCK_MAX_READERS ((axth_u32_t)128)
+#define AXTHREAD_RWLOCK_INITIALIZER {((axth_u32_t)0),((axth_u32_t)0)}
+
+#if AXTHREAD_IMPLEMENT
+static void axth_rwlock__acquire_write_privilege( axth_rwlock_t *p )
+{
+	axth_u32_t cSpin = 1;
+	while( AX_ATOMIC_COMPARE_EXCHANGE_FULL32( &p->uWriting, 1, 0 ) != 0 ) {
+		axth_backoff( &cSpin, AXTHREAD_MAX_BACKOFF_SPIN_COUNT );
+	}
+}
+static void axth_rwlock__release_write_privilege( axth_rwlock_t *p )
+{
+	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriting, 0 );
+}
+#endif
+
+AXTHREAD_FUNC axth_rwlock_t *AXTHREAD_CALL axth_rwlock_init( axth_rwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	p->cReaders = 0;
+	p->uWriting = 0;
+
+	return p;
+}
+#else
+;
+#endif
+AXTHREAD_FUNC axth_rwlock_t *AXTHREAD_CALL axth_rwlock_fini( axth_rwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	( void )p;
+	return ( axth_rwlock_t * )0;
 }
 #else
 ;
@@ -3587,6 +4061,390 @@ namespace ax
 
 
 
+/*
+===============================================================================
+
+	SCALABLE READ / WRITE LOCK
+
+	Readers are counted in per-worker slots (indexed by axth_get_worker_id()),
+	each on its own cache line, so readers on different workers never write
+	to the same memory. A read acquisition costs one atomic increment on the
+	reader's own slot and a read of the writer flag.
+	The price is size: each lock takes AXTHREAD_SRWLOCK_SLOTS cache lines
+	(2KB by default), so keep it for locks that are hot.
+
+	Writers take priority. Once a writer has announced itself new readers give
+	way, and the writer only waits for the readers already inside to leave.
+	Readers waiting on a writer, and a writer waiting on readers, spin
+	briefly and then park (see PARKING).
+
+	Threads that never called axth_set_worker_id() all share slot 0; they are
+	still correct, but only scale as well as axth_rwlock_t. A read lock may be
+	released from a different worker than the one that took it (such as by a
+	job that moved to another thread).
+
+	Read locks are NOT recursive: a reader that takes the lock again while a
+	writer is waiting will deadlock.
+
+===============================================================================
+*/
+
+AXTHREAD__ENTER_C
+
+/* number of reader slots (must be a power of two) */
+#ifndef AXTHREAD_SRWLOCK_SLOTS
+# define AXTHREAD_SRWLOCK_SLOTS     32
+#endif
+/* number of times a waiter checks the lock before parking */
+#ifndef AXTHREAD_SRWLOCK_SPIN_COUNT
+# define AXTHREAD_SRWLOCK_SPIN_COUNT 1024
+#endif
+#ifndef AXTHREAD__CACHE_LINE
+# define AXTHREAD__CACHE_LINE       64
+#endif
+
+typedef struct axth_srwlock__slot_s
+{
+	/* readers inside (or entering) the lock on this slot; may wrap if readers move between workers */
+	volatile axth_u32_t             cReaders;
+	char                            Padding[ AXTHREAD__CACHE_LINE - sizeof( axth_u32_t ) ];
+} axth_srwlock__slot_t;
+
+typedef struct axth_srwlock_s
+{
+	/* reader counts, one cache line each */
+	axth_srwlock__slot_t            Slots[ AXTHREAD_SRWLOCK_SLOTS ];
+	/* 0 if no writer; 1 if a writer holds or wants the lock; 2 if it is also parked waiting on readers */
+	volatile axth_u32_t             uWriter;
+	/* readers parked on uWriter */
+	volatile axth_u32_t             cParkedReaders;
+	/* bumped by readers leaving while the writer is parked; the writer parks on this */
+	volatile axth_u32_t             uDrainSeq;
+	/* only one writer at a time */
+	axth_amutex_t                   WriterLock;
+} axth_srwlock_t;
+
+#define AXTHREAD_SRWLOCK_INITIALIZER { { { 0 } } }
+
+#if AXTHREAD_IMPLEMENT
+static volatile axth_u32_t *axth_srwlock__slot( axth_srwlock_t *p )
+{
+	return &p->Slots[ axth_get_worker_id() & ( AXTHREAD_SRWLOCK_SLOTS - 1 ) ].cReaders;
+}
+/* implementation: number of readers inside the lock (slots may individually wrap but not the sum) */
+static axth_u32_t axth_srwlock__count_readers( const axth_srwlock_t *p )
+{
+	axth_u32_t cReaders;
+	axth_u32_t i;
+
+	cReaders = 0;
+	for( i = 0; i < AXTHREAD_SRWLOCK_SLOTS; ++i ) {
+		cReaders += p->Slots[ i ].cReaders;
+	}
+
+	return cReaders;
+}
+/* implementation: leave a slot, letting a parked writer know */
+static void axth_srwlock__leave( axth_srwlock_t *p, volatile axth_u32_t *pSlot )
+{
+	AX_ATOMIC_FETCH_SUB_FULL32( pSlot, 1 );
+	if( p->uWriter == 2 ) {
+		AX_ATOMIC_FETCH_ADD_FULL32( &p->uDrainSeq, 1 );
+		axth__wake( &p->uDrainSeq, 0, AXTHREAD__PARK_ANY );
+	}
+}
+/* implementation: enter a slot unless a writer holds or wants the lock */
+static int axth_srwlock__enter( axth_srwlock_t *p )
+{
+	volatile axth_u32_t *pSlot;
+
+	pSlot = axth_srwlock__slot( p );
+
+	AX_ATOMIC_FETCH_ADD_FULL32( pSlot, 1 );
+	if( p->uWriter == 0 ) {
+		return 1;
+	}
+
+	axth_srwlock__leave( p, pSlot );
+	return 0;
+}
+/* implementation: wait until the lock was drained of readers */
+static void axth_srwlock__drain( axth_srwlock_t *p )
+{
+	axth_u32_t uSeq;
+	axth_u32_t cSpins;
+
+	for( cSpins = AXTHREAD_SRWLOCK_SPIN_COUNT; cSpins > 0; --cSpins ) {
+		if( axth_srwlock__count_readers( p ) == 0 ) {
+			return;
+		}
+
+		AX_CPU_PAUSE();
+	}
+
+	/* readers leaving from here on bump uDrainSeq and wake us */
+	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriter, 2 );
+	for(;;) {
+		uSeq = p->uDrainSeq;
+		if( axth_srwlock__count_readers( p ) == 0 ) {
+			break;
+		}
+
+		axth__park( &p->uDrainSeq, uSeq, AXTHREAD__PARK_ANY );
+	}
+	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriter, 1 );
+}
+#endif
+
+AXTHREAD_FUNC axth_srwlock_t *AXTHREAD_CALL axth_srwlock_init( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_u32_t i;
+
+	for( i = 0; i < AXTHREAD_SRWLOCK_SLOTS; ++i ) {
+		p->Slots[ i ].cReaders = 0;
+	}
+
+	p->uWriter = 0;
+	p->cParkedReaders = 0;
+	p->uDrainSeq = 0;
+	axth_amutex_init( &p->WriterLock );
+
+	return p;
+}
+#else
+;
+#endif
+AXTHREAD_FUNC axth_srwlock_t *AXTHREAD_CALL axth_srwlock_fini( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_amutex_fini( &p->WriterLock );
+	return ( axth_srwlock_t * )0;
+}
+#else
+;
+#endif
+
+AXTHREAD_FUNC int AXTHREAD_CALL axth_srwlock_try_rdacquire( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	return axth_srwlock__enter( p );
+}
+#else
+;
+#endif
+AXTHREAD_FUNC void AXTHREAD_CALL axth_srwlock_rdacquire( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_u32_t uWriter;
+	axth_u32_t cSpins;
+
+	while( !axth_srwlock__enter( p ) ) {
+		/* give way to the writer */
+		for( cSpins = AXTHREAD_SRWLOCK_SPIN_COUNT; cSpins > 0 && p->uWriter != 0; --cSpins ) {
+			AX_CPU_PAUSE();
+		}
+
+		AX_ATOMIC_FETCH_ADD_FULL32( &p->cParkedReaders, 1 );
+		if( ( uWriter = p->uWriter ) != 0 ) {
+			axth__park( &p->uWriter, uWriter, AXTHREAD__PARK_ANY );
+		}
+		AX_ATOMIC_FETCH_SUB_FULL32( &p->cParkedReaders, 1 );
+	}
+
+	/* don't let the critical section's accesses move above the acquisition */
+	AX_COMPILER_FENCE();
+}
+#else
+;
+#endif
+AXTHREAD_FUNC void AXTHREAD_CALL axth_srwlock_rdrelease( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_srwlock__leave( p, axth_srwlock__slot( p ) );
+}
+#else
+;
+#endif
+
+AXTHREAD_FUNC int AXTHREAD_CALL axth_srwlock_try_wracquire( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	if( !axth_amutex_try_acquire( &p->WriterLock ) ) {
+		return 0;
+	}
+
+	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriter, 1 );
+	if( axth_srwlock__count_readers( p ) != 0 ) {
+		AX_ATOMIC_EXCHANGE_FULL32( &p->uWriter, 0 );
+		if( p->cParkedReaders != 0 ) {
+			axth__wake( &p->uWriter, 1, AXTHREAD__PARK_ANY );
+		}
+
+		axth_amutex_release( &p->WriterLock );
+		return 0;
+	}
+
+	AX_COMPILER_FENCE();
+	return 1;
+}
+#else
+;
+#endif
+AXTHREAD_FUNC void AXTHREAD_CALL axth_srwlock_wracquire( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	axth_amutex_acquire( &p->WriterLock, AXTHREAD_DEFAULT_SPIN_COUNT );
+
+	/* turn new readers away, then wait for the ones already inside */
+	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriter, 1 );
+	axth_srwlock__drain( p );
+
+	AX_COMPILER_FENCE();
+}
+#else
+;
+#endif
+AXTHREAD_FUNC void AXTHREAD_CALL axth_srwlock_wrrelease( axth_srwlock_t *p )
+#if AXTHREAD_IMPLEMENT
+{
+	AX_ATOMIC_EXCHANGE_FULL32( &p->uWriter, 0 );
+	if( p->cParkedReaders != 0 ) {
+		axth__wake( &p->uWriter, 1, AXTHREAD__PARK_ANY );
+	}
+
+	axth_amutex_release( &p->WriterLock );
+}
+#else
+;
+#endif
+
+AXTHREAD__LEAVE_C
+
+#if AXTHREAD_CXX_ENABLED
+namespace ax
+{
+
+	/// Writer-preferring read/write lock whose readers don't contend with each other
+	class CScalableRWLock
+	{
+	public:
+									/// Constructor
+		AXTHREAD_INLINE             CScalableRWLock     ()
+									: m_rwLock()
+									{
+										if( !axth_srwlock_init( &m_rwLock ) ) {
+											axth_cxx_error( "axth_srwlock_init failed" );
+										}
+									}
+									/// Destructor
+		AXTHREAD_INLINE             ~CScalableRWLock    ()
+									{
+										axth_srwlock_fini( &m_rwLock );
+									}
+
+									/// Try to acquire read access; return immediately upon failure
+		AXTHREAD_INLINE bool        tryReadLock         ()
+									{
+										return !!axth_srwlock_try_rdacquire( &m_rwLock );
+									}
+									/// acquire read access
+		AXTHREAD_INLINE void        readLock            ()
+									{
+										axth_srwlock_rdacquire( &m_rwLock );
+									}
+									/// release read access
+		AXTHREAD_INLINE void        readUnlock          ()
+									{
+										axth_srwlock_rdrelease( &m_rwLock );
+									}
+									/// Try to acquire write access; return immediately upon failure
+		AXTHREAD_INLINE bool        tryWriteLock        ()
+									{
+										return !!axth_srwlock_try_wracquire( &m_rwLock );
+									}
+									/// acquire write access
+		AXTHREAD_INLINE void        writeLock           ()
+									{
+										axth_srwlock_wracquire( &m_rwLock );
+									}
+									/// release write access
+		AXTHREAD_INLINE void        writeUnlock         ()
+									{
+										axth_srwlock_wrrelease( &m_rwLock );
+									}
+
+		AXTHREAD_INLINE             operator axth_srwlock_t &()
+									{
+										return m_rwLock;
+									}
+
+	private:
+		axth_srwlock_t              m_rwLock;
+
+# ifdef AX_DELETE_COPYFUNCS
+		AX_DELETE_COPYFUNCS( CScalableRWLock );
+# endif
+	};
+
+	/// Scope-based read-locker for axth_srwlock_t
+	class ScalableReadLockGuard
+	{
+	public:
+		typedef axth_srwlock_t      mutex_type;
+
+									/// acquire a lock (for automatic release on destruct)
+		AXTHREAD_INLINE             ScalableReadLockGuard( mutex_type &m )
+									: m_mutex( m )
+									{
+										axth_srwlock_rdacquire( &m_mutex );
+									}
+									/// release the acquired lock
+		AXTHREAD_INLINE             ~ScalableReadLockGuard()
+									{
+										axth_srwlock_rdrelease( &m_mutex );
+									}
+
+	private:
+		mutex_type &                m_mutex;
+
+# ifdef AX_DELETE_COPYFUNCS
+		AX_DELETE_COPYFUNCS( ScalableReadLockGuard );
+# endif
+	};
+
+	/// Scope-based write-locker for axth_srwlock_t
+	class ScalableWriteLockGuard
+	{
+	public:
+		typedef axth_srwlock_t      mutex_type;
+
+									/// acquire a lock (for automatic release on destruct)
+		AXTHREAD_INLINE             ScalableWriteLockGuard( mutex_type &m )
+									: m_mutex( m )
+									{
+										axth_srwlock_wracquire( &m_mutex );
+									}
+									/// release the acquired lock
+		AXTHREAD_INLINE             ~ScalableWriteLockGuard()
+									{
+										axth_srwlock_wrrelease( &m_mutex );
+									}
+
+	private:
+		mutex_type &                m_mutex;
+
+# ifdef AX_DELETE_COPYFUNCS
+		AX_DELETE_COPYFUNCS( ScalableWriteLockGuard );
+# endif
+	};
+
+}
+#endif
+
+
+
+
 /*
 ===============================================================================
 
@@ -4112,6 +4970,8 @@ namespace ax
 	};
 
 	typedef TLockGuard<CQuickMutex> CQuickMutexGuard;
+	typedef TLockGuard<CTicketMutex> CTicketMutexGuard;
+	typedef TLockGuard<CAdaptiveMutex> CAdaptiveMutexGuard;
 
 }
 #endif
@@ -467,8 +467,10 @@ namespace ax
 
 #if AXTIME_IMPLEMENT
 
+/* (split to keep T_*R_ from overflowing; the remainder is below F_, so that product fits) */
 # define axtm__convres(T_,F_,R_)\
-	(((axtm_u64_t)(T_))*((axtm_u64_t)(R_))/((axtm_u64_t)(F_)))
+	(((axtm_u64_t)(T_))/((axtm_u64_t)(F_))*((axtm_u64_t)(R_)) +\
+	((axtm_u64_t)(T_))%((axtm_u64_t)(F_))*((axtm_u64_t)(R_))/((axtm_u64_t)(F_)))
 
 # ifndef AXTIME_PLATFORM_DEFINED
 #  define AXTIME_PLATFORM_WINDOWS   0
@@ -624,7 +626,7 @@ AXTIME_FUNC int AXTIME_CALL axtm_nanoseconds( int *psec, int *pnanosec )
 	}
 
 	*psec = (int)axtm__convfreq( t, 1 );
-	*pnanosec = (int)axtm__convfreq( t, AXTIME_NANOSECS )%AXTIME_NANOSECS;
+	*pnanosec = (int)( axtm__convfreq( t, AXTIME_NANOSECS )%AXTIME_NANOSECS );
 
 	return 1;
 }
@@ -83,6 +83,14 @@
 #  define  AXFIBER_IMPLEMENTATION
 # endif
 
+# ifndef AXLIB_NO_JOB
+#  define    AXJOB_IMPLEMENTATION
+# endif
+
+# ifndef AXLIB_NO_PROFILE
+#  define    AXPROF_IMPLEMENTATION
+# endif
+
 # ifndef AXLIB_NO_LOG
 #  define    AXLOG_IMPLEMENTATION
 # endif
@@ -128,6 +136,8 @@
 #include "ax_time.h"
 #include "ax_thread.h"
 #include "ax_fiber.h"
+#include "ax_job.h"
+#include "ax_profile.h"
 
 /* Utility libraries */
 #include "ax_config.h"
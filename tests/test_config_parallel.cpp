@@ -0,0 +1,237 @@
+/*
+
+	test_config_parallel - axconf_lex_parallel matches axconf_lex
+
+	c++ -O2 -I include tests/test_config_parallel.cpp -o test_config_parallel -lpthread
+
+	Lexes the same buffer with axconf_lex and with axconf_lex_parallel, and
+	checks that both give the same tokens (type, extent, flags, and line info)
+	and the same reports in the same order. The chunk size is lowered to 64
+	bytes so that even small inputs are split many times. The inputs are a
+	handful of hand-written configurations with strings and comments spanning
+	split points, and a few hundred random ones built from fragments chosen to
+	land next to section lines. Exits with 0 on success.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+#define AXCONF_PARALLEL_MIN_CHUNK 64
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXMM_IMPLEMENTATION
+#define AXFIBER_IMPLEMENTATION
+#define AXJOB_IMPLEMENTATION
+#define AXSTR_IMPLEMENTATION
+#define AXCONF_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_memory.h"
+#include "ax_fiber.h"
+#include "ax_job.h"
+#include "ax_config.h"
+
+/* number of random configurations */
+#define RANDOM_CONFIGS 400
+
+static axjob_system_t               g_Jobs;
+static int                          g_cFailures;
+
+static void fail( const char *pszName, const char *pszMessage, unsigned uIndex )
+{
+	if( ++g_cFailures <= 10 ) {
+		fprintf( stderr, "test_config_parallel: %s: %s (at %u)\n", pszName, pszMessage, uIndex );
+	}
+}
+
+static void check( const char *pszName, const std::string &src, unsigned cMaxChunks )
+{
+	axconf_t seq, par;
+	axconf_token_t *t;
+	unsigned i;
+
+	axconf_init( &seq );
+	axconf_init( &par );
+	axconf_set_filename( &seq, "test.cfg" );
+	axconf_set_filename( &par, "test.cfg" );
+	axconf_set_buffer_ref( &seq, src.data(), src.size() );
+	axconf_set_buffer_ref( &par, src.data(), src.size() );
+
+	do {
+		t = axconf_lex( &seq );
+	} while( t != ( axconf_token_t * )0 && t->type != kAxconfTok_EOF );
+	const int bSeqDone = t != ( axconf_token_t * )0;
+
+	if( axconf_lex_parallel( &par, &g_Jobs, cMaxChunks ) != bSeqDone ) {
+		fail( pszName, "lexing stopped in one mode but not the other", 0 );
+	}
+
+	/* compare by offset; the two configs share the buffer */
+	const axconf_token_link_t *x = seq.l_head;
+	for( i = 0; ( t = axconf_lex( &par ) ) != ( axconf_token_t * )0; ++i, x = x->l_next ) {
+		if( !x ) {
+			fail( pszName, "more tokens in parallel", i );
+			break;
+		}
+
+		if( t->type != x->tok.type || t->pLexanS != x->tok.pLexanS || t->pLexanE != x->tok.pLexanE || t->uFlags != x->tok.uFlags ) {
+			fail( pszName, "tokens differ", i );
+			break;
+		}
+
+		axconf_lineinfo_t seqLine, parLine;
+		axconf_get_lineinfo( &seqLine, &seq, &x->tok );
+		axconf_get_lineinfo( &parLine, &par, t );
+		if( seqLine.uLine != parLine.uLine || seqLine.uColumn != parLine.uColumn ) {
+			fail( pszName, "line info differs", i );
+			break;
+		}
+
+		if( t->type == kAxconfTok_EOF ) {
+			x = x->l_next;
+			break;
+		}
+	}
+	if( !t && x != ( const axconf_token_link_t * )0 ) {
+		fail( pszName, "fewer tokens in parallel", i );
+	}
+
+	const axconf_report_t *rs = axconf_first_report( &seq );
+	const axconf_report_t *rp = axconf_first_report( &par );
+	for( i = 0; rs != ( const axconf_report_t * )0 && rp != ( const axconf_report_t * )0; ++i ) {
+		if( rs->MessageId != rp->MessageId || rs->Severity != rp->Severity || rs->Location.uLine != rp->Location.uLine || rs->Location.uColumn != rp->Location.uColumn ) {
+			fail( pszName, "reports differ", i );
+			break;
+		}
+		if( rp->pConfig != &par ) {
+			fail( pszName, "report belongs to a chunk", i );
+			break;
+		}
+
+		rs = axconf_next_report( rs );
+		rp = axconf_next_report( rp );
+	}
+	if( ( rs != ( const axconf_report_t * )0 ) != ( rp != ( const axconf_report_t * )0 ) ) {
+		fail( pszName, "different number of reports", i );
+	}
+
+	axconf_fini( &seq );
+	axconf_fini( &par );
+}
+
+/* configurations built from fragments that like to straddle a split */
+static std::string randomConfig( unsigned &x )
+{
+	static const char *const pszFragments[] = {
+		"[section]\n",
+		"[sect.sub]\r\n",
+		"k = 1.5e3\n",
+		"k = 1.5e",
+		"k = 2e+7",
+		"k = 0x1F\n",
+		"k = 0b101",
+		"k = 077",
+		"k = 1.",
+		"k = 12",
+		"k := \"str\"\n",
+		"k = \"multi\n[notsect]\nline\"\n",
+		"k = \"unterminated\n",
+		"/* block\n[inside] */\n",
+		"/* unterminated\n",
+		"// line comment [x]\n",
+		"# hash\n",
+		"; semi\n",
+		"flags += [ a, b, c ]\n",
+		"*tag +other\n",
+		"!directive here\n",
+		"[\n",
+		"\n",
+		"\r",
+		" \t",
+		"=",
+		"e3\n",
+	};
+	static const unsigned cFragments = sizeof( pszFragments )/sizeof( pszFragments[ 0 ] );
+
+	std::string s;
+	x = x*1664525 + 1013904223;
+	const unsigned cParts = 8 + ( x >> 8 )%120;
+
+	for( unsigned i = 0; i < cParts; ++i ) {
+		x = x*1664525 + 1013904223;
+		s += pszFragments[ ( x >> 12 )%cFragments ];
+
+		/* make section lines (and thus splits) frequent */
+		if( ( x >> 24 )%3 == 0 ) {
+			s += "\n[s]\n";
+		}
+	}
+
+	return s;
+}
+
+int main()
+{
+	axjob_config_t cfg;
+
+	memset( ( void * )&cfg, 0, sizeof( cfg ) );
+	cfg.cWorkers = 4;
+	if( !axjob_init( &g_Jobs, &cfg ) ) {
+		fprintf( stderr, "test_config_parallel: axjob_init failed\n" );
+		return 1;
+	}
+
+	std::string s = "*tag1 +tag2\n";
+	for( int i = 0; i < 400; ++i ) {
+		char szBuf[ 256 ];
+
+		snprintf( szBuf, sizeof( szBuf ), "[sect%d]\r\nname%d = \"value %d\"\nnum = %d.5e3\n\tflag := true\n", i, i, i, i );
+		s += szBuf;
+		if( i%7 == 0 ) {
+			s += "str = \"multi\n[notsect]\nline\\n\"\n";
+		}
+		if( i%11 == 0 ) {
+			s += "/* block\n[inside]\n /* nested\n[deep] */ */\n";
+		}
+		if( i%13 == 0 ) {
+			s += "# hash comment\n; semi [x]\n// slash\n";
+		}
+		if( i%17 == 0 ) {
+			s += "[\n";
+		}
+		if( i%19 == 0 ) {
+			s += "x = 0x1F y = 077 !directive here\r";
+		}
+	}
+
+	static const unsigned cMaxChunks[] = { 0, 2, 3, 8, 64, 1000 };
+	for( const unsigned n : cMaxChunks ) {
+		check( "mixed", s, n );
+	}
+	check( "unterminated string", s + "\n[end]\nq = \"unterminated\n[z]\n", 50 );
+	check( "unterminated comment", s + "\n[end]\n/* open\n[z]\n", 50 );
+	check( "exponent before section", "[a]\nk = 1.5e3\n[b]\nk = 2.5e3\n[c]\nk = 1e3\n[d]\n", 8 );
+	check( "one section", "[a]\n", 4 );
+	check( "empty", "", 4 );
+
+	unsigned x = 12345;
+	for( unsigned i = 0; i < RANDOM_CONFIGS; ++i ) {
+		char szName[ 32 ];
+
+		snprintf( szName, sizeof( szName ), "random %u", i );
+		check( szName, randomConfig( x ), 64 );
+	}
+
+	axjob_fini( &g_Jobs );
+
+	if( g_cFailures > 0 ) {
+		fprintf( stderr, "test_config_parallel: %d failure(s)\n", g_cFailures );
+		return 1;
+	}
+
+	printf( "test_config_parallel: ok\n" );
+	return 0;
+}
@@ -0,0 +1,349 @@
+/*
+
+	test_memory_phased - ax_memory phased-heap stress test
+
+	c++ -O2 -I include tests/test_memory_phased.cpp -o test_memory_phased -lpthread
+
+	Several threads allocate with their own tags and free them while the other
+	threads keep allocating, so tag frees overlap block fetches (including
+	multi-block allocations) the whole time. Every allocation is filled with a
+	pattern unique to it and checked before its tag is freed, and after each
+	round all live allocations are checked for overlap. Then the thread and
+	heap bookkeeping is exercised: many heaps cycled on one thread, bindings
+	left behind by another thread's fini, short-lived threads coming and going,
+	and working blocks handed back by a thread that unregisters. Exits with 0
+	on success.
+
+*/
+
+#include <wchar.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define AXTHREAD_IMPLEMENTATION
+#define AXMM_IMPLEMENTATION
+#include "ax_thread.h"
+#include "ax_memory.h"
+
+/* threads allocating at once (each gets its own tag) */
+#define STRESS_THREADS 8
+/* rounds of allocate, check, free per thread */
+#define STRESS_ROUNDS 200
+/* allocations per thread per round */
+#define STRESS_ALLOCS 512
+
+static axmm_phased_heap_t           g_Heap;
+static int                          g_cFailures;
+static std::mutex                   g_FailLock;
+
+static void fail( const char *pszMessage, unsigned uThread, unsigned uRound )
+{
+	std::lock_guard< std::mutex > guard( g_FailLock );
+
+	if( ++g_cFailures <= 10 ) {
+		fprintf( stderr, "test_memory_phased: %s (thread %u, round %u)\n", pszMessage, uThread, uRound );
+	}
+}
+
+/* a barrier that can be reused round after round */
+class CBarrier
+{
+public:
+	explicit CBarrier( unsigned cThreads )
+	: m_cThreads( cThreads )
+	, m_cWaiting( 0 )
+	, m_uGeneration( 0 )
+	{
+	}
+
+	void wait()
+	{
+		std::unique_lock< std::mutex > lock( m_Lock );
+		const unsigned uGeneration = m_uGeneration;
+
+		if( ++m_cWaiting == m_cThreads ) {
+			m_cWaiting = 0;
+			++m_uGeneration;
+			m_Cond.notify_all();
+			return;
+		}
+
+		m_Cond.wait( lock, [&] { return m_uGeneration != uGeneration; } );
+	}
+
+private:
+	std::mutex                      m_Lock;
+	std::condition_variable         m_Cond;
+	const unsigned                  m_cThreads;
+	unsigned                        m_cWaiting;
+	unsigned                        m_uGeneration;
+};
+
+struct SAlloc
+{
+	unsigned char *                 pBytes;
+	size_t                          cBytes;
+};
+
+static unsigned char patternByte( unsigned uThread, unsigned uRound, unsigned uIndex, size_t uOffset )
+{
+	return ( unsigned char )( uThread*131 + uRound*31 + uIndex*7 + unsigned( uOffset%251 ) );
+}
+
+/* mostly small objects, sometimes a few KB, and rarely more than a block */
+static size_t pickSize( unsigned &x )
+{
+	x = x*1664525 + 1013904223;
+
+	const unsigned r = ( x >> 8 )%1000;
+	if( r == 0 ) {
+		return AXMM_BLOCK_SIZE + ( x >> 12 )%AXMM_BLOCK_SIZE;
+	}
+	if( r < 50 ) {
+		return 1024 + ( x >> 12 )%16384;
+	}
+
+	return 1 + ( x >> 12 )%256;
+}
+
+static void stressThread( unsigned uThread, CBarrier &barrier, std::vector< SAlloc > *pAllAllocs )
+{
+	const unsigned uTag = 1 + uThread;
+	std::vector< SAlloc > &allocs = pAllAllocs[ uThread ];
+	unsigned x = 0x9E3779B9u ^ uThread;
+
+	for( unsigned uRound = 0; uRound < STRESS_ROUNDS; ++uRound ) {
+		allocs.clear();
+
+		for( unsigned i = 0; i < STRESS_ALLOCS; ++i ) {
+			const size_t cBytes = pickSize( x );
+			unsigned char *const p = ( unsigned char * )axmm_phased_alloc( &g_Heap, uTag, cBytes );
+
+			if( !p ) {
+				fail( "allocation failed", uThread, uRound );
+				continue;
+			}
+			if( ( size_t( p ) & ( AXMM_PHASED_HEAP_ALIGNMENT - 1 ) ) != 0 ) {
+				fail( "misaligned allocation", uThread, uRound );
+			}
+
+			for( size_t j = 0; j < cBytes; ++j ) {
+				p[ j ] = patternByte( uThread, uRound, i, j );
+			}
+
+			SAlloc a = { p, cBytes };
+			allocs.push_back( a );
+		}
+
+		/* every few rounds, check for overlap between all threads' allocations at once */
+		if( uRound%16 == 0 ) {
+			barrier.wait();
+			if( uThread == 0 ) {
+				std::vector< SAlloc > all;
+
+				for( unsigned t = 0; t < STRESS_THREADS; ++t ) {
+					all.insert( all.end(), pAllAllocs[ t ].begin(), pAllAllocs[ t ].end() );
+				}
+				std::sort( all.begin(), all.end(), []( const SAlloc &a, const SAlloc &b ) { return a.pBytes < b.pBytes; } );
+				for( size_t i = 1; i < all.size(); ++i ) {
+					if( all[ i - 1 ].pBytes + all[ i - 1 ].cBytes > all[ i ].pBytes ) {
+						fail( "allocations overlap", uThread, uRound );
+						break;
+					}
+				}
+			}
+			barrier.wait();
+		}
+
+		/* anything another thread's allocation or tag free touched shows up here */
+		for( unsigned i = 0; i < unsigned( allocs.size() ); ++i ) {
+			const SAlloc &a = allocs[ i ];
+
+			for( size_t j = 0; j < a.cBytes; ++j ) {
+				if( a.pBytes[ j ] != patternByte( uThread, uRound, i, j ) ) {
+					fail( "allocation was overwritten", uThread, uRound );
+					j = a.cBytes;
+					i = unsigned( allocs.size() );
+				}
+			}
+		}
+
+		/* the other threads are still allocating (or checking) while this frees */
+		axmm_phased_free( &g_Heap, uTag );
+	}
+
+	allocs.clear();
+	axmm_phased_thread_fini();
+}
+
+static void testConcurrentTags()
+{
+	static_assert( STRESS_THREADS < AXMM_MAX_TAGS, "each thread needs its own tag (tag 0 is unused)" );
+
+	std::vector< SAlloc > allAllocs[ STRESS_THREADS ];
+	std::vector< std::thread > threads;
+	CBarrier barrier( STRESS_THREADS );
+
+	if( !axmm_phased_init( &g_Heap, ( void * )0, 0 ) ) {
+		fail( "axmm_phased_init failed", 0, 0 );
+		return;
+	}
+
+	for( unsigned i = 0; i < STRESS_THREADS; ++i ) {
+		threads.emplace_back( stressThread, i, std::ref( barrier ), allAllocs );
+	}
+	for( std::thread &t : threads ) {
+		t.join();
+	}
+
+	axmm_phased_fini( &g_Heap );
+}
+
+/* more heaps than a thread has bindings for, one after another */
+static void testHeapCycling()
+{
+	for( unsigned i = 0; i < AXMM_MAX_HEAPS_PER_THREAD*3; ++i ) {
+		axmm_phased_heap_t heap;
+
+		if( !axmm_phased_init( &heap, ( void * )0, 0 ) ) {
+			fail( "axmm_phased_init failed", 0, i );
+			return;
+		}
+		if( !axmm_phased_alloc( &heap, 1, 64 ) ) {
+			fail( "allocation from a cycled heap failed", 0, i );
+		}
+		axmm_phased_free( &heap, 1 );
+		axmm_phased_fini( &heap );
+	}
+}
+
+/* bindings to heaps that another thread finished are reclaimed */
+static void testStaleBindings()
+{
+	static axmm_phased_heap_t heaps[ AXMM_MAX_HEAPS_PER_THREAD*2 ];
+
+	for( unsigned i = 0; i < AXMM_MAX_HEAPS_PER_THREAD; ++i ) {
+		if( !axmm_phased_init( &heaps[ i ], ( void * )0, 0 ) || !axmm_phased_alloc( &heaps[ i ], 1, 64 ) ) {
+			fail( "couldn't set up a heap", 0, i );
+			return;
+		}
+	}
+
+	std::thread( [] {
+		for( unsigned i = 0; i < AXMM_MAX_HEAPS_PER_THREAD; ++i ) {
+			axmm_phased_fini( &heaps[ i ] );
+		}
+	} ).join();
+
+	for( unsigned i = AXMM_MAX_HEAPS_PER_THREAD; i < AXMM_MAX_HEAPS_PER_THREAD*2; ++i ) {
+		if( !axmm_phased_init( &heaps[ i ], ( void * )0, 0 ) ) {
+			fail( "axmm_phased_init failed", 0, i );
+			return;
+		}
+		if( !axmm_phased_alloc( &heaps[ i ], 1, 64 ) ) {
+			fail( "allocation after another thread's fini failed", 0, i );
+		}
+	}
+	for( unsigned i = AXMM_MAX_HEAPS_PER_THREAD; i < AXMM_MAX_HEAPS_PER_THREAD*2; ++i ) {
+		axmm_phased_fini( &heaps[ i ] );
+	}
+}
+
+/* more short-lived threads than the heap has records for */
+static void testThreadChurn()
+{
+	if( !axmm_phased_init( &g_Heap, ( void * )0, 0 ) ) {
+		fail( "axmm_phased_init failed", 0, 0 );
+		return;
+	}
+
+	for( unsigned i = 0; i < AXMM_MAX_THREADS*2; ++i ) {
+		void *p = ( void * )0;
+
+		std::thread( [&] {
+			p = axmm_phased_alloc( &g_Heap, 1, 64 );
+			axmm_phased_thread_fini();
+		} ).join();
+
+		if( !p ) {
+			fail( "allocation from a short-lived thread failed", i, 0 );
+			break;
+		}
+	}
+
+	axmm_phased_free( &g_Heap, 1 );
+	axmm_phased_fini( &g_Heap );
+}
+
+/* a thread that unregisters hands its partially used block back, and the next allocation continues it */
+static void testSpareBlocks()
+{
+	unsigned char *pFirst = ( unsigned char * )0;
+
+	if( !axmm_phased_init( &g_Heap, ( void * )0, 0 ) ) {
+		fail( "axmm_phased_init failed", 0, 0 );
+		return;
+	}
+
+	std::thread( [&] {
+		pFirst = ( unsigned char * )axmm_phased_alloc( &g_Heap, 1, 64 );
+		if( pFirst != ( unsigned char * )0 ) {
+			memset( pFirst, 0xA5, 64 );
+		}
+		axmm_phased_thread_fini();
+	} ).join();
+
+	if( !pFirst ) {
+		fail( "allocation from the unregistering thread failed", 0, 0 );
+		axmm_phased_fini( &g_Heap );
+		return;
+	}
+
+	const axmm_u32_t uSplitPos = g_Heap.uSplitPos;
+	unsigned char *const pSecond = ( unsigned char * )axmm_phased_alloc( &g_Heap, 1, 64 );
+	if( pSecond != pFirst + 64 ) {
+		fail( "the handed back block wasn't continued", 0, 0 );
+	}
+	if( g_Heap.uSplitPos != uSplitPos ) {
+		fail( "a new block was fetched despite a spare one", 0, 0 );
+	}
+	for( unsigned i = 0; i < 64; ++i ) {
+		if( pFirst[ i ] != 0xA5 ) {
+			fail( "the handed back block's allocations were overwritten", 0, i );
+			break;
+		}
+	}
+
+	/* freeing the tag drops its spare blocks with the rest */
+	axmm_phased_thread_fini();
+	axmm_phased_free( &g_Heap, 1 );
+	if( g_Heap.pSpareBlocks[ 1 ] != ( void * )0 || g_Heap.uSplitPos != 0 ) {
+		fail( "spare blocks survived freeing their tag", 0, 0 );
+	}
+
+	axmm_phased_fini( &g_Heap );
+}
+
+int main()
+{
+	testConcurrentTags();
+	testHeapCycling();
+	testStaleBindings();
+	testThreadChurn();
+	testSpareBlocks();
+
+	if( g_cFailures > 0 ) {
+		fprintf( stderr, "test_memory_phased: %d failure(s)\n", g_cFailures );
+		return 1;
+	}
+
+	printf( "test_memory_phased: ok\n" );
+	return 0;
+}